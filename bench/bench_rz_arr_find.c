@@ -0,0 +1,67 @@
+#include "rz_common.h"
+#include "rz_collections.h"
+
+#include "bench_utils.h"
+
+/// element search in the arrays of u8, u16, u32 and u64: rz_arr_find, rz_arr_rfind and rz_arr_count (the sized
+/// kernels) against the memcmp loop that rz_arr_find was before (memcmp of every element) and the typed loop
+/// (`a[i] == x`). the needle is the last element (the first for rfind), so every call scan the whole array.
+/// the arrays of 64 elements, 4 KB and 64 MB, build with -DRZ_NO_SIMD for the scalar kernels, -mavx2 for AVX2.
+///   bench_rz_arr_find [bytes]
+
+static rz_usize bench_memcmp_find(const void *data, rz_usize len, const void *item, rz_usize elemsize) {
+    for (rz_usize i = 0; i < len; ++i) {
+        if (0 == memcmp(item, (const rz_u8 *)data + i * elemsize, elemsize)) return i;
+    }
+    return RZ_ARR_FIND_NOTFOUND;
+}
+
+// every array is `bytes` long, the calls repeat until `total` bytes is scanned
+#define bench_find_type(T, bytes, total)                                                                                          \
+    do {                                                                                                                          \
+        RZ_Array(T) a = {.allocator = rz_std_allocator()};                                                                        \
+        rz_usize len  = (bytes) / sizeof(T);                                                                                      \
+        rz_usize reps = RZ_MAX((total) / (bytes), 1);                                                                             \
+        rz_arr_reserve(&a, len);                                                                                                  \
+        for (rz_usize i = 0; i < len; ++i) a.data[i] = (T)(i % 100);                                                              \
+        a.len             = len;                                                                                                  \
+        a.data[len - 1]   = (T)101;                                                                                               \
+        a.data[0]         = (T)102;                                                                                               \
+        T        needle   = (T)101;                                                                                               \
+        T        rneedle  = (T)102;                                                                                               \
+        rz_usize scanned  = reps * len * sizeof(T);                                                                               \
+        printf("%s, %zu elements\n", #T, len);                                                                                    \
+        RZ_BENCH_BYTES("  memcmp loop (old rz_arr_find)", scanned,                                                              \
+                       for (rz_usize r = 0; r < reps; ++r) RZ_ASSERT(bench_memcmp_find(a.data, len, &needle, sizeof(T)) == len - 1)); \
+        RZ_BENCH_BYTES("  typed loop", scanned, for (rz_usize r = 0; r < reps; ++r) {                                             \
+            rz_usize i = 0;                                                                                                       \
+            while (a.data[i] != needle) i++;                                                                                      \
+            RZ_ASSERT(i == len - 1);                                                                                              \
+        });                                                                                                                       \
+        RZ_BENCH_BYTES("  rz_arr_find", scanned, for (rz_usize r = 0; r < reps; ++r) RZ_ASSERT(rz_arr_find(&a, needle) == len - 1)); \
+        RZ_BENCH_BYTES("  rz_arr_rfind", scanned, for (rz_usize r = 0; r < reps; ++r) RZ_ASSERT(rz_arr_rfind(&a, rneedle) == 0));  \
+        RZ_BENCH_BYTES("  typed count loop", scanned, for (rz_usize r = 0; r < reps; ++r) {                                       \
+            rz_usize count = 0;                                                                                                   \
+            for (rz_usize i = 0; i < len; ++i) count += (a.data[i] == needle);                                                    \
+            rz_bench_keep(count);                                                                                                 \
+            RZ_ASSERT(count == 1);                                                                                                \
+        });                                                                                                                       \
+        RZ_BENCH_BYTES("  rz_arr_count", scanned, for (rz_usize r = 0; r < reps; ++r) RZ_ASSERT(rz_arr_count(&a, needle) == 1)); \
+        rz_arr_free(&a);                                                                                                          \
+    } while (0)
+
+int main(int argc, char **argv) {
+    rz_usize big   = rz_bench_arg(argc, argv, 1, 64U << 20U);
+    rz_usize total = RZ_MAX(big, 256U << 20U);
+    printf("simd: %s\n", RZ_TARGET_SIMD_AVX2 ? "avx2" : RZ_TARGET_SIMD_SSE2 ? "sse2" : RZ_TARGET_SIMD_NEON ? "neon" : "none");
+
+    const rz_usize sizes[] = {64, 4096, big};
+    for (rz_usize s = 0; s < RZ_ARRAY_LEN(sizes); ++s) {
+        printf("== %zu bytes\n", sizes[s]);
+        bench_find_type(rz_u8, sizes[s], total);
+        bench_find_type(rz_u16, sizes[s], total);
+        bench_find_type(rz_u32, sizes[s], total);
+        bench_find_type(rz_u64, sizes[s], total);
+    }
+    return 0;
+}
@@ -0,0 +1,187 @@
+#include "rz_common.h"
+#include "rz_art.h"
+#include "rz_collections.h"
+
+#include "bench_utils.h"
+
+/// point lookups of path keys in RZ_Art against a `const char *` hash table and a sorted array (binary search),
+/// and prefix queries against the sorted array (lower bound then scan) and the full scan.
+/// the paths have 12 children per directory level, so the inner nodes is mostly Node4 and Node16.
+/// RZ_Hm itself is not used, `rz_hm_get` does not link (rz__hm_get is not defined), the stand-in
+/// hash and compare with rz_hm_hasheq_string and use the same load factor (RZ_HM_LOAD_FACTOR_PERCENT).
+/// build with -DRZ_NO_SIMD to compare the Node16 SSE2 search against the scalar loop.
+///   bench_rz_art [keys] [lookups]
+
+#define BENCH_FANOUT 12u
+#define BENCH_DEPTH  6u
+
+typedef struct {
+    const char **keys;
+    rz_usize     mask;
+} BenchStrSet;
+
+static void bench_strset_build(BenchStrSet *s, const char *const *keys, rz_usize len) {
+    rz_usize cap = rz_next_pow2((len * 100) / RZ_HM_LOAD_FACTOR_PERCENT + 1);
+    s->keys      = calloc(cap, sizeof(*s->keys));
+    s->mask      = cap - 1;
+    for (rz_usize k = 0; k < len; ++k) {
+        rz_usize i = rz_hm_hasheq_string(RZ_HM_HASHCMP_HASH, keys[k], NULL, strlen(keys[k]), 0) & s->mask;
+        while (s->keys[i] != NULL) i = (i + 1) & s->mask;
+        s->keys[i] = keys[k];
+    }
+}
+
+static bool bench_strset_contains(const BenchStrSet *s, const char *key) {
+    rz_usize len = strlen(key);
+    for (rz_usize i = rz_hm_hasheq_string(RZ_HM_HASHCMP_HASH, key, NULL, len, 0) & s->mask; s->keys[i] != NULL; i = (i + 1) & s->mask) {
+        if (rz_hm_hasheq_string(RZ_HM_HASHCMP_CMP, s->keys[i], key, len, 0)) return true;
+    }
+    return false;
+}
+
+static int bench_cmp_cstr(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+// first index of `sorted` that is not less than `key`
+static rz_usize bench_lower_bound(const char *const *sorted, rz_usize len, const char *key) {
+    rz_usize lo = 0, hi = len;
+    while (lo < hi) {
+        rz_usize mid = lo + ((hi - lo) / 2);
+        if (strcmp(sorted[mid], key) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static bool bench_count_key(const rz_u8 *key, rz_usize key_len, void *value, void *user) {
+    RZ_UNUSED_ALL(key, key_len, value);
+    (*(rz_usize *)user)++;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    rz_usize n       = rz_bench_arg(argc, argv, 1, 1000000);
+    rz_usize lookups = rz_bench_arg(argc, argv, 2, 1000000);
+    rz_u64   rng     = 0xA57;
+
+    // unique paths "/dA/dB/dC/dD/dE/fF.log", each component is one of BENCH_FANOUT names
+    RZ_Art(rz_u32) art = {.allocator = rz_std_allocator()};
+    char **keys        = malloc(n * sizeof(char *));
+    for (rz_usize i = 0; i < n;) {
+        char path[96];
+        int  len = 0;
+        for (rz_u32 d = 0; d + 1 < BENCH_DEPTH; ++d) len += snprintf(path + len, sizeof(path) - (rz_usize)len, "/dir%02u", (rz_u32)(rz_bench_rand(&rng) % BENCH_FANOUT));
+        snprintf(path + len, sizeof(path) - (rz_usize)len, "/file%02u.log", (rz_u32)(rz_bench_rand(&rng) % BENCH_FANOUT));
+        if (rz_art_get_cstr(&art, path) != NULL) continue;
+        keys[i] = strdup(path);
+        rz_art_insert_cstr(&art, keys[i], (rz_u32)i);
+        ++i;
+    }
+
+    BenchStrSet set = {0};
+    bench_strset_build(&set, (const char *const *)keys, n);
+    const char **sorted = malloc(n * sizeof(char *));
+    memcpy(sorted, keys, n * sizeof(char *));
+    qsort(sorted, n, sizeof(char *), bench_cmp_cstr);
+
+    const char **probes = malloc(lookups * sizeof(char *));
+    for (rz_usize i = 0; i < lookups; ++i) probes[i] = keys[rz_bench_rand(&rng) % n];
+
+    printf("keys: %zu paths, lookups: %zu, simd: %s\n", n, lookups, RZ_TARGET_SIMD_SSE2 ? "sse2" : "none");
+    RZ_BENCH("rz_art_get", lookups, {
+        rz_u64 sum = 0;
+        for (rz_usize i = 0; i < lookups; ++i) sum += *rz_art_get_cstr(&art, probes[i]);
+        rz_bench_keep(sum);
+    });
+    RZ_BENCH("hash table (rz_hm_hasheq_string)", lookups, {
+        rz_usize found = 0;
+        for (rz_usize i = 0; i < lookups; ++i) found += bench_strset_contains(&set, probes[i]);
+        RZ_ASSERT(found == lookups);
+    });
+    RZ_BENCH("sorted array binary search", lookups, {
+        rz_usize found = 0;
+        for (rz_usize i = 0; i < lookups; ++i) {
+            rz_usize j = bench_lower_bound(sorted, n, probes[i]);
+            found += (j < n && strcmp(sorted[j], probes[i]) == 0);
+        }
+        RZ_ASSERT(found == lookups);
+    });
+
+    // insert new keys into the built structures, the sorted array shift the tail for every insert
+    rz_usize     inserts  = 1000;
+    char       **new_keys = malloc(inserts * sizeof(char *));
+    for (rz_usize i = 0; i < inserts; ++i) {
+        char path[96];
+        snprintf(path, sizeof(path), "/dir%02u/new/file%zu.log", (rz_u32)(rz_bench_rand(&rng) % BENCH_FANOUT), i);
+        new_keys[i] = strdup(path);
+    }
+    const char **grown = malloc((n + inserts) * sizeof(char *));
+    RZ_BENCH("insert + remove 1000 keys: rz_art", inserts, {
+        for (rz_usize i = 0; i < inserts; ++i) rz_art_insert_cstr(&art, new_keys[i], (rz_u32)i);
+        for (rz_usize i = 0; i < inserts; ++i) rz_art_remove(&art, new_keys[i], strlen(new_keys[i]));
+    });
+    RZ_BENCH("insert 1000 keys: sorted array", inserts, {
+        memcpy(grown, sorted, n * sizeof(char *));
+        for (rz_usize i = 0; i < inserts; ++i) {
+            rz_usize len = n + i;
+            rz_usize j   = bench_lower_bound(grown, len, new_keys[i]);
+            memmove(&grown[j + 1], &grown[j], (len - j) * sizeof(char *));
+            grown[j] = new_keys[i];
+        }
+    });
+    free(grown);
+    for (rz_usize i = 0; i < inserts; ++i) free(new_keys[i]);
+    free(new_keys);
+
+    // count the keys under a directory of depth 2 ("/dirA/dirB/"), and of depth 4
+    const rz_u32 depths[] = {2, 4};
+    for (rz_usize d = 0; d < RZ_ARRAY_LEN(depths); ++d) {
+        rz_usize queries = (depths[d] == 2) ? 1000 : 10000;
+        char   (*prefixes)[64] = malloc(queries * sizeof(*prefixes));
+        for (rz_usize q = 0; q < queries; ++q) {
+            int len = 0;
+            for (rz_u32 k = 0; k < depths[d]; ++k) len += snprintf(prefixes[q] + len, 64 - (rz_usize)len, "/dir%02u", (rz_u32)(rz_bench_rand(&rng) % BENCH_FANOUT));
+            snprintf(prefixes[q] + len, 64 - (rz_usize)len, "/");
+        }
+        rz_usize expected = 0;
+        for (rz_usize q = 0; q < queries; ++q) {
+            rz_usize plen = strlen(prefixes[q]);
+            for (rz_usize j = bench_lower_bound(sorted, n, prefixes[q]); j < n && strncmp(sorted[j], prefixes[q], plen) == 0; ++j) expected++;
+        }
+
+        printf("prefix depth %u: %zu queries, %.1f keys per query\n", depths[d], queries, (rz_f64)expected / (rz_f64)queries);
+        RZ_BENCH("  rz_art_foreach_prefix", queries, {
+            rz_usize count = 0;
+            for (rz_usize q = 0; q < queries; ++q) rz_art_foreach_prefix(&art, prefixes[q], strlen(prefixes[q]), bench_count_key, &count);
+            RZ_ASSERT(count == expected);
+        });
+        RZ_BENCH("  sorted array lower bound + scan", queries, {
+            rz_usize count = 0;
+            for (rz_usize q = 0; q < queries; ++q) {
+                rz_usize plen = strlen(prefixes[q]);
+                for (rz_usize j = bench_lower_bound(sorted, n, prefixes[q]); j < n && strncmp(sorted[j], prefixes[q], plen) == 0; ++j) count++;
+            }
+            RZ_ASSERT(count == expected);
+        });
+        if (depths[d] == 2) {
+            RZ_BENCH("  full scan", queries, {
+                rz_usize count = 0;
+                for (rz_usize q = 0; q < queries; ++q) {
+                    rz_usize plen = strlen(prefixes[q]);
+                    for (rz_usize j = 0; j < n; ++j) count += (strncmp(keys[j], prefixes[q], plen) == 0);
+                }
+                RZ_ASSERT(count == expected);
+            });
+        }
+        free(prefixes);
+    }
+
+    rz_art_free(&art);
+    free(set.keys);
+    free(sorted);
+    free(probes);
+    for (rz_usize i = 0; i < n; ++i) free(keys[i]);
+    free(keys);
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include "rz_common.h"
+#include "rz_bitset.h"
+#include "rz_collections.h"
+
+#include "bench_utils.h"
+
+/// dense bitset kernels against the scalar word loop, and the roaring bitmap memory/intersection
+/// against a sorted u32 array and an open addressing u32 hash set.
+/// RZ_Hs(u32) is not used as the hash set, `rz_hm_get`/`rz_hs_contains` does not link (rz__hm_get is not defined),
+/// the stand-in use the same load factor (RZ_HM_LOAD_FACTOR_PERCENT).
+///   bench_rz_bitset [universe_bits]
+
+typedef RZ_Array(rz_u32) U32Array;
+
+typedef struct {
+    rz_u32  *slots;
+    rz_usize mask;
+} BenchU32Set;
+
+#define BENCH_U32SET_EMPTY RZ_U32_MAX
+
+static inline rz_usize bench_u32set_hash(rz_u32 v) {
+    return (rz_usize)((v * 0x9E3779B97F4A7C15ULL) >> 32U);
+}
+
+static void bench_u32set_build(BenchU32Set *s, const U32Array *values) {
+    rz_usize cap = rz_next_pow2((values->len * 100) / RZ_HM_LOAD_FACTOR_PERCENT + 1);
+    s->slots     = malloc(cap * sizeof(rz_u32));
+    s->mask      = cap - 1;
+    memset(s->slots, 0xff, cap * sizeof(rz_u32));
+    for (rz_usize k = 0; k < values->len; ++k) {
+        rz_usize i = bench_u32set_hash(values->data[k]) & s->mask;
+        while (s->slots[i] != BENCH_U32SET_EMPTY) i = (i + 1) & s->mask;
+        s->slots[i] = values->data[k];
+    }
+}
+
+static inline bool bench_u32set_contains(const BenchU32Set *s, rz_u32 v) {
+    for (rz_usize i = bench_u32set_hash(v) & s->mask;; i = (i + 1) & s->mask) {
+        if (s->slots[i] == v) return true;
+        if (s->slots[i] == BENCH_U32SET_EMPTY) return false;
+    }
+}
+
+static rz_usize sorted_and_count(const U32Array *a, const U32Array *b) {
+    rz_usize i = 0, j = 0, n = 0;
+    while (i < a->len && j < b->len) {
+        rz_u32 x = a->data[i], y = b->data[j];
+        n += (x == y);
+        i += (x <= y);
+        j += (y <= x);
+    }
+    return n;
+}
+
+static rz_usize scalar_and_count(const rz_u64 *a, const rz_u64 *b, rz_usize nwords) {
+    rz_usize n = 0;
+    for (rz_usize i = 0; i < nwords; ++i) n += rz_popcount64(a[i] & b[i]);
+    return n;
+}
+
+// `values` is sorted and unique
+static void bench_gen(U32Array *values, rz_u32 universe, const char *dist, rz_u64 *rng) {
+    values->len = 0;
+    if (strcmp(dist, "runs") == 0) {
+        // runs of 1000 every 3000 values, shifted by a random offset
+        rz_u32 offset = (rz_u32)(rz_bench_rand(rng) % 1000);
+        for (rz_u32 start = offset; start + 1000 < universe; start += 3000) {
+            for (rz_u32 v = start; v < start + 1000; ++v) rz_arr_push(values, v);
+        }
+        return;
+    }
+    rz_u64 percent = (strcmp(dist, "sparse") == 0) ? 1 : 50;
+    for (rz_u32 v = 0; v < universe; ++v) {
+        if (rz_bench_rand(rng) % 100 < percent) rz_arr_push(values, v);
+    }
+}
+
+static void bench_roaring(const char *dist, rz_u32 universe, rz_u64 *rng) {
+    U32Array a = {.allocator = rz_std_allocator()}, b = {.allocator = rz_std_allocator()};
+    bench_gen(&a, universe, dist, rng);
+    bench_gen(&b, universe, dist, rng);
+
+    RZ_Roaring ra = {0}, rb = {0}, res = {0};
+    rz_roaring_init(&ra, rz_std_allocator());
+    rz_roaring_init(&rb, rz_std_allocator());
+    rz_roaring_init(&res, rz_std_allocator());
+    rz_arr_foreach(v, &a) { rz_roaring_add(&ra, *v); }
+    rz_arr_foreach(v, &b) { rz_roaring_add(&rb, *v); }
+    rz_roaring_run_optimize(&ra);
+    rz_roaring_run_optimize(&rb);
+
+    BenchU32Set sa = {0}, sb = {0};
+    bench_u32set_build(&sa, &a);
+    bench_u32set_build(&sb, &b);
+
+    printf("%s: %zu values in [0, %u)\n", dist, a.len, universe);
+    printf("  memory: roaring %zu B, sorted array %zu B, hash set %zu B\n", rz_roaring_memory_usage(&ra), a.len * sizeof(rz_u32), (sa.mask + 1) * sizeof(rz_u32));
+
+    char     name[64];
+    rz_usize expected = sorted_and_count(&a, &b);
+    snprintf(name, sizeof(name), "  %s roaring and (materialize)", dist);
+    RZ_BENCH(name, a.len, {
+        rz_roaring_op(&res, &ra, &rb, RZ_BITSET_OP_AND);
+        RZ_ASSERT(rz_roaring_cardinality(&res) == expected);
+    });
+    snprintf(name, sizeof(name), "  %s roaring and_cardinality", dist);
+    RZ_BENCH(name, a.len, { RZ_ASSERT(rz_roaring_and_cardinality(&ra, &rb) == expected); });
+    snprintf(name, sizeof(name), "  %s sorted array merge count", dist);
+    RZ_BENCH(name, a.len, { RZ_ASSERT(sorted_and_count(&a, &b) == expected); });
+    snprintf(name, sizeof(name), "  %s hash set probe count", dist);
+    RZ_BENCH(name, a.len, {
+        rz_usize n = 0;
+        rz_arr_foreach(v, &a) { n += bench_u32set_contains(&sb, *v); }
+        RZ_ASSERT(n == expected);
+    });
+
+    free(sa.slots);
+    free(sb.slots);
+    rz_roaring_free(&ra);
+    rz_roaring_free(&rb);
+    rz_roaring_free(&res);
+    rz_arr_free(&a);
+    rz_arr_free(&b);
+}
+
+int main(int argc, char **argv) {
+    rz_usize universe = rz_bench_arg(argc, argv, 1, 1U << 24U);
+    rz_u64   rng      = 0x1234567;
+
+    RZ_Bitset a = {0}, b = {0}, dst = {0};
+    rz_bitset_init(&a, universe, rz_std_allocator());
+    rz_bitset_init(&b, universe, rz_std_allocator());
+    rz_bitset_init(&dst, universe, rz_std_allocator());
+    rz_usize nwords = rz_bitset_words_len(universe);
+    for (rz_usize i = 0; i < nwords; ++i) {
+        a.words[i] = rz_bench_rand(&rng);
+        b.words[i] = rz_bench_rand(&rng);
+    }
+
+    printf("bitset: %zu bits\n", universe);
+    rz_usize expected = scalar_and_count(a.words, b.words, nwords);
+    RZ_BENCH_BYTES("  rz_bitset_and_count", nwords * 16, { RZ_ASSERT(rz_bitset_and_count(&a, &b) == expected); });
+    RZ_BENCH_BYTES("  scalar and popcount loop", nwords * 16, { RZ_ASSERT(scalar_and_count(a.words, b.words, nwords) == expected); });
+    RZ_BENCH_BYTES("  rz_bitset_and", nwords * 16, {
+        memcpy(dst.words, a.words, nwords * sizeof(rz_u64));
+        rz_bitset_and(&dst, &b);
+    });
+    RZ_BENCH_BYTES("  scalar and loop", nwords * 16, {
+        memcpy(dst.words, a.words, nwords * sizeof(rz_u64));
+        for (rz_usize i = 0; i < nwords; ++i) dst.words[i] &= b.words[i];
+        rz_bench_keep(dst.words);
+    });
+    rz_bitset_free(&a);
+    rz_bitset_free(&b);
+    rz_bitset_free(&dst);
+
+    bench_roaring("sparse", (rz_u32)universe, &rng);
+    bench_roaring("dense", (rz_u32)universe, &rng);
+    bench_roaring("runs", (rz_u32)universe, &rng);
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "rz_common.h"
+#include "rz_cache.h"
+#include "rz_collections.h"
+
+#include "bench_utils.h"
+
+#include <math.h>
+
+/// hit rate and ops/sec of the LRU and CLOCK policies, with Zipf distributed keys.
+/// the workload is read-through: get, and put on miss. the all-hit case (every key fit in the cache)
+/// isolate the cost of the hit path, where CLOCK only set a bit and LRU move the node to the front.
+///   bench_rz_cache [requests] [universe]
+
+typedef RZ_LruCache(rz_u64, rz_u64) BenchCache;
+
+// the keys are drawn by inverting the Zipf CDF, scrambled so hot keys are not neighbours
+static void bench_zipf_stream(rz_u64 *stream, rz_usize n, rz_usize universe, rz_f64 s, rz_u64 *rng) {
+    rz_f64 *cdf = malloc(universe * sizeof(rz_f64));
+    rz_f64  sum = 0;
+    for (rz_usize k = 0; k < universe; ++k) cdf[k] = (sum += 1.0 / pow((rz_f64)(k + 1), s));
+    for (rz_usize i = 0; i < n; ++i) {
+        rz_f64   u  = ((rz_f64)(rz_bench_rand(rng) >> 11U) / (rz_f64)(1ULL << 53U)) * sum;
+        rz_usize lo = 0, hi = universe - 1;
+        while (lo < hi) {
+            rz_usize mid = lo + ((hi - lo) / 2);
+            if (cdf[mid] < u) lo = mid + 1;
+            else hi = mid;
+        }
+        stream[i] = (lo + 1) * 0x9E3779B97F4A7C15ULL;
+    }
+    free(cdf);
+}
+
+static void bench_read_through(const char *policy_name, RZ_CachePolicy policy, const rz_u64 *stream, rz_usize n, rz_usize max_entries) {
+    char   name[64];
+    rz_f64 hit_rate = 0;
+    snprintf(name, sizeof(name), "  %s", policy_name);
+    RZ_BENCH(name, n, {
+        BenchCache c = {0};
+        rz_lru_init(&c, .max_entries = max_entries, .policy = policy);
+        rz_u64 sum = 0;
+        for (rz_usize i = 0; i < n; ++i) {
+            rz_u64 *v = rz_lru_get(&c, stream[i]);
+            if (v != NULL) {
+                sum += *v;
+            } else {
+                rz_lru_put(&c, stream[i], stream[i] >> 3U);
+            }
+        }
+        rz_bench_keep(sum);
+        hit_rate = rz_lru_hit_rate(&c);
+        rz_lru_free(&c);
+    });
+    printf("    hit rate %.2f%%\n", hit_rate * 100);
+}
+
+static void bench_all_hits(const char *name, RZ_CachePolicy policy, const rz_u64 *stream, rz_usize n, rz_usize universe) {
+    BenchCache c = {0};
+    rz_lru_init(&c, .max_entries = universe, .policy = policy);
+    for (rz_usize k = 0; k < universe; ++k) rz_lru_put(&c, (k + 1) * 0x9E3779B97F4A7C15ULL, k);
+    RZ_BENCH(name, n, {
+        rz_u64 sum = 0;
+        for (rz_usize i = 0; i < n; ++i) sum += *rz_lru_get(&c, stream[i]);
+        rz_bench_keep(sum);
+    });
+    rz_lru_free(&c);
+}
+
+int main(int argc, char **argv) {
+    rz_usize n        = rz_bench_arg(argc, argv, 1, 1U << 22U);
+    rz_usize universe = rz_bench_arg(argc, argv, 2, 1U << 20U);
+    rz_u64   rng      = 0x2F1B;
+    rz_u64  *stream   = malloc(n * sizeof(rz_u64));
+
+    const rz_f64 skews[] = {0.8, 0.99, 1.2};
+    for (rz_usize s = 0; s < RZ_ARRAY_LEN(skews); ++s) {
+        bench_zipf_stream(stream, n, universe, skews[s], &rng);
+        const rz_usize percents[] = {1, 10};
+        for (rz_usize p = 0; p < RZ_ARRAY_LEN(percents); ++p) {
+            rz_usize max_entries = (universe * percents[p]) / 100;
+            printf("zipf s=%.2f, %zu requests, %zu keys, cache %zu entries (%zu%%)\n", skews[s], n, universe, max_entries, percents[p]);
+            bench_read_through("lru", RZ_CACHE_LRU, stream, n, max_entries);
+            bench_read_through("clock", RZ_CACHE_CLOCK, stream, n, max_entries);
+        }
+    }
+
+    // in cache (the hit path itself) and out of cache (the misses of the LRU list writes)
+    const rz_usize cached[] = {1U << 14U, universe};
+    for (rz_usize k = 0; k < RZ_ARRAY_LEN(cached); ++k) {
+        printf("all hits, zipf s=0.99, %zu keys cached\n", cached[k]);
+        bench_zipf_stream(stream, n, cached[k], 0.99, &rng);
+        bench_all_hits("  lru get", RZ_CACHE_LRU, stream, n, cached[k]);
+        bench_all_hits("  clock get", RZ_CACHE_CLOCK, stream, n, cached[k]);
+    }
+    free(stream);
+    return 0;
+}
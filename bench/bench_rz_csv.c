@@ -0,0 +1,138 @@
+#include "rz_common.h"
+#include "rz_csv.h"
+#include "rz_fs.h"
+#include "rz_strings.h"
+
+#include "bench_utils.h"
+
+/// throughput of rz_csv on the generated export without quotes and with the quoted fields (the delimiters,
+/// the newlines and the escaped quotes inside the quotes), against the rz_sv_split_char loop (line then field,
+/// no quoting, so only on the export without quotes) and the byte by byte state machine that handle the quotes.
+/// the build with -DRZ_NO_SIMD is the scalar classification, the default x86_64 build is SSE2 without PCLMUL
+/// (the prefix XOR is 6 shift/xor), -mpclmul use the carry-less multiply, -mavx2 -mpclmul both.
+///   bench_rz_csv [bytes] [threads]
+
+static rz_usize bench_export(char *buf, rz_usize bytes, bool quoted) {
+    static const char *const names[] = {"alice", "bob", "carol", "dave", "eve", "mallory", "trent"};
+    static const char *const notes[] = {"\"ok, shipped\"", "\"said \"\"hi\"\"\"", "\"two\nlines\"", "\"\""};
+    rz_u64                   rng     = 0xC5F;
+    rz_usize                 len     = 0;
+    while (len + 256 < bytes) {
+        rz_u64      r    = rz_bench_rand(&rng);
+        const char *note = (quoted && (r >> 40U) % 3 == 0) ? notes[(r >> 44U) % 4] : "plain note";
+        len += (rz_usize)snprintf(buf + len, 256, "%llu,%s,%u.%02u,2026-10-%02u,%s,%u\n", (unsigned long long)(r >> 20U), names[r % 7],
+                                  (rz_u32)((r >> 8U) % 10000), (rz_u32)((r >> 16U) % 100), (rz_u32)(1 + (r >> 24U) % 28), note,
+                                  (rz_u32)((r >> 32U) % 100));
+    }
+    return len;
+}
+
+typedef struct {
+    rz_usize fields;
+    rz_usize bytes;
+} BenchSum;
+
+static BenchSum bench_split_char(RZ_StrView input) {
+    BenchSum   sum = {0};
+    RZ_StrView line, field;
+    while (rz_sv_split_char(&input, '\n', &line)) {
+        while (rz_sv_split_char(&line, ',', &field)) {
+            sum.fields++;
+            sum.bytes += field.len;
+        }
+    }
+    return sum;
+}
+
+// RFC 4180 byte by byte: the field ends at ',' or '\n' outside the quotes
+static BenchSum bench_state_machine(RZ_StrView input) {
+    BenchSum sum = {0};
+    rz_usize start = 0;
+    bool     inquote = false;
+    for (rz_usize i = 0; i < input.len; ++i) {
+        rz_char ch = input.data[i];
+        if (ch == '"') inquote = !inquote;
+        else if (!inquote && (ch == ',' || ch == '\n')) {
+            sum.fields++;
+            sum.bytes += i - start;
+            start      = i + 1;
+        }
+    }
+    return sum;
+}
+
+static BenchSum bench_rz_csv(RZ_StrView input, bool unquote) {
+    BenchSum     sum     = {0};
+    RZ_CsvReader r       = rz_csv_reader(input);
+    RZ_Str       scratch = {.allocator = rz_std_allocator()};
+    RZ_CsvRow    row;
+    while (rz_csv_next_row(&r, &row)) {
+        sum.fields += row.len;
+        for (rz_usize i = 0; i < row.len; ++i) sum.bytes += unquote ? rz_csv_unquote(&r, row.data[i], &scratch).len : row.data[i].len;
+    }
+    rz_str_free(&scratch);
+    rz_csv_reader_free(&r);
+    return sum;
+}
+
+#define BENCH_MAX_CHUNKS 64u
+
+static bool bench_count_row(const RZ_CsvReader *r, RZ_CsvRow row, rz_usize chunk, void *user) {
+    RZ_UNUSED(r);
+    BenchSum *sums      = user;
+    sums[chunk].fields += row.len;
+    for (rz_usize i = 0; i < row.len; ++i) sums[chunk].bytes += row.data[i].len;
+    return true;
+}
+
+static BenchSum bench_rz_csv_parallel(RZ_StrView input, rz_usize threads) {
+    BenchSum sums[BENCH_MAX_CHUNKS] = {0}, sum = {0};
+    RZ_ASSERT(rz_csv_read_parallel(input, threads, bench_count_row, sums));
+    for (rz_usize i = 0; i < BENCH_MAX_CHUNKS; ++i) {
+        sum.fields += sums[i].fields;
+        sum.bytes  += sums[i].bytes;
+    }
+    return sum;
+}
+
+#define bench_assert_sum(a, b) RZ_ASSERT((a).fields == (b).fields && (a).bytes == (b).bytes)
+
+int main(int argc, char **argv) {
+    rz_usize    bytes   = rz_bench_arg(argc, argv, 1, 256U << 20U);
+    rz_usize    threads = RZ_MIN(rz_bench_arg(argc, argv, 2, 4), BENCH_MAX_CHUNKS);
+    char       *buf     = malloc(bytes);
+    const char *path    = "bench_rz_csv.csv";
+    printf("simd: %s, pclmul: %s\n", RZ_TARGET_SIMD_AVX2 ? "avx2" : RZ_TARGET_SIMD_SSE2 ? "sse2" : RZ_TARGET_SIMD_NEON ? "neon" : "none",
+#if defined(__PCLMUL__)
+           "yes"
+#else
+           "no"
+#endif
+    );
+
+    for (int quoted = 0; quoted < 2; ++quoted) {
+        RZ_StrView input = rz_sv_sized(buf, bench_export(buf, bytes, quoted));
+        BenchSum   sum   = bench_state_machine(input);
+        printf("%s: %zu MB, %zu fields\n", quoted ? "quoted" : "no quotes", input.len >> 20U, sum.fields);
+        if (!quoted) RZ_BENCH_BYTES("  rz_sv_split_char (line, field)", input.len, bench_assert_sum(bench_split_char(input), sum));
+        RZ_BENCH_BYTES("  byte by byte state machine", input.len, bench_assert_sum(bench_state_machine(input), sum));
+        RZ_BENCH_BYTES("  rz_csv_next_row", input.len, bench_assert_sum(bench_rz_csv(input, false), sum));
+        RZ_BENCH_BYTES("  rz_csv_next_row + rz_csv_unquote", input.len, rz_bench_keep(bench_rz_csv(input, true).fields));
+        char name[64];
+        snprintf(name, sizeof(name), "  rz_csv_read_parallel (%zu threads)", threads);
+        RZ_BENCH_BYTES(name, input.len, bench_assert_sum(bench_rz_csv_parallel(input, threads), sum));
+
+        if (quoted) {
+            RZ_ASSERT(rz_fs_write(rz_path(path), (const rz_u8 *)input.data, input.len));
+            RZ_BENCH_BYTES("  rz_csv_map + rz_csv_next_row (page cache)", input.len, {
+                RZ_CsvMap m = {0};
+                RZ_ASSERT(rz_csv_map(&m, rz_path(path)));
+                bench_assert_sum(bench_rz_csv(m.data, false), sum);
+                rz_csv_unmap(&m);
+            });
+            rz_fs_remove(rz_path(path));
+        }
+    }
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,171 @@
+#define RZ_BENCH_REPEAT 1
+#include "rz_common.h"
+#include "rz_collections.h"
+#include "rz_external_sort.h"
+#include "rz_fs.h"
+
+#include "bench_utils.h"
+
+#if RZ_TARGET_OS_LINUX
+#    include <fcntl.h>
+#endif
+
+/// rz_external_sort of a generated file of newline delimited records against reading the whole file,
+/// qsort of the lines and writing them back (the in-memory sort, while the file still fit in the memory).
+/// the external sort run with `.memory_limit` = 64 MB, with the default fan in (more than one merge pass)
+/// and with a fan in that merge all the runs at once (1024), with and without the io thread.
+/// the input pages is dropped from the page cache before every case (linux only), so the input is read from the disk.
+/// the request ask for 10 GB, the default is 1 GB so the in-memory sort still fit in the memory of the test machine,
+/// the size is the first argument. every case run once (RZ_BENCH_REPEAT = 1).
+///   bench_rz_external_sort [bytes] [memory_limit]
+
+typedef struct {
+    const rz_u8 *data;
+    rz_usize     len;
+} BenchLine;
+
+static int bench_cmp_line(const void *a, const void *b) {
+    const BenchLine *x = a, *y = b;
+    int              r = memcmp(x->data, y->data, RZ_MIN(x->len, y->len));
+    return (r != 0) ? r : (x->len > y->len) - (x->len < y->len);
+}
+
+static void bench_drop_cache(const char *path) {
+#if RZ_TARGET_OS_LINUX
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+#else
+    RZ_UNUSED(path);
+#endif
+}
+
+// lines of 16 to 80 random lowercase letters
+static rz_usize bench_generate(const char *path, rz_usize bytes) {
+    RZ_Fd  fd  = rz_fd_open_cstr_write(path);
+    rz_u64 rng = 0x5087;
+    RZ_ASSERT(fd != RZ_INVALID_FD);
+    rz_u8   *buf   = malloc(1U << 20U);
+    rz_usize len   = 0, total = 0, lines = 0;
+    while (total < bytes) {
+        rz_u64   r        = rz_bench_rand(&rng);
+        rz_usize line_len = 16 + (r % 65);
+        if (len + line_len + 1 > (1U << 20U)) {
+            RZ_ASSERT(rz_fd_write_all(fd, buf, len));
+            len = 0;
+        }
+        for (rz_usize i = 0; i < line_len; ++i) {
+            if ((i & 7U) == 0) r = rz_bench_rand(&rng);
+            buf[len++] = (rz_u8)('a' + ((r >> ((i & 7U) * 8U)) & 0xFFU) % 26);
+        }
+        buf[len++]  = '\n';
+        total      += line_len + 1;
+        lines++;
+    }
+    RZ_ASSERT(rz_fd_write_all(fd, buf, len));
+    RZ_ASSERT(rz_fd_close(fd));
+    free(buf);
+    return lines;
+}
+
+static void bench_memory_sort(const char *in_path, const char *out_path) {
+    RZ_BytesArray raw = {.allocator = rz_std_allocator()};
+    RZ_ASSERT(rz_fs_read(rz_path(in_path), &raw));
+    RZ_Array(BenchLine) lines = {.allocator = rz_std_allocator()};
+    for (rz_usize start = 0, i = 0; i < raw.len; ++i) {
+        if (raw.data[i] != '\n') continue;
+        rz_arr_append(&lines, ((BenchLine){raw.data + start, i - start}));
+        start = i + 1;
+    }
+    rz_arr_qsort(&lines, bench_cmp_line);
+
+    RZ_Fd    out = rz_fd_open_cstr_write(out_path);
+    rz_u8   *buf = malloc(1U << 20U);
+    rz_usize len = 0;
+    RZ_ASSERT(out != RZ_INVALID_FD);
+    for (rz_usize i = 0; i < lines.len; ++i) {
+        if (len + lines.data[i].len + 1 > (1U << 20U)) {
+            RZ_ASSERT(rz_fd_write_all(out, buf, len));
+            len = 0;
+        }
+        memcpy(buf + len, lines.data[i].data, lines.data[i].len);
+        len            += lines.data[i].len;
+        buf[len++]      = '\n';
+    }
+    RZ_ASSERT(rz_fd_write_all(out, buf, len));
+    RZ_ASSERT(rz_fd_close(out));
+    free(buf);
+    rz_arr_free(&lines);
+    rz_arr_free(&raw);
+}
+
+static void bench_on_progress(const RZ_ExternalSortProgress *progress, void *user) {
+    if (progress->stage == RZ_EXTERNAL_SORT_STAGE_DONE) *(RZ_ExternalSortProgress *)user = *progress;
+}
+
+static void bench_external_sort(const char *in_path, const char *out_path, rz_usize memory_limit, rz_usize fan_in, bool sync_io,
+                                RZ_ExternalSortProgress *done) {
+    RZ_Fd in  = rz_fd_open_cstr_read(in_path);
+    RZ_Fd out = rz_fd_open_cstr_write(out_path);
+    RZ_ASSERT(in != RZ_INVALID_FD && out != RZ_INVALID_FD);
+    RZ_ASSERT(rz_external_sort(in, out, .memory_limit = memory_limit, .fan_in = fan_in, .sync_io = sync_io, .temp_dir = rz_path("."),
+                               .progress = bench_on_progress, .progress_user = done));
+    RZ_ASSERT(rz_fd_close(in));
+    RZ_ASSERT(rz_fd_close(out));
+}
+
+static bool bench_same_file(const char *a_path, const char *b_path) {
+    RZ_Fd    a = rz_fd_open_cstr_read(a_path), b = rz_fd_open_cstr_read(b_path);
+    rz_u8   *x = malloc(1U << 20U), *y = malloc(1U << 20U);
+    bool     same = true;
+    rz_usize x_len = 0, y_len = 0;
+    do {
+        RZ_ASSERT(rz_fd_read(a, x, 1U << 20U, &x_len) && rz_fd_read(b, y, 1U << 20U, &y_len));
+        same = (x_len == y_len) && (memcmp(x, y, x_len) == 0);
+    } while (same && x_len > 0);
+    rz_fd_close(a);
+    rz_fd_close(b);
+    free(x);
+    free(y);
+    return same;
+}
+
+int main(int argc, char **argv) {
+    rz_usize    bytes        = rz_bench_arg(argc, argv, 1, 1U << 30U);
+    rz_usize    memory_limit = rz_bench_arg(argc, argv, 2, 64U << 20U);
+    const char *in_path      = "bench_rz_external_sort.in";
+    const char *ref_path     = "bench_rz_external_sort.ref";
+    const char *out_path     = "bench_rz_external_sort.out";
+
+    rz_usize lines = bench_generate(in_path, bytes);
+    printf("input: %zu MB, %zu lines, memory_limit %zu MB\n", bytes >> 20U, lines, memory_limit >> 20U);
+
+    bench_drop_cache(in_path);
+    RZ_BENCH_BYTES("in memory: read all + rz_arr_qsort + write", bytes, bench_memory_sort(in_path, ref_path));
+
+    struct {
+        const char *name;
+        rz_usize    fan_in;
+        bool        sync_io;
+    } cases[] = {
+        {"rz_external_sort (default fan_in)", RZ_EXTERNAL_SORT_DEFAULT_FAN_IN, false},
+        {"rz_external_sort (default fan_in, sync_io)", RZ_EXTERNAL_SORT_DEFAULT_FAN_IN, true},
+        {"rz_external_sort (fan_in = 1024, one merge)", 1024, false},
+        {"rz_external_sort (fan_in = 1024, one merge, sync_io)", 1024, true},
+    };
+    for (rz_usize i = 0; i < RZ_ARRAY_LEN(cases); ++i) {
+        RZ_ExternalSortProgress done = {0};
+        bench_drop_cache(in_path);
+        RZ_BENCH_BYTES(cases[i].name, bytes, bench_external_sort(in_path, out_path, memory_limit, cases[i].fan_in, cases[i].sync_io, &done));
+        printf("  %llu runs, %.2f GB read + written, progress %.1f MB/s\n", (unsigned long long)done.runs,
+               (rz_f64)(done.bytes_read + done.bytes_written) / 1e9, done.bytes_per_sec / 1e6);
+        RZ_ASSERT(done.records == lines);
+        RZ_ASSERT(bench_same_file(out_path, ref_path));
+    }
+
+    rz_fs_remove(rz_path(in_path));
+    rz_fs_remove(rz_path(ref_path));
+    rz_fs_remove(rz_path(out_path));
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include "rz_common.h"
+#include "rz_allocator.h"
+#include "rz_collections.h"
+#include "rz_hamt.h"
+
+#include "bench_utils.h"
+
+/// the cost of publishing a new version of the map after every update: RZ_Hamt (clone + insert, the update
+/// copy the path to the leaf) against copying the whole hash table and inserting into the copy.
+/// the memory is counted by the allocator: bytes allocated per update, and the live bytes while readers
+/// hold the last BENCH_SNAPSHOTS versions. also the bulk build (persistent, transient) and the lookup.
+/// RZ_Hm itself is not used, `rz_hm_get` does not link (rz__hm_get is not defined), the stand-in
+/// hash with rz_hm_default_hash and use the same load factor (RZ_HM_LOAD_FACTOR_PERCENT).
+///   bench_rz_hamt [keys] [updates]
+
+#define BENCH_SNAPSHOTS 16u
+
+typedef struct {
+    rz_usize live;
+    rz_usize total;
+} BenchCounter;
+
+static void *bench_counter_alloc(void *a, rz_usize len) {
+    BenchCounter *c  = a;
+    c->live         += len;
+    c->total        += len;
+    return malloc(len);
+}
+
+static void *bench_counter_remap(void *a, void *mem, rz_usize mem_len, rz_usize new_len) {
+    BenchCounter *c  = a;
+    c->live         += new_len - mem_len;
+    c->total        += new_len;
+    return realloc(mem, new_len);
+}
+
+static void bench_counter_dealloc(void *a, void *mem, rz_usize mem_len) {
+    BenchCounter *c  = a;
+    c->live         -= mem_len;
+    free(mem);
+}
+
+static RZ_Allocator bench_counter_allocator(BenchCounter *c) {
+    static const RZ_AllocatorVTable vtable = {
+        .alloc   = bench_counter_alloc,
+        .remap   = bench_counter_remap,
+        .dealloc = bench_counter_dealloc,
+    };
+    return (RZ_Allocator){.ptr = c, .vtable = &vtable};
+}
+
+typedef struct {
+    rz_u64 key;
+    rz_u64 value;
+} BenchEntry;
+
+// open addressing u64 -> u64, the key 0 is the empty slot
+typedef struct {
+    BenchEntry *slots;
+    rz_usize    mask;
+    rz_usize    len;
+} BenchTable;
+
+static BenchTable bench_table_new(rz_usize keys, BenchCounter *c) {
+    rz_usize cap = rz_next_pow2((keys * 100) / RZ_HM_LOAD_FACTOR_PERCENT + 1);
+    BenchTable t = {.slots = bench_counter_alloc(c, cap * sizeof(BenchEntry)), .mask = cap - 1};
+    memset(t.slots, 0, cap * sizeof(BenchEntry));
+    return t;
+}
+
+static void bench_table_insert(BenchTable *t, rz_u64 key, rz_u64 value) {
+    rz_usize i = rz_hm_default_hash(&key, sizeof(key), 0) & t->mask;
+    while (t->slots[i].key != 0 && t->slots[i].key != key) i = (i + 1) & t->mask;
+    t->len        += (t->slots[i].key == 0);
+    t->slots[i]    = (BenchEntry){key, value};
+}
+
+static const rz_u64 *bench_table_get(const BenchTable *t, rz_u64 key) {
+    for (rz_usize i = rz_hm_default_hash(&key, sizeof(key), 0) & t->mask; t->slots[i].key != 0; i = (i + 1) & t->mask) {
+        if (t->slots[i].key == key) return &t->slots[i].value;
+    }
+    return NULL;
+}
+
+static BenchTable bench_table_copy(const BenchTable *t, BenchCounter *c) {
+    rz_usize   size = (t->mask + 1) * sizeof(BenchEntry);
+    BenchTable copy = *t;
+    copy.slots      = bench_counter_alloc(c, size);
+    memcpy(copy.slots, t->slots, size);
+    return copy;
+}
+
+static void bench_table_free(BenchTable *t, BenchCounter *c) {
+    bench_counter_dealloc(c, t->slots, (t->mask + 1) * sizeof(BenchEntry));
+}
+
+typedef RZ_Hamt(rz_u64) U64Hamt;
+
+static void bench_versions(rz_usize n, rz_usize updates, const rz_u64 *keys) {
+    // keys 1..n are in the map, the updates overwrite random keys
+    BenchCounter hamt_counter = {0}, table_counter = {0};
+    U64Hamt      map          = {.allocator = bench_counter_allocator(&hamt_counter)};
+    BenchTable   table        = bench_table_new(n, &table_counter);
+    rz_hamt_transient_begin(&map);
+    for (rz_usize i = 0; i < n; ++i) {
+        rz_hamt_insert_u64(&map, keys[i], keys[i]);
+        bench_table_insert(&table, keys[i], keys[i]);
+    }
+    rz_hamt_transient_end(&map);
+    rz_usize hamt_base = hamt_counter.live, table_base = table_counter.live;
+    printf("%zu keys: RZ_Hamt %.1f MB, table %.1f MB\n", n, (rz_f64)hamt_base / (1 << 20), (rz_f64)table_base / (1 << 20));
+
+    // every update publish a new version, the reader drop the previous one
+    rz_u64 rng          = 0x4A37;
+    rz_usize hamt_total = hamt_counter.total;
+    RZ_BENCH("  RZ_Hamt: clone + insert per update", updates, {
+        U64Hamt published = {0};
+        rz_hamt_clone(&published, &map);
+        for (rz_usize i = 0; i < updates; ++i) {
+            rz_u64 key = keys[rz_bench_rand(&rng) % n];
+            rz_hamt_insert_u64(&map, key, i);
+            rz_hamt_free(&published);
+            rz_hamt_clone(&published, &map);
+        }
+        rz_hamt_free(&published);
+    });
+    rz_f64 hamt_per_update = (rz_f64)(hamt_counter.total - hamt_total) / (rz_f64)(updates * RZ_BENCH_REPEAT);
+
+    rz_usize copy_updates = RZ_MIN(updates, RZ_MAX(20000000 / n, 10));
+    rz_usize table_total  = table_counter.total;
+    RZ_BENCH("  full copy + insert per update", copy_updates, {
+        BenchTable published = bench_table_copy(&table, &table_counter);
+        for (rz_usize i = 0; i < copy_updates; ++i) {
+            rz_u64 key = keys[rz_bench_rand(&rng) % n];
+            BenchTable next = bench_table_copy(&published, &table_counter);
+            bench_table_insert(&next, key, i);
+            bench_table_free(&published, &table_counter);
+            published = next;
+        }
+        bench_table_free(&published, &table_counter);
+    });
+    rz_f64 table_per_update = (rz_f64)(table_counter.total - table_total) / (rz_f64)(copy_updates * RZ_BENCH_REPEAT);
+    printf("  %-46s %12.0f B RZ_Hamt, %12.0f B full copy\n", "allocated per update", hamt_per_update, table_per_update);
+
+    // readers hold the last BENCH_SNAPSHOTS versions
+    U64Hamt    hamt_snapshots[BENCH_SNAPSHOTS];
+    BenchTable table_snapshots[BENCH_SNAPSHOTS];
+    for (rz_usize s = 0; s < BENCH_SNAPSHOTS; ++s) {
+        rz_u64 key = keys[rz_bench_rand(&rng) % n];
+        rz_hamt_insert_u64(&map, key, s);
+        hamt_snapshots[s] = (U64Hamt){0};
+        rz_hamt_clone(&hamt_snapshots[s], &map);
+        table_snapshots[s] = bench_table_copy(&table, &table_counter);
+        bench_table_insert(&table_snapshots[s], key, s);
+    }
+    printf("  live with %u snapshots %24s %9.1f MB RZ_Hamt, %9.1f MB full copy\n", BENCH_SNAPSHOTS, "", (rz_f64)hamt_counter.live / (1 << 20),
+           (rz_f64)table_counter.live / (1 << 20));
+    for (rz_usize s = 0; s < BENCH_SNAPSHOTS; ++s) {
+        rz_hamt_free(&hamt_snapshots[s]);
+        bench_table_free(&table_snapshots[s], &table_counter);
+    }
+
+    rz_usize lookups = 1U << 20U;
+    RZ_BENCH("  rz_hamt_get_u64", lookups, {
+        rz_u64 sum = 0;
+        for (rz_usize i = 0; i < lookups; ++i) sum += *rz_hamt_get_u64(&map, keys[rz_bench_rand(&rng) % n]);
+        rz_bench_keep(sum);
+    });
+    RZ_BENCH("  table get", lookups, {
+        rz_u64 sum = 0;
+        for (rz_usize i = 0; i < lookups; ++i) sum += *bench_table_get(&table, keys[rz_bench_rand(&rng) % n]);
+        rz_bench_keep(sum);
+    });
+
+    RZ_BENCH("  build: rz_hamt_insert_u64 (persistent)", n, {
+        U64Hamt t = {.allocator = rz_std_allocator()};
+        for (rz_usize i = 0; i < n; ++i) rz_hamt_insert_u64(&t, keys[i], keys[i]);
+        rz_hamt_free(&t);
+    });
+    RZ_BENCH("  build: rz_hamt_insert_u64 (transient)", n, {
+        U64Hamt t = {.allocator = rz_std_allocator()};
+        rz_hamt_transient_begin(&t);
+        for (rz_usize i = 0; i < n; ++i) rz_hamt_insert_u64(&t, keys[i], keys[i]);
+        rz_hamt_transient_end(&t);
+        rz_hamt_free(&t);
+    });
+    RZ_BENCH("  build: table insert", n, {
+        BenchCounter c = {0};
+        BenchTable   t = bench_table_new(n, &c);
+        for (rz_usize i = 0; i < n; ++i) bench_table_insert(&t, keys[i], keys[i]);
+        bench_table_free(&t, &c);
+    });
+
+    rz_hamt_free(&map);
+    bench_table_free(&table, &table_counter);
+}
+
+int main(int argc, char **argv) {
+    rz_usize n       = rz_bench_arg(argc, argv, 1, 1000000);
+    rz_usize updates = rz_bench_arg(argc, argv, 2, 100000);
+    rz_u64  *keys    = malloc(n * sizeof(rz_u64));
+    for (rz_usize i = 0; i < n; ++i) keys[i] = i + 1;
+
+    for (rz_usize keys_len = 1000; keys_len <= n; keys_len *= 10) bench_versions(keys_len, updates, keys);
+    free(keys);
+    return 0;
+}
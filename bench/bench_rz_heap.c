@@ -0,0 +1,176 @@
+#include "rz_common.h"
+#include "rz_collections.h"
+
+#include "bench_utils.h"
+
+/// the 4-ary RZ_Heap against a binary heap (same code with 2 children) and against keeping the array sorted
+/// with rz_arr_qsort, on the scheduler "hold" workload (pop the next deadline, push it back later).
+/// also rz_arr_top_k against sorting the whole array, and heapify against qsort.
+///   bench_rz_heap [ops] [items]
+
+#define u64_less(a, b) ((a) < (b))
+RZ_HEAP_DEFINE(U64Heap, rz_u64, u64_less);
+
+typedef RZ_Array(rz_u64) U64Array;
+
+typedef struct {
+    rz_u64  *data;
+    rz_usize len;
+} BenchBinHeap;
+
+static inline void bench_binheap_push(BenchBinHeap *h, rz_u64 item) {
+    rz_usize i = h->len++;
+    while (i > 0 && item < h->data[(i - 1) >> 1U]) {
+        h->data[i] = h->data[(i - 1) >> 1U];
+        i          = (i - 1) >> 1U;
+    }
+    h->data[i] = item;
+}
+
+static inline rz_u64 bench_binheap_pop(BenchBinHeap *h) {
+    rz_u64   top  = h->data[0];
+    rz_u64   item = h->data[--h->len];
+    rz_usize i    = 0;
+    for (;;) {
+        rz_usize c = (i << 1U) + 1U;
+        if (c >= h->len) break;
+        if (c + 1 < h->len && h->data[c + 1] < h->data[c]) c++;
+        if (!(h->data[c] < item)) break;
+        h->data[i] = h->data[c];
+        i          = c;
+    }
+    h->data[i] = item;
+    return top;
+}
+
+static int bench_cmp_u64(const void *a, const void *b) {
+    rz_u64 x = *(const rz_u64 *)a, y = *(const rz_u64 *)b;
+    return (x > y) - (x < y);
+}
+
+static int bench_cmp_u64_desc(const void *a, const void *b) {
+    return bench_cmp_u64(b, a);
+}
+
+static void bench_hold(rz_usize queue, rz_usize ops, rz_u64 *rng) {
+    rz_u64 *initial = malloc(queue * sizeof(rz_u64));
+    for (rz_usize i = 0; i < queue; ++i) initial[i] = rz_bench_rand(rng) >> 20U;
+    rz_u64 *delays = malloc(ops * sizeof(rz_u64));
+    for (rz_usize i = 0; i < ops; ++i) delays[i] = rz_bench_rand(rng) >> 44U;
+
+    printf("queue %zu: hold (%zu pop + push), drain (push all then pop all)\n", queue, ops);
+    rz_u64 expected = 0;
+    RZ_BENCH("  RZ_Heap (4-ary)", ops, {
+        U64Heap h = {.allocator = rz_std_allocator()};
+        for (rz_usize i = 0; i < queue; ++i) U64Heap_push(&h, initial[i]);
+        rz_u64 sum = 0;
+        for (rz_usize i = 0; i < ops; ++i) {
+            rz_u64 t = U64Heap_pop(&h);
+            sum += t;
+            U64Heap_push(&h, t + delays[i]);
+        }
+        expected = sum;
+        U64Heap_free(&h);
+    });
+    RZ_BENCH("  binary heap", ops, {
+        BenchBinHeap h = {.data = malloc(queue * sizeof(rz_u64))};
+        for (rz_usize i = 0; i < queue; ++i) bench_binheap_push(&h, initial[i]);
+        rz_u64 sum = 0;
+        for (rz_usize i = 0; i < ops; ++i) {
+            rz_u64 t = bench_binheap_pop(&h);
+            sum += t;
+            bench_binheap_push(&h, t + delays[i]);
+        }
+        RZ_ASSERT(sum == expected);
+        free(h.data);
+    });
+    RZ_BENCH("  RZ_Heap (4-ary) drain", queue, {
+        U64Heap h = {.allocator = rz_std_allocator()};
+        for (rz_usize i = 0; i < queue; ++i) U64Heap_push(&h, initial[i]);
+        rz_u64 prev = 0;
+        while (h.len > 0) {
+            rz_u64 t = U64Heap_pop(&h);
+            RZ_ASSERT(prev <= t);
+            prev = t;
+        }
+        U64Heap_free(&h);
+    });
+    RZ_BENCH("  binary heap drain", queue, {
+        BenchBinHeap h = {.data = malloc(queue * sizeof(rz_u64))};
+        for (rz_usize i = 0; i < queue; ++i) bench_binheap_push(&h, initial[i]);
+        rz_u64 prev = 0;
+        while (h.len > 0) {
+            rz_u64 t = bench_binheap_pop(&h);
+            RZ_ASSERT(prev <= t);
+            prev = t;
+        }
+        free(h.data);
+    });
+    if (queue <= 4096) {
+        // the array is sorted descending, the next deadline is the last item
+        rz_usize sort_ops = RZ_MIN(ops, 20000);
+        RZ_BENCH("  RZ_Array + rz_arr_qsort after push", sort_ops, {
+            U64Array a = {.allocator = rz_std_allocator()};
+            rz_arr_append_many(&a, initial, queue);
+            rz_arr_qsort(&a, bench_cmp_u64_desc);
+            rz_u64 sum = 0;
+            for (rz_usize i = 0; i < sort_ops; ++i) {
+                rz_u64 t = a.data[--a.len];
+                sum += t;
+                rz_arr_push(&a, t + delays[i]);
+                rz_arr_qsort(&a, bench_cmp_u64_desc);
+            }
+            rz_bench_keep(sum);
+            rz_arr_free(&a);
+        });
+    }
+    free(initial);
+    free(delays);
+}
+
+int main(int argc, char **argv) {
+    rz_usize ops   = rz_bench_arg(argc, argv, 1, 1U << 22U);
+    rz_usize items = rz_bench_arg(argc, argv, 2, 10000000);
+    rz_u64   rng   = 0x4EA9;
+
+    bench_hold(1024, ops, &rng);
+    bench_hold(1U << 20U, ops, &rng);
+
+    U64Array src = {.allocator = rz_std_allocator()}, work = {.allocator = rz_std_allocator()}, out = {.allocator = rz_std_allocator()};
+    for (rz_usize i = 0; i < items; ++i) rz_arr_push(&src, rz_bench_rand(&rng));
+    rz_arr_reserve(&work, items);
+
+    const rz_usize ks[] = {100, 10000};
+    for (rz_usize i = 0; i < RZ_ARRAY_LEN(ks); ++i) {
+        printf("top %zu of %zu\n", ks[i], items);
+        RZ_BENCH("  rz_arr_top_k", items, {
+            out.len = 0;
+            rz_arr_top_k(&src, ks[i], bench_cmp_u64, &out);
+        });
+        rz_u64 top = out.data[0];
+        RZ_BENCH("  rz_arr_qsort + first k", items, {
+            work.len = 0;
+            rz_arr_append_many(&work, src.data, src.len);
+            rz_arr_qsort(&work, bench_cmp_u64_desc);
+            RZ_ASSERT(work.data[0] == top);
+        });
+    }
+
+    printf("order %zu items\n", items);
+    RZ_BENCH("  U64Heap_heapify", items, {
+        work.len = 0;
+        rz_arr_append_many(&work, src.data, src.len);
+        U64Heap h = U64Heap_from_array(work.data, work.len, work.capacity, work.allocator);
+        rz_bench_keep(h.data);
+    });
+    RZ_BENCH("  rz_arr_qsort", items, {
+        work.len = 0;
+        rz_arr_append_many(&work, src.data, src.len);
+        rz_arr_qsort(&work, bench_cmp_u64);
+    });
+
+    rz_arr_free(&src);
+    rz_arr_free(&work);
+    rz_arr_free(&out);
+    return 0;
+}
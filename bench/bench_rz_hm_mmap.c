@@ -0,0 +1,149 @@
+#include "rz_common.h"
+#include "rz_collections.h"
+#include "rz_fs.h"
+#include "rz_hm_mmap.h"
+
+#include "bench_utils.h"
+
+#if RZ_TARGET_OS_LINUX
+#    include <fcntl.h>
+#endif
+
+/// cold start of a lookup table: map the rz_hm_mmap file, against reading the raw entries and
+/// rebuilding an open addressing table (what the process do at every start without the file).
+/// RZ_Hm itself is not used, `rz_hm_get` does not link (rz__hm_get is not defined), the stand-in
+/// hash with rz_hm_default_hash and use the same load factor (RZ_HM_LOAD_FACTOR_PERCENT).
+/// the "cold" cases drop the file pages from the page cache first (linux only).
+///   bench_rz_hm_mmap [entries] [lookups]
+
+typedef struct {
+    rz_u32 id;
+    rz_f64 score;
+} Record;
+
+typedef struct {
+    rz_u64 key;
+    Record value;
+} RecordEntry;
+
+typedef struct {
+    RecordEntry *slots;
+    bool        *used;
+    rz_usize     mask;
+} BenchTable;
+
+static void bench_table_build(BenchTable *t, const RecordEntry *entries, rz_usize len) {
+    rz_usize cap = rz_next_pow2((len * 100) / RZ_HM_LOAD_FACTOR_PERCENT + 1);
+    t->slots     = malloc(cap * sizeof(RecordEntry));
+    t->used      = calloc(cap, sizeof(bool));
+    t->mask      = cap - 1;
+    for (rz_usize k = 0; k < len; ++k) {
+        rz_usize i = rz_hm_default_hash(&entries[k].key, sizeof(rz_u64), 0) & t->mask;
+        while (t->used[i]) i = (i + 1) & t->mask;
+        t->slots[i] = entries[k];
+        t->used[i]  = true;
+    }
+}
+
+static const Record *bench_table_get(const BenchTable *t, rz_u64 key) {
+    for (rz_usize i = rz_hm_default_hash(&key, sizeof(rz_u64), 0) & t->mask; t->used[i]; i = (i + 1) & t->mask) {
+        if (t->slots[i].key == key) return &t->slots[i].value;
+    }
+    return NULL;
+}
+
+static void bench_table_free(BenchTable *t) {
+    free(t->slots);
+    free(t->used);
+}
+
+static void bench_drop_cache(const char *path) {
+#if RZ_TARGET_OS_LINUX
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+#else
+    RZ_UNUSED(path);
+#endif
+}
+
+// open the table and look up `lookups` random keys, this is the cost before the first request is served
+static void bench_mmap_start(const char *path, rz_usize n, rz_usize lookups, bool verify, bool cold) {
+    if (cold) bench_drop_cache(path);
+    RZ_HmMmap m   = {0};
+    rz_u64    rng = 0xC01D;
+    RZ_ASSERT(rz_hm_mmap_open(&m, rz_path(path), .verify_checksum = verify));
+    rz_u64 sum = 0;
+    for (rz_usize i = 0; i < lookups; ++i) {
+        const Record *r = rz_hm_mmap_get(&m, (rz_u64)(rz_bench_rand(&rng) % n) * 7);
+        RZ_ASSERT(r != NULL);
+        sum += r->id;
+    }
+    rz_bench_keep(sum);
+    rz_hm_mmap_close(&m);
+}
+
+static void bench_rebuild_start(const char *path, rz_usize n, rz_usize lookups, bool cold) {
+    if (cold) bench_drop_cache(path);
+    RZ_BytesArray raw = {.allocator = rz_std_allocator()};
+    RZ_ASSERT(rz_fs_read(rz_path(path), &raw));
+    BenchTable t = {0};
+    bench_table_build(&t, (const RecordEntry *)raw.data, raw.len / sizeof(RecordEntry));
+    rz_arr_free(&raw);
+    rz_u64 rng = 0xC01D, sum = 0;
+    for (rz_usize i = 0; i < lookups; ++i) {
+        const Record *r = bench_table_get(&t, (rz_u64)(rz_bench_rand(&rng) % n) * 7);
+        RZ_ASSERT(r != NULL);
+        sum += r->id;
+    }
+    rz_bench_keep(sum);
+    bench_table_free(&t);
+}
+
+int main(int argc, char **argv) {
+    rz_usize    n          = rz_bench_arg(argc, argv, 1, 1U << 22U);
+    rz_usize    lookups    = rz_bench_arg(argc, argv, 2, 1000);
+    const char *mmap_path  = "bench_rz_hm_mmap.rzhm";
+    const char *raw_path   = "bench_rz_hm_mmap.raw";
+
+    RZ_Array(RecordEntry) entries = {.allocator = rz_std_allocator()};
+    for (rz_u64 i = 0; i < n; ++i) rz_arr_append(&entries, ((RecordEntry){i * 7, {.id = (rz_u32)i, .score = (rz_f64)i / 2}}));
+    RZ_ASSERT(rz_hm_mmap_write(rz_path(mmap_path), &entries));
+    RZ_ASSERT(rz_fs_write(rz_path(raw_path), (const rz_u8 *)entries.data, entries.len * sizeof(RecordEntry)));
+    rz_usize mmap_size = (rz_usize)rz_path_file_size(rz_path(mmap_path));
+    rz_usize raw_size  = entries.len * sizeof(RecordEntry);
+
+    printf("entries: %zu, lookups after start: %zu, rzhm file %zu B, raw entries %zu B\n", n, lookups, mmap_size, raw_size);
+    RZ_BENCH_BYTES("rz_hm_mmap_open + lookups", mmap_size, bench_mmap_start(mmap_path, n, lookups, false, false));
+    RZ_BENCH_BYTES("rz_hm_mmap_open (verify_checksum) + lookups", mmap_size, bench_mmap_start(mmap_path, n, lookups, true, false));
+    RZ_BENCH_BYTES("read raw + rebuild table + lookups", raw_size, bench_rebuild_start(raw_path, n, lookups, false));
+#if RZ_TARGET_OS_LINUX
+    RZ_BENCH_BYTES("cold: rz_hm_mmap_open + lookups", mmap_size, bench_mmap_start(mmap_path, n, lookups, false, true));
+    RZ_BENCH_BYTES("cold: read raw + rebuild table + lookups", raw_size, bench_rebuild_start(raw_path, n, lookups, true));
+#endif
+
+    // steady state lookups, once both are warm
+    RZ_HmMmap m = {0};
+    RZ_ASSERT(rz_hm_mmap_open(&m, rz_path(mmap_path)));
+    BenchTable t = {0};
+    bench_table_build(&t, entries.data, entries.len);
+    rz_usize probes = n;
+    RZ_BENCH("rz_hm_mmap_get", probes, {
+        rz_u64 rng = 0xBEEF, sum = 0;
+        for (rz_usize i = 0; i < probes; ++i) sum += ((const Record *)rz_hm_mmap_get(&m, (rz_u64)(rz_bench_rand(&rng) % n) * 7))->id;
+        rz_bench_keep(sum);
+    });
+    RZ_BENCH("rebuilt table get", probes, {
+        rz_u64 rng = 0xBEEF, sum = 0;
+        for (rz_usize i = 0; i < probes; ++i) sum += bench_table_get(&t, (rz_u64)(rz_bench_rand(&rng) % n) * 7)->id;
+        rz_bench_keep(sum);
+    });
+
+    bench_table_free(&t);
+    rz_hm_mmap_close(&m);
+    rz_arr_free(&entries);
+    rz_fs_remove(rz_path(mmap_path));
+    rz_fs_remove(rz_path(raw_path));
+    return 0;
+}
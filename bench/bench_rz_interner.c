@@ -0,0 +1,158 @@
+#include "rz_common.h"
+#include "rz_collections.h"
+#include "rz_interner.h"
+#include "rz_strings.h"
+
+#include "bench_utils.h"
+
+#include <threads.h>
+
+/// interning a stream of repeated tag/path like strings, against a `const char *` -> id table
+/// that hash and compare with rz_hm_hasheq_string (what RZ_Hm(const char *, u32) does per lookup).
+/// RZ_Hm itself is not used, `rz_hm_get` does not link (rz__hm_get is not defined).
+/// also the equality of symbols against strcmp, and the sync interner against one mutex.
+///   bench_rz_interner [lookups] [unique]
+
+#define BENCH_THREADS 4u
+
+typedef struct {
+    const char **keys;
+    rz_u32      *ids;
+    rz_usize     mask;
+    rz_usize     len;
+} BenchStrTable;
+
+static void bench_str_table_init(BenchStrTable *t, rz_usize capacity) {
+    capacity = rz_next_pow2((capacity * 100) / RZ_HM_LOAD_FACTOR_PERCENT + 1);
+    t->keys  = calloc(capacity, sizeof(*t->keys));
+    t->ids   = calloc(capacity, sizeof(*t->ids));
+    t->mask  = capacity - 1;
+    t->len   = 0;
+}
+
+static rz_u32 bench_str_table_intern(BenchStrTable *t, const char *key) {
+    rz_usize len = strlen(key);
+    rz_usize i   = rz_hm_hasheq_string(RZ_HM_HASHCMP_HASH, key, NULL, len, 0) & t->mask;
+    for (;; i = (i + 1) & t->mask) {
+        if (t->keys[i] == NULL) break;
+        if (rz_hm_hasheq_string(RZ_HM_HASHCMP_CMP, t->keys[i], key, len, 0)) return t->ids[i];
+    }
+    t->keys[i] = key;
+    t->ids[i]  = (rz_u32)t->len++;
+    return t->ids[i];
+}
+
+typedef struct {
+    RZ_SyncInterner *sync;
+    RZ_Interner     *single;
+    mtx_t           *lock;
+    const char     **stream;
+    rz_usize         n;
+} BenchWorker;
+
+static int bench_sync_worker(void *arg) {
+    BenchWorker *w   = arg;
+    RZ_Symbol    sum = 0;
+    for (rz_usize i = 0; i < w->n; ++i) sum += rz_sync_intern(w->sync, rz_sv(w->stream[i]));
+    rz_bench_keep(sum);
+    return 0;
+}
+
+static int bench_locked_worker(void *arg) {
+    BenchWorker *w   = arg;
+    RZ_Symbol    sum = 0;
+    for (rz_usize i = 0; i < w->n; ++i) {
+        mtx_lock(w->lock);
+        sum += rz_intern(w->single, rz_sv(w->stream[i]));
+        mtx_unlock(w->lock);
+    }
+    rz_bench_keep(sum);
+    return 0;
+}
+
+static void bench_threads(const char *name, thrd_start_t fn, BenchWorker *proto, rz_usize n) {
+    RZ_BENCH(name, n, {
+        thrd_t      threads[BENCH_THREADS];
+        BenchWorker workers[BENCH_THREADS];
+        for (rz_usize t = 0; t < BENCH_THREADS; ++t) {
+            workers[t]        = *proto;
+            workers[t].stream = proto->stream + (t * (n / BENCH_THREADS));
+            workers[t].n      = n / BENCH_THREADS;
+            thrd_create(&threads[t], fn, &workers[t]);
+        }
+        for (rz_usize t = 0; t < BENCH_THREADS; ++t) thrd_join(threads[t], NULL);
+    });
+}
+
+int main(int argc, char **argv) {
+    rz_usize n      = rz_bench_arg(argc, argv, 1, 1U << 22U);
+    rz_usize unique = rz_bench_arg(argc, argv, 2, 4096);
+    rz_u64   rng    = 0x5EED;
+
+    // the strings look like logger tags and path components
+    char **pool = malloc(unique * sizeof(char *));
+    for (rz_usize i = 0; i < unique; ++i) {
+        pool[i] = malloc(48);
+        snprintf(pool[i], 48, "module_%zu/component/%zu", i % 97, i);
+    }
+    const char **stream = malloc(n * sizeof(char *));
+    for (rz_usize i = 0; i < n; ++i) stream[i] = pool[rz_bench_rand(&rng) % unique];
+
+    printf("lookups: %zu, unique strings: %zu\n", n, unique);
+    RZ_Interner in = {0};
+    rz_interner_init(&in, rz_std_allocator());
+    RZ_BENCH("rz_intern (hit after the first round)", n, {
+        RZ_Symbol sum = 0;
+        for (rz_usize i = 0; i < n; ++i) sum += rz_intern(&in, rz_sv(stream[i]));
+        rz_bench_keep(sum);
+    });
+    RZ_BENCH("rz_interner_find", n, {
+        RZ_Symbol sum = 0;
+        for (rz_usize i = 0; i < n; ++i) sum += rz_interner_find(&in, rz_sv(stream[i]));
+        rz_bench_keep(sum);
+    });
+
+    BenchStrTable table = {0};
+    bench_str_table_init(&table, unique);
+    RZ_BENCH("char* table with rz_hm_hasheq_string", n, {
+        rz_u32 sum = 0;
+        for (rz_usize i = 0; i < n; ++i) sum += bench_str_table_intern(&table, stream[i]);
+        rz_bench_keep(sum);
+    });
+
+    // equality of two items of the stream
+    RZ_Symbol *symbols = malloc(n * sizeof(RZ_Symbol));
+    for (rz_usize i = 0; i < n; ++i) symbols[i] = rz_intern(&in, rz_sv(stream[i]));
+    RZ_BENCH("symbol == symbol", n - 1, {
+        rz_usize eq = 0;
+        for (rz_usize i = 1; i < n; ++i) eq += (symbols[i] == symbols[i - 1]);
+        rz_bench_keep(eq);
+    });
+    RZ_BENCH("strcmp(a, b) == 0", n - 1, {
+        rz_usize eq = 0;
+        for (rz_usize i = 1; i < n; ++i) eq += (strcmp(stream[i], stream[i - 1]) == 0);
+        rz_bench_keep(eq);
+    });
+
+    RZ_SyncInterner sync = {0};
+    rz_sync_interner_init(&sync, rz_std_allocator());
+    RZ_Interner single = {0};
+    rz_interner_init(&single, rz_std_allocator());
+    mtx_t lock;
+    mtx_init(&lock, mtx_plain);
+    BenchWorker proto = {.sync = &sync, .single = &single, .lock = &lock, .stream = stream};
+    bench_threads("rz_sync_intern, 4 threads", bench_sync_worker, &proto, n);
+    bench_threads("rz_intern behind one mutex, 4 threads", bench_locked_worker, &proto, n);
+
+    mtx_destroy(&lock);
+    rz_interner_free(&single);
+    rz_sync_interner_free(&sync);
+    rz_interner_free(&in);
+    free(table.keys);
+    free(table.ids);
+    free(symbols);
+    for (rz_usize i = 0; i < unique; ++i) free(pool[i]);
+    free(stream);
+    free(pool);
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "rz_common.h"
+#include "rz_allocator.h"
+#include "rz_collections.h"
+
+#include "bench_utils.h"
+
+#if RZ_TARGET_OS_LINUX
+#    include <sys/resource.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
+/// append throughput, the slowest single append, and the peak memory of RZ_SegArray against RZ_Array.
+/// the peak is counted by the allocator (a remap count the old and the new block until it return),
+/// and on linux also the max rss of a child process that only build the array.
+/// the request ask for 1B items, the default is 100M rz_u64 (800 MB) so both fit in the memory of the test machine.
+///   bench_rz_segarray [items]
+
+typedef struct {
+    rz_usize live;
+    rz_usize peak;
+} BenchCounter;
+
+static void *bench_counter_alloc(void *a, rz_usize len) {
+    BenchCounter *c = a;
+    c->live        += len;
+    c->peak         = RZ_MAX(c->peak, c->live);
+    return malloc(len);
+}
+
+static void *bench_counter_remap(void *a, void *mem, rz_usize mem_len, rz_usize new_len) {
+    BenchCounter *c = a;
+    // realloc may need both blocks while it copy
+    c->peak  = RZ_MAX(c->peak, c->live + new_len);
+    c->live += new_len - mem_len;
+    return realloc(mem, new_len);
+}
+
+static void bench_counter_dealloc(void *a, void *mem, rz_usize mem_len) {
+    BenchCounter *c = a;
+    c->live        -= mem_len;
+    free(mem);
+}
+
+static RZ_Allocator bench_counter_allocator(BenchCounter *c) {
+    static const RZ_AllocatorVTable vtable = {
+        .alloc   = bench_counter_alloc,
+        .remap   = bench_counter_remap,
+        .dealloc = bench_counter_dealloc,
+    };
+    return (RZ_Allocator){.ptr = c, .vtable = &vtable};
+}
+
+typedef RZ_Array(rz_u64) U64Array;
+typedef RZ_SegArray(rz_u64) U64SegArray;
+
+typedef enum {
+    BENCH_ARRAY,
+    BENCH_SEGARRAY,
+} BenchKind;
+
+// append `n` items one by one, return the slowest append in ns
+static rz_u64 bench_build(BenchKind kind, rz_usize n, BenchCounter *counter, bool time_each) {
+    U64Array    arr    = {.allocator = bench_counter_allocator(counter)};
+    U64SegArray segarr = {.allocator = bench_counter_allocator(counter)};
+    rz_u64      worst  = 0;
+    for (rz_usize i = 0; i < n; ++i) {
+        rz_u64 start = time_each ? rz_bench_now() : 0;
+        if (kind == BENCH_ARRAY) rz_arr_push(&arr, i);
+        else rz_segarr_push(&segarr, i);
+        if (time_each) worst = RZ_MAX(worst, rz_bench_now() - start);
+    }
+    rz_bench_keep(arr.data);
+    rz_bench_keep(segarr.segments[0]);
+    rz_arr_free(&arr);
+    rz_segarr_free(&segarr);
+    return worst;
+}
+
+static void bench_append_many(BenchKind kind, rz_usize n, const rz_u64 *chunk, rz_usize chunk_len) {
+    BenchCounter counter = {0};
+    U64Array     arr     = {.allocator = bench_counter_allocator(&counter)};
+    U64SegArray  segarr  = {.allocator = bench_counter_allocator(&counter)};
+    for (rz_usize i = 0; i < n; i += chunk_len) {
+        if (kind == BENCH_ARRAY) rz_arr_append_many(&arr, chunk, chunk_len);
+        else rz_segarr_append_many(&segarr, chunk, chunk_len);
+    }
+    rz_arr_free(&arr);
+    rz_segarr_free(&segarr);
+}
+
+static void bench_max_rss(const char *name, BenchKind kind, rz_usize n) {
+#if RZ_TARGET_OS_LINUX
+    pid_t pid = fork();
+    if (pid == 0) {
+        BenchCounter counter = {0};
+        bench_build(kind, n, &counter, false);
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        printf("%-48s %12.1f MB max rss\n", name, (rz_f64)usage.ru_maxrss / 1024.0);
+        exit(0);
+    }
+    waitpid(pid, NULL, 0);
+#else
+    RZ_UNUSED_ALL(name, kind, n);
+#endif
+}
+
+int main(int argc, char **argv) {
+    rz_usize n = rz_bench_arg(argc, argv, 1, 100000000);
+    printf("items: %zu rz_u64 (%zu MB)\n", n, (n * sizeof(rz_u64)) >> 20U);
+    fflush(stdout);
+
+    bench_max_rss("RZ_Array build", BENCH_ARRAY, n);
+    bench_max_rss("RZ_SegArray build", BENCH_SEGARRAY, n);
+
+    BenchCounter arr_counter = {0}, seg_counter = {0};
+    RZ_BENCH("rz_arr_push", n, bench_build(BENCH_ARRAY, n, &arr_counter, false));
+    RZ_BENCH("rz_segarr_push", n, bench_build(BENCH_SEGARRAY, n, &seg_counter, false));
+    printf("%-48s %12.1f MB allocator peak\n", "RZ_Array", (rz_f64)arr_counter.peak / (1 << 20));
+    printf("%-48s %12.1f MB allocator peak\n", "RZ_SegArray", (rz_f64)seg_counter.peak / (1 << 20));
+
+    rz_u64 chunk[4096];
+    for (rz_usize i = 0; i < RZ_ARRAY_LEN(chunk); ++i) chunk[i] = i;
+    RZ_BENCH("rz_arr_append_many (4096)", n, bench_append_many(BENCH_ARRAY, n, chunk, RZ_ARRAY_LEN(chunk)));
+    RZ_BENCH("rz_segarr_append_many (4096)", n, bench_append_many(BENCH_SEGARRAY, n, chunk, RZ_ARRAY_LEN(chunk)));
+
+    BenchCounter counter = {0};
+    printf("%-48s %12.3f ms slowest push\n", "RZ_Array", (rz_f64)bench_build(BENCH_ARRAY, n, &counter, true) / 1e6);
+    printf("%-48s %12.3f ms slowest push\n", "RZ_SegArray", (rz_f64)bench_build(BENCH_SEGARRAY, n, &counter, true) / 1e6);
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "rz_common.h"
+#include "rz_collections.h"
+
+#include "bench_utils.h"
+
+/// scan of one (and two) fields of 10M records, stored as RZ_Array of structs (AoS) and RZ_SOA_DEFINE (SoA).
+/// also the cost of building both layouts with push.
+///   bench_rz_soa [records]
+
+RZ_SOA_DEFINE(Bodies, (rz_f32, x), (rz_f32, y), (rz_f32, z), (rz_f32, vx), (rz_f32, vy), (rz_f32, vz), (rz_f64, mass), (rz_u64, id),
+              (rz_u32, flags));
+typedef RZ_Array(BodiesItem) BodiesArray;
+
+static BodiesItem bench_body(rz_usize i) {
+    return (BodiesItem){.x = (rz_f32)(i & 1023U), .y = 1, .z = 2, .vx = 3, .vy = 4, .vz = 5, .mass = 1.5, .id = i, .flags = (rz_u32)(i % 3)};
+}
+
+int main(int argc, char **argv) {
+    rz_usize n = rz_bench_arg(argc, argv, 1, 10000000);
+
+    BodiesArray aos = {.allocator = rz_std_allocator()};
+    Bodies      soa = {.allocator = rz_std_allocator()};
+    printf("records: %zu, AoS item %zu B\n", n, sizeof(BodiesItem));
+    RZ_BENCH("AoS build (rz_arr_push)", n, {
+        aos.len = 0;
+        for (rz_usize i = 0; i < n; ++i) rz_arr_push(&aos, bench_body(i));
+        rz_bench_keep(aos.data);
+    });
+    RZ_BENCH("SoA build (Bodies_push)", n, {
+        Bodies_clear(&soa);
+        for (rz_usize i = 0; i < n; ++i) Bodies_push(&soa, bench_body(i));
+        rz_bench_keep(soa.x);
+    });
+
+    rz_f64 expected = 0;
+    for (rz_usize i = 0; i < n; ++i) expected += aos.data[i].x;
+    RZ_BENCH("AoS sum(x)", n, {
+        rz_f64 sum = 0;
+        for (rz_usize i = 0; i < aos.len; ++i) sum += aos.data[i].x;
+        RZ_ASSERT(sum == expected);
+    });
+    RZ_BENCH("SoA sum(x)", n, {
+        rz_f64 sum = 0;
+        for (rz_usize i = 0; i < soa.len; ++i) sum += soa.x[i];
+        RZ_ASSERT(sum == expected);
+    });
+    RZ_BENCH("AoS sum(x) where flags == 1", n, {
+        rz_f64 sum = 0;
+        for (rz_usize i = 0; i < aos.len; ++i) sum += (aos.data[i].flags == 1) ? aos.data[i].x : 0;
+        rz_bench_keep(sum);
+    });
+    RZ_BENCH("SoA sum(x) where flags == 1", n, {
+        rz_f64 sum = 0;
+        for (rz_usize i = 0; i < soa.len; ++i) sum += (soa.flags[i] == 1) ? soa.x[i] : 0;
+        rz_bench_keep(sum);
+    });
+
+    rz_arr_free(&aos);
+    Bodies_free(&soa);
+    return 0;
+}
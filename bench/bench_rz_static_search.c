@@ -0,0 +1,68 @@
+#include "rz_common.h"
+#include "rz_collections.h"
+
+#include "bench_utils.h"
+
+/// RZ_StaticSearchU32 (Eytzinger layout) against rz_arr_bsearch, from the table that fit in L1 to out of cache.
+/// the inline branchless binary search on the sorted array separate the cost of the layout from the cost of
+/// the `cmpfunc` call of rz_arr_bsearch. half of the lookups is a hit.
+///   bench_rz_static_search [lookups] [max_items]
+
+typedef RZ_Array(rz_u32) U32Array;
+
+static int bench_cmp_u32(const void *a, const void *b) {
+    rz_u32 x = *(const rz_u32 *)a, y = *(const rz_u32 *)b;
+    return (x > y) - (x < y);
+}
+
+static inline rz_usize bench_branchless_lower_bound(const rz_u32 *data, rz_usize len, rz_u32 key) {
+    const rz_u32 *base = data;
+    while (len > 1) {
+        rz_usize half = len / 2;
+        base         += (rz_usize)(base[half - 1] < key) * half;
+        len          -= half;
+    }
+    return (rz_usize)(base - data) + (*base < key);
+}
+
+int main(int argc, char **argv) {
+    rz_usize lookups   = rz_bench_arg(argc, argv, 1, 1U << 22U);
+    rz_usize max_items = rz_bench_arg(argc, argv, 2, 1U << 26U);
+    rz_u64   rng       = 0xE472;
+
+    rz_u32 *queries = malloc(lookups * sizeof(rz_u32));
+    for (rz_usize len = 1U << 10U; len <= max_items; len <<= 4U) {
+        // the even numbers, the odd query is a miss
+        U32Array sorted = {.allocator = rz_std_allocator()};
+        rz_arr_reserve(&sorted, len);
+        for (rz_usize i = 0; i < len; ++i) rz_arr_push(&sorted, (rz_u32)(i * 2));
+        for (rz_usize i = 0; i < lookups; ++i) queries[i] = (rz_u32)(rz_bench_rand(&rng) % (len * 2));
+        RZ_StaticSearchU32 table = {.allocator = rz_std_allocator()};
+        RZ_StaticSearchU32_build(&table, sorted.data, sorted.len);
+
+        printf("%zu items (%zu KB)\n", len, (len * sizeof(rz_u32)) >> 10U);
+        rz_usize hits = 0;
+        RZ_BENCH("  rz_arr_bsearch", lookups, {
+            hits = 0;
+            for (rz_usize i = 0; i < lookups; ++i) hits += (rz_arr_bsearch(&sorted, queries[i], bench_cmp_u32) != RZ_ARR_FIND_NOTFOUND);
+        });
+        RZ_BENCH("  branchless lower bound (sorted array)", lookups, {
+            rz_usize found = 0;
+            for (rz_usize i = 0; i < lookups; ++i) {
+                rz_usize j = bench_branchless_lower_bound(sorted.data, sorted.len, queries[i]);
+                found += (j < sorted.len && sorted.data[j] == queries[i]);
+            }
+            RZ_ASSERT(found == hits);
+        });
+        RZ_BENCH("  RZ_StaticSearchU32_find", lookups, {
+            rz_usize found = 0;
+            for (rz_usize i = 0; i < lookups; ++i) found += (RZ_StaticSearchU32_find(&table, queries[i]) != RZ_ARR_FIND_NOTFOUND);
+            RZ_ASSERT(found == hits);
+        });
+
+        RZ_StaticSearchU32_free(&table);
+        rz_arr_free(&sorted);
+    }
+    free(queries);
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <strings.h>
+
+#include "rz_collections.h"
+#include "rz_common.h"
+#include "rz_strings.h"
+
+#include "bench_utils.h"
+
+/// the ASCII case folding: rz_sv_to_ascii_lowercase/uppercase against the rz_ascii_lower loop they were before,
+/// rz_sv_case_cmp against the old one (the length then strncasecmp) on the header names and on 4 KB strings,
+/// rz_sv_case_find against strcasestr and the lowercase copy + rz_sv_find on the generated log (the needle is
+/// absent, so the search go over the whole log), and rz_sv_case_hash against the lowercase copy + the hash.
+/// build with -DRZ_NO_SIMD for the scalar loops, or with -mavx2 for AVX2, SSE2 by default on x86_64.
+///   bench_rz_strings_case [bytes]
+
+static void bench_old_lowercase(RZ_StrView *sv) {
+    rz_foreach(c, sv) *c = rz_ascii_lower(*c);
+}
+
+static rz_ptrdiff bench_old_case_cmp(RZ_StrView lhs, RZ_StrView rhs) {
+    if (lhs.len == 0 || rhs.len == 0) return (rz_ptrdiff)(lhs.len != 0) - (rz_ptrdiff)(rhs.len != 0);
+    if (lhs.len != rhs.len) return (rz_ptrdiff)lhs.len - (rz_ptrdiff)rhs.len;
+    return strncasecmp(lhs.data, rhs.data, lhs.len);
+}
+
+// the lowercase copy in `buf` (of the size of the haystack) then the case-sensitive search
+static rz_usize bench_copy_find(RZ_StrView sv, RZ_StrView lower_needle, char *buf) {
+    memcpy(buf, sv.data, sv.len);
+    RZ_StrView copy = rz_sv_sized(buf, sv.len);
+    rz_sv_to_ascii_lowercase(&copy);
+    return rz_sv_find(copy, lower_needle);
+}
+
+static rz_usize bench_copy_hash(RZ_StrView sv, rz_usize seed) {
+    char buf[256];
+    memcpy(buf, sv.data, sv.len);
+    RZ_StrView copy = rz_sv_sized(buf, sv.len);
+    rz_sv_to_ascii_lowercase(&copy);
+    return rz_hm_default_hash(buf, copy.len, seed);
+}
+
+static const char *const bench_headers[] = {"Content-Type",  "content-length", "X-Forwarded-For", "Accept-Encoding", "User-Agent",
+                                            "Cache-Control", "If-None-Match",  "Authorization",   "Connection",      "Host"};
+
+static rz_usize bench_text(char *buf, rz_usize bytes) {
+    rz_u64   rng = 0xCA5E;
+    rz_usize len = 0;
+    while (len + 256 < bytes) {
+        rz_u64 r  = rz_bench_rand(&rng);
+        len      += (rz_usize)snprintf(buf + len, 256, "GET /Api/V1/Users?Id=%u HTTP/1.1\r\n%s: Value-%u\r\n", (rz_u32)(r % 100000),
+                                       bench_headers[(r >> 20U) % RZ_ARRAY_LEN(bench_headers)], (rz_u32)((r >> 32U) % 1000));
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+int main(int argc, char **argv) {
+    rz_usize   bytes = rz_bench_arg(argc, argv, 1, 64U << 20U);
+    char      *buf   = malloc(bytes + 1);
+    char      *copy  = malloc(bytes + 1);
+    RZ_StrView text  = rz_sv_sized(buf, bench_text(buf, bytes));
+    printf("text: %zu MB, simd: %s\n", text.len >> 20U, RZ_TARGET_SIMD_AVX2 ? "avx2" : RZ_TARGET_SIMD_SSE2 ? "sse2" : RZ_TARGET_SIMD_NEON ? "neon" : "none");
+
+    printf("conversion\n");
+    RZ_StrView conv = rz_sv_sized(copy, text.len);
+    memcpy(copy, text.data, text.len);
+    RZ_BENCH_BYTES("  old lowercase (rz_ascii_lower loop)", conv.len, bench_old_lowercase(&conv));
+    RZ_BENCH_BYTES("  rz_sv_to_ascii_lowercase", conv.len, rz_sv_to_ascii_lowercase(&conv));
+    RZ_BENCH_BYTES("  rz_sv_to_ascii_uppercase", conv.len, rz_sv_to_ascii_uppercase(&conv));
+
+    // the header names against the other case of themselves, and the 4 KB blocks of the text
+    rz_usize   count = RZ_ARRAY_LEN(bench_headers), reps = 1000000 / count;
+    RZ_StrView names[RZ_ARRAY_LEN(bench_headers)], upper[RZ_ARRAY_LEN(bench_headers)];
+    char       upper_buf[RZ_ARRAY_LEN(bench_headers)][32];
+    for (rz_usize i = 0; i < count; ++i) {
+        names[i] = rz_sv(bench_headers[i]);
+        memcpy(upper_buf[i], names[i].data, names[i].len);
+        upper[i] = rz_sv_sized(upper_buf[i], names[i].len);
+        rz_sv_to_ascii_uppercase(&upper[i]);
+    }
+    printf("compare, equal ignoring the case\n");
+    // strncasecmp is pure, the keep of the views stop the compiler from calling it once out of the loop
+    RZ_BENCH("  header names: old rz_sv_case_cmp (strncasecmp)", reps * count, for (rz_usize r = 0; r < reps; ++r) for (rz_usize i = 0; i < count; ++i) {
+        rz_bench_keep(upper[i].data);
+        RZ_ASSERT(bench_old_case_cmp(names[i], upper[i]) == 0);
+    });
+    RZ_BENCH("  header names: rz_sv_case_cmp", reps * count, for (rz_usize r = 0; r < reps; ++r) for (rz_usize i = 0; i < count; ++i) {
+        rz_bench_keep(upper[i].data);
+        RZ_ASSERT(rz_sv_case_cmp(names[i], upper[i]) == 0);
+    });
+    RZ_StrView conv_block = rz_sv_sized(conv.data, 4096), text_block = rz_sv_sized(text.data, 4096);
+    RZ_BENCH_BYTES("  4 KB: old rz_sv_case_cmp (strncasecmp)", 4096 * 4096, for (rz_usize r = 0; r < 4096; ++r) {
+        rz_bench_keep(conv_block.data);
+        RZ_ASSERT(bench_old_case_cmp(conv_block, text_block) == 0);
+    });
+    RZ_BENCH_BYTES("  4 KB: rz_sv_case_cmp", 4096 * 4096, for (rz_usize r = 0; r < 4096; ++r) {
+        rz_bench_keep(conv_block.data);
+        RZ_ASSERT(rz_sv_case_cmp(conv_block, text_block) == 0);
+    });
+
+    const char *const needles[] = {"gzip", "x-request-id: abc"};
+    for (rz_usize n = 0; n < RZ_ARRAY_LEN(needles); ++n) {
+        RZ_StrView needle = rz_sv(needles[n]);
+        printf("find \"%s\" (absent)\n", needles[n]);
+        RZ_BENCH_BYTES("  rz_sv_find (case-sensitive)", text.len, RZ_ASSERT(rz_sv_find(text, needle) == RZ_NOT_FOUND));
+        RZ_BENCH_BYTES("  strcasestr", text.len, RZ_ASSERT(strcasestr(text.data, needles[n]) == NULL));
+        RZ_BENCH_BYTES("  lowercase copy + rz_sv_find", text.len, RZ_ASSERT(bench_copy_find(text, needle, copy) == RZ_NOT_FOUND));
+        RZ_BENCH_BYTES("  rz_sv_case_find", text.len, RZ_ASSERT(rz_sv_case_find(text, needle) == RZ_NOT_FOUND));
+    }
+
+    printf("hash of the header names\n");
+    RZ_BENCH("  rz_hm_default_hash (case-sensitive)", reps * count, for (rz_usize r = 0; r < reps; ++r) for (rz_usize i = 0; i < count; ++i) {
+        rz_bench_keep(rz_hm_default_hash(upper[i].data, upper[i].len, 0));
+    });
+    RZ_BENCH("  lowercase copy + rz_hm_default_hash", reps * count, for (rz_usize r = 0; r < reps; ++r) for (rz_usize i = 0; i < count; ++i) {
+        rz_bench_keep(bench_copy_hash(upper[i], 0));
+    });
+    rz_usize hashes[RZ_ARRAY_LEN(bench_headers)];
+    for (rz_usize i = 0; i < count; ++i) hashes[i] = bench_copy_hash(names[i], 0);
+    RZ_BENCH("  rz_sv_case_hash", reps * count, for (rz_usize r = 0; r < reps; ++r) for (rz_usize i = 0; i < count; ++i) {
+        RZ_ASSERT(rz_sv_case_hash(upper[i], 0) == hashes[i]);
+    });
+
+    free(buf);
+    free(copy);
+    return 0;
+}
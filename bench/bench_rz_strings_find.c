@@ -0,0 +1,88 @@
+#include "rz_common.h"
+#include "rz_strings.h"
+
+#include "bench_utils.h"
+
+/// substring search in a generated log buffer: rz_sv_find, rz_sv_finder_find and rz_sv_rfind against the old
+/// rz_sv_find loop (rz_sv_eq at every offset) and memmem, for the short, medium and long needles that is rare
+/// in the log, and for the needle that is the worst case of the filter ("aa...ab" in "aa...a").
+/// build with -DRZ_NO_SIMD for the scalar filter, or with -mavx2 for the AVX2 filter (SSE2 by default on x86_64).
+///   bench_rz_strings_find [bytes]
+
+static const char *const bench_levels[]   = {"INFO ", "INFO ", "INFO ", "DEBUG", "WARN "};
+static const char *const bench_paths[]    = {"/api/v1/users", "/api/v1/orders", "/static/app.js", "/healthz", "/api/v2/search?q=shoes"};
+static const char *const bench_messages[] = {"request done", "cache hit", "cache miss, loading from the database", "slow query", "retry"};
+
+static rz_usize bench_log(char *buf, rz_usize bytes) {
+    rz_u64   rng = 0x106;
+    rz_usize len = 0;
+    while (len + 256 < bytes) {
+        rz_u64 r = rz_bench_rand(&rng);
+        len     += (rz_usize)snprintf(buf + len, 256, "2026-10-19T%02u:%02u:%02u.%03uZ %s [worker-%u] %s path=%s status=200 ms=%u\n",
+                                      (rz_u32)(r % 24), (rz_u32)((r >> 8U) % 60), (rz_u32)((r >> 16U) % 60), (rz_u32)((r >> 24U) % 1000),
+                                      bench_levels[(r >> 32U) % 5], (rz_u32)((r >> 36U) % 16), bench_messages[(r >> 40U) % 5], bench_paths[(r >> 44U) % 5],
+                                      (rz_u32)((r >> 48U) % 500));
+    }
+    return len;
+}
+
+// the rz_sv_find before the filter, with the bound of the last offset fixed
+static rz_usize bench_naive_find(RZ_StrView sv, RZ_StrView needle) {
+    if (needle.len > sv.len) return RZ_NOT_FOUND;
+    for (rz_usize i = 0; i + needle.len <= sv.len; ++i) {
+        if (rz_sv_eq(rz_sv_sized(sv.data + i, needle.len), needle)) return i;
+    }
+    return RZ_NOT_FOUND;
+}
+
+static rz_usize bench_naive_rfind(RZ_StrView sv, RZ_StrView needle) {
+    if (needle.len > sv.len) return RZ_NOT_FOUND;
+    for (rz_usize i = sv.len - needle.len + 1; i-- > 0;) {
+        if (rz_sv_eq(rz_sv_sized(sv.data + i, needle.len), needle)) return i;
+    }
+    return RZ_NOT_FOUND;
+}
+
+static rz_usize bench_memmem(RZ_StrView sv, RZ_StrView needle) {
+    const char *p = memmem(sv.data, sv.len, needle.data, needle.len);
+    return (p == NULL) ? RZ_NOT_FOUND : (rz_usize)(p - sv.data);
+}
+
+static void bench_needle(const char *name, RZ_StrView hay, RZ_StrView needle) {
+    rz_usize expected = bench_memmem(hay, needle);
+    printf("%s (%zu bytes): %s\n", name, needle.len, (expected == RZ_NOT_FOUND) ? "not found" : "found");
+    RZ_BENCH_BYTES("  old rz_sv_find (rz_sv_eq at every offset)", hay.len, RZ_ASSERT(bench_naive_find(hay, needle) == expected));
+    RZ_BENCH_BYTES("  memmem", hay.len, RZ_ASSERT(bench_memmem(hay, needle) == expected));
+    RZ_BENCH_BYTES("  rz_sv_find", hay.len, RZ_ASSERT(rz_sv_find(hay, needle) == expected));
+    RZ_StrFinder finder = rz_sv_finder(needle);
+    RZ_BENCH_BYTES("  rz_sv_finder_find", hay.len, RZ_ASSERT(rz_sv_finder_find(&finder, hay) == expected));
+    rz_usize last = rz_sv_rfind(hay, needle);
+    RZ_BENCH_BYTES("  old rz_sv_rfind", hay.len, RZ_ASSERT(bench_naive_rfind(hay, needle) == last));
+    RZ_BENCH_BYTES("  rz_sv_rfind", hay.len, RZ_ASSERT(rz_sv_rfind(hay, needle) == last));
+}
+
+int main(int argc, char **argv) {
+    rz_usize bytes = rz_bench_arg(argc, argv, 1, 64U << 20U);
+    char    *buf   = malloc(bytes);
+    rz_usize len   = bench_log(buf, bytes);
+    RZ_StrView log = rz_sv_sized(buf, len);
+    printf("log: %zu MB, simd: %s\n", len >> 20U, RZ_TARGET_SIMD_AVX2 ? "avx2" : RZ_TARGET_SIMD_SSE2 ? "sse2" : RZ_TARGET_SIMD_NEON ? "neon" : "none");
+
+    bench_needle("short", log, rz_sv("ERROR"));
+    bench_needle("medium", log, rz_sv("status=503"));
+    bench_needle("long", log, rz_sv("connection reset by peer while reading the response"));
+    // the first and the last byte match in the lines of the workers 10..15, the filter verify often
+    bench_needle("frequent candidates", log, rz_sv("INFO  [worker-19]"));
+
+    // the worst case of the filter: every offset is a candidate, the old loop is O(n * m)
+    rz_usize worst_len = RZ_MIN(len, 4U << 20U);
+    memset(buf, 'a', worst_len);
+    char needle[257];
+    memset(needle, 'a', sizeof(needle) - 2);
+    needle[sizeof(needle) - 2] = 'b';
+    needle[sizeof(needle) - 1] = '\0';
+    bench_needle("\"a..ab\" in \"a..a\"", rz_sv_sized(buf, worst_len), rz_sv(needle));
+
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include "rz_common.h"
+#include "rz_strings.h"
+
+#include "bench_utils.h"
+
+/// the edit distances: rz_sv_levenshtein_distance and rz_sv_osa_distance (bit-parallel) against the O(n * m)
+/// DP that they were before (the row in the temp allocator, the 3 rows for OSA), on the generated symbol table
+/// (the identifiers of 2 to 5 words, ~20 chars) with the query that has 2 typos, and on the long strings of 64
+/// to 1000 chars (the multi word bit vectors). the "did you mean" search: every candidate with the bound
+/// (rz_sv_levenshtein_distance_max) and rz_sv_fuzzy_top_k.
+///   bench_rz_strings_fuzzy [symbols]
+
+// rz_sv_levenshtein_distance before the bit vectors (with the row of b_len + 1, the old one wrote past the end)
+static rz_usize bench_dp_levenshtein(RZ_StrView a, RZ_StrView b) {
+    if (b.len == 0) return a.len;
+    auto     save  = rz_temp_snapshot();
+    rz_usize *cache = rz_alloc_bytes(rz_temp_allocator(), sizeof(rz_usize) * (b.len + 1));
+    for (rz_usize j = 0; j < b.len; ++j) cache[j] = j + 1;
+
+    rz_usize result = b.len;
+    for (rz_usize i = 0; i < a.len; ++i) {
+        result              = i + 1;
+        rz_usize distance_b = i;
+        for (rz_usize j = 0; j < b.len; ++j) {
+            rz_usize distance_a = distance_b + (rz_usize)(a.data[i] != b.data[j]);
+            distance_b          = cache[j];
+            result              = RZ_MIN(result + 1, RZ_MIN(distance_a, distance_b + 1));
+            cache[j]            = result;
+        }
+    }
+    rz_temp_rewind(save);
+    return result;
+}
+
+// rz_sv_osa_distance before the bit vectors, the 3 rows of the DP
+static rz_usize bench_dp_osa(RZ_StrView a, RZ_StrView b) {
+    auto      save = rz_temp_snapshot();
+    rz_usize *rows = rz_alloc_bytes(rz_temp_allocator(), sizeof(rz_usize) * 3 * (b.len + 1));
+    rz_usize *prev2 = rows, *prev = rows + b.len + 1, *curr = rows + 2 * (b.len + 1);
+    for (rz_usize j = 0; j <= b.len; ++j) prev2[j] = prev[j] = j;
+
+    for (rz_usize i = 0; i < a.len; ++i) {
+        curr[0] = i + 1;
+        for (rz_usize j = 0; j < b.len; ++j) {
+            rz_usize cost = (rz_usize)(a.data[i] != b.data[j]);
+            curr[j + 1]   = RZ_MIN(curr[j] + 1, RZ_MIN(prev[j + 1] + 1, prev[j] + cost));
+            if (i > 0 && j > 0 && cost && a.data[i] == b.data[j - 1] && a.data[i - 1] == b.data[j]) {
+                curr[j + 1] = RZ_MIN(curr[j + 1], prev2[j - 1] + 1);
+            }
+        }
+        rz_usize *tmp = prev2;
+        prev2         = prev;
+        prev          = curr;
+        curr          = tmp;
+    }
+    rz_usize result = prev[b.len];
+    rz_temp_rewind(save);
+    return result;
+}
+
+static const char *const bench_words[] = {"str", "sv", "arr", "hm", "find", "char", "split", "once", "insert", "remove", "get",
+                                          "set", "parse", "many", "ascii", "lower", "utf8", "iter", "next", "alloc", "temp", "buffer"};
+
+// `count` identifiers "rz_word_word..." in `buf`
+static void bench_symbols(RZ_Str *buf, RZ_StrView *svs, rz_usize count) {
+    rz_u64    rng   = 0xF022;
+    rz_usize *start = malloc(count * sizeof(rz_usize));
+    for (rz_usize i = 0; i < count; ++i) {
+        rz_u64 r = rz_bench_rand(&rng);
+        start[i] = buf->len;
+        rz_str_append_cstr(buf, "rz");
+        for (rz_u64 w = 0; w < 2 + (r % 4); ++w) {
+            rz_str_append_cstr(buf, "_");
+            rz_str_append_cstr(buf, bench_words[(r >> (8 + w * 6)) % RZ_ARRAY_LEN(bench_words)]);
+        }
+    }
+    // the views after the appends, the buffer moved
+    for (rz_usize i = 0; i < count; ++i) svs[i] = rz_sv_sized(buf->data + start[i], ((i + 1 < count) ? start[i + 1] : buf->len) - start[i]);
+    free(start);
+}
+
+// the copy of `sv` with 2 substitutions
+static RZ_StrView bench_typos(RZ_StrView sv, char *out, rz_u64 *rng) {
+    memcpy(out, sv.data, sv.len);
+    for (rz_usize t = 0; t < 2; ++t) out[3 + rz_bench_rand(rng) % (sv.len - 3)] = 'q';
+    return rz_sv_sized(out, sv.len);
+}
+
+int main(int argc, char **argv) {
+    rz_usize    count   = rz_bench_arg(argc, argv, 1, 50000);
+    RZ_Str      buf     = {.allocator = rz_std_allocator()};
+    RZ_StrView *symbols = malloc(count * sizeof(RZ_StrView));
+    bench_symbols(&buf, symbols, count);
+
+    rz_u64     rng = 0x7E57;
+    char       query_buf[64];
+    RZ_StrView query = bench_typos(symbols[count / 2], query_buf, &rng);
+    rz_usize   chars = 0, want = 0;
+    for (rz_usize i = 0; i < count; ++i) chars += symbols[i].len;
+    printf("symbols: %zu, %.1f chars, query \"%.*s\"\n", count, (rz_f64)chars / (rz_f64)count, (int)query.len, query.data);
+
+    printf("query against every symbol\n");
+    RZ_BENCH("  old levenshtein (DP)", count, {
+        want = 0;
+        for (rz_usize i = 0; i < count; ++i) want += bench_dp_levenshtein(query, symbols[i]);
+    });
+    RZ_BENCH("  rz_sv_levenshtein_distance", count, {
+        rz_usize sum = 0;
+        for (rz_usize i = 0; i < count; ++i) sum += rz_sv_levenshtein_distance(query, symbols[i]);
+        RZ_ASSERT(sum == want);
+    });
+    RZ_BENCH("  old osa (DP)", count, {
+        want = 0;
+        for (rz_usize i = 0; i < count; ++i) want += bench_dp_osa(query, symbols[i]);
+    });
+    RZ_BENCH("  rz_sv_osa_distance", count, {
+        rz_usize sum = 0;
+        for (rz_usize i = 0; i < count; ++i) sum += rz_sv_osa_distance(query, symbols[i]);
+        RZ_ASSERT(sum == want);
+    });
+    RZ_BENCH("  rz_sv_levenshtein_distance_max (3)", count, {
+        rz_usize near = 0;
+        for (rz_usize i = 0; i < count; ++i) near += (rz_sv_levenshtein_distance_max(query, symbols[i], 3) <= 3);
+        RZ_ASSERT(near > 0);
+    });
+    RZ_StrMatch top[5];
+    RZ_BENCH("  rz_sv_fuzzy_top_k (5, max 3)", count, {
+        RZ_ASSERT(rz_sv_fuzzy_top_k(query, symbols, count, top, 5, .max_distance = 3) > 0);
+        RZ_ASSERT(top[0].distance <= 2);
+    });
+    RZ_BENCH("  rz_sv_fuzzy_top_k (5, osa, no max)", count, {
+        RZ_ASSERT(rz_sv_fuzzy_top_k(query, symbols, count, top, 5, .transpositions = true) == 5);
+        RZ_ASSERT(top[0].distance <= 2);
+    });
+
+    // the long strings: the log lines of `len` chars against the copies with 1 typo every 16 chars
+    const rz_usize lens[] = {64, 200, 1000};
+    for (rz_usize l = 0; l < RZ_ARRAY_LEN(lens); ++l) {
+        rz_usize len = lens[l], pairs = 200000 / len;
+        char    *a   = malloc(len), *b = malloc(len);
+        for (rz_usize i = 0; i < len; ++i) a[i] = bench_words[rz_bench_rand(&rng) % RZ_ARRAY_LEN(bench_words)][0];
+        memcpy(b, a, len);
+        for (rz_usize i = 0; i < len; i += 16) b[i] = 'Q';
+        RZ_StrView sa = rz_sv_sized(a, len), sb = rz_sv_sized(b, len);
+        rz_usize   distance = bench_dp_levenshtein(sa, sb);
+        printf("%zu chars, distance %zu\n", len, distance);
+        RZ_BENCH("  old levenshtein (DP)", pairs, for (rz_usize i = 0; i < pairs; ++i) RZ_ASSERT(bench_dp_levenshtein(sa, sb) == distance));
+        RZ_BENCH("  rz_sv_levenshtein_distance", pairs, for (rz_usize i = 0; i < pairs; ++i) RZ_ASSERT(rz_sv_levenshtein_distance(sa, sb) == distance));
+        RZ_BENCH("  old osa (DP)", pairs, for (rz_usize i = 0; i < pairs; ++i) rz_bench_keep(bench_dp_osa(sa, sb)));
+        RZ_BENCH("  rz_sv_osa_distance", pairs, for (rz_usize i = 0; i < pairs; ++i) rz_bench_keep(rz_sv_osa_distance(sa, sb)));
+        free(a);
+        free(b);
+    }
+
+    rz_str_free(&buf);
+    free(symbols);
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "rz_common.h"
+#include "rz_strings.h"
+
+#include "bench_utils.h"
+
+/// number parsing from the views: rz_sv_parse_i64/u64/f64/f32 and rz_sv_parse_many_* against strtoll, strtoull,
+/// strtod and strtof on the same bytes (nul terminated, so the libc does not need the copy), and against the copy
+/// of the view into the nul terminated buffer + strtod (what the view that is not nul terminated need).
+/// the numbers: short integers (the ids, the counts), 19 digits u64, prices ("1234.56"), the doubles printed with
+/// %.17g (the round trip of random doubles) and the floats with %.9g.
+///   bench_rz_strings_parse [count]
+
+typedef struct {
+    char       *buf;
+    RZ_StrView *svs;
+    rz_usize    count;
+    rz_usize    bytes;
+} BenchNumbers;
+
+// every number is nul terminated in `buf`, the views does not include the nul
+static BenchNumbers bench_numbers(rz_usize count, rz_u32 kind) {
+    BenchNumbers n   = {.buf = malloc(count * 32), .svs = malloc(count * sizeof(RZ_StrView)), .count = count};
+    rz_u64       rng = 0x9A25 + kind;
+    for (rz_usize i = 0; i < count; ++i) {
+        rz_u64 r   = rz_bench_rand(&rng);
+        char  *p   = n.buf + n.bytes;
+        int    len = 0;
+        if (kind == 0) {
+            // 1 to 6 digits, a quarter negative
+            static const rz_u64 pow10[] = {10, 100, 1000, 10000, 100000, 1000000};
+            rz_i64              v       = (rz_i64)(r % pow10[(r >> 56U) % 6]);
+            len                         = snprintf(p, 32, "%lld", (long long)(((r >> 62U) == 0) ? -v : v));
+        } else if (kind == 1) len = snprintf(p, 32, "%llu", (unsigned long long)(r | (1ULL << 63U)));
+        else if (kind == 2) len = snprintf(p, 32, "%u.%02u", (rz_u32)((r >> 8U) % 100000), (rz_u32)(r % 100));
+        else {
+            rz_f64 v;
+            rz_u64 bits = (r & ~(0x7FFULL << 52U)) | ((rz_u64)(1023 - 30 + (r >> 52U) % 60) << 52U);
+            memcpy(&v, &bits, sizeof(v));
+            len = (kind == 3) ? snprintf(p, 32, "%.17g", v) : snprintf(p, 32, "%.9g", (rz_f64)(rz_f32)v);
+        }
+        n.svs[i]  = rz_sv_sized(p, (rz_usize)len);
+        n.bytes  += (rz_usize)len + 1;
+    }
+    return n;
+}
+
+static void bench_numbers_free(BenchNumbers *n) {
+    free(n->buf);
+    free(n->svs);
+}
+
+// the view is copied into the nul terminated buffer for strtod
+static rz_f64 bench_copy_strtod(RZ_StrView sv) {
+    char tmp[64];
+    memcpy(tmp, sv.data, sv.len);
+    tmp[sv.len] = '\0';
+    return strtod(tmp, NULL);
+}
+
+int main(int argc, char **argv) {
+    rz_usize count = rz_bench_arg(argc, argv, 1, 1000000);
+    void    *out   = malloc(count * sizeof(rz_u64));
+    void    *want  = malloc(count * sizeof(rz_u64));
+
+    const char *const names[] = {"short i64", "19 digits u64", "price f64 (1234.56)", "%.17g f64", "%.9g f32"};
+    for (rz_u32 kind = 0; kind < RZ_ARRAY_LEN(names); ++kind) {
+        BenchNumbers n = bench_numbers(count, kind);
+        printf("%s: %zu numbers, %.1f bytes per number\n", names[kind], count, (rz_f64)n.bytes / (rz_f64)count - 1.0);
+        rz_i64 *i64 = out, *want_i64 = want;
+        rz_u64 *u64 = out, *want_u64 = want;
+        rz_f64 *f64 = out, *want_f64 = want;
+        rz_f32 *f32 = out, *want_f32 = want;
+        if (kind == 0) {
+            RZ_BENCH("  strtoll", count, for (rz_usize i = 0; i < count; ++i) want_i64[i] = strtoll(n.svs[i].data, NULL, 10));
+            RZ_BENCH("  rz_sv_parse_i64", count, for (rz_usize i = 0; i < count; ++i) rz_sv_parse_i64(n.svs[i], &i64[i]));
+            RZ_ASSERT(memcmp(out, want, count * sizeof(rz_i64)) == 0);
+            RZ_BENCH("  rz_sv_parse_many_i64", count, RZ_ASSERT(rz_sv_parse_many_i64(n.svs, count, i64) == count));
+        } else if (kind == 1) {
+            RZ_BENCH("  strtoull", count, for (rz_usize i = 0; i < count; ++i) want_u64[i] = strtoull(n.svs[i].data, NULL, 10));
+            RZ_BENCH("  rz_sv_parse_u64", count, for (rz_usize i = 0; i < count; ++i) rz_sv_parse_u64(n.svs[i], &u64[i]));
+            RZ_ASSERT(memcmp(out, want, count * sizeof(rz_u64)) == 0);
+            RZ_BENCH("  rz_sv_parse_many_u64", count, RZ_ASSERT(rz_sv_parse_many_u64(n.svs, count, u64) == count));
+        } else if (kind < 4) {
+            RZ_BENCH("  strtod", count, for (rz_usize i = 0; i < count; ++i) want_f64[i] = strtod(n.svs[i].data, NULL));
+            RZ_BENCH("  copy + strtod", count, for (rz_usize i = 0; i < count; ++i) f64[i] = bench_copy_strtod(n.svs[i]));
+            RZ_BENCH("  rz_sv_parse_f64", count, for (rz_usize i = 0; i < count; ++i) rz_sv_parse_f64(n.svs[i], &f64[i]));
+            RZ_ASSERT(memcmp(out, want, count * sizeof(rz_f64)) == 0);
+            RZ_BENCH("  rz_sv_parse_many_f64", count, RZ_ASSERT(rz_sv_parse_many_f64(n.svs, count, f64) == count));
+        } else {
+            RZ_BENCH("  strtof", count, for (rz_usize i = 0; i < count; ++i) want_f32[i] = strtof(n.svs[i].data, NULL));
+            RZ_BENCH("  rz_sv_parse_f32", count, for (rz_usize i = 0; i < count; ++i) rz_sv_parse_f32(n.svs[i], &f32[i]));
+            RZ_ASSERT(memcmp(out, want, count * sizeof(rz_f32)) == 0);
+            RZ_BENCH("  rz_sv_parse_many_f32", count, RZ_ASSERT(rz_sv_parse_many_f32(n.svs, count, f32) == count));
+        }
+        bench_numbers_free(&n);
+    }
+
+    free(out);
+    free(want);
+    return 0;
+}
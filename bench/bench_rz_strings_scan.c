@@ -0,0 +1,154 @@
+#include "rz_common.h"
+#include "rz_strings.h"
+
+#include "bench_utils.h"
+
+/// the single byte scans in a generated log buffer: rz_sv_find_char, rz_sv_rfind_char, the line splitting with
+/// rz_sv_split_char / rz_sv_rsplit_char, rz_sv_find_any / rz_sv_split_any and rz_sv_trim_char, against the byte
+/// by byte loops they were before (and memchr/memrchr, the 256 entries table for the byte sets).
+/// the byte that is absent make the scan go over the whole buffer. build with -DRZ_NO_SIMD for the scalar loops,
+/// or with -mavx2 for AVX2 (the nibble shuffle of the byte sets), SSE2 by default on x86_64.
+///   bench_rz_strings_scan [bytes]
+
+static rz_usize bench_log(char *buf, rz_usize bytes) {
+    static const char *const paths[] = {"/api/v1/users", "/api/v1/orders", "/static/app.js", "/healthz", "/api/v2/search?q=shoes"};
+    rz_u64                   rng     = 0x5CA;
+    rz_usize                 len     = 0;
+    while (len + 256 < bytes) {
+        rz_u64 r = rz_bench_rand(&rng);
+        len     += (rz_usize)snprintf(buf + len, 256, "2026-10-19T%02u:%02u:%02u INFO [worker-%u] request done path=%s status=200 ms=%u\r\n",
+                                      (rz_u32)(r % 24), (rz_u32)((r >> 8U) % 60), (rz_u32)((r >> 16U) % 60), (rz_u32)((r >> 24U) % 16),
+                                      paths[(r >> 32U) % 5], (rz_u32)((r >> 40U) % 500));
+    }
+    return len;
+}
+
+// rz_sv_find_char, rz_sv_rfind_char and the trims before the vectorized scans
+static rz_usize bench_old_find_char(RZ_StrView sv, rz_char needle) {
+    for (rz_usize i = 0; i < sv.len; ++i) {
+        if (sv.data[i] == needle) return i;
+    }
+    return RZ_NOT_FOUND;
+}
+
+static rz_usize bench_old_rfind_char(RZ_StrView sv, rz_char needle) {
+    for (rz_usize i = sv.len; i-- > 0;) {
+        if (sv.data[i] == needle) return i;
+    }
+    return RZ_NOT_FOUND;
+}
+
+static RZ_StrView bench_old_trim_char(RZ_StrView sv, rz_char ch) {
+    rz_usize start = 0, end = sv.len;
+    while (start < end && sv.data[start] == ch) start++;
+    while (end > start && sv.data[end - 1] == ch) end--;
+    return rz_sv_sized(sv.data + start, end - start);
+}
+
+static rz_usize bench_old_lines(RZ_StrView sv) {
+    rz_usize lines = 0;
+    for (rz_usize i; (i = bench_old_find_char(sv, '\n')) != RZ_NOT_FOUND; lines++) sv = rz_sv_sized(sv.data + i + 1, sv.len - i - 1);
+    return lines + (sv.len > 0);
+}
+
+static rz_usize bench_old_rlines(RZ_StrView sv) {
+    rz_usize lines = 0;
+    for (rz_usize i; (i = bench_old_rfind_char(sv, '\n')) != RZ_NOT_FOUND; lines++) sv.len = i;
+    return lines + (sv.len > 0);
+}
+
+typedef struct {
+    bool has[256];
+} BenchByteTable;
+
+static BenchByteTable bench_table(RZ_StrView bytes) {
+    BenchByteTable t = {0};
+    for (rz_usize i = 0; i < bytes.len; ++i) t.has[(rz_u8)bytes.data[i]] = true;
+    return t;
+}
+
+static rz_usize bench_table_find(RZ_StrView sv, const BenchByteTable *t) {
+    for (rz_usize i = 0; i < sv.len; ++i) {
+        if (t->has[(rz_u8)sv.data[i]]) return i;
+    }
+    return RZ_NOT_FOUND;
+}
+
+static void bench_find_any(RZ_StrView log, const char *set) {
+    BenchByteTable t = bench_table(rz_sv(set));
+    char           name[64];
+    snprintf(name, sizeof(name), "  %zu bytes: 256 entries table loop", strlen(set));
+    RZ_BENCH_BYTES(name, log.len, RZ_ASSERT(bench_table_find(log, &t) == RZ_NOT_FOUND));
+    snprintf(name, sizeof(name), "  %zu bytes: rz_sv_find_any", strlen(set));
+    RZ_BENCH_BYTES(name, log.len, RZ_ASSERT(rz_sv_find_any_cstr(log, set) == RZ_NOT_FOUND));
+    snprintf(name, sizeof(name), "  %zu bytes: rz_sv_rfind_any", strlen(set));
+    RZ_BENCH_BYTES(name, log.len, RZ_ASSERT(rz_sv_rfind_any_cstr(log, set) == RZ_NOT_FOUND));
+}
+
+int main(int argc, char **argv) {
+    rz_usize   bytes = rz_bench_arg(argc, argv, 1, 64U << 20U);
+    char      *buf   = malloc(bytes);
+    RZ_StrView log   = rz_sv_sized(buf, bench_log(buf, bytes));
+    rz_usize   lines = bench_old_lines(log);
+    // from the end, the empty piece after the last newline is a piece
+    rz_usize   rlines = bench_old_rlines(log);
+    printf("log: %zu MB, %zu lines, simd: %s\n", log.len >> 20U, lines,
+           RZ_TARGET_SIMD_AVX2 ? "avx2" : RZ_TARGET_SIMD_SSE2 ? "sse2" : RZ_TARGET_SIMD_NEON ? "neon" : "none");
+
+    printf("absent byte\n");
+    RZ_BENCH_BYTES("  old rz_sv_find_char (byte loop)", log.len, RZ_ASSERT(bench_old_find_char(log, '#') == RZ_NOT_FOUND));
+    RZ_BENCH_BYTES("  rz_sv_find_char (memchr)", log.len, RZ_ASSERT(rz_sv_find_char(log, '#') == RZ_NOT_FOUND));
+    RZ_BENCH_BYTES("  old rz_sv_rfind_char (byte loop)", log.len, RZ_ASSERT(bench_old_rfind_char(log, '#') == RZ_NOT_FOUND));
+    RZ_BENCH_BYTES("  memrchr", log.len, RZ_ASSERT(memrchr(log.data, '#', log.len) == NULL));
+    RZ_BENCH_BYTES("  rz_sv_rfind_char", log.len, RZ_ASSERT(rz_sv_rfind_char(log, '#') == RZ_NOT_FOUND));
+
+    printf("lines (%.0f bytes per line)\n", (rz_f64)log.len / (rz_f64)lines);
+    RZ_BENCH_BYTES("  old split (byte loop)", log.len, RZ_ASSERT(bench_old_lines(log) == lines));
+    RZ_BENCH_BYTES("  rz_sv_split_char", log.len, {
+        RZ_StrView rest = log, line;
+        rz_usize   n    = 0;
+        while (rz_sv_split_char(&rest, '\n', &line)) n++;
+        RZ_ASSERT(n == lines);
+    });
+    RZ_BENCH_BYTES("  old rsplit (byte loop)", log.len, RZ_ASSERT(bench_old_rlines(log) == rlines));
+    RZ_BENCH_BYTES("  rz_sv_rsplit_char", log.len, {
+        RZ_StrView rest = log, line;
+        rz_usize   n    = 0;
+        while (rz_sv_rsplit_char(&rest, '\n', &line)) n++;
+        RZ_ASSERT(n == rlines);
+    });
+    BenchByteTable crlf = bench_table(rz_sv("\r\n"));
+    RZ_BENCH_BYTES("  \"\\r\\n\": 256 entries table loop", log.len, {
+        RZ_StrView rest = log;
+        rz_usize   n    = 0;
+        for (rz_usize i; (i = bench_table_find(rest, &crlf)) != RZ_NOT_FOUND; n++) rest = rz_sv_sized(rest.data + i + 1, rest.len - i - 1);
+        RZ_ASSERT(n == lines * 2);
+    });
+    RZ_BENCH_BYTES("  \"\\r\\n\": rz_sv_split_any", log.len, {
+        RZ_StrView rest = log, line;
+        rz_usize   n    = 0;
+        while (rz_sv_split_any_cstr(&rest, "\r\n", &line)) n++;
+        RZ_ASSERT(n == lines * 2);
+    });
+
+    printf("absent byte set\n");
+    bench_find_any(log, "#|~");
+    bench_find_any(log, "#|~^`<");
+    bench_find_any(log, "#|~^`<>!");
+    bench_find_any(log, "#|~^`<>!{}$%");
+    bench_find_any(log, "#|~^`<>!{}$%*;@'\\\"");
+    bench_find_any(log, "#|~^`<>!{}$%*;@'\\\"\t\v\f\a");
+
+    // the 32 KB runs of spaces around the word
+    rz_usize pad = 32U << 10U, reps = 1024;
+    memset(buf, ' ', 2 * pad + 1);
+    buf[pad]           = 'x';
+    RZ_StrView padded  = rz_sv_sized(buf, 2 * pad + 1);
+    printf("trim (%zu KB of spaces on both sides)\n", pad >> 10U);
+    RZ_BENCH_BYTES("  old rz_sv_trim_char (byte loop)", padded.len * reps,
+                   for (rz_usize r = 0; r < reps; ++r) RZ_ASSERT(bench_old_trim_char(padded, ' ').len == 1));
+    RZ_BENCH_BYTES("  rz_sv_trim_char", padded.len * reps, for (rz_usize r = 0; r < reps; ++r) RZ_ASSERT(rz_sv_trim_char(padded, ' ').len == 1));
+
+    free(buf);
+    return 0;
+}
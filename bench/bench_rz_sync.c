@@ -0,0 +1,226 @@
+#include "rz_common.h"
+#include "rz_collections.h"
+#include "rz_sync.h"
+
+#include "bench_utils.h"
+
+#include <threads.h>
+
+/// throughput of the queues for producer/consumer counts, and the ping-pong latency.
+/// the baseline is a bounded RZ_Deque behind a mutex and two condition variables.
+///   bench_rz_sync [items]
+
+#define BENCH_QUEUE_CAPACITY 1024u
+#define BENCH_QUEUE_BATCH    64u
+
+typedef struct {
+    mtx_t             lock;
+    cnd_t             not_empty;
+    cnd_t             not_full;
+    RZ_Deque(rz_u64)  dq;
+} LockedQueue;
+
+static void locked_init(LockedQueue *q) {
+    *q = (LockedQueue){0};
+    mtx_init(&q->lock, mtx_plain);
+    cnd_init(&q->not_empty);
+    cnd_init(&q->not_full);
+    rz_dq_reserve(&q->dq, BENCH_QUEUE_CAPACITY);
+}
+
+static void locked_free(LockedQueue *q) {
+    rz_dq_free(&q->dq);
+    mtx_destroy(&q->lock);
+    cnd_destroy(&q->not_empty);
+    cnd_destroy(&q->not_full);
+}
+
+static void locked_push(LockedQueue *q, rz_u64 v) {
+    mtx_lock(&q->lock);
+    while (q->dq.len == BENCH_QUEUE_CAPACITY) cnd_wait(&q->not_full, &q->lock);
+    rz_dq_push_back(&q->dq, v);
+    cnd_signal(&q->not_empty);
+    mtx_unlock(&q->lock);
+}
+
+static rz_u64 locked_pop(LockedQueue *q) {
+    mtx_lock(&q->lock);
+    while (q->dq.len == 0) cnd_wait(&q->not_empty, &q->lock);
+    rz_u64 v = rz_dq_pop_front(&q->dq);
+    cnd_signal(&q->not_full);
+    mtx_unlock(&q->lock);
+    return v;
+}
+
+typedef enum {
+    BENCH_SPSC,
+    BENCH_SPSC_BATCH,
+    BENCH_MPMC,
+    BENCH_LOCKED,
+} BenchQueueKind;
+
+typedef struct {
+    BenchQueueKind       kind;
+    RZ_SpscQueue(rz_u64) spsc;
+    RZ_MpmcQueue(rz_u64) mpmc;
+    LockedQueue          locked;
+    // the ping-pong reply queues
+    RZ_SpscQueue(rz_u64) spsc_back;
+    LockedQueue          locked_back;
+} BenchQueues;
+
+typedef struct {
+    BenchQueues *q;
+    rz_usize     n;
+    rz_u64       sum;
+} BenchWorker;
+
+static int bench_producer(void *arg) {
+    BenchWorker *w = arg;
+    BenchQueues *q = w->q;
+    switch (q->kind) {
+        case BENCH_SPSC:
+            for (rz_u64 i = 0; i < w->n; ++i) rz_spsc_push(&q->spsc, i);
+            break;
+        case BENCH_SPSC_BATCH: {
+            rz_u64 items[BENCH_QUEUE_BATCH];
+            for (rz_u64 i = 0; i < w->n;) {
+                rz_usize n = RZ_MIN(BENCH_QUEUE_BATCH, w->n - i);
+                for (rz_usize j = 0; j < n; ++j) items[j] = i + j;
+                rz_usize pushed = rz_spsc_push_many(&q->spsc, items, n);
+                if (pushed == 0) thrd_yield();
+                i += pushed;
+            }
+        } break;
+        case BENCH_MPMC:
+            for (rz_u64 i = 0; i < w->n; ++i) rz_mpmc_push(&q->mpmc, i);
+            break;
+        case BENCH_LOCKED:
+            for (rz_u64 i = 0; i < w->n; ++i) locked_push(&q->locked, i);
+            break;
+    }
+    return 0;
+}
+
+static int bench_consumer(void *arg) {
+    BenchWorker *w = arg;
+    BenchQueues *q = w->q;
+    rz_u64       v = 0;
+    switch (q->kind) {
+        case BENCH_SPSC:
+            for (rz_usize i = 0; i < w->n; ++i) {
+                rz_spsc_pop(&q->spsc, &v);
+                w->sum += v;
+            }
+            break;
+        case BENCH_SPSC_BATCH: {
+            rz_u64 items[BENCH_QUEUE_BATCH];
+            for (rz_usize i = 0; i < w->n;) {
+                rz_usize popped = rz_spsc_pop_many(&q->spsc, items, RZ_MIN(BENCH_QUEUE_BATCH, w->n - i));
+                if (popped == 0) thrd_yield();
+                for (rz_usize j = 0; j < popped; ++j) w->sum += items[j];
+                i += popped;
+            }
+        } break;
+        case BENCH_MPMC:
+            for (rz_usize i = 0; i < w->n; ++i) {
+                rz_mpmc_pop(&q->mpmc, &v);
+                w->sum += v;
+            }
+            break;
+        case BENCH_LOCKED:
+            for (rz_usize i = 0; i < w->n; ++i) w->sum += locked_pop(&q->locked);
+            break;
+    }
+    return 0;
+}
+
+static void bench_throughput(const char *name, BenchQueues *q, BenchQueueKind kind, rz_usize producers, rz_usize consumers, rz_usize items) {
+    q->kind = kind;
+    thrd_t      threads[16];
+    BenchWorker workers[16];
+    RZ_ASSERT(producers + consumers <= RZ_ARRAY_LEN(threads));
+    // every producer push the same amount, and every consumer pop the same amount
+    items -= items % (producers * consumers);
+
+    RZ_BENCH(name, items, {
+        for (rz_usize i = 0; i < producers; ++i) {
+            workers[i] = (BenchWorker){.q = q, .n = items / producers};
+            thrd_create(&threads[i], bench_producer, &workers[i]);
+        }
+        for (rz_usize i = producers; i < producers + consumers; ++i) {
+            workers[i] = (BenchWorker){.q = q, .n = items / consumers};
+            thrd_create(&threads[i], bench_consumer, &workers[i]);
+        }
+        for (rz_usize i = 0; i < producers + consumers; ++i) thrd_join(threads[i], NULL);
+    });
+}
+
+static int bench_pong(void *arg) {
+    BenchWorker *w = arg;
+    BenchQueues *q = w->q;
+    rz_u64       v = 0;
+    for (rz_usize i = 0; i < w->n; ++i) {
+        if (q->kind == BENCH_LOCKED) {
+            locked_push(&q->locked_back, locked_pop(&q->locked));
+        } else {
+            rz_spsc_pop(&q->spsc, &v);
+            rz_spsc_push(&q->spsc_back, v);
+        }
+    }
+    return 0;
+}
+
+static void bench_latency(const char *name, BenchQueues *q, BenchQueueKind kind, rz_usize rounds) {
+    q->kind = kind;
+    RZ_BENCH(name, rounds, {
+        thrd_t      pong;
+        BenchWorker w = {.q = q, .n = rounds};
+        thrd_create(&pong, bench_pong, &w);
+        rz_u64 v = 0;
+        for (rz_u64 i = 0; i < rounds; ++i) {
+            if (kind == BENCH_LOCKED) {
+                locked_push(&q->locked, i);
+                v += locked_pop(&q->locked_back);
+            } else {
+                rz_spsc_push(&q->spsc, i);
+                rz_spsc_pop(&q->spsc_back, &v);
+            }
+        }
+        thrd_join(pong, NULL);
+        rz_bench_keep(v);
+    });
+}
+
+int main(int argc, char **argv) {
+    rz_usize items  = rz_bench_arg(argc, argv, 1, 1U << 22U);
+    rz_usize rounds = items / 64;
+
+    BenchQueues q = {0};
+    rz_spsc_init(&q.spsc, .capacity = BENCH_QUEUE_CAPACITY);
+    rz_spsc_init(&q.spsc_back, .capacity = BENCH_QUEUE_CAPACITY);
+    rz_mpmc_init(&q.mpmc, .capacity = BENCH_QUEUE_CAPACITY);
+    locked_init(&q.locked);
+    locked_init(&q.locked_back);
+
+    printf("items: %zu, capacity: %u\n", items, BENCH_QUEUE_CAPACITY);
+    bench_throughput("spsc 1p/1c", &q, BENCH_SPSC, 1, 1, items);
+    bench_throughput("spsc 1p/1c (push_many/pop_many 64)", &q, BENCH_SPSC_BATCH, 1, 1, items);
+    bench_throughput("mpmc 1p/1c", &q, BENCH_MPMC, 1, 1, items);
+    bench_throughput("mpmc 2p/2c", &q, BENCH_MPMC, 2, 2, items);
+    bench_throughput("mpmc 4p/4c", &q, BENCH_MPMC, 4, 4, items);
+    bench_throughput("mutex deque 1p/1c", &q, BENCH_LOCKED, 1, 1, items);
+    bench_throughput("mutex deque 2p/2c", &q, BENCH_LOCKED, 2, 2, items);
+    bench_throughput("mutex deque 4p/4c", &q, BENCH_LOCKED, 4, 4, items);
+
+    printf("ping-pong rounds: %zu\n", rounds);
+    bench_latency("spsc round trip", &q, BENCH_SPSC, rounds);
+    bench_latency("mutex deque round trip", &q, BENCH_LOCKED, rounds);
+
+    rz_spsc_free(&q.spsc);
+    rz_spsc_free(&q.spsc_back);
+    rz_mpmc_free(&q.mpmc);
+    locked_free(&q.locked);
+    locked_free(&q.locked_back);
+    return 0;
+}
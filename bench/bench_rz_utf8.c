@@ -0,0 +1,98 @@
+#include "rz_common.h"
+#include "rz_strings.h"
+#include "rz_utf8.h"
+
+#include "bench_utils.h"
+
+/// throughput of rz_utf8 on the ASCII, the mixed (latin text with accents and emoji) and the CJK corpus:
+/// validation, codepoint counting, the iterator and the transcoding to UTF-16/32 (and back from UTF-32).
+/// the baseline is the byte by byte validation loop (rz_utf8_decode of every codepoint), and the build
+/// with -DRZ_NO_SIMD (scalar), with SSE2 (default on x86_64) and with -mavx2 (the lookup table validation).
+///   bench_rz_utf8 [bytes]
+
+static const char *const bench_mixed_words[] = {"the", "café", "naïve", "Zürich", "déjà", "vu", "über", "smørrebrød", "😀", "and", "of", "señor", "€5"};
+
+static void bench_append_cp(RZ_Str *s, rz_u32 cp) {
+    RZ_ASSERT(rz_utf8_append(s, cp));
+}
+
+static void bench_corpus(RZ_Str *s, rz_usize bytes, rz_u32 kind) {
+    rz_u64 rng = 0x0718 + kind;
+    s->len     = 0;
+    while (s->len < bytes) {
+        rz_u64      r   = rz_bench_rand(&rng);
+        const char *sep = ((r >> 32U) % 12 == 0) ? ".\n" : " ";
+        if (kind == 0) {
+            // ASCII text
+            static const char *const words[] = {"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "server", "request"};
+            rz_str_append_cstr(s, words[r % RZ_ARRAY_LEN(words)]);
+            rz_str_append_cstr(s, sep);
+        } else if (kind == 1) {
+            rz_str_append_cstr(s, bench_mixed_words[r % RZ_ARRAY_LEN(bench_mixed_words)]);
+            rz_str_append_cstr(s, sep);
+        } else {
+            // CJK ideographs, the punctuation and the newline every ~40 characters
+            bench_append_cp(s, 0x4E00 + (rz_u32)(r % 0x5200));
+            if ((r >> 32U) % 40 == 0) bench_append_cp(s, 0x3002);
+            if ((r >> 40U) % 40 == 0) rz_str_append_cstr(s, "\n");
+        }
+    }
+}
+
+static rz_usize bench_decode_all(RZ_StrView sv) {
+    rz_usize i = 0;
+    while (i < sv.len) {
+        rz_u32   cp = 0;
+        rz_usize n  = rz_utf8_decode(rz_sv_sized(sv.data + i, sv.len - i), &cp);
+        if (cp == RZ_UTF8_INVALID) break;
+        i += n;
+    }
+    return i;
+}
+
+int main(int argc, char **argv) {
+    rz_usize bytes = rz_bench_arg(argc, argv, 1, 64U << 20U);
+    RZ_Str   text  = {.allocator = rz_std_allocator()};
+    RZ_Str   back  = {.allocator = rz_std_allocator()};
+    RZ_Utf16Str u16 = {.allocator = rz_std_allocator()};
+    RZ_Utf32Str u32 = {.allocator = rz_std_allocator()};
+    printf("simd: %s\n", RZ_TARGET_SIMD_AVX2 ? "avx2" : RZ_TARGET_SIMD_SSE2 ? "sse2" : RZ_TARGET_SIMD_NEON ? "neon" : "none");
+
+    const char *const names[] = {"ascii", "mixed", "cjk"};
+    for (rz_u32 kind = 0; kind < RZ_ARRAY_LEN(names); ++kind) {
+        bench_corpus(&text, bytes, kind);
+        RZ_StrView sv         = rz_sv_sized(text.data, text.len);
+        rz_usize   codepoints = rz_utf8_count_codepoints(sv);
+        printf("%s: %zu MB, %.2f bytes per codepoint\n", names[kind], sv.len >> 20U, (rz_f64)sv.len / (rz_f64)codepoints);
+
+        RZ_BENCH_BYTES("  rz_utf8_decode loop (baseline validation)", sv.len, RZ_ASSERT(bench_decode_all(sv) == sv.len));
+        RZ_BENCH_BYTES("  rz_utf8_validate", sv.len, RZ_ASSERT(rz_utf8_validate(sv)));
+        if (kind == 0) RZ_BENCH_BYTES("  rz_utf8_ascii_prefix", sv.len, RZ_ASSERT(rz_utf8_ascii_prefix(sv) == sv.len));
+        RZ_BENCH_BYTES("  rz_utf8_count_codepoints", sv.len, RZ_ASSERT(rz_utf8_count_codepoints(sv) == codepoints));
+        RZ_BENCH_BYTES("  RZ_Utf8Iter", sv.len, {
+            RZ_Utf8Iter it    = rz_utf8_iter(sv);
+            rz_u32      cp    = 0;
+            rz_usize    count = 0;
+            while (rz_utf8_iter_next(&it, &cp)) count++;
+            RZ_ASSERT(count == codepoints);
+        });
+        RZ_BENCH_BYTES("  rz_utf8_to_utf16", sv.len, {
+            u16.len = 0;
+            RZ_ASSERT(rz_utf8_to_utf16(sv, &u16));
+        });
+        RZ_BENCH_BYTES("  rz_utf8_to_utf32", sv.len, {
+            u32.len = 0;
+            RZ_ASSERT(rz_utf8_to_utf32(sv, &u32) && u32.len == codepoints);
+        });
+        RZ_BENCH_BYTES("  rz_utf32_to_utf8", sv.len, {
+            back.len = 0;
+            RZ_ASSERT(rz_utf32_to_utf8(u32.data, u32.len, &back) && back.len == sv.len);
+        });
+    }
+
+    rz_str_free(&text);
+    rz_str_free(&back);
+    rz_arr_free(&u16);
+    rz_arr_free(&u32);
+    return 0;
+}
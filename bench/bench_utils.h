@@ -0,0 +1,83 @@
+#pragma once
+
+#ifndef __BENCH_UTILS_H
+#    define __BENCH_UTILS_H
+
+/// helpers for the benchmarks in bench/. every bench_*.c is a program on its own,
+/// build it like the tests (with the IMPL of the modules it use) but optimized, ex:
+///   cc -O2 -DNDEBUG -Isrc -Ibench bench/bench_rz_sync.c -o bench_rz_sync && ./bench_rz_sync [n]
+/// each case is repeated RZ_BENCH_REPEAT times and the fastest run is reported.
+
+#    include <stdio.h>
+#    include <stdlib.h>
+
+#    include "rz_common.h"
+#    include "rz_time.h"
+
+#    ifndef RZ_BENCH_REPEAT
+#        define RZ_BENCH_REPEAT 5
+#    endif
+
+static inline rz_u64 rz_bench_now(void) {
+    RZ_Duration t = rz_instant_now().t;
+    return (t.secs * 1000000000ULL) + t.nanos;
+}
+
+/// keep `x` alive, so the compiler does not remove the benchmarked code.
+#    if RZ_TARGET_COMPILER_MSVC
+#        define rz_bench_keep(x) _ReadWriteBarrier()
+#    else
+#        define rz_bench_keep(x) __asm__ volatile("" : : "g"(x) : "memory")
+#    endif
+
+static inline void rz_bench_report(const char *name, rz_u64 ns, rz_usize ops) {
+    if (ns == 0) ns = 1;
+    printf("%-48s %12.2f ns/op %10.2f Mop/s\n", name, (rz_f64)ns / (rz_f64)ops, ((rz_f64)ops * 1e3) / (rz_f64)ns);
+}
+
+static inline void rz_bench_report_bytes(const char *name, rz_u64 ns, rz_usize bytes) {
+    if (ns == 0) ns = 1;
+    printf("%-48s %12.3f ms    %10.2f GB/s\n", name, (rz_f64)ns / 1e6, (rz_f64)bytes / (rz_f64)ns);
+}
+
+#    define rz__bench_best(best, ...)                                                 \
+        rz_u64 best = RZ_U64_MAX;                                                     \
+        for (rz_usize rz__rep = 0; rz__rep < RZ_BENCH_REPEAT; ++rz__rep) {            \
+            rz_u64 rz__start = rz_bench_now();                                        \
+            __VA_ARGS__;                                                              \
+            rz_u64 rz__elapsed = rz_bench_now() - rz__start;                          \
+            if (rz__elapsed < best) best = rz__elapsed;                               \
+        }
+
+/// run the body and report ns per op. the body must do the same work on every repeat.
+///   RZ_BENCH("rz_arr_find", n, { ... });
+#    define RZ_BENCH(name, ops, ...)                                                  \
+        do {                                                                          \
+            rz__bench_best(rz__best, __VA_ARGS__);                                    \
+            rz_bench_report(name, rz__best, ops);                                     \
+        } while (0)
+
+/// run the body and report the throughput of `bytes` processed per run.
+#    define RZ_BENCH_BYTES(name, bytes, ...)                                          \
+        do {                                                                          \
+            rz__bench_best(rz__best, __VA_ARGS__);                                    \
+            rz_bench_report_bytes(name, rz__best, bytes);                             \
+        } while (0)
+
+/// xorshift64*, the benchmarks does not depend on the libc rand().
+static inline rz_u64 rz_bench_rand(rz_u64 *state) {
+    rz_u64 x = *state;
+    x ^= x >> 12U;
+    x ^= x << 25U;
+    x ^= x >> 27U;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/// `argv[i]` as number, or `fallback` when it is not given.
+static inline rz_usize rz_bench_arg(int argc, char **argv, int i, rz_usize fallback) {
+    if (i >= argc) return fallback;
+    return (rz_usize)strtoull(argv[i], NULL, 10);
+}
+
+#endif /* end of include guard: __BENCH_UTILS_H */
@@ -374,9 +374,11 @@ typedef struct {
 } RZ__TempAllocator;
 
 static void *rz__temp_allocator_alloc(void *a, rz_usize len) {
-    RZ__TempAllocator *ta = a;
-    RZ_ASSERT((ta->len + len) < RZ_TEMP_ALLOCATOR_CAPACITY, "Temp allocator is not enough. resize / redefined RZ_TEMP_ALLOCATOR_CAPACITY with bigger capacity");
-    return ta->data + ta->len;
+    RZ__TempAllocator *ta    = a;
+    rz_usize           start = (ta->len + (alignof(max_align_t) - 1)) & ~(alignof(max_align_t) - 1);
+    RZ_ASSERT((start + len) < RZ_TEMP_ALLOCATOR_CAPACITY, "Temp allocator is not enough. resize / redefined RZ_TEMP_ALLOCATOR_CAPACITY with bigger capacity");
+    ta->len = start + len;
+    return ta->data + start;
 }
 static void *rz__temp_allocator_remap(void *a, void *mem, rz_usize mem_len, rz_usize new_len) {
     void *new_ptr = rz__temp_allocator_alloc(a, new_len);
@@ -214,29 +214,31 @@ RZ_DEF bool rz_ap_parse_type_bool(void *value_dest, RZ_StrView value, RZ_Str *er
     return true;
 }
 
-#define rz__ap_helper_parse_primitive(type, ...)                                 \
-    do {                                                                         \
-        char *end;                                                               \
-        type  v = __VA_ARGS__;                                                   \
-        if (end == value.data) {                                                 \
-            rz_str_append_cstr(error_buf, "malformed number");                   \
-        }                                                                        \
-        if (rz_last_os_error() != 0) {                                           \
-            rz_str_appendf(error_buf, "parse number failed: %s", rz_strerror()); \
-            return false;                                                        \
-        }                                                                        \
-        *(type *)value_dest = v;                                                 \
-        return true;                                                             \
+// the whole value must be the number, parsed from the view without the C string copy
+#define rz__ap_helper_parse_primitive(type, parse)                                             \
+    do {                                                                                       \
+        type              v   = 0;                                                             \
+        RZ_StrParseResult res = parse(value, &v);                                              \
+        if (res.status == RZ_STR_PARSE_INVALID || res.consumed != value.len) {                 \
+            rz_str_appendf(error_buf, "malformed number: '" RZ_SVFmt "'", RZ_SVArg(value));    \
+            return false;                                                                      \
+        }                                                                                      \
+        if (res.status == RZ_STR_PARSE_OVERFLOW) {                                             \
+            rz_str_appendf(error_buf, "number out of range: '" RZ_SVFmt "'", RZ_SVArg(value)); \
+            return false;                                                                      \
+        }                                                                                      \
+        *(type *)value_dest = v;                                                               \
+        return true;                                                                           \
     } while (0)
 
 RZ_DEC bool rz_ap_parse_type_int(void *value_dest, RZ_StrView value, RZ_Str *error_buf) {
-    rz__ap_helper_parse_primitive(rz_i64, strtoll(value.data, &end, 10));
+    rz__ap_helper_parse_primitive(rz_i64, rz_sv_parse_i64);
 }
 RZ_DEC bool rz_ap_parse_type_uint(void *value_dest, RZ_StrView value, RZ_Str *error_buf) {
-    rz__ap_helper_parse_primitive(rz_u64, strtoull(value.data, &end, 10));
+    rz__ap_helper_parse_primitive(rz_u64, rz_sv_parse_u64);
 }
 RZ_DEC bool rz_ap_parse_type_float(void *value_dest, RZ_StrView value, RZ_Str *error_buf) {
-    rz__ap_helper_parse_primitive(rz_f64, strtod(value.data, &end));
+    rz__ap_helper_parse_primitive(rz_f64, rz_sv_parse_f64);
 }
 #undef rz__ap_helper_parse_primitive
 
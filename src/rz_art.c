@@ -0,0 +1,701 @@
+#include "rz_art.h"
+
+#ifdef RZ_ART_IMPL
+
+typedef enum : rz_u8
+{
+    RZ__ART_NODE4 = 1,
+    RZ__ART_NODE16,
+    RZ__ART_NODE48,
+    RZ__ART_NODE256,
+} RZ__ArtNodeType;
+
+typedef struct {
+    rz_usize    key_len;
+    /// the value (`valuesize` bytes) then the key bytes
+    max_align_t data[];
+} RZ__ArtLeaf;
+
+typedef struct {
+    RZ__ArtNodeType type;
+    rz_u16          num_children;
+    /// the length of the compressed path, only the first RZ_ART_MAX_PREFIX bytes is stored in `prefix`
+    rz_usize        prefix_len;
+    rz_u8           prefix[RZ_ART_MAX_PREFIX];
+    /// the key that end at this node (it is the prefix of every key in the subtree)
+    RZ__ArtLeaf    *leaf;
+} RZ__ArtNode;
+
+typedef struct {
+    RZ__ArtNode n;
+    rz_u8       keys[4];
+    void       *children[4];
+} RZ__ArtNode4;
+
+typedef struct {
+    RZ__ArtNode n;
+    rz_u8       keys[16];
+    void       *children[16];
+} RZ__ArtNode16;
+
+typedef struct {
+    RZ__ArtNode n;
+    /// index + 1 into `children`, 0 is empty
+    rz_u8       index[256];
+    void       *children[48];
+} RZ__ArtNode48;
+
+typedef struct {
+    RZ__ArtNode n;
+    void       *children[256];
+} RZ__ArtNode256;
+
+// the child pointer is tagged, the leaf has the lowest bit set.
+#    define rz__art_is_leaf(p)              (((rz_uptr)(p) & 1U) != 0)
+#    define rz__art_leaf(p)                 ((RZ__ArtLeaf *)((rz_uptr)(p) & ~(rz_uptr)1U))
+#    define rz__art_tag_leaf(l)             ((void *)((rz_uptr)(l) | 1U))
+#    define rz__art_leaf_value(l)           ((void *)(l)->data)
+#    define rz__art_leaf_key(l, valuesize)  ((const rz_u8 *)(l)->data + (valuesize))
+
+/////////////// node and leaf allocation
+static rz_usize rz__art_node_size(RZ__ArtNodeType type) {
+    switch (type) {
+    case RZ__ART_NODE4: return sizeof(RZ__ArtNode4);
+    case RZ__ART_NODE16: return sizeof(RZ__ArtNode16);
+    case RZ__ART_NODE48: return sizeof(RZ__ArtNode48);
+    case RZ__ART_NODE256: return sizeof(RZ__ArtNode256);
+    default: RZ_UNREACHABLE("rz__art_node_size: RZ__ArtNodeType");
+    }
+}
+
+static RZ__ArtNode *rz__art_node_alloc(RZ_ArtOpaque *t, RZ__ArtNodeType type) {
+    RZ__ArtNode *n = rz_raw_calloc(t->allocator, 1, rz__art_node_size(type));
+    RZ_ASSERT_ALLOCATOR_PTR(n);
+    n->type = type;
+    return n;
+}
+
+static void rz__art_node_dealloc(RZ_ArtOpaque *t, RZ__ArtNode *n) {
+    rz_raw_dealloc(t->allocator, n, rz__art_node_size(n->type));
+}
+
+// copy everything except the type and the children
+static void rz__art_copy_header(RZ__ArtNode *dst, const RZ__ArtNode *src) {
+    dst->num_children = src->num_children;
+    dst->prefix_len   = src->prefix_len;
+    dst->leaf         = src->leaf;
+    memcpy(dst->prefix, src->prefix, RZ_MIN(src->prefix_len, RZ_ART_MAX_PREFIX));
+}
+
+static RZ__ArtLeaf *rz__art_leaf_alloc(RZ_ArtOpaque *t, rz_usize valuesize, const rz_u8 *key, rz_usize key_len) {
+    RZ__ArtLeaf *l = rz_raw_alloc(t->allocator, sizeof(RZ__ArtLeaf) + valuesize + key_len);
+    RZ_ASSERT_ALLOCATOR_PTR(l);
+    l->key_len = key_len;
+    memset(l->data, 0, valuesize);
+    if (key_len > 0) memcpy((rz_u8 *)l->data + valuesize, key, key_len);
+    return l;
+}
+
+static void rz__art_leaf_dealloc(RZ_ArtOpaque *t, RZ__ArtLeaf *l, rz_usize valuesize) {
+    rz_raw_dealloc(t->allocator, l, sizeof(RZ__ArtLeaf) + valuesize + l->key_len);
+}
+
+static inline bool rz__art_leaf_eq(const RZ__ArtLeaf *l, rz_usize valuesize, const rz_u8 *key, rz_usize key_len) {
+    return (l->key_len == key_len) && ((key_len == 0) || (memcmp(rz__art_leaf_key(l, valuesize), key, key_len) == 0));
+}
+
+/////////////// children
+static void **rz__art_find_child(RZ__ArtNode *n, rz_u8 c) {
+    switch (n->type) {
+    case RZ__ART_NODE4: {
+        RZ__ArtNode4 *p = (RZ__ArtNode4 *)n;
+        for (rz_u32 i = 0; i < n->num_children; ++i) {
+            if (p->keys[i] == c) return &p->children[i];
+        }
+        return NULL;
+    }
+    case RZ__ART_NODE16: {
+        RZ__ArtNode16 *p = (RZ__ArtNode16 *)n;
+#    if RZ_TARGET_SIMD_SSE2
+        // compare the 16 keys at once, the keys after `num_children` is masked out.
+        __m128i eq   = _mm_cmpeq_epi8(_mm_set1_epi8((char)c), _mm_loadu_si128((const __m128i *)p->keys));
+        rz_u32  mask = (rz_u32)_mm_movemask_epi8(eq) & ((1U << n->num_children) - 1U);
+        return (mask != 0) ? &p->children[rz_ctz64(mask)] : NULL;
+#    else
+        for (rz_u32 i = 0; i < n->num_children; ++i) {
+            if (p->keys[i] == c) return &p->children[i];
+        }
+        return NULL;
+#    endif
+    }
+    case RZ__ART_NODE48: {
+        RZ__ArtNode48 *p = (RZ__ArtNode48 *)n;
+        return (p->index[c] != 0) ? &p->children[p->index[c] - 1] : NULL;
+    }
+    case RZ__ART_NODE256: {
+        RZ__ArtNode256 *p = (RZ__ArtNode256 *)n;
+        return (p->children[c] != NULL) ? &p->children[c] : NULL;
+    }
+    default: RZ_UNREACHABLE("rz__art_find_child: RZ__ArtNodeType");
+    }
+}
+
+// iterate the children in the order of the key byte, `*pos` is the iterator (start from 0).
+static void *rz__art_next_child(const RZ__ArtNode *n, rz_u32 *pos, rz_u8 *c) {
+    switch (n->type) {
+    case RZ__ART_NODE4:
+    case RZ__ART_NODE16: {
+        if (*pos >= n->num_children) return NULL;
+        const rz_u8 *keys     = (n->type == RZ__ART_NODE4) ? ((const RZ__ArtNode4 *)n)->keys : ((const RZ__ArtNode16 *)n)->keys;
+        void *const *children = (n->type == RZ__ART_NODE4) ? ((const RZ__ArtNode4 *)n)->children : ((const RZ__ArtNode16 *)n)->children;
+        *c                    = keys[*pos];
+        return children[(*pos)++];
+    }
+    case RZ__ART_NODE48: {
+        const RZ__ArtNode48 *p = (const RZ__ArtNode48 *)n;
+        for (; *pos < 256; ++*pos) {
+            if (p->index[*pos] == 0) continue;
+            *c = (rz_u8)(*pos)++;
+            return p->children[p->index[*c] - 1];
+        }
+        return NULL;
+    }
+    case RZ__ART_NODE256: {
+        const RZ__ArtNode256 *p = (const RZ__ArtNode256 *)n;
+        for (; *pos < 256; ++*pos) {
+            if (p->children[*pos] == NULL) continue;
+            *c = (rz_u8)(*pos)++;
+            return p->children[*c];
+        }
+        return NULL;
+    }
+    default: RZ_UNREACHABLE("rz__art_next_child: RZ__ArtNodeType");
+    }
+}
+
+static void rz__art_sorted_insert(rz_u8 *keys, void **children, rz_u32 num, rz_u8 c, void *child) {
+    rz_u32 pos = 0;
+    while (pos < num && keys[pos] < c) pos++;
+    memmove(keys + pos + 1, keys + pos, num - pos);
+    memmove(children + pos + 1, children + pos, (num - pos) * sizeof(void *));
+    keys[pos]     = c;
+    children[pos] = child;
+}
+
+static void rz__art_sorted_remove(rz_u8 *keys, void **children, rz_u32 num, rz_u32 pos) {
+    memmove(keys + pos, keys + pos + 1, num - pos - 1);
+    memmove(children + pos, children + pos + 1, (num - pos - 1) * sizeof(void *));
+}
+
+// add the child `c`, the node is replaced by the bigger node type (through `ref`) when it is full.
+static void rz__art_add_child(RZ_ArtOpaque *t, void **ref, RZ__ArtNode *n, rz_u8 c, void *child) {
+    switch (n->type) {
+    case RZ__ART_NODE4: {
+        RZ__ArtNode4 *p = (RZ__ArtNode4 *)n;
+        if (n->num_children < 4) {
+            rz__art_sorted_insert(p->keys, p->children, n->num_children++, c, child);
+            return;
+        }
+        RZ__ArtNode16 *g = (RZ__ArtNode16 *)rz__art_node_alloc(t, RZ__ART_NODE16);
+        rz__art_copy_header(&g->n, n);
+        memcpy(g->keys, p->keys, 4);
+        memcpy(g->children, p->children, 4 * sizeof(void *));
+        *ref = g;
+        rz__art_node_dealloc(t, n);
+        rz__art_add_child(t, ref, &g->n, c, child);
+        return;
+    }
+    case RZ__ART_NODE16: {
+        RZ__ArtNode16 *p = (RZ__ArtNode16 *)n;
+        if (n->num_children < 16) {
+            rz__art_sorted_insert(p->keys, p->children, n->num_children++, c, child);
+            return;
+        }
+        RZ__ArtNode48 *g = (RZ__ArtNode48 *)rz__art_node_alloc(t, RZ__ART_NODE48);
+        rz__art_copy_header(&g->n, n);
+        for (rz_u32 i = 0; i < 16; ++i) {
+            g->index[p->keys[i]] = (rz_u8)(i + 1);
+            g->children[i]       = p->children[i];
+        }
+        *ref = g;
+        rz__art_node_dealloc(t, n);
+        rz__art_add_child(t, ref, &g->n, c, child);
+        return;
+    }
+    case RZ__ART_NODE48: {
+        RZ__ArtNode48 *p = (RZ__ArtNode48 *)n;
+        if (n->num_children < 48) {
+            rz_u32 pos = 0;
+            while (p->children[pos] != NULL) pos++;
+            p->children[pos] = child;
+            p->index[c]      = (rz_u8)(pos + 1);
+            n->num_children++;
+            return;
+        }
+        RZ__ArtNode256 *g = (RZ__ArtNode256 *)rz__art_node_alloc(t, RZ__ART_NODE256);
+        rz__art_copy_header(&g->n, n);
+        for (rz_u32 b = 0; b < 256; ++b) {
+            if (p->index[b] != 0) g->children[b] = p->children[p->index[b] - 1];
+        }
+        *ref = g;
+        rz__art_node_dealloc(t, n);
+        rz__art_add_child(t, ref, &g->n, c, child);
+        return;
+    }
+    case RZ__ART_NODE256: {
+        ((RZ__ArtNode256 *)n)->children[c] = child;
+        n->num_children++;
+        return;
+    }
+    default: RZ_UNREACHABLE("rz__art_add_child: RZ__ArtNodeType");
+    }
+}
+
+// remove the child `c` (stored in `slot`), the node is replaced by the smaller node type (through `ref`).
+static void rz__art_remove_child(RZ_ArtOpaque *t, void **ref, RZ__ArtNode *n, rz_u8 c, void **slot) {
+    switch (n->type) {
+    case RZ__ART_NODE4: {
+        RZ__ArtNode4 *p = (RZ__ArtNode4 *)n;
+        rz__art_sorted_remove(p->keys, p->children, n->num_children--, (rz_u32)(slot - p->children));
+        return;
+    }
+    case RZ__ART_NODE16: {
+        RZ__ArtNode16 *p = (RZ__ArtNode16 *)n;
+        rz__art_sorted_remove(p->keys, p->children, n->num_children--, (rz_u32)(slot - p->children));
+        if (n->num_children > 3) return;
+        RZ__ArtNode4 *s = (RZ__ArtNode4 *)rz__art_node_alloc(t, RZ__ART_NODE4);
+        rz__art_copy_header(&s->n, n);
+        memcpy(s->keys, p->keys, n->num_children);
+        memcpy(s->children, p->children, n->num_children * sizeof(void *));
+        *ref = s;
+        rz__art_node_dealloc(t, n);
+        return;
+    }
+    case RZ__ART_NODE48: {
+        RZ__ArtNode48 *p              = (RZ__ArtNode48 *)n;
+        p->children[p->index[c] - 1]  = NULL;
+        p->index[c]                   = 0;
+        n->num_children--;
+        if (n->num_children > 12) return;
+        RZ__ArtNode16 *s = (RZ__ArtNode16 *)rz__art_node_alloc(t, RZ__ART_NODE16);
+        rz__art_copy_header(&s->n, n);
+        rz_u32 k = 0;
+        for (rz_u32 b = 0; b < 256; ++b) {
+            if (p->index[b] == 0) continue;
+            s->keys[k]     = (rz_u8)b;
+            s->children[k] = p->children[p->index[b] - 1];
+            k++;
+        }
+        *ref = s;
+        rz__art_node_dealloc(t, n);
+        return;
+    }
+    case RZ__ART_NODE256: {
+        RZ__ArtNode256 *p = (RZ__ArtNode256 *)n;
+        p->children[c]    = NULL;
+        n->num_children--;
+        if (n->num_children > 37) return;
+        RZ__ArtNode48 *s = (RZ__ArtNode48 *)rz__art_node_alloc(t, RZ__ART_NODE48);
+        rz__art_copy_header(&s->n, n);
+        rz_u32 k = 0;
+        for (rz_u32 b = 0; b < 256; ++b) {
+            if (p->children[b] == NULL) continue;
+            s->index[b]    = (rz_u8)(k + 1);
+            s->children[k] = p->children[b];
+            k++;
+        }
+        *ref = s;
+        rz__art_node_dealloc(t, n);
+        return;
+    }
+    default: RZ_UNREACHABLE("rz__art_remove_child: RZ__ArtNodeType");
+    }
+}
+
+// the node without children is replaced by its leaf, and the Node4 with single child (and no leaf)
+// is merged into the child (the prefix of the node + the key byte is prepended to the prefix of the child).
+static void rz__art_collapse(RZ_ArtOpaque *t, void **ref) {
+    RZ__ArtNode *n = *ref;
+    if (n->num_children == 0) {
+        *ref = (n->leaf != NULL) ? rz__art_tag_leaf(n->leaf) : NULL;
+        rz__art_node_dealloc(t, n);
+        return;
+    }
+    if (n->num_children > 1 || n->leaf != NULL) return;
+    RZ_DBG_ASSERT(n->type == RZ__ART_NODE4);
+
+    RZ__ArtNode4 *p     = (RZ__ArtNode4 *)n;
+    void         *child = p->children[0];
+    if (!rz__art_is_leaf(child)) {
+        RZ__ArtNode *c = child;
+        rz_u8        prefix[RZ_ART_MAX_PREFIX];
+        rz_usize     len = RZ_MIN(n->prefix_len, RZ_ART_MAX_PREFIX);
+        memcpy(prefix, n->prefix, len);
+        if (len < RZ_ART_MAX_PREFIX) prefix[len++] = p->keys[0];
+        if (len < RZ_ART_MAX_PREFIX) {
+            rz_usize sub = RZ_MIN(c->prefix_len, RZ_ART_MAX_PREFIX - len);
+            memcpy(prefix + len, c->prefix, sub);
+            len += sub;
+        }
+        memcpy(c->prefix, prefix, len);
+        c->prefix_len += n->prefix_len + 1;
+    }
+    *ref = child;
+    rz__art_node_dealloc(t, n);
+}
+
+// the smallest key in the subtree, every key in the subtree has the same bytes until the end of the node prefix.
+static RZ__ArtLeaf *rz__art_minimum(const void *n) {
+    while (!rz__art_is_leaf(n)) {
+        const RZ__ArtNode *node = n;
+        if (node->leaf != NULL) return node->leaf;
+        rz_u32 pos = 0;
+        rz_u8  c   = 0;
+        n          = rz__art_next_child(node, &pos, &c);
+    }
+    return rz__art_leaf(n);
+}
+
+// the amount of matching bytes of the node prefix and `key[depth ..]`,
+// the bytes after RZ_ART_MAX_PREFIX is compared with the minimum leaf.
+static rz_usize rz__art_prefix_mismatch(const RZ__ArtNode *n, rz_usize valuesize, const rz_u8 *key, rz_usize key_len, rz_usize depth) {
+    rz_usize max = RZ_MIN(RZ_MIN(n->prefix_len, RZ_ART_MAX_PREFIX), key_len - depth);
+    rz_usize i   = 0;
+    for (; i < max; ++i) {
+        if (n->prefix[i] != key[depth + i]) return i;
+    }
+    if (n->prefix_len > RZ_ART_MAX_PREFIX) {
+        const rz_u8 *lkey = rz__art_leaf_key(rz__art_minimum(n), valuesize);
+        max               = RZ_MIN(n->prefix_len, key_len - depth);
+        for (; i < max; ++i) {
+            if (lkey[depth + i] != key[depth + i]) return i;
+        }
+    }
+    return i;
+}
+
+// the optimistic prefix check for lookup, the skipped bytes is checked by the leaf.
+static inline bool rz__art_check_prefix(const RZ__ArtNode *n, const rz_u8 *key, rz_usize key_len, rz_usize depth) {
+    if (depth + n->prefix_len > key_len) return false;
+    return memcmp(n->prefix, key + depth, RZ_MIN(n->prefix_len, RZ_ART_MAX_PREFIX)) == 0;
+}
+
+// the key end at `depth`: store it as the leaf of the node, otherwise as the child `key[depth]`.
+static void rz__art_attach(RZ_ArtOpaque *t, void **ref, RZ__ArtNode *n, RZ__ArtLeaf *l, rz_usize valuesize, rz_usize depth) {
+    if (l->key_len == depth) {
+        n->leaf = l;
+    } else {
+        rz__art_add_child(t, ref, n, rz__art_leaf_key(l, valuesize)[depth], rz__art_tag_leaf(l));
+    }
+}
+
+/////////////// api
+static void rz__art_free_node(RZ_ArtOpaque *t, rz_usize valuesize, void *n) {
+    if (rz__art_is_leaf(n)) {
+        rz__art_leaf_dealloc(t, rz__art_leaf(n), valuesize);
+        return;
+    }
+    RZ__ArtNode *node = n;
+    if (node->leaf != NULL) rz__art_leaf_dealloc(t, node->leaf, valuesize);
+    rz_u32 pos = 0;
+    rz_u8  c   = 0;
+    for (void *child; (child = rz__art_next_child(node, &pos, &c)) != NULL;) rz__art_free_node(t, valuesize, child);
+    rz__art_node_dealloc(t, node);
+}
+
+RZ_DEF void rz__art_free(RZ_ArtOpaque *t, rz_usize valuesize) {
+    RZ_ASSERT_NOT_NULL(t);
+    if (t->root != NULL) rz__art_free_node(t, valuesize, t->root);
+    t->root = NULL;
+    t->len  = 0;
+}
+
+RZ_DEF void *rz__art_insert(RZ_ArtOpaque *t, rz_usize valuesize, const void *key_, rz_usize key_len) {
+    RZ_ASSERT_NOT_NULL(t);
+    RZ_ASSERT(key_ != NULL || key_len == 0, "rz_art_insert: key is NULL");
+    if (!rz_is_allocator(t->allocator)) t->allocator = rz_std_allocator();
+
+    const rz_u8 *key   = key_;
+    void       **ref   = &t->root;
+    rz_usize     depth = 0;
+    for (;;) {
+        void *n = *ref;
+        if (n == NULL) {
+            RZ__ArtLeaf *l = rz__art_leaf_alloc(t, valuesize, key, key_len);
+            *ref           = rz__art_tag_leaf(l);
+            t->len++;
+            return rz__art_leaf_value(l);
+        }
+
+        if (rz__art_is_leaf(n)) {
+            RZ__ArtLeaf *old = rz__art_leaf(n);
+            if (rz__art_leaf_eq(old, valuesize, key, key_len)) return rz__art_leaf_value(old);
+
+            // split the leaf: new Node4 with the common prefix of both keys
+            const rz_u8 *old_key = rz__art_leaf_key(old, valuesize);
+            rz_usize     max     = RZ_MIN(old->key_len, key_len) - depth;
+            rz_usize     lcp     = 0;
+            while (lcp < max && old_key[depth + lcp] == key[depth + lcp]) lcp++;
+
+            RZ__ArtNode *node = rz__art_node_alloc(t, RZ__ART_NODE4);
+            node->prefix_len  = lcp;
+            memcpy(node->prefix, key + depth, RZ_MIN(lcp, RZ_ART_MAX_PREFIX));
+            *ref = node;
+
+            RZ__ArtLeaf *l = rz__art_leaf_alloc(t, valuesize, key, key_len);
+            rz__art_attach(t, ref, node, old, valuesize, depth + lcp);
+            rz__art_attach(t, ref, node, l, valuesize, depth + lcp);
+            t->len++;
+            return rz__art_leaf_value(l);
+        }
+
+        RZ__ArtNode *node = n;
+        if (node->prefix_len > 0) {
+            rz_usize diff = rz__art_prefix_mismatch(node, valuesize, key, key_len, depth);
+            if (diff < node->prefix_len) {
+                // split the prefix: new Node4 with the matching part, the node keep the rest after the key byte
+                RZ__ArtNode *parent = rz__art_node_alloc(t, RZ__ART_NODE4);
+                parent->prefix_len  = diff;
+                memcpy(parent->prefix, node->prefix, RZ_MIN(diff, RZ_ART_MAX_PREFIX));
+                *ref = parent;
+
+                rz_u8 c;
+                if (node->prefix_len <= RZ_ART_MAX_PREFIX) {
+                    c                 = node->prefix[diff];
+                    node->prefix_len -= diff + 1;
+                    memmove(node->prefix, node->prefix + diff + 1, node->prefix_len);
+                } else {
+                    const rz_u8 *min_key  = rz__art_leaf_key(rz__art_minimum(node), valuesize);
+                    c                     = min_key[depth + diff];
+                    node->prefix_len     -= diff + 1;
+                    memcpy(node->prefix, min_key + depth + diff + 1, RZ_MIN(node->prefix_len, RZ_ART_MAX_PREFIX));
+                }
+                rz__art_add_child(t, ref, parent, c, node);
+
+                RZ__ArtLeaf *l = rz__art_leaf_alloc(t, valuesize, key, key_len);
+                rz__art_attach(t, ref, parent, l, valuesize, depth + diff);
+                t->len++;
+                return rz__art_leaf_value(l);
+            }
+            depth += node->prefix_len;
+        }
+
+        if (depth == key_len) {
+            if (node->leaf != NULL) {
+                RZ_DBG_ASSERT(rz__art_leaf_eq(node->leaf, valuesize, key, key_len));
+                return rz__art_leaf_value(node->leaf);
+            }
+            node->leaf = rz__art_leaf_alloc(t, valuesize, key, key_len);
+            t->len++;
+            return rz__art_leaf_value(node->leaf);
+        }
+
+        void **child = rz__art_find_child(node, key[depth]);
+        if (child == NULL) {
+            RZ__ArtLeaf *l = rz__art_leaf_alloc(t, valuesize, key, key_len);
+            rz__art_add_child(t, ref, node, key[depth], rz__art_tag_leaf(l));
+            t->len++;
+            return rz__art_leaf_value(l);
+        }
+        ref = child;
+        depth++;
+    }
+}
+
+RZ_DEF void *rz__art_get(const RZ_ArtOpaque *t, rz_usize valuesize, const void *key_, rz_usize key_len) {
+    RZ_ASSERT_NOT_NULL(t);
+    const rz_u8 *key   = key_;
+    void        *n     = t->root;
+    rz_usize     depth = 0;
+    while (n != NULL) {
+        if (rz__art_is_leaf(n)) {
+            RZ__ArtLeaf *l = rz__art_leaf(n);
+            return rz__art_leaf_eq(l, valuesize, key, key_len) ? rz__art_leaf_value(l) : NULL;
+        }
+        RZ__ArtNode *node = n;
+        if (!rz__art_check_prefix(node, key, key_len, depth)) return NULL;
+        depth += node->prefix_len;
+        if (depth == key_len) {
+            RZ__ArtLeaf *l = node->leaf;
+            return (l != NULL && rz__art_leaf_eq(l, valuesize, key, key_len)) ? rz__art_leaf_value(l) : NULL;
+        }
+        void **child = rz__art_find_child(node, key[depth]);
+        if (child == NULL) return NULL;
+        n = *child;
+        depth++;
+    }
+    return NULL;
+}
+
+RZ_DEF bool rz__art_remove(RZ_ArtOpaque *t, rz_usize valuesize, const void *key_, rz_usize key_len) {
+    RZ_ASSERT_NOT_NULL(t);
+    const rz_u8 *key        = key_;
+    void       **ref        = &t->root;
+    void       **parent_ref = NULL;
+    rz_usize     depth      = 0;
+    while (*ref != NULL) {
+        void *n = *ref;
+        if (rz__art_is_leaf(n)) {
+            RZ__ArtLeaf *l = rz__art_leaf(n);
+            if (!rz__art_leaf_eq(l, valuesize, key, key_len)) return false;
+            if (parent_ref == NULL) {
+                *ref = NULL;
+            } else {
+                rz__art_remove_child(t, parent_ref, *parent_ref, key[depth - 1], ref);
+                rz__art_collapse(t, parent_ref);
+            }
+            rz__art_leaf_dealloc(t, l, valuesize);
+            t->len--;
+            return true;
+        }
+
+        RZ__ArtNode *node = n;
+        if (!rz__art_check_prefix(node, key, key_len, depth)) return false;
+        depth += node->prefix_len;
+        if (depth == key_len) {
+            RZ__ArtLeaf *l = node->leaf;
+            if (l == NULL || !rz__art_leaf_eq(l, valuesize, key, key_len)) return false;
+            node->leaf = NULL;
+            rz__art_collapse(t, ref);
+            rz__art_leaf_dealloc(t, l, valuesize);
+            t->len--;
+            return true;
+        }
+        void **child = rz__art_find_child(node, key[depth]);
+        if (child == NULL) return false;
+        parent_ref = ref;
+        ref        = child;
+        depth++;
+    }
+    return false;
+}
+
+RZ_DEF void *rz__art_longest_prefix(const RZ_ArtOpaque *t, rz_usize valuesize, const void *key_, rz_usize key_len, rz_usize *matched_len) {
+    RZ_ASSERT_NOT_NULL(t);
+    const rz_u8 *key   = key_;
+    RZ__ArtLeaf *best  = NULL;
+    void        *n     = t->root;
+    rz_usize     depth = 0;
+    // every candidate is checked with the leaf key, so the optimistic prefix check is enough.
+#    define rz__art_is_prefix_of_key(l) ((l)->key_len <= key_len && memcmp(rz__art_leaf_key(l, valuesize), key, (l)->key_len) == 0)
+    while (n != NULL) {
+        if (rz__art_is_leaf(n)) {
+            if (rz__art_is_prefix_of_key(rz__art_leaf(n))) best = rz__art_leaf(n);
+            break;
+        }
+        RZ__ArtNode *node = n;
+        if (!rz__art_check_prefix(node, key, key_len, depth)) break;
+        depth += node->prefix_len;
+        if (node->leaf != NULL && rz__art_is_prefix_of_key(node->leaf)) best = node->leaf;
+        if (depth == key_len) break;
+
+        void **child = rz__art_find_child(node, key[depth]);
+        if (child == NULL) break;
+        n = *child;
+        depth++;
+    }
+#    undef rz__art_is_prefix_of_key
+    if (best == NULL) return NULL;
+    if (matched_len != NULL) *matched_len = best->key_len;
+    return rz__art_leaf_value(best);
+}
+
+/////////////// iteration
+typedef struct {
+    rz_usize     valuesize;
+    /// NULL is unbounded
+    const rz_u8 *lo, *hi;
+    rz_usize     lo_len, hi_len;
+    RZ_ArtIterFn fn;
+    void        *user;
+    /// `fn` return false
+    bool         stopped;
+} RZ__ArtIter;
+
+static int rz__art_cmp(const rz_u8 *a, rz_usize a_len, const rz_u8 *b, rz_usize b_len) {
+    rz_usize n = RZ_MIN(a_len, b_len);
+    int      r = (n > 0) ? memcmp(a, b, n) : 0;
+    if (r != 0) return r;
+    return (a_len > b_len) - (a_len < b_len);
+}
+
+// return false to stop the iteration
+static bool rz__art_iter_leaf(RZ__ArtIter *it, RZ__ArtLeaf *l) {
+    const rz_u8 *key = rz__art_leaf_key(l, it->valuesize);
+    if (it->hi != NULL && rz__art_cmp(key, l->key_len, it->hi, it->hi_len) >= 0) return false;
+    if (it->lo != NULL && rz__art_cmp(key, l->key_len, it->lo, it->lo_len) < 0) return true;
+    it->stopped = !it->fn(key, l->key_len, rz__art_leaf_value(l), it->user);
+    return !it->stopped;
+}
+
+// in order traversal. when `bounded`, the keys of the subtree has the same bytes as `lo[0 .. depth)`
+// and the subtrees that is smaller than `lo` is skipped without visiting the leaves.
+static bool rz__art_iter(RZ__ArtIter *it, const void *n, rz_usize depth, bool bounded) {
+    if (rz__art_is_leaf(n)) return rz__art_iter_leaf(it, rz__art_leaf(n));
+
+    const RZ__ArtNode *node = n;
+    rz_usize           end  = depth + node->prefix_len;
+    if (bounded) {
+        const rz_u8 *path = rz__art_leaf_key(rz__art_minimum(node), it->valuesize);
+        rz_usize     m    = RZ_MIN(end, it->lo_len);
+        int          r    = (m > depth) ? memcmp(path + depth, it->lo + depth, m - depth) : 0;
+        if (r < 0) return true;
+        // `lo` is smaller than the prefix or `lo` is the prefix of every key in the subtree
+        if (r > 0 || it->lo_len <= end) bounded = false;
+    }
+
+    if (node->leaf != NULL && !rz__art_iter_leaf(it, node->leaf)) return false;
+    rz_u32 pos = 0;
+    rz_u8  c   = 0;
+    for (void *child; (child = rz__art_next_child(node, &pos, &c)) != NULL;) {
+        if (bounded && c < it->lo[end]) continue;
+        if (!rz__art_iter(it, child, end + 1, bounded && c == it->lo[end])) return false;
+    }
+    return true;
+}
+
+RZ_DEF bool rz__art_foreach_range(const RZ_ArtOpaque *t, rz_usize valuesize, const void *lo, rz_usize lo_len, const void *hi, rz_usize hi_len, RZ_ArtIterFn fn,
+                                  void *user) {
+    RZ_ASSERT_NOT_NULL(t);
+    RZ_ASSERT_NOT_NULL(fn);
+    RZ__ArtIter it = {.valuesize = valuesize, .lo = lo, .lo_len = lo_len, .hi = hi, .hi_len = hi_len, .fn = fn, .user = user};
+    if (t->root != NULL) rz__art_iter(&it, t->root, 0, lo != NULL);
+    return !it.stopped;
+}
+
+RZ_DEF bool rz__art_foreach_prefix(const RZ_ArtOpaque *t, rz_usize valuesize, const void *prefix_, rz_usize prefix_len, RZ_ArtIterFn fn, void *user) {
+    RZ_ASSERT_NOT_NULL(t);
+    RZ_ASSERT_NOT_NULL(fn);
+    RZ__ArtIter  it     = {.valuesize = valuesize, .fn = fn, .user = user};
+    const rz_u8 *prefix = prefix_;
+    void        *n      = t->root;
+    rz_usize     depth  = 0;
+    while (n != NULL) {
+        if (rz__art_is_leaf(n)) {
+            RZ__ArtLeaf *l = rz__art_leaf(n);
+            if (l->key_len >= prefix_len && memcmp(rz__art_leaf_key(l, valuesize), prefix, prefix_len) == 0) rz__art_iter_leaf(&it, l);
+            break;
+        }
+
+        RZ__ArtNode *node = n;
+        rz_usize     end  = depth + node->prefix_len;
+        rz_usize     m    = RZ_MIN(end, prefix_len);
+        if (m > depth) {
+            // the stored prefix is not enough, compare with the full path of the subtree
+            const rz_u8 *path = ((m - depth) <= RZ_ART_MAX_PREFIX) ? node->prefix : rz__art_leaf_key(rz__art_minimum(node), valuesize) + depth;
+            if (memcmp(path, prefix + depth, m - depth) != 0) break;
+        }
+        if (end >= prefix_len) {
+            // every key in the subtree start with `prefix`
+            rz__art_iter(&it, n, depth, false);
+            break;
+        }
+        void **child = rz__art_find_child(node, prefix[end]);
+        if (child == NULL) break;
+        n     = *child;
+        depth = end + 1;
+    }
+    return !it.stopped;
+}
+
+#endif /* ifdef RZ_ART_IMPL */
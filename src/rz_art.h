@@ -0,0 +1,123 @@
+#pragma once
+#ifndef RZ_ART_H
+#    define RZ_ART_H
+#    include "rz_allocator.h"
+#    include "rz_common.h"
+
+/// Adaptive radix tree (ART), ordered map of byte string keys.
+/// the inner node grow and shrink between 4 types by the amount of children:
+///  - Node4  : 4 sorted key bytes and 4 children
+///  - Node16 : 16 sorted key bytes (SSE2 compare) and 16 children
+///  - Node48 : 256 bytes index into 48 children
+///  - Node256: 256 children, direct lookup
+/// the common prefix of the subtree is compressed into the node (path compression, the first
+/// RZ_ART_MAX_PREFIX bytes is stored, the rest is checked against the leaf), so the lookup is
+/// O(key length) independent of the amount of keys, and the iteration is in the lexicographic order of keys.
+/// a key can be the prefix of another key (e.g. "/usr" and "/usr/lib").
+///
+/// the leaves and nodes is allocated from `allocator` (e.g. the arena of rz_arena_allocator).
+/// integer key must be big endian to keep the order, see rz_art_key_u64.
+///
+/// Example:
+///  RZ_Art(rz_u32) paths = {.allocator = rz_std_allocator()};
+///  rz_art_insert(&paths, "/usr/lib", 8, 1);
+///  rz_art_insert_cstr(&paths, "/usr/bin", 2);
+///  rz_u32 *id = rz_art_get_cstr(&paths, "/usr/bin");
+///  rz_art_foreach_prefix(&paths, "/usr/", 5, print_path, NULL);
+///  rz_art_free(&paths);
+///
+/// NOTE: the value pointer is valid until the key is removed.
+
+#    if defined(__cplusplus)
+extern "C" {
+#    endif
+
+#    ifndef RZ_ART_MAX_PREFIX
+#        define RZ_ART_MAX_PREFIX 10U
+#    endif
+
+/// called for every key in order, return false to stop the iteration.
+typedef bool (*RZ_ArtIterFn)(const rz_u8 *key, rz_usize key_len, void *value, void *user);
+
+#    define RZ__ART_STRUCT_MEMBERS                      \
+        /* root - tagged pointer of the root node */  \
+        void        *root;                            \
+        /* len - the amount of keys */                \
+        rz_usize     len;                             \
+        RZ_Allocator allocator
+
+#    define RZ_Art(V)                   \
+        struct {                        \
+            RZ__ART_STRUCT_MEMBERS;     \
+            V *__temp;                  \
+        }
+
+typedef RZ_Art(void) RZ_ArtOpaque;
+
+/// big endian representation of integer key, so the order of the keys is the numeric order.
+typedef struct {
+    rz_u8 data[8];
+} RZ_ArtIntKey;
+
+static inline RZ_ArtIntKey rz_art_key_u64(rz_u64 v) {
+    RZ_ArtIntKey k;
+    for (rz_u32 i = 0; i < 8; ++i) k.data[i] = (rz_u8)(v >> (56u - (i * 8u)));
+    return k;
+}
+
+// clang-format off
+///    void rz_art_free(RZ_Art(V) *t);
+#    define rz_art_free(t)                          rz__art_free((RZ_ArtOpaque *)(t), sizeof(*(t)->__temp))
+#    define rz_art_clear                            rz_art_free
+
+///  insert the key or replace the value of the existing key.
+///    void rz_art_insert(RZ_Art(V) *t, const void *key, rz_usize key_len, V value);
+///    void rz_art_insert_cstr(RZ_Art(V) *t, const char *key, V value);
+///    void rz_art_insert_u64(RZ_Art(V) *t, rz_u64 key, V value);
+#    define rz_art_insert(t, key, key_len, value)   ((t)->__temp = rz__art_insert((RZ_ArtOpaque *)(t), sizeof(*(t)->__temp), (key), (key_len)), (void)(*(t)->__temp = (value)))
+#    define rz_art_insert_cstr(t, key, value)       rz_art_insert(t, key, strlen(key), value)
+#    define rz_art_insert_u64(t, key, value)        rz_art_insert(t, rz_art_key_u64(key).data, 8, value)
+
+///  get pointer to the value, NULL if the key is not found.
+///      V* rz_art_get(RZ_Art(V) *t, const void *key, rz_usize key_len);
+///      V* rz_art_get_cstr(RZ_Art(V) *t, const char *key);
+///      V* rz_art_get_u64(RZ_Art(V) *t, rz_u64 key);
+#    define rz_art_get(t, key, key_len)             ((RZ_TYPEOF((t)->__temp))rz__art_get((const RZ_ArtOpaque *)(t), sizeof(*(t)->__temp), (key), (key_len)))
+#    define rz_art_get_cstr(t, key)                 rz_art_get(t, key, strlen(key))
+#    define rz_art_get_u64(t, key)                  rz_art_get(t, rz_art_key_u64(key).data, 8)
+#    define rz_art_contains(t, key, key_len)        (rz_art_get(t, key, key_len) != NULL)
+
+///  remove the key, return false if the key is not found.
+///    bool rz_art_remove(RZ_Art(V) *t, const void *key, rz_usize key_len);
+#    define rz_art_remove(t, key, key_len)          rz__art_remove((RZ_ArtOpaque *)(t), sizeof(*(t)->__temp), (key), (key_len))
+#    define rz_art_remove_u64(t, key)               rz_art_remove(t, rz_art_key_u64(key).data, 8)
+
+///  the value of the longest key that is the prefix of `key` (e.g. the route table), NULL if there is none.
+///  `matched_len` (nullable) is set to the length of the matched key.
+///      V* rz_art_longest_prefix(RZ_Art(V) *t, const void *key, rz_usize key_len, rz_usize *matched_len);
+#    define rz_art_longest_prefix(t, key, key_len, matched_len) ((RZ_TYPEOF((t)->__temp))rz__art_longest_prefix((const RZ_ArtOpaque *)(t), sizeof(*(t)->__temp), (key), (key_len), (matched_len)))
+
+///  iterate the keys in order: all the keys, the keys that start with `prefix`,
+///  or the keys in the range [lo, hi) (NULL `lo`/`hi` is unbounded).
+///  return false if the iteration is stopped by `fn`.
+///    bool rz_art_foreach(RZ_Art(V) *t, RZ_ArtIterFn fn, void *user);
+///    bool rz_art_foreach_prefix(RZ_Art(V) *t, const void *prefix, rz_usize prefix_len, RZ_ArtIterFn fn, void *user);
+///    bool rz_art_foreach_range(RZ_Art(V) *t, const void *lo, rz_usize lo_len, const void *hi, rz_usize hi_len, RZ_ArtIterFn fn, void *user);
+#    define rz_art_foreach(t, fn, user)             rz__art_foreach_range((const RZ_ArtOpaque *)(t), sizeof(*(t)->__temp), NULL, 0, NULL, 0, (fn), (user))
+#    define rz_art_foreach_prefix(t, prefix, prefix_len, fn, user) rz__art_foreach_prefix((const RZ_ArtOpaque *)(t), sizeof(*(t)->__temp), (prefix), (prefix_len), (fn), (user))
+#    define rz_art_foreach_range(t, lo, lo_len, hi, hi_len, fn, user) rz__art_foreach_range((const RZ_ArtOpaque *)(t), sizeof(*(t)->__temp), (lo), (lo_len), (hi), (hi_len), (fn), (user))
+// clang-format on
+
+RZ_DEC void  rz__art_free(RZ_ArtOpaque *t, rz_usize valuesize);
+RZ_DEC void *rz__art_insert(RZ_ArtOpaque *t, rz_usize valuesize, const void *key, rz_usize key_len);
+RZ_DEC void *rz__art_get(const RZ_ArtOpaque *t, rz_usize valuesize, const void *key, rz_usize key_len);
+RZ_DEC bool  rz__art_remove(RZ_ArtOpaque *t, rz_usize valuesize, const void *key, rz_usize key_len);
+RZ_DEC void *rz__art_longest_prefix(const RZ_ArtOpaque *t, rz_usize valuesize, const void *key, rz_usize key_len, rz_usize *matched_len);
+RZ_DEC bool  rz__art_foreach_prefix(const RZ_ArtOpaque *t, rz_usize valuesize, const void *prefix, rz_usize prefix_len, RZ_ArtIterFn fn, void *user);
+RZ_DEC bool  rz__art_foreach_range(const RZ_ArtOpaque *t, rz_usize valuesize, const void *lo, rz_usize lo_len, const void *hi, rz_usize hi_len, RZ_ArtIterFn fn,
+                                   void *user);
+
+#    if defined(__cplusplus)
+}
+#    endif
+#endif /* end of include guard: RZ_ART_H */
@@ -0,0 +1,769 @@
+#include "rz_bitset.h"
+
+#ifdef RZ_BITSET_IMPL
+
+///////////////
+/// word kernels
+///
+#    if RZ_TARGET_SIMD_AVX2
+#        define RZ__BITSET_VEC_WORDS   4u
+#        define rz__bitset_vec_t       __m256i
+#        define rz__bitset_load(p)     _mm256_loadu_si256((const __m256i *)(p))
+#        define rz__bitset_store(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#        define rz__bitset_vand(a, b)  _mm256_and_si256(a, b)
+#        define rz__bitset_vor(a, b)   _mm256_or_si256(a, b)
+#        define rz__bitset_vxor(a, b)  _mm256_xor_si256(a, b)
+// `_mm256_andnot_si256(a, b)` is `~a & b`
+#        define rz__bitset_vandn(a, b) _mm256_andnot_si256(b, a)
+#    elif RZ_TARGET_SIMD_SSE2
+#        define RZ__BITSET_VEC_WORDS   2u
+#        define rz__bitset_vec_t       __m128i
+#        define rz__bitset_load(p)     _mm_loadu_si128((const __m128i *)(p))
+#        define rz__bitset_store(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#        define rz__bitset_vand(a, b)  _mm_and_si128(a, b)
+#        define rz__bitset_vor(a, b)   _mm_or_si128(a, b)
+#        define rz__bitset_vxor(a, b)  _mm_xor_si128(a, b)
+#        define rz__bitset_vandn(a, b) _mm_andnot_si128(b, a)
+#    endif
+
+#    ifdef RZ__BITSET_VEC_WORDS
+#        define RZ__BITSET_VEC_LOOP(VOP)                                                                         \
+            for (; (i + RZ__BITSET_VEC_WORDS) <= nwords; i += RZ__BITSET_VEC_WORDS) {                            \
+                rz__bitset_store(dst + i, VOP(rz__bitset_load(dst + i), rz__bitset_load(src + i))); \
+            }
+#    else
+#        define RZ__BITSET_VEC_LOOP(VOP)
+#    endif
+
+RZ_DEF void rz__bitset_words_op(rz_u64 *dst, const rz_u64 *src, rz_usize nwords, RZ_BitsetOp op) {
+    rz_usize i = 0;
+    switch (op) {
+    case RZ_BITSET_OP_AND:
+        RZ__BITSET_VEC_LOOP(rz__bitset_vand)
+        for (; i < nwords; ++i) dst[i] &= src[i];
+        break;
+    case RZ_BITSET_OP_OR:
+        RZ__BITSET_VEC_LOOP(rz__bitset_vor)
+        for (; i < nwords; ++i) dst[i] |= src[i];
+        break;
+    case RZ_BITSET_OP_XOR:
+        RZ__BITSET_VEC_LOOP(rz__bitset_vxor)
+        for (; i < nwords; ++i) dst[i] ^= src[i];
+        break;
+    case RZ_BITSET_OP_ANDNOT:
+        RZ__BITSET_VEC_LOOP(rz__bitset_vandn)
+        for (; i < nwords; ++i) dst[i] &= ~src[i];
+        break;
+    default: RZ_UNREACHABLE("rz__bitset_words_op: RZ_BitsetOp");
+    }
+}
+
+RZ_DEF rz_usize rz__bitset_words_count(const rz_u64 *words, rz_usize nwords) {
+    // 4 independent accumulators, so the popcnt of each word is not serialized on one register.
+    rz_usize c0 = 0, c1 = 0, c2 = 0, c3 = 0, i = 0;
+    for (; (i + 4) <= nwords; i += 4) {
+        c0 += rz_popcount64(words[i + 0]);
+        c1 += rz_popcount64(words[i + 1]);
+        c2 += rz_popcount64(words[i + 2]);
+        c3 += rz_popcount64(words[i + 3]);
+    }
+    for (; i < nwords; ++i) c0 += rz_popcount64(words[i]);
+    return c0 + c1 + c2 + c3;
+}
+
+// index of the `k`-th set bit in `w` (k < popcount(w))
+static inline rz_u32 rz__bitset_select_word(rz_u64 w, rz_usize k) {
+    for (; k > 0; --k) w &= w - 1;
+    return rz_ctz64(w);
+}
+
+static inline rz_u64 rz__bitset_tail_mask(rz_usize nbits) {
+    return (nbits % RZ_BITSET_WORD_BITS) ? (((rz_u64)1 << (nbits % RZ_BITSET_WORD_BITS)) - 1) : ~(rz_u64)0;
+}
+
+///////////////
+/// Bitset
+///
+RZ_DEF void rz_bitset_init(RZ_Bitset *bs, rz_usize nbits, RZ_Allocator allocator) {
+    RZ_ASSERT_NOT_NULL(bs);
+    if (!rz_is_allocator(allocator)) allocator = rz_std_allocator();
+    *bs = (RZ_Bitset){.allocator = allocator};
+    rz_bitset_resize(bs, nbits);
+}
+
+RZ_DEF void rz_bitset_free(RZ_Bitset *bs) {
+    RZ_ASSERT_NOT_NULL(bs);
+    if (bs->words != NULL) rz_raw_dealloc(bs->allocator, bs->words, bs->capacity * sizeof(rz_u64));
+    bs->words    = NULL;
+    bs->nbits    = 0;
+    bs->capacity = 0;
+}
+
+RZ_DEF void rz_bitset_resize(RZ_Bitset *bs, rz_usize nbits) {
+    RZ_ASSERT_NOT_NULL(bs);
+    rz_usize nwords     = rz_bitset_words_len(nbits);
+    rz_usize old_nwords = rz_bitset_words_len(bs->nbits);
+    if (nwords > bs->capacity) {
+        if (!rz_is_allocator(bs->allocator)) bs->allocator = rz_std_allocator();
+        rz_usize new_capacity = RZ_MAX(nwords, bs->capacity + (bs->capacity >> 1u));
+        bs->words             = rz_raw_remap(bs->allocator, bs->words, bs->capacity * sizeof(rz_u64), new_capacity * sizeof(rz_u64));
+        RZ_ASSERT_ALLOCATOR_PTR(bs->words);
+        memset(bs->words + bs->capacity, 0, (new_capacity - bs->capacity) * sizeof(rz_u64));
+        bs->capacity = new_capacity;
+    }
+    // keep the bits after `nbits` cleared, so growing again expose zeros.
+    if (nbits < bs->nbits) {
+        memset(bs->words + nwords, 0, (old_nwords - nwords) * sizeof(rz_u64));
+        if (nwords > 0) bs->words[nwords - 1] &= rz__bitset_tail_mask(nbits);
+    }
+    bs->nbits = nbits;
+}
+
+RZ_DEF void rz_bitset_set_all(RZ_Bitset *bs) {
+    rz_usize nwords = rz_bitset_words_len(bs->nbits);
+    if (nwords == 0) return;
+    memset(bs->words, 0xff, nwords * sizeof(rz_u64));
+    bs->words[nwords - 1] &= rz__bitset_tail_mask(bs->nbits);
+}
+
+RZ_DEF void rz_bitset_clear_all(RZ_Bitset *bs) {
+    if (bs->words != NULL) memset(bs->words, 0, rz_bitset_words_len(bs->nbits) * sizeof(rz_u64));
+}
+
+RZ_DEF void rz_bitset_set_range(RZ_Bitset *bs, rz_usize start, rz_usize end, bool value) {
+    RZ_ASSERT(start <= end && end <= bs->nbits, "rz_bitset_set_range: invalid range");
+    while (start < end) {
+        rz_usize wi   = start / RZ_BITSET_WORD_BITS;
+        rz_usize lo   = start % RZ_BITSET_WORD_BITS;
+        rz_usize n    = RZ_MIN(RZ_BITSET_WORD_BITS - lo, end - start);
+        rz_u64   mask = ((n == RZ_BITSET_WORD_BITS) ? ~(rz_u64)0 : (((rz_u64)1 << n) - 1)) << lo;
+        if (value) bs->words[wi] |= mask;
+        else bs->words[wi] &= ~mask;
+        start += n;
+    }
+}
+
+RZ_DEF rz_usize rz_bitset_count(const RZ_Bitset *bs) {
+    return rz__bitset_words_count(bs->words, rz_bitset_words_len(bs->nbits));
+}
+
+RZ_DEF rz_usize rz_bitset_rank(const RZ_Bitset *bs, rz_usize i) {
+    RZ_ASSERT(i <= bs->nbits, "rz_bitset_rank: index out of bound");
+    rz_usize wi   = i / RZ_BITSET_WORD_BITS;
+    rz_usize rank = rz__bitset_words_count(bs->words, wi);
+    if (i % RZ_BITSET_WORD_BITS) rank += rz_popcount64(bs->words[wi] & rz__bitset_tail_mask(i));
+    return rank;
+}
+
+RZ_DEF rz_usize rz_bitset_select(const RZ_Bitset *bs, rz_usize k) {
+    rz_usize nwords = rz_bitset_words_len(bs->nbits);
+    for (rz_usize wi = 0; wi < nwords; ++wi) {
+        rz_usize c = rz_popcount64(bs->words[wi]);
+        if (k < c) return (wi * RZ_BITSET_WORD_BITS) + rz__bitset_select_word(bs->words[wi], k);
+        k -= c;
+    }
+    return RZ_NOT_FOUND;
+}
+
+RZ_DEF rz_usize rz_bitset_next_set(const RZ_Bitset *bs, rz_usize from) {
+    if (from >= bs->nbits) return RZ_NOT_FOUND;
+    rz_usize nwords = rz_bitset_words_len(bs->nbits);
+    rz_usize wi     = from / RZ_BITSET_WORD_BITS;
+    rz_u64   w      = bs->words[wi] & (~(rz_u64)0 << (from % RZ_BITSET_WORD_BITS));
+    for (;;) {
+        if (w != 0) return (wi * RZ_BITSET_WORD_BITS) + rz_ctz64(w);
+        if (++wi >= nwords) return RZ_NOT_FOUND;
+        w = bs->words[wi];
+    }
+}
+
+RZ_DEF void rz_bitset_op(RZ_Bitset *dst, const RZ_Bitset *src, RZ_BitsetOp op) {
+    RZ_ASSERT(dst != NULL && src != NULL);
+    if ((op == RZ_BITSET_OP_OR || op == RZ_BITSET_OP_XOR) && src->nbits > dst->nbits) rz_bitset_resize(dst, src->nbits);
+
+    rz_usize dn = rz_bitset_words_len(dst->nbits);
+    rz_usize n  = RZ_MIN(dn, rz_bitset_words_len(src->nbits));
+    rz__bitset_words_op(dst->words, src->words, n, op);
+    if (op == RZ_BITSET_OP_AND && dn > n) memset(dst->words + n, 0, (dn - n) * sizeof(rz_u64));
+}
+
+RZ_DEF rz_usize rz_bitset_and_count(const RZ_Bitset *a, const RZ_Bitset *b) {
+    rz_usize n     = RZ_MIN(rz_bitset_words_len(a->nbits), rz_bitset_words_len(b->nbits));
+    rz_usize count = 0;
+    for (rz_usize i = 0; i < n; ++i) count += rz_popcount64(a->words[i] & b->words[i]);
+    return count;
+}
+
+///////////////
+/// Roaring
+///
+#    define RZ__ROARING_CHUNK_BITS 65536u
+
+static inline rz_u16 *rz__roaring_u16(const RZ_RoaringContainer *c) {
+    return (rz_u16 *)c->data;
+}
+static inline rz_u64 *rz__roaring_words(const RZ_RoaringContainer *c) {
+    return (rz_u64 *)c->data;
+}
+
+static rz_usize rz__roaring_data_bytes(RZ_RoaringKind kind, rz_u32 capacity) {
+    switch (kind) {
+    case RZ_ROARING_ARRAY: return capacity * sizeof(rz_u16);
+    case RZ_ROARING_BITMAP: return RZ_ROARING_BITMAP_WORDS * sizeof(rz_u64);
+    case RZ_ROARING_RUN: return capacity * 2 * sizeof(rz_u16);
+    default: RZ_UNREACHABLE("rz__roaring_data_bytes: RZ_RoaringKind");
+    }
+}
+
+static RZ_RoaringContainer rz__roaring_container_new(RZ_Allocator a, rz_u16 key, RZ_RoaringKind kind, rz_u32 capacity) {
+    if (kind == RZ_ROARING_BITMAP) capacity = RZ_ROARING_BITMAP_WORDS;
+    RZ_RoaringContainer c = {.key = key, .kind = kind, .capacity = capacity};
+    c.data                = rz_raw_alloc(a, rz__roaring_data_bytes(kind, capacity));
+    RZ_ASSERT_ALLOCATOR_PTR(c.data);
+    if (kind == RZ_ROARING_BITMAP) memset(c.data, 0, rz__roaring_data_bytes(kind, capacity));
+    return c;
+}
+
+static void rz__roaring_container_free(RZ_Allocator a, RZ_RoaringContainer *c) {
+    if (c->data != NULL) rz_raw_dealloc(a, c->data, rz__roaring_data_bytes(c->kind, c->capacity));
+    c->data = NULL;
+}
+
+static RZ_RoaringContainer rz__roaring_container_clone(RZ_Allocator a, const RZ_RoaringContainer *c) {
+    RZ_RoaringContainer res = *c;
+    rz_usize            sz  = rz__roaring_data_bytes(c->kind, c->capacity);
+    res.data                = rz_raw_alloc(a, sz);
+    RZ_ASSERT_ALLOCATOR_PTR(res.data);
+    memcpy(res.data, c->data, sz);
+    return res;
+}
+
+// lower bound of `v` in sorted u16 array. `*found` is true if `arr[idx] == v`.
+static rz_u32 rz__roaring_u16_search(const rz_u16 *arr, rz_u32 len, rz_u16 v, bool *found) {
+    rz_u32 lo = 0, hi = len;
+    while (lo < hi) {
+        rz_u32 mid = lo + ((hi - lo) / 2);
+        if (arr[mid] < v) lo = mid + 1;
+        else hi = mid;
+    }
+    *found = (lo < len) && (arr[lo] == v);
+    return lo;
+}
+
+static bool rz__roaring_run_contains(const rz_u16 *runs, rz_u32 len, rz_u16 v) {
+    // find the last run with start <= v
+    rz_u32 lo = 0, hi = len;
+    while (lo < hi) {
+        rz_u32 mid = lo + ((hi - lo) / 2);
+        if (runs[mid * 2] <= v) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == 0) return false;
+    rz_u32 start = runs[(lo - 1) * 2];
+    return v <= (start + runs[((lo - 1) * 2) + 1]);
+}
+
+static bool rz__roaring_container_contains(const RZ_RoaringContainer *c, rz_u16 low) {
+    bool found = false;
+    switch (c->kind) {
+    case RZ_ROARING_ARRAY: rz__roaring_u16_search(rz__roaring_u16(c), c->len, low, &found); return found;
+    case RZ_ROARING_BITMAP: return (rz__roaring_words(c)[low >> 6u] >> (low & 63u)) & 1u;
+    case RZ_ROARING_RUN: return rz__roaring_run_contains(rz__roaring_u16(c), c->len, low);
+    default: RZ_UNREACHABLE("rz__roaring_container_contains: RZ_RoaringKind");
+    }
+}
+
+static void rz__roaring_words_set_range(rz_u64 *words, rz_u32 start, rz_u32 end_inclusive) {
+    RZ_Bitset bs = {.words = words, .nbits = RZ__ROARING_CHUNK_BITS, .capacity = RZ_ROARING_BITMAP_WORDS};
+    rz_bitset_set_range(&bs, start, (rz_usize)end_inclusive + 1, true);
+}
+
+// expand any container into 1024 words
+static void rz__roaring_container_to_words(const RZ_RoaringContainer *c, rz_u64 *words) {
+    switch (c->kind) {
+    case RZ_ROARING_BITMAP: memcpy(words, c->data, RZ_ROARING_BITMAP_WORDS * sizeof(rz_u64)); break;
+    case RZ_ROARING_ARRAY:
+        memset(words, 0, RZ_ROARING_BITMAP_WORDS * sizeof(rz_u64));
+        for (rz_u32 i = 0; i < c->len; ++i) {
+            rz_u16 v = rz__roaring_u16(c)[i];
+            words[v >> 6u] |= (rz_u64)1 << (v & 63u);
+        }
+        break;
+    case RZ_ROARING_RUN:
+        memset(words, 0, RZ_ROARING_BITMAP_WORDS * sizeof(rz_u64));
+        for (rz_u32 i = 0; i < c->len; ++i) {
+            rz_u16 start = rz__roaring_u16(c)[i * 2];
+            rz__roaring_words_set_range(words, start, (rz_u32)start + rz__roaring_u16(c)[(i * 2) + 1]);
+        }
+        break;
+    default: RZ_UNREACHABLE("rz__roaring_container_to_words: RZ_RoaringKind");
+    }
+}
+
+// build the smallest of array or bitmap container from words. `card` is the popcount of words.
+static RZ_RoaringContainer rz__roaring_container_from_words(RZ_Allocator a, rz_u16 key, const rz_u64 *words, rz_u32 card) {
+    if (card == 0) return (RZ_RoaringContainer){.key = key};
+    if (card > RZ_ROARING_ARRAY_MAX) {
+        RZ_RoaringContainer c = rz__roaring_container_new(a, key, RZ_ROARING_BITMAP, 0);
+        memcpy(c.data, words, RZ_ROARING_BITMAP_WORDS * sizeof(rz_u64));
+        c.card = card;
+        return c;
+    }
+    RZ_RoaringContainer c   = rz__roaring_container_new(a, key, RZ_ROARING_ARRAY, card);
+    rz_u16             *arr = c.data;
+    for (rz_u32 wi = 0; wi < RZ_ROARING_BITMAP_WORDS; ++wi) {
+        for (rz_u64 w = words[wi]; w != 0; w &= w - 1) arr[c.len++] = (rz_u16)((wi * 64u) + rz_ctz64(w));
+    }
+    c.card = card;
+    return c;
+}
+
+// convert container (in place) into array or bitmap, depend on the cardinality.
+static void rz__roaring_container_unrun(RZ_Allocator a, RZ_RoaringContainer *c, rz_u64 *tmp_words) {
+    rz__roaring_container_to_words(c, tmp_words);
+    RZ_RoaringContainer res = rz__roaring_container_from_words(a, c->key, tmp_words, c->card);
+    rz__roaring_container_free(a, c);
+    *c = res;
+}
+
+static bool rz__roaring_container_add(RZ_Allocator a, RZ_RoaringContainer *c, rz_u16 low) {
+    switch (c->kind) {
+    case RZ_ROARING_ARRAY: {
+        bool   found = false;
+        rz_u32 idx   = rz__roaring_u16_search(rz__roaring_u16(c), c->len, low, &found);
+        if (found) return false;
+        if (c->card >= RZ_ROARING_ARRAY_MAX) {
+            RZ_RoaringContainer res = rz__roaring_container_new(a, c->key, RZ_ROARING_BITMAP, 0);
+            rz__roaring_container_to_words(c, res.data);
+            res.card = c->card;
+            rz__roaring_container_free(a, c);
+            *c = res;
+            return rz__roaring_container_add(a, c, low);
+        }
+        if (c->len == c->capacity) {
+            rz_u32 new_capacity = RZ_MIN(RZ_MAX(c->capacity * 2, 4u), RZ_ROARING_ARRAY_MAX);
+            c->data             = rz_raw_remap(a, c->data, c->capacity * sizeof(rz_u16), new_capacity * sizeof(rz_u16));
+            RZ_ASSERT_ALLOCATOR_PTR(c->data);
+            c->capacity = new_capacity;
+        }
+        rz_u16 *arr = c->data;
+        memmove(arr + idx + 1, arr + idx, (c->len - idx) * sizeof(rz_u16));
+        arr[idx] = low;
+        c->len++;
+        c->card++;
+        return true;
+    }
+    case RZ_ROARING_BITMAP: {
+        rz_u64 *w   = &rz__roaring_words(c)[low >> 6u];
+        rz_u64  bit = (rz_u64)1 << (low & 63u);
+        if (*w & bit) return false;
+        *w |= bit;
+        c->card++;
+        return true;
+    }
+    case RZ_ROARING_RUN: {
+        if (rz__roaring_run_contains(rz__roaring_u16(c), c->len, low)) return false;
+        rz_u64 words[RZ_ROARING_BITMAP_WORDS];
+        rz__roaring_container_unrun(a, c, words);
+        return rz__roaring_container_add(a, c, low);
+    }
+    default: RZ_UNREACHABLE("rz__roaring_container_add: RZ_RoaringKind");
+    }
+}
+
+static bool rz__roaring_container_remove(RZ_Allocator a, RZ_RoaringContainer *c, rz_u16 low) {
+    switch (c->kind) {
+    case RZ_ROARING_ARRAY: {
+        bool   found = false;
+        rz_u32 idx   = rz__roaring_u16_search(rz__roaring_u16(c), c->len, low, &found);
+        if (!found) return false;
+        rz_u16 *arr = c->data;
+        memmove(arr + idx, arr + idx + 1, (c->len - idx - 1) * sizeof(rz_u16));
+        c->len--;
+        c->card--;
+        return true;
+    }
+    case RZ_ROARING_BITMAP: {
+        rz_u64 *w   = &rz__roaring_words(c)[low >> 6u];
+        rz_u64  bit = (rz_u64)1 << (low & 63u);
+        if (!(*w & bit)) return false;
+        *w &= ~bit;
+        c->card--;
+        if (c->card <= RZ_ROARING_ARRAY_MAX) {
+            RZ_RoaringContainer res = rz__roaring_container_from_words(a, c->key, c->data, c->card);
+            rz__roaring_container_free(a, c);
+            *c = res;
+        }
+        return true;
+    }
+    case RZ_ROARING_RUN: {
+        if (!rz__roaring_run_contains(rz__roaring_u16(c), c->len, low)) return false;
+        rz_u64 words[RZ_ROARING_BITMAP_WORDS];
+        rz__roaring_container_unrun(a, c, words);
+        return rz__roaring_container_remove(a, c, low);
+    }
+    default: RZ_UNREACHABLE("rz__roaring_container_remove: RZ_RoaringKind");
+    }
+}
+
+static rz_usize rz__roaring_find(const RZ_Roaring *r, rz_u16 key, bool *found) {
+    rz_usize lo = 0, hi = r->containers.len;
+    while (lo < hi) {
+        rz_usize mid = lo + ((hi - lo) / 2);
+        if (r->containers.data[mid].key < key) lo = mid + 1;
+        else hi = mid;
+    }
+    *found = (lo < r->containers.len) && (r->containers.data[lo].key == key);
+    return lo;
+}
+
+static void rz__roaring_insert_at(RZ_Roaring *r, rz_usize idx, RZ_RoaringContainer c) {
+    rz__arr_grow(&r->containers, r->containers.len + 1);
+    memmove(r->containers.data + idx + 1, r->containers.data + idx, (r->containers.len - idx) * sizeof(RZ_RoaringContainer));
+    r->containers.data[idx] = c;
+    r->containers.len++;
+}
+
+static void rz__roaring_remove_at(RZ_Roaring *r, rz_usize idx) {
+    rz__roaring_container_free(r->containers.allocator, &r->containers.data[idx]);
+    memmove(r->containers.data + idx, r->containers.data + idx + 1, (r->containers.len - idx - 1) * sizeof(RZ_RoaringContainer));
+    r->containers.len--;
+}
+
+RZ_DEF void rz_roaring_init(RZ_Roaring *r, RZ_Allocator allocator) {
+    RZ_ASSERT_NOT_NULL(r);
+    if (!rz_is_allocator(allocator)) allocator = rz_std_allocator();
+    *r = (RZ_Roaring){.containers = {.allocator = allocator}};
+}
+
+RZ_DEF void rz_roaring_clear(RZ_Roaring *r) {
+    RZ_ASSERT_NOT_NULL(r);
+    rz_arr_foreach(c, &r->containers) { rz__roaring_container_free(r->containers.allocator, c); }
+    r->containers.len = 0;
+}
+
+RZ_DEF void rz_roaring_free(RZ_Roaring *r) {
+    rz_roaring_clear(r);
+    if (r->containers.data != NULL) rz_arr_free(&r->containers);
+}
+
+RZ_DEF bool rz_roaring_add(RZ_Roaring *r, rz_u32 value) {
+    RZ_ASSERT_NOT_NULL(r);
+    if (!rz_is_allocator(r->containers.allocator)) r->containers.allocator = rz_std_allocator();
+    rz_u16   key   = (rz_u16)(value >> 16u);
+    bool     found = false;
+    rz_usize idx   = rz__roaring_find(r, key, &found);
+    if (!found) rz__roaring_insert_at(r, idx, rz__roaring_container_new(r->containers.allocator, key, RZ_ROARING_ARRAY, 4));
+    return rz__roaring_container_add(r->containers.allocator, &r->containers.data[idx], (rz_u16)value);
+}
+
+RZ_DEF void rz_roaring_add_range(RZ_Roaring *r, rz_u64 start, rz_u64 end) {
+    RZ_ASSERT_NOT_NULL(r);
+    RZ_ASSERT(start <= end && end <= ((rz_u64)1 << 32u), "rz_roaring_add_range: invalid range");
+    if (start == end) return;
+    if (!rz_is_allocator(r->containers.allocator)) r->containers.allocator = rz_std_allocator();
+    RZ_Allocator a = r->containers.allocator;
+
+    rz_u64 words[RZ_ROARING_BITMAP_WORDS];
+    for (rz_u64 key = start >> 16u; key <= ((end - 1) >> 16u); ++key) {
+        rz_u32   lo    = (key == (start >> 16u)) ? (rz_u32)(start & 0xffff) : 0;
+        rz_u32   hi    = (key == ((end - 1) >> 16u)) ? (rz_u32)((end - 1) & 0xffff) : 0xffff;
+        bool     found = false;
+        rz_usize idx   = rz__roaring_find(r, (rz_u16)key, &found);
+        if (!found) {
+            // a single run is always the smallest container for a fresh range.
+            RZ_RoaringContainer c = rz__roaring_container_new(a, (rz_u16)key, RZ_ROARING_RUN, 1);
+            rz__roaring_u16(&c)[0] = (rz_u16)lo;
+            rz__roaring_u16(&c)[1] = (rz_u16)(hi - lo);
+            c.len                  = 1;
+            c.card                 = (hi - lo) + 1;
+            rz__roaring_insert_at(r, idx, c);
+            continue;
+        }
+        RZ_RoaringContainer *c = &r->containers.data[idx];
+        rz__roaring_container_to_words(c, words);
+        rz__roaring_words_set_range(words, lo, hi);
+        RZ_RoaringContainer res = rz__roaring_container_from_words(a, c->key, words, (rz_u32)rz__bitset_words_count(words, RZ_ROARING_BITMAP_WORDS));
+        rz__roaring_container_free(a, c);
+        *c = res;
+    }
+}
+
+RZ_DEF bool rz_roaring_remove(RZ_Roaring *r, rz_u32 value) {
+    RZ_ASSERT_NOT_NULL(r);
+    bool     found = false;
+    rz_usize idx   = rz__roaring_find(r, (rz_u16)(value >> 16u), &found);
+    if (!found) return false;
+    bool removed = rz__roaring_container_remove(r->containers.allocator, &r->containers.data[idx], (rz_u16)value);
+    if (r->containers.data[idx].card == 0) rz__roaring_remove_at(r, idx);
+    return removed;
+}
+
+RZ_DEF bool rz_roaring_contains(const RZ_Roaring *r, rz_u32 value) {
+    bool     found = false;
+    rz_usize idx   = rz__roaring_find(r, (rz_u16)(value >> 16u), &found);
+    return found && rz__roaring_container_contains(&r->containers.data[idx], (rz_u16)value);
+}
+
+RZ_DEF rz_u64 rz_roaring_cardinality(const RZ_Roaring *r) {
+    rz_u64 card = 0;
+    for (rz_usize i = 0; i < r->containers.len; ++i) card += r->containers.data[i].card;
+    return card;
+}
+
+RZ_DEF rz_usize rz_roaring_memory_usage(const RZ_Roaring *r) {
+    rz_usize bytes = r->containers.capacity * sizeof(RZ_RoaringContainer);
+    for (rz_usize i = 0; i < r->containers.len; ++i) bytes += rz__roaring_data_bytes(r->containers.data[i].kind, r->containers.data[i].capacity);
+    return bytes;
+}
+
+RZ_DEF void rz_roaring_run_optimize(RZ_Roaring *r) {
+    RZ_Allocator a = r->containers.allocator;
+    rz_u64       words[RZ_ROARING_BITMAP_WORDS];
+    rz_arr_foreach(c, &r->containers) {
+        if (c->kind == RZ_ROARING_RUN) continue;
+        rz__roaring_container_to_words(c, words);
+
+        // a run start where the bit is set and the previous bit is clear.
+        rz_u32 nruns = 0;
+        rz_u64 carry = 0;
+        for (rz_u32 wi = 0; wi < RZ_ROARING_BITMAP_WORDS; ++wi) {
+            nruns += rz_popcount64(words[wi] & ~((words[wi] << 1u) | carry));
+            carry = words[wi] >> 63u;
+        }
+        if (rz__roaring_data_bytes(RZ_ROARING_RUN, nruns) >= rz__roaring_data_bytes(c->kind, c->card)) continue;
+
+        RZ_RoaringContainer res  = rz__roaring_container_new(a, c->key, RZ_ROARING_RUN, nruns);
+        rz_u16             *runs = res.data;
+        RZ_Bitset           bs   = {.words = words, .nbits = RZ__ROARING_CHUNK_BITS, .capacity = RZ_ROARING_BITMAP_WORDS};
+        for (rz_usize s = rz_bitset_next_set(&bs, 0); s != RZ_NOT_FOUND;) {
+            rz_usize e = s;
+            while ((e + 1) < RZ__ROARING_CHUNK_BITS && rz_bitset_test(&bs, e + 1)) e++;
+            runs[res.len * 2]       = (rz_u16)s;
+            runs[(res.len * 2) + 1] = (rz_u16)(e - s);
+            res.len++;
+            s = rz_bitset_next_set(&bs, e + 1);
+        }
+        res.card = c->card;
+        rz__roaring_container_free(a, c);
+        *c = res;
+    }
+}
+
+static RZ_RoaringContainer rz__roaring_container_op(RZ_Allocator a, const RZ_RoaringContainer *ca, const RZ_RoaringContainer *cb, RZ_BitsetOp op, rz_u64 *wa,
+                                                    rz_u64 *wb) {
+    // sparse fast paths: the result is never larger than the array operand.
+    if ((op == RZ_BITSET_OP_AND && (ca->kind == RZ_ROARING_ARRAY || cb->kind == RZ_ROARING_ARRAY)) || (op == RZ_BITSET_OP_ANDNOT && ca->kind == RZ_ROARING_ARRAY)) {
+        const RZ_RoaringContainer *arr   = (ca->kind == RZ_ROARING_ARRAY) ? ca : cb;
+        const RZ_RoaringContainer *other = (arr == ca) ? cb : ca;
+        bool                       keep  = (op == RZ_BITSET_OP_AND);
+        RZ_RoaringContainer        res   = rz__roaring_container_new(a, ca->key, RZ_ROARING_ARRAY, arr->card);
+        rz_u16                    *out   = res.data;
+        const rz_u16              *in    = rz__roaring_u16(arr);
+        if (other->kind == RZ_ROARING_ARRAY) {
+            // merge of two sorted arrays
+            const rz_u16 *oth = rz__roaring_u16(other);
+            rz_u32        j   = 0;
+            for (rz_u32 i = 0; i < arr->len; ++i) {
+                while (j < other->len && oth[j] < in[i]) j++;
+                if ((j < other->len && oth[j] == in[i]) == keep) out[res.len++] = in[i];
+            }
+        } else {
+            for (rz_u32 i = 0; i < arr->len; ++i) {
+                if (rz__roaring_container_contains(other, in[i]) == keep) out[res.len++] = in[i];
+            }
+        }
+        res.card = res.len;
+        if (res.card == 0) rz__roaring_container_free(a, &res);
+        return res;
+    }
+    if (op == RZ_BITSET_OP_OR && ca->kind == RZ_ROARING_ARRAY && cb->kind == RZ_ROARING_ARRAY && (ca->card + cb->card) <= RZ_ROARING_ARRAY_MAX) {
+        RZ_RoaringContainer res = rz__roaring_container_new(a, ca->key, RZ_ROARING_ARRAY, ca->card + cb->card);
+        rz_u16             *out = res.data;
+        const rz_u16       *x = rz__roaring_u16(ca), *y = rz__roaring_u16(cb);
+        rz_u32              i = 0, j = 0;
+        while (i < ca->len && j < cb->len) {
+            if (x[i] < y[j]) out[res.len++] = x[i++];
+            else if (y[j] < x[i]) out[res.len++] = y[j++];
+            else out[res.len++] = x[i++], j++;
+        }
+        while (i < ca->len) out[res.len++] = x[i++];
+        while (j < cb->len) out[res.len++] = y[j++];
+        res.card = res.len;
+        return res;
+    }
+
+    // dense path, expand both into words and use the bitset kernel.
+    rz__roaring_container_to_words(ca, wa);
+    rz__roaring_container_to_words(cb, wb);
+    rz__bitset_words_op(wa, wb, RZ_ROARING_BITMAP_WORDS, op);
+    return rz__roaring_container_from_words(a, ca->key, wa, (rz_u32)rz__bitset_words_count(wa, RZ_ROARING_BITMAP_WORDS));
+}
+
+RZ_DEF void rz_roaring_op(RZ_Roaring *dst, const RZ_Roaring *a, const RZ_Roaring *b, RZ_BitsetOp op) {
+    RZ_ASSERT(dst != NULL && a != NULL && b != NULL);
+    RZ_ASSERT(dst != a && dst != b, "rz_roaring_op: dst must not alias the operand");
+    if (!rz_is_allocator(dst->containers.allocator)) dst->containers.allocator = rz_std_allocator();
+    rz_roaring_clear(dst);
+
+    RZ_Allocator alc     = dst->containers.allocator;
+    bool         keep_a  = (op != RZ_BITSET_OP_AND);
+    bool         keep_b  = (op == RZ_BITSET_OP_OR || op == RZ_BITSET_OP_XOR);
+    rz_u64      *scratch = rz_raw_alloc(alc, 2 * RZ_ROARING_BITMAP_WORDS * sizeof(rz_u64));
+    RZ_ASSERT_ALLOCATOR_PTR(scratch);
+
+    rz_usize i = 0, j = 0;
+    while (i < a->containers.len || j < b->containers.len) {
+        const RZ_RoaringContainer *ca = (i < a->containers.len) ? &a->containers.data[i] : NULL;
+        const RZ_RoaringContainer *cb = (j < b->containers.len) ? &b->containers.data[j] : NULL;
+        if (cb == NULL || (ca != NULL && ca->key < cb->key)) {
+            if (keep_a) rz_arr_push(&dst->containers, rz__roaring_container_clone(alc, ca));
+            i++;
+        } else if (ca == NULL || cb->key < ca->key) {
+            if (keep_b) rz_arr_push(&dst->containers, rz__roaring_container_clone(alc, cb));
+            j++;
+        } else {
+            RZ_RoaringContainer res = rz__roaring_container_op(alc, ca, cb, op, scratch, scratch + RZ_ROARING_BITMAP_WORDS);
+            if (res.card > 0) rz_arr_push(&dst->containers, res);
+            i++;
+            j++;
+        }
+    }
+    rz_raw_dealloc(alc, scratch, 2 * RZ_ROARING_BITMAP_WORDS * sizeof(rz_u64));
+}
+
+// popcount of the bits in [start, end] (inclusive) of the 1024 words
+static rz_u32 rz__roaring_words_range_count(const rz_u64 *words, rz_u32 start, rz_u32 end) {
+    rz_u32 first = start >> 6u, last = end >> 6u;
+    rz_u64 first_mask = ~(rz_u64)0 << (start & 63u);
+    rz_u64 last_mask  = ~(rz_u64)0 >> (63u - (end & 63u));
+    if (first == last) return rz_popcount64(words[first] & first_mask & last_mask);
+
+    rz_u32 n = rz_popcount64(words[first] & first_mask) + rz_popcount64(words[last] & last_mask);
+    for (rz_u32 w = first + 1; w < last; ++w) n += rz_popcount64(words[w]);
+    return n;
+}
+
+// cardinality of `ca & cb` for any pair of container kinds, without building the result container.
+static rz_u32 rz__roaring_container_and_card(const RZ_RoaringContainer *ca, const RZ_RoaringContainer *cb) {
+    // order the pair as array < bitmap < run, so every kind pair is handled once.
+    if (ca->kind > cb->kind) {
+        const RZ_RoaringContainer *t = ca;
+        ca                           = cb;
+        cb                           = t;
+    }
+    rz_u32        card = 0;
+    const rz_u16 *x    = rz__roaring_u16(ca);
+    const rz_u16 *y    = rz__roaring_u16(cb);
+    switch (ca->kind) {
+    case RZ_ROARING_ARRAY:
+        if (cb->kind == RZ_ROARING_ARRAY) {
+            for (rz_u32 i = 0, j = 0; i < ca->len && j < cb->len;) {
+                card += (x[i] == y[j]);
+                rz_u16 xi = x[i], yj = y[j];
+                i += (xi <= yj);
+                j += (yj <= xi);
+            }
+        } else if (cb->kind == RZ_ROARING_BITMAP) {
+            const rz_u64 *words = rz__roaring_words(cb);
+            for (rz_u32 i = 0; i < ca->len; ++i) card += (words[x[i] >> 6u] >> (x[i] & 63u)) & 1u;
+        } else {
+            // both sorted, walk the runs along the array
+            for (rz_u32 i = 0, r = 0; i < ca->len && r < cb->len;) {
+                rz_u32 start = y[r * 2], end = start + y[(r * 2) + 1];
+                if (x[i] < start) i++;
+                else if (x[i] > end) r++;
+                else card++, i++;
+            }
+        }
+        break;
+    case RZ_ROARING_BITMAP:
+        if (cb->kind == RZ_ROARING_BITMAP) {
+            const rz_u64 *wa = rz__roaring_words(ca), *wb = rz__roaring_words(cb);
+            for (rz_u32 w = 0; w < RZ_ROARING_BITMAP_WORDS; ++w) card += rz_popcount64(wa[w] & wb[w]);
+        } else {
+            for (rz_u32 r = 0; r < cb->len; ++r) card += rz__roaring_words_range_count(rz__roaring_words(ca), y[r * 2], (rz_u32)y[r * 2] + y[(r * 2) + 1]);
+        }
+        break;
+    case RZ_ROARING_RUN:
+        // overlap of two sorted lists of intervals
+        for (rz_u32 i = 0, j = 0; i < ca->len && j < cb->len;) {
+            rz_u32 xs = x[i * 2], xe = xs + x[(i * 2) + 1];
+            rz_u32 ys = y[j * 2], ye = ys + y[(j * 2) + 1];
+            rz_u32 lo = RZ_MAX(xs, ys), hi = RZ_MIN(xe, ye);
+            if (lo <= hi) card += hi - lo + 1;
+            if (xe <= ye) i++;
+            else j++;
+        }
+        break;
+    default: RZ_UNREACHABLE("rz__roaring_container_and_card: RZ_RoaringKind");
+    }
+    return card;
+}
+
+RZ_DEF rz_u64 rz_roaring_and_cardinality(const RZ_Roaring *a, const RZ_Roaring *b) {
+    rz_u64   card = 0;
+    rz_usize i = 0, j = 0;
+    while (i < a->containers.len && j < b->containers.len) {
+        const RZ_RoaringContainer *ca = &a->containers.data[i];
+        const RZ_RoaringContainer *cb = &b->containers.data[j];
+        if (ca->key < cb->key) {
+            i++;
+        } else if (cb->key < ca->key) {
+            j++;
+        } else {
+            card += rz__roaring_container_and_card(ca, cb);
+            i++;
+            j++;
+        }
+    }
+    return card;
+}
+
+RZ_DEF bool rz_roaring_iter_next(RZ_RoaringIter *it, rz_u32 *value) {
+    while (it->container < it->r->containers.len) {
+        const RZ_RoaringContainer *c    = &it->r->containers.data[it->container];
+        rz_u32                     base = (rz_u32)c->key << 16u;
+        switch (c->kind) {
+        case RZ_ROARING_ARRAY:
+            if (it->pos < c->len) {
+                *value = base | rz__roaring_u16(c)[it->pos++];
+                return true;
+            }
+            break;
+        case RZ_ROARING_RUN:
+            // pos is the run index, word is the offset in the run.
+            if (it->pos < c->len) {
+                const rz_u16 *run = rz__roaring_u16(c) + (it->pos * 2);
+                *value            = base | (rz_u32)(run[0] + it->word);
+                if (it->word == run[1]) {
+                    it->pos++;
+                    it->word = 0;
+                } else {
+                    it->word++;
+                }
+                return true;
+            }
+            break;
+        case RZ_ROARING_BITMAP:
+            // pos is the next word index, word is the remaining bits of words[pos - 1].
+            for (;;) {
+                if (it->word != 0) {
+                    *value = base | (((it->pos - 1) * 64u) + rz_ctz64(it->word));
+                    it->word &= it->word - 1;
+                    return true;
+                }
+                if (it->pos >= RZ_ROARING_BITMAP_WORDS) break;
+                it->word = rz__roaring_words(c)[it->pos++];
+            }
+            break;
+        default: RZ_UNREACHABLE("rz_roaring_iter_next: RZ_RoaringKind");
+        }
+        it->container++;
+        it->pos  = 0;
+        it->word = 0;
+    }
+    return false;
+}
+
+#endif /* ifdef RZ_BITSET_IMPL */
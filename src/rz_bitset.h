@@ -0,0 +1,176 @@
+#pragma once
+#ifndef RZ_BITSET_H
+#    define RZ_BITSET_H
+#    include "rz_allocator.h"
+#    include "rz_collections.h"
+#    include "rz_common.h"
+
+/// Dense bitset and compressed (roaring) bitmap for large sets of integer ids.
+///  - RZ_Bitset : flat array of u64 words. O(1) test/set, set algebra a whole word (or vector) at a time.
+///  - RZ_Roaring: the u32 space is split into 16 bit chunks (high bits is the container key),
+///                each chunk is stored in the smallest container of:
+///                  array  - sorted u16, for sparse chunk (cardinality <= 4096)
+///                  bitmap - 1024 u64 words (8KiB), for dense chunk
+///                  run    - sorted [start, start + length] pairs, for long consecutive ranges
+///
+/// Example:
+///  RZ_Roaring a = {0}, b = {0}, res = {0};
+///  rz_roaring_init(&a, rz_std_allocator()); ...
+///  rz_roaring_add(&a, 42);
+///  rz_roaring_add_range(&b, 0, 100); // [0, 100)
+///  rz_roaring_and(&res, &a, &b);
+///  rz_roaring_foreach(id, &res) { printf("%u\n", id); }
+
+#    if defined(__cplusplus)
+extern "C" {
+#    endif
+
+typedef enum : rz_u8
+{
+    RZ_BITSET_OP_AND,
+    RZ_BITSET_OP_OR,
+    RZ_BITSET_OP_XOR,
+    RZ_BITSET_OP_ANDNOT,
+} RZ_BitsetOp;
+
+///////////////
+/// Bitset
+///
+typedef struct {
+    /// bits, bit `i` is `words[i / 64] >> (i % 64)`. bits after `nbits` is always 0.
+    rz_u64      *words;
+    /// the amount of bits
+    rz_usize     nbits;
+    /// capacity of `words`
+    rz_usize     capacity;
+    RZ_Allocator allocator;
+} RZ_Bitset;
+
+#    define RZ_BITSET_WORD_BITS      64u
+#    define rz_bitset_words_len(nbits) (((nbits) + (RZ_BITSET_WORD_BITS - 1)) / RZ_BITSET_WORD_BITS)
+
+// clang-format off
+///    bool rz_bitset_test(const RZ_Bitset *bs, rz_usize i);
+#    define rz_bitset_test(bs, i)    ((((bs)->words[(i) >> 6u] >> ((i) & 63u)) & 1u) != 0)
+///    void rz_bitset_set(RZ_Bitset *bs, rz_usize i);
+#    define rz_bitset_set(bs, i)     ((bs)->words[(i) >> 6u] |= ((rz_u64)1 << ((i) & 63u)))
+///    void rz_bitset_clear(RZ_Bitset *bs, rz_usize i);
+#    define rz_bitset_clear(bs, i)   ((bs)->words[(i) >> 6u] &= ~((rz_u64)1 << ((i) & 63u)))
+///    void rz_bitset_flip(RZ_Bitset *bs, rz_usize i);
+#    define rz_bitset_flip(bs, i)    ((bs)->words[(i) >> 6u] ^= ((rz_u64)1 << ((i) & 63u)))
+
+///  iterate index of set bits, in ascending order.
+///     rz_bitset_foreach(i, &bs) { printf("%zu\n", i); }
+#    define rz_bitset_foreach(i, bs) for (rz_usize i = rz_bitset_next_set(bs, 0); i != RZ_NOT_FOUND; i = rz_bitset_next_set(bs, i + 1))
+
+#    define rz_bitset_and(dst, src)     rz_bitset_op(dst, src, RZ_BITSET_OP_AND)
+#    define rz_bitset_or(dst, src)      rz_bitset_op(dst, src, RZ_BITSET_OP_OR)
+#    define rz_bitset_xor(dst, src)     rz_bitset_op(dst, src, RZ_BITSET_OP_XOR)
+#    define rz_bitset_andnot(dst, src)  rz_bitset_op(dst, src, RZ_BITSET_OP_ANDNOT)
+// clang-format on
+
+/// initialize bitset with `nbits` bits, all cleared. if allocator is not valid use rz_std_allocator()
+RZ_DEC void     rz_bitset_init(RZ_Bitset *bs, rz_usize nbits, RZ_Allocator allocator);
+RZ_DEC void     rz_bitset_free(RZ_Bitset *bs);
+/// resize to `nbits`, new bits is cleared.
+RZ_DEC void     rz_bitset_resize(RZ_Bitset *bs, rz_usize nbits);
+RZ_DEC void     rz_bitset_set_all(RZ_Bitset *bs);
+RZ_DEC void     rz_bitset_clear_all(RZ_Bitset *bs);
+/// set or clear all bits in [start, end)
+RZ_DEC void     rz_bitset_set_range(RZ_Bitset *bs, rz_usize start, rz_usize end, bool value);
+/// amount of set bits (popcount)
+RZ_DEC rz_usize rz_bitset_count(const RZ_Bitset *bs);
+/// amount of set bits in [0, i)
+RZ_DEC rz_usize rz_bitset_rank(const RZ_Bitset *bs, rz_usize i);
+/// index of the `k`-th set bit (0 based). return RZ_NOT_FOUND if count <= k.
+RZ_DEC rz_usize rz_bitset_select(const RZ_Bitset *bs, rz_usize k);
+/// index of the first set bit at or after `from`. return RZ_NOT_FOUND if there is none.
+RZ_DEC rz_usize rz_bitset_next_set(const RZ_Bitset *bs, rz_usize from);
+/// in place set algebra: `dst = dst <op> src`.
+/// for or/xor `dst` is grown to the size of `src`, for and the bits beyond `src` is cleared.
+RZ_DEC void     rz_bitset_op(RZ_Bitset *dst, const RZ_Bitset *src, RZ_BitsetOp op);
+/// popcount of `a & b` without materializing the intersection.
+RZ_DEC rz_usize rz_bitset_and_count(const RZ_Bitset *a, const RZ_Bitset *b);
+
+/// word kernels (internal use, shared with the roaring bitmap containers). `dst = dst <op> src`.
+RZ_DEC void     rz__bitset_words_op(rz_u64 *dst, const rz_u64 *src, rz_usize nwords, RZ_BitsetOp op);
+RZ_DEC rz_usize rz__bitset_words_count(const rz_u64 *words, rz_usize nwords);
+
+///////////////
+/// Roaring
+///
+typedef enum : rz_u8
+{
+    RZ_ROARING_ARRAY,
+    RZ_ROARING_BITMAP,
+    RZ_ROARING_RUN,
+} RZ_RoaringKind;
+
+#    define RZ_ROARING_ARRAY_MAX      4096u
+#    define RZ_ROARING_BITMAP_WORDS   1024u
+
+typedef struct {
+    /// high 16 bits of the values in the container
+    rz_u16         key;
+    RZ_RoaringKind kind;
+    /// the amount of values in the container (1 ... 65536)
+    rz_u32         card;
+    /// array: amount of u16 values, run: amount of runs, bitmap: unused
+    rz_u32         len;
+    /// capacity of `data`: u16 for array, pair of u16 for run, 1024 u64 for bitmap
+    rz_u32         capacity;
+    /// array: rz_u16[], run: {start, length} rz_u16[][2], bitmap: rz_u64[1024]
+    void          *data;
+} RZ_RoaringContainer;
+
+typedef struct {
+    /// sorted by `key`
+    RZ_Array(RZ_RoaringContainer) containers;
+} RZ_Roaring;
+
+typedef struct {
+    const RZ_Roaring *r;
+    rz_usize          container;
+    rz_u32            pos;
+    rz_u64            word;
+} RZ_RoaringIter;
+
+RZ_DEC void     rz_roaring_init(RZ_Roaring *r, RZ_Allocator allocator);
+RZ_DEC void     rz_roaring_free(RZ_Roaring *r);
+RZ_DEC void     rz_roaring_clear(RZ_Roaring *r);
+/// return true if `value` is newly added
+RZ_DEC bool     rz_roaring_add(RZ_Roaring *r, rz_u32 value);
+/// add all the values in [start, end). full chunks is stored as run container
+RZ_DEC void     rz_roaring_add_range(RZ_Roaring *r, rz_u64 start, rz_u64 end);
+/// return true if `value` was in the bitmap
+RZ_DEC bool     rz_roaring_remove(RZ_Roaring *r, rz_u32 value);
+RZ_DEC bool     rz_roaring_contains(const RZ_Roaring *r, rz_u32 value);
+RZ_DEC rz_u64   rz_roaring_cardinality(const RZ_Roaring *r);
+/// convert containers to run containers when it is smaller.
+RZ_DEC void     rz_roaring_run_optimize(RZ_Roaring *r);
+/// approximate memory used by the containers data in bytes.
+RZ_DEC rz_usize rz_roaring_memory_usage(const RZ_Roaring *r);
+
+/// set algebra, `dst = a <op> b`. dst is cleared first and use its own allocator
+/// (rz_std_allocator() if not initialized). `dst` must not alias `a` or `b`.
+RZ_DEC void     rz_roaring_op(RZ_Roaring *dst, const RZ_Roaring *a, const RZ_Roaring *b, RZ_BitsetOp op);
+/// cardinality of `a & b` without materializing the intersection.
+RZ_DEC rz_u64   rz_roaring_and_cardinality(const RZ_Roaring *a, const RZ_Roaring *b);
+
+#    define rz_roaring_and(dst, a, b)    rz_roaring_op(dst, a, b, RZ_BITSET_OP_AND)
+#    define rz_roaring_or(dst, a, b)     rz_roaring_op(dst, a, b, RZ_BITSET_OP_OR)
+#    define rz_roaring_xor(dst, a, b)    rz_roaring_op(dst, a, b, RZ_BITSET_OP_XOR)
+#    define rz_roaring_andnot(dst, a, b) rz_roaring_op(dst, a, b, RZ_BITSET_OP_ANDNOT)
+
+/// iterate values in ascending order.
+///  RZ_RoaringIter it = rz_roaring_iter(&r);
+///  rz_u32 v;
+///  while (rz_roaring_iter_next(&it, &v)) { ... }
+#    define rz_roaring_iter(_r)          ((RZ_RoaringIter){.r = (_r)})
+RZ_DEC bool rz_roaring_iter_next(RZ_RoaringIter *it, rz_u32 *value);
+#    define rz_roaring_foreach(v, _r)    for (rz_u32 v = 0, *v##_once = &v; v##_once; v##_once = NULL) for (RZ_RoaringIter v##_it = rz_roaring_iter(_r); rz_roaring_iter_next(&v##_it, &v);)
+
+#    if defined(__cplusplus)
+}
+#    endif
+#endif /* end of include guard: RZ_BITSET_H */
@@ -0,0 +1,275 @@
+#include "rz_cache.h"
+
+#ifdef RZ_CACHE_IMPL
+
+#    define RZ__LRU_NIL           RZ_U32_MAX
+#    define RZ__LRU_INDEX_INIT    16U
+
+struct RZ__LruNode {
+    rz_usize hash;
+    rz_usize cost;
+    /// recency list, `next` is also the link of the free list
+    rz_u32   prev, next;
+    bool     alive;
+    /// second chance bit (RZ_CACHE_CLOCK)
+    bool     referenced;
+};
+
+#    define rz__lru_elem(c, i)    ((rz_u8 *)(c)->data + ((rz_usize)(i) * (c)->state.opt.elemsize))
+#    define rz__lru_hash(c, key)  (c)->state.opt.hashcmp(RZ_HM_HASHCMP_HASH, (key), NULL, (c)->state.opt.keysize, (c)->state.seed)
+#    define rz__lru_keyeq(c, key, i) \
+        (c)->state.opt.hashcmp(RZ_HM_HASHCMP_CMP, (key), rz__lru_elem(c, i), (c)->state.opt.keysize, (c)->state.seed)
+
+RZ_DEF void rz__lru_init(RZ_LruCacheOpaque *c, RZ__LruInitOpt opt) {
+    RZ_ASSERT_NOT_NULL(c);
+    RZ_ASSERT(opt.elemsize > 0 && opt.keysize > 0, "rz_lru_init: invalid entry size");
+    if (!rz_is_allocator(opt.allocator)) opt.allocator = rz_std_allocator();
+    if (!opt.hashcmp) opt.hashcmp = rz_hm_hasheq_bytes;
+    *c = (RZ_LruCacheOpaque){
+        .__temp = -1,
+        .state  = {.head = RZ__LRU_NIL, .tail = RZ__LRU_NIL, .free_head = RZ__LRU_NIL, .opt = opt},
+    };
+}
+
+/////////////// recency list
+static inline void rz__lru_unlink(RZ_LruCacheOpaque *c, rz_u32 i) {
+    struct RZ__LruNode *nodes = c->state.nodes;
+    if (nodes[i].prev != RZ__LRU_NIL) nodes[nodes[i].prev].next = nodes[i].next;
+    else c->state.head = nodes[i].next;
+    if (nodes[i].next != RZ__LRU_NIL) nodes[nodes[i].next].prev = nodes[i].prev;
+    else c->state.tail = nodes[i].prev;
+}
+
+static inline void rz__lru_push_front(RZ_LruCacheOpaque *c, rz_u32 i) {
+    struct RZ__LruNode *nodes = c->state.nodes;
+    nodes[i].prev             = RZ__LRU_NIL;
+    nodes[i].next             = c->state.head;
+    if (c->state.head != RZ__LRU_NIL) nodes[c->state.head].prev = i;
+    else c->state.tail = i;
+    c->state.head = i;
+}
+
+/////////////// index (linear probing)
+// return the slot of the key, or the empty slot where it should be inserted.
+static rz_usize rz__lru_probe(const RZ_LruCacheOpaque *c, const void *key, rz_usize hash) {
+    rz_usize mask = c->state.index_capacity - 1;
+    for (rz_usize j = hash & mask;; j = (j + 1) & mask) {
+        rz_u32 n = c->state.index[j];
+        if (n == 0) return j;
+        if (c->state.nodes[n - 1].hash == hash && rz__lru_keyeq(c, key, n - 1)) return j;
+    }
+}
+
+static void rz__lru_index_grow(RZ_LruCacheOpaque *c) {
+    rz_u32  *old_index    = c->state.index;
+    rz_usize old_capacity = c->state.index_capacity;
+    rz_usize new_capacity = old_capacity ? old_capacity * 2 : RZ__LRU_INDEX_INIT;
+
+    c->state.index = rz_raw_calloc(c->state.opt.allocator, new_capacity, sizeof(rz_u32));
+    RZ_ASSERT_ALLOCATOR_PTR(c->state.index);
+    c->state.index_capacity = new_capacity;
+    for (rz_usize j = 0; j < old_capacity; ++j) {
+        if (old_index[j] == 0) continue;
+        rz_usize k = c->state.nodes[old_index[j] - 1].hash & (new_capacity - 1);
+        while (c->state.index[k] != 0) k = (k + 1) & (new_capacity - 1);
+        c->state.index[k] = old_index[j];
+    }
+    if (old_index != NULL) rz_free(c->state.opt.allocator, old_index, old_capacity);
+}
+
+// backward shift deletion, keep the probe sequences valid without tombstones.
+static void rz__lru_index_erase(RZ_LruCacheOpaque *c, rz_u32 node) {
+    rz_u32  *index = c->state.index;
+    rz_usize mask  = c->state.index_capacity - 1;
+    rz_usize i     = c->state.nodes[node].hash & mask;
+    while (index[i] != node + 1) i = (i + 1) & mask;
+
+    for (rz_usize j = (i + 1) & mask; index[j] != 0; j = (j + 1) & mask) {
+        rz_usize home = c->state.nodes[index[j] - 1].hash & mask;
+        // move `j` into the hole if its home is not in the cyclic range (i, j]
+        bool in_range = (i <= j) ? ((i < home) && (home <= j)) : ((i < home) || (home <= j));
+        if (in_range) continue;
+        index[i] = index[j];
+        i        = j;
+    }
+    index[i] = 0;
+}
+
+/////////////// entries
+static void rz__lru_release(RZ_LruCacheOpaque *c, rz_u32 i) {
+    if (c->state.opt.on_evict) {
+        rz_u8 *elem = rz__lru_elem(c, i);
+        c->state.opt.on_evict(elem, elem + c->state.opt.valueoffs, c->state.opt.user);
+    }
+}
+
+static void rz__lru_remove_node(RZ_LruCacheOpaque *c, rz_u32 i) {
+    struct RZ__LruNode *node = &c->state.nodes[i];
+    rz__lru_release(c, i);
+    rz__lru_index_erase(c, i);
+    if (c->state.opt.policy == RZ_CACHE_LRU) rz__lru_unlink(c, i);
+    c->len--;
+    c->bytes          -= node->cost;
+    node->alive        = false;
+    node->next         = c->state.free_head;
+    c->state.free_head = i;
+}
+
+static rz_u32 rz__lru_victim(RZ_LruCacheOpaque *c, rz_u32 keep) {
+    switch (c->state.opt.policy) {
+    case RZ_CACHE_LRU: {
+        rz_u32 i = c->state.tail;
+        return (i == keep) ? c->state.nodes[i].prev : i;
+    }
+    case RZ_CACHE_CLOCK: {
+        // every entry is visited at most twice, the first visit clear the referenced bit.
+        for (rz_usize step = 0; step < (rz_usize)c->state.nodes_len * 2; ++step) {
+            rz_u32 i      = c->state.hand;
+            c->state.hand = (c->state.hand + 1 == c->state.nodes_len) ? 0 : c->state.hand + 1;
+
+            struct RZ__LruNode *node = &c->state.nodes[i];
+            if (!node->alive || i == keep) continue;
+            if (node->referenced) {
+                node->referenced = false;
+                continue;
+            }
+            return i;
+        }
+        return RZ__LRU_NIL;
+    }
+    default:
+        RZ_UNREACHABLE("rz__lru_victim: RZ_CachePolicy");
+    }
+}
+
+#    define rz__lru_over_budget(c)                                                           \
+        (((c)->state.opt.max_entries && ((c)->len > (c)->state.opt.max_entries))           \
+         || ((c)->state.opt.max_bytes && ((c)->bytes > (c)->state.opt.max_bytes)))
+
+RZ_DEF void rz__lru_evict(RZ_LruCacheOpaque *c, rz_usize keep) {
+    RZ_ASSERT_NOT_NULL(c);
+    while (c->len > 0 && rz__lru_over_budget(c)) {
+        rz_u32 victim = rz__lru_victim(c, (rz_u32)keep);
+        // only `keep` is left and it is still bigger than the budget
+        if (victim == RZ__LRU_NIL) victim = (rz_u32)keep;
+        rz__lru_remove_node(c, victim);
+        c->evictions++;
+    }
+}
+
+static inline void rz__lru_touch(RZ_LruCacheOpaque *c, rz_u32 i) {
+    if (c->state.opt.policy == RZ_CACHE_CLOCK) {
+        c->state.nodes[i].referenced = true;
+    } else if (c->state.head != i) {
+        rz__lru_unlink(c, i);
+        rz__lru_push_front(c, i);
+    }
+}
+
+RZ_DEF rz_ptrdiff rz__lru_get(RZ_LruCacheOpaque *c, const void *key, bool touch) {
+    RZ_ASSERT_NOT_NULL(c);
+    rz_u32 n = 0;
+    if (c->len > 0) {
+        rz_usize hash = rz__lru_hash(c, key);
+        n             = c->state.index[rz__lru_probe(c, key, hash)];
+    }
+    if (n == 0) {
+        if (touch) c->misses++;
+        return -1;
+    }
+
+    if (touch) {
+        c->hits++;
+        rz__lru_touch(c, n - 1);
+    }
+    return (rz_ptrdiff)(n - 1);
+}
+
+RZ_DEF rz_usize rz__lru_put(RZ_LruCacheOpaque *c, const void *key, rz_usize cost) {
+    RZ_ASSERT_NOT_NULL(c);
+    RZ_ASSERT(c->state.opt.elemsize > 0, "rz_lru_put: the cache is not initialized (rz_lru_init)");
+
+    rz_usize hash = rz__lru_hash(c, key);
+    if (c->state.index_capacity > 0) {
+        rz_u32 n = c->state.index[rz__lru_probe(c, key, hash)];
+        if (n != 0) {
+            rz_u32 i = n - 1;
+            // the old key and value is released, the new (equal) key is stored with the new value
+            rz__lru_release(c, i);
+            memcpy(rz__lru_elem(c, i), key, c->state.opt.keysize);
+            c->bytes               += cost - c->state.nodes[i].cost;
+            c->state.nodes[i].cost  = cost;
+            rz__lru_touch(c, i);
+            return i;
+        }
+    }
+
+    // evict before insert, so the storage never grow past `max_entries`
+    if (c->state.opt.max_entries && c->len >= c->state.opt.max_entries) {
+        rz__lru_remove_node(c, rz__lru_victim(c, RZ__LRU_NIL));
+        c->evictions++;
+    }
+    if (((c->len + 1) * 4) > (c->state.index_capacity * 3)) rz__lru_index_grow(c);
+
+    rz_u32 i = c->state.free_head;
+    if (i != RZ__LRU_NIL) {
+        c->state.free_head = c->state.nodes[i].next;
+    } else {
+        RZ_ASSERT(c->state.nodes_len < RZ__LRU_NIL, "rz_lru_put: too many entries");
+        if (c->state.nodes_len == c->state.capacity) {
+            RZ_Allocator a            = c->state.opt.allocator;
+            rz_usize     old_capacity = c->state.capacity;
+            rz_usize     new_capacity = old_capacity ? old_capacity * 2 : RZ_ARR_INIT_CAPACITY;
+            if (c->state.opt.max_entries) new_capacity = RZ_MIN(new_capacity, c->state.opt.max_entries);
+            c->data        = rz_raw_remap(a, c->data, old_capacity * c->state.opt.elemsize, new_capacity * c->state.opt.elemsize);
+            c->state.nodes = rz_raw_remap(a, c->state.nodes, old_capacity * sizeof(struct RZ__LruNode), new_capacity * sizeof(struct RZ__LruNode));
+            RZ_ASSERT_ALLOCATOR_PTR(c->data);
+            RZ_ASSERT_ALLOCATOR_PTR(c->state.nodes);
+            c->state.capacity = new_capacity;
+        }
+        i = c->state.nodes_len++;
+    }
+
+    memcpy(rz__lru_elem(c, i), key, c->state.opt.keysize);
+    c->state.nodes[i] = (struct RZ__LruNode){.hash = hash, .cost = cost, .prev = RZ__LRU_NIL, .next = RZ__LRU_NIL, .alive = true};
+    if (c->state.opt.policy == RZ_CACHE_LRU) rz__lru_push_front(c, i);
+    c->state.index[rz__lru_probe(c, key, hash)] = i + 1;
+    c->len++;
+    c->bytes += cost;
+    return i;
+}
+
+RZ_DEF bool rz__lru_remove(RZ_LruCacheOpaque *c, const void *key) {
+    rz_ptrdiff i = rz__lru_get(c, key, false);
+    if (i < 0) return false;
+    rz__lru_remove_node(c, (rz_u32)i);
+    return true;
+}
+
+RZ_DEF void rz__lru_clear(RZ_LruCacheOpaque *c) {
+    RZ_ASSERT_NOT_NULL(c);
+    for (rz_u32 i = 0; i < c->state.nodes_len; ++i) {
+        if (c->state.nodes[i].alive) rz__lru_release(c, i);
+    }
+    if (c->state.index != NULL) memset(c->state.index, 0, c->state.index_capacity * sizeof(rz_u32));
+    c->len             = 0;
+    c->bytes           = 0;
+    c->state.nodes_len = 0;
+    c->state.hand      = 0;
+    c->state.head      = RZ__LRU_NIL;
+    c->state.tail      = RZ__LRU_NIL;
+    c->state.free_head = RZ__LRU_NIL;
+}
+
+RZ_DEF void rz__lru_free(RZ_LruCacheOpaque *c) {
+    RZ_ASSERT_NOT_NULL(c);
+    if (c->state.opt.elemsize == 0) return; // never initialized
+    rz__lru_clear(c);
+    RZ_Allocator a = c->state.opt.allocator;
+    if (c->data != NULL) rz_raw_dealloc(a, c->data, c->state.capacity * c->state.opt.elemsize);
+    if (c->state.nodes != NULL) rz_free(a, c->state.nodes, c->state.capacity);
+    if (c->state.index != NULL) rz_free(a, c->state.index, c->state.index_capacity);
+    rz__lru_init(c, c->state.opt);
+}
+
+#endif /* ifdef RZ_CACHE_IMPL */
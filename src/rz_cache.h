@@ -0,0 +1,153 @@
+#pragma once
+#ifndef RZ_CACHE_H
+#    define RZ_CACHE_H
+#    include "rz_allocator.h"
+#    include "rz_collections.h"
+#    include "rz_common.h"
+
+/// Bounded key/value cache with O(1) get, put and evict.
+/// the budget is the amount of entries (`.max_entries`) and/or the sum of the `cost` reported
+/// by rz_lru_put_cost (`.max_bytes`, e.g. the size of the cached file content).
+/// when the budget is exceeded the victim is selected by the policy:
+///
+///  - RZ_CACHE_LRU  : intrusive doubly linked recency list, every hit move the entry to the front,
+///                    the victim is the least recently used entry.
+///  - RZ_CACHE_CLOCK: second chance, a hit only set the `referenced` bit (no list writes),
+///                    the clock hand skip (and clear) referenced entries. better for read heavy use.
+///
+/// the entries `{key, value}` is stored in `data` (like RZ_Hm), indexed by open addressing table
+/// of the key hash (RZ_HmHashCmpFn, rz_hm_hasheq_bytes by default).
+/// `on_evict` is called for every entry that leave the cache (evicted, replaced by put, removed, clear, free),
+/// so it can release the resources of the key and the value. put of the existing key release the old key and
+/// value, and store the new key (it own its resources from then on).
+///
+/// Example:
+///  RZ_LruCache(rz_u64, RZ_Str) files = {0};
+///  rz_lru_init(&files, .max_bytes = 64 << 20, .on_evict = release_file);
+///  RZ_Str *content = rz_lru_get(&files, inode);
+///  if (content == NULL) {
+///      RZ_Str s = load_file(inode);
+///      rz_lru_put_cost(&files, inode, s, s.len);
+///  }
+///  rz_lru_free(&files);
+///
+/// NOTE: the pointer returned by rz_lru_get is valid until the next put/remove.
+
+#    if defined(__cplusplus)
+extern "C" {
+#    endif
+
+typedef enum : rz_u8
+{
+    RZ_CACHE_LRU = 0,
+    RZ_CACHE_CLOCK,
+} RZ_CachePolicy;
+
+/// called with pointer to the key and value of the entry that leave the cache
+typedef void (*RZ_CacheEvictFn)(void *key, void *value, void *user);
+
+typedef struct {
+    rz_usize        elemsize;
+    rz_usize        keysize;
+    rz_usize        valueoffs;
+    /// budget in entries, 0 is unlimited
+    rz_usize        max_entries;
+    /// budget in the sum of `cost`, 0 is unlimited
+    rz_usize        max_bytes;
+    RZ_CachePolicy  policy;
+    /// default: rz_hm_hasheq_bytes
+    RZ_HmHashCmpFn  hashcmp;
+    RZ_CacheEvictFn on_evict;
+    void           *user;
+    /// default: rz_std_allocator()
+    RZ_Allocator    allocator;
+} RZ__LruInitOpt;
+
+struct RZ__LruNode;
+typedef struct {
+    struct RZ__LruNode *nodes;
+    /// open addressing table, node index + 1, 0 is empty slot
+    rz_u32             *index;
+    rz_usize            index_capacity;
+    /// capacity of `data` and `nodes`
+    rz_usize            capacity;
+    /// amount of nodes used (alive and free)
+    rz_u32              nodes_len;
+    /// recency list, head is the most recently used (RZ_CACHE_LRU)
+    rz_u32              head, tail;
+    rz_u32              free_head;
+    /// clock hand (RZ_CACHE_CLOCK)
+    rz_u32              hand;
+    rz_usize            seed;
+    RZ__LruInitOpt      opt;
+} RZ__LruState;
+
+#    define RZ__LRU_STRUCT_MEMBERS(T)                                         \
+        /* data - the entries, not packed (removed entry leave a hole) */   \
+        T           *data;                                                  \
+        /* len - the amount of entries in the cache */                      \
+        rz_usize     len;                                                   \
+        /* bytes - the sum of the `cost` of the entries */                  \
+        rz_usize     bytes;                                                 \
+        /* statistics */                                                    \
+        rz_usize     hits, misses, evictions;                               \
+        rz_ptrdiff   __temp;                                                \
+        RZ__LruState state
+
+// clang-format off
+#    define RZ_LruCache(Key, Value)            \
+        struct {                               \
+            RZ__LRU_STRUCT_MEMBERS(struct {    \
+                Key   key;                     \
+                Value value;                   \
+            });                                \
+        }
+
+typedef struct { RZ__LRU_STRUCT_MEMBERS(void); } RZ_LruCacheOpaque;
+
+#    define rz__lru_key(c, _key)              RZ_ADDRESSOF((c)->data->key, _key)
+
+///    void rz_lru_init(RZ_LruCache(K, V) *c, RZ__LruInitOpt...);
+#    define rz_lru_init(c, ...)               rz__lru_init((RZ_LruCacheOpaque *)(c), (RZ__LruInitOpt){ .elemsize = sizeof(*(c)->data), .keysize = sizeof((c)->data->key), .valueoffs = RZ_OFFSETOF(RZ_TYPEOF(*(c)->data), value) __VA_OPT__(, ) __VA_ARGS__ })
+#    define rz_lru_free(c)                    rz__lru_free((RZ_LruCacheOpaque *)(c))
+#    define rz_lru_clear(c)                   rz__lru_clear((RZ_LruCacheOpaque *)(c))
+
+///  get pointer to the value (and mark the entry as recently used), NULL if the key is not cached.
+///  rz_lru_peek does not touch the recency or the statistics.
+///       V* rz_lru_get(RZ_LruCache(K, V) *c, K key);
+///       V* rz_lru_peek(RZ_LruCache(K, V) *c, K key);
+#    define rz_lru_get(c, _key)               ((c)->__temp = rz__lru_get((RZ_LruCacheOpaque *)(c), rz__lru_key(c, _key), true), ((c)->__temp < 0) ? NULL : &(c)->data[(c)->__temp].value)
+#    define rz_lru_peek(c, _key)              ((c)->__temp = rz__lru_get((RZ_LruCacheOpaque *)(c), rz__lru_key(c, _key), false), ((c)->__temp < 0) ? NULL : &(c)->data[(c)->__temp].value)
+#    define rz_lru_contains(c, _key)          (rz__lru_get((RZ_LruCacheOpaque *)(c), rz__lru_key(c, _key), false) >= 0)
+
+///  insert or replace the entry, then evict entries until the cache is within the budget.
+///  an entry that is bigger than `.max_bytes` is evicted immediately.
+///    void rz_lru_put(RZ_LruCache(K, V) *c, K key, V value);
+///    void rz_lru_put_cost(RZ_LruCache(K, V) *c, K key, V value, rz_usize cost);
+#    define rz_lru_put(c, _key, _value)       rz_lru_put_cost(c, _key, _value, 0)
+#    define rz_lru_put_cost(c, _key, _value, cost)                                                  \
+        do {                                                                                        \
+            (c)->__temp                    = rz__lru_put((RZ_LruCacheOpaque *)(c), rz__lru_key(c, _key), (cost)); \
+            (c)->data[(c)->__temp].value   = (_value);                                              \
+            rz__lru_evict((RZ_LruCacheOpaque *)(c), (rz_usize)(c)->__temp);                         \
+        } while (0)
+
+///  remove the entry (`on_evict` is called), return false if the key is not cached.
+///    bool rz_lru_remove(RZ_LruCache(K, V) *c, K key);
+#    define rz_lru_remove(c, _key)            rz__lru_remove((RZ_LruCacheOpaque *)(c), rz__lru_key(c, _key))
+///  hits / (hits + misses)
+#    define rz_lru_hit_rate(c)                (((c)->hits + (c)->misses) ? (rz_f64)(c)->hits / (rz_f64)((c)->hits + (c)->misses) : 0.0)
+// clang-format on
+
+RZ_DEC void       rz__lru_init(RZ_LruCacheOpaque *c, RZ__LruInitOpt opt);
+RZ_DEC void       rz__lru_free(RZ_LruCacheOpaque *c);
+RZ_DEC void       rz__lru_clear(RZ_LruCacheOpaque *c);
+RZ_DEC rz_ptrdiff rz__lru_get(RZ_LruCacheOpaque *c, const void *key, bool touch);
+RZ_DEC rz_usize   rz__lru_put(RZ_LruCacheOpaque *c, const void *key, rz_usize cost);
+RZ_DEC void       rz__lru_evict(RZ_LruCacheOpaque *c, rz_usize keep);
+RZ_DEC bool       rz__lru_remove(RZ_LruCacheOpaque *c, const void *key);
+
+#    if defined(__cplusplus)
+}
+#    endif
+#endif /* end of include guard: RZ_CACHE_H */
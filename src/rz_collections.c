@@ -11,7 +11,8 @@ RZ_DEF void rz__arr_grow_impl(void **data, rz_usize *capacity, rz_usize elemsize
     rz_usize old_cap = *capacity;
     if (*capacity == 0) *capacity = RZ_ARR_INIT_CAPACITY;
 
-    while (new_capacity > *capacity) *capacity += (*capacity >> 1u);
+    // the capacity 1 does not grow by the half
+    while (new_capacity > *capacity) *capacity = RZ_MAX(*capacity + (*capacity >> 1u), *capacity + 1);
 
     *data = rz_raw_remap(allocator, *data, old_cap * elemsize, *capacity * elemsize);
     RZ_ASSERT_ALLOCATOR_PTR(*data);
@@ -36,9 +37,157 @@ RZ_DEF void *rz__arr_remove(void *data, rz_usize *len, rz_usize type_size, rz_us
     return last;
 }
 
+/// SIMD helpers for the sized find kernels.
+/// `rz__arr_vec_mask(rz__arr_vec_eq_W(..))` return a mask with one bit per byte, where all the bytes
+/// of the matching lane is set. so the lane index is `ctz(mask) / sizeof(T)`.
+#    if RZ_TARGET_SIMD_AVX2
+#        define RZ__ARR_SIMD             1
+#        define RZ__ARR_VEC_BYTES        32u
+typedef __m256i RZ__ArrVec;
+#        define rz__arr_vec_load(p)      _mm256_loadu_si256((const __m256i *)(p))
+#        define rz__arr_vec_mask(v)      ((rz_u32)_mm256_movemask_epi8(v))
+#        define rz__arr_vec_splat_8(v)   _mm256_set1_epi8((char)(v))
+#        define rz__arr_vec_splat_16(v)  _mm256_set1_epi16((short)(v))
+#        define rz__arr_vec_splat_32(v)  _mm256_set1_epi32((int)(v))
+#        define rz__arr_vec_splat_64(v)  _mm256_set1_epi64x((long long)(v))
+#        define rz__arr_vec_eq_8(a, b)   _mm256_cmpeq_epi8(a, b)
+#        define rz__arr_vec_eq_16(a, b)  _mm256_cmpeq_epi16(a, b)
+#        define rz__arr_vec_eq_32(a, b)  _mm256_cmpeq_epi32(a, b)
+#        define rz__arr_vec_eq_64(a, b)  _mm256_cmpeq_epi64(a, b)
+#        define rz__arr_vec_zero()       _mm256_setzero_si256()
+#        define rz__arr_vec_sub_8(a, b)  _mm256_sub_epi8(a, b)
+#        define rz__arr_vec_add_64(a, b) _mm256_add_epi64(a, b)
+#        define rz__arr_vec_sad(v)       _mm256_sad_epu8(v, _mm256_setzero_si256())
+#        define rz__arr_vec_hsum_64(v)   rz__arr_sse2_hsum_64(_mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)))
+#    elif RZ_TARGET_SIMD_SSE2
+#        define RZ__ARR_SIMD             1
+#        define RZ__ARR_VEC_BYTES        16u
+typedef __m128i RZ__ArrVec;
+#        define rz__arr_vec_load(p)      _mm_loadu_si128((const __m128i *)(p))
+#        define rz__arr_vec_mask(v)      ((rz_u32)_mm_movemask_epi8(v))
+#        define rz__arr_vec_splat_8(v)   _mm_set1_epi8((char)(v))
+#        define rz__arr_vec_splat_16(v)  _mm_set1_epi16((short)(v))
+#        define rz__arr_vec_splat_32(v)  _mm_set1_epi32((int)(v))
+#        define rz__arr_vec_splat_64(v)  _mm_set1_epi64x((long long)(v))
+#        define rz__arr_vec_eq_8(a, b)   _mm_cmpeq_epi8(a, b)
+#        define rz__arr_vec_eq_16(a, b)  _mm_cmpeq_epi16(a, b)
+#        define rz__arr_vec_eq_32(a, b)  _mm_cmpeq_epi32(a, b)
+#        define rz__arr_vec_eq_64(a, b)  rz__arr_sse2_cmpeq_epi64(a, b)
+#        define rz__arr_vec_zero()       _mm_setzero_si128()
+#        define rz__arr_vec_sub_8(a, b)  _mm_sub_epi8(a, b)
+#        define rz__arr_vec_add_64(a, b) _mm_add_epi64(a, b)
+#        define rz__arr_vec_sad(v)       _mm_sad_epu8(v, _mm_setzero_si128())
+#        define rz__arr_vec_hsum_64(v)   rz__arr_sse2_hsum_64(v)
+// SSE2 has no 64 bit compare. the lane is equal if both of its 32 bit halves are equal.
+static inline __m128i rz__arr_sse2_cmpeq_epi64(__m128i a, __m128i b) {
+    __m128i eq = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+#    else
+#        define RZ__ARR_SIMD 0
+#    endif
+
+#    if RZ__ARR_SIMD
+// the sum of the 2 u64 lanes (the store, _mm_cvtsi128_si64 is x86_64 only)
+static inline rz_u64 rz__arr_sse2_hsum_64(__m128i v) {
+    rz_u64 lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, v);
+    return lanes[0] + lanes[1];
+}
+#        define RZ__ARR_SIMD_FIND(W, T)                                                                     \
+            RZ__ArrVec     v     = rz__arr_vec_splat_##W(needle);                                           \
+            const rz_usize lanes = RZ__ARR_VEC_BYTES / sizeof(T);                                           \
+            for (; (i + lanes) <= len; i += lanes) {                                                        \
+                rz_u32 m = rz__arr_vec_mask(rz__arr_vec_eq_##W(rz__arr_vec_load(p + i * sizeof(T)), v));   \
+                if (m) return i + (rz_ctz32(m) / sizeof(T));                                                \
+            }
+#        define RZ__ARR_SIMD_RFIND(W, T)                                                                    \
+            RZ__ArrVec     v     = rz__arr_vec_splat_##W(needle);                                           \
+            const rz_usize lanes = RZ__ARR_VEC_BYTES / sizeof(T);                                           \
+            while (i >= lanes) {                                                                            \
+                i -= lanes;                                                                                 \
+                rz_u32 m = rz__arr_vec_mask(rz__arr_vec_eq_##W(rz__arr_vec_load(p + i * sizeof(T)), v));   \
+                if (m) return i + ((31u - rz_clz32(m)) / sizeof(T));                                        \
+            }
+// the matching lane is all ones, subtracting it count 1 in every byte of the lane (up to 255 vectors), the
+// byte counts is summed into the 64 bit lanes with SAD. no popcount, it is the libgcc call without -mpopcnt.
+#        define RZ__ARR_SIMD_COUNT(W, T)                                                                    \
+            RZ__ArrVec     v     = rz__arr_vec_splat_##W(needle);                                           \
+            RZ__ArrVec     total = rz__arr_vec_zero();                                                      \
+            const rz_usize lanes = RZ__ARR_VEC_BYTES / sizeof(T);                                           \
+            while ((i + lanes) <= len) {                                                                    \
+                rz_usize   end   = i + (RZ_MIN((len - i) / lanes, 255u) * lanes);                           \
+                RZ__ArrVec bytes = rz__arr_vec_zero();                                                      \
+                for (; i < end; i += lanes) {                                                               \
+                    bytes = rz__arr_vec_sub_8(bytes, rz__arr_vec_eq_##W(rz__arr_vec_load(p + i * sizeof(T)), v)); \
+                }                                                                                           \
+                total = rz__arr_vec_add_64(total, rz__arr_vec_sad(bytes));                                  \
+            }                                                                                               \
+            count = rz__arr_vec_hsum_64(total) / sizeof(T);
+#    else
+#        define RZ__ARR_SIMD_FIND(W, T)
+#        define RZ__ARR_SIMD_RFIND(W, T)
+#        define RZ__ARR_SIMD_COUNT(W, T)
+#    endif
+
+/// generate the find, rfind and count kernels for element of `W` bits.
+/// the items is loaded with memcpy, so unaligned data and non integer type (float, struct, etc) is fine.
+#    define RZ__ARR_SIZED_KERNELS(W, T)                                                  \
+        static inline T rz__arr_load_##W(const rz_u8 *p, rz_usize i) {                    \
+            T v;                                                                          \
+            memcpy(&v, p + (i * sizeof(T)), sizeof(T));                                   \
+            return v;                                                                     \
+        }                                                                                 \
+        RZ_DEF rz_usize rz__arr_find_##W(const void *data, rz_usize len, void const *item) {  \
+            const rz_u8 *p = data;                                                        \
+            T            needle;                                                          \
+            rz_usize     i = 0;                                                           \
+            if (p == NULL) return RZ_ARR_FIND_NOTFOUND;                                   \
+            memcpy(&needle, item, sizeof(T));                                             \
+            RZ__ARR_SIMD_FIND(W, T)                                                       \
+            for (; i < len; ++i) {                                                        \
+                if (rz__arr_load_##W(p, i) == needle) return i;                       \
+            }                                                                             \
+            return RZ_ARR_FIND_NOTFOUND;                                                  \
+        }                                                                                 \
+        RZ_DEF rz_usize rz__arr_rfind_##W(const void *data, rz_usize len, void const *item) { \
+            const rz_u8 *p = data;                                                        \
+            T            needle;                                                          \
+            rz_usize     i = len;                                                         \
+            if (p == NULL) return RZ_ARR_FIND_NOTFOUND;                                   \
+            memcpy(&needle, item, sizeof(T));                                             \
+            RZ__ARR_SIMD_RFIND(W, T)                                                      \
+            while (i-- > 0) {                                                             \
+                if (rz__arr_load_##W(p, i) == needle) return i;                       \
+            }                                                                             \
+            return RZ_ARR_FIND_NOTFOUND;                                                  \
+        }                                                                                 \
+        RZ_DEF rz_usize rz__arr_count_##W(const void *data, rz_usize len, void const *item) { \
+            const rz_u8 *p = data;                                                        \
+            T            needle;                                                          \
+            rz_usize     i = 0, count = 0;                                                \
+            if (p == NULL) return 0;                                                      \
+            memcpy(&needle, item, sizeof(T));                                             \
+            RZ__ARR_SIMD_COUNT(W, T)                                                      \
+            for (; i < len; ++i) count += (rz__arr_load_##W(p, i) == needle);         \
+            return count;                                                                 \
+        }
+
+RZ__ARR_SIZED_KERNELS(8, rz_u8)
+RZ__ARR_SIZED_KERNELS(16, rz_u16)
+RZ__ARR_SIZED_KERNELS(32, rz_u32)
+RZ__ARR_SIZED_KERNELS(64, rz_u64)
+
 RZ_DEF rz_usize rz__arr_find(const RZ_ArrayViewOpaque *arr, void const *item, rz_usize elemsize) {
     RZ_DBG_ASSERT(arr != NULL && item != NULL);
     if (arr->data == NULL) return RZ_ARR_FIND_NOTFOUND;
+    switch (elemsize) {
+    case 1: return rz__arr_find_8(arr->data, arr->len, item);
+    case 2: return rz__arr_find_16(arr->data, arr->len, item);
+    case 4: return rz__arr_find_32(arr->data, arr->len, item);
+    case 8: return rz__arr_find_64(arr->data, arr->len, item);
+    default: break;
+    }
     for (rz_usize i = 0; i < arr->len; ++i) {
         if (0 == memcmp(item, (rz_u8 *)arr->data + i * elemsize, elemsize)) {
 
@@ -51,6 +200,13 @@ RZ_DEF rz_usize rz__arr_find(const RZ_ArrayViewOpaque *arr, void const *item, rz
 RZ_DEF rz_usize rz__arr_rfind(const RZ_ArrayViewOpaque *arr, void const *item, rz_usize elemsize) {
     RZ_DBG_ASSERT(arr != NULL && item != NULL);
     if (arr->data == NULL) return RZ_ARR_FIND_NOTFOUND;
+    switch (elemsize) {
+    case 1: return rz__arr_rfind_8(arr->data, arr->len, item);
+    case 2: return rz__arr_rfind_16(arr->data, arr->len, item);
+    case 4: return rz__arr_rfind_32(arr->data, arr->len, item);
+    case 8: return rz__arr_rfind_64(arr->data, arr->len, item);
+    default: break;
+    }
 
     for (rz_usize i = arr->len; i-- > 0;) {
         if (0 == memcmp(item, (rz_u8 *)arr->data + i * elemsize, elemsize)) {
@@ -60,6 +216,44 @@ RZ_DEF rz_usize rz__arr_rfind(const RZ_ArrayViewOpaque *arr, void const *item, r
     return RZ_ARR_FIND_NOTFOUND;
 }
 
+RZ_DEF rz_usize rz__arr_count(const RZ_ArrayViewOpaque *arr, void const *item, rz_usize elemsize) {
+    RZ_DBG_ASSERT(arr != NULL && item != NULL);
+    if (arr->data == NULL) return 0;
+    switch (elemsize) {
+    case 1: return rz__arr_count_8(arr->data, arr->len, item);
+    case 2: return rz__arr_count_16(arr->data, arr->len, item);
+    case 4: return rz__arr_count_32(arr->data, arr->len, item);
+    case 8: return rz__arr_count_64(arr->data, arr->len, item);
+    default: break;
+    }
+
+    rz_usize count = 0;
+    for (rz_usize i = 0; i < arr->len; ++i) {
+        count += (0 == memcmp(item, (rz_u8 *)arr->data + i * elemsize, elemsize));
+    }
+    return count;
+}
+
+RZ_DEF rz_usize rz__arr_find_all(const RZ_ArrayViewOpaque *arr, void const *item, rz_usize elemsize, RZ_ArrayOpaque *indices) {
+    RZ_DBG_ASSERT(arr != NULL && item != NULL && indices != NULL);
+    if (arr->data == NULL) return 0;
+
+    rz_usize found = 0;
+    for (rz_usize i = 0; i < arr->len;) {
+        // search the rest of the array with the sized kernel, dispatched once per match.
+        RZ_ArrayViewOpaque rest = {.data = (rz_u8 *)arr->data + (i * elemsize), .len = arr->len - i};
+        rz_usize           at   = rz__arr_find(&rest, item, elemsize);
+        if (at == RZ_ARR_FIND_NOTFOUND) break;
+
+        rz__arr_grow_impl(&indices->data, &indices->capacity, sizeof(rz_usize), indices->len + 1, indices->allocator);
+        ((rz_usize *)indices->data)[indices->len++] = i + at;
+
+        i += at + 1;
+        found++;
+    }
+    return found;
+}
+
 RZ_DEF rz_usize rz__arr_find_by(const RZ_ArrayViewOpaque *arr, RZ__ArrFindPatternFn pat, void const *pat_data, rz_usize elemsize) {
     RZ_ASSERT(arr != NULL && pat != NULL);
     if (arr->data == NULL) return RZ_ARR_FIND_NOTFOUND;
@@ -90,7 +284,7 @@ RZ_DEF rz_usize rz__arr_bsearch(const RZ_ArrayViewOpaque *arr, rz_usize elemsize
     while (len > 0) {
         const rz_u8 *try  = data + elemsize * (len / 2);
         int          sign = cmpfunc(needle, try);
-        if (sign == 0) return (rz_u8 *)try - (rz_u8 *)arr->data;
+        if (sign == 0) return (rz_usize)(try - (const rz_u8 *)arr->data) / elemsize;
         else if (len == 1) break;
         else if (sign < 0) len /= 2;
         else if (sign > 0) {
@@ -101,6 +295,523 @@ RZ_DEF rz_usize rz__arr_bsearch(const RZ_ArrayViewOpaque *arr, rz_usize elemsize
     return RZ_ARR_FIND_NOTFOUND;
 }
 
+static void *rz__sarr_alloc(void *a, rz_usize len) {
+    RZ__SmallArrayStorage *s = a;
+    if (!s->inline_used && len <= s->inline_size) {
+        s->inline_used = true;
+        return s->inline_data;
+    }
+    return rz_raw_alloc(s->backing, len);
+}
+
+static void *rz__sarr_remap(void *a, void *mem, rz_usize mem_len, rz_usize new_len) {
+    RZ__SmallArrayStorage *s = a;
+    if (mem != s->inline_data) return rz_raw_remap(s->backing, mem, mem_len, new_len);
+    if (new_len <= s->inline_size) return mem;
+
+    // spill the inline storage into the backing allocator
+    void *heap = rz_raw_alloc(s->backing, new_len);
+    if (heap == NULL) return NULL;
+    memcpy(heap, mem, mem_len);
+    s->inline_used = false;
+    return heap;
+}
+
+static void rz__sarr_dealloc(void *a, void *mem, rz_usize mem_len) {
+    RZ__SmallArrayStorage *s = a;
+    if (mem == s->inline_data) s->inline_used = false;
+    else rz_raw_dealloc(s->backing, mem, mem_len);
+}
+
+RZ_DEF void rz__sarr_init(RZ_ArrayOpaque *sa, RZ__SmallArrayStorage *storage, void *inline_data, rz_usize inline_capacity, rz_usize elemsize, RZ_Allocator allocator) {
+    static const RZ_AllocatorVTable vtable = {
+        .alloc   = rz__sarr_alloc,
+        .remap   = rz__sarr_remap,
+        .dealloc = rz__sarr_dealloc,
+    };
+    RZ_ASSERT(sa != NULL && storage != NULL && inline_data != NULL);
+    if (!rz_is_allocator(allocator)) allocator = rz_std_allocator();
+
+    *storage = (RZ__SmallArrayStorage){
+        .backing     = allocator,
+        .inline_data = inline_data,
+        .inline_size = inline_capacity * elemsize,
+        .inline_used = true,
+    };
+    sa->data      = inline_data;
+    sa->len       = 0;
+    sa->capacity  = inline_capacity;
+    sa->allocator = (RZ_Allocator){.ptr = storage, .vtable = &vtable};
+}
+
+RZ_DEF void rz__dq_slices(const RZ_DequeOpaque *dq, rz_usize elemsize, RZ_ArrayViewOpaque *first, RZ_ArrayViewOpaque *second) {
+    RZ_DBG_ASSERT(dq != NULL && first != NULL && second != NULL);
+    *first  = (RZ_ArrayViewOpaque){0};
+    *second = (RZ_ArrayViewOpaque){0};
+    if (dq->data == NULL || dq->len == 0) return;
+
+    rz_usize to_end = dq->capacity - dq->head;
+    first->data     = (rz_u8 *)dq->data + (dq->head * elemsize);
+    first->len      = RZ_MIN(dq->len, to_end);
+    if (dq->len > to_end) {
+        second->data = dq->data;
+        second->len  = dq->len - to_end;
+    }
+}
+
+RZ_DEF void rz__dq_grow(RZ_DequeOpaque *dq, rz_usize elemsize, rz_usize additional) {
+    RZ_ASSERT_NOT_NULL(dq);
+    rz_usize required = dq->len + additional;
+    if (required <= dq->capacity) return;
+    if (!rz_is_allocator(dq->allocator)) dq->allocator = rz_std_allocator();
+
+    rz_usize new_capacity = rz_next_pow2(RZ_MAX(required, RZ_ARR_INIT_CAPACITY));
+    rz_u8   *new_data     = rz_raw_alloc(dq->allocator, new_capacity * elemsize);
+    RZ_ASSERT_ALLOCATOR_PTR(new_data);
+
+    // unwrap the ring while copying, so the items is contiguous from index 0 in the new buffer.
+    RZ_ArrayViewOpaque first, second;
+    rz__dq_slices(dq, elemsize, &first, &second);
+    if (first.len > 0) memcpy(new_data, first.data, first.len * elemsize);
+    if (second.len > 0) memcpy(new_data + (first.len * elemsize), second.data, second.len * elemsize);
+
+    if (dq->data != NULL) rz_raw_dealloc(dq->allocator, dq->data, dq->capacity * elemsize);
+    dq->data     = new_data;
+    dq->capacity = new_capacity;
+    dq->head     = 0;
+}
+
+RZ_DEF void rz__dq_push_back_many(RZ_DequeOpaque *dq, rz_usize elemsize, const void *items, rz_usize items_len) {
+    RZ_DBG_ASSERT(dq != NULL && (items != NULL || items_len == 0));
+    if (items_len == 0) return;
+    rz__dq_grow(dq, elemsize, items_len);
+
+    rz_usize tail   = (dq->head + dq->len) & (dq->capacity - 1);
+    rz_usize to_end = RZ_MIN(items_len, dq->capacity - tail);
+    memcpy((rz_u8 *)dq->data + (tail * elemsize), items, to_end * elemsize);
+    if (to_end < items_len) memcpy(dq->data, (const rz_u8 *)items + (to_end * elemsize), (items_len - to_end) * elemsize);
+    dq->len += items_len;
+}
+
+RZ_DEF void rz__heap_grow(RZ_HeapOpaque *h, rz_usize elemsize, rz_usize capacity) {
+    RZ_ASSERT_NOT_NULL(h);
+    if (capacity <= h->capacity) return;
+    if (!rz_is_allocator(h->allocator)) h->allocator = rz_std_allocator();
+    rz_usize old_capacity = h->capacity;
+    rz__arr_grow_impl(&h->data, &h->capacity, elemsize, capacity, h->allocator);
+    if (h->handles != NULL) {
+        h->handles = rz_raw_remap(h->allocator, h->handles, old_capacity * sizeof(rz_u32), h->capacity * sizeof(rz_u32));
+        RZ_ASSERT_ALLOCATOR_PTR(h->handles);
+    }
+}
+
+RZ_DEF void rz__heap_free(RZ_HeapOpaque *h, rz_usize elemsize) {
+    RZ_ASSERT_NOT_NULL(h);
+    if (h->data != NULL) rz_raw_dealloc(h->allocator, h->data, h->capacity * elemsize);
+    if (h->handles != NULL) rz_free(h->allocator, h->handles, h->capacity);
+    if (h->positions != NULL) rz_free(h->allocator, h->positions, h->positions_capacity);
+    if (h->generations != NULL) rz_free(h->allocator, h->generations, h->positions_capacity);
+    RZ_Allocator allocator = h->allocator;
+    *h                     = (RZ_HeapOpaque){.allocator = allocator};
+}
+
+RZ_DEF void rz__heap_clear(RZ_HeapOpaque *h) {
+    RZ_ASSERT_NOT_NULL(h);
+    // every handle is released with the next generation, the tracking stay on.
+    if (h->handles != NULL) {
+        for (rz_usize i = 0; i < h->len; ++i) rz__heap_handle_release(h, h->handles[i]);
+    }
+    h->len = 0;
+}
+
+RZ_DEF RZ_HeapHandle rz__heap_handle_new(RZ_HeapOpaque *h, rz_usize pos) {
+    RZ_ASSERT_NOT_NULL(h);
+    RZ_DBG_ASSERT(pos < h->capacity);
+    if (h->handles == NULL) {
+        // enable the tracking, the items that is already in the heap get the handles [0, len).
+        RZ_ASSERT(h->positions_len == 0, "rz_heap: handles is not empty");
+        h->handles = rz_raw_alloc(h->allocator, h->capacity * sizeof(rz_u32));
+        RZ_ASSERT_ALLOCATOR_PTR(h->handles);
+        for (rz_usize i = 0; i < h->len; ++i) {
+            RZ_HeapHandle handle = rz__heap_handle_new(h, i);
+            RZ_UNUSED(handle);
+        }
+    }
+
+    rz_u32 slot;
+    if (h->free_handle != 0) {
+        slot           = h->free_handle - 1;
+        h->free_handle = h->positions[slot];
+    } else {
+        RZ_ASSERT(h->positions_len < RZ_U32_MAX, "rz_heap: too many handles");
+        rz_usize old_capacity = h->positions_capacity;
+        rz__arr_grow_impl((void **)&h->positions, &h->positions_capacity, sizeof(rz_u32), h->positions_len + 1, h->allocator);
+        if (old_capacity != h->positions_capacity) {
+            h->generations = rz_raw_remap(h->allocator, h->generations, old_capacity * sizeof(rz_u32), h->positions_capacity * sizeof(rz_u32));
+            RZ_ASSERT_ALLOCATOR_PTR(h->generations);
+        }
+        slot                 = (rz_u32)h->positions_len++;
+        h->generations[slot] = 0;
+    }
+    h->handles[pos]    = slot;
+    h->positions[slot] = (rz_u32)pos;
+    return (((RZ_HeapHandle)h->generations[slot]) << 32U) | slot;
+}
+
+RZ_DEF void rz__heap_handle_release(RZ_HeapOpaque *h, rz_u32 slot) {
+    RZ_ASSERT_NOT_NULL(h);
+    RZ_DBG_ASSERT(slot < h->positions_len);
+    // the free slot store the next free slot, it is never valid since `handles[pos]` is the live slot.
+    // the slot is retired when the generation is exhausted, reusing it would make old handles valid again.
+    if (++h->generations[slot] == RZ_U32_MAX) return;
+    h->positions[slot] = h->free_handle;
+    h->free_handle     = slot + 1;
+}
+
+RZ_DEF bool rz__heap_handle_valid(const RZ_HeapOpaque *h, RZ_HeapHandle handle) {
+    RZ_ASSERT_NOT_NULL(h);
+    rz_u32 slot = rz__heap_handle_slot(handle);
+    if (h->handles == NULL || slot >= h->positions_len || h->generations[slot] != (rz_u32)(handle >> 32U)) return false;
+    rz_u32 pos = h->positions[slot];
+    return pos < h->len && h->handles[pos] == slot;
+}
+
+// the generic (memcpy) version of the 4-ary sift down, the top is the smallest item by `cmpfunc`.
+static void rz__heap_sift_down_bytes(rz_u8 *data, rz_usize len, rz_usize elemsize, rz_usize i, int (*cmpfunc)(const void *, const void *), rz_u8 *temp) {
+    memcpy(temp, data + (i * elemsize), elemsize);
+    for (;;) {
+        rz_usize first = (i << 2U) + 1U;
+        if (first >= len) break;
+        rz_usize best = first, last = RZ_MIN(first + 4U, len);
+        for (rz_usize c = first + 1U; c < last; ++c) {
+            if (cmpfunc(data + (c * elemsize), data + (best * elemsize)) < 0) best = c;
+        }
+        if (cmpfunc(data + (best * elemsize), temp) >= 0) break;
+        memcpy(data + (i * elemsize), data + (best * elemsize), elemsize);
+        i = best;
+    }
+    memcpy(data + (i * elemsize), temp, elemsize);
+}
+
+RZ_DEF void rz__arr_top_k(const RZ_ArrayViewOpaque *a, rz_usize elemsize, rz_usize k, int (*cmpfunc)(const void *, const void *), RZ_ArrayOpaque *out) {
+    RZ_ASSERT_NOT_NULL(a);
+    RZ_ASSERT_NOT_NULL(out);
+    RZ_ASSERT_NOT_NULL(cmpfunc);
+    k = RZ_MIN(k, a->len);
+    if (k == 0) return;
+
+    // min heap of the k biggest items in `out[start .. start + k)`, the top is the smallest of them.
+    rz_usize start = out->len;
+    rz__arr_grow_impl(&out->data, &out->capacity, elemsize, start + k, out->allocator);
+    rz_u8       *heap = (rz_u8 *)out->data + (start * elemsize);
+    const rz_u8 *src  = a->data;
+    rz_u8        temp[elemsize];
+
+    memcpy(heap, src, k * elemsize);
+    for (rz_usize i = ((k > 1) ? ((k - 2) >> 2U) + 1U : 0); i-- > 0;) rz__heap_sift_down_bytes(heap, k, elemsize, i, cmpfunc, temp);
+    for (rz_usize i = k; i < a->len; ++i) {
+        if (cmpfunc(src + (i * elemsize), heap) <= 0) continue;
+        memcpy(heap, src + (i * elemsize), elemsize);
+        rz__heap_sift_down_bytes(heap, k, elemsize, 0, cmpfunc, temp);
+    }
+
+    // pop the smallest into the end, so the biggest is the first.
+    for (rz_usize n = k; n > 1; --n) {
+        rz_u8 *last = heap + ((n - 1) * elemsize);
+        memcpy(temp, heap, elemsize);
+        memcpy(heap, last, elemsize);
+        memcpy(last, temp, elemsize);
+        rz__heap_sift_down_bytes(heap, n - 1, elemsize, 0, cmpfunc, temp);
+    }
+    out->len = start + k;
+}
+
+// [ranks: (len + 1) rz_u32][padding to the cache line][keys: (len + 1) items]
+#    define RZ__STATIC_SEARCH_LINE 64U
+static rz_usize rz__static_search_block_size(rz_usize len, rz_usize elemsize) {
+    return ((len + 1) * sizeof(rz_u32)) + (RZ__STATIC_SEARCH_LINE - 1U) + ((len + 1) * elemsize);
+}
+
+// in-order traversal of the implicit tree assign the sorted items to the positions.
+static rz_usize rz__static_search_fill(RZ_StaticSearchOpaque *s, rz_usize elemsize, const rz_u8 *sorted, rz_usize i, rz_usize k) {
+    if (k > s->len) return i;
+    i = rz__static_search_fill(s, elemsize, sorted, i, k << 1U);
+    memcpy((rz_u8 *)s->keys + (k * elemsize), sorted + (i * elemsize), elemsize);
+    s->ranks[k] = (rz_u32)i++;
+    return rz__static_search_fill(s, elemsize, sorted, i, (k << 1U) + 1U);
+}
+
+RZ_DEF void rz__static_search_build(RZ_StaticSearchOpaque *s, rz_usize elemsize, const void *sorted, rz_usize len) {
+    RZ_ASSERT_NOT_NULL(s);
+    RZ_ASSERT(sorted != NULL || len == 0);
+    RZ_ASSERT(len < UINT32_MAX, "rz_static_search: too many items");
+    rz__static_search_free(s, elemsize);
+    if (len == 0) return;
+    if (!rz_is_allocator(s->allocator)) s->allocator = rz_std_allocator();
+
+    rz_u8 *block = rz_raw_alloc(s->allocator, rz__static_search_block_size(len, elemsize));
+    RZ_ASSERT_ALLOCATOR_PTR(block);
+    uintptr_t keys = (uintptr_t)(block + ((len + 1) * sizeof(rz_u32)));
+    keys           = (keys + (RZ__STATIC_SEARCH_LINE - 1U)) & ~(uintptr_t)(RZ__STATIC_SEARCH_LINE - 1U);
+
+    s->ranks    = (rz_u32 *)block;
+    s->keys     = (void *)keys;
+    s->len      = len;
+    s->ranks[0] = 0;
+    memset(s->keys, 0, elemsize);
+    rz__static_search_fill(s, elemsize, sorted, 0, 1);
+}
+
+RZ_DEF void rz__static_search_free(RZ_StaticSearchOpaque *s, rz_usize elemsize) {
+    RZ_ASSERT_NOT_NULL(s);
+    if (s->ranks != NULL) rz_raw_dealloc(s->allocator, s->ranks, rz__static_search_block_size(s->len, elemsize));
+    RZ_Allocator allocator = s->allocator;
+    *s                     = (RZ_StaticSearchOpaque){.allocator = allocator};
+}
+
+RZ_DEF void rz__segarr_free(RZ_SegArrayOpaque *sa, rz_usize elemsize) {
+    RZ_ASSERT_NOT_NULL(sa);
+    for (rz_u32 k = 0; k < RZ__SEGARR_MAX_SEGMENTS && sa->segments[k] != NULL; ++k) {
+        rz_raw_dealloc(sa->allocator, sa->segments[k], rz__segarr_segment_capacity(k) * elemsize);
+        sa->segments[k] = NULL;
+    }
+    sa->len      = 0;
+    sa->capacity = 0;
+}
+
+RZ_DEF void rz__segarr_reserve(RZ_SegArrayOpaque *sa, rz_usize elemsize, rz_usize capacity) {
+    RZ_ASSERT_NOT_NULL(sa);
+    if (capacity <= sa->capacity) return;
+    if (!rz_is_allocator(sa->allocator)) sa->allocator = rz_std_allocator();
+
+    // the capacity is always the sum of the full segments, so `capacity` is the first index of the next segment.
+    for (rz_u32 k = (sa->capacity == 0) ? 0 : rz__segarr_segment(sa->capacity); sa->capacity < capacity; ++k) {
+        RZ_ASSERT(k < RZ__SEGARR_MAX_SEGMENTS, "rz_segarr_reserve: capacity overflow");
+        sa->segments[k] = rz_raw_alloc(sa->allocator, rz__segarr_segment_capacity(k) * elemsize);
+        RZ_ASSERT_ALLOCATOR_PTR(sa->segments[k]);
+        sa->capacity += rz__segarr_segment_capacity(k);
+    }
+}
+
+RZ_DEF void rz__segarr_append_many(RZ_SegArrayOpaque *sa, rz_usize elemsize, const void *items, rz_usize items_len) {
+    RZ_DBG_ASSERT(sa != NULL && (items != NULL || items_len == 0));
+    if (items_len == 0) return;
+    rz__segarr_reserve(sa, elemsize, sa->len + items_len);
+
+    const rz_u8 *src = items;
+    while (items_len > 0) {
+        rz_u32   k      = rz__segarr_segment(sa->len);
+        rz_usize offset = sa->len + rz__segarr_segment_capacity(0) - rz__segarr_segment_capacity(k);
+        rz_usize n      = RZ_MIN(items_len, rz__segarr_segment_capacity(k) - offset);
+        memcpy((rz_u8 *)sa->segments[k] + (offset * elemsize), src, n * elemsize);
+        src       += n * elemsize;
+        sa->len   += n;
+        items_len -= n;
+    }
+}
+
+#    define RZ__SLOTMAP_NO_FREE RZ_U32_MAX
+
+RZ_DEF void rz__slotmap_free(RZ_SlotMapOpaque *sm, rz_usize elemsize) {
+    RZ_ASSERT_NOT_NULL(sm);
+    if (sm->data != NULL) rz_raw_dealloc(sm->allocator, sm->data, sm->capacity * elemsize);
+    if (sm->dense_slot != NULL) rz_free(sm->allocator, sm->dense_slot, sm->capacity);
+    if (sm->slots != NULL) rz_free(sm->allocator, sm->slots, sm->slots_capacity);
+    RZ_Allocator allocator = sm->allocator;
+    *sm                    = (RZ_SlotMapOpaque){.allocator = allocator};
+}
+
+RZ_DEF void rz__slotmap_clear(RZ_SlotMapOpaque *sm) {
+    RZ_ASSERT_NOT_NULL(sm);
+    // free every alive slot with the next generation, the stale handles never match again.
+    for (rz_usize i = 0; i < sm->len; ++i) {
+        struct RZ__Slot *slot = &sm->slots[sm->dense_slot[i]];
+        slot->generation++;
+        if (slot->generation == RZ_U32_MAX - 1) continue; // retired, see rz__slotmap_remove
+        slot->index   = sm->free_head;
+        sm->free_head = sm->dense_slot[i];
+    }
+    sm->len = 0;
+}
+
+RZ_DEF RZ_SlotHandle rz__slotmap_insert(RZ_SlotMapOpaque *sm, rz_usize elemsize) {
+    RZ_ASSERT_NOT_NULL(sm);
+    if (!rz_is_allocator(sm->allocator)) sm->allocator = rz_std_allocator();
+    if (sm->slots_len == 0 && sm->len == 0) sm->free_head = RZ__SLOTMAP_NO_FREE;
+
+    if (sm->len == sm->capacity) {
+        rz_usize new_capacity = sm->capacity ? sm->capacity * 2 : RZ_ARR_INIT_CAPACITY;
+        sm->data              = rz_raw_remap(sm->allocator, sm->data, sm->capacity * elemsize, new_capacity * elemsize);
+        sm->dense_slot        = rz_raw_remap(sm->allocator, sm->dense_slot, sm->capacity * sizeof(rz_u32), new_capacity * sizeof(rz_u32));
+        RZ_ASSERT_ALLOCATOR_PTR(sm->data);
+        RZ_ASSERT_ALLOCATOR_PTR(sm->dense_slot);
+        sm->capacity = new_capacity;
+    }
+
+    rz_u32 slot_index = sm->free_head;
+    if (slot_index != RZ__SLOTMAP_NO_FREE) {
+        sm->free_head = sm->slots[slot_index].index;
+    } else {
+        RZ_ASSERT(sm->slots_len < RZ__SLOTMAP_NO_FREE, "rz_slotmap_insert: too many slots");
+        if (sm->slots_len == sm->slots_capacity) {
+            rz_u32 new_capacity = sm->slots_capacity ? sm->slots_capacity * 2 : RZ_ARR_INIT_CAPACITY;
+            sm->slots           = rz_raw_remap(sm->allocator, sm->slots, sm->slots_capacity * sizeof(struct RZ__Slot), new_capacity * sizeof(struct RZ__Slot));
+            RZ_ASSERT_ALLOCATOR_PTR(sm->slots);
+            sm->slots_capacity = new_capacity;
+        }
+        slot_index                       = sm->slots_len++;
+        sm->slots[slot_index].generation = 0;
+    }
+
+    struct RZ__Slot *slot = &sm->slots[slot_index];
+    slot->generation++; // even (free) -> odd (alive)
+    slot->index               = (rz_u32)sm->len;
+    sm->dense_slot[sm->len++] = slot_index;
+    return rz__slot_handle(slot_index, slot->generation);
+}
+
+RZ_DEF rz_usize rz__slotmap_dense_index(const RZ_SlotMapOpaque *sm, RZ_SlotHandle h) {
+    RZ_ASSERT_NOT_NULL(sm);
+    rz_u32 slot_index = rz_slot_handle_index(h);
+    if (slot_index >= sm->slots_len) return RZ_NOT_FOUND;
+    const struct RZ__Slot *slot = &sm->slots[slot_index];
+    // the generation of free slot is even, so it never match the generation of valid handle.
+    if (slot->generation != rz_slot_handle_generation(h) || (slot->generation & 1U) == 0) return RZ_NOT_FOUND;
+    return slot->index;
+}
+
+RZ_DEF void *rz__slotmap_get(const RZ_SlotMapOpaque *sm, rz_usize elemsize, RZ_SlotHandle h) {
+    rz_usize i = rz__slotmap_dense_index(sm, h);
+    return (i == RZ_NOT_FOUND) ? NULL : (rz_u8 *)sm->data + (i * elemsize);
+}
+
+RZ_DEF bool rz__slotmap_remove(RZ_SlotMapOpaque *sm, rz_usize elemsize, RZ_SlotHandle h) {
+    rz_usize i = rz__slotmap_dense_index(sm, h);
+    if (i == RZ_NOT_FOUND) return false;
+
+    // swap remove, move the last item into the hole and update its slot through the back index.
+    rz_usize last = sm->len - 1;
+    if (i != last) {
+        memcpy((rz_u8 *)sm->data + (i * elemsize), (rz_u8 *)sm->data + (last * elemsize), elemsize);
+        sm->dense_slot[i]                  = sm->dense_slot[last];
+        sm->slots[sm->dense_slot[i]].index = (rz_u32)i;
+    }
+    sm->len--;
+
+    rz_u32           slot_index = rz_slot_handle_index(h);
+    struct RZ__Slot *slot       = &sm->slots[slot_index];
+    slot->generation++; // odd (alive) -> even (free)
+    // the slot is retired when the generation is exhausted, reusing it would make old handles valid again.
+    if (slot->generation == RZ_U32_MAX - 1) return true;
+    slot->index   = sm->free_head;
+    sm->free_head = slot_index;
+    return true;
+}
+
+RZ_DEF void rz_sparse_set_free(RZ_SparseSet *ss) {
+    RZ_ASSERT_NOT_NULL(ss);
+    if (ss->dense != NULL) rz_free(ss->allocator, ss->dense, ss->capacity);
+    if (ss->sparse != NULL) rz_free(ss->allocator, ss->sparse, ss->sparse_capacity);
+    *ss = (RZ_SparseSet){.allocator = ss->allocator};
+}
+
+RZ_DEF rz_usize rz_sparse_set_index_of(const RZ_SparseSet *ss, rz_u32 id) {
+    RZ_ASSERT_NOT_NULL(ss);
+    if (id >= ss->sparse_capacity) return RZ_NOT_FOUND;
+    rz_u32 i = ss->sparse[id];
+    return (i < ss->len && ss->dense[i] == id) ? i : RZ_NOT_FOUND;
+}
+
+RZ_DEF bool rz_sparse_set_insert(RZ_SparseSet *ss, rz_u32 id) {
+    RZ_ASSERT_NOT_NULL(ss);
+    if (rz_sparse_set_index_of(ss, id) != RZ_NOT_FOUND) return false;
+    if (!rz_is_allocator(ss->allocator)) ss->allocator = rz_std_allocator();
+
+    if (id >= ss->sparse_capacity) {
+        rz_usize new_capacity = rz_next_pow2(RZ_MAX((rz_usize)id + 1, RZ_ARR_INIT_CAPACITY));
+        ss->sparse            = rz_raw_remap(ss->allocator, ss->sparse, ss->sparse_capacity * sizeof(rz_u32), new_capacity * sizeof(rz_u32));
+        RZ_ASSERT_ALLOCATOR_PTR(ss->sparse);
+        // the stale entries is rejected by `dense[sparse[id]] == id`, zero only to keep the memory defined.
+        memset(ss->sparse + ss->sparse_capacity, 0, (new_capacity - ss->sparse_capacity) * sizeof(rz_u32));
+        ss->sparse_capacity = new_capacity;
+    }
+    if (ss->len == ss->capacity) {
+        rz_usize new_capacity = ss->capacity ? ss->capacity * 2 : RZ_ARR_INIT_CAPACITY;
+        ss->dense             = rz_raw_remap(ss->allocator, ss->dense, ss->capacity * sizeof(rz_u32), new_capacity * sizeof(rz_u32));
+        RZ_ASSERT_ALLOCATOR_PTR(ss->dense);
+        ss->capacity = new_capacity;
+    }
+    ss->sparse[id]       = (rz_u32)ss->len;
+    ss->dense[ss->len++] = id;
+    return true;
+}
+
+RZ_DEF bool rz_sparse_set_remove(RZ_SparseSet *ss, rz_u32 id) {
+    rz_usize i = rz_sparse_set_index_of(ss, id);
+    if (i == RZ_NOT_FOUND) return false;
+    rz_u32 last      = ss->dense[--ss->len];
+    ss->dense[i]     = last;
+    ss->sparse[last] = (rz_u32)i;
+    return true;
+}
+
+// the start of every column is aligned to max_align_t, return the offset of `column` in the block.
+static rz_usize rz__soa_offset(const rz_usize *sizes, rz_usize column, rz_usize capacity) {
+    rz_usize align  = alignof(max_align_t);
+    rz_usize offset = 0;
+    for (rz_usize i = 0; i < column; ++i) offset += ((sizes[i] * capacity) + align - 1) & ~(align - 1);
+    return offset;
+}
+
+RZ_DEF void rz__soa_reserve(RZ_SoaOpaque *s, const rz_usize *sizes, rz_usize ncolumns, rz_usize capacity) {
+    RZ_ASSERT_NOT_NULL(s);
+    if (capacity <= s->capacity) return;
+    if (!rz_is_allocator(s->allocator)) s->allocator = rz_std_allocator();
+
+    rz_usize new_capacity = s->capacity ? s->capacity : RZ_ARR_INIT_CAPACITY;
+    while (capacity > new_capacity) new_capacity += (new_capacity >> 1u);
+
+    // the columns is moved, so the block can not be remapped in place.
+    rz_u8 *old_block = s->columns[0];
+    rz_u8 *block     = rz_raw_alloc(s->allocator, rz__soa_offset(sizes, ncolumns, new_capacity));
+    RZ_ASSERT_ALLOCATOR_PTR(block);
+    for (rz_usize i = 0; i < ncolumns; ++i) {
+        rz_u8 *column = block + rz__soa_offset(sizes, i, new_capacity);
+        if (s->len > 0) memcpy(column, s->columns[i], s->len * sizes[i]);
+        s->columns[i] = column;
+    }
+    if (old_block != NULL) rz_raw_dealloc(s->allocator, old_block, rz__soa_offset(sizes, ncolumns, s->capacity));
+    s->capacity = new_capacity;
+}
+
+RZ_DEF void rz__soa_resize(RZ_SoaOpaque *s, const rz_usize *sizes, rz_usize ncolumns, rz_usize len) {
+    RZ_ASSERT_NOT_NULL(s);
+    rz__soa_reserve(s, sizes, ncolumns, len);
+    if (len > s->len) {
+        for (rz_usize i = 0; i < ncolumns; ++i) memset((rz_u8 *)s->columns[i] + (s->len * sizes[i]), 0, (len - s->len) * sizes[i]);
+    }
+    s->len = len;
+}
+
+RZ_DEF void rz__soa_remove_unordered(RZ_SoaOpaque *s, const rz_usize *sizes, rz_usize ncolumns, rz_usize index) {
+    RZ_ASSERT_NOT_NULL(s);
+    RZ_ASSERT(index < s->len, "rz_soa_remove_unordered: index out of bounds");
+    s->len--;
+    if (index == s->len) return;
+    for (rz_usize i = 0; i < ncolumns; ++i) {
+        rz_u8 *column = s->columns[i];
+        memcpy(column + (index * sizes[i]), column + (s->len * sizes[i]), sizes[i]);
+    }
+}
+
+RZ_DEF void rz__soa_free(RZ_SoaOpaque *s, const rz_usize *sizes, rz_usize ncolumns) {
+    RZ_ASSERT_NOT_NULL(s);
+    if (s->columns[0] != NULL) rz_raw_dealloc(s->allocator, s->columns[0], rz__soa_offset(sizes, ncolumns, s->capacity));
+    for (rz_usize i = 0; i < ncolumns; ++i) s->columns[i] = NULL;
+    s->len      = 0;
+    s->capacity = 0;
+}
+
 static thread_local rz_usize rz__hash_seed = 0;
 void                         rz_rand_seed(rz_usize seed) {
     rz__hash_seed = seed;
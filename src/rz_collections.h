@@ -149,15 +149,25 @@
 #    define RZ_ARR_FIND_NOTFOUND          ((rz_usize)(-1))
 #    define RZ_NOT_FOUND                  RZ_ARR_FIND_NOTFOUND
 
+///  element-size dispatch for the find/rfind/count kernels (internal use).
+///  when sizeof(T) is 1, 2, 4 or 8 the sized (SIMD) kernel is selected at compile time,
+///  otherwise it falls back to the memcmp kernel that dispatch per-call on `elemsize`.
+#    define rz__arr_kernel_call(fn, a, needle)                                                                                                  \
+        ((sizeof(*(a)->data) == 1) ? rz__arr_##fn##_8((a)->data, (a)->len, RZ_ADDRESSOF(*(a)->data, (needle)))  :                             \
+         (sizeof(*(a)->data) == 2) ? rz__arr_##fn##_16((a)->data, (a)->len, RZ_ADDRESSOF(*(a)->data, (needle))) :                             \
+         (sizeof(*(a)->data) == 4) ? rz__arr_##fn##_32((a)->data, (a)->len, RZ_ADDRESSOF(*(a)->data, (needle))) :                             \
+         (sizeof(*(a)->data) == 8) ? rz__arr_##fn##_64((a)->data, (a)->len, RZ_ADDRESSOF(*(a)->data, (needle))) :                             \
+                                     rz__arr_##fn((const RZ_ArrayViewOpaque *)(a), RZ_ADDRESSOF(*(a)->data, (needle)), sizeof(*(a)->data)))
+
 ///  find item from start of array.
 ///  rz_usize rz_arr_find(ArrayLike<T> *a, T item);
-#    define rz_arr_find(a, needle)               rz__arr_find   ((const RZ_ArrayViewOpaque *)(a), RZ_ADDRESSOF(*(a)->data, (needle)), sizeof(*(a)->data))
+#    define rz_arr_find(a, needle)               rz__arr_kernel_call(find, a, needle)
 ///  rz_usize rz_arr_find_by(ArrayLike<T> *a, bool(*pat_fn)(const void*item, const void *data), T pat_data);
 #    define rz_arr_find_by(a, pat_fn, pat_data)  rz__arr_find_by((const RZ_ArrayViewOpaque *)(a), pat_fn, RZ_ADDRESSOF(*(a)->data, (pat_data)), sizeof(*(a)->data))
 
 ///  find item from end of array. (reserve)
 ///  rz_usize rz_arr_rfind(ArrayLike<T> *a, T item);
-#    define rz_arr_rfind(a, needle)              rz__arr_rfind   ((const RZ_ArrayViewOpaque *)(a), RZ_ADDRESSOF(*(a)->data, (needle)), sizeof(*(a)->data))
+#    define rz_arr_rfind(a, needle)              rz__arr_kernel_call(rfind, a, needle)
 ///  rz_usize rz_arr_rfind_by(ArrayLike<T> *a, bool(*pat_fn)(const void*item, const void *data), T pat_data);
 #    define rz_arr_rfind_by(a, pat_fn, pat_data) rz__arr_rfind_by((const RZ_ArrayViewOpaque *)(a), pat_fn, RZ_ADDRESSOF(*(a)->data, (pat_data)), sizeof(*(a)->data))
 
@@ -167,6 +177,15 @@
 ///  bool   rz_arr_contains_by(ArrayLike<T> *a, bool(*pat_fn)(const void*item, const void *data), T pat_data);
 #    define rz_arr_contains_by(a, pat_fn, pat_data) (RZ_ARR_FIND_NOTFOUND != rz_arr_find_by(a, pat_fn, pat_data))
 
+///  count the occurrences of item in array.
+///  rz_usize rz_arr_count(ArrayLike<T> *a, T item);
+#    define rz_arr_count(a, needle)                 rz__arr_kernel_call(count, a, needle)
+
+///  find all the index of item in array. the indices is appended into `indices` (RZ_Array(rz_usize)).
+///  return the number of indices appended.
+///  rz_usize rz_arr_find_all(ArrayLike<T> *a, T item, RZ_Array(rz_usize) *indices);
+#    define rz_arr_find_all(a, needle, indices)     rz__arr_find_all((const RZ_ArrayViewOpaque *)(a), RZ_ADDRESSOF(*(a)->data, (needle)), sizeof(*(a)->data), (RZ_ArrayOpaque *)(indices))
+
 ///  check if array is ends with other array (`hasystack` has suffix of `needle`)
 ///  bool   rz_arr_ends_with(ArrayLike<T> *haystack, ArrayLike<T> *needle);
 #    define rz_arr_ends_with(a, needles)      ((needles).len <= (a)->len) && memcmp((a)->data + ((a)->len - (needles)->len), (needles)->data, (needles)->len * sizeof(*(a)->data))
@@ -220,9 +239,10 @@
 #    define rz_arr_rsplit_by(a, pat_fn, pat_data, result)           rz__arr_rsplit_by((RZ_ArrayViewOpaque *)(a), sizeof(*(a)->data), pat_fn, RZ_ADDRESSOF(*(a)->data, pat_data), (RZ_ArrayViewOpaque *)(result), false)
 #    define rz_arr_rsplit_inclusive_by(a, pat_fn, pat_data, result) rz__arr_rsplit_by((RZ_ArrayViewOpaque *)(a), sizeof(*(a)->data), pat_fn, RZ_ADDRESSOF(*(a)->data, pat_data), (RZ_ArrayViewOpaque *)(result), true)
 
-///  binary search array. 
+///  binary search array, return the index of `needle` or RZ_ARR_FIND_NOTFOUND.
+///  for the big read only table see RZ_STATIC_SEARCH_DEFINE.
 ///  rz_usize rz_arr_bsearch(ArrayLike<T> *a, T needle,  int(*cmpfunc)(void const *, void const *));
-#    define rz_arr_bsearch(a, needle, cmpfunc)   rz__arr_bsearch((a)->data, (a)->len, sizeof(*(a)->data), RZ_ADDRESSOF(*(a)->data, needle), cmpfunc)
+#    define rz_arr_bsearch(a, needle, cmpfunc)   rz__arr_bsearch((const RZ_ArrayViewOpaque *)(a), sizeof(*(a)->data), RZ_ADDRESSOF(*(a)->data, needle), cmpfunc)
 
 ///  binary search array.( using stdlib qsort. TODO: implement our own sorting algoritm? )
 ///  void   rz_arr_sort(ArrayLike<T> *a, int(*cmpfunc)(void const *, void const *));
@@ -230,6 +250,685 @@
 
 #    define rz__arr_grow(da, new_capacity) rz__arr_grow_impl((void **)&(da)->data, &(da)->capacity, sizeof(*(da)->data), (new_capacity), (da)->allocator)
 
+///////////////
+/// SmallArray Macors helpers
+///
+/// RZ_SmallArray(T, N) is RZ_Array(T) with inline storage for the first N items.
+/// the `allocator` member is a small buffer allocator that hand out the inline storage first
+/// and spill to the backing allocator when the array grow past N, so every rz_arr_* macro
+/// (append, append_many, pop, remove, foreach, find, free, ...) work on it as is.
+///
+/// NOTE: `data` and `allocator` point into the struct itself, so the small array
+///       must not be copied or moved by value after rz_sarr_init.
+///
+/// Example:
+///  RZ_SmallArray(RZ_StrView, 8) tags;
+///  rz_sarr_init(&tags, rz_std_allocator());
+///  rz_arr_append(&tags, rz_sv("a"));   // no allocation until the 9th item
+///  rz_arr_foreach(it, &tags) { ... }
+///  rz_sarr_free(&tags);                // tags start again from the inline storage
+///
+#    define RZ_SmallArray(T, N)                                        \
+        struct {                                                       \
+            RZ__ARR_STRUCT_MEMBERS(T);                                 \
+            /* storage - state of the small buffer allocator */        \
+            RZ__SmallArrayStorage storage;                             \
+            /* inline_data - the inline storage for the first N items */ \
+            T inline_data[N];                                          \
+        }
+
+///  initialize small array, `data` point to the inline storage. if allocator is not valid use rz_std_allocator()
+///    void rz_sarr_init(RZ_SmallArray(T, N) *sa, RZ_Allocator allocator);
+#    define rz_sarr_init(sa, _allocator)   rz__sarr_init((RZ_ArrayOpaque *)(sa), &(sa)->storage, (sa)->inline_data, RZ_ARRAY_LEN((sa)->inline_data), sizeof(*(sa)->data), (_allocator))
+
+///  free the spilled items and start again from the inline storage with capacity N.
+///  rz_arr_free work too, but the next grow only get the inline storage back when RZ_ARR_INIT_CAPACITY items fit in it.
+///    void rz_sarr_free(RZ_SmallArray(T, N) *sa);
+#    define rz_sarr_free(sa)               do { rz_arr_free(sa); rz_sarr_init(sa, (sa)->storage.backing); } while(0)
+
+///  check if the items is still stored in the inline storage.
+///    bool rz_sarr_is_inline(RZ_SmallArray(T, N) *sa);
+#    define rz_sarr_is_inline(sa)          ((void *)(sa)->data == (void *)(sa)->inline_data)
+
+///  get the view of the small array, to pass it to the function that accept RZ_ArrayView(T).
+///    RZ_ArrayView(T) rz_sarr_view(view_type, RZ_SmallArray(T, N) *sa);
+#    define rz_sarr_view(view_type, sa)    ((view_type){.data = (sa)->data, .len = (sa)->len})
+
+///////////////
+/// Deque (ring buffer) Macors helpers
+///
+/// RZ_Deque(T) is double ended queue on top of ring buffer with power of two capacity.
+/// the logical item `i` is stored at `data[(head + i) & (capacity - 1)]`, so push and pop
+/// on both ends is O(1) and never memmove the items (unlike `rz_arr_remove(da, 0)`).
+///
+/// Example:
+///  RZ_Deque(int) dq = {.allocator = rz_std_allocator()};
+///  rz_dq_push_back(&dq, 1);
+///  rz_dq_push_front(&dq, 0);
+///  int zero = rz_dq_pop_front(&dq);
+///  int one  = rz_dq_pop_back(&dq);
+///  rz_dq_free(&dq);
+///
+#    define RZ__DEQUE_STRUCT_MEMBERS(T)                                      \
+        /* data - the ring buffer, capacity is always power of two or 0 */ \
+        T           *data;                                                 \
+        /* head - index of the first item in the `data` */                 \
+        rz_usize     head;                                                 \
+        /* len - the amount of items in the deque */                       \
+        rz_usize     len;                                                  \
+        /* capacity - the capacity of the `data` allocated */              \
+        rz_usize     capacity;                                             \
+        /* allocator - the allocator of the deque */                       \
+        RZ_Allocator allocator
+
+#    define RZ_Deque(T)                    \
+        struct {                           \
+            RZ__DEQUE_STRUCT_MEMBERS(T);   \
+        }
+
+#    define rz__dq_mask(dq)                ((dq)->capacity - 1)
+#    define rz__dq_index(dq, i)            (((dq)->head + (i)) & rz__dq_mask(dq))
+
+///    void rz_dq_free(RZ_Deque(T) *dq);
+#    define rz_dq_free(dq)                 do { rz_free((dq)->allocator, (dq)->data, (dq)->capacity); (dq)->capacity = 0; (dq)->len = 0; (dq)->head = 0; (dq)->data = NULL; } while(0)
+#    define rz_dq_clear(dq)                ((dq)->len = 0, (dq)->head = 0)
+#    define rz_dq_is_empty(dq)             ((dq)->len == 0)
+
+///  Reserve space for `additional` items. the capacity is rounded up to power of two.
+///  when the ring is wrapped, growing unwrap it into the new buffer (head become 0).
+///    void rz_dq_reserve(RZ_Deque(T) *dq, rz_usize additional);
+#    define rz_dq_reserve(dq, additional)  rz__dq_grow((RZ_DequeOpaque *)(dq), sizeof(*(dq)->data), (additional))
+
+///  push item at the end / at the front of the deque.
+///    void rz_dq_push_back(RZ_Deque(T) *dq, T item);
+///    void rz_dq_push_front(RZ_Deque(T) *dq, T item);
+#    define rz_dq_push_back(dq, ...)       do { rz_dq_reserve(dq, 1); (dq)->data[rz__dq_index(dq, (dq)->len)] = __VA_ARGS__; (dq)->len++; } while (0)
+#    define rz_dq_push_front(dq, ...)      do { rz_dq_reserve(dq, 1); (dq)->head = ((dq)->head - 1) & rz__dq_mask(dq); (dq)->len++; (dq)->data[(dq)->head] = __VA_ARGS__; } while (0)
+
+///  push several items at the end of the deque, (at most two memcpy)
+///    void rz_dq_push_back_many(RZ_Deque(T) *dq, T *items, rz_usize items_len);
+#    define rz_dq_push_back_many(dq, items, items_len)  do { RZ_STATIC_ASSERT_TYPE_COMPATIBLE(*(dq)->data, *items); rz__dq_push_back_many((RZ_DequeOpaque *)(dq), sizeof(*(dq)->data), (items), (items_len)); } while (0)
+
+///  pop the item from the front / from the end of the deque. asserts if the deque is empty
+///       T rz_dq_pop_front(RZ_Deque(T) *dq);
+///       T rz_dq_pop_back(RZ_Deque(T) *dq);
+#    define rz_dq_pop_front(dq)            (dq)->data[(RZ_ASSERT((dq)->len > 0, "try to pop empty deque"), (dq)->len--, (dq)->head = ((dq)->head + 1) & rz__dq_mask(dq), ((dq)->head - 1) & rz__dq_mask(dq))]
+#    define rz_dq_pop_back(dq)             (dq)->data[(RZ_ASSERT((dq)->len > 0, "try to pop empty deque"), --(dq)->len, rz__dq_index(dq, (dq)->len))]
+
+///  drop `n` items from the front of the deque, e.g after the slices is consumed by writev.
+///    void rz_dq_drop_front(RZ_Deque(T) *dq, rz_usize n);
+#    define rz_dq_drop_front(dq, n)        do { rz_usize _n = (n); RZ_ASSERT(_n <= (dq)->len, "try to drop more than deque len"); (dq)->head = rz__dq_index(dq, _n); (dq)->len -= _n; } while (0)
+
+///  get first / last item from deque. crash if deque is empty.
+///      T  rz_dq_front(RZ_Deque(T) *dq);
+///      T  rz_dq_back(RZ_Deque(T) *dq);
+#    define rz_dq_front(dq)                (dq)->data[(RZ_ASSERT((dq)->len > 0), (dq)->head)]
+#    define rz_dq_back(dq)                 (dq)->data[(RZ_ASSERT((dq)->len > 0), rz__dq_index(dq, (dq)->len - 1))]
+
+///  get item at logical index (0 is the front). crash if idx is out of bound.
+///      T  rz_dq_at(RZ_Deque(T) *dq, rz_usize idx);
+#    define rz_dq_at(dq, idx)              (dq)->data[(RZ_ASSERT((dq)->len > (idx)), rz__dq_index(dq, idx))]
+
+///  get pointer of item at logical index. return NULL if idx is invalid
+///      T* rz_dq_get(RZ_Deque(T) *dq, rz_usize idx);
+#    define rz_dq_get(dq, idx)             (((idx) < (dq)->len) ? &(dq)->data[rz__dq_index(dq, idx)] : NULL)
+
+///  get the contiguous slices of the deque. `first` is from head to the end of the buffer,
+///  `second` is the wrapped part (empty when the ring is not wrapped).
+///  first and second can be used directly for bulk memcpy or writev.
+///    void rz_dq_slices(RZ_Deque(T) *dq, RZ_ArrayView(T) *first, RZ_ArrayView(T) *second);
+#    define rz_dq_slices(dq, first, second) rz__dq_slices((const RZ_DequeOpaque *)(dq), sizeof(*(dq)->data), (RZ_ArrayViewOpaque *)(first), (RZ_ArrayViewOpaque *)(second))
+
+///  iterate item from deque, from front to back.
+///     rz_dq_foreach(it_item, &dq) {
+///         printf("item: %d", *it_item);
+///     }
+///  one loop (break end the walk), the logical index of `it` is recomputed from its offset to the head.
+#    define rz_dq_foreach(it, dq)          for (RZ_TYPEOF((dq)->data) it = ((dq)->len > 0) ? &(dq)->data[(dq)->head] : NULL; it != NULL; \
+                                                it = (rz__dq_offset(dq, it) + 1 < (dq)->len) ? &(dq)->data[rz__dq_index(dq, rz__dq_offset(dq, it) + 1)] : NULL)
+#    define rz__dq_offset(dq, ptr)         (((rz_usize)((ptr) - (dq)->data) - (dq)->head) & rz__dq_mask(dq))
+
+///////////////
+/// Heap (priority queue) Macors helpers
+///
+/// RZ_HEAP_DEFINE(Name, T, less) generate the 4-ary heap `Name` (RZ_Heap(T)) with the comparator `less` inlined
+/// into the sift loops. `less(a, b)` take two values of T (function or function like macro), the top of the heap is
+/// the smallest item by `less`, so the max heap is `less` that compare with `>`.
+/// 4-ary heap is shallower than binary heap and the 4 children is in the same cache line for small T.
+/// the heap has the members of RZ_Array(T) (`data[0]` is the top), the items can be appended with rz_arr_* then
+/// Name_heapify. the generated functions:
+///
+///    void          Name_reserve(Name *h, rz_usize capacity);
+///    void          Name_free(Name *h);
+///    void          Name_clear(Name *h);
+///    void          Name_push(Name *h, T item);
+///    T             Name_pop(Name *h);                 // crash if the heap is empty
+///    T*            Name_peek(Name *h);                // NULL if the heap is empty
+///    void          Name_heapify(Name *h);             // O(n), restore the heap after `data` is modified
+///    Name          Name_from_array(T *data, rz_usize len, rz_usize capacity, RZ_Allocator allocator); // O(n)
+///    // decrease-key: the handle is stable while the item is in the heap, the first push_handle enable the tracking.
+///    // the handle is `(generation << 32) | slot`, the slot of the popped/removed item is reused with the next
+///    // generation, so the old handle is never valid again (contains is false, update/remove crash).
+///    RZ_HeapHandle Name_push_handle(Name *h, T item);
+///    bool          Name_contains(const Name *h, RZ_HeapHandle handle);
+///    T*            Name_get(const Name *h, RZ_HeapHandle handle);
+///    void          Name_update(Name *h, RZ_HeapHandle handle, T item); // decrease or increase the key
+///    T             Name_remove(Name *h, RZ_HeapHandle handle);
+///
+/// Example:
+///  typedef struct { rz_u64 deadline; rz_u32 task; } Timer;
+///  #define timer_less(a, b) ((a).deadline < (b).deadline)
+///  RZ_HEAP_DEFINE(Timers, Timer, timer_less);
+///
+///  Timers timers = {.allocator = rz_std_allocator()};
+///  RZ_HeapHandle h = Timers_push_handle(&timers, (Timer){.deadline = 100, .task = 1});
+///  Timers_update(&timers, h, (Timer){.deadline = 10, .task = 1});
+///  Timer next = Timers_pop(&timers);
+///  Timers_free(&timers);
+///
+typedef rz_u64 RZ_HeapHandle;
+
+#    define RZ__HEAP_STRUCT_MEMBERS(T)                                                          \
+        RZ__ARR_STRUCT_MEMBERS(T);                                                            \
+        /* handles - the handle slot of the item at the position, NULL if the tracking is off */ \
+        rz_u32  *handles;                                                                     \
+        /* positions - the position of the handle slot in `data` */                           \
+        rz_u32  *positions;                                                                   \
+        /* generations - the generation of the handle slot */                                 \
+        rz_u32  *generations;                                                                 \
+        rz_usize positions_len;                                                               \
+        rz_usize positions_capacity;                                                          \
+        /* free_handle - the free list of handle slots (slot + 1), 0 is empty */              \
+        rz_u32   free_handle
+
+#    define RZ_Heap(T)                  \
+        struct {                        \
+            RZ__HEAP_STRUCT_MEMBERS(T); \
+        }
+
+// clang-format off
+#    define RZ__HEAP_PLACE(h, i, item, handle)  do { (h)->data[i] = (item); if ((h)->handles != NULL) { (h)->handles[i] = (handle); (h)->positions[handle] = (rz_u32)(i); } } while (0)
+#    define RZ__HEAP_HANDLE_AT(h, i)            (((h)->handles != NULL) ? (h)->handles[i] : 0U)
+
+#    define RZ_HEAP_DEFINE(Name, T, less)                                                                           \
+        typedef RZ_Heap(T) Name;                                                                                    \
+        static inline rz_usize Name##__sift_up(Name *h, rz_usize i) {                                               \
+            T      item   = h->data[i];                                                                             \
+            rz_u32 handle = RZ__HEAP_HANDLE_AT(h, i);                                                               \
+            while (i > 0) {                                                                                         \
+                rz_usize parent = (i - 1) >> 2U;                                                                    \
+                if (!(less(item, h->data[parent]))) break;                                                          \
+                RZ__HEAP_PLACE(h, i, h->data[parent], RZ__HEAP_HANDLE_AT(h, parent));                               \
+                i = parent;                                                                                         \
+            }                                                                                                       \
+            RZ__HEAP_PLACE(h, i, item, handle);                                                                     \
+            return i;                                                                                               \
+        }                                                                                                           \
+        static inline rz_usize Name##__sift_down(Name *h, rz_usize i) {                                             \
+            rz_usize len    = h->len;                                                                               \
+            T        item   = h->data[i];                                                                           \
+            rz_u32   handle = RZ__HEAP_HANDLE_AT(h, i);                                                             \
+            for (;;) {                                                                                              \
+                rz_usize first = (i << 2U) + 1U;                                                                    \
+                if (first >= len) break;                                                                            \
+                rz_usize best = first;                                                                              \
+                if (first + 4U <= len) {                                                                            \
+                    /* tournament of the 4 children, compiled to conditional moves */                               \
+                    rz_usize l = first + (rz_usize)(less(h->data[first + 1U], h->data[first]));                     \
+                    rz_usize r = first + 2U + (rz_usize)(less(h->data[first + 3U], h->data[first + 2U]));           \
+                    best       = (less(h->data[r], h->data[l])) ? r : l;                                            \
+                } else {                                                                                            \
+                    for (rz_usize c = first + 1U; c < len; ++c) {                                                   \
+                        if (less(h->data[c], h->data[best])) best = c;                                              \
+                    }                                                                                               \
+                }                                                                                                   \
+                if (!(less(h->data[best], item))) break;                                                            \
+                RZ__HEAP_PLACE(h, i, h->data[best], RZ__HEAP_HANDLE_AT(h, best));                                   \
+                i = best;                                                                                           \
+            }                                                                                                       \
+            RZ__HEAP_PLACE(h, i, item, handle);                                                                     \
+            return i;                                                                                               \
+        }                                                                                                           \
+        static inline void Name##_reserve(Name *h, rz_usize capacity) {                                             \
+            rz__heap_grow((RZ_HeapOpaque *)h, sizeof(T), capacity);                                                 \
+        }                                                                                                           \
+        static inline void Name##_free(Name *h) { rz__heap_free((RZ_HeapOpaque *)h, sizeof(T)); }                   \
+        static inline void Name##_clear(Name *h) { rz__heap_clear((RZ_HeapOpaque *)h); }                            \
+        static inline void Name##_push(Name *h, T item) {                                                           \
+            if (h->len >= h->capacity) Name##_reserve(h, h->len + 1);                                               \
+            if (h->handles != NULL) rz__heap_handle_new((RZ_HeapOpaque *)h, h->len);                                \
+            h->data[h->len] = item;                                                                                 \
+            Name##__sift_up(h, h->len++);                                                                           \
+        }                                                                                                           \
+        static inline T *Name##_peek(Name *h) { return (h->len > 0) ? &h->data[0] : NULL; }                         \
+        static inline T  Name##_pop(Name *h) {                                                                      \
+            RZ_ASSERT(h->len > 0, "try to pop empty heap");                                                         \
+            T top = h->data[0];                                                                                     \
+            if (h->handles != NULL) rz__heap_handle_release((RZ_HeapOpaque *)h, h->handles[0]);                     \
+            if (--h->len > 0) {                                                                                     \
+                RZ__HEAP_PLACE(h, 0, h->data[h->len], RZ__HEAP_HANDLE_AT(h, h->len));                               \
+                Name##__sift_down(h, 0);                                                                            \
+            }                                                                                                       \
+            return top;                                                                                             \
+        }                                                                                                           \
+        static inline void Name##_heapify(Name *h) {                                                                \
+            for (rz_usize i = (h->len > 1) ? ((h->len - 2) >> 2U) + 1U : 0; i-- > 0;) Name##__sift_down(h, i);     \
+        }                                                                                                           \
+        static inline Name Name##_from_array(T *data, rz_usize len, rz_usize capacity, RZ_Allocator allocator) {    \
+            Name h = {.data = data, .len = len, .capacity = capacity, .allocator = allocator};                      \
+            Name##_heapify(&h);                                                                                     \
+            return h;                                                                                               \
+        }                                                                                                           \
+        static inline RZ_HeapHandle Name##_push_handle(Name *h, T item) {                                           \
+            if (h->len >= h->capacity) Name##_reserve(h, h->len + 1);                                               \
+            RZ_HeapHandle handle = rz__heap_handle_new((RZ_HeapOpaque *)h, h->len);                                 \
+            h->data[h->len]      = item;                                                                            \
+            Name##__sift_up(h, h->len++);                                                                           \
+            return handle;                                                                                          \
+        }                                                                                                           \
+        static inline bool Name##_contains(const Name *h, RZ_HeapHandle handle) {                                   \
+            return rz__heap_handle_valid((const RZ_HeapOpaque *)h, handle);                                         \
+        }                                                                                                           \
+        static inline T *Name##_get(const Name *h, RZ_HeapHandle handle) {                                          \
+            return Name##_contains(h, handle) ? &h->data[h->positions[rz__heap_handle_slot(handle)]] : NULL;        \
+        }                                                                                                           \
+        static inline void Name##_update(Name *h, RZ_HeapHandle handle, T item) {                                   \
+            RZ_ASSERT(Name##_contains(h, handle), "heap update: invalid handle");                                   \
+            rz_usize i = h->positions[rz__heap_handle_slot(handle)];                                                \
+            h->data[i] = item;                                                                                      \
+            if (Name##__sift_up(h, i) == i) Name##__sift_down(h, i);                                                \
+        }                                                                                                           \
+        static inline T Name##_remove(Name *h, RZ_HeapHandle handle) {                                              \
+            RZ_ASSERT(Name##_contains(h, handle), "heap remove: invalid handle");                                   \
+            rz_usize i    = h->positions[rz__heap_handle_slot(handle)];                                             \
+            T        item = h->data[i];                                                                             \
+            rz__heap_handle_release((RZ_HeapOpaque *)h, rz__heap_handle_slot(handle));                              \
+            if (i != --h->len) {                                                                                    \
+                RZ__HEAP_PLACE(h, i, h->data[h->len], h->handles[h->len]);                                          \
+                if (Name##__sift_up(h, i) == i) Name##__sift_down(h, i);                                            \
+            }                                                                                                       \
+            return item;                                                                                            \
+        }                                                                                                           \
+        typedef int Name##__require_semicolon
+
+///  move the buffer of the array into the heap (the array must not be freed) and heapify it.
+///    Name rz_heap_from_array(Name, RZ_Array(T) *a);
+#    define rz_heap_from_array(Name, a)         Name##_from_array((a)->data, (a)->len, (a)->capacity, (a)->allocator)
+
+///  select the `k` biggest items (by qsort like `cmpfunc`) of the array with a k items heap, O(n log k).
+///  the items is appended into `out` (RZ_Array(T)) from the biggest.
+///    void rz_arr_top_k(ArrayLike<T> *a, rz_usize k, int (*cmpfunc)(const void *, const void *), RZ_Array(T) *out);
+#    define rz_arr_top_k(a, k, cmpfunc, out)    do { RZ_STATIC_ASSERT_TYPE_COMPATIBLE(*(a)->data, *(out)->data); rz__arr_top_k((const RZ_ArrayViewOpaque *)(a), sizeof(*(a)->data), (k), (cmpfunc), (RZ_ArrayOpaque *)(out)); } while (0)
+// clang-format on
+
+///////////////
+/// StaticSearch (Eytzinger layout) Macors helpers
+///
+/// RZ_STATIC_SEARCH_DEFINE(Name, T, K, key_of) generate `Name` (RZ_StaticSearch(T)), the read only search table
+/// of items sorted by `key_of(item)` (function or function like macro that return K, compared with `<`).
+/// the sorted items is copied in the Eytzinger (BFS) layout: `keys[1]` is the root and the children of `keys[k]`
+/// is `keys[2k]` and `keys[2k + 1]`, so the first levels share the same cache lines and the lookup is branchless
+/// (`k = 2k + (key_of(keys[k]) < key)`) and prefetch the descendants of 4 levels below (16 u32 keys of one cache line).
+/// for the big table that is built once and searched many times, use rz_arr_bsearch for the small or mutable array.
+/// the typed tables of rz_u32, rz_u64 and rz_f64 is predefined: RZ_StaticSearchU32, RZ_StaticSearchU64 and RZ_StaticSearchF64.
+/// the generated functions:
+///
+///    void     Name_build(Name *s, const T *sorted, rz_usize len); // copy the sorted items, the old table is freed
+///    void     Name_free(Name *s);
+///    rz_usize Name_lower_bound(const Name *s, K key);             // index (in `sorted`) of the first item >= key, or len
+///    rz_usize Name_find(const Name *s, K key);                    // index (in `sorted`) of the item, or RZ_ARR_FIND_NOTFOUND
+///    T*       Name_get(const Name *s, K key);                     // the item in the table, or NULL
+///
+/// Example:
+///  typedef struct { rz_u32 code; const char *name; } Symbol;
+///  #define symbol_code(s) ((s).code)
+///  RZ_STATIC_SEARCH_DEFINE(Symbols, Symbol, rz_u32, symbol_code);
+///
+///  Symbols table = {.allocator = rz_std_allocator()};
+///  Symbols_build(&table, sorted_symbols, sorted_symbols_len);
+///  Symbol *s = Symbols_get(&table, 0x41);
+///  Symbols_free(&table);
+///
+/// NOTE: the keys of RZ_StaticSearchF64 must not be NaN.
+#    define RZ__STATIC_SEARCH_STRUCT_MEMBERS(T)                                                        \
+        /* keys - the items in Eytzinger layout, `keys[0]` is unused */                              \
+        T           *keys;                                                                         \
+        /* ranks - the index of `keys[k]` in the sorted items (the start of the allocated block) */ \
+        rz_u32      *ranks;                                                                        \
+        /* len - the amount of items */                                                            \
+        rz_usize     len;                                                                          \
+        RZ_Allocator allocator
+
+#    define RZ_StaticSearch(T)                  \
+        struct {                                \
+            RZ__STATIC_SEARCH_STRUCT_MEMBERS(T); \
+        }
+
+// clang-format off
+/// the stride of the prefetched descendant: 4 levels below for the key of 4 bytes, one cache line of keys.
+#    define RZ__STATIC_SEARCH_STRIDE(T)         ((sizeof(T) <= 4U) ? 16U : (sizeof(T) <= 8U) ? 8U : (sizeof(T) <= 16U) ? 4U : 2U)
+#    define RZ__STATIC_SEARCH_KEY(x)            (x)
+
+#    define RZ_STATIC_SEARCH_DEFINE(Name, T, K, key_of)                                                             \
+        typedef RZ_StaticSearch(T) Name;                                                                            \
+        static inline void Name##_build(Name *s, const T *sorted, rz_usize len) {                                   \
+            rz__static_search_build((RZ_StaticSearchOpaque *)s, sizeof(T), sorted, len);                            \
+        }                                                                                                           \
+        static inline void Name##_free(Name *s) { rz__static_search_free((RZ_StaticSearchOpaque *)s, sizeof(T)); }  \
+        /* the position of the first item >= key in `keys`, 0 if there is none */                                  \
+        static inline rz_usize Name##__search(const Name *s, K key) {                                               \
+            rz_usize k = 1;                                                                                         \
+            while (k <= s->len) {                                                                                   \
+                rz_prefetch((uintptr_t)s->keys + (k * RZ__STATIC_SEARCH_STRIDE(T) * sizeof(T)));                    \
+                k = (k << 1U) + (rz_usize)(key_of(s->keys[k]) < key);                                               \
+            }                                                                                                       \
+            /* drop the right turns after the last left turn */                                                     \
+            return k >> (rz_ctz64(~(rz_u64)k) + 1U);                                                                \
+        }                                                                                                           \
+        static inline rz_usize Name##_lower_bound(const Name *s, K key) {                                           \
+            rz_usize k = Name##__search(s, key);                                                                    \
+            return (k != 0) ? s->ranks[k] : s->len;                                                                 \
+        }                                                                                                           \
+        static inline T *Name##_get(const Name *s, K key) {                                                         \
+            rz_usize k = Name##__search(s, key);                                                                    \
+            return (k != 0 && !(key < key_of(s->keys[k]))) ? &s->keys[k] : NULL;                                    \
+        }                                                                                                           \
+        static inline rz_usize Name##_find(const Name *s, K key) {                                                  \
+            T *item = Name##_get(s, key);                                                                           \
+            return (item != NULL) ? s->ranks[item - s->keys] : RZ_ARR_FIND_NOTFOUND;                                \
+        }                                                                                                           \
+        typedef int Name##__require_semicolon
+// clang-format on
+
+///////////////
+/// SegArray (segmented array) Macors helpers
+///
+/// RZ_SegArray(T) store the items in geometrically growing segments, the segment `k` has
+/// `1 << (k + RZ_SEGARR_FIRST_SHIFT)` items. growing only allocate the next segment, the old items is never
+/// copied (no reallocation spikes) and the address of the item is stable until the array is freed.
+/// the segment and the offset of index `i` is found with one bit scan of `i + (1 << RZ_SEGARR_FIRST_SHIFT)`.
+///
+/// Example:
+///  RZ_SegArray(Node) nodes = {.allocator = rz_std_allocator()};
+///  rz_segarr_push(&nodes, (Node){.id = 1});
+///  Node *first = rz_segarr_at(&nodes, 0); // stay valid after more push
+///  rz_segarr_foreach(it, &nodes) { visit(it); }
+///  rz_segarr_free(&nodes);
+///
+#    ifndef RZ_SEGARR_FIRST_SHIFT
+/// the first segment has `1 << RZ_SEGARR_FIRST_SHIFT` items
+#        define RZ_SEGARR_FIRST_SHIFT 4U
+#    endif
+#    define RZ__SEGARR_MAX_SEGMENTS       ((sizeof(rz_usize) * 8U) - RZ_SEGARR_FIRST_SHIFT)
+
+#    define RZ__SEGARR_STRUCT_MEMBERS(T)                                         \
+        /* segments - the segment `k` has `1 << (k + FIRST_SHIFT)` items */   \
+        T           *segments[RZ__SEGARR_MAX_SEGMENTS];                        \
+        /* len - the amount of items in the array */                           \
+        rz_usize     len;                                                      \
+        /* capacity - the sum of the capacity of the allocated segments */     \
+        rz_usize     capacity;                                                 \
+        /* allocator - the allocator of the segments */                        \
+        RZ_Allocator allocator
+
+#    define RZ_SegArray(T)                  \
+        struct {                            \
+            RZ__SEGARR_STRUCT_MEMBERS(T);   \
+        }
+
+/// the segment of the index `i`
+static inline rz_u32 rz__segarr_segment(rz_usize i) {
+    return (rz_u32)(63u - rz_clz64((rz_u64)i + ((rz_u64)1 << RZ_SEGARR_FIRST_SHIFT))) - RZ_SEGARR_FIRST_SHIFT;
+}
+/// the amount of items in the segment `k`
+#    define rz__segarr_segment_capacity(k) ((rz_usize)1 << ((k) + RZ_SEGARR_FIRST_SHIFT))
+
+// clang-format off
+///    void rz_segarr_free(RZ_SegArray(T) *sa);
+#    define rz_segarr_free(sa)                 rz__segarr_free((RZ_SegArrayOpaque *)(sa), sizeof(**(sa)->segments))
+///  the segments is kept for the next push.
+#    define rz_segarr_clear(sa)                ((sa)->len = 0)
+#    define rz_segarr_is_empty(sa)             ((sa)->len == 0)
+
+///  allocate the segments until the capacity is at least `capacity`
+///    void rz_segarr_reserve(RZ_SegArray(T) *sa, rz_usize capacity);
+#    define rz_segarr_reserve(sa, capacity)    rz__segarr_reserve((RZ_SegArrayOpaque *)(sa), sizeof(**(sa)->segments), (capacity))
+
+///  get pointer of item at index. crash if idx is out of bound.
+///      T* rz_segarr_at(RZ_SegArray(T) *sa, rz_usize idx);
+///      T* rz_segarr_get(RZ_SegArray(T) *sa, rz_usize idx); // NULL if idx is out of bound
+#    define rz_segarr_at(sa, idx)              ((RZ_TYPEOF((sa)->segments[0]))rz__segarr_at((void *const *)(sa)->segments, sizeof(**(sa)->segments), (RZ_ASSERT((rz_usize)(idx) < (sa)->len, "rz_segarr_at: index out of bounds"), (idx))))
+#    define rz_segarr_get(sa, idx)             (((rz_usize)(idx) < (sa)->len) ? rz_segarr_at(sa, idx) : NULL)
+
+///  push item at the end of the array, O(1) and never move the other items.
+///    void rz_segarr_push(RZ_SegArray(T) *sa, T item);
+#    define rz_segarr_push(sa, ...)            do { if ((sa)->len == (sa)->capacity) rz_segarr_reserve(sa, (sa)->len + 1); (sa)->len++; *rz_segarr_at(sa, (sa)->len - 1) = __VA_ARGS__; } while (0)
+#    define rz_segarr_append                   rz_segarr_push
+
+///  push several items at the end of the array (one memcpy per segment)
+///    void rz_segarr_append_many(RZ_SegArray(T) *sa, T *items, rz_usize items_len);
+#    define rz_segarr_append_many(sa, items, items_len) do { RZ_STATIC_ASSERT_TYPE_COMPATIBLE(**(sa)->segments, *items); rz__segarr_append_many((RZ_SegArrayOpaque *)(sa), sizeof(**(sa)->segments), (items), (items_len)); } while (0)
+
+///  pop the last item, crash if the array is empty.
+///       T rz_segarr_pop(RZ_SegArray(T) *sa);
+#    define rz_segarr_pop(sa)                  (*(RZ_ASSERT((sa)->len > 0, "try to pop empty segarray"), (sa)->len--, (RZ_TYPEOF((sa)->segments[0]))rz__segarr_at((void *const *)(sa)->segments, sizeof(**(sa)->segments), (sa)->len)))
+
+///  iterate item from the array in index order, segment by segment (no bit scan per item).
+///     rz_segarr_foreach(it_item, &sa) {
+///         printf("item: %d", *it_item);
+///     }
+#    define rz_segarr_foreach(it, sa)                                                                                                                     \
+        for (rz_usize it##_seg = 0, it##_left = (sa)->len, it##_brk = 0; !it##_brk && it##_left > 0; ++it##_seg)                                           \
+            for (RZ_TYPEOF((sa)->segments[0]) it = (sa)->segments[it##_seg], it##_end = it + RZ_MIN(it##_left, rz__segarr_segment_capacity(it##_seg)); \
+                 (it##_brk = (it < it##_end)) || ((it##_left -= (rz_usize)(it##_end - (sa)->segments[it##_seg])), false);                                  \
+                 ++it)
+// clang-format on
+
+///////////////
+/// SlotMap Macors helpers
+///
+/// RZ_SlotMap(T) store the items densely packed in `data[0 .. len)` (cache friendly iteration) and give
+/// stable 64 bit handle `(generation << 32) | slot` for every inserted item. insert, remove and get is O(1).
+/// remove is swap-remove, the last item is moved into the hole and its slot is updated through the
+/// back index `dense_slot`, so the handles of other items stay valid. the slot of removed item is reused
+/// with the next generation, so the old handle (and every copy of it) is detected as stale.
+///
+/// Example:
+///  RZ_SlotMap(Entity) entities = {.allocator = rz_std_allocator()};
+///  RZ_SlotHandle player = rz_slotmap_insert(&entities, (Entity){.hp = 100});
+///  Entity *e = rz_slotmap_get(&entities, player);  // NULL if `player` is removed
+///  rz_slotmap_remove(&entities, player);
+///  rz_slotmap_foreach(it, &entities) { update(it); }
+///  rz_slotmap_free(&entities);
+///
+typedef rz_u64 RZ_SlotHandle;
+/// never returned by rz_slotmap_insert (the generation of live item is odd)
+#    define RZ_SLOT_HANDLE_NONE ((RZ_SlotHandle)0)
+
+#    define RZ__SLOTMAP_STRUCT_MEMBERS(T)                                            \
+        /* data - the items, densely packed */                                     \
+        T                *data;                                                    \
+        /* len - the amount of items in the slot map */                            \
+        rz_usize          len;                                                     \
+        /* capacity - the capacity of `data` and `dense_slot` */                   \
+        rz_usize          capacity;                                                \
+        /* dense_slot - back index, slot index of `data[i]` */                     \
+        rz_u32           *dense_slot;                                              \
+        /* slots - generation and dense index (or next free slot) of every slot */ \
+        struct RZ__Slot  *slots;                                                   \
+        rz_u32            slots_len;                                               \
+        rz_u32            slots_capacity;                                          \
+        /* free_head - first free slot, RZ_U32_MAX if there is no free slot */      \
+        rz_u32            free_head;                                               \
+        RZ_SlotHandle     __temp;                                                  \
+        /* allocator - the allocator of the slot map */                            \
+        RZ_Allocator      allocator
+
+#    define RZ_SlotMap(T)                    \
+        struct {                             \
+            RZ__SLOTMAP_STRUCT_MEMBERS(T);   \
+        }
+
+#    define rz_slot_handle_index(h)          ((rz_u32)((h) & RZ_U32_MAX))
+#    define rz_slot_handle_generation(h)     ((rz_u32)((h) >> 32U))
+
+///    void rz_slotmap_free(RZ_SlotMap(T) *sm);
+///    void rz_slotmap_clear(RZ_SlotMap(T) *sm);   // every handle is invalidated
+#    define rz_slotmap_free(sm)              rz__slotmap_free((RZ_SlotMapOpaque *)(sm), sizeof(*(sm)->data))
+#    define rz_slotmap_clear(sm)             rz__slotmap_clear((RZ_SlotMapOpaque *)(sm))
+#    define rz_slotmap_is_empty(sm)          ((sm)->len == 0)
+
+///  insert the item and return its handle.
+///    RZ_SlotHandle rz_slotmap_insert(RZ_SlotMap(T) *sm, T item);
+#    define rz_slotmap_insert(sm, ...)       ((sm)->__temp = rz__slotmap_insert((RZ_SlotMapOpaque *)(sm), sizeof(*(sm)->data)), (sm)->data[(sm)->len - 1] = __VA_ARGS__, (sm)->__temp)
+
+///  get pointer to the item of the handle, NULL if the handle is stale or invalid.
+///  the pointer is valid until the next insert or remove.
+///       T* rz_slotmap_get(RZ_SlotMap(T) *sm, RZ_SlotHandle h);
+///     bool rz_slotmap_contains(RZ_SlotMap(T) *sm, RZ_SlotHandle h);
+#    define rz_slotmap_get(sm, h)            ((RZ_TYPEOF((sm)->data))rz__slotmap_get((const RZ_SlotMapOpaque *)(sm), sizeof(*(sm)->data), (h)))
+#    define rz_slotmap_contains(sm, h)       (rz__slotmap_dense_index((const RZ_SlotMapOpaque *)(sm), (h)) != RZ_NOT_FOUND)
+
+///  remove the item of the handle, return false if the handle is stale or invalid.
+///    bool rz_slotmap_remove(RZ_SlotMap(T) *sm, RZ_SlotHandle h);
+#    define rz_slotmap_remove(sm, h)         rz__slotmap_remove((RZ_SlotMapOpaque *)(sm), sizeof(*(sm)->data), (h))
+
+///  handle of the item `data[i]`, e.g. to remove items while iterating.
+///    RZ_SlotHandle rz_slotmap_handle_at(RZ_SlotMap(T) *sm, rz_usize i);
+#    define rz_slotmap_handle_at(sm, i)      (RZ_ASSERT((i) < (sm)->len), rz__slot_handle((sm)->dense_slot[i], (sm)->slots[(sm)->dense_slot[i]].generation))
+
+///  iterate the items in dense order (not insertion order).
+///     rz_slotmap_foreach(it, &sm) { ... }
+#    define rz_slotmap_foreach(it, sm)       for (RZ_TYPEOF((sm)->data) it = (sm)->data; it < (sm)->data + (sm)->len; ++it)
+
+///////////////
+/// SparseSet
+///
+/// set of integer ids (e.g. entity index), O(1) insert, remove, contains and clear,
+/// the ids is densely packed in `dense[0 .. len)` for iteration. `sparse[id]` is the index of `id` in `dense`.
+/// memory is proportional to the biggest id inserted.
+///
+/// Example:
+///  RZ_SparseSet ss = {.allocator = rz_std_allocator()};
+///  rz_sparse_set_insert(&ss, 42);
+///  if (rz_sparse_set_contains(&ss, 42)) { ... }
+///  for (rz_usize i = 0; i < ss.len; ++i) printf("%u\n", ss.dense[i]);
+///  rz_sparse_set_free(&ss);
+///
+typedef struct {
+    rz_u32      *dense;
+    rz_usize     len;
+    rz_usize     capacity;
+    rz_u32      *sparse;
+    rz_usize     sparse_capacity;
+    RZ_Allocator allocator;
+} RZ_SparseSet;
+
+RZ_DEC void rz_sparse_set_free(RZ_SparseSet *ss);
+/// return true if `id` is new
+RZ_DEC bool rz_sparse_set_insert(RZ_SparseSet *ss, rz_u32 id);
+/// return false if `id` is not in the set. the last id is moved into the place of `id`.
+RZ_DEC bool rz_sparse_set_remove(RZ_SparseSet *ss, rz_u32 id);
+/// index of `id` in `dense`, RZ_NOT_FOUND if `id` is not in the set.
+RZ_DEC rz_usize rz_sparse_set_index_of(const RZ_SparseSet *ss, rz_u32 id);
+#    define rz_sparse_set_contains(ss, id)  (rz_sparse_set_index_of(ss, id) != RZ_NOT_FOUND)
+#    define rz_sparse_set_clear(ss)         ((ss)->len = 0)
+
+///////////////
+/// SoA (struct of arrays) Macors helpers
+///
+/// RZ_SOA_DEFINE(Name, (T, field), ...) generate the container `Name` that store every field in its own
+/// column (`T *field`), so the loop that only read one or two fields does not pull the other fields into the cache.
+/// all the columns share one allocation (the start of every column is aligned to max_align_t).
+/// the item (the array of structs element) type is `Name##Item`, and the generated functions is prefixed by `Name`:
+///
+///    void     Name_reserve(Name *s, rz_usize capacity);
+///    void     Name_resize(Name *s, rz_usize len);               // the new items is zeroed
+///    void     Name_push(Name *s, NameItem item);
+///    NameItem Name_get(const Name *s, rz_usize index);
+///    void     Name_set(Name *s, rz_usize index, NameItem item);
+///    void     Name_remove_unordered(Name *s, rz_usize index);   // the last item is moved into `index`
+///    void     Name_clear(Name *s);
+///    void     Name_free(Name *s);
+///    void     Name_from_aos(Name *s, const NameItem *items, rz_usize len); // append the items
+///    void     Name_to_aos(const Name *s, NameItem *out);        // `out` must have room for `s->len` items
+///
+/// Example:
+///  RZ_SOA_DEFINE(Particles, (float, x), (float, y), (rz_u32, id));
+///  Particles ps = {.allocator = rz_std_allocator()};
+///  Particles_push(&ps, (ParticlesItem){.x = 1, .y = 2, .id = 7});
+///  typedef RZ_ArrayView(float) FloatView;
+///  FloatView xs = rz_soa_column(FloatView, &ps, x);
+///  float sum = 0;
+///  for (rz_usize i = 0; i < xs.len; ++i) sum += xs.data[i];
+///  Particles_free(&ps);
+///
+/// NOTE: max 20 fields (RZ_FOR_EACH), a column pointer is invalidated by reserve/resize/push.
+///
+// clang-format off
+#    define RZ__SOA_ITEM_FIELD(tf)      RZ__SOA_ITEM_FIELD_ tf
+#    define RZ__SOA_ITEM_FIELD_(T, f)   T f
+#    define RZ__SOA_COLUMN(tf)          RZ__SOA_COLUMN_ tf
+#    define RZ__SOA_COLUMN_(T, f)       T *f
+#    define RZ__SOA_SIZEOF(tf)          RZ__SOA_SIZEOF_ tf
+#    define RZ__SOA_SIZEOF_(T, f)       sizeof(T),
+#    define RZ__SOA_GET(tf)             RZ__SOA_GET_ tf
+#    define RZ__SOA_GET_(T, f)          .f = s->f[index],
+#    define RZ__SOA_SET(tf)             RZ__SOA_SET_ tf
+#    define RZ__SOA_SET_(T, f)          s->f[index] = item.f
+
+#    define RZ_SOA_DEFINE(Name, ...)                                                                                    \
+        typedef struct { RZ_FOR_EACH(;, RZ__SOA_ITEM_FIELD, __VA_ARGS__); } Name##Item;                                 \
+        typedef struct {                                                                                                \
+            rz_usize     len;                                                                                           \
+            rz_usize     capacity;                                                                                      \
+            RZ_Allocator allocator;                                                                                     \
+            union {                                                                                                     \
+                struct { RZ_FOR_EACH(;, RZ__SOA_COLUMN, __VA_ARGS__); };                                                \
+                void *columns[RZ_NARGS(__VA_ARGS__)];                                                                   \
+            };                                                                                                          \
+        } Name;                                                                                                         \
+        static const rz_usize Name##__sizes[] = { RZ_FOR_EACH(, RZ__SOA_SIZEOF, __VA_ARGS__) };                         \
+        static inline void Name##_reserve(Name *s, rz_usize capacity) {                                                 \
+            rz__soa_reserve((RZ_SoaOpaque *)s, Name##__sizes, RZ_ARRAY_LEN(Name##__sizes), capacity);                   \
+        }                                                                                                               \
+        static inline void Name##_resize(Name *s, rz_usize len) {                                                       \
+            rz__soa_resize((RZ_SoaOpaque *)s, Name##__sizes, RZ_ARRAY_LEN(Name##__sizes), len);                         \
+        }                                                                                                               \
+        static inline void Name##_push(Name *s, Name##Item item) {                                                      \
+            if (s->len >= s->capacity) Name##_reserve(s, s->len + 1);                                                   \
+            rz_usize index = s->len++;                                                                                  \
+            RZ_FOR_EACH(;, RZ__SOA_SET, __VA_ARGS__);                                                                   \
+        }                                                                                                               \
+        static inline Name##Item Name##_get(const Name *s, rz_usize index) {                                            \
+            RZ_DBG_ASSERT(index < s->len);                                                                              \
+            return (Name##Item){ RZ_FOR_EACH(, RZ__SOA_GET, __VA_ARGS__) };                                             \
+        }                                                                                                               \
+        static inline void Name##_set(Name *s, rz_usize index, Name##Item item) {                                       \
+            RZ_DBG_ASSERT(index < s->len);                                                                              \
+            RZ_FOR_EACH(;, RZ__SOA_SET, __VA_ARGS__);                                                                   \
+        }                                                                                                               \
+        static inline void Name##_remove_unordered(Name *s, rz_usize index) {                                           \
+            rz__soa_remove_unordered((RZ_SoaOpaque *)s, Name##__sizes, RZ_ARRAY_LEN(Name##__sizes), index);             \
+        }                                                                                                               \
+        static inline void Name##_clear(Name *s) { s->len = 0; }                                                        \
+        static inline void Name##_free(Name *s) {                                                                       \
+            rz__soa_free((RZ_SoaOpaque *)s, Name##__sizes, RZ_ARRAY_LEN(Name##__sizes));                                \
+        }                                                                                                               \
+        static inline void Name##_from_aos(Name *s, const Name##Item *items, rz_usize len) {                            \
+            Name##_reserve(s, s->len + len);                                                                            \
+            for (rz_usize i = 0; i < len; ++i) Name##_push(s, items[i]);                                                \
+        }                                                                                                               \
+        static inline void Name##_to_aos(const Name *s, Name##Item *out) {                                              \
+            for (rz_usize i = 0; i < s->len; ++i) out[i] = Name##_get(s, i);                                            \
+        }                                                                                                               \
+        typedef int Name##__require_semicolon
+
+///  get the column of the field as view, to pass it to the function that accept RZ_ArrayView(T).
+///    RZ_ArrayView(T) rz_soa_column(view_type, Name *s, field);
+#    define rz_soa_column(view_type, s, field)  ((view_type){.data = (s)->field, .len = (s)->len})
+// clang-format on
+
 ///////////////
 /// Hm (HashMap) & Hs (HashSet) Macors helpers
 ///
@@ -532,11 +1231,129 @@ RZ_DEC void *rz__arr_remove(void *data, rz_usize *len, rz_usize type_size, rz_us
 
 RZ_DEC rz_usize rz__arr_find(const RZ_ArrayViewOpaque *arr, void const *item, rz_usize elemsize);
 RZ_DEC rz_usize rz__arr_rfind(const RZ_ArrayViewOpaque *arr, void const *item, rz_usize elemsize);
+RZ_DEC rz_usize rz__arr_count(const RZ_ArrayViewOpaque *arr, void const *item, rz_usize elemsize);
+RZ_DEC rz_usize rz__arr_find_all(const RZ_ArrayViewOpaque *arr, void const *item, rz_usize elemsize, RZ_ArrayOpaque *indices);
 RZ_DEC rz_usize rz__arr_find_by(const RZ_ArrayViewOpaque *arr, RZ__ArrFindPatternFn pat, void const *pat_data, rz_usize elemsize);
 RZ_DEC rz_usize rz__arr_rfind_by(const RZ_ArrayViewOpaque *arr, RZ__ArrFindPatternFn pat, void const *pat_data, rz_usize elemsize);
 
+/// sized kernels for element of 1, 2, 4 and 8 bytes (SSE2/AVX2 with scalar fallback).
+/// the comparison is bitwise, same as memcmp.
+RZ_DEC rz_usize rz__arr_find_8(const void *data, rz_usize len, void const *item);
+RZ_DEC rz_usize rz__arr_find_16(const void *data, rz_usize len, void const *item);
+RZ_DEC rz_usize rz__arr_find_32(const void *data, rz_usize len, void const *item);
+RZ_DEC rz_usize rz__arr_find_64(const void *data, rz_usize len, void const *item);
+RZ_DEC rz_usize rz__arr_rfind_8(const void *data, rz_usize len, void const *item);
+RZ_DEC rz_usize rz__arr_rfind_16(const void *data, rz_usize len, void const *item);
+RZ_DEC rz_usize rz__arr_rfind_32(const void *data, rz_usize len, void const *item);
+RZ_DEC rz_usize rz__arr_rfind_64(const void *data, rz_usize len, void const *item);
+RZ_DEC rz_usize rz__arr_count_8(const void *data, rz_usize len, void const *item);
+RZ_DEC rz_usize rz__arr_count_16(const void *data, rz_usize len, void const *item);
+RZ_DEC rz_usize rz__arr_count_32(const void *data, rz_usize len, void const *item);
+RZ_DEC rz_usize rz__arr_count_64(const void *data, rz_usize len, void const *item);
+
 RZ_DEC rz_usize rz__arr_bsearch(const RZ_ArrayViewOpaque *data, rz_usize elemsize, void const *needle, int (*cmpfunc)(void const *, void const *));
 
+///////////////
+/// SmallArray Imlementation details
+///
+typedef struct {
+    /// allocator used when the items is spilled from the inline storage
+    RZ_Allocator backing;
+    void        *inline_data;
+    /// size of the inline storage in bytes
+    rz_usize     inline_size;
+    /// true if the inline storage is handed out to `data`
+    bool         inline_used;
+} RZ__SmallArrayStorage;
+
+RZ_DEC void rz__sarr_init(RZ_ArrayOpaque *sa, RZ__SmallArrayStorage *storage, void *inline_data, rz_usize inline_capacity, rz_usize elemsize, RZ_Allocator allocator);
+
+///////////////
+/// Deque Imlementation details
+///
+typedef RZ_Deque(void) RZ_DequeOpaque;
+
+RZ_DEC void rz__dq_grow(RZ_DequeOpaque *dq, rz_usize elemsize, rz_usize additional);
+RZ_DEC void rz__dq_slices(const RZ_DequeOpaque *dq, rz_usize elemsize, RZ_ArrayViewOpaque *first, RZ_ArrayViewOpaque *second);
+RZ_DEC void rz__dq_push_back_many(RZ_DequeOpaque *dq, rz_usize elemsize, const void *items, rz_usize items_len);
+
+///////////////
+/// Heap Imlementation details
+///
+typedef RZ_Heap(void) RZ_HeapOpaque;
+
+RZ_DEC void          rz__heap_grow(RZ_HeapOpaque *h, rz_usize elemsize, rz_usize capacity);
+RZ_DEC void          rz__heap_free(RZ_HeapOpaque *h, rz_usize elemsize);
+RZ_DEC void          rz__heap_clear(RZ_HeapOpaque *h);
+#    define rz__heap_handle_slot(handle) ((rz_u32)((handle) & RZ_U32_MAX))
+/// assign new handle to the item at `pos`, enable the tracking of the handles on the first call.
+RZ_DEC RZ_HeapHandle rz__heap_handle_new(RZ_HeapOpaque *h, rz_usize pos);
+/// release the slot of the item that leave the heap, its handle is stale from now.
+RZ_DEC void          rz__heap_handle_release(RZ_HeapOpaque *h, rz_u32 slot);
+RZ_DEC bool          rz__heap_handle_valid(const RZ_HeapOpaque *h, RZ_HeapHandle handle);
+RZ_DEC void rz__arr_top_k(const RZ_ArrayViewOpaque *a, rz_usize elemsize, rz_usize k, int (*cmpfunc)(const void *, const void *), RZ_ArrayOpaque *out);
+
+///////////////
+/// StaticSearch Imlementation details
+///
+typedef RZ_StaticSearch(void) RZ_StaticSearchOpaque;
+
+RZ_DEC void rz__static_search_build(RZ_StaticSearchOpaque *s, rz_usize elemsize, const void *sorted, rz_usize len);
+RZ_DEC void rz__static_search_free(RZ_StaticSearchOpaque *s, rz_usize elemsize);
+
+RZ_STATIC_SEARCH_DEFINE(RZ_StaticSearchU32, rz_u32, rz_u32, RZ__STATIC_SEARCH_KEY);
+RZ_STATIC_SEARCH_DEFINE(RZ_StaticSearchU64, rz_u64, rz_u64, RZ__STATIC_SEARCH_KEY);
+RZ_STATIC_SEARCH_DEFINE(RZ_StaticSearchF64, rz_f64, rz_f64, RZ__STATIC_SEARCH_KEY);
+
+///////////////
+/// SegArray Imlementation details
+///
+typedef RZ_SegArray(void) RZ_SegArrayOpaque;
+
+static inline void *rz__segarr_at(void *const *segments, rz_usize elemsize, rz_usize i) {
+    rz_u32 k = rz__segarr_segment(i);
+    return (rz_u8 *)segments[k] + ((i + rz__segarr_segment_capacity(0) - rz__segarr_segment_capacity(k)) * elemsize);
+}
+
+RZ_DEC void rz__segarr_free(RZ_SegArrayOpaque *sa, rz_usize elemsize);
+RZ_DEC void rz__segarr_reserve(RZ_SegArrayOpaque *sa, rz_usize elemsize, rz_usize capacity);
+RZ_DEC void rz__segarr_append_many(RZ_SegArrayOpaque *sa, rz_usize elemsize, const void *items, rz_usize items_len);
+
+///////////////
+/// SlotMap Imlementation details
+///
+struct RZ__Slot {
+    /// odd: the slot is alive, even: the slot is free.
+    rz_u32 generation;
+    /// alive: index of the item in `data`, free: next free slot
+    rz_u32 index;
+};
+typedef RZ_SlotMap(void) RZ_SlotMapOpaque;
+
+#    define rz__slot_handle(index, generation) ((((RZ_SlotHandle)(generation)) << 32U) | (RZ_SlotHandle)(index))
+
+RZ_DEC void          rz__slotmap_free(RZ_SlotMapOpaque *sm, rz_usize elemsize);
+RZ_DEC void          rz__slotmap_clear(RZ_SlotMapOpaque *sm);
+RZ_DEC RZ_SlotHandle rz__slotmap_insert(RZ_SlotMapOpaque *sm, rz_usize elemsize);
+RZ_DEC rz_usize      rz__slotmap_dense_index(const RZ_SlotMapOpaque *sm, RZ_SlotHandle h);
+RZ_DEC void         *rz__slotmap_get(const RZ_SlotMapOpaque *sm, rz_usize elemsize, RZ_SlotHandle h);
+RZ_DEC bool          rz__slotmap_remove(RZ_SlotMapOpaque *sm, rz_usize elemsize, RZ_SlotHandle h);
+
+///////////////
+/// SoA Imlementation details
+///
+typedef struct {
+    rz_usize     len;
+    rz_usize     capacity;
+    RZ_Allocator allocator;
+    void        *columns[];
+} RZ_SoaOpaque;
+
+RZ_DEC void rz__soa_reserve(RZ_SoaOpaque *s, const rz_usize *sizes, rz_usize ncolumns, rz_usize capacity);
+RZ_DEC void rz__soa_resize(RZ_SoaOpaque *s, const rz_usize *sizes, rz_usize ncolumns, rz_usize len);
+RZ_DEC void rz__soa_remove_unordered(RZ_SoaOpaque *s, const rz_usize *sizes, rz_usize ncolumns, rz_usize index);
+RZ_DEC void rz__soa_free(RZ_SoaOpaque *s, const rz_usize *sizes, rz_usize ncolumns);
+
 ///////////////
 /// Hm (HashMap) & Hs (HashSet) Imlementation details
 ///
@@ -255,11 +255,34 @@
 #        define RZ_TARGET_COMPILER_GCC 0
 #    endif
 
+/* SIMD detection (compile time). define RZ_NO_SIMD to force the scalar paths */
+#    if !defined(RZ_NO_SIMD)
+#        if RZ_TARGET_ARCH_X86_64 || (RZ_TARGET_ARCH_X86 && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#            define RZ_TARGET_SIMD_SSE2 1
+#        endif
+#        if defined(__AVX2__)
+#            define RZ_TARGET_SIMD_AVX2 1
+#        endif
+#        if RZ_TARGET_ARCH_AARCH64 || (RZ_TARGET_ARCH_ARM && defined(__ARM_NEON))
+#            define RZ_TARGET_SIMD_NEON 1
+#        endif
+#    endif
+#    ifndef RZ_TARGET_SIMD_SSE2
+#        define RZ_TARGET_SIMD_SSE2 0
+#    endif
+#    ifndef RZ_TARGET_SIMD_AVX2
+#        define RZ_TARGET_SIMD_AVX2 0
+#    endif
+#    ifndef RZ_TARGET_SIMD_NEON
+#        define RZ_TARGET_SIMD_NEON 0
+#    endif
+
 #    define RZ_TARGET_BITS(A)       RZ_TARGET_BITS_##A
 #    define RZ_TARGET_ARCH(A)       RZ_TARGET_ARCH_##A
 #    define RZ_TARGET_OS(A)         RZ_TARGET_OS_##A
 #    define RZ_TARGET_FAMILY(A)     RZ_TARGET_FAMILY_##A
 #    define RZ_TARGET_COMPILER(A)   RZ_TARGET_COMPILER_##A
+#    define RZ_TARGET_SIMD(A)       RZ_TARGET_SIMD_##A
 
 #    define RZ_TARGET(TGT, V)       RZ_TARGET_##TGT(V)
 #    define RZ_TARGET_ANY(TGT, ...) (RZ_ANY(RZ_TARGET_##TGT, __VA_ARGS__))
@@ -275,6 +298,7 @@
 #        include <fcntl.h>
 #        include <malloc.h>
 #        include <pwd.h>
+#        include <sys/mman.h>
 #        include <sys/stat.h>
 #        include <sys/types.h>
 #        include <sys/wait.h>
@@ -300,6 +324,15 @@
 #    include <string.h>
 #    include <threads.h>
 
+#    if RZ_TARGET_SIMD_AVX2
+#        include <immintrin.h>
+#    elif RZ_TARGET_SIMD_SSE2
+#        include <emmintrin.h>
+#    endif
+#    if RZ_TARGET_SIMD_NEON
+#        include <arm_neon.h>
+#    endif
+
 #    if defined(__has_attribute)
 #        define RZ_HAS_ATTR __has_attribute
 #    else
@@ -550,6 +583,37 @@ typedef int       rz_int;
 #    define RZ_MAX(A, B) (((A) > (B)) ? (A) : (B))
 #    define RZ_MIN(A, B) (((A) < (B)) ? (A) : (B))
 
+// clang-format off
+/// bit scan helpers. the result of ctz/clz is undefined when `x` is zero.
+#    if RZ_TARGET_COMPILER_MSVC
+static inline rz_u32 rz_ctz32(rz_u32 x) { unsigned long r; _BitScanForward(&r, x); return (rz_u32)r; }
+static inline rz_u32 rz_clz32(rz_u32 x) { unsigned long r; _BitScanReverse(&r, x); return 31u - (rz_u32)r; }
+static inline rz_u32 rz_ctz64(rz_u64 x) { unsigned long r; _BitScanForward64(&r, x); return (rz_u32)r; }
+static inline rz_u32 rz_clz64(rz_u64 x) { unsigned long r; _BitScanReverse64(&r, x); return 63u - (rz_u32)r; }
+static inline rz_u32 rz_popcount32(rz_u32 x) { return (rz_u32)__popcnt(x); }
+static inline rz_u32 rz_popcount64(rz_u64 x) { return (rz_u32)__popcnt64(x); }
+#    else
+static inline rz_u32 rz_ctz32(rz_u32 x) { return (rz_u32)__builtin_ctz(x); }
+static inline rz_u32 rz_clz32(rz_u32 x) { return (rz_u32)__builtin_clz(x); }
+static inline rz_u32 rz_ctz64(rz_u64 x) { return (rz_u32)__builtin_ctzll(x); }
+static inline rz_u32 rz_clz64(rz_u64 x) { return (rz_u32)__builtin_clzll(x); }
+static inline rz_u32 rz_popcount32(rz_u32 x) { return (rz_u32)__builtin_popcount(x); }
+static inline rz_u32 rz_popcount64(rz_u64 x) { return (rz_u32)__builtin_popcountll(x); }
+#    endif
+#    define rz_is_pow2(x)    (((x) != 0) && (((x) & ((x) - 1)) == 0))
+/// round up to the next power of two (x <= 2^63). rz_next_pow2(0) == 1
+static inline rz_u64 rz_next_pow2(rz_u64 x) { return (x <= 1) ? 1 : ((rz_u64)1 << (64u - rz_clz64(x - 1))); }
+
+/// hint to load the cache line of `addr` for read, never fault (the address can be out of the object).
+#    if RZ_HAS_BUILTIN(__builtin_prefetch)
+#        define rz_prefetch(addr) __builtin_prefetch((const void *)(addr), 0, 3)
+#    elif RZ_TARGET_SIMD_SSE2
+#        define rz_prefetch(addr) _mm_prefetch((const char *)(addr), _MM_HINT_T0)
+#    else
+#        define rz_prefetch(addr) RZ_UNUSED(addr)
+#    endif
+// clang-format on
+
 // defined RZ_WINDOWS_MSGBOX_ERROR if you want panic using windows MessageBox
 RZ_DEF RZ_NORETURN void rz_panic_impl(const char *loc, RZ_PRINTF_FMT(const char *fmt), ...) RZ_PRINTF_FORMAT(2, 3);
 
@@ -0,0 +1,355 @@
+#include "rz_csv.h"
+#include "rz_error.h"
+
+#ifdef RZ_CSV_IMPL
+
+#    define RZ_TAG            "rz_csv"
+#    define RZ__CSV_BLOCK     64u
+
+#    if RZ_TARGET_SIMD_SSE2 && defined(__PCLMUL__)
+#        include <wmmintrin.h>
+#    endif
+
+// bit i is the parity of the set bits [0, i] of `x`, so the bits between the open and the close quote is set
+static inline rz_u64 rz__csv_prefix_xor(rz_u64 x) {
+#    if RZ_TARGET_SIMD_SSE2 && defined(__PCLMUL__) && RZ_TARGET_ARCH_X86_64
+    // the carry-less multiply by all ones is the xor of every left shift of `x`
+    return (rz_u64)_mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_set_epi64x(0, (long long)x), _mm_set1_epi8((char)0xFF), 0));
+#    elif RZ_TARGET_SIMD_NEON && RZ_TARGET_ARCH_AARCH64 && defined(__ARM_FEATURE_AES)
+    return (rz_u64)vmull_p64((poly64_t)x, (poly64_t)RZ_U64_MAX);
+#    else
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+#    endif
+}
+
+typedef struct {
+    rz_u64 delimiter;
+    rz_u64 quote;
+    rz_u64 newline;
+} RZ__CsvBits;
+
+#    if RZ_TARGET_SIMD_NEON && RZ_TARGET_ARCH_AARCH64
+// the movemask of 4 compare results (64 bytes): keep one weight bit per byte and add the neighbours 3 times
+static inline rz_u64 rz__csv_neon_mask(uint8x16_t a, uint8x16_t b, uint8x16_t c, uint8x16_t d) {
+    const uint8x16_t weight = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t       ab     = vpaddq_u8(vandq_u8(a, weight), vandq_u8(b, weight));
+    uint8x16_t       cd     = vpaddq_u8(vandq_u8(c, weight), vandq_u8(d, weight));
+    uint8x16_t       sum    = vpaddq_u8(ab, cd);
+    sum                     = vpaddq_u8(sum, sum);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+}
+#    endif
+
+// classify the 64 bytes at `p`
+static inline RZ__CsvBits rz__csv_classify(const rz_char *p, rz_char delimiter, rz_char quote) {
+    RZ__CsvBits bits = {0};
+#    if RZ_TARGET_SIMD_AVX2
+    __m256i lo = _mm256_loadu_si256((const __m256i *)p), hi = _mm256_loadu_si256((const __m256i *)(p + 32));
+#        define RZ__CSV_EQ(c)                                                                 \
+            ((rz_u64)(rz_u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, _mm256_set1_epi8(c))) | \
+             ((rz_u64)(rz_u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, _mm256_set1_epi8(c))) << 32))
+#    elif RZ_TARGET_SIMD_SSE2
+    __m128i v0 = _mm_loadu_si128((const __m128i *)p), v1 = _mm_loadu_si128((const __m128i *)(p + 16));
+    __m128i v2 = _mm_loadu_si128((const __m128i *)(p + 32)), v3 = _mm_loadu_si128((const __m128i *)(p + 48));
+#        define RZ__CSV_EQ16(v, c, shift) ((rz_u64)(rz_u32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c))) << (shift))
+#        define RZ__CSV_EQ(c)             (RZ__CSV_EQ16(v0, c, 0) | RZ__CSV_EQ16(v1, c, 16) | RZ__CSV_EQ16(v2, c, 32) | RZ__CSV_EQ16(v3, c, 48))
+#    elif RZ_TARGET_SIMD_NEON && RZ_TARGET_ARCH_AARCH64
+    uint8x16_t v0 = vld1q_u8((const rz_u8 *)p), v1 = vld1q_u8((const rz_u8 *)(p + 16));
+    uint8x16_t v2 = vld1q_u8((const rz_u8 *)(p + 32)), v3 = vld1q_u8((const rz_u8 *)(p + 48));
+#        define RZ__CSV_EQ(c)                                                                                   \
+            rz__csv_neon_mask(vceqq_u8(v0, vdupq_n_u8((rz_u8)(c))), vceqq_u8(v1, vdupq_n_u8((rz_u8)(c))), \
+                              vceqq_u8(v2, vdupq_n_u8((rz_u8)(c))), vceqq_u8(v3, vdupq_n_u8((rz_u8)(c))))
+#    endif
+#    ifdef RZ__CSV_EQ
+    bits.delimiter = RZ__CSV_EQ(delimiter);
+    bits.quote     = RZ__CSV_EQ(quote);
+    bits.newline   = RZ__CSV_EQ('\n');
+#        undef RZ__CSV_EQ
+#        undef RZ__CSV_EQ16
+#    else
+    for (rz_u32 i = 0; i < RZ__CSV_BLOCK; ++i) {
+        rz_u64 bit      = (rz_u64)1 << i;
+        bits.delimiter |= (p[i] == delimiter) ? bit : 0;
+        bits.quote     |= (p[i] == quote) ? bit : 0;
+        bits.newline   |= (p[i] == '\n') ? bit : 0;
+    }
+#    endif
+    return bits;
+}
+
+// classify the block at `offset`, the block past the end of `sv` is read from the zero padded copy
+static inline RZ__CsvBits rz__csv_classify_at(RZ_StrView sv, rz_usize offset, rz_char delimiter, rz_char quote) {
+    if ((offset + RZ__CSV_BLOCK) <= sv.len) return rz__csv_classify(sv.data + offset, delimiter, quote);
+    rz_char  tail[RZ__CSV_BLOCK] = {0};
+    rz_usize n                   = sv.len - offset;
+    memcpy(tail, sv.data + offset, n);
+    RZ__CsvBits bits  = rz__csv_classify(tail, delimiter, quote);
+    rz_u64      valid = ((rz_u64)1 << n) - 1; // n < 64
+    bits.delimiter   &= valid;
+    bits.quote       &= valid;
+    bits.newline     &= valid;
+    return bits;
+}
+
+static inline RZ_CsvOpt rz__csv_opt(RZ_CsvOpt opt) {
+    if (opt.delimiter == 0) opt.delimiter = ',';
+    if (opt.quote == 0) opt.quote = '"';
+    if (!rz_is_allocator(opt.allocator)) opt.allocator = rz_std_allocator();
+    RZ_ASSERT(opt.delimiter != '\n' && opt.quote != '\n' && opt.delimiter != opt.quote, "rz_csv: invalid delimiter/quote");
+    return opt;
+}
+
+RZ_DEF RZ_CsvReader rz_csv_reader_opt(RZ_StrView input, RZ_CsvOpt opt) {
+    opt = rz__csv_opt(opt);
+    return (RZ_CsvReader){.input = input, .opt = opt, .fields = {.allocator = opt.allocator}};
+}
+
+RZ_DEF void rz_csv_reader_free(RZ_CsvReader *r) {
+    RZ_ASSERT_NOT_NULL(r);
+    rz_arr_free(&r->fields);
+}
+
+// index the next block: the delimiters and the newlines outside the quotes
+static inline void rz__csv_index(RZ_CsvReader *r) {
+    RZ__CsvBits bits   = rz__csv_classify_at(r->input, r->next, r->opt.delimiter, r->opt.quote);
+    rz_u64      inside = rz__csv_prefix_xor(bits.quote) ^ r->inquote;
+    r->inquote         = (rz_u64)((rz_i64)inside >> 63);
+    r->ends            = (bits.delimiter | bits.newline) & ~inside;
+    r->block           = r->next;
+    r->next           += RZ__CSV_BLOCK;
+}
+
+// the hot state of rz_csv_next_row, in locals: the stores of the fields could alias the reader, every field
+// would reload `ends`, `field_start` and `fields.len` from it
+typedef struct {
+    rz_u64   ends;
+    rz_usize start;
+    rz_usize len;
+} RZ__CsvCursor;
+
+static inline void rz__csv_push_field(RZ_CsvReader *r, RZ__CsvCursor *c, rz_usize end, bool row_end) {
+    RZ_StrView field = rz_sv_sized(r->input.data + c->start, end - c->start);
+    if (row_end && field.len > 0 && field.data[field.len - 1] == '\r') field.len--;
+    // the check is inline, rz_arr_append call rz__arr_grow_impl for every field
+    if (c->len >= r->fields.capacity) rz_arr_reserve(&r->fields, c->len + 1);
+    r->fields.data[c->len++] = field;
+    c->start                 = end + 1;
+}
+
+RZ_DEF bool rz_csv_next_row(RZ_CsvReader *r, RZ_CsvRow *row) {
+    RZ_ASSERT_NOT_NULL(r);
+    RZ_ASSERT_NOT_NULL(row);
+    r->fields.len = 0;
+    if (r->done) return false;
+    RZ__CsvCursor c = {.ends = r->ends, .start = r->field_start};
+    for (;;) {
+        while (c.ends == 0) {
+            if (r->next >= r->input.len) {
+                // the last row without newline
+                r->done = true;
+                if (c.len == 0 && c.start >= r->input.len) return false;
+                rz__csv_push_field(r, &c, r->input.len, true);
+                goto row;
+            }
+            rz__csv_index(r);
+            c.ends = r->ends;
+        }
+        rz_usize pos  = r->block + rz_ctz64(c.ends);
+        c.ends       &= c.ends - 1;
+        bool row_end  = r->input.data[pos] == '\n';
+        rz__csv_push_field(r, &c, pos, row_end);
+        if (row_end) break;
+    }
+row:
+    r->ends        = c.ends;
+    r->field_start = c.start;
+    r->fields.len  = c.len;
+    *row           = (RZ_CsvRow){.data = r->fields.data, .len = c.len};
+    return true;
+}
+
+RZ_DEF RZ_StrView rz_csv_unquote(const RZ_CsvReader *r, RZ_StrView field, RZ_Str *scratch) {
+    RZ_ASSERT_NOT_NULL(r);
+    RZ_ASSERT_NOT_NULL(scratch);
+    rz_char quote = r->opt.quote;
+    if (field.len < 2 || field.data[0] != quote || field.data[field.len - 1] != quote) return field;
+    RZ_StrView inner = rz_sv_sized(field.data + 1, field.len - 2);
+    rz_usize   i     = rz_sv_find_char(inner, quote);
+    if (i == RZ_NOT_FOUND) return inner;
+
+    // every escaped quote is the doubled quote, keep one of them
+    scratch->len = 0;
+    while (i != RZ_NOT_FOUND) {
+        rz_str_append_sized_str(scratch, inner.data, i + 1);
+        rz_usize skip = (i + 1 < inner.len && inner.data[i + 1] == quote) ? i + 2 : i + 1;
+        inner         = rz_sv_sized(inner.data + skip, inner.len - skip);
+        i             = rz_sv_find_char(inner, quote);
+    }
+    rz_str_append_sized_str(scratch, inner.data, inner.len);
+    return rz_sv_from_str(scratch);
+}
+
+// the parity of the quotes in [from, to), all ones when it is odd
+static rz_u64 rz__csv_quote_parity(RZ_StrView sv, rz_usize from, rz_usize to, rz_char quote) {
+    rz_u32 count = 0;
+    for (; (from + RZ__CSV_BLOCK) <= to; from += RZ__CSV_BLOCK) count += rz_popcount64(rz__csv_classify(sv.data + from, '\n', quote).quote);
+    for (; from < to; ++from) count += sv.data[from] == quote;
+    return (count & 1u) ? RZ_U64_MAX : 0;
+}
+
+// the first byte after the newline that is outside the quotes at or after `from`, RZ_NOT_FOUND when there is none
+static rz_usize rz__csv_row_start(RZ_StrView sv, rz_usize from, rz_u64 inquote, rz_char quote) {
+    for (; from < sv.len; from += RZ__CSV_BLOCK) {
+        RZ__CsvBits bits   = rz__csv_classify_at(sv, from, '\n', quote);
+        rz_u64      inside = rz__csv_prefix_xor(bits.quote) ^ inquote;
+        rz_u64      ends   = bits.newline & ~inside;
+        if (ends != 0) return from + rz_ctz64(ends) + 1;
+        inquote = (rz_u64)((rz_i64)inside >> 63);
+    }
+    return RZ_NOT_FOUND;
+}
+
+RZ_DEF rz_usize rz_csv_chunks_opt(RZ_StrView input, RZ_StrView *chunks, rz_usize count, RZ_CsvOpt opt) {
+    RZ_ASSERT(chunks != NULL || count == 0, "rz_csv_chunks: invalid chunks");
+    opt = rz__csv_opt(opt);
+    if (count == 0 || input.len == 0) return 0;
+
+    rz_usize len = 0, start = 0, scanned = 0;
+    rz_u64   parity = 0;
+    for (rz_usize k = 1; k < count && start < input.len; ++k) {
+        rz_usize split = (rz_usize)(((rz_u64)input.len * k) / count);
+        if (split <= start) continue;
+        parity        ^= rz__csv_quote_parity(input, scanned, split, opt.quote);
+        scanned        = split;
+        rz_usize next  = rz__csv_row_start(input, split, parity, opt.quote);
+        if (next == RZ_NOT_FOUND || next >= input.len) break;
+        chunks[len++] = rz_sv_sized(input.data + start, next - start);
+        start         = next;
+    }
+    chunks[len++] = rz_sv_sized(input.data + start, input.len - start);
+    return len;
+}
+
+typedef struct {
+    RZ_StrView   chunk;
+    rz_usize     index;
+    RZ_CsvRowFn  fn;
+    void        *user;
+    RZ_CsvOpt    opt;
+    atomic_bool *stop;
+    thrd_t       thread;
+    bool         threaded;
+} RZ__CsvWorker;
+
+static int rz__csv_worker(void *arg) {
+    RZ__CsvWorker *w = arg;
+    RZ_CsvReader   r = rz_csv_reader_opt(w->chunk, w->opt);
+    RZ_CsvRow      row;
+    while (!atomic_load_explicit(w->stop, memory_order_relaxed) && rz_csv_next_row(&r, &row)) {
+        if (!w->fn(&r, row, w->index, w->user)) atomic_store(w->stop, true);
+    }
+    rz_csv_reader_free(&r);
+    return 0;
+}
+
+RZ_DEF bool rz_csv_read_parallel_opt(RZ_StrView input, rz_usize threads, RZ_CsvRowFn fn, void *user, RZ_CsvOpt opt) {
+    RZ_ASSERT_NOT_NULL(fn);
+    opt = rz__csv_opt(opt);
+    if (threads == 0) threads = 1;
+
+    RZ_StrView    *chunks  = rz_raw_calloc(opt.allocator, threads, sizeof(*chunks));
+    RZ__CsvWorker *workers = rz_raw_calloc(opt.allocator, threads, sizeof(*workers));
+    RZ_ASSERT_ALLOCATOR_PTR(chunks);
+    RZ_ASSERT_ALLOCATOR_PTR(workers);
+    atomic_bool stop = false;
+    rz_usize    len  = rz_csv_chunks_opt(input, chunks, threads, opt);
+    for (rz_usize i = 0; i < len; ++i) {
+        workers[i] = (RZ__CsvWorker){.chunk = chunks[i], .index = i, .fn = fn, .user = user, .opt = opt, .stop = &stop};
+        // the first chunk is read by the calling thread, the chunk is read inline when the thread is not created
+        if (i > 0) workers[i].threaded = thrd_create(&workers[i].thread, rz__csv_worker, &workers[i]) == thrd_success;
+    }
+    for (rz_usize i = 0; i < len; ++i) {
+        if (!workers[i].threaded) rz__csv_worker(&workers[i]);
+    }
+    for (rz_usize i = 0; i < len; ++i) {
+        if (workers[i].threaded) thrd_join(workers[i].thread, NULL);
+    }
+    rz_free(opt.allocator, chunks, threads);
+    rz_free(opt.allocator, workers, threads);
+    return !atomic_load(&stop);
+}
+
+RZ_DEF bool rz_csv_map(RZ_CsvMap *m, const RZ_Path path) {
+    RZ_ASSERT_NOT_NULL(m);
+    *m       = (RZ_CsvMap){0};
+    RZ_Fd fd = rz_fd_open_read(path);
+    if (fd == RZ_INVALID_FD) return false;
+
+    void    *base = NULL;
+    rz_usize size = 0;
+#    if RZ_TARGET_OS_WINDOWS
+    LARGE_INTEGER file_size;
+    HANDLE        mapping = NULL;
+    if (!GetFileSizeEx(fd, &file_size)) {
+        RZ_OS_ERROR_INTR("Failed to get size of " RZ_PathFmt, RZ_PathArg(path));
+        rz_fd_close(fd);
+        return false;
+    }
+    size = (rz_usize)file_size.QuadPart;
+    if (size > 0) {
+        mapping = CreateFileMappingA(fd, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (base == NULL) {
+            RZ_OS_ERROR_INTR("Failed to map " RZ_PathFmt, RZ_PathArg(path));
+            if (mapping != NULL) CloseHandle(mapping);
+            rz_fd_close(fd);
+            return false;
+        }
+    }
+    m->mapping = mapping;
+#    else
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        RZ_OS_ERROR_INTR("Failed to stat " RZ_PathFmt, RZ_PathArg(path));
+        rz_fd_close(fd);
+        return false;
+    }
+    size = (rz_usize)st.st_size;
+    if (size > 0) {
+        base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            RZ_OS_ERROR_INTR("Failed to map " RZ_PathFmt, RZ_PathArg(path));
+            rz_fd_close(fd);
+            return false;
+        }
+        // the reader scan the file once from the start
+        madvise(base, size, MADV_SEQUENTIAL);
+    }
+#    endif
+    // the mapping keep its own reference of the file
+    rz_fd_close(fd);
+    m->data = rz_sv_sized(base, size);
+    return true;
+}
+
+RZ_DEF void rz_csv_unmap(RZ_CsvMap *m) {
+    RZ_ASSERT_NOT_NULL(m);
+    if (m->data.data != NULL) {
+#    if RZ_TARGET_OS_WINDOWS
+        UnmapViewOfFile(m->data.data);
+        CloseHandle(m->mapping);
+#    else
+        munmap(m->data.data, m->data.len);
+#    endif
+    }
+    *m = (RZ_CsvMap){0};
+}
+
+#    undef RZ_TAG
+#endif /* ifdef RZ_CSV_IMPL */
@@ -0,0 +1,113 @@
+#pragma once
+#ifndef RZ_CSV_H
+#    define RZ_CSV_H
+#    include "rz_collections.h"
+#    include "rz_common.h"
+#    include "rz_fs.h"
+#    include "rz_strings.h"
+
+/// CSV/TSV reader (RFC 4180), the fields is RZ_StrView into the input buffer, nothing is copied.
+/// the input is indexed 64 bytes at a time:
+///  - the delimiter, quote and newline bytes of the block is classified into 3 bitmaps
+///    (2 AVX2 or 4 SSE2/NEON compares per bitmap, the scalar loop on the other targets).
+///  - the bytes inside the quotes is the prefix XOR of the quote bitmap (one carry-less multiply with PCLMUL,
+///    otherwise 6 shift/xor), xored with the carry of the previous block ("a""b" toggle out and in again).
+///  - the field ends is the delimiters and the newlines that is outside the quotes, the rows is emitted
+///    from the set bits, so the cost per byte does not depend on the amount of the fields.
+///
+/// the field is the raw bytes: the quoted field keep its quotes and escaped quotes, rz_csv_unquote remove
+/// them on demand (zero copy when the field has no escaped quote). the row end is '\n' outside the quotes,
+/// the '\r' before it is removed (CRLF), the empty line is the row of one empty field.
+///
+/// the multi-GB input is read in parallel by splitting it at the row boundaries with rz_csv_chunks (the
+/// quote parity at the split point is the popcount of the quotes before it), every chunk is read by its own
+/// reader in its own thread, rz_csv_read_parallel do that with the C11 threads.
+///
+/// Example:
+///  RZ_CsvMap m = {0};
+///  if (!rz_csv_map(&m, rz_path("export.csv"))) return false;
+///  RZ_CsvReader r       = rz_csv_reader(m.data, .delimiter = '\t');
+///  RZ_Str       scratch = {0};
+///  RZ_CsvRow    row;
+///  while (rz_csv_next_row(&r, &row)) {
+///      RZ_StrView name = rz_csv_unquote(&r, row.data[0], &scratch);
+///      ...
+///  }
+///  rz_arr_free(&scratch);
+///  rz_csv_reader_free(&r);
+///  rz_csv_unmap(&m);
+
+#    if defined(__cplusplus)
+extern "C" {
+#    endif
+
+typedef struct {
+    /// default ','
+    rz_char      delimiter;
+    /// default '"'
+    rz_char      quote;
+    /// the fields array of the reader, default rz_std_allocator
+    RZ_Allocator allocator;
+} RZ_CsvOpt;
+
+typedef RZ_ArrayView(RZ_StrView) RZ_CsvRow;
+
+typedef struct {
+    RZ_StrView           input;
+    RZ_CsvOpt            opt;
+    /// the fields of the current row, reused by every row
+    RZ_Array(RZ_StrView) fields;
+    /// offset of the indexed block and of the next block
+    rz_usize             block;
+    rz_usize             next;
+    /// the field ends of the indexed block that is not emitted yet
+    rz_u64               ends;
+    /// all ones when the indexed block end inside the quotes
+    rz_u64               inquote;
+    rz_usize             field_start;
+    bool                 done;
+} RZ_CsvReader;
+
+RZ_DEC RZ_CsvReader rz_csv_reader_opt(RZ_StrView input, RZ_CsvOpt opt);
+#    define rz_csv_reader(input, ...) rz_csv_reader_opt(input, (RZ_CsvOpt){__VA_ARGS__})
+RZ_DEC void rz_csv_reader_free(RZ_CsvReader *r);
+
+/// read the next row, return false at the end of the input.
+/// the row (not the fields bytes) is valid until the next call.
+RZ_DEC bool rz_csv_next_row(RZ_CsvReader *r, RZ_CsvRow *row);
+
+/// the content of the field without the quotes. the field without escaped quote is returned as the view
+/// of the input, otherwise the unescaped field is written into `scratch` (overwritten) and its view is returned.
+RZ_DEC RZ_StrView rz_csv_unquote(const RZ_CsvReader *r, RZ_StrView field, RZ_Str *scratch);
+
+/// split `input` into at most `count` chunks that start at the row boundaries, return the amount of chunks.
+/// reading every chunk with its own reader give the same rows as reading the whole input.
+RZ_DEC rz_usize rz_csv_chunks_opt(RZ_StrView input, RZ_StrView *chunks, rz_usize count, RZ_CsvOpt opt);
+#    define rz_csv_chunks(input, chunks, count, ...) rz_csv_chunks_opt(input, chunks, count, (RZ_CsvOpt){__VA_ARGS__})
+
+/// called for every row of the chunk, from the thread of the chunk. return false to stop the reading.
+typedef bool (*RZ_CsvRowFn)(const RZ_CsvReader *r, RZ_CsvRow row, rz_usize chunk, void *user);
+
+/// read `input` with `threads` threads (the calling thread read the first chunk), the rows of the chunk is in
+/// the input order but the chunks is read concurrently. return false when `fn` stopped the reading.
+/// every thread allocate its fields array from `opt.allocator`, so it must be thread safe.
+RZ_DEC bool rz_csv_read_parallel_opt(RZ_StrView input, rz_usize threads, RZ_CsvRowFn fn, void *user, RZ_CsvOpt opt);
+#    define rz_csv_read_parallel(input, threads, fn, user, ...) rz_csv_read_parallel_opt(input, threads, fn, user, (RZ_CsvOpt){__VA_ARGS__})
+
+typedef struct {
+    /// the mapped file (read only)
+    RZ_StrView data;
+#    if RZ_TARGET_OS_WINDOWS
+    HANDLE mapping;
+#    endif
+} RZ_CsvMap;
+
+/// map the file read only, the readers of `m->data` point into the mapped pages. return false (and set
+/// rz_strerror) on io error. the empty file is the empty view.
+RZ_DEC bool rz_csv_map(RZ_CsvMap *m, const RZ_Path path);
+RZ_DEC void rz_csv_unmap(RZ_CsvMap *m);
+
+#    if defined(__cplusplus)
+}
+#    endif
+#endif /* end of include guard: RZ_CSV_H */
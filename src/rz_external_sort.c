@@ -0,0 +1,560 @@
+#include "rz_external_sort.h"
+#include "rz_error.h"
+#include "rz_sprintf.h"
+
+#ifdef RZ_EXTERNAL_SORT_IMPL
+
+#    define RZ_TAG                       "rz_external_sort"
+#    define RZ__EXTSORT_MAX_FILE_TRIES   64U
+#    define RZ__EXTSORT_INSERTION_WIDTH  8U
+
+///////////////
+/// Double buffered io
+///
+/// the caller use `data[current]`, the job (read or write) of `data[current ^ 1]` is done by the io thread.
+/// the reader is primed with the job of the first buffer, the writer submit the buffer when it is full.
+typedef struct {
+    RZ_Fd        fd;
+    rz_u8       *data[2];
+    rz_usize     len[2];
+    /// the read position in `data[current]`
+    rz_usize     pos;
+    rz_usize     capacity;
+    rz_u32       current;
+    /// bytes read from or written into the fd
+    rz_u64       bytes;
+    bool         reading;
+    bool         threaded;
+    /// the job of `data[current ^ 1]` is in flight
+    bool         busy;
+    bool         quit;
+    /// false after any io error
+    bool         ok;
+    /// the last read job reach the end of the fd
+    bool         eof;
+    /// the reader consumed the last buffer
+    bool         drained;
+    RZ_OsError   error;
+    RZ_Allocator allocator;
+    mtx_t        lock;
+    cnd_t        cond;
+    thrd_t       thread;
+} RZ__ExtSortIo;
+
+static bool rz__extsort_io_job(RZ__ExtSortIo *io, rz_u32 i) {
+    if (!io->reading) return rz_fd_write_all(io->fd, io->data[i], io->len[i]);
+    io->len[i] = 0;
+    while (io->len[i] < io->capacity) {
+        rz_usize n = 0;
+        if (!rz_fd_read(io->fd, io->data[i] + io->len[i], io->capacity - io->len[i], &n)) return false;
+        if (n == 0) break;
+        io->len[i] += n;
+    }
+    io->eof = io->len[i] < io->capacity;
+    return true;
+}
+
+static int rz__extsort_io_thread(void *arg) {
+    RZ__ExtSortIo *io = arg;
+    mtx_lock(&io->lock);
+    for (;;) {
+        while (!io->busy && !io->quit) cnd_wait(&io->cond, &io->lock);
+        if (!io->busy) break;
+        rz_u32 i = io->current ^ 1U;
+        mtx_unlock(&io->lock);
+        bool ok = rz__extsort_io_job(io, i);
+        mtx_lock(&io->lock);
+        if (!ok) {
+            io->ok    = false;
+            io->error = rz_last_os_error();
+        }
+        io->busy = false;
+        cnd_broadcast(&io->cond);
+    }
+    mtx_unlock(&io->lock);
+    return 0;
+}
+
+// start the job of `data[current ^ 1]`
+static void rz__extsort_io_submit(RZ__ExtSortIo *io) {
+    if (!io->threaded) {
+        if (!rz__extsort_io_job(io, io->current ^ 1U)) io->ok = false;
+        return;
+    }
+    mtx_lock(&io->lock);
+    io->busy = true;
+    cnd_broadcast(&io->cond);
+    mtx_unlock(&io->lock);
+}
+
+// wait the job in flight
+static bool rz__extsort_io_wait(RZ__ExtSortIo *io) {
+    if (!io->threaded) return io->ok;
+    mtx_lock(&io->lock);
+    while (io->busy) cnd_wait(&io->cond, &io->lock);
+    mtx_unlock(&io->lock);
+    // the error of the io thread is set in its own thread local error
+    if (!io->ok) rz_set_error(io->error, RZ_TAG, __FILE__, __LINE__, "failed to %s file", io->reading ? "read" : "write");
+    return io->ok;
+}
+
+static void rz__extsort_io_open(RZ__ExtSortIo *io, RZ_Fd fd, bool reading, const RZ_ExternalSortOpt *opt) {
+    *io = (RZ__ExtSortIo){.fd = fd, .reading = reading, .capacity = opt->io_buffer_size, .ok = true, .allocator = opt->allocator};
+    io->data[0] = rz_raw_alloc(io->allocator, io->capacity * 2);
+    RZ_ASSERT_ALLOCATOR_PTR(io->data[0]);
+    io->data[1] = io->data[0] + io->capacity;
+
+    if (!opt->sync_io && mtx_init(&io->lock, mtx_plain) == thrd_success) {
+        if (cnd_init(&io->cond) == thrd_success) {
+            io->threaded = thrd_create(&io->thread, rz__extsort_io_thread, io) == thrd_success;
+            if (!io->threaded) cnd_destroy(&io->cond);
+        }
+        if (!io->threaded) mtx_destroy(&io->lock);
+    }
+    if (reading) {
+        // the empty `data[1]` is consumed first, then the job of `data[0]`
+        io->current = 1;
+        rz__extsort_io_submit(io);
+    }
+}
+
+static bool rz__extsort_io_flush(RZ__ExtSortIo *io) {
+    RZ_DBG_ASSERT(!io->reading);
+    rz__extsort_io_wait(io);
+    io->bytes += io->len[io->current];
+    io->current ^= 1U;
+    io->len[io->current] = 0;
+    if (io->ok) rz__extsort_io_submit(io);
+    return io->ok;
+}
+
+static bool rz__extsort_io_close(RZ__ExtSortIo *io) {
+    if (io->data[0] == NULL) return true;
+    if (!io->reading && io->len[io->current] > 0) rz__extsort_io_flush(io);
+    bool result = rz__extsort_io_wait(io);
+    if (io->threaded) {
+        mtx_lock(&io->lock);
+        io->quit = true;
+        cnd_broadcast(&io->cond);
+        mtx_unlock(&io->lock);
+        thrd_join(io->thread, NULL);
+        cnd_destroy(&io->cond);
+        mtx_destroy(&io->lock);
+    }
+    rz_raw_dealloc(io->allocator, io->data[0], io->capacity * 2);
+    io->data[0] = io->data[1] = NULL;
+    return result;
+}
+
+// swap to the buffer of the finished read job, false on the end of the fd or error (check `ok`)
+static bool rz__extsort_io_fill(RZ__ExtSortIo *io) {
+    if (io->drained || !rz__extsort_io_wait(io)) return false;
+    io->current ^= 1U;
+    io->pos = 0;
+    io->bytes += io->len[io->current];
+    if (io->eof) io->drained = true;
+    else rz__extsort_io_submit(io);
+    return io->len[io->current] > 0;
+}
+
+static void rz__extsort_io_write(RZ__ExtSortIo *io, const void *src, rz_usize len) {
+    const rz_u8 *s = src;
+    while (len > 0) {
+        rz_usize room = io->capacity - io->len[io->current];
+        if (room == 0) {
+            rz__extsort_io_flush(io);
+            continue;
+        }
+        rz_usize n = RZ_MIN(room, len);
+        memcpy(io->data[io->current] + io->len[io->current], s, n);
+        io->len[io->current] += n;
+        s += n;
+        len -= n;
+    }
+}
+
+///////////////
+/// Records
+///
+typedef struct {
+    const rz_u8 *data;
+    rz_usize     len;
+} RZ__ExtSortRecord;
+
+/// read the next record, the record point into the io buffer or `scratch` and is valid until the next read.
+/// return 1 on success, 0 on the end of the input, -1 on error.
+static int rz__extsort_read_record(RZ__ExtSortIo *io, rz_usize record_size, rz_usize max_len, RZ_BytesArray *scratch, RZ__ExtSortRecord *rec) {
+    scratch->len = 0;
+    for (;;) {
+        if (io->pos >= io->len[io->current] && !rz__extsort_io_fill(io)) {
+            if (!io->ok) return -1;
+            if (scratch->len == 0) return 0;
+            if (record_size != 0) {
+                RZ_ERROR_INTR("truncated record, %zu of %zu bytes", scratch->len, record_size);
+                return -1;
+            }
+            break; // the last line without '\n'
+        }
+        const rz_u8 *p     = io->data[io->current] + io->pos;
+        rz_usize     avail = io->len[io->current] - io->pos;
+        rz_usize     take  = 0;
+        bool         complete;
+        if (record_size != 0) {
+            take     = RZ_MIN(record_size - scratch->len, avail);
+            complete = (scratch->len + take) == record_size;
+            io->pos += take;
+        } else {
+            const rz_u8 *nl = memchr(p, '\n', avail);
+            complete        = nl != NULL;
+            take            = complete ? (rz_usize)(nl - p) : avail;
+            io->pos += take + complete;
+        }
+        if (complete && scratch->len == 0) {
+            *rec = (RZ__ExtSortRecord){.data = p, .len = take};
+            return 1;
+        }
+        rz_arr_append_many(scratch, p, take);
+        if (scratch->len > max_len) {
+            RZ_ERROR_INTR("the record is bigger than the memory limit (%zu bytes)", max_len);
+            return -1;
+        }
+        if (complete) break;
+    }
+    *rec = (RZ__ExtSortRecord){.data = scratch->data, .len = scratch->len};
+    return 1;
+}
+
+static int rz__extsort_cmp_bytes(const void *a, rz_usize a_len, const void *b, rz_usize b_len, void *user) {
+    RZ_UNUSED(user);
+    int c = memcmp(a, b, RZ_MIN(a_len, b_len));
+    return (c != 0) ? c : (a_len > b_len) - (a_len < b_len);
+}
+
+///////////////
+/// Sort state
+///
+typedef struct {
+    /// offset of the record in the run arena
+    rz_usize offset;
+    rz_usize len;
+    /// the first 8 bytes of the record (big endian, zero padded), only with the default comparator
+    rz_u64   prefix;
+} RZ__ExtSortItem;
+
+typedef struct {
+    RZ_ExternalSortOpt      opt;
+    RZ_PathBuf              dir;
+    RZ_PathBuf              path;
+    rz_u64                  tag;
+    rz_u32                  next_id;
+    /// the ids of the run files, the runs in [runs_head, len) is not merged yet
+    RZ_Array(rz_u32)        runs;
+    rz_usize                runs_head;
+    RZ_ExternalSortProgress progress;
+    RZ_InstantTime          start;
+} RZ__ExtSort;
+
+static inline rz_u64 rz__extsort_prefix(const rz_u8 *data, rz_usize len) {
+    rz_u64 prefix = 0;
+    for (rz_usize i = 0; i < 8; ++i) prefix = (prefix << 8U) | ((i < len) ? data[i] : 0U);
+    return prefix;
+}
+
+// with the default comparator the prefix order is the memcmp order, the record is read only when the prefix is equal
+static inline int rz__extsort_item_cmp(const RZ__ExtSort *s, const rz_u8 *base, RZ__ExtSortItem a, RZ__ExtSortItem b) {
+    if (s->opt.cmp == rz__extsort_cmp_bytes) {
+        if (a.prefix != b.prefix) return (a.prefix < b.prefix) ? -1 : 1;
+        if (a.len <= 8 || b.len <= 8) return (a.len > b.len) - (a.len < b.len);
+    }
+    return s->opt.cmp(base + a.offset, a.len, base + b.offset, b.len, s->opt.cmp_user);
+}
+
+// stable sort: insertion sort of the small blocks then bottom up merge
+static void rz__extsort_sort(const RZ__ExtSort *s, const rz_u8 *base, RZ__ExtSortItem *items, RZ__ExtSortItem *tmp, rz_usize n) {
+    for (rz_usize lo = 0; lo < n; lo += RZ__EXTSORT_INSERTION_WIDTH) {
+        rz_usize hi = RZ_MIN(lo + RZ__EXTSORT_INSERTION_WIDTH, n);
+        for (rz_usize i = lo + 1; i < hi; ++i) {
+            RZ__ExtSortItem item = items[i];
+            rz_usize        j    = i;
+            for (; j > lo && rz__extsort_item_cmp(s, base, item, items[j - 1]) < 0; --j) items[j] = items[j - 1];
+            items[j] = item;
+        }
+    }
+    RZ__ExtSortItem *src = items, *dst = tmp;
+    for (rz_usize width = RZ__EXTSORT_INSERTION_WIDTH; width < n; width *= 2) {
+        for (rz_usize lo = 0; lo < n; lo += 2 * width) {
+            rz_usize mid = RZ_MIN(lo + width, n), hi = RZ_MIN(lo + (2 * width), n);
+            rz_usize i = lo, j = mid, k = lo;
+            while (i < mid && j < hi) dst[k++] = (rz__extsort_item_cmp(s, base, src[j], src[i]) < 0) ? src[j++] : src[i++];
+            while (i < mid) dst[k++] = src[i++];
+            while (j < hi) dst[k++] = src[j++];
+        }
+        RZ__ExtSortItem *t = src;
+        src                = dst;
+        dst                = t;
+    }
+    if (src != items) memcpy(items, src, n * sizeof(*items));
+}
+
+static void rz__extsort_run_path(RZ__ExtSort *s, rz_u32 id) {
+    char name[64];
+    rz_snprintf(name, sizeof(name), "rz_extsort_%llx_%u.run", (unsigned long long)s->tag, id);
+    s->path.len = 0;
+    rz_str_append_sized_str(&s->path, s->dir.data, s->dir.len);
+    rz_pathbuf_push_cstr(&s->path, name);
+}
+
+static RZ_Path rz__extsort_path(const RZ__ExtSort *s) { return rz_path_sized(s->path.data, s->path.len); }
+
+// create new run file (that does not exist yet), `id` is set to the id of the file
+static RZ_Fd rz__extsort_run_create(RZ__ExtSort *s, rz_u32 *id) {
+    for (rz_u32 tries = 0; tries < RZ__EXTSORT_MAX_FILE_TRIES; ++tries) {
+        *id = s->next_id++;
+        rz__extsort_run_path(s, *id);
+        RZ_Fd fd = rz_fd_open_opt(rz__extsort_path(s), (RZ_FdOpenOpt){.write = true, .create_new = true});
+        if (fd != RZ_INVALID_FD || !rz_fs_exists(rz__extsort_path(s))) return fd;
+    }
+    return RZ_INVALID_FD;
+}
+
+static void rz__extsort_run_remove(RZ__ExtSort *s, rz_u32 id) {
+    rz__extsort_run_path(s, id);
+    rz_fs_remove(rz__extsort_path(s), .ignore_non_existing = true);
+}
+
+static void rz__extsort_report(RZ__ExtSort *s, RZ_ExternalSortStage stage) {
+    if (s->opt.progress == NULL) return;
+    RZ_ExternalSortProgress *p = &s->progress;
+    p->stage                   = stage;
+    p->runs_pending            = s->runs.len - s->runs_head;
+    p->elapsed_secs            = rz_duration_as_secs(rz_f64, rz_instant_elapsed(s->start));
+    p->bytes_per_sec           = (p->elapsed_secs > 0) ? (rz_f64)(p->bytes_read + p->bytes_written) / p->elapsed_secs : 0;
+    s->opt.progress(p, s->opt.progress_user);
+}
+
+static void rz__extsort_write_record(RZ__ExtSort *s, RZ__ExtSortIo *out, const void *data, rz_usize len) {
+    rz__extsort_io_write(out, data, len);
+    if (s->opt.record_size == 0) rz__extsort_io_write(out, "\n", 1);
+}
+
+static bool rz__extsort_write_items(RZ__ExtSort *s, RZ_Fd fd, const rz_u8 *base, const RZ__ExtSortItem *items, rz_usize n) {
+    RZ__ExtSortIo out;
+    rz__extsort_io_open(&out, fd, false, &s->opt);
+    for (rz_usize i = 0; i < n && out.ok; ++i) rz__extsort_write_record(s, &out, base + items[i].offset, items[i].len);
+    bool result = rz__extsort_io_close(&out);
+    s->progress.bytes_written += out.bytes;
+    return result;
+}
+
+///////////////
+/// K-way merge (loser tree)
+///
+typedef struct {
+    RZ__ExtSortIo     io;
+    RZ_BytesArray     scratch;
+    RZ__ExtSortRecord head;
+    bool              done;
+} RZ__ExtSortSource;
+
+// the source `a` win against `b` (smaller head, the older run on tie), the finished source always lose
+static inline bool rz__extsort_wins(const RZ__ExtSort *s, const RZ__ExtSortSource *src, rz_u32 a, rz_u32 b) {
+    if (src[a].done || src[b].done) return !src[a].done && (src[b].done || a < b);
+    int c = s->opt.cmp(src[a].head.data, src[a].head.len, src[b].head.data, src[b].head.len, s->opt.cmp_user);
+    return c < 0 || (c == 0 && a < b);
+}
+
+// the leaves of the tree is [k, 2k), the inner node `n` store the loser of the match between its children
+static rz_u32 rz__extsort_tree_build(const RZ__ExtSort *s, const RZ__ExtSortSource *src, rz_u32 *tree, rz_u32 k, rz_u32 n) {
+    if (n >= k) return n - k;
+    rz_u32 a = rz__extsort_tree_build(s, src, tree, k, 2 * n);
+    rz_u32 b = rz__extsort_tree_build(s, src, tree, k, (2 * n) + 1);
+    bool   w = rz__extsort_wins(s, src, a, b);
+    tree[n]  = w ? b : a;
+    return w ? a : b;
+}
+
+static bool rz__extsort_advance(RZ__ExtSort *s, RZ__ExtSortSource *src) {
+    int r = rz__extsort_read_record(&src->io, s->opt.record_size, s->opt.memory_limit, &src->scratch, &src->head);
+    src->done = r <= 0;
+    return r >= 0;
+}
+
+// merge the runs [first, first + k) into `out`, the run files is removed
+static bool rz__extsort_merge(RZ__ExtSort *s, rz_usize first, rz_u32 k, RZ__ExtSortIo *out) {
+    bool               result = true;
+    RZ__ExtSortSource *src    = rz_raw_calloc(s->opt.allocator, k, sizeof(*src));
+    rz_u32            *tree   = rz_raw_calloc(s->opt.allocator, k, sizeof(*tree));
+    RZ_ASSERT_ALLOCATOR_PTR(src);
+    RZ_ASSERT_ALLOCATOR_PTR(tree);
+
+    rz_u32 opened = 0;
+    for (; opened < k; ++opened) {
+        rz__extsort_run_path(s, s->runs.data[first + opened]);
+        RZ_Fd fd = rz_fd_open_read(rz__extsort_path(s));
+        if (fd == RZ_INVALID_FD) rz_return_defer(false);
+        src[opened].scratch = (RZ_BytesArray){.allocator = s->opt.allocator};
+        rz__extsort_io_open(&src[opened].io, fd, true, &s->opt);
+        if (!rz__extsort_advance(s, &src[opened])) {
+            opened++;
+            rz_return_defer(false);
+        }
+    }
+
+    rz_u32 winner = rz__extsort_tree_build(s, src, tree, k, 1);
+    while (!src[winner].done && out->ok) {
+        rz__extsort_write_record(s, out, src[winner].head.data, src[winner].head.len);
+        if (!rz__extsort_advance(s, &src[winner])) rz_return_defer(false);
+        for (rz_u32 n = (winner + k) >> 1U; n >= 1; n >>= 1U) {
+            if (rz__extsort_wins(s, src, tree[n], winner)) {
+                rz_u32 t = tree[n];
+                tree[n]  = winner;
+                winner   = t;
+            }
+        }
+    }
+    result = out->ok;
+defer:
+    for (rz_u32 i = 0; i < opened; ++i) {
+        rz__extsort_io_close(&src[i].io);
+        rz_fd_close(src[i].io.fd);
+        s->progress.bytes_read += src[i].io.bytes;
+        rz_arr_free(&src[i].scratch);
+    }
+    for (rz_u32 i = 0; i < k; ++i) rz__extsort_run_remove(s, s->runs.data[first + i]);
+    rz_free(s->opt.allocator, src, k);
+    rz_free(s->opt.allocator, tree, k);
+    return result;
+}
+
+///////////////
+/// External sort
+///
+// sort the run and write it into new run file
+static bool rz__extsort_spill(RZ__ExtSort *s, const rz_u8 *base, RZ__ExtSortItem *items, RZ__ExtSortItem *tmp, rz_usize n) {
+    rz__extsort_sort(s, base, items, tmp, n);
+    rz_u32 id = 0;
+    RZ_Fd  fd = rz__extsort_run_create(s, &id);
+    if (fd == RZ_INVALID_FD) return false;
+    bool result = rz__extsort_write_items(s, fd, base, items, n);
+    result      = rz_fd_close(fd) && result;
+    if (!result) {
+        rz__extsort_run_remove(s, id);
+        return false;
+    }
+    rz_arr_append(&s->runs, id);
+    s->progress.runs++;
+    rz__extsort_report(s, RZ_EXTERNAL_SORT_STAGE_RUNS);
+    return true;
+}
+
+RZ_DEF bool rz_external_sort_opt(RZ_Fd input, RZ_Fd output, RZ_ExternalSortOpt opt) {
+    if (!rz_is_allocator(opt.allocator)) opt.allocator = rz_std_allocator();
+    if (opt.memory_limit == 0) opt.memory_limit = RZ_EXTERNAL_SORT_DEFAULT_MEMORY;
+    if (opt.fan_in == 0) opt.fan_in = RZ_EXTERNAL_SORT_DEFAULT_FAN_IN;
+    if (opt.io_buffer_size == 0) opt.io_buffer_size = RZ_EXTERNAL_SORT_DEFAULT_IO_BUFFER;
+    if (opt.cmp == NULL) opt.cmp = rz__extsort_cmp_bytes;
+    RZ_ASSERT(opt.fan_in >= 2 && opt.fan_in <= RZ_U32_MAX, "rz_external_sort: fan_in must be >= 2");
+
+    bool          result  = true;
+    RZ__ExtSort   s       = {.opt = opt, .start = rz_instant_now()};
+    RZ_BytesArray arena   = {.allocator = opt.allocator};
+    RZ_BytesArray scratch = {.allocator = opt.allocator};
+    RZ_Array(RZ__ExtSortItem) items = {.allocator = opt.allocator};
+    RZ_Array(RZ__ExtSortItem) tmp   = {.allocator = opt.allocator};
+    RZ__ExtSortIo in = {0}, out = {0};
+
+    s.dir  = (RZ_PathBuf){.allocator = opt.allocator};
+    s.path = (RZ_PathBuf){.allocator = opt.allocator};
+    s.runs = (RZ_TYPEOF(s.runs)){.allocator = opt.allocator};
+    s.tag  = ((rz_u64)(rz_uptr)&s << 16U) ^ s.start.t.nanos ^ s.start.t.secs;
+    if (!rz_path_is_empty(opt.temp_dir)) rz_str_append_sv(&s.dir, opt.temp_dir);
+    else if (!rz_fs_temp_dir(&s.dir)) rz_return_defer(false);
+
+    // read and spill the sorted runs
+    rz__extsort_io_open(&in, input, true, &opt);
+    for (;;) {
+        RZ__ExtSortRecord rec;
+        int               r = rz__extsort_read_record(&in, opt.record_size, opt.memory_limit, &scratch, &rec);
+        if (r < 0) rz_return_defer(false);
+        if (r == 0) break;
+        rz_usize cost = rec.len + (2 * sizeof(RZ__ExtSortItem));
+        if (cost > opt.memory_limit) {
+            RZ_ERROR_INTR("the record is bigger than the memory limit (%zu bytes)", opt.memory_limit);
+            rz_return_defer(false);
+        }
+        if (arena.len + (items.len * 2 * sizeof(RZ__ExtSortItem)) + cost > opt.memory_limit) {
+            rz_arr_reserve(&tmp, items.len);
+            if (!rz__extsort_spill(&s, arena.data, items.data, tmp.data, items.len)) rz_return_defer(false);
+            arena.len = items.len = 0;
+        }
+        rz_u64 prefix = (opt.cmp == rz__extsort_cmp_bytes) ? rz__extsort_prefix(rec.data, rec.len) : 0;
+        rz_arr_append(&items, (RZ__ExtSortItem){.offset = arena.len, .len = rec.len, .prefix = prefix});
+        rz_arr_append_many(&arena, rec.data, rec.len);
+        s.progress.records++;
+    }
+    result = rz__extsort_io_close(&in);
+    s.progress.bytes_read += in.bytes;
+    if (!result) rz_return_defer(false);
+
+    rz_arr_reserve(&tmp, items.len);
+    if (s.runs.len == 0) {
+        // the input fit in the memory
+        rz__extsort_sort(&s, arena.data, items.data, tmp.data, items.len);
+        rz_return_defer(rz__extsort_write_items(&s, output, arena.data, items.data, items.len));
+    }
+    if (items.len > 0 && !rz__extsort_spill(&s, arena.data, items.data, tmp.data, items.len)) rz_return_defer(false);
+    rz_arr_free(&arena);
+    rz_arr_free(&items);
+    rz_arr_free(&tmp);
+
+    // merge the runs into bigger runs until the last merge to the output.
+    // every pass merge the consecutive runs in order (the merged run keep the place of its runs) to keep it stable.
+    while (s.runs.len - s.runs_head > opt.fan_in) {
+        rz_usize end = s.runs.len;
+        while (s.runs_head < end) {
+            rz_u32 k = (rz_u32)RZ_MIN(opt.fan_in, end - s.runs_head);
+            rz_u32 id = s.runs.data[s.runs_head];
+            if (k > 1) {
+                RZ_Fd fd = rz__extsort_run_create(&s, &id);
+                if (fd == RZ_INVALID_FD) rz_return_defer(false);
+                rz__extsort_io_open(&out, fd, false, &opt);
+                bool merged = rz__extsort_merge(&s, s.runs_head, k, &out);
+                merged      = rz__extsort_io_close(&out) && merged;
+                merged      = rz_fd_close(fd) && merged;
+                s.progress.bytes_written += out.bytes;
+                if (!merged) {
+                    s.runs_head += k;
+                    rz__extsort_run_remove(&s, id);
+                    rz_return_defer(false);
+                }
+            }
+            s.runs_head += k;
+            rz_arr_append(&s.runs, id);
+        }
+        rz__extsort_report(&s, RZ_EXTERNAL_SORT_STAGE_MERGE);
+    }
+    rz__extsort_io_open(&out, output, false, &opt);
+    rz_u32 k = (rz_u32)(s.runs.len - s.runs_head);
+    result   = rz__extsort_merge(&s, s.runs_head, k, &out);
+    result   = rz__extsort_io_close(&out) && result;
+    s.progress.bytes_written += out.bytes;
+    s.runs_head += k;
+
+defer:
+    rz__extsort_io_close(&in);
+    rz__extsort_io_close(&out);
+    for (rz_usize i = s.runs_head; i < s.runs.len; ++i) rz__extsort_run_remove(&s, s.runs.data[i]);
+    s.runs_head = s.runs.len;
+    if (result) rz__extsort_report(&s, RZ_EXTERNAL_SORT_STAGE_DONE);
+    rz_arr_free(&arena);
+    rz_arr_free(&scratch);
+    rz_arr_free(&items);
+    rz_arr_free(&tmp);
+    rz_arr_free(&s.runs);
+    rz_pathbuf_free(&s.dir);
+    rz_pathbuf_free(&s.path);
+    return result;
+}
+
+#    undef RZ_TAG
+#endif /* ifdef RZ_EXTERNAL_SORT_IMPL */
@@ -0,0 +1,107 @@
+#pragma once
+#ifndef RZ_EXTERNAL_SORT_H
+#    define RZ_EXTERNAL_SORT_H
+#    include "rz_allocator.h"
+#    include "rz_common.h"
+#    include "rz_fs.h"
+
+/// External merge sort, sort the records of file that is bigger than the memory.
+/// the sort has 4 stages:
+///  - read   : the records is read from the input fd, fixed size records (`.record_size`) or newline
+///             delimited records (`.record_size = 0`, the '\n' is not part of the record).
+///  - sort   : the records is collected until `.memory_limit` then sorted in memory (stable merge sort).
+///  - spill  : the sorted run is written into the temp file under `.temp_dir` (default rz_fs_temp_dir).
+///  - merge  : the runs is k-way merged with the loser tree, at most `.fan_in` runs at once,
+///             if there is more runs than `.fan_in` the runs is merged into bigger runs first.
+/// if the input fit in the memory, the sorted run is written to the output directly (no temp file).
+/// the read and write is double buffered, the io thread read/write one buffer while the sort consume/fill
+/// the other (`.sync_io = true` do the io in the calling thread).
+/// the output is stable, the records with equal key keep the order of the input.
+///
+/// Example:
+///  RZ_Fd in  = rz_fd_open_cstr_read("words.txt");
+///  RZ_Fd out = rz_fd_open_cstr_write("words.sorted.txt");
+///  if (!rz_external_sort(in, out, .memory_limit = 256 << 20, .fan_in = 32)) {
+///      RZ_LOGE("sort", "sort failed: %s", rz_strerror());
+///  }
+///  rz_fd_close(in);
+///  rz_fd_close(out);
+///
+/// NOTE: every newline delimited record is written with '\n', even the last line of the input that has no '\n'.
+
+#    if defined(__cplusplus)
+extern "C" {
+#    endif
+
+#    ifndef RZ_EXTERNAL_SORT_DEFAULT_MEMORY
+#        define RZ_EXTERNAL_SORT_DEFAULT_MEMORY (64U << 20U)
+#    endif
+#    ifndef RZ_EXTERNAL_SORT_DEFAULT_FAN_IN
+#        define RZ_EXTERNAL_SORT_DEFAULT_FAN_IN 16U
+#    endif
+#    ifndef RZ_EXTERNAL_SORT_DEFAULT_IO_BUFFER
+#        define RZ_EXTERNAL_SORT_DEFAULT_IO_BUFFER (1U << 20U)
+#    endif
+
+/// compare two records, like memcmp/qsort (< 0, 0, > 0).
+typedef int (*RZ_ExternalSortCmpFn)(const void *a, rz_usize a_len, const void *b, rz_usize b_len, void *user);
+
+typedef enum : rz_u8
+{
+    /// read the input and spill the sorted runs
+    RZ_EXTERNAL_SORT_STAGE_RUNS,
+    /// merge the runs
+    RZ_EXTERNAL_SORT_STAGE_MERGE,
+    /// the output is complete
+    RZ_EXTERNAL_SORT_STAGE_DONE,
+} RZ_ExternalSortStage;
+
+typedef struct {
+    RZ_ExternalSortStage stage;
+    /// bytes read from the input / the runs, and bytes written to the runs / the output.
+    rz_u64               bytes_read;
+    rz_u64               bytes_written;
+    /// records read from the input
+    rz_u64               records;
+    /// the sorted runs written into the temp files, and the runs left to merge.
+    rz_u64               runs;
+    rz_u64               runs_pending;
+    rz_f64               elapsed_secs;
+    /// (bytes_read + bytes_written) / elapsed_secs
+    rz_f64               bytes_per_sec;
+} RZ_ExternalSortProgress;
+
+/// called after every run is spilled and every merge pass.
+typedef void (*RZ_ExternalSortProgressFn)(const RZ_ExternalSortProgress *progress, void *user);
+
+typedef struct {
+    /// size of the fixed size record, 0 for newline delimited records.
+    rz_usize                  record_size;
+    /// the memory of the in-memory run (records + index), default RZ_EXTERNAL_SORT_DEFAULT_MEMORY.
+    rz_usize                  memory_limit;
+    /// the maximum amount of runs that is merged at once (>= 2), default RZ_EXTERNAL_SORT_DEFAULT_FAN_IN.
+    rz_usize                  fan_in;
+    /// size of one io buffer (every stream has 2), default RZ_EXTERNAL_SORT_DEFAULT_IO_BUFFER.
+    rz_usize                  io_buffer_size;
+    /// the comparator, default is memcmp order (the shorter record first when it is the prefix).
+    RZ_ExternalSortCmpFn      cmp;
+    void                     *cmp_user;
+    RZ_ExternalSortProgressFn progress;
+    void                     *progress_user;
+    /// the directory of the temp files, default rz_fs_temp_dir.
+    RZ_Path                   temp_dir;
+    /// do the io in the calling thread.
+    bool                      sync_io;
+    RZ_Allocator              allocator;
+} RZ_ExternalSortOpt;
+
+/// sort the records of `input` into `output`. return false (and set rz_strerror) on io error
+/// or invalid input (truncated fixed size record, record bigger than the memory limit).
+/// the temp files is removed in any case.
+RZ_DEC bool rz_external_sort_opt(RZ_Fd input, RZ_Fd output, RZ_ExternalSortOpt opt);
+#    define rz_external_sort(input, output, ...) rz_external_sort_opt(input, output, (RZ_ExternalSortOpt){__VA_ARGS__})
+
+#    if defined(__cplusplus)
+}
+#    endif
+#endif /* end of include guard: RZ_EXTERNAL_SORT_H */
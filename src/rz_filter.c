@@ -0,0 +1,1054 @@
+#include "rz_filter.h"
+
+#ifdef RZ_FILTER_IMPL
+
+#    define RZ__FILTER_VERSION 1U
+#    define RZ__BLOOM_MAGIC    "RZBF"
+#    define RZ__CUCKOO_MAGIC   "RZCF"
+#    define RZ__HLL_MAGIC      "RZHL"
+#    define RZ__CMS_MAGIC      "RZCM"
+#    define RZ__TOPK_MAGIC     "RZTK"
+
+// finalizer of splitmix64, the filters use every bit of the hash so weak hash (e.g rz_hm_id_hash) is mixed first.
+static inline rz_u64 rz__filter_mix64(rz_u64 h) {
+    h ^= h >> 30u;
+    h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27u;
+    h *= 0x94d049bb133111ebull;
+    h ^= h >> 31u;
+    return h;
+}
+
+static void rz__filter_default_opt(RZ__FilterInitOpt *opt) {
+    if (opt->hash == NULL) opt->hash = rz_hm_default_hash;
+    if (!rz_is_allocator(opt->allocator)) opt->allocator = rz_std_allocator();
+    if (opt->fpp <= 0.0 || opt->fpp >= 1.0) opt->fpp = 0.01;
+    if (opt->expected_count == 0) opt->expected_count = 1;
+}
+
+///////////////
+/// serialization helpers (little endian)
+///
+typedef struct {
+    const rz_u8 *p;
+    rz_usize     len;
+} RZ__FilterReader;
+
+static void rz__filter_put(RZ_BytesArray *bytes, rz_u64 v, rz_usize size) {
+    for (rz_usize i = 0; i < size; ++i) rz_arr_append(bytes, (rz_u8)(v >> (i * 8u)));
+}
+
+static bool rz__filter_get(RZ__FilterReader *r, rz_usize size, rz_u64 *v) {
+    if (r->len < size) return false;
+    *v = 0;
+    for (rz_usize i = 0; i < size; ++i) *v |= (rz_u64)r->p[i] << (i * 8u);
+    r->p += size;
+    r->len -= size;
+    return true;
+}
+
+static void rz__filter_put_header(RZ_BytesArray *bytes, const char magic[4]) {
+    if (!rz_is_allocator(bytes->allocator)) bytes->allocator = rz_std_allocator();
+    rz_arr_append_many(bytes, (const rz_u8 *)magic, 4);
+    rz__filter_put(bytes, RZ__FILTER_VERSION, sizeof(rz_u32));
+}
+
+static bool rz__filter_get_header(RZ__FilterReader *r, const char magic[4]) {
+    rz_u64 version = 0;
+    if (r->len < 4 || memcmp(r->p, magic, 4) != 0) return false;
+    r->p += 4;
+    r->len -= 4;
+    return rz__filter_get(r, sizeof(rz_u32), &version) && version == RZ__FILTER_VERSION;
+}
+
+///////////////
+/// BloomFilter
+///
+#    define RZ__BLOOM_BLOCK_WORDS 8U
+#    define RZ__BLOOM_BLOCK_BITS  (RZ__BLOOM_BLOCK_WORDS * 32U)
+
+// odd constants from the parquet split block bloom filter spec, one per word of the block.
+static const rz_u32 rz__bloom_salt[RZ__BLOOM_BLOCK_WORDS] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+// e^-x without libm, (e^(-x / 2^k))^(2^k) with taylor series for the small exponent.
+static rz_f64 rz__filter_exp_neg(rz_f64 x) {
+    rz_usize k = 0;
+    for (; x > 0.5; x /= 2) k++;
+    rz_f64 term = 1.0, sum = 1.0;
+    for (int i = 1; i < 16; ++i) {
+        term *= -x / i;
+        sum += term;
+    }
+    while (k-- > 0) sum *= sum;
+    return sum;
+}
+
+// false positive rate of split block bloom filter with `bits_per_key`:
+//   the keys per block is poisson(256 / bits_per_key), and a block with j keys
+//   give false positive with probability (1 - (31/32)^j)^8.
+static rz_f64 rz__bloom_fpp(rz_f64 bits_per_key) {
+    rz_f64 lambda = RZ__BLOOM_BLOCK_BITS / bits_per_key;
+    rz_f64 pois = rz__filter_exp_neg(lambda), miss = 1.0, fpp = 0.0;
+    for (rz_usize j = 0; j < (rz_usize)(lambda * 4) + 64; ++j) {
+        rz_f64 hit = 1.0 - miss;
+        hit *= hit;
+        hit *= hit;
+        fpp += pois * hit * hit;
+        pois *= lambda / (rz_f64)(j + 1);
+        miss *= 31.0 / 32.0;
+    }
+    return fpp;
+}
+
+static rz_usize rz__bloom_nblocks(rz_usize expected_count, rz_f64 fpp) {
+    // bisection of bits per key, the fpp is monotonic on it.
+    rz_f64 lo = 1.0, hi = 128.0;
+    for (int i = 0; i < 40; ++i) {
+        rz_f64 mid = (lo + hi) / 2;
+        if (rz__bloom_fpp(mid) > fpp) lo = mid;
+        else hi = mid;
+    }
+    return (rz_usize)((hi * (rz_f64)expected_count) / RZ__BLOOM_BLOCK_BITS) + 1;
+}
+
+static inline const rz_u32 *rz__bloom_block(const RZ_BloomFilter *bf, rz_u64 h) {
+    // fast range reduction of the high 32 bits, nblocks doesn't need to be power of two.
+    rz_usize idx = (rz_usize)(((h >> 32u) * (rz_u64)bf->nblocks) >> 32u);
+    return bf->words + (idx * RZ__BLOOM_BLOCK_WORDS);
+}
+
+RZ_DEF void rz__bloom_init(RZ_BloomFilter *bf, RZ__FilterInitOpt opt) {
+    RZ_ASSERT_NOT_NULL(bf);
+    rz__filter_default_opt(&opt);
+    *bf = (RZ_BloomFilter){
+        .nblocks   = rz__bloom_nblocks(opt.expected_count, opt.fpp),
+        .hash      = opt.hash,
+        .seed      = opt.seed,
+        .allocator = opt.allocator,
+    };
+    bf->words = rz_raw_calloc(bf->allocator, bf->nblocks * RZ__BLOOM_BLOCK_WORDS, sizeof(rz_u32));
+    RZ_ASSERT_ALLOCATOR_PTR(bf->words);
+}
+
+RZ_DEF void rz_bloom_free(RZ_BloomFilter *bf) {
+    RZ_ASSERT_NOT_NULL(bf);
+    if (bf->words != NULL) rz_raw_dealloc(bf->allocator, bf->words, rz_bloom_size_bytes(bf));
+    bf->words   = NULL;
+    bf->nblocks = 0;
+}
+
+RZ_DEF void rz_bloom_clear(RZ_BloomFilter *bf) {
+    if (bf->words != NULL) memset(bf->words, 0, rz_bloom_size_bytes(bf));
+}
+
+RZ_DEF void rz_bloom_add_hash(RZ_BloomFilter *bf, rz_u64 hash) {
+    RZ_DBG_ASSERT(bf->words != NULL);
+    hash          = rz__filter_mix64(hash);
+    rz_u32 *block = (rz_u32 *)rz__bloom_block(bf, hash);
+    rz_u32  key   = (rz_u32)hash;
+#    if RZ_TARGET_SIMD_AVX2
+    __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int)key), _mm256_loadu_si256((const __m256i *)rz__bloom_salt)), 27);
+    __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+    _mm256_storeu_si256((__m256i *)block, _mm256_or_si256(_mm256_loadu_si256((const __m256i *)block), mask));
+#    else
+    for (rz_usize i = 0; i < RZ__BLOOM_BLOCK_WORDS; ++i) block[i] |= (rz_u32)1 << ((key * rz__bloom_salt[i]) >> 27u);
+#    endif
+}
+
+RZ_DEF bool rz_bloom_contains_hash(const RZ_BloomFilter *bf, rz_u64 hash) {
+    if (bf->words == NULL) return false;
+    hash                = rz__filter_mix64(hash);
+    const rz_u32 *block = rz__bloom_block(bf, hash);
+    rz_u32        key   = (rz_u32)hash;
+#    if RZ_TARGET_SIMD_AVX2
+    __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int)key), _mm256_loadu_si256((const __m256i *)rz__bloom_salt)), 27);
+    __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+    // testc: (~block & mask) == 0, every bit of the mask is set in the block
+    return _mm256_testc_si256(_mm256_loadu_si256((const __m256i *)block), mask) != 0;
+#    else
+    rz_u32 missing = 0;
+    for (rz_usize i = 0; i < RZ__BLOOM_BLOCK_WORDS; ++i) missing |= ~block[i] & ((rz_u32)1 << ((key * rz__bloom_salt[i]) >> 27u));
+    return missing == 0;
+#    endif
+}
+
+RZ_DEF void rz_bloom_add(RZ_BloomFilter *bf, const void *data, rz_usize size) {
+    rz_bloom_add_hash(bf, bf->hash(data, size, bf->seed));
+}
+
+RZ_DEF bool rz_bloom_contains(const RZ_BloomFilter *bf, const void *data, rz_usize size) {
+    return rz_bloom_contains_hash(bf, bf->hash(data, size, bf->seed));
+}
+
+RZ_DEF bool rz_bloom_merge(RZ_BloomFilter *dst, const RZ_BloomFilter *src) {
+    RZ_ASSERT(dst != NULL && src != NULL);
+    if (dst->nblocks != src->nblocks || dst->seed != src->seed || dst->hash != src->hash) return false;
+    for (rz_usize i = 0; i < dst->nblocks * RZ__BLOOM_BLOCK_WORDS; ++i) dst->words[i] |= src->words[i];
+    return true;
+}
+
+RZ_DEF void rz_bloom_serialize(const RZ_BloomFilter *bf, RZ_BytesArray *bytes) {
+    RZ_ASSERT(bf != NULL && bytes != NULL);
+    rz__filter_put_header(bytes, RZ__BLOOM_MAGIC);
+    rz__filter_put(bytes, bf->nblocks, sizeof(rz_u64));
+    rz__filter_put(bytes, bf->seed, sizeof(rz_u64));
+    rz_arr_reserve(bytes, bytes->len + rz_bloom_size_bytes(bf));
+    for (rz_usize i = 0; i < bf->nblocks * RZ__BLOOM_BLOCK_WORDS; ++i) rz__filter_put(bytes, bf->words[i], sizeof(rz_u32));
+}
+
+RZ_DEF bool rz__bloom_deserialize(RZ_BloomFilter *bf, const rz_u8 *bytes, rz_usize len, RZ__FilterInitOpt opt) {
+    RZ_ASSERT(bf != NULL && bytes != NULL);
+    rz__filter_default_opt(&opt);
+    RZ__FilterReader r       = {.p = bytes, .len = len};
+    rz_u64           nblocks = 0, seed = 0, word = 0;
+    if (!rz__filter_get_header(&r, RZ__BLOOM_MAGIC)) return false;
+    if (!rz__filter_get(&r, sizeof(rz_u64), &nblocks) || !rz__filter_get(&r, sizeof(rz_u64), &seed)) return false;
+    if (nblocks == 0 || (r.len / (RZ__BLOOM_BLOCK_WORDS * sizeof(rz_u32))) != nblocks || (r.len % (RZ__BLOOM_BLOCK_WORDS * sizeof(rz_u32))) != 0) return false;
+
+    *bf = (RZ_BloomFilter){
+        .nblocks   = (rz_usize)nblocks,
+        .hash      = opt.hash,
+        .seed      = (rz_usize)seed,
+        .allocator = opt.allocator,
+    };
+    bf->words = rz_raw_alloc(bf->allocator, rz_bloom_size_bytes(bf));
+    RZ_ASSERT_ALLOCATOR_PTR(bf->words);
+    for (rz_usize i = 0; i < bf->nblocks * RZ__BLOOM_BLOCK_WORDS; ++i) {
+        rz__filter_get(&r, sizeof(rz_u32), &word);
+        bf->words[i] = (rz_u32)word;
+    }
+    return true;
+}
+
+///////////////
+/// CuckooFilter
+///
+#    define RZ__CUCKOO_LOAD_FACTOR 0.95
+
+static inline rz_u16 rz__cuckoo_fingerprint(rz_u64 h) {
+    rz_u16 fp = (rz_u16)(h >> 48u);
+    return fp ? fp : 1;
+}
+
+static inline rz_usize rz__cuckoo_alt_index(const RZ_CuckooFilter *cf, rz_usize index, rz_u16 fp) {
+    // partial key cuckoo hashing, the alternate bucket only depend on the current bucket and the fingerprint.
+    return (index ^ ((rz_usize)fp * 0x5bd1e995U)) & (cf->nbuckets - 1);
+}
+
+// SWAR: check the 4 slots of the bucket at once.
+static inline bool rz__cuckoo_bucket_has(const RZ_CuckooFilter *cf, rz_usize index, rz_u16 fp) {
+    rz_u64 bucket = 0;
+    memcpy(&bucket, cf->slots + (index * RZ_CUCKOO_BUCKET_SLOTS), sizeof(bucket));
+    rz_u64 x = bucket ^ ((rz_u64)fp * 0x0001000100010001ull);
+    return ((x - 0x0001000100010001ull) & ~x & 0x8000800080008000ull) != 0;
+}
+
+static inline bool rz__cuckoo_bucket_put(RZ_CuckooFilter *cf, rz_usize index, rz_u16 fp) {
+    rz_u16 *bucket = cf->slots + (index * RZ_CUCKOO_BUCKET_SLOTS);
+    for (rz_usize i = 0; i < RZ_CUCKOO_BUCKET_SLOTS; ++i) {
+        if (bucket[i] == 0) {
+            bucket[i] = fp;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline bool rz__cuckoo_bucket_del(RZ_CuckooFilter *cf, rz_usize index, rz_u16 fp) {
+    rz_u16 *bucket = cf->slots + (index * RZ_CUCKOO_BUCKET_SLOTS);
+    for (rz_usize i = 0; i < RZ_CUCKOO_BUCKET_SLOTS; ++i) {
+        if (bucket[i] == fp) {
+            bucket[i] = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline rz_u64 rz__cuckoo_rand(RZ_CuckooFilter *cf) {
+    cf->rng ^= cf->rng << 13u;
+    cf->rng ^= cf->rng >> 7u;
+    cf->rng ^= cf->rng << 17u;
+    return cf->rng;
+}
+
+// insert fingerprint into `index` or its alternate bucket, evicting other fingerprint when both is full.
+// the last evicted fingerprint is kept in the victim slot when there is no room after RZ_CUCKOO_MAX_KICKS.
+static void rz__cuckoo_insert(RZ_CuckooFilter *cf, rz_usize index, rz_u16 fp) {
+    if (rz__cuckoo_bucket_put(cf, index, fp)) return;
+    index = rz__cuckoo_alt_index(cf, index, fp);
+    if (rz__cuckoo_bucket_put(cf, index, fp)) return;
+
+    for (rz_usize kick = 0; kick < RZ_CUCKOO_MAX_KICKS; ++kick) {
+        rz_u16 *slot = cf->slots + (index * RZ_CUCKOO_BUCKET_SLOTS) + (rz__cuckoo_rand(cf) % RZ_CUCKOO_BUCKET_SLOTS);
+        rz_u16  old  = *slot;
+        *slot        = fp;
+        fp           = old;
+        index        = rz__cuckoo_alt_index(cf, index, fp);
+        if (rz__cuckoo_bucket_put(cf, index, fp)) return;
+    }
+    cf->victim.index       = index;
+    cf->victim.fingerprint = fp;
+    cf->victim.used        = true;
+}
+
+RZ_DEF void rz__cuckoo_init(RZ_CuckooFilter *cf, RZ__FilterInitOpt opt) {
+    RZ_ASSERT_NOT_NULL(cf);
+    rz__filter_default_opt(&opt);
+    rz_usize nbuckets = (rz_usize)((rz_f64)opt.expected_count / (RZ_CUCKOO_BUCKET_SLOTS * RZ__CUCKOO_LOAD_FACTOR)) + 1;
+    *cf               = (RZ_CuckooFilter){
+                      .nbuckets  = rz_next_pow2(nbuckets),
+                      .hash      = opt.hash,
+                      .seed      = opt.seed,
+                      .allocator = opt.allocator,
+                      .rng       = rz__filter_mix64(opt.seed) | 1u,
+    };
+    cf->slots = rz_raw_calloc(cf->allocator, cf->nbuckets * RZ_CUCKOO_BUCKET_SLOTS, sizeof(rz_u16));
+    RZ_ASSERT_ALLOCATOR_PTR(cf->slots);
+}
+
+RZ_DEF void rz_cuckoo_free(RZ_CuckooFilter *cf) {
+    RZ_ASSERT_NOT_NULL(cf);
+    if (cf->slots != NULL) rz_raw_dealloc(cf->allocator, cf->slots, cf->nbuckets * RZ_CUCKOO_BUCKET_SLOTS * sizeof(rz_u16));
+    cf->slots    = NULL;
+    cf->nbuckets = 0;
+    cf->len      = 0;
+}
+
+RZ_DEF void rz_cuckoo_clear(RZ_CuckooFilter *cf) {
+    if (cf->slots != NULL) memset(cf->slots, 0, cf->nbuckets * RZ_CUCKOO_BUCKET_SLOTS * sizeof(rz_u16));
+    cf->len         = 0;
+    cf->victim.used = false;
+}
+
+RZ_DEF bool rz_cuckoo_add_hash(RZ_CuckooFilter *cf, rz_u64 hash) {
+    RZ_DBG_ASSERT(cf->slots != NULL);
+    if (cf->victim.used) return false;
+    hash = rz__filter_mix64(hash);
+    rz__cuckoo_insert(cf, (rz_usize)hash & (cf->nbuckets - 1), rz__cuckoo_fingerprint(hash));
+    cf->len++;
+    return true;
+}
+
+RZ_DEF bool rz_cuckoo_contains_hash(const RZ_CuckooFilter *cf, rz_u64 hash) {
+    if (cf->slots == NULL) return false;
+    hash        = rz__filter_mix64(hash);
+    rz_u16   fp = rz__cuckoo_fingerprint(hash);
+    rz_usize i1 = (rz_usize)hash & (cf->nbuckets - 1);
+    rz_usize i2 = rz__cuckoo_alt_index(cf, i1, fp);
+    if (rz__cuckoo_bucket_has(cf, i1, fp) || rz__cuckoo_bucket_has(cf, i2, fp)) return true;
+    return cf->victim.used && cf->victim.fingerprint == fp && (cf->victim.index == i1 || cf->victim.index == i2);
+}
+
+RZ_DEF bool rz_cuckoo_remove_hash(RZ_CuckooFilter *cf, rz_u64 hash) {
+    if (cf->slots == NULL) return false;
+    hash        = rz__filter_mix64(hash);
+    rz_u16   fp = rz__cuckoo_fingerprint(hash);
+    rz_usize i1 = (rz_usize)hash & (cf->nbuckets - 1);
+    rz_usize i2 = rz__cuckoo_alt_index(cf, i1, fp);
+    if (rz__cuckoo_bucket_del(cf, i1, fp) || rz__cuckoo_bucket_del(cf, i2, fp)) {
+        cf->len--;
+        // there is room now, move the victim back into the table.
+        if (cf->victim.used) {
+            cf->victim.used = false;
+            rz__cuckoo_insert(cf, cf->victim.index, cf->victim.fingerprint);
+        }
+        return true;
+    }
+    if (cf->victim.used && cf->victim.fingerprint == fp && (cf->victim.index == i1 || cf->victim.index == i2)) {
+        cf->victim.used = false;
+        cf->len--;
+        return true;
+    }
+    return false;
+}
+
+RZ_DEF bool rz_cuckoo_add(RZ_CuckooFilter *cf, const void *data, rz_usize size) {
+    return rz_cuckoo_add_hash(cf, cf->hash(data, size, cf->seed));
+}
+
+RZ_DEF bool rz_cuckoo_contains(const RZ_CuckooFilter *cf, const void *data, rz_usize size) {
+    return rz_cuckoo_contains_hash(cf, cf->hash(data, size, cf->seed));
+}
+
+RZ_DEF bool rz_cuckoo_remove(RZ_CuckooFilter *cf, const void *data, rz_usize size) {
+    return rz_cuckoo_remove_hash(cf, cf->hash(data, size, cf->seed));
+}
+
+RZ_DEF void rz_cuckoo_serialize(const RZ_CuckooFilter *cf, RZ_BytesArray *bytes) {
+    RZ_ASSERT(cf != NULL && bytes != NULL);
+    rz__filter_put_header(bytes, RZ__CUCKOO_MAGIC);
+    rz__filter_put(bytes, cf->nbuckets, sizeof(rz_u64));
+    rz__filter_put(bytes, cf->len, sizeof(rz_u64));
+    rz__filter_put(bytes, cf->seed, sizeof(rz_u64));
+    rz__filter_put(bytes, cf->victim.used, sizeof(rz_u8));
+    rz__filter_put(bytes, cf->victim.fingerprint, sizeof(rz_u16));
+    rz__filter_put(bytes, cf->victim.index, sizeof(rz_u64));
+    rz_arr_reserve(bytes, bytes->len + (cf->nbuckets * RZ_CUCKOO_BUCKET_SLOTS * sizeof(rz_u16)));
+    for (rz_usize i = 0; i < cf->nbuckets * RZ_CUCKOO_BUCKET_SLOTS; ++i) rz__filter_put(bytes, cf->slots[i], sizeof(rz_u16));
+}
+
+RZ_DEF bool rz__cuckoo_deserialize(RZ_CuckooFilter *cf, const rz_u8 *bytes, rz_usize len, RZ__FilterInitOpt opt) {
+    RZ_ASSERT(cf != NULL && bytes != NULL);
+    rz__filter_default_opt(&opt);
+    RZ__FilterReader r        = {.p = bytes, .len = len};
+    rz_u64           nbuckets = 0, count = 0, seed = 0, used = 0, fp = 0, index = 0, slot = 0;
+    if (!rz__filter_get_header(&r, RZ__CUCKOO_MAGIC)) return false;
+    if (!rz__filter_get(&r, sizeof(rz_u64), &nbuckets) || !rz__filter_get(&r, sizeof(rz_u64), &count) || !rz__filter_get(&r, sizeof(rz_u64), &seed) ||
+        !rz__filter_get(&r, sizeof(rz_u8), &used) || !rz__filter_get(&r, sizeof(rz_u16), &fp) || !rz__filter_get(&r, sizeof(rz_u64), &index))
+        return false;
+    if (nbuckets == 0 || !rz_is_pow2(nbuckets) || index >= nbuckets || (r.len / (RZ_CUCKOO_BUCKET_SLOTS * sizeof(rz_u16))) != nbuckets ||
+        (r.len % (RZ_CUCKOO_BUCKET_SLOTS * sizeof(rz_u16))) != 0)
+        return false;
+
+    *cf = (RZ_CuckooFilter){
+        .nbuckets  = (rz_usize)nbuckets,
+        .len       = (rz_usize)count,
+        .hash      = opt.hash,
+        .seed      = (rz_usize)seed,
+        .allocator = opt.allocator,
+        .victim    = {.index = (rz_usize)index, .fingerprint = (rz_u16)fp, .used = used != 0},
+        .rng       = rz__filter_mix64(seed) | 1u,
+    };
+    cf->slots = rz_raw_alloc(cf->allocator, cf->nbuckets * RZ_CUCKOO_BUCKET_SLOTS * sizeof(rz_u16));
+    RZ_ASSERT_ALLOCATOR_PTR(cf->slots);
+    for (rz_usize i = 0; i < cf->nbuckets * RZ_CUCKOO_BUCKET_SLOTS; ++i) {
+        rz__filter_get(&r, sizeof(rz_u16), &slot);
+        cf->slots[i] = (rz_u16)slot;
+    }
+    return true;
+}
+
+///////////////
+/// Sketches
+///
+static void rz__sketch_default_opt(RZ__SketchInitOpt *opt) {
+    if (opt->hash == NULL) opt->hash = rz_hm_default_hash;
+    if (!rz_is_allocator(opt->allocator)) opt->allocator = rz_std_allocator();
+    if (opt->precision == 0) opt->precision = RZ_HLL_DEFAULT_PRECISION;
+    if (opt->epsilon <= 0.0 || opt->epsilon >= 1.0) opt->epsilon = 0.001;
+    if (opt->delta <= 0.0 || opt->delta >= 1.0) opt->delta = 0.01;
+    if (opt->capacity == 0) opt->capacity = RZ_TOPK_DEFAULT_CAPACITY;
+}
+
+///////////////
+/// HyperLogLog
+///
+#    define rz__hll_nregisters(hll) ((rz_usize)1 << (hll)->precision)
+
+// newton iteration from above, `x` is in (0, 1) so it converge without overflow.
+static rz_f64 rz__hll_sqrt(rz_f64 x) {
+    rz_f64 y = 1.0;
+    for (int i = 0; i < 64; ++i) {
+        rz_f64 next = 0.5 * (y + (x / y));
+        if (next >= y) break;
+        y = next;
+    }
+    return y;
+}
+
+// the correction of the registers with the maximum rank, and of the zero registers (Ertl, "New cardinality
+// estimation algorithms for HyperLogLog sketches"), the series is summed until the term is below the rounding
+// of the sum. x^(2^k) vanish long before the 64 terms bound, the bound only keep the loop finite.
+#    define RZ__HLL_EPSILON 2.220446049250313e-16 // DBL_EPSILON
+
+static rz_f64 rz__hll_tau(rz_f64 x) {
+    if (x <= 0.0 || x >= 1.0) return 0.0;
+    rz_f64 y = 1.0, z = 1.0 - x;
+    for (int i = 0; i < 64; ++i) {
+        x            = rz__hll_sqrt(x);
+        y           *= 0.5;
+        rz_f64 term  = (1.0 - x) * (1.0 - x) * y;
+        z           -= term;
+        if (term <= z * RZ__HLL_EPSILON) break;
+    }
+    return z / 3.0;
+}
+
+// `x` < 1, the sketch with only zero registers is 0 before
+static rz_f64 rz__hll_sigma(rz_f64 x) {
+    rz_f64 y = 1.0, z = x;
+    for (int i = 0; i < 64; ++i) {
+        x           *= x;
+        rz_f64 term  = x * y;
+        z           += term;
+        y           += y;
+        if (term <= z * RZ__HLL_EPSILON) break;
+    }
+    return z;
+}
+
+static void rz__hll_densify(RZ_HyperLogLog *hll) {
+    hll->registers = rz_raw_calloc(hll->allocator, rz__hll_nregisters(hll), sizeof(rz_u8));
+    RZ_ASSERT_ALLOCATOR_PTR(hll->registers);
+    for (rz_usize i = 0; i < hll->sparse.len; ++i) hll->registers[hll->sparse.data[i] >> 8u] = (rz_u8)hll->sparse.data[i];
+    rz_arr_free(&hll->sparse);
+}
+
+static void rz__hll_set(RZ_HyperLogLog *hll, rz_u32 index, rz_u8 rank) {
+    if (hll->registers != NULL) {
+        if (hll->registers[index] < rank) hll->registers[index] = rank;
+        return;
+    }
+    rz_usize lo = 0, hi = hll->sparse.len;
+    while (lo < hi) {
+        rz_usize mid = lo + ((hi - lo) / 2);
+        if ((hll->sparse.data[mid] >> 8u) < index) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < hll->sparse.len && (hll->sparse.data[lo] >> 8u) == index) {
+        if ((rz_u8)hll->sparse.data[lo] < rank) hll->sparse.data[lo] = (index << 8u) | rank;
+        return;
+    }
+    // the sparse registers is not smaller than the dense one anymore
+    if (((hll->sparse.len + 1) * sizeof(rz_u32)) > rz__hll_nregisters(hll)) {
+        rz__hll_densify(hll);
+        hll->registers[index] = rank;
+        return;
+    }
+    rz_arr_reserve(&hll->sparse, hll->sparse.len + 1);
+    memmove(hll->sparse.data + lo + 1, hll->sparse.data + lo, (hll->sparse.len - lo) * sizeof(rz_u32));
+    hll->sparse.data[lo] = (index << 8u) | rank;
+    hll->sparse.len++;
+}
+
+// `dst[i] = max(dst[i], src[i])`
+static void rz__hll_max_bytes(rz_u8 *dst, const rz_u8 *src, rz_usize len) {
+    rz_usize i = 0;
+#    if RZ_TARGET_SIMD_AVX2
+    for (; (i + 32) <= len; i += 32) {
+        __m256i v = _mm256_max_epu8(_mm256_loadu_si256((const __m256i *)(dst + i)), _mm256_loadu_si256((const __m256i *)(src + i)));
+        _mm256_storeu_si256((__m256i *)(dst + i), v);
+    }
+#    elif RZ_TARGET_SIMD_SSE2
+    for (; (i + 16) <= len; i += 16) {
+        __m128i v = _mm_max_epu8(_mm_loadu_si128((const __m128i *)(dst + i)), _mm_loadu_si128((const __m128i *)(src + i)));
+        _mm_storeu_si128((__m128i *)(dst + i), v);
+    }
+#    endif
+    for (; i < len; ++i) dst[i] = RZ_MAX(dst[i], src[i]);
+}
+
+RZ_DEF void rz__hll_init(RZ_HyperLogLog *hll, RZ__SketchInitOpt opt) {
+    RZ_ASSERT_NOT_NULL(hll);
+    rz__sketch_default_opt(&opt);
+    RZ_ASSERT(opt.precision >= RZ_HLL_MIN_PRECISION && opt.precision <= RZ_HLL_MAX_PRECISION, "invalid HyperLogLog precision");
+    *hll = (RZ_HyperLogLog){
+        .sparse    = {.allocator = opt.allocator},
+        .precision = opt.precision,
+        .hash      = opt.hash,
+        .seed      = opt.seed,
+        .allocator = opt.allocator,
+    };
+}
+
+RZ_DEF void rz_hll_free(RZ_HyperLogLog *hll) {
+    RZ_ASSERT_NOT_NULL(hll);
+    if (hll->registers != NULL) rz_raw_dealloc(hll->allocator, hll->registers, rz__hll_nregisters(hll));
+    hll->registers = NULL;
+    rz_arr_free(&hll->sparse);
+}
+
+RZ_DEF void rz_hll_clear(RZ_HyperLogLog *hll) {
+    rz_hll_free(hll);
+}
+
+RZ_DEF void rz_hll_add_hash(RZ_HyperLogLog *hll, rz_u64 hash) {
+    hash = rz__filter_mix64(hash);
+    // the index is the high bits, the rank is the position of the first set bit of the rest (1 based),
+    // the sentinel bit bound the rank to `64 - precision + 1`.
+    rz_u32 index = (rz_u32)(hash >> (64u - hll->precision));
+    rz_u64 rest  = (hash << hll->precision) | ((rz_u64)1 << (hll->precision - 1u));
+    rz__hll_set(hll, index, (rz_u8)(rz_clz64(rest) + 1u));
+}
+
+RZ_DEF void rz_hll_add(RZ_HyperLogLog *hll, const void *data, rz_usize size) {
+    rz_hll_add_hash(hll, hll->hash(data, size, hll->seed));
+}
+
+RZ_DEF rz_f64 rz_hll_estimate(const RZ_HyperLogLog *hll) {
+    RZ_ASSERT_NOT_NULL(hll);
+    // counts[k] is the amount of registers with rank k (0 ... q + 1)
+    rz_usize counts[64 - RZ_HLL_MIN_PRECISION + 2] = {0};
+    rz_u32   q = 64u - hll->precision;
+    rz_usize m = rz__hll_nregisters(hll);
+    if (hll->registers != NULL) {
+        for (rz_usize i = 0; i < m; ++i) counts[hll->registers[i]]++;
+    } else {
+        counts[0] = m - hll->sparse.len;
+        for (rz_usize i = 0; i < hll->sparse.len; ++i) counts[(rz_u8)hll->sparse.data[i]]++;
+    }
+    if (counts[0] == m) return 0.0;
+
+    rz_f64 z = (rz_f64)m * rz__hll_tau(1.0 - ((rz_f64)counts[q + 1] / (rz_f64)m));
+    for (rz_u32 k = q; k >= 1; --k) z = 0.5 * (z + (rz_f64)counts[k]);
+    z += (rz_f64)m * rz__hll_sigma((rz_f64)counts[0] / (rz_f64)m);
+    // alpha_inf = 1 / (2 ln 2)
+    return (0.721347520444481703680 * (rz_f64)m * (rz_f64)m) / z;
+}
+
+RZ_DEF bool rz_hll_merge(RZ_HyperLogLog *dst, const RZ_HyperLogLog *src) {
+    RZ_ASSERT(dst != NULL && src != NULL);
+    if (dst->precision != src->precision || dst->seed != src->seed || dst->hash != src->hash) return false;
+    if (src->registers == NULL) {
+        for (rz_usize i = 0; i < src->sparse.len; ++i) rz__hll_set(dst, src->sparse.data[i] >> 8u, (rz_u8)src->sparse.data[i]);
+        return true;
+    }
+    if (dst->registers == NULL) rz__hll_densify(dst);
+    rz__hll_max_bytes(dst->registers, src->registers, rz__hll_nregisters(dst));
+    return true;
+}
+
+RZ_DEF void rz_hll_serialize(const RZ_HyperLogLog *hll, RZ_BytesArray *bytes) {
+    RZ_ASSERT(hll != NULL && bytes != NULL);
+    rz__filter_put_header(bytes, RZ__HLL_MAGIC);
+    rz__filter_put(bytes, hll->precision, sizeof(rz_u8));
+    rz__filter_put(bytes, hll->seed, sizeof(rz_u64));
+    rz__filter_put(bytes, hll->registers == NULL, sizeof(rz_u8));
+    if (hll->registers == NULL) {
+        rz__filter_put(bytes, hll->sparse.len, sizeof(rz_u64));
+        for (rz_usize i = 0; i < hll->sparse.len; ++i) rz__filter_put(bytes, hll->sparse.data[i], sizeof(rz_u32));
+    } else {
+        rz_arr_append_many(bytes, hll->registers, rz__hll_nregisters(hll));
+    }
+}
+
+RZ_DEF bool rz__hll_deserialize(RZ_HyperLogLog *hll, const rz_u8 *bytes, rz_usize len, RZ__SketchInitOpt opt) {
+    RZ_ASSERT(hll != NULL && bytes != NULL);
+    RZ__FilterReader r         = {.p = bytes, .len = len};
+    rz_u64           precision = 0, seed = 0, sparse = 0, count = 0, item = 0;
+    if (!rz__filter_get_header(&r, RZ__HLL_MAGIC)) return false;
+    if (!rz__filter_get(&r, sizeof(rz_u8), &precision) || !rz__filter_get(&r, sizeof(rz_u64), &seed) || !rz__filter_get(&r, sizeof(rz_u8), &sparse)) return false;
+    if (precision < RZ_HLL_MIN_PRECISION || precision > RZ_HLL_MAX_PRECISION) return false;
+
+    rz_usize m = (rz_usize)1 << precision;
+    rz_u64   q = 64u - precision;
+    if (sparse != 0) {
+        if (!rz__filter_get(&r, sizeof(rz_u64), &count) || count > m || r.len != count * sizeof(rz_u32)) return false;
+        // sorted by index, and the rank is valid
+        for (rz_usize i = 0, prev = 0; i < count; ++i) {
+            item = (rz_u64)r.p[i * 4] | ((rz_u64)r.p[(i * 4) + 1] << 8u) | ((rz_u64)r.p[(i * 4) + 2] << 16u) | ((rz_u64)r.p[(i * 4) + 3] << 24u);
+            if ((item >> 8u) >= m || (i > 0 && (item >> 8u) <= prev) || (item & 0xffu) == 0 || (item & 0xffu) > q + 1) return false;
+            prev = (rz_usize)(item >> 8u);
+        }
+    } else {
+        if (r.len != m) return false;
+        for (rz_usize i = 0; i < m; ++i) {
+            if (r.p[i] > q + 1) return false;
+        }
+    }
+
+    opt.precision = (rz_u8)precision;
+    opt.seed      = (rz_usize)seed;
+    rz__hll_init(hll, opt);
+    if (sparse != 0) {
+        rz_arr_reserve(&hll->sparse, count);
+        for (rz_usize i = 0; i < count; ++i) {
+            rz__filter_get(&r, sizeof(rz_u32), &item);
+            rz_arr_append(&hll->sparse, (rz_u32)item);
+        }
+    } else {
+        hll->registers = rz_raw_alloc(hll->allocator, m);
+        RZ_ASSERT_ALLOCATOR_PTR(hll->registers);
+        memcpy(hll->registers, r.p, m);
+    }
+    return true;
+}
+
+///////////////
+/// CountMinSketch
+///
+#    define RZ__CMS_MAX_DEPTH 32U
+
+// the column of the row, double hashing of the 2 halves of the hash and fast range reduction.
+static inline rz_usize rz__cms_column(const RZ_CountMinSketch *cms, rz_u64 h, rz_usize row) {
+    rz_u32 x = (rz_u32)h + ((rz_u32)row * ((rz_u32)(h >> 32u) | 1u));
+    return (rz_usize)(((rz_u64)x * (rz_u64)cms->width) >> 32u);
+}
+
+// the estimate is the minimum counter of the rows, `h` is already mixed
+static rz_u64 rz__cms_min(const RZ_CountMinSketch *cms, rz_u64 h) {
+    rz_u64 estimate = RZ_U64_MAX;
+    for (rz_usize row = 0; row < cms->depth; ++row) estimate = RZ_MIN(estimate, cms->counters[(row * cms->width) + rz__cms_column(cms, h, row)]);
+    return estimate;
+}
+
+RZ_DEF void rz__cms_init(RZ_CountMinSketch *cms, RZ__SketchInitOpt opt) {
+    RZ_ASSERT_NOT_NULL(cms);
+    rz__sketch_default_opt(&opt);
+    // width = e / epsilon, depth = ln(1 / delta)
+    rz_usize depth = 1;
+    while (depth < RZ__CMS_MAX_DEPTH && rz__filter_exp_neg((rz_f64)depth) > opt.delta) depth++;
+    *cms = (RZ_CountMinSketch){
+        .width     = (rz_usize)(2.718281828459045 / opt.epsilon) + 1,
+        .depth     = depth,
+        .hash      = opt.hash,
+        .seed      = opt.seed,
+        .allocator = opt.allocator,
+    };
+    cms->counters = rz_raw_calloc(cms->allocator, cms->width * cms->depth, sizeof(rz_u64));
+    RZ_ASSERT_ALLOCATOR_PTR(cms->counters);
+}
+
+RZ_DEF void rz_cms_free(RZ_CountMinSketch *cms) {
+    RZ_ASSERT_NOT_NULL(cms);
+    if (cms->counters != NULL) rz_raw_dealloc(cms->allocator, cms->counters, rz_cms_size_bytes(cms));
+    cms->counters = NULL;
+    cms->width    = 0;
+    cms->depth    = 0;
+    cms->total    = 0;
+}
+
+RZ_DEF void rz_cms_clear(RZ_CountMinSketch *cms) {
+    if (cms->counters != NULL) memset(cms->counters, 0, rz_cms_size_bytes(cms));
+    cms->total = 0;
+}
+
+RZ_DEF rz_u64 rz_cms_add_hash(RZ_CountMinSketch *cms, rz_u64 hash, rz_u64 count) {
+    RZ_DBG_ASSERT(cms->counters != NULL);
+    hash = rz__filter_mix64(hash);
+    // conservative update: only the counters below the new estimate is raised, so the
+    // counters shared with other items grow less than with adding `count` into every row.
+    rz_u64 estimate = rz__cms_min(cms, hash) + count;
+    for (rz_usize row = 0; row < cms->depth; ++row) {
+        rz_u64 *counter = cms->counters + (row * cms->width) + rz__cms_column(cms, hash, row);
+        if (*counter < estimate) *counter = estimate;
+    }
+    cms->total += count;
+    return estimate;
+}
+
+RZ_DEF rz_u64 rz_cms_estimate_hash(const RZ_CountMinSketch *cms, rz_u64 hash) {
+    return (cms->counters != NULL) ? rz__cms_min(cms, rz__filter_mix64(hash)) : 0;
+}
+
+RZ_DEF rz_u64 rz_cms_add(RZ_CountMinSketch *cms, const void *data, rz_usize size, rz_u64 count) {
+    return rz_cms_add_hash(cms, cms->hash(data, size, cms->seed), count);
+}
+
+RZ_DEF rz_u64 rz_cms_estimate(const RZ_CountMinSketch *cms, const void *data, rz_usize size) {
+    return rz_cms_estimate_hash(cms, cms->hash(data, size, cms->seed));
+}
+
+RZ_DEF bool rz_cms_merge(RZ_CountMinSketch *dst, const RZ_CountMinSketch *src) {
+    RZ_ASSERT(dst != NULL && src != NULL);
+    if (dst->width != src->width || dst->depth != src->depth || dst->seed != src->seed || dst->hash != src->hash) return false;
+    for (rz_usize i = 0; i < dst->width * dst->depth; ++i) dst->counters[i] += src->counters[i];
+    dst->total += src->total;
+    return true;
+}
+
+RZ_DEF void rz_cms_serialize(const RZ_CountMinSketch *cms, RZ_BytesArray *bytes) {
+    RZ_ASSERT(cms != NULL && bytes != NULL);
+    rz__filter_put_header(bytes, RZ__CMS_MAGIC);
+    rz__filter_put(bytes, cms->width, sizeof(rz_u64));
+    rz__filter_put(bytes, cms->depth, sizeof(rz_u64));
+    rz__filter_put(bytes, cms->seed, sizeof(rz_u64));
+    rz__filter_put(bytes, cms->total, sizeof(rz_u64));
+    rz_arr_reserve(bytes, bytes->len + rz_cms_size_bytes(cms));
+    for (rz_usize i = 0; i < cms->width * cms->depth; ++i) rz__filter_put(bytes, cms->counters[i], sizeof(rz_u64));
+}
+
+RZ_DEF bool rz__cms_deserialize(RZ_CountMinSketch *cms, const rz_u8 *bytes, rz_usize len, RZ__SketchInitOpt opt) {
+    RZ_ASSERT(cms != NULL && bytes != NULL);
+    rz__sketch_default_opt(&opt);
+    RZ__FilterReader r     = {.p = bytes, .len = len};
+    rz_u64           width = 0, depth = 0, seed = 0, total = 0;
+    if (!rz__filter_get_header(&r, RZ__CMS_MAGIC)) return false;
+    if (!rz__filter_get(&r, sizeof(rz_u64), &width) || !rz__filter_get(&r, sizeof(rz_u64), &depth) || !rz__filter_get(&r, sizeof(rz_u64), &seed) ||
+        !rz__filter_get(&r, sizeof(rz_u64), &total))
+        return false;
+    if (width == 0 || width > RZ_U32_MAX || depth == 0 || depth > RZ__CMS_MAX_DEPTH || (r.len / sizeof(rz_u64)) != width * depth || (r.len % sizeof(rz_u64)) != 0) return false;
+
+    *cms = (RZ_CountMinSketch){
+        .width     = (rz_usize)width,
+        .depth     = (rz_usize)depth,
+        .total     = total,
+        .hash      = opt.hash,
+        .seed      = (rz_usize)seed,
+        .allocator = opt.allocator,
+    };
+    cms->counters = rz_raw_alloc(cms->allocator, rz_cms_size_bytes(cms));
+    RZ_ASSERT_ALLOCATOR_PTR(cms->counters);
+    for (rz_usize i = 0; i < cms->width * cms->depth; ++i) rz__filter_get(&r, sizeof(rz_u64), &cms->counters[i]);
+    return true;
+}
+
+///////////////
+/// TopK
+///
+#    define rz__topk_count(tk, i) ((tk)->entries[(tk)->heap[i]].item.count)
+
+static void rz__topk_heap_swap(RZ_TopK *tk, rz_usize a, rz_usize b) {
+    rz_u32 tmp                        = tk->heap[a];
+    tk->heap[a]                       = tk->heap[b];
+    tk->heap[b]                       = tmp;
+    tk->entries[tk->heap[a]].heap_pos = (rz_u32)a;
+    tk->entries[tk->heap[b]].heap_pos = (rz_u32)b;
+}
+
+static void rz__topk_sift_up(RZ_TopK *tk, rz_usize i) {
+    while (i > 0 && rz__topk_count(tk, (i - 1) / 2) > rz__topk_count(tk, i)) {
+        rz__topk_heap_swap(tk, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static void rz__topk_sift_down(RZ_TopK *tk, rz_usize i) {
+    for (;;) {
+        rz_usize min = i, l = (2 * i) + 1, r = l + 1;
+        if (l < tk->len && rz__topk_count(tk, l) < rz__topk_count(tk, min)) min = l;
+        if (r < tk->len && rz__topk_count(tk, r) < rz__topk_count(tk, min)) min = r;
+        if (min == i) return;
+        rz__topk_heap_swap(tk, i, min);
+        i = min;
+    }
+}
+
+// the slot of the key, or the empty slot where the key would be inserted
+static rz_usize rz__topk_probe(const RZ_TopK *tk, rz_u64 hash, const rz_u8 *key, rz_usize key_len) {
+    rz_usize mask = tk->nslots - 1;
+    for (rz_usize i = (rz_usize)hash & mask;; i = (i + 1) & mask) {
+        if (tk->slots[i] == 0) return i;
+        const RZ__TopKEntry *e = &tk->entries[tk->slots[i] - 1];
+        if (e->hash == hash && e->item.key_len == key_len && (key_len == 0 || memcmp(e->item.key, key, key_len) == 0)) return i;
+    }
+}
+
+// backward shift deletion, the following entries of the cluster is moved into the hole when it is
+// between their home slot and their current slot.
+static void rz__topk_unindex(RZ_TopK *tk, rz_usize hole) {
+    rz_usize mask = tk->nslots - 1;
+    tk->slots[hole] = 0;
+    for (rz_usize j = (hole + 1) & mask; tk->slots[j] != 0; j = (j + 1) & mask) {
+        rz_usize home = (rz_usize)tk->entries[tk->slots[j] - 1].hash & mask;
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            tk->slots[hole] = tk->slots[j];
+            tk->slots[j]    = 0;
+            hole            = j;
+        }
+    }
+}
+
+static void rz__topk_key_free(RZ_TopK *tk, RZ__TopKEntry *e) {
+    if (e->item.key_len > 0) rz_raw_dealloc(tk->allocator, (void *)e->item.key, e->item.key_len);
+    e->item.key     = NULL;
+    e->item.key_len = 0;
+}
+
+static void rz__topk_key_set(RZ_TopK *tk, RZ__TopKEntry *e, rz_u64 hash, const rz_u8 *key, rz_usize key_len) {
+    rz_u8 *copy = NULL;
+    if (key_len > 0) {
+        copy = rz_raw_alloc(tk->allocator, key_len);
+        RZ_ASSERT_ALLOCATOR_PTR(copy);
+        memcpy(copy, key, key_len);
+    }
+    e->item.key     = copy;
+    e->item.key_len = key_len;
+    e->hash         = hash;
+}
+
+// space saving update of the key, the untracked key replace the minimum entry when the sketch is full
+// and inherit its count as the error.
+static rz_u64 rz__topk_update(RZ_TopK *tk, rz_u64 hash, const rz_u8 *key, rz_usize key_len, rz_u64 count, rz_u64 error) {
+    rz_usize slot = rz__topk_probe(tk, hash, key, key_len);
+    if (tk->slots[slot] != 0) {
+        RZ__TopKEntry *e = &tk->entries[tk->slots[slot] - 1];
+        e->item.count += count;
+        e->item.error += error;
+        rz__topk_sift_down(tk, e->heap_pos);
+        return e->item.count;
+    }
+
+    rz_u32 index;
+    if (tk->len < tk->capacity) {
+        index              = (rz_u32)tk->len;
+        tk->heap[tk->len]  = index;
+        tk->entries[index] = (RZ__TopKEntry){.heap_pos = (rz_u32)tk->len};
+        tk->len++;
+    } else {
+        index            = tk->heap[0];
+        RZ__TopKEntry *e = &tk->entries[index];
+        count += e->item.count;
+        error += e->item.count;
+        rz__topk_unindex(tk, rz__topk_probe(tk, e->hash, e->item.key, e->item.key_len));
+        rz__topk_key_free(tk, e);
+        slot = rz__topk_probe(tk, hash, key, key_len);
+    }
+    RZ__TopKEntry *e = &tk->entries[index];
+    rz__topk_key_set(tk, e, hash, key, key_len);
+    e->item.count   = count;
+    e->item.error   = error;
+    tk->slots[slot] = index + 1;
+    rz__topk_sift_up(tk, e->heap_pos);
+    rz__topk_sift_down(tk, e->heap_pos);
+    return count;
+}
+
+static int rz__topk_item_cmp(const void *a, const void *b) {
+    rz_u64 ca = ((const RZ_TopKItem *)a)->count, cb = ((const RZ_TopKItem *)b)->count;
+    return (ca < cb) - (ca > cb);
+}
+
+RZ_DEF void rz__topk_init(RZ_TopK *tk, RZ__SketchInitOpt opt) {
+    RZ_ASSERT_NOT_NULL(tk);
+    rz__sketch_default_opt(&opt);
+    RZ_ASSERT(opt.capacity < RZ_U32_MAX / 2, "TopK capacity is too big");
+    *tk = (RZ_TopK){
+        .nslots    = rz_next_pow2(opt.capacity * 2),
+        .capacity  = opt.capacity,
+        .hash      = opt.hash,
+        .seed      = opt.seed,
+        .allocator = opt.allocator,
+    };
+    tk->entries = rz_raw_alloc(tk->allocator, tk->capacity * sizeof(RZ__TopKEntry));
+    tk->heap    = rz_raw_alloc(tk->allocator, tk->capacity * sizeof(rz_u32));
+    tk->slots   = rz_raw_calloc(tk->allocator, tk->nslots, sizeof(rz_u32));
+    RZ_ASSERT_ALLOCATOR_PTR(tk->entries);
+    RZ_ASSERT_ALLOCATOR_PTR(tk->heap);
+    RZ_ASSERT_ALLOCATOR_PTR(tk->slots);
+}
+
+RZ_DEF void rz_topk_free(RZ_TopK *tk) {
+    RZ_ASSERT_NOT_NULL(tk);
+    if (tk->entries == NULL) return;
+    rz_topk_clear(tk);
+    rz_raw_dealloc(tk->allocator, tk->entries, tk->capacity * sizeof(RZ__TopKEntry));
+    rz_raw_dealloc(tk->allocator, tk->heap, tk->capacity * sizeof(rz_u32));
+    rz_raw_dealloc(tk->allocator, tk->slots, tk->nslots * sizeof(rz_u32));
+    tk->entries  = NULL;
+    tk->heap     = NULL;
+    tk->slots    = NULL;
+    tk->nslots   = 0;
+    tk->capacity = 0;
+}
+
+RZ_DEF void rz_topk_clear(RZ_TopK *tk) {
+    for (rz_usize i = 0; i < tk->len; ++i) rz__topk_key_free(tk, &tk->entries[i]);
+    if (tk->slots != NULL) memset(tk->slots, 0, tk->nslots * sizeof(rz_u32));
+    tk->len = 0;
+}
+
+RZ_DEF rz_u64 rz_topk_add(RZ_TopK *tk, const void *key, rz_usize key_len, rz_u64 count) {
+    RZ_DBG_ASSERT(tk->entries != NULL);
+    return rz__topk_update(tk, tk->hash(key, key_len, tk->seed), key, key_len, count, 0);
+}
+
+RZ_DEF rz_u64 rz_topk_count(const RZ_TopK *tk, const void *key, rz_usize key_len) {
+    if (tk->entries == NULL) return 0;
+    rz_usize slot = rz__topk_probe(tk, tk->hash(key, key_len, tk->seed), key, key_len);
+    return (tk->slots[slot] != 0) ? tk->entries[tk->slots[slot] - 1].item.count : 0;
+}
+
+RZ_DEF rz_usize rz_topk_items(const RZ_TopK *tk, RZ_TopKItem *items, rz_usize cap) {
+    RZ_ASSERT(tk != NULL && (items != NULL || cap == 0));
+    if (cap >= tk->len) {
+        for (rz_usize i = 0; i < tk->len; ++i) items[i] = tk->entries[i].item;
+        qsort(items, tk->len, sizeof(RZ_TopKItem), rz__topk_item_cmp);
+        return tk->len;
+    }
+    if (cap == 0) return 0;
+    // partial selection, insertion of the bigger counts into the sorted `items`
+    rz_usize len = 0;
+    for (rz_usize i = 0; i < tk->len; ++i) {
+        const RZ_TopKItem *item = &tk->entries[i].item;
+        if (len == cap && items[cap - 1].count >= item->count) continue;
+        rz_usize pos = (len < cap) ? len++ : cap - 1;
+        while (pos > 0 && items[pos - 1].count < item->count) {
+            items[pos] = items[pos - 1];
+            pos--;
+        }
+        items[pos] = *item;
+    }
+    return len;
+}
+
+RZ_DEF void rz_topk_merge(RZ_TopK *dst, const RZ_TopK *src) {
+    RZ_ASSERT(dst != NULL && src != NULL && dst != src);
+    if (src->len == 0) return;
+    rz_u64 dst_min = (dst->len == dst->capacity && dst->len > 0) ? rz__topk_count(dst, 0) : 0;
+    rz_u64 src_min = (src->len == src->capacity && src->len > 0) ? rz__topk_count(src, 0) : 0;
+
+    // the union of the two summaries, the key missing from one side get the minimum count of that side
+    rz_usize     len   = 0;
+    RZ_TopKItem *items = rz_raw_alloc(dst->allocator, (dst->len + src->len) * sizeof(RZ_TopKItem));
+    RZ_ASSERT_ALLOCATOR_PTR(items);
+    for (rz_usize i = 0; i < dst->len; ++i) {
+        RZ_TopKItem item      = dst->entries[i].item;
+        rz_u64      src_count = rz_topk_count(src, item.key, item.key_len);
+        item.count += (src_count != 0) ? src_count : src_min;
+        item.error += (src_count != 0) ? 0 : src_min;
+        items[len++] = item;
+    }
+    for (rz_usize i = 0; i < src->len; ++i) {
+        RZ_TopKItem item = src->entries[i].item;
+        if (rz_topk_count(dst, item.key, item.key_len) != 0) continue;
+        item.count += dst_min;
+        item.error += dst_min;
+        items[len++] = item;
+    }
+    qsort(items, len, sizeof(RZ_TopKItem), rz__topk_item_cmp);
+
+    // rebuild `dst` from the biggest counts, the keys is copied before the old keys is freed
+    RZ_TopK merged = {0};
+    rz_topk_init(&merged, .capacity = dst->capacity, .hash = dst->hash, .seed = dst->seed, .allocator = dst->allocator);
+    for (rz_usize i = 0; i < RZ_MIN(len, merged.capacity); ++i) {
+        rz_u64 hash = merged.hash(items[i].key, items[i].key_len, merged.seed);
+        rz__topk_update(&merged, hash, items[i].key, items[i].key_len, items[i].count, items[i].error);
+    }
+    rz_raw_dealloc(dst->allocator, items, (dst->len + src->len) * sizeof(RZ_TopKItem));
+    rz_topk_free(dst);
+    *dst = merged;
+}
+
+RZ_DEF void rz_topk_serialize(const RZ_TopK *tk, RZ_BytesArray *bytes) {
+    RZ_ASSERT(tk != NULL && bytes != NULL);
+    rz__filter_put_header(bytes, RZ__TOPK_MAGIC);
+    rz__filter_put(bytes, tk->capacity, sizeof(rz_u64));
+    rz__filter_put(bytes, tk->seed, sizeof(rz_u64));
+    rz__filter_put(bytes, tk->len, sizeof(rz_u64));
+    for (rz_usize i = 0; i < tk->len; ++i) {
+        const RZ_TopKItem *item = &tk->entries[i].item;
+        rz__filter_put(bytes, item->count, sizeof(rz_u64));
+        rz__filter_put(bytes, item->error, sizeof(rz_u64));
+        rz__filter_put(bytes, item->key_len, sizeof(rz_u64));
+        if (item->key_len > 0) rz_arr_append_many(bytes, item->key, item->key_len);
+    }
+}
+
+RZ_DEF bool rz__topk_deserialize(RZ_TopK *tk, const rz_u8 *bytes, rz_usize len, RZ__SketchInitOpt opt) {
+    RZ_ASSERT(tk != NULL && bytes != NULL);
+    RZ__FilterReader r        = {.p = bytes, .len = len};
+    rz_u64           capacity = 0, seed = 0, count = 0;
+    if (!rz__filter_get_header(&r, RZ__TOPK_MAGIC)) return false;
+    if (!rz__filter_get(&r, sizeof(rz_u64), &capacity) || !rz__filter_get(&r, sizeof(rz_u64), &seed) || !rz__filter_get(&r, sizeof(rz_u64), &count)) return false;
+    if (capacity == 0 || capacity >= RZ_U32_MAX / 2 || count > capacity) return false;
+
+    // validate the entries before anything is allocated
+    RZ__FilterReader entries = r;
+    for (rz_u64 i = 0, key_len = 0, value = 0; i < count; ++i) {
+        if (!rz__filter_get(&entries, sizeof(rz_u64), &value) || !rz__filter_get(&entries, sizeof(rz_u64), &value) ||
+            !rz__filter_get(&entries, sizeof(rz_u64), &key_len) || entries.len < key_len)
+            return false;
+        entries.p += key_len;
+        entries.len -= key_len;
+    }
+    if (entries.len != 0) return false;
+
+    opt.capacity = (rz_usize)capacity;
+    opt.seed     = (rz_usize)seed;
+    rz__topk_init(tk, opt);
+    for (rz_u64 i = 0, key_len = 0, item_count = 0, error = 0; i < count; ++i) {
+        rz__filter_get(&r, sizeof(rz_u64), &item_count);
+        rz__filter_get(&r, sizeof(rz_u64), &error);
+        rz__filter_get(&r, sizeof(rz_u64), &key_len);
+        rz__topk_update(tk, tk->hash(r.p, (rz_usize)key_len, tk->seed), r.p, (rz_usize)key_len, item_count, error);
+        r.p += key_len;
+        r.len -= key_len;
+    }
+    return true;
+}
+
+#endif /* ifdef RZ_FILTER_IMPL */
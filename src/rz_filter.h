@@ -0,0 +1,327 @@
+#pragma once
+#ifndef RZ_FILTER_H
+#    define RZ_FILTER_H
+#    include "rz_allocator.h"
+#    include "rz_collections.h"
+#    include "rz_common.h"
+
+/// Approximate membership filters, a cheap negative lookup before the expensive one (RZ_Hm, on disk index, ...).
+/// `contains` never return false for an item that was added (no false negative),
+/// but may return true for an item that was never added (false positive).
+///
+///  - RZ_BloomFilter : split block bloom filter. every item touch exactly one 256 bit block
+///                     (one cache line access), one bit in each of the 8 u32 words of the block.
+///                     the probe compute and test the 8 bits at once with AVX2.
+///  - RZ_CuckooFilter: 16 bit fingerprints in buckets of 4 slots, support `remove`.
+///
+/// and streaming sketches, fixed memory summary of the stream that is too big to keep every key (RZ_Hs):
+///  - RZ_HyperLogLog   : the amount of distinct items, ~1.04 / sqrt(2^precision) standard error.
+///                       sparse (sorted non zero registers) while the cardinality is small, then dense
+///                       (1 byte per register, the merge is the byte max with AVX2).
+///  - RZ_CountMinSketch: the frequency of the item, never under estimated, over estimated by at most
+///                       `epsilon * total` with probability `1 - delta`, conservative update.
+///  - RZ_TopK          : the heavy hitters, space saving with `capacity` counters (min heap + hash index),
+///                       the item with frequency > total / capacity is always tracked.
+///
+/// all of them hash the item with the `rz_hm_*_hash` functions (rz_hm_default_hash by default),
+/// the `*_hash` variants take an already computed 64 bit hash.
+/// they can be serialized into byte buffer (little endian) and loaded back, and the sketches of
+/// different processes can be merged (same options), e.g:
+///
+///  RZ_BloomFilter bf = {0};
+///  rz_bloom_init(&bf, .expected_count = 100000, .fpp = 0.01);
+///  rz_bloom_add(&bf, key, key_len);
+///  RZ_BytesArray bytes = {.allocator = rz_std_allocator()};
+///  rz_bloom_serialize(&bf, &bytes);
+///  rz_fs_write_array(rz_path("index.bloom"), &bytes);
+///  ...
+///  rz_bloom_deserialize(&bf, bytes.data, bytes.len, .allocator = a);
+///
+/// NOTE: the hash function is not serialized, the loader must use the same `hash` as the writer.
+
+#    ifndef RZ_CUCKOO_MAX_KICKS
+#        define RZ_CUCKOO_MAX_KICKS 500U
+#    endif
+
+#    define RZ_CUCKOO_BUCKET_SLOTS 4U
+
+#    if defined(__cplusplus)
+extern "C" {
+#    endif
+
+/// same signature as the rz_hm_*_hash functions
+typedef rz_usize (*RZ_FilterHashFn)(void const *data, rz_usize size, rz_usize seed);
+
+typedef struct {
+    /// amount of items the filter is sized for
+    rz_usize        expected_count;
+    /// target false positive probability, default: 0.01
+    rz_f64          fpp;
+    /// default: rz_hm_default_hash
+    RZ_FilterHashFn hash;
+    rz_usize        seed;
+    /// default: rz_std_allocator()
+    RZ_Allocator    allocator;
+} RZ__FilterInitOpt;
+
+///////////////
+/// BloomFilter
+///
+typedef struct {
+    /// nblocks * 8 words, a block is 256 bits
+    rz_u32         *words;
+    rz_usize        nblocks;
+    RZ_FilterHashFn hash;
+    rz_usize        seed;
+    RZ_Allocator    allocator;
+} RZ_BloomFilter;
+
+// clang-format off
+///    void rz_bloom_init(RZ_BloomFilter *bf, RZ__FilterInitOpt...);
+#    define rz_bloom_init(bf, ...)                   rz__bloom_init(bf, (RZ__FilterInitOpt){ __VA_ARGS__ })
+///  load filter from bytes produced by rz_bloom_serialize. return false if the bytes is not valid bloom filter.
+///  the size and `seed` is read from the bytes, only `hash` and `allocator` is used from the options.
+///    bool rz_bloom_deserialize(RZ_BloomFilter *bf, const rz_u8 *bytes, rz_usize len, RZ__FilterInitOpt...);
+#    define rz_bloom_deserialize(bf, bytes, len, ...) rz__bloom_deserialize(bf, bytes, len, (RZ__FilterInitOpt){ __VA_ARGS__ })
+///    void rz_bloom_add_item(RZ_BloomFilter *bf, T item);
+///    bool rz_bloom_contains_item(RZ_BloomFilter *bf, T item);
+#    define rz_bloom_add_item(bf, item)              rz_bloom_add(bf, RZ_ADDRESSOF(item, item), sizeof(item))
+#    define rz_bloom_contains_item(bf, item)         rz_bloom_contains(bf, RZ_ADDRESSOF(item, item), sizeof(item))
+// clang-format on
+
+RZ_DEC void rz__bloom_init(RZ_BloomFilter *bf, RZ__FilterInitOpt opt);
+RZ_DEC bool rz__bloom_deserialize(RZ_BloomFilter *bf, const rz_u8 *bytes, rz_usize len, RZ__FilterInitOpt opt);
+RZ_DEC void rz_bloom_free(RZ_BloomFilter *bf);
+RZ_DEC void rz_bloom_clear(RZ_BloomFilter *bf);
+
+RZ_DEC void rz_bloom_add_hash(RZ_BloomFilter *bf, rz_u64 hash);
+RZ_DEC bool rz_bloom_contains_hash(const RZ_BloomFilter *bf, rz_u64 hash);
+RZ_DEC void rz_bloom_add(RZ_BloomFilter *bf, const void *data, rz_usize size);
+RZ_DEC bool rz_bloom_contains(const RZ_BloomFilter *bf, const void *data, rz_usize size);
+/// union of two filters with the same size and seed. return false if the filters is not compatible.
+RZ_DEC bool rz_bloom_merge(RZ_BloomFilter *dst, const RZ_BloomFilter *src);
+/// size of the bit array in bytes
+#    define rz_bloom_size_bytes(bf) ((bf)->nblocks * 8 * sizeof(rz_u32))
+
+/// append the serialized filter into `bytes`
+RZ_DEC void rz_bloom_serialize(const RZ_BloomFilter *bf, RZ_BytesArray *bytes);
+
+///////////////
+/// CuckooFilter
+///
+typedef struct {
+    /// nbuckets * RZ_CUCKOO_BUCKET_SLOTS fingerprints, 0 is empty slot
+    rz_u16         *slots;
+    /// always power of two
+    rz_usize        nbuckets;
+    /// amount of items in the filter
+    rz_usize        len;
+    RZ_FilterHashFn hash;
+    rz_usize        seed;
+    RZ_Allocator    allocator;
+    /// the evicted fingerprint that doesn't fit after RZ_CUCKOO_MAX_KICKS, the filter is full while it is used.
+    struct {
+        rz_usize index;
+        rz_u16   fingerprint;
+        bool     used;
+    } victim;
+    rz_u64 rng;
+} RZ_CuckooFilter;
+
+// clang-format off
+///    void rz_cuckoo_init(RZ_CuckooFilter *cf, RZ__FilterInitOpt...);
+#    define rz_cuckoo_init(cf, ...)                    rz__cuckoo_init(cf, (RZ__FilterInitOpt){ __VA_ARGS__ })
+///    bool rz_cuckoo_deserialize(RZ_CuckooFilter *cf, const rz_u8 *bytes, rz_usize len, RZ__FilterInitOpt...);
+#    define rz_cuckoo_deserialize(cf, bytes, len, ...) rz__cuckoo_deserialize(cf, bytes, len, (RZ__FilterInitOpt){ __VA_ARGS__ })
+#    define rz_cuckoo_add_item(cf, item)               rz_cuckoo_add(cf, RZ_ADDRESSOF(item, item), sizeof(item))
+#    define rz_cuckoo_contains_item(cf, item)          rz_cuckoo_contains(cf, RZ_ADDRESSOF(item, item), sizeof(item))
+#    define rz_cuckoo_remove_item(cf, item)            rz_cuckoo_remove(cf, RZ_ADDRESSOF(item, item), sizeof(item))
+// clang-format on
+
+RZ_DEC void rz__cuckoo_init(RZ_CuckooFilter *cf, RZ__FilterInitOpt opt);
+RZ_DEC bool rz__cuckoo_deserialize(RZ_CuckooFilter *cf, const rz_u8 *bytes, rz_usize len, RZ__FilterInitOpt opt);
+RZ_DEC void rz_cuckoo_free(RZ_CuckooFilter *cf);
+RZ_DEC void rz_cuckoo_clear(RZ_CuckooFilter *cf);
+
+/// return false if the filter is full, the item is not added.
+RZ_DEC bool rz_cuckoo_add_hash(RZ_CuckooFilter *cf, rz_u64 hash);
+RZ_DEC bool rz_cuckoo_contains_hash(const RZ_CuckooFilter *cf, rz_u64 hash);
+/// only remove item that was added, removing item that was never added may remove other item (false negative).
+RZ_DEC bool rz_cuckoo_remove_hash(RZ_CuckooFilter *cf, rz_u64 hash);
+RZ_DEC bool rz_cuckoo_add(RZ_CuckooFilter *cf, const void *data, rz_usize size);
+RZ_DEC bool rz_cuckoo_contains(const RZ_CuckooFilter *cf, const void *data, rz_usize size);
+RZ_DEC bool rz_cuckoo_remove(RZ_CuckooFilter *cf, const void *data, rz_usize size);
+
+RZ_DEC void rz_cuckoo_serialize(const RZ_CuckooFilter *cf, RZ_BytesArray *bytes);
+
+///////////////
+/// Sketches
+///
+typedef struct {
+    /// HyperLogLog: 2^precision registers (RZ_HLL_MIN_PRECISION ... RZ_HLL_MAX_PRECISION), default: RZ_HLL_DEFAULT_PRECISION
+    rz_u8           precision;
+    /// CountMinSketch: the error bound `epsilon * total` with probability `1 - delta`, default: 0.001 and 0.01
+    rz_f64          epsilon;
+    rz_f64          delta;
+    /// TopK: amount of tracked items, default: RZ_TOPK_DEFAULT_CAPACITY
+    rz_usize        capacity;
+    /// default: rz_hm_default_hash
+    RZ_FilterHashFn hash;
+    rz_usize        seed;
+    /// default: rz_std_allocator()
+    RZ_Allocator    allocator;
+} RZ__SketchInitOpt;
+
+///////////////
+/// HyperLogLog
+///
+#    define RZ_HLL_MIN_PRECISION 4U
+#    define RZ_HLL_MAX_PRECISION 18U
+#    ifndef RZ_HLL_DEFAULT_PRECISION
+#        define RZ_HLL_DEFAULT_PRECISION 14U
+#    endif
+
+typedef struct {
+    /// 2^precision registers (the rank of the hash), NULL while the sketch is sparse
+    rz_u8           *registers;
+    /// sorted `(index << 8) | rank` of the non zero registers, until it is bigger than the dense registers
+    RZ_Array(rz_u32) sparse;
+    rz_u8            precision;
+    RZ_FilterHashFn  hash;
+    rz_usize         seed;
+    RZ_Allocator     allocator;
+} RZ_HyperLogLog;
+
+// clang-format off
+///    void rz_hll_init(RZ_HyperLogLog *hll, RZ__SketchInitOpt...);
+#    define rz_hll_init(hll, ...)                      rz__hll_init(hll, (RZ__SketchInitOpt){ __VA_ARGS__ })
+///  the precision and `seed` is read from the bytes, only `hash` and `allocator` is used from the options.
+///    bool rz_hll_deserialize(RZ_HyperLogLog *hll, const rz_u8 *bytes, rz_usize len, RZ__SketchInitOpt...);
+#    define rz_hll_deserialize(hll, bytes, len, ...)   rz__hll_deserialize(hll, bytes, len, (RZ__SketchInitOpt){ __VA_ARGS__ })
+#    define rz_hll_add_item(hll, item)                 rz_hll_add(hll, RZ_ADDRESSOF(item, item), sizeof(item))
+#    define rz_hll_is_sparse(hll)                      ((hll)->registers == NULL)
+// clang-format on
+
+RZ_DEC void   rz__hll_init(RZ_HyperLogLog *hll, RZ__SketchInitOpt opt);
+RZ_DEC bool   rz__hll_deserialize(RZ_HyperLogLog *hll, const rz_u8 *bytes, rz_usize len, RZ__SketchInitOpt opt);
+RZ_DEC void   rz_hll_free(RZ_HyperLogLog *hll);
+RZ_DEC void   rz_hll_clear(RZ_HyperLogLog *hll);
+
+RZ_DEC void   rz_hll_add_hash(RZ_HyperLogLog *hll, rz_u64 hash);
+RZ_DEC void   rz_hll_add(RZ_HyperLogLog *hll, const void *data, rz_usize size);
+/// the estimated amount of distinct items (Ertl's improved estimator, no empirical bias table).
+RZ_DEC rz_f64 rz_hll_estimate(const RZ_HyperLogLog *hll);
+/// union of two sketches with the same precision and seed. return false if the sketches is not compatible.
+RZ_DEC bool   rz_hll_merge(RZ_HyperLogLog *dst, const RZ_HyperLogLog *src);
+
+RZ_DEC void   rz_hll_serialize(const RZ_HyperLogLog *hll, RZ_BytesArray *bytes);
+
+///////////////
+/// CountMinSketch
+///
+typedef struct {
+    /// `depth` rows of `width` counters
+    rz_u64         *counters;
+    rz_usize        width;
+    rz_usize        depth;
+    /// sum of the added counts
+    rz_u64          total;
+    RZ_FilterHashFn hash;
+    rz_usize        seed;
+    RZ_Allocator    allocator;
+} RZ_CountMinSketch;
+
+// clang-format off
+///    void rz_cms_init(RZ_CountMinSketch *cms, RZ__SketchInitOpt...);
+#    define rz_cms_init(cms, ...)                      rz__cms_init(cms, (RZ__SketchInitOpt){ __VA_ARGS__ })
+///  the size and `seed` is read from the bytes, only `hash` and `allocator` is used from the options.
+///    bool rz_cms_deserialize(RZ_CountMinSketch *cms, const rz_u8 *bytes, rz_usize len, RZ__SketchInitOpt...);
+#    define rz_cms_deserialize(cms, bytes, len, ...)   rz__cms_deserialize(cms, bytes, len, (RZ__SketchInitOpt){ __VA_ARGS__ })
+#    define rz_cms_add_item(cms, item, count)          rz_cms_add(cms, RZ_ADDRESSOF(item, item), sizeof(item), count)
+#    define rz_cms_estimate_item(cms, item)            rz_cms_estimate(cms, RZ_ADDRESSOF(item, item), sizeof(item))
+// clang-format on
+
+RZ_DEC void   rz__cms_init(RZ_CountMinSketch *cms, RZ__SketchInitOpt opt);
+RZ_DEC bool   rz__cms_deserialize(RZ_CountMinSketch *cms, const rz_u8 *bytes, rz_usize len, RZ__SketchInitOpt opt);
+RZ_DEC void   rz_cms_free(RZ_CountMinSketch *cms);
+RZ_DEC void   rz_cms_clear(RZ_CountMinSketch *cms);
+
+/// add `count` occurrences of the item, return the new estimate of the item.
+RZ_DEC rz_u64 rz_cms_add_hash(RZ_CountMinSketch *cms, rz_u64 hash, rz_u64 count);
+RZ_DEC rz_u64 rz_cms_estimate_hash(const RZ_CountMinSketch *cms, rz_u64 hash);
+RZ_DEC rz_u64 rz_cms_add(RZ_CountMinSketch *cms, const void *data, rz_usize size, rz_u64 count);
+RZ_DEC rz_u64 rz_cms_estimate(const RZ_CountMinSketch *cms, const void *data, rz_usize size);
+/// sum of two sketches with the same size and seed. return false if the sketches is not compatible.
+RZ_DEC bool   rz_cms_merge(RZ_CountMinSketch *dst, const RZ_CountMinSketch *src);
+/// size of the counters in bytes
+#    define rz_cms_size_bytes(cms) ((cms)->width * (cms)->depth * sizeof(rz_u64))
+
+RZ_DEC void   rz_cms_serialize(const RZ_CountMinSketch *cms, RZ_BytesArray *bytes);
+
+///////////////
+/// TopK
+///
+#    ifndef RZ_TOPK_DEFAULT_CAPACITY
+#        define RZ_TOPK_DEFAULT_CAPACITY 100U
+#    endif
+
+typedef struct {
+    /// the key is owned by the sketch, valid until the next update of the sketch
+    const rz_u8 *key;
+    rz_usize     key_len;
+    /// the estimated count, `count - error` is never more than the real count
+    rz_u64       count;
+    rz_u64       error;
+} RZ_TopKItem;
+
+typedef struct {
+    RZ_TopKItem item;
+    rz_u64      hash;
+    /// position in the heap
+    rz_u32      heap_pos;
+} RZ__TopKEntry;
+
+typedef struct {
+    /// the tracked items (`len <= capacity`), the index of the entry is stable
+    RZ__TopKEntry  *entries;
+    /// min heap of entry indexes by count, the root is replaced by the new item when the sketch is full
+    rz_u32         *heap;
+    /// open addressing index of the entries by hash, entry index + 1 (0 is empty), `nslots` is power of two
+    rz_u32         *slots;
+    rz_usize        nslots;
+    rz_usize        len;
+    rz_usize        capacity;
+    RZ_FilterHashFn hash;
+    rz_usize        seed;
+    RZ_Allocator    allocator;
+} RZ_TopK;
+
+// clang-format off
+///    void rz_topk_init(RZ_TopK *tk, RZ__SketchInitOpt...);
+#    define rz_topk_init(tk, ...)                      rz__topk_init(tk, (RZ__SketchInitOpt){ __VA_ARGS__ })
+///  the capacity and `seed` is read from the bytes, only `hash` and `allocator` is used from the options.
+///    bool rz_topk_deserialize(RZ_TopK *tk, const rz_u8 *bytes, rz_usize len, RZ__SketchInitOpt...);
+#    define rz_topk_deserialize(tk, bytes, len, ...)   rz__topk_deserialize(tk, bytes, len, (RZ__SketchInitOpt){ __VA_ARGS__ })
+// clang-format on
+
+RZ_DEC void     rz__topk_init(RZ_TopK *tk, RZ__SketchInitOpt opt);
+RZ_DEC bool     rz__topk_deserialize(RZ_TopK *tk, const rz_u8 *bytes, rz_usize len, RZ__SketchInitOpt opt);
+RZ_DEC void     rz_topk_free(RZ_TopK *tk);
+RZ_DEC void     rz_topk_clear(RZ_TopK *tk);
+
+/// add `count` occurrences of the key, return the new estimated count of the key.
+RZ_DEC rz_u64   rz_topk_add(RZ_TopK *tk, const void *key, rz_usize key_len, rz_u64 count);
+/// the estimated count of the key, 0 if the key is not tracked.
+RZ_DEC rz_u64   rz_topk_count(const RZ_TopK *tk, const void *key, rz_usize key_len);
+/// copy at most `cap` tracked items into `items` (sorted by count, the biggest first), return the amount of items.
+RZ_DEC rz_usize rz_topk_items(const RZ_TopK *tk, RZ_TopKItem *items, rz_usize cap);
+/// merge `src` into `dst` (mergeable summaries: the key that is missing from the full sketch is counted
+/// with the minimum count of that sketch), `dst` keep its capacity.
+RZ_DEC void     rz_topk_merge(RZ_TopK *dst, const RZ_TopK *src);
+
+RZ_DEC void     rz_topk_serialize(const RZ_TopK *tk, RZ_BytesArray *bytes);
+
+#    if defined(__cplusplus)
+}
+#    endif
+#endif /* end of include guard: RZ_FILTER_H */
@@ -12,6 +12,8 @@
 RZ_ALWAYS_INLINE static bool rz__path_is_sep(char ch) {
     return ((ch == RZ_PATH_WINDOWS_SEP) || (ch == RZ_PATH_UNIX_SEP));
 }
+// the bytes of rz__path_is_sep, for the rz_sv_*_any byte set search
+#define RZ__PATH_SEPS rz_sv_static("\\/")
 RZ_ALWAYS_INLINE static bool rz__path_is_verbatim(const RZ_Path path) {
     return (rz_sv_starts_with(path, rz_sv_static("\\\\?\\")) || rz_sv_starts_with(path, rz_sv_static("\\??\\")));
 }
@@ -102,7 +104,7 @@ RZ_DEF bool rz_pathbuf_set_filestem(RZ_PathBuf *path, RZ_Path filestem) {
     return true;
 }
 
-#define rz__path_validate_extension(ext) RZ_ASSERT(rz_sv_contains_char(ext, RZ_PATH_SEP), "extension cannot contain path separators: `" RZ_SVFmt "`", RZ_SVArg(ext))
+#define rz__path_validate_extension(ext) RZ_ASSERT(rz_sv_find_any(ext, RZ__PATH_SEPS) == RZ_NOT_FOUND, "extension cannot contain path separators: `" RZ_SVFmt "`", RZ_SVArg(ext))
 
 RZ_DEF bool rz_pathbuf_set_extension(RZ_PathBuf *path, RZ_Path extension) {
     rz__path_validate_extension(extension);
@@ -155,12 +157,17 @@ RZ_DEF RZ_PathBuf rz_pathbuf_join(const RZ_PathBuf *path, RZ_Path component) {
 }
 
 static void rz__path_change_sep(RZ_Path *path) {
-    rz_foreach(ch, path) {
 #if RZ_TARGET_OS_WINDOWS
-        if (*ch == RZ_PATH_UNIX_SEP) *ch = RZ_PATH_SEP;
+    const char from = RZ_PATH_UNIX_SEP;
 #else
-        if (*ch == RZ_PATH_WINDOWS_SEP) *ch = RZ_PATH_SEP;
+    const char from = RZ_PATH_WINDOWS_SEP;
 #endif
+    RZ_StrView rest = *path;
+    rz_usize   i    = 0;
+    while ((i = rz_sv_find_char(rest, from)) != RZ_NOT_FOUND) {
+        rest.data[i] = RZ_PATH_SEP;
+        rest.data += i + 1;
+        rest.len -= i + 1;
     }
 }
 
@@ -201,13 +208,14 @@ RZ_DEF bool rz_path_filename(const RZ_Path path, RZ_Path *filename) {
     if (rz_arr_is_empty(&path)) return false;
 
     RZ_Path p = path;
-    while (rz_sv_rsplit_by(&p, rz__path_is_sep, filename)) {
+    while (rz_sv_rsplit_any(&p, RZ__PATH_SEPS, filename)) {
         // if empty its mean the end is '/'. continue until the path is empty
         if (rz_arr_is_empty(filename) || rz_sv_eq(*filename, rz_sv_static("."))) continue;
 
         // if the filename is '..' . its mean.
         // the function like '/this/is/path/../' or 'relative/path/..'
         if (rz_sv_eq(*filename, rz_sv_static(".."))) return false;
+        break;
     }
 
     // if the filename is empty.
@@ -219,15 +227,10 @@ RZ_DEF bool rz_path_filename(const RZ_Path path, RZ_Path *filename) {
 RZ_DEF bool rz_path_filestem(const RZ_Path path, RZ_Path *filestem) {
     if (!rz_path_filename(path, filestem)) return false;
 
-    rz_usize dot = RZ_NOT_FOUND;
-    if ((dot = rz_sv_rfind_char(path, '.')) == RZ_NOT_FOUND) {
-        // if not found dot '.'. its mean there is no extension.
-        // so its just found a stem. and return true
-        return true;
-    }
-
-    auto ret = rz_sv_strip_nsuffix(filestem, dot);
-    RZ_UNUSED(ret);
+    // if not found dot '.' (or the filename only have dot in start of filename '.filename'),
+    // its mean there is no extension. so its just found a stem
+    rz_usize dot = rz_sv_rfind_char(*filestem, '.');
+    if (dot != RZ_NOT_FOUND && dot > 0) filestem->len = dot;
     return true;
 }
 
@@ -257,7 +260,7 @@ RZ_DEF bool rz_path_parent_dir(const RZ_Path path, RZ_Path *parent_dir) {
     RZ_DBG_ASSERT(parent_dir != NULL);
     RZ_Path right = {0};
     *parent_dir   = path;
-    while (rz_sv_rsplit_by(parent_dir, rz__path_is_sep, &right)) {
+    while (rz_sv_rsplit_any(parent_dir, RZ__PATH_SEPS, &right)) {
         // if like this. the right is empty. ex: "/this/is/path/" "/this/is/path/."
         if (rz_sv_is_empty(right) || rz_sv_eq(right, rz_sv_static("."))) continue;
         break;
@@ -1406,7 +1409,7 @@ RZ_DEF RZ_Fd rz_fd_open_opt(const RZ_Path path, RZ_FdOpenOpt o) {
 
     // determine if is creating new file.
     if ((o.create_new == true) || (o.create == true)) {
-        if ((o.write == false) || (o.append == false)) {
+        if ((o.write == false) && (o.append == false)) {
             errno = EINVAL; // invalid argument
             RZ_OS_ERROR_INTR("Failed to open file opening file (path: '" RZ_SVFmt "'). .create set without .write or .append", RZ_SVArg(path));
             rz_return_defer(RZ_INVALID_FD);
@@ -1442,7 +1445,7 @@ RZ_DEF bool rz_fd_close(RZ_Fd fd) {
 #if RZ_TARGET_OS_WINDOWS
     return CloseHandle(fd);
 #else
-    return close(fd) != 0;
+    return close(fd) == 0;
 #endif // _WIN32
 }
 
@@ -1459,11 +1462,13 @@ RZ_DEF bool rz_fd_read(RZ_Fd fd, void *dst, rz_usize dstsize, rz_usize *readsize
     }
     return true;
 #else
-    *readsize = read(fd, dst, dstsize);
-    if (*readsize < 0) {
+    ssize_t n = read(fd, dst, dstsize);
+    if (n < 0) {
+        *readsize = 0;
         RZ_OS_ERROR_INTR("Failed to read file.");
         return false;
     }
+    *readsize = (rz_usize)n;
     return true;
 #endif
 }
@@ -1481,11 +1486,13 @@ RZ_DEF bool rz_fd_write(RZ_Fd fd, const void *src, rz_usize srclen, rz_usize *wr
     }
     return true;
 #else
-    *writesize = write(fd, src, srclen);
-    if (*writesize < 0) {
-        RZ_OS_ERROR_INTR("Failed to read file.");
+    ssize_t n = write(fd, src, srclen);
+    if (n < 0) {
+        *writesize = 0;
+        RZ_OS_ERROR_INTR("Failed to write file.");
         return false;
     }
+    *writesize = (rz_usize)n;
     return true;
 #endif
 }
@@ -0,0 +1,332 @@
+#include "rz_hamt.h"
+
+#ifdef RZ_HAMT_IMPL
+
+#    define RZ__HAMT_BITS     5U
+#    define RZ__HAMT_MASK     ((1U << RZ__HAMT_BITS) - 1U)
+// the node at the shift >= 64 has no hash bits left, it is the collision node (unordered, compared linearly)
+#    define RZ__HAMT_MAX_SHIFT 64U
+
+typedef struct {
+    atomic_uint refs;
+    rz_u64      hash;
+    rz_usize    key_len;
+    /// the value (`valuesize` bytes) then the key bytes
+    max_align_t data[];
+} RZ__HamtLeaf;
+
+typedef struct {
+    atomic_uint refs;
+    /// the transient (or the single update) that own the node
+    rz_u32      edit;
+    /// the present children of the inner node, 0 on the collision node
+    rz_u32      bitmap;
+    rz_u16      len;
+    rz_u16      cap;
+    void       *children[];
+} RZ__HamtNode;
+
+// the child pointer is tagged, the leaf has the lowest bit set.
+#    define rz__hamt_is_leaf(p)              (((rz_uptr)(p) & 1U) != 0)
+#    define rz__hamt_leaf(p)                 ((RZ__HamtLeaf *)((rz_uptr)(p) & ~(rz_uptr)1U))
+#    define rz__hamt_tag_leaf(l)             ((void *)((rz_uptr)(l) | 1U))
+#    define rz__hamt_leaf_value(l)           ((void *)(l)->data)
+#    define rz__hamt_leaf_key(l, valuesize)  ((const rz_u8 *)(l)->data + (valuesize))
+#    define rz__hamt_index(hash, shift)      ((rz_u32)((hash) >> (shift)) & RZ__HAMT_MASK)
+
+static atomic_uint rz__hamt_edit_counter;
+
+static rz_u32 rz__hamt_next_edit(void) {
+    rz_u32 edit;
+    do {
+        edit = atomic_fetch_add_explicit(&rz__hamt_edit_counter, 1, memory_order_relaxed) + 1U;
+    } while (edit == 0);
+    return edit;
+}
+
+static inline rz_u64 rz__hamt_hash(const void *key, rz_usize key_len) {
+    return (rz_u64)rz_hm_default_hash(key, key_len, 0);
+}
+
+/////////////// node and leaf allocation
+static RZ__HamtLeaf *rz__hamt_leaf_alloc(RZ_HamtOpaque *t, rz_usize valuesize, rz_u64 hash, const rz_u8 *key, rz_usize key_len) {
+    RZ__HamtLeaf *l = rz_raw_alloc(t->allocator, sizeof(RZ__HamtLeaf) + valuesize + key_len);
+    RZ_ASSERT_ALLOCATOR_PTR(l);
+    atomic_init(&l->refs, 1);
+    l->hash    = hash;
+    l->key_len = key_len;
+    memset(l->data, 0, valuesize);
+    if (key_len > 0) memcpy((rz_u8 *)l->data + valuesize, key, key_len);
+    return l;
+}
+
+static inline bool rz__hamt_leaf_eq(const RZ__HamtLeaf *l, rz_usize valuesize, rz_u64 hash, const rz_u8 *key, rz_usize key_len) {
+    return (l->hash == hash) && (l->key_len == key_len) && ((key_len == 0) || (memcmp(rz__hamt_leaf_key(l, valuesize), key, key_len) == 0));
+}
+
+static RZ__HamtNode *rz__hamt_node_alloc(RZ_HamtOpaque *t, rz_u32 edit, rz_u32 cap) {
+    RZ__HamtNode *n = rz_raw_alloc(t->allocator, sizeof(RZ__HamtNode) + (cap * sizeof(void *)));
+    RZ_ASSERT_ALLOCATOR_PTR(n);
+    atomic_init(&n->refs, 1);
+    n->edit   = edit;
+    n->bitmap = 0;
+    n->len    = 0;
+    n->cap    = (rz_u16)cap;
+    return n;
+}
+
+static inline void rz__hamt_node_dealloc(RZ_HamtOpaque *t, RZ__HamtNode *n) {
+    rz_raw_dealloc(t->allocator, n, sizeof(RZ__HamtNode) + (n->cap * sizeof(void *)));
+}
+
+/////////////// reference counting
+static inline void rz__hamt_retain(void *p) {
+    atomic_uint *refs = rz__hamt_is_leaf(p) ? &rz__hamt_leaf(p)->refs : &((RZ__HamtNode *)p)->refs;
+    atomic_fetch_add_explicit(refs, 1, memory_order_relaxed);
+}
+
+static void rz__hamt_release(RZ_HamtOpaque *t, rz_usize valuesize, void *p) {
+    if (rz__hamt_is_leaf(p)) {
+        RZ__HamtLeaf *l = rz__hamt_leaf(p);
+        if (atomic_fetch_sub_explicit(&l->refs, 1, memory_order_acq_rel) == 1) {
+            rz_raw_dealloc(t->allocator, l, sizeof(RZ__HamtLeaf) + valuesize + l->key_len);
+        }
+        return;
+    }
+    RZ__HamtNode *n = p;
+    if (atomic_fetch_sub_explicit(&n->refs, 1, memory_order_acq_rel) != 1) return;
+    for (rz_u32 i = 0; i < n->len; ++i) rz__hamt_release(t, valuesize, n->children[i]);
+    rz__hamt_node_dealloc(t, n);
+}
+
+// make the node in `*slot` writable by the update `edit` with room for `cap` children:
+// the node that is owned by the update (and not shared) is used in place, otherwise it is copied
+// and the slot (owned by the update) release its reference of the old node.
+static RZ__HamtNode *rz__hamt_node_own(RZ_HamtOpaque *t, rz_usize valuesize, rz_u32 edit, void **slot, rz_u32 cap) {
+    RZ__HamtNode *n     = *slot;
+    bool          owned = (n->edit == edit) && (atomic_load_explicit(&n->refs, memory_order_acquire) == 1);
+    if (owned && n->cap >= cap) return n;
+
+    RZ__HamtNode *copy = rz__hamt_node_alloc(t, edit, RZ_MAX(cap, n->len));
+    copy->bitmap       = n->bitmap;
+    copy->len          = n->len;
+    memcpy(copy->children, n->children, n->len * sizeof(void *));
+    if (owned) {
+        // moved, the children keep their reference
+        rz__hamt_node_dealloc(t, n);
+    } else {
+        for (rz_u32 i = 0; i < n->len; ++i) rz__hamt_retain(n->children[i]);
+        rz__hamt_release(t, valuesize, n);
+    }
+    *slot = copy;
+    return copy;
+}
+
+static void rz__hamt_node_insert_child(RZ__HamtNode *n, rz_u32 pos, void *child) {
+    memmove(n->children + pos + 1, n->children + pos, (n->len - pos) * sizeof(void *));
+    n->children[pos] = child;
+    n->len++;
+}
+
+static void rz__hamt_node_remove_child(RZ__HamtNode *n, rz_u32 pos) {
+    memmove(n->children + pos, n->children + pos + 1, (n->len - pos - 1) * sizeof(void *));
+    n->len--;
+}
+
+// the subtree of the 2 leaves with different keys, they take the reference of the new subtree.
+static void *rz__hamt_node_pair(RZ_HamtOpaque *t, rz_u32 edit, rz_u32 shift, RZ__HamtLeaf *a, RZ__HamtLeaf *b) {
+    RZ__HamtNode *n = rz__hamt_node_alloc(t, edit, 2);
+    if (shift >= RZ__HAMT_MAX_SHIFT) {
+        n->children[0] = rz__hamt_tag_leaf(a);
+        n->children[1] = rz__hamt_tag_leaf(b);
+        n->len         = 2;
+        return n;
+    }
+    rz_u32 ia = rz__hamt_index(a->hash, shift), ib = rz__hamt_index(b->hash, shift);
+    if (ia == ib) {
+        n->bitmap      = 1U << ia;
+        n->children[0] = rz__hamt_node_pair(t, edit, shift + RZ__HAMT_BITS, a, b);
+        n->len         = 1;
+        return n;
+    }
+    n->bitmap                 = (1U << ia) | (1U << ib);
+    n->children[ia > ib]      = rz__hamt_tag_leaf(a);
+    n->children[!(ia > ib)]   = rz__hamt_tag_leaf(b);
+    n->len                    = 2;
+    return n;
+}
+
+/////////////// insert and remove
+// put the leaf (with its reference) into the subtree of `*slot`, return false if the key is replaced.
+static bool rz__hamt_insert_at(RZ_HamtOpaque *t, rz_usize valuesize, rz_u32 edit, void **slot, rz_u32 shift, RZ__HamtLeaf *leaf) {
+    for (;;) {
+        void *p = *slot;
+        if (p == NULL) {
+            *slot = rz__hamt_tag_leaf(leaf);
+            return true;
+        }
+        if (rz__hamt_is_leaf(p)) {
+            RZ__HamtLeaf *old = rz__hamt_leaf(p);
+            if (rz__hamt_leaf_eq(old, valuesize, leaf->hash, rz__hamt_leaf_key(leaf, valuesize), leaf->key_len)) {
+                *slot = rz__hamt_tag_leaf(leaf);
+                rz__hamt_release(t, valuesize, p);
+                return false;
+            }
+            *slot = rz__hamt_node_pair(t, edit, shift, old, leaf);
+            return true;
+        }
+
+        RZ__HamtNode *n = p;
+        if (shift >= RZ__HAMT_MAX_SHIFT) {
+            for (rz_u32 i = 0; i < n->len; ++i) {
+                if (!rz__hamt_leaf_eq(rz__hamt_leaf(n->children[i]), valuesize, leaf->hash, rz__hamt_leaf_key(leaf, valuesize), leaf->key_len)) continue;
+                n = rz__hamt_node_own(t, valuesize, edit, slot, n->len);
+                rz__hamt_release(t, valuesize, n->children[i]);
+                n->children[i] = rz__hamt_tag_leaf(leaf);
+                return false;
+            }
+            n = rz__hamt_node_own(t, valuesize, edit, slot, n->len + 1U);
+            rz__hamt_node_insert_child(n, n->len, rz__hamt_tag_leaf(leaf));
+            return true;
+        }
+
+        rz_u32 bit = 1U << rz__hamt_index(leaf->hash, shift);
+        rz_u32 pos = rz_popcount32(n->bitmap & (bit - 1U));
+        if ((n->bitmap & bit) == 0) {
+            n = rz__hamt_node_own(t, valuesize, edit, slot, n->len + 1U);
+            n->bitmap |= bit;
+            rz__hamt_node_insert_child(n, pos, rz__hamt_tag_leaf(leaf));
+            return true;
+        }
+        n     = rz__hamt_node_own(t, valuesize, edit, slot, n->len);
+        slot  = &n->children[pos];
+        shift += RZ__HAMT_BITS;
+    }
+}
+
+// remove the key that is present in the subtree of `*slot`, the node with a single leaf is replaced by the leaf.
+static void rz__hamt_remove_at(RZ_HamtOpaque *t, rz_usize valuesize, rz_u32 edit, void **slot, rz_u32 shift, rz_u64 hash, const rz_u8 *key,
+                               rz_usize key_len) {
+    if (rz__hamt_is_leaf(*slot)) {
+        rz__hamt_release(t, valuesize, *slot);
+        *slot = NULL;
+        return;
+    }
+
+    RZ__HamtNode *n   = rz__hamt_node_own(t, valuesize, edit, slot, ((RZ__HamtNode *)*slot)->len);
+    rz_u32        pos = 0;
+    if (shift >= RZ__HAMT_MAX_SHIFT) {
+        while (!rz__hamt_leaf_eq(rz__hamt_leaf(n->children[pos]), valuesize, hash, key, key_len)) pos++;
+        rz__hamt_release(t, valuesize, n->children[pos]);
+        rz__hamt_node_remove_child(n, pos);
+    } else {
+        rz_u32 bit = 1U << rz__hamt_index(hash, shift);
+        pos        = rz_popcount32(n->bitmap & (bit - 1U));
+        rz__hamt_remove_at(t, valuesize, edit, &n->children[pos], shift + RZ__HAMT_BITS, hash, key, key_len);
+        if (n->children[pos] == NULL) {
+            n->bitmap &= ~bit;
+            rz__hamt_node_remove_child(n, pos);
+        }
+    }
+
+    if (n->len == 0) {
+        rz__hamt_node_dealloc(t, n);
+        *slot = NULL;
+    } else if (n->len == 1 && rz__hamt_is_leaf(n->children[0])) {
+        // moved, the leaf keep its reference
+        *slot = n->children[0];
+        rz__hamt_node_dealloc(t, n);
+    }
+}
+
+static bool rz__hamt_foreach_at(const void *p, rz_usize valuesize, RZ_HamtIterFn fn, void *user) {
+    if (rz__hamt_is_leaf(p)) {
+        const RZ__HamtLeaf *l = rz__hamt_leaf(p);
+        return fn(rz__hamt_leaf_key(l, valuesize), l->key_len, rz__hamt_leaf_value(l), user);
+    }
+    const RZ__HamtNode *n = p;
+    for (rz_u32 i = 0; i < n->len; ++i) {
+        if (!rz__hamt_foreach_at(n->children[i], valuesize, fn, user)) return false;
+    }
+    return true;
+}
+
+RZ_DEF void rz__hamt_free(RZ_HamtOpaque *t, rz_usize valuesize) {
+    RZ_ASSERT_NOT_NULL(t);
+    if (t->root != NULL) rz__hamt_release(t, valuesize, t->root);
+    t->root = NULL;
+    t->len  = 0;
+    t->edit = 0;
+}
+
+RZ_DEF void rz__hamt_clone(RZ_HamtOpaque *dst, const RZ_HamtOpaque *src) {
+    RZ_ASSERT_NOT_NULL(dst);
+    RZ_ASSERT_NOT_NULL(src);
+    RZ_ASSERT(dst->root == NULL, "the destination must be empty");
+    if (src->root != NULL) rz__hamt_retain(src->root);
+    dst->root      = src->root;
+    dst->len       = src->len;
+    dst->edit      = 0;
+    dst->allocator = src->allocator;
+}
+
+RZ_DEF void rz__hamt_transient_begin(RZ_HamtOpaque *t) {
+    RZ_ASSERT_NOT_NULL(t);
+    t->edit = rz__hamt_next_edit();
+}
+
+RZ_DEF void *rz__hamt_insert(RZ_HamtOpaque *t, rz_usize valuesize, const void *key_, rz_usize key_len) {
+    RZ_ASSERT_NOT_NULL(t);
+    RZ_ASSERT(key_ != NULL || key_len == 0);
+    if (!rz_is_allocator(t->allocator)) t->allocator = rz_std_allocator();
+
+    const rz_u8  *key  = key_;
+    rz_u32        edit = (t->edit != 0) ? t->edit : rz__hamt_next_edit();
+    RZ__HamtLeaf *leaf = rz__hamt_leaf_alloc(t, valuesize, rz__hamt_hash(key, key_len), key, key_len);
+    if (rz__hamt_insert_at(t, valuesize, edit, &t->root, 0, leaf)) t->len++;
+    return rz__hamt_leaf_value(leaf);
+}
+
+RZ_DEF const void *rz__hamt_get(const RZ_HamtOpaque *t, rz_usize valuesize, const void *key_, rz_usize key_len) {
+    RZ_ASSERT_NOT_NULL(t);
+    const rz_u8 *key   = key_;
+    rz_u64       hash  = rz__hamt_hash(key, key_len);
+    const void  *p     = t->root;
+    rz_u32       shift = 0;
+    while (p != NULL) {
+        if (rz__hamt_is_leaf(p)) {
+            const RZ__HamtLeaf *l = rz__hamt_leaf(p);
+            return rz__hamt_leaf_eq(l, valuesize, hash, key, key_len) ? rz__hamt_leaf_value(l) : NULL;
+        }
+        const RZ__HamtNode *n = p;
+        if (shift >= RZ__HAMT_MAX_SHIFT) {
+            for (rz_u32 i = 0; i < n->len; ++i) {
+                const RZ__HamtLeaf *l = rz__hamt_leaf(n->children[i]);
+                if (rz__hamt_leaf_eq(l, valuesize, hash, key, key_len)) return rz__hamt_leaf_value(l);
+            }
+            return NULL;
+        }
+        rz_u32 bit = 1U << rz__hamt_index(hash, shift);
+        if ((n->bitmap & bit) == 0) return NULL;
+        p = n->children[rz_popcount32(n->bitmap & (bit - 1U))];
+        shift += RZ__HAMT_BITS;
+    }
+    return NULL;
+}
+
+RZ_DEF bool rz__hamt_remove(RZ_HamtOpaque *t, rz_usize valuesize, const void *key_, rz_usize key_len) {
+    // look up first, the path is not copied when the key is not found
+    if (rz__hamt_get(t, valuesize, key_, key_len) == NULL) return false;
+    rz_u32 edit = (t->edit != 0) ? t->edit : rz__hamt_next_edit();
+    rz__hamt_remove_at(t, valuesize, edit, &t->root, 0, rz__hamt_hash(key_, key_len), key_, key_len);
+    t->len--;
+    return true;
+}
+
+RZ_DEF bool rz__hamt_foreach(const RZ_HamtOpaque *t, rz_usize valuesize, RZ_HamtIterFn fn, void *user) {
+    RZ_ASSERT_NOT_NULL(t);
+    RZ_ASSERT_NOT_NULL(fn);
+    return (t->root == NULL) || rz__hamt_foreach_at(t->root, valuesize, fn, user);
+}
+
+#endif /* ifdef RZ_HAMT_IMPL */
@@ -0,0 +1,121 @@
+#pragma once
+#ifndef RZ_HAMT_H
+#    define RZ_HAMT_H
+#    include "rz_allocator.h"
+#    include "rz_collections.h"
+#    include "rz_common.h"
+
+/// Persistent hash array mapped trie (HAMT), hash map of byte string keys with structural sharing.
+/// the 64 bit hash of the key is consumed 5 bits per level, every inner node has 32 bits bitmap of
+/// the present children and the children array is compressed (popcount of the bitmap below the bit
+/// is the index), the keys with the same 64 bit hash is stored in the collision node at the bottom.
+///
+/// the map is immutable from the point of view of its snapshots:
+///  - rz_hamt_clone is O(1), the snapshot share the root with the map (reference counted).
+///  - the update copy only the path from the root to the changed leaf (O(log32 n) nodes),
+///    the untouched subtrees is shared between the old and the new version.
+///  - the node is freed when the last version that reference it is freed.
+/// the transient mode (rz_hamt_transient_begin/end) is for the bulk update: the nodes created
+/// by the transient that is not shared with any snapshot is mutated in place instead of copied.
+///
+/// the reference count is atomic, so the snapshot can be read and freed from any thread
+/// (with thread safe allocator) while the single writer keep updating its own map.
+///
+/// Example:
+///  RZ_Hamt(rz_u32) routes = {.allocator = rz_std_allocator()};
+///  rz_hamt_insert_cstr(&routes, "/api", 1);
+///
+///  // reader, take the snapshot under the same lock that the writer use to publish it
+///  RZ_Hamt(rz_u32) snapshot = {0};
+///  rz_hamt_clone(&snapshot, &routes);
+///  const rz_u32 *id = rz_hamt_get_cstr(&snapshot, "/api");
+///  rz_hamt_free(&snapshot);
+///
+///  // writer, the snapshot still see the old version
+///  rz_hamt_transient_begin(&routes);
+///  for (rz_usize i = 0; i < new_routes.len; ++i) rz_hamt_insert_cstr(&routes, new_routes.data[i].path, new_routes.data[i].id);
+///  rz_hamt_transient_end(&routes);
+///  rz_hamt_free(&routes);
+///
+/// NOTE: the value pointer is valid while the version (map or snapshot) that return it is alive,
+///       the value is shared between the versions, it must not be modified.
+
+#    if defined(__cplusplus)
+extern "C" {
+#    endif
+
+/// called for every key (in the hash order), return false to stop the iteration.
+typedef bool (*RZ_HamtIterFn)(const rz_u8 *key, rz_usize key_len, const void *value, void *user);
+
+#    define RZ__HAMT_STRUCT_MEMBERS                                        \
+        /* root - tagged pointer of the root node (shared) */             \
+        void        *root;                                               \
+        /* len - the amount of keys */                                   \
+        rz_usize     len;                                                \
+        /* edit - the id of the transient, 0 is persistent */            \
+        rz_u32       edit;                                               \
+        RZ_Allocator allocator
+
+#    define RZ_Hamt(V)                  \
+        struct {                        \
+            RZ__HAMT_STRUCT_MEMBERS;    \
+            V *__temp;                  \
+        }
+
+typedef RZ_Hamt(void) RZ_HamtOpaque;
+
+// clang-format off
+///  release the version, the nodes that is not shared with other version is freed.
+///    void rz_hamt_free(RZ_Hamt(V) *t);
+#    define rz_hamt_free(t)                         rz__hamt_free((RZ_HamtOpaque *)(t), sizeof(*(t)->__temp))
+
+///  O(1) snapshot of `src` into `dst` (`dst` must be empty or freed), `dst` is persistent.
+///    void rz_hamt_clone(RZ_Hamt(V) *dst, const RZ_Hamt(V) *src);
+#    define rz_hamt_clone(dst, src)                 do { RZ_STATIC_ASSERT_TYPE_COMPATIBLE(*(dst)->__temp, *(src)->__temp); rz__hamt_clone((RZ_HamtOpaque *)(dst), (const RZ_HamtOpaque *)(src)); } while (0)
+
+///  start/end the transient mode of the map, the nodes of the transient is mutated in place.
+///    void rz_hamt_transient_begin(RZ_Hamt(V) *t);
+///    void rz_hamt_transient_end(RZ_Hamt(V) *t);
+#    define rz_hamt_transient_begin(t)              rz__hamt_transient_begin((RZ_HamtOpaque *)(t))
+#    define rz_hamt_transient_end(t)                ((void)((t)->edit = 0))
+
+///  insert the key or replace the value of the existing key.
+///    void rz_hamt_insert(RZ_Hamt(V) *t, const void *key, rz_usize key_len, V value);
+///    void rz_hamt_insert_cstr(RZ_Hamt(V) *t, const char *key, V value);
+///    void rz_hamt_insert_u64(RZ_Hamt(V) *t, rz_u64 key, V value);
+#    define rz_hamt_insert(t, key, key_len, value)  ((t)->__temp = rz__hamt_insert((RZ_HamtOpaque *)(t), sizeof(*(t)->__temp), (key), (key_len)), (void)(*(t)->__temp = (value)))
+#    define rz_hamt_insert_cstr(t, key, value)      rz_hamt_insert(t, key, strlen(key), value)
+#    define rz_hamt_insert_u64(t, key, value)       rz_hamt_insert(t, &(rz_u64){(key)}, sizeof(rz_u64), value)
+
+///  get pointer to the value, NULL if the key is not found.
+///      const V* rz_hamt_get(const RZ_Hamt(V) *t, const void *key, rz_usize key_len);
+///      const V* rz_hamt_get_cstr(const RZ_Hamt(V) *t, const char *key);
+///      const V* rz_hamt_get_u64(const RZ_Hamt(V) *t, rz_u64 key);
+#    define rz_hamt_get(t, key, key_len)            ((const RZ_TYPEOF(*(t)->__temp) *)rz__hamt_get((const RZ_HamtOpaque *)(t), sizeof(*(t)->__temp), (key), (key_len)))
+#    define rz_hamt_get_cstr(t, key)                rz_hamt_get(t, key, strlen(key))
+#    define rz_hamt_get_u64(t, key)                 rz_hamt_get(t, &(rz_u64){(key)}, sizeof(rz_u64))
+#    define rz_hamt_contains(t, key, key_len)       (rz_hamt_get(t, key, key_len) != NULL)
+
+///  remove the key, return false if the key is not found.
+///    bool rz_hamt_remove(RZ_Hamt(V) *t, const void *key, rz_usize key_len);
+#    define rz_hamt_remove(t, key, key_len)         rz__hamt_remove((RZ_HamtOpaque *)(t), sizeof(*(t)->__temp), (key), (key_len))
+#    define rz_hamt_remove_cstr(t, key)             rz_hamt_remove(t, key, strlen(key))
+#    define rz_hamt_remove_u64(t, key)              rz_hamt_remove(t, &(rz_u64){(key)}, sizeof(rz_u64))
+
+///  iterate all the keys, return false if the iteration is stopped by `fn`.
+///    bool rz_hamt_foreach(const RZ_Hamt(V) *t, RZ_HamtIterFn fn, void *user);
+#    define rz_hamt_foreach(t, fn, user)            rz__hamt_foreach((const RZ_HamtOpaque *)(t), sizeof(*(t)->__temp), (fn), (user))
+// clang-format on
+
+RZ_DEC void        rz__hamt_free(RZ_HamtOpaque *t, rz_usize valuesize);
+RZ_DEC void        rz__hamt_clone(RZ_HamtOpaque *dst, const RZ_HamtOpaque *src);
+RZ_DEC void        rz__hamt_transient_begin(RZ_HamtOpaque *t);
+RZ_DEC void       *rz__hamt_insert(RZ_HamtOpaque *t, rz_usize valuesize, const void *key, rz_usize key_len);
+RZ_DEC const void *rz__hamt_get(const RZ_HamtOpaque *t, rz_usize valuesize, const void *key, rz_usize key_len);
+RZ_DEC bool        rz__hamt_remove(RZ_HamtOpaque *t, rz_usize valuesize, const void *key, rz_usize key_len);
+RZ_DEC bool        rz__hamt_foreach(const RZ_HamtOpaque *t, rz_usize valuesize, RZ_HamtIterFn fn, void *user);
+
+#    if defined(__cplusplus)
+}
+#    endif
+#endif /* end of include guard: RZ_HAMT_H */
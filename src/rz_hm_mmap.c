@@ -0,0 +1,258 @@
+#include "rz_hm_mmap.h"
+#include "rz_error.h"
+#include "rz_sprintf.h"
+
+#ifdef RZ_HM_MMAP_IMPL
+
+#    define RZ_TAG                 "rz_hm_mmap"
+#    define RZ__HM_MMAP_MAGIC      "RZHM"
+#    define RZ__HM_MMAP_ENDIAN     0x01020304U
+#    define RZ__HM_MMAP_MIN_SLOTS  16U
+#    define rz__hm_mmap_align(x, a) (((x) + ((a) - 1)) & ~(rz_u64)((a) - 1))
+
+// the hash is fixed to siphash (not rz_hm_default_hash) so the file does not depend on the build config of the reader
+static inline rz_u64 rz__hm_mmap_hash(const void *key, rz_usize len, rz_u64 seed) {
+    return rz_hm_siphash_hash(key, len, (rz_usize)seed);
+}
+
+static inline rz_u64 rz__hm_mmap_checksum(const rz_u8 *base, rz_u64 size) {
+    return rz_hm_siphash_hash(base + sizeof(RZ_HmMmapHeader), size - sizeof(RZ_HmMmapHeader), 0);
+}
+
+// size of entry {keylen, key + '\0', value}
+static inline rz_u64 rz__hm_mmap_entry_size(rz_u64 keylen, rz_u64 valuesize) {
+    return sizeof(rz_u64) + rz__hm_mmap_align(keylen + 1, 8) + rz__hm_mmap_align(valuesize, 8);
+}
+
+static inline const void *rz__hm_mmap_elem_key(const rz_u8 *elem, RZ__HmMmapWriteOpt opt, rz_u64 *keylen) {
+    if (opt.string_keys) {
+        const char *key = *(const char *const *)elem;
+        RZ_ASSERT_NOT_NULL(key);
+        *keylen = strlen(key);
+        return key;
+    }
+    *keylen = opt.keysize;
+    return elem;
+}
+
+RZ_DEF void rz__hm_mmap_serialize(const void *elems_ptr, rz_usize len, RZ_BytesArray *bytes, RZ__HmMmapWriteOpt opt) {
+    RZ_ASSERT(elems_ptr != NULL || len == 0, "rz_hm_mmap_serialize: invalid elements");
+    RZ_ASSERT_NOT_NULL(bytes);
+    RZ_ASSERT(!opt.string_keys || (opt.keysize == sizeof(const char *)), "rz_hm_mmap_serialize: string keys must be `const char *`");
+
+    const rz_u8 *elems = elems_ptr;
+
+    rz_u64 nslots         = RZ_MAX(rz_next_pow2(len * 2), RZ__HM_MMAP_MIN_SLOTS);
+    rz_u64 slots_offset   = rz__hm_mmap_align(sizeof(RZ_HmMmapHeader), RZ_HM_MMAP_ALIGN);
+    rz_u64 entries_offset = slots_offset + (nslots * sizeof(RZ_HmMmapSlot));
+    rz_u64 size           = entries_offset;
+    for (rz_u64 i = 0; i < len; ++i) {
+        rz_u64 keylen = 0;
+        rz__hm_mmap_elem_key(elems + (i * opt.elemsize), opt, &keylen);
+        size += rz__hm_mmap_entry_size(keylen, opt.valuesize);
+    }
+
+    rz_usize base = bytes->len;
+    rz_arr_resize(bytes, base + size);
+    rz_u8 *image = bytes->data + base;
+    memset(image, 0, size);
+
+    RZ_HmMmapHeader *header = (RZ_HmMmapHeader *)image;
+    RZ_HmMmapSlot   *slots  = (RZ_HmMmapSlot *)(image + slots_offset);
+    memcpy(header->magic, RZ__HM_MMAP_MAGIC, sizeof(header->magic));
+    header->version        = RZ_HM_MMAP_VERSION;
+    header->word_bits      = sizeof(rz_usize) * 8;
+    header->flags          = opt.string_keys ? RZ_HM_MMAP_STRING_KEYS : 0;
+    header->endian         = RZ__HM_MMAP_ENDIAN;
+    header->keysize        = opt.string_keys ? 0 : (rz_u32)opt.keysize;
+    header->valuesize      = opt.valuesize;
+    header->len            = len;
+    header->nslots         = nslots;
+    header->seed           = opt.seed;
+    header->slots_offset   = slots_offset;
+    header->entries_offset = entries_offset;
+    header->size           = size;
+
+    rz_u64 offset = entries_offset;
+    for (rz_u64 i = 0; i < len; ++i) {
+        const rz_u8 *elem   = elems + (i * opt.elemsize);
+        rz_u64       keylen = 0;
+        const void  *key    = rz__hm_mmap_elem_key(elem, opt, &keylen);
+
+        rz_u8 *entry = image + offset;
+        memcpy(entry, &keylen, sizeof(keylen));
+        if (keylen > 0) memcpy(entry + sizeof(rz_u64), key, keylen);
+        memcpy(entry + sizeof(rz_u64) + rz__hm_mmap_align(keylen + 1, 8), elem + opt.valueoffs, opt.valuesize);
+
+        // the keys is unique (RZ_Hm), the first empty slot is the place
+        rz_u64 hash = rz__hm_mmap_hash(key, keylen, opt.seed);
+        rz_u64 j    = hash & (nslots - 1);
+        while (slots[j].offset != 0) j = (j + 1) & (nslots - 1);
+        slots[j] = (RZ_HmMmapSlot){.hash = hash, .offset = offset};
+
+        offset += rz__hm_mmap_entry_size(keylen, opt.valuesize);
+    }
+    RZ_DBG_ASSERT(offset == size);
+    header->checksum = rz__hm_mmap_checksum(image, size);
+}
+
+RZ_DEF bool rz__hm_mmap_write(const void *elems, rz_usize len, const RZ_Path path, RZ__HmMmapWriteOpt opt) {
+    RZ_BytesArray bytes  = {.allocator = rz_std_allocator()};
+    bool          result = false;
+    auto          m      = rz_temp_snapshot();
+    RZ_Path       tmp    = rz_path(rz_asprintf(rz_temp_allocator(), "%.*s.tmp", RZ_PathArg(path)));
+
+    rz__hm_mmap_serialize(elems, len, &bytes, opt);
+    if (!rz_fs_write(tmp, bytes.data, bytes.len)) goto defer;
+    result = rz_fs_rename(tmp, path, .replace_existing = true);
+defer:
+    rz_arr_free(&bytes);
+    rz_temp_rewind(m);
+    return result;
+}
+
+///////////////
+/// Reader
+///
+RZ_DEF bool rz_hm_mmap_from_bytes(RZ_HmMmap *m, const void *data, rz_usize size, RZ_HmMmapOpenOpt opt) {
+    RZ_ASSERT_NOT_NULL(m);
+    *m = (RZ_HmMmap){0};
+    if (data == NULL || size < sizeof(RZ_HmMmapHeader)) {
+        RZ_ERROR_INTR("invalid file, size %zu is smaller than the header", size);
+        return false;
+    }
+    RZ_ASSERT(((rz_uptr)data & 7u) == 0, "rz_hm_mmap_from_bytes: data must be aligned to 8 bytes");
+
+    const RZ_HmMmapHeader *h = data;
+    if (memcmp(h->magic, RZ__HM_MMAP_MAGIC, sizeof(h->magic)) != 0) {
+        RZ_ERROR_INTR("invalid file, bad magic");
+        return false;
+    }
+    if (h->version != RZ_HM_MMAP_VERSION) {
+        RZ_ERROR_INTR("unsupported version %u (expected %u)", h->version, RZ_HM_MMAP_VERSION);
+        return false;
+    }
+    if (h->endian != RZ__HM_MMAP_ENDIAN || h->word_bits != sizeof(rz_usize) * 8) {
+        RZ_ERROR_INTR("the file is written on other platform (endianness or word size)");
+        return false;
+    }
+    if (h->size != size || !rz_is_pow2(h->nslots) || (h->slots_offset % RZ_HM_MMAP_ALIGN) != 0 || h->slots_offset < sizeof(RZ_HmMmapHeader)
+        || h->entries_offset != h->slots_offset + (h->nslots * sizeof(RZ_HmMmapSlot)) || h->entries_offset > size || h->len >= h->nslots) {
+        RZ_ERROR_INTR("invalid file, corrupted header");
+        return false;
+    }
+    if (opt.verify_checksum && rz__hm_mmap_checksum(data, size) != h->checksum) {
+        RZ_ERROR_INTR("invalid file, checksum mismatch");
+        return false;
+    }
+    m->base   = data;
+    m->size   = size;
+    m->header = h;
+    m->slots  = (const RZ_HmMmapSlot *)(m->base + h->slots_offset);
+    return true;
+}
+
+RZ_DEF bool rz_hm_mmap_open_opt(RZ_HmMmap *m, const RZ_Path path, RZ_HmMmapOpenOpt opt) {
+    RZ_ASSERT_NOT_NULL(m);
+    *m = (RZ_HmMmap){0};
+    RZ_Fd fd = rz_fd_open_read(path);
+    if (fd == RZ_INVALID_FD) return false;
+
+    void    *base = NULL;
+    rz_usize size = 0;
+#    if RZ_TARGET_OS_WINDOWS
+    LARGE_INTEGER file_size;
+    HANDLE        mapping = NULL;
+    if (!GetFileSizeEx(fd, &file_size)) {
+        RZ_OS_ERROR_INTR("Failed to get size of " RZ_PathFmt, RZ_PathArg(path));
+        rz_fd_close(fd);
+        return false;
+    }
+    size = (rz_usize)file_size.QuadPart;
+    if (size > 0) {
+        mapping = CreateFileMappingA(fd, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (base == NULL) {
+            RZ_OS_ERROR_INTR("Failed to map " RZ_PathFmt, RZ_PathArg(path));
+            if (mapping != NULL) CloseHandle(mapping);
+            rz_fd_close(fd);
+            return false;
+        }
+    }
+#    else
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        RZ_OS_ERROR_INTR("Failed to stat " RZ_PathFmt, RZ_PathArg(path));
+        rz_fd_close(fd);
+        return false;
+    }
+    size = (rz_usize)st.st_size;
+    if (size > 0) {
+        base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            RZ_OS_ERROR_INTR("Failed to map " RZ_PathFmt, RZ_PathArg(path));
+            rz_fd_close(fd);
+            return false;
+        }
+    }
+#    endif
+    // the mapping keep its own reference of the file
+    rz_fd_close(fd);
+
+    if (!rz_hm_mmap_from_bytes(m, base, size, opt)) {
+#    if RZ_TARGET_OS_WINDOWS
+        if (base != NULL) UnmapViewOfFile(base);
+        if (mapping != NULL) CloseHandle(mapping);
+#    else
+        if (base != NULL) munmap(base, size);
+#    endif
+        return false;
+    }
+    m->mapped = true;
+#    if RZ_TARGET_OS_WINDOWS
+    m->mapping = mapping;
+#    endif
+    return true;
+}
+
+RZ_DEF void rz_hm_mmap_close(RZ_HmMmap *m) {
+    RZ_ASSERT_NOT_NULL(m);
+    if (m->mapped) {
+#    if RZ_TARGET_OS_WINDOWS
+        UnmapViewOfFile(m->base);
+        CloseHandle(m->mapping);
+#    else
+        munmap((void *)m->base, m->size);
+#    endif
+    }
+    *m = (RZ_HmMmap){0};
+}
+
+RZ_DEF const void *rz_hm_mmap_find(const RZ_HmMmap *m, const void *key, rz_usize keysize) {
+    RZ_ASSERT_NOT_NULL(m);
+    const RZ_HmMmapHeader *h = m->header;
+    if (h == NULL || h->len == 0) return NULL;
+    if (!(h->flags & RZ_HM_MMAP_STRING_KEYS) && keysize != h->keysize) return NULL;
+
+    rz_u64 hash = rz__hm_mmap_hash(key, keysize, h->seed);
+    rz_u64 mask = h->nslots - 1;
+    // a corrupted file may have no empty slot, so the probe is bounded by the slot count
+    for (rz_u64 n = 0, i = hash & mask; n < h->nslots; ++n, i = (i + 1) & mask) {
+        const RZ_HmMmapSlot *slot = &m->slots[i];
+        if (slot->offset == 0) return NULL;
+        if (slot->hash != hash) continue;
+
+        // the entry offset is not covered by the header check, do not trust it
+        if (slot->offset < h->entries_offset || slot->offset > m->size - sizeof(rz_u64)) return NULL;
+        const rz_u8 *entry  = m->base + slot->offset;
+        rz_u64       keylen = *(const rz_u64 *)entry;
+        if (keylen != keysize || keylen > m->size) continue;
+        rz_u64 value_offset = slot->offset + sizeof(rz_u64) + rz__hm_mmap_align(keylen + 1, 8);
+        if (value_offset + h->valuesize > m->size) return NULL;
+        if (memcmp(entry + sizeof(rz_u64), key, keysize) == 0) return m->base + value_offset;
+    }
+    return NULL;
+}
+
+#    undef RZ_TAG
+#endif /* ifdef RZ_HM_MMAP_IMPL */
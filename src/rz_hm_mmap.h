@@ -0,0 +1,151 @@
+#pragma once
+#ifndef RZ_HM_MMAP_H
+#    define RZ_HM_MMAP_H
+#    include "rz_collections.h"
+#    include "rz_common.h"
+#    include "rz_fs.h"
+
+/// Memory mappable, read only, on disk hash table.
+/// the RZ_Hm is serialized once into position independent file, the reader map the file
+/// and answer lookups directly from the mapped pages, nothing is deserialized or allocated.
+/// the file is mapped shared read only, so every process that open the same file share the pages
+/// (from the os page cache) instead of rebuilding its own copy of the table.
+///
+/// file layout (native endian, the reader reject file with other endianness or word size):
+///
+///  [header     ] RZ_HmMmapHeader
+///  [slots      ] nslots * RZ_HmMmapSlot {hash, entry offset}, aligned to RZ_HM_MMAP_ALIGN,
+///                open addressing (linear probing), nslots is power of two, load <= 1/2.
+///  [entries    ] {rz_u64 keylen; key bytes + '\0'; value}, key and value aligned to 8 bytes.
+///
+/// the key is either fixed size bytes (the `.key` of the RZ_Hm element), or nul terminated
+/// string when the map is `RZ_Hm(const char *, Value)` and `.string_keys = true` is passed to the writer.
+/// the value is copied as plain bytes, so it must not contain pointers.
+///
+/// Example:
+///  RZ_Hm(rz_u64, Record) map = {0};
+///  ... fill the map ...
+///  rz_hm_mmap_write(rz_path("records.rzhm"), &map);
+///
+///  // in other process
+///  RZ_HmMmap m = {0};
+///  if (rz_hm_mmap_open(&m, rz_path("records.rzhm"))) {
+///      const Record *r = rz_hm_mmap_get(&m, (rz_u64)42);
+///      rz_hm_mmap_close(&m);
+///  }
+
+#    define RZ_HM_MMAP_VERSION      1U
+#    define RZ_HM_MMAP_ALIGN        64U
+#    define RZ_HM_MMAP_STRING_KEYS  (1U << 0)
+
+#    if defined(__cplusplus)
+extern "C" {
+#    endif
+
+typedef struct {
+    /// "RZHM"
+    rz_u8  magic[4];
+    rz_u16 version;
+    /// width of the hash (rz_hm_siphash_hash is computed on rz_usize)
+    rz_u8  word_bits;
+    /// RZ_HM_MMAP_STRING_KEYS
+    rz_u8  flags;
+    /// 0x01020304 written in the writer byte order
+    rz_u32 endian;
+    /// fixed key size (0 for string keys)
+    rz_u32 keysize;
+    rz_u64 valuesize;
+    rz_u64 len;
+    rz_u64 nslots;
+    rz_u64 seed;
+    rz_u64 slots_offset;
+    rz_u64 entries_offset;
+    /// total size of the file
+    rz_u64 size;
+    /// rz_hm_siphash_hash of the bytes after the header
+    rz_u64 checksum;
+} RZ_HmMmapHeader;
+
+typedef struct {
+    rz_u64 hash;
+    /// offset of the entry from the start of the file, 0 is empty slot.
+    rz_u64 offset;
+} RZ_HmMmapSlot;
+
+typedef struct {
+    const rz_u8           *base;
+    rz_usize               size;
+    const RZ_HmMmapHeader *header;
+    const RZ_HmMmapSlot   *slots;
+    /// true when `base` is mapped by rz_hm_mmap_open (and unmapped by rz_hm_mmap_close)
+    bool                   mapped;
+#    if RZ_TARGET_OS_WINDOWS
+    HANDLE mapping;
+#    endif
+} RZ_HmMmap;
+
+///////////////
+/// Writer
+///
+typedef struct {
+    rz_usize elemsize;
+    rz_usize keysize;
+    rz_usize valueoffs;
+    rz_usize valuesize;
+    /// the `.key` of the element is `const char *` (nul terminated)
+    bool     string_keys;
+    rz_usize seed;
+} RZ__HmMmapWriteOpt;
+
+/// append the file image of `len` elements `{key, value}` into `bytes`.
+RZ_DEC void rz__hm_mmap_serialize(const void *elems, rz_usize len, RZ_BytesArray *bytes, RZ__HmMmapWriteOpt opt);
+/// serialize the elements and write it into `path`. the file is written into `path.tmp` then renamed,
+/// so a reader that already map the old file keep its old (valid) pages.
+RZ_DEC bool rz__hm_mmap_write(const void *elems, rz_usize len, const RZ_Path path, RZ__HmMmapWriteOpt opt);
+
+// clang-format off
+#    define rz__hm_mmap_write_opt(hm, ...)  (RZ__HmMmapWriteOpt){                       \
+            .elemsize  = sizeof(*(hm)->data),                                          \
+            .keysize   = sizeof((hm)->data->key),                                      \
+            .valueoffs = RZ_OFFSETOF(RZ_TYPEOF(*(hm)->data), value),                   \
+            .valuesize = sizeof((hm)->data->value) __VA_OPT__(, ) __VA_ARGS__ }
+///  `hm` is RZ_Hm(Key, Value), or any container with `.data` and `.len` of `struct { Key key; Value value; }`
+///  (e.g. RZ_Array of the entries, the keys must be unique), the elements are written in the order of `.data`.
+///    void rz_hm_mmap_serialize(RZ_Hm(Key, Value) *hm, RZ_BytesArray *bytes, RZ__HmMmapWriteOpt...);
+///    bool rz_hm_mmap_write(const RZ_Path path, RZ_Hm(Key, Value) *hm, RZ__HmMmapWriteOpt...);
+#    define rz_hm_mmap_serialize(hm, bytes, ...) rz__hm_mmap_serialize((hm)->data, (hm)->len, bytes, rz__hm_mmap_write_opt(hm, __VA_ARGS__))
+#    define rz_hm_mmap_write(path, hm, ...)      rz__hm_mmap_write((hm)->data, (hm)->len, path, rz__hm_mmap_write_opt(hm, __VA_ARGS__))
+// clang-format on
+
+///////////////
+/// Reader
+///
+typedef struct {
+    /// check the checksum of the whole file, this touch every page of the file.
+    bool verify_checksum;
+} RZ_HmMmapOpenOpt;
+
+/// map the file read only (shared). return false (and set rz_strerror) if the file can not be
+/// mapped or the header is not valid.
+RZ_DEC bool rz_hm_mmap_open_opt(RZ_HmMmap *m, const RZ_Path path, RZ_HmMmapOpenOpt opt);
+#    define rz_hm_mmap_open(m, path, ...) rz_hm_mmap_open_opt(m, path, (RZ_HmMmapOpenOpt){__VA_ARGS__})
+/// use file image that is already in memory (e.g. from rz_hm_mmap_serialize), the bytes is not copied.
+RZ_DEC bool rz_hm_mmap_from_bytes(RZ_HmMmap *m, const void *data, rz_usize size, RZ_HmMmapOpenOpt opt);
+RZ_DEC void rz_hm_mmap_close(RZ_HmMmap *m);
+
+/// return pointer to the value of the key (inside the mapped file), or NULL if not found.
+RZ_DEC const void *rz_hm_mmap_find(const RZ_HmMmap *m, const void *key, rz_usize keysize);
+
+// clang-format off
+///    const Value *rz_hm_mmap_get(const RZ_HmMmap *m, Key _key);
+///    const Value *rz_hm_mmap_get_cstr(const RZ_HmMmap *m, const char *key);
+#    define rz_hm_mmap_get(m, _key)          rz_hm_mmap_find(m, RZ_ADDRESSOF(_key, _key), sizeof(_key))
+#    define rz_hm_mmap_get_cstr(m, cstr)     rz_hm_mmap_find(m, cstr, strlen(cstr))
+#    define rz_hm_mmap_get_sv(m, sv)         rz_hm_mmap_find(m, (sv).data, (sv).len)
+#    define rz_hm_mmap_len(m)                ((m)->header->len)
+// clang-format on
+
+#    if defined(__cplusplus)
+}
+#    endif
+#endif /* end of include guard: RZ_HM_MMAP_H */
@@ -0,0 +1,162 @@
+#include "rz_interner.h"
+
+#ifdef RZ_INTERNER_IMPL
+
+#    define RZ__INTERNER_INIT_CAPACITY 64U
+
+static inline rz_u32 rz__interner_hash(RZ_StrView sv) {
+    rz_u64 h = rz_hm_default_hash(sv.data, sv.len, 0);
+    return (rz_u32)(h ^ (h >> 32u));
+}
+
+RZ_DEF void rz_interner_init(RZ_Interner *in, RZ_Allocator allocator) {
+    RZ_ASSERT_NOT_NULL(in);
+    if (!rz_is_allocator(allocator)) allocator = rz_std_allocator();
+    *in = (RZ_Interner){
+        .arena     = rz_arena(allocator),
+        .strings   = {.allocator = allocator},
+        .allocator = allocator,
+    };
+}
+
+RZ_DEF void rz_interner_free(RZ_Interner *in) {
+    RZ_ASSERT_NOT_NULL(in);
+    rz_arena_free(&in->arena);
+    if (in->strings.data != NULL) rz_arr_free(&in->strings);
+    if (in->slots != NULL) rz_free(in->allocator, in->slots, in->capacity);
+    in->slots    = NULL;
+    in->capacity = 0;
+}
+
+// return the slot of `sv`, or the empty slot where it should be inserted.
+static RZ__InternerSlot *rz__interner_probe(const RZ_Interner *in, RZ_StrView sv, rz_u32 hash) {
+    rz_usize mask = in->capacity - 1;
+    for (rz_usize i = hash & mask;; i = (i + 1) & mask) {
+        RZ__InternerSlot *slot = &in->slots[i];
+        if (slot->symbol == 0) return slot;
+        if (slot->hash == hash) {
+            RZ_StrView s = in->strings.data[slot->symbol - 1];
+            if (s.len == sv.len && memcmp(s.data, sv.data, sv.len) == 0) return slot;
+        }
+    }
+}
+
+static void rz__interner_rehash(RZ_Interner *in, rz_usize capacity) {
+    RZ__InternerSlot *old_slots    = in->slots;
+    rz_usize          old_capacity = in->capacity;
+
+    in->slots    = rz_raw_calloc(in->allocator, capacity, sizeof(RZ__InternerSlot));
+    in->capacity = capacity;
+    RZ_ASSERT_ALLOCATOR_PTR(in->slots);
+    for (rz_usize i = 0; i < old_capacity; ++i) {
+        if (old_slots[i].symbol == 0) continue;
+        // strings is unique, the first empty slot is the place
+        rz_usize j = old_slots[i].hash & (capacity - 1);
+        while (in->slots[j].symbol != 0) j = (j + 1) & (capacity - 1);
+        in->slots[j] = old_slots[i];
+    }
+    if (old_slots != NULL) rz_free(in->allocator, old_slots, old_capacity);
+}
+
+static RZ_Symbol rz__interner_intern_hashed(RZ_Interner *in, RZ_StrView sv, rz_u32 hash) {
+    // keep the load factor below 3/4
+    if (((in->strings.len + 1) * 4) > (in->capacity * 3)) rz__interner_rehash(in, in->capacity ? in->capacity * 2 : RZ__INTERNER_INIT_CAPACITY);
+
+    RZ__InternerSlot *slot = rz__interner_probe(in, sv, hash);
+    if (slot->symbol != 0) return slot->symbol - 1;
+
+    RZ_ASSERT(in->strings.len < (rz_usize)RZ_SYMBOL_NONE, "rz_intern: too many symbols");
+    rz_char *data = rz_raw_alloc(rz_arena_allocator(&in->arena), sv.len + 1);
+    RZ_ASSERT_ALLOCATOR_PTR(data);
+    if (sv.len > 0) memcpy(data, sv.data, sv.len);
+    data[sv.len] = '\0';
+
+    RZ_Symbol sym = (RZ_Symbol)in->strings.len;
+    rz_arr_append(&in->strings, rz_sv_sized(data, sv.len));
+    slot->hash   = hash;
+    slot->symbol = sym + 1;
+    return sym;
+}
+
+static RZ_Symbol rz__interner_find_hashed(const RZ_Interner *in, RZ_StrView sv, rz_u32 hash) {
+    if (in->capacity == 0) return RZ_SYMBOL_NONE;
+    const RZ__InternerSlot *slot = rz__interner_probe(in, sv, hash);
+    return slot->symbol ? slot->symbol - 1 : RZ_SYMBOL_NONE;
+}
+
+RZ_DEF RZ_Symbol rz_intern(RZ_Interner *in, RZ_StrView sv) {
+    RZ_ASSERT_NOT_NULL(in);
+    return rz__interner_intern_hashed(in, sv, rz__interner_hash(sv));
+}
+
+RZ_DEF RZ_Symbol rz_interner_find(const RZ_Interner *in, RZ_StrView sv) {
+    RZ_ASSERT_NOT_NULL(in);
+    return rz__interner_find_hashed(in, sv, rz__interner_hash(sv));
+}
+
+///////////////
+/// SyncInterner
+///
+// the slot index use the low bits of the hash, so the shard use the high bits.
+#    define rz__sync_interner_shard(hash)   ((hash) >> (32U - RZ_INTERNER_SHARDS_BITS))
+#    define rz__sync_interner_symbol(s, l)  (((l) << RZ_INTERNER_SHARDS_BITS) | (s))
+
+RZ_DEF void rz_sync_interner_init(RZ_SyncInterner *in, RZ_Allocator allocator) {
+    RZ_ASSERT_NOT_NULL(in);
+    for (rz_usize i = 0; i < RZ_INTERNER_SHARDS; ++i) {
+        RZ_ASSERT(mtx_init(&in->shards[i].lock, mtx_plain) == thrd_success, "rz_sync_interner_init: mtx_init");
+        rz_interner_init(&in->shards[i].interner, allocator);
+    }
+}
+
+RZ_DEF void rz_sync_interner_free(RZ_SyncInterner *in) {
+    RZ_ASSERT_NOT_NULL(in);
+    for (rz_usize i = 0; i < RZ_INTERNER_SHARDS; ++i) {
+        rz_interner_free(&in->shards[i].interner);
+        mtx_destroy(&in->shards[i].lock);
+    }
+}
+
+RZ_DEF RZ_Symbol rz_sync_intern(RZ_SyncInterner *in, RZ_StrView sv) {
+    RZ_ASSERT_NOT_NULL(in);
+    rz_u32 hash  = rz__interner_hash(sv);
+    rz_u32 shard = rz__sync_interner_shard(hash);
+    mtx_lock(&in->shards[shard].lock);
+    RZ_Symbol local = rz__interner_intern_hashed(&in->shards[shard].interner, sv, hash);
+    mtx_unlock(&in->shards[shard].lock);
+    RZ_ASSERT(local < (RZ_SYMBOL_NONE >> RZ_INTERNER_SHARDS_BITS), "rz_sync_intern: too many symbols");
+    return rz__sync_interner_symbol(shard, local);
+}
+
+RZ_DEF RZ_Symbol rz_sync_interner_find(RZ_SyncInterner *in, RZ_StrView sv) {
+    RZ_ASSERT_NOT_NULL(in);
+    rz_u32 hash  = rz__interner_hash(sv);
+    rz_u32 shard = rz__sync_interner_shard(hash);
+    mtx_lock(&in->shards[shard].lock);
+    RZ_Symbol local = rz__interner_find_hashed(&in->shards[shard].interner, sv, hash);
+    mtx_unlock(&in->shards[shard].lock);
+    return (local == RZ_SYMBOL_NONE) ? RZ_SYMBOL_NONE : rz__sync_interner_symbol(shard, local);
+}
+
+RZ_DEF RZ_StrView rz_sync_interner_str(RZ_SyncInterner *in, RZ_Symbol sym) {
+    RZ_ASSERT_NOT_NULL(in);
+    rz_u32 shard = sym & (RZ_INTERNER_SHARDS - 1);
+    // the lock only guard the `strings` array that may be reallocated, the bytes never move.
+    mtx_lock(&in->shards[shard].lock);
+    RZ_StrView sv = rz_interner_str(&in->shards[shard].interner, sym >> RZ_INTERNER_SHARDS_BITS);
+    mtx_unlock(&in->shards[shard].lock);
+    return sv;
+}
+
+RZ_DEF rz_usize rz_sync_interner_len(RZ_SyncInterner *in) {
+    RZ_ASSERT_NOT_NULL(in);
+    rz_usize len = 0;
+    for (rz_usize i = 0; i < RZ_INTERNER_SHARDS; ++i) {
+        mtx_lock(&in->shards[i].lock);
+        len += rz_interner_len(&in->shards[i].interner);
+        mtx_unlock(&in->shards[i].lock);
+    }
+    return len;
+}
+
+#endif /* ifdef RZ_INTERNER_IMPL */
@@ -0,0 +1,105 @@
+#pragma once
+#ifndef RZ_INTERNER_H
+#    define RZ_INTERNER_H
+#    include "rz_allocator.h"
+#    include "rz_collections.h"
+#    include "rz_common.h"
+#    include "rz_strings.h"
+#    include "rz_sync.h"
+
+/// String interning, map every unique string into small integer symbol.
+/// the string is hashed and compared once when it is interned, after that
+/// the equality of two strings is an integer compare and the symbol can be used as
+/// key of array (symbol is dense, 0 ... len-1) or as cheap key of RZ_Hm.
+///
+///  - RZ_Interner    : single threaded. the bytes is copied into arena (with nul terminator),
+///                     the table is open addressing (linear probing) of {hash, symbol}.
+///  - RZ_SyncInterner: thread safe, RZ_INTERNER_SHARDS interner each with its own lock,
+///                     the shard is selected by the hash, so threads interning different strings usually take different locks.
+///
+/// Example:
+///  RZ_Interner in = {0};
+///  rz_interner_init(&in, rz_std_allocator());
+///  RZ_Symbol a = rz_intern_cstr(&in, "info");
+///  RZ_Symbol b = rz_intern(&in, rz_sv_sized(buf, 4));   // "info"
+///  assert(a == b);
+///  printf("%s\n", rz_interner_cstr(&in, a));
+///  rz_interner_free(&in);
+///
+/// NOTE: the interner keep pointer to its own arena, it must not be moved after init.
+///       the strings is never moved, RZ_StrView returned is valid until rz_interner_free.
+
+#    ifndef RZ_INTERNER_SHARDS_BITS
+#        define RZ_INTERNER_SHARDS_BITS 4U
+#    endif
+#    define RZ_INTERNER_SHARDS (1U << RZ_INTERNER_SHARDS_BITS)
+
+#    if defined(__cplusplus)
+extern "C" {
+#    endif
+
+typedef rz_u32 RZ_Symbol;
+/// returned by rz_interner_find when the string is not interned
+#    define RZ_SYMBOL_NONE ((RZ_Symbol)(-1))
+
+typedef struct {
+    rz_u32    hash;
+    /// symbol + 1, 0 is empty slot
+    RZ_Symbol symbol;
+} RZ__InternerSlot;
+
+typedef struct {
+    /// storage of the strings bytes
+    RZ_ArenaAllocator arena;
+    /// symbol -> string
+    RZ_Array(RZ_StrView) strings;
+    /// string -> symbol, capacity is power of two
+    RZ__InternerSlot *slots;
+    rz_usize          capacity;
+    RZ_Allocator      allocator;
+} RZ_Interner;
+
+/// if allocator is not valid use rz_std_allocator()
+RZ_DEC void      rz_interner_init(RZ_Interner *in, RZ_Allocator allocator);
+RZ_DEC void      rz_interner_free(RZ_Interner *in);
+/// return the symbol of `sv`, the string is copied into the interner if it is new.
+RZ_DEC RZ_Symbol rz_intern(RZ_Interner *in, RZ_StrView sv);
+/// return the symbol of `sv` or RZ_SYMBOL_NONE if `sv` is not interned, never insert.
+RZ_DEC RZ_Symbol rz_interner_find(const RZ_Interner *in, RZ_StrView sv);
+
+// clang-format off
+#    define rz_intern_cstr(in, cstr)         rz_intern(in, rz_sv(cstr))
+#    define rz_interner_find_cstr(in, cstr)  rz_interner_find(in, rz_sv(cstr))
+///  get the string of the symbol, O(1). crash if the symbol is not from this interner.
+///    RZ_StrView  rz_interner_str(const RZ_Interner *in, RZ_Symbol sym);
+///    const char *rz_interner_cstr(const RZ_Interner *in, RZ_Symbol sym);
+#    define rz_interner_str(in, sym)         rz_arr_at(&(in)->strings, sym)
+#    define rz_interner_cstr(in, sym)        ((const char *)rz_interner_str(in, sym).data)
+///  amount of unique strings
+#    define rz_interner_len(in)              ((in)->strings.len)
+// clang-format on
+
+///////////////
+/// SyncInterner
+///
+/// the symbol is `(local symbol << RZ_INTERNER_SHARDS_BITS) | shard`.
+/// symbols from RZ_SyncInterner is not dense, and not interchangeable with RZ_Interner symbols.
+typedef struct {
+    struct {
+        alignas(RZ_CACHE_LINE_SIZE) mtx_t lock;
+        RZ_Interner interner;
+    } shards[RZ_INTERNER_SHARDS];
+} RZ_SyncInterner;
+
+RZ_DEC void       rz_sync_interner_init(RZ_SyncInterner *in, RZ_Allocator allocator);
+RZ_DEC void       rz_sync_interner_free(RZ_SyncInterner *in);
+RZ_DEC RZ_Symbol  rz_sync_intern(RZ_SyncInterner *in, RZ_StrView sv);
+RZ_DEC RZ_Symbol  rz_sync_interner_find(RZ_SyncInterner *in, RZ_StrView sv);
+RZ_DEC RZ_StrView rz_sync_interner_str(RZ_SyncInterner *in, RZ_Symbol sym);
+RZ_DEC rz_usize   rz_sync_interner_len(RZ_SyncInterner *in);
+#    define rz_sync_intern_cstr(in, cstr) rz_sync_intern(in, rz_sv(cstr))
+
+#    if defined(__cplusplus)
+}
+#    endif
+#endif /* end of include guard: RZ_INTERNER_H */
@@ -267,23 +267,34 @@ static void rz__logger_default_flush(void *self) {
 
 static bool rz__log_level_parse(RZ_StrView s, RZ_LogLevel *level) {
     RZ_ASSERT_NOT_NULL(level);
-    if (rz_sv_case_eq(s, rz_sv_static("o")) || rz_sv_case_eq(s, rz_sv_static("off"))) {
-        *level = RZ_LOG_LEVEL_OFF;
-    } else if (rz_sv_case_eq(s, rz_sv_static("e")) || rz_sv_case_eq(s, rz_sv_static("err")) || rz_sv_case_eq(s, rz_sv_static("error"))) {
-        *level = RZ_LOG_LEVEL_ERROR;
-    } else if (rz_sv_case_eq(s, rz_sv_static("w")) || rz_sv_case_eq(s, rz_sv_static("warn")) || rz_sv_case_eq(s, rz_sv_static("warning"))) {
-        *level = RZ_LOG_LEVEL_WARN;
-    } else if (rz_sv_case_eq(s, rz_sv_static("i")) || rz_sv_case_eq(s, rz_sv_static("info"))) {
-        *level = RZ_LOG_LEVEL_INFO;
-    } else if (rz_sv_case_eq(s, rz_sv_static("d")) || rz_sv_case_eq(s, rz_sv_static("debug"))) {
-        *level = RZ_LOG_LEVEL_DEBUG;
-    } else if (rz_sv_case_eq(s, rz_sv_static("t")) || rz_sv_case_eq(s, rz_sv_static("trace"))) {
-        *level = RZ_LOG_LEVEL_TRACE;
-    } else {
-        RZ_ERROR_INTR("failed to parse log_level. required o|off,e|error,w|warning,i|info,d|debug,t|trace. but got: " RZ_SVFmt, RZ_SVArg(s));
-        return false;
+    static const struct {
+        const char *name;
+        RZ_LogLevel level;
+    } names[] = {
+        {"o", RZ_LOG_LEVEL_OFF},
+        {"off", RZ_LOG_LEVEL_OFF},
+        {"e", RZ_LOG_LEVEL_ERROR},
+        {"err", RZ_LOG_LEVEL_ERROR},
+        {"error", RZ_LOG_LEVEL_ERROR},
+        {"w", RZ_LOG_LEVEL_WARN},
+        {"warn", RZ_LOG_LEVEL_WARN},
+        {"warning", RZ_LOG_LEVEL_WARN},
+        {"i", RZ_LOG_LEVEL_INFO},
+        {"info", RZ_LOG_LEVEL_INFO},
+        {"d", RZ_LOG_LEVEL_DEBUG},
+        {"debug", RZ_LOG_LEVEL_DEBUG},
+        {"t", RZ_LOG_LEVEL_TRACE},
+        {"trace", RZ_LOG_LEVEL_TRACE},
+    };
+    // rz_sv_case_cmp reject the different length before it look at the bytes
+    for (rz_usize i = 0; i < RZ_ARRAY_LEN(names); ++i) {
+        if (rz_sv_case_eq_cstr(s, names[i].name)) {
+            *level = names[i].level;
+            return true;
+        }
     }
-    return true;
+    RZ_ERROR_INTR("failed to parse log_level. required o|off,e|error,w|warning,i|info,d|debug,t|trace. but got: " RZ_SVFmt, RZ_SVArg(s));
+    return false;
 }
 
 static bool rz__log_default_filter_map_parse(RZ__LogDefault *l, RZ_StrView filter) {
@@ -303,9 +314,8 @@ static bool rz__log_default_filter_map_parse(RZ__LogDefault *l, RZ_StrView filte
             RZ_ERROR_INTR("failed to parse log filter: `" RZ_SVFmt "`. required ':' between tag and log_level [example: $tag:$log_level]. but got none", RZ_SVArg(key_value));
             return false;
         }
-        rz_arr_split_at(&key_value, colon, &key, &value);
-        key   = rz_sv_trim(key);
-        value = rz_sv_trim(value);
+        key   = rz_sv_trim(rz_sv_sized(key_value.data, colon));
+        value = rz_sv_trim(rz_sv_sized(key_value.data + colon + 1, key_value.len - colon - 1));
         if (rz_sv_is_empty(key) || rz_sv_is_empty(value)) {
             RZ_ERROR_INTR("failed to parse log filter: `" RZ_SVFmt "`. required key and value on key:value is not empty", RZ_SVArg(key_value));
             return false;
@@ -315,7 +325,7 @@ static bool rz__log_default_filter_map_parse(RZ__LogDefault *l, RZ_StrView filte
         while (rz_sv_split_char(&key, ',', &k)) {
             k = rz_sv_trim(k);
             if (rz_sv_is_empty(k)) continue;
-            if (rz_sv_eq(key, rz_sv_static("all"))) {
+            if (rz_sv_eq(k, rz_sv_static("all"))) {
                 l->max_level = level;
                 continue;
             }
@@ -9,7 +9,7 @@
 extern "C" {
 #    endif /* ifndef  defined(__cplusplus) */
 
-/// TODO: implement utf8
+/// the UTF-8 validation, decoding and transcoding is in rz_utf8.h
 
 RZ_DEC bool    rz_is_ascii_whitespace(rz_char ch);
 RZ_DEC bool    rz_is_ascii_alphabetic(rz_char ch);
@@ -78,6 +78,18 @@ RZ_DEC rz_ptrdiff rz_sv_case_cmp(RZ_StrView lhs, RZ_StrView rhs);
 #    define rz_sv_case_eq(lhs, rhs)            (rz_sv_case_cmp(lhs, rhs) == 0)
 #    define rz_sv_case_eq_cstr(lhs, rhs_cstr)  rz_sv_case_eq(lhs, rz_sv(rhs_cstr))
 
+/// the ASCII case-insensitive search (the bytes >= 0x80 must match exactly), same result as rz_sv_find on the lowercase copies
+RZ_DEC rz_usize rz_sv_case_find(RZ_StrView sv, RZ_StrView needle);
+#    define rz_sv_case_find_cstr(sv, cstr)     rz_sv_case_find(sv, rz_sv(cstr))
+#    define rz_sv_case_contains(sv, pat)       (rz_sv_case_find(sv, pat) != RZ_NOT_FOUND)
+#    define rz_sv_case_contains_cstr(sv, cstr) rz_sv_case_contains(sv, rz_sv(cstr))
+
+/// hash of the ASCII lowercase bytes, the strings that is rz_sv_case_eq has the same hash
+RZ_DEC rz_usize rz_sv_case_hash(RZ_StrView sv, rz_usize seed);
+/// RZ_HmHashCmpFn of the RZ_StrView key that ignore the ASCII case, e.g.
+///  rz_hm_init(&headers, .hashcmp = rz_hm_hasheq_sv_case);
+RZ_DEC rz_usize rz_hm_hasheq_sv_case(RZ_HmHashCmpOp op, void const *a, void const *b, rz_usize len, rz_usize seed);
+
 RZ_DEC rz_ptrdiff rz_sv_cmp(RZ_StrView lhs, RZ_StrView rhs);
 #    define rz_sv_cmp_cstr(lhs, rhs_cstr) rz_sv_cmp(lhs, rz_sv(rhs_cstr))
 #    define rz_sv_eq(lhs, rhs)            (rz_sv_cmp(lhs, rhs) == 0)
@@ -99,6 +111,26 @@ RZ_DEC rz_usize rz_sv_rfind_by(RZ_StrView sv, RZ_StrViewCharPredicate fn);
 #    define rz_sv_contains_cstr(sv, cstr) rz_sv_contains(sv, rz_sv(cstr))
 #    define rz_sv_contains_char(sv, ch)   (rz_sv_find_char(sv, ch) != RZ_NOT_FOUND)
 
+/// index of the first/last byte of `sv` that is any of the `bytes`, e.g. rz_sv_find_any_cstr(line, "\r\n,")
+RZ_DEC rz_usize rz_sv_find_any(RZ_StrView sv, RZ_StrView bytes);
+RZ_DEC rz_usize rz_sv_rfind_any(RZ_StrView sv, RZ_StrView bytes);
+#    define rz_sv_find_any_cstr(sv, cstr)  rz_sv_find_any(sv, rz_sv(cstr))
+#    define rz_sv_rfind_any_cstr(sv, cstr) rz_sv_rfind_any(sv, rz_sv(cstr))
+
+/// precompiled needle for the repeated search of the same needle (the Two-Way factorization is computed once).
+/// the needle view must outlive the finder.
+typedef struct {
+    RZ_StrView needle;
+    rz_usize   crit, period;   // forward critical factorization
+    rz_usize   rcrit, rperiod; // reverse critical factorization
+    bool       periodic, rperiodic;
+} RZ_StrFinder;
+
+RZ_DEC RZ_StrFinder rz_sv_finder(RZ_StrView needle);
+/// same result as rz_sv_find/rz_sv_rfind with the needle of the finder
+RZ_DEC rz_usize rz_sv_finder_find(const RZ_StrFinder *f, RZ_StrView sv);
+RZ_DEC rz_usize rz_sv_finder_rfind(const RZ_StrFinder *f, RZ_StrView sv);
+
 RZ_DEC bool rz_sv_starts_with(RZ_StrView sv, RZ_StrView starts_sv);
 #    define rz_sv_starts_with_cstr(sv, starts) rz_sv_starts_with(sv, rz_sv(starts))
 #    define rz_sv_starts_with_char(sv, ch)     (((sv).len == 0 || (sv).data == NULL) ? false : ((sv).data[0] == ch))
@@ -144,6 +176,12 @@ RZ_DEC bool rz__sv_split_by(RZ_StrView *sv, RZ_StrViewCharPredicate fn, RZ_StrVi
 #    define rz_sv_split_inclusive_char(sv, delim, result)      rz__sv_split_char(sv, delim, result, true)
 #    define rz_sv_split_inclusive_by(sv, predicate, result)    rz__sv_split_by(sv, predicate, result, true)
 
+/// split by any of the `bytes`
+RZ_DEC bool rz__sv_split_any(RZ_StrView *sv, RZ_StrView bytes, RZ_StrView *result, bool inclusive);
+#    define rz_sv_split_any(sv, bytes, result)                 rz__sv_split_any(sv, bytes, result, false)
+#    define rz_sv_split_any_cstr(sv, cstr, result)             rz__sv_split_any(sv, rz_sv(cstr), result, false)
+#    define rz_sv_split_inclusive_any(sv, bytes, result)       rz__sv_split_any(sv, bytes, result, true)
+
 RZ_DEC bool rz__sv_rsplit(RZ_StrView *sv, RZ_StrView delim, RZ_StrView *result, bool inclusive);
 RZ_DEC bool rz__sv_rsplit_char(RZ_StrView *sv, char delim, RZ_StrView *result, bool inclusive);
 RZ_DEC bool rz__sv_rsplit_by(RZ_StrView *sv, RZ_StrViewCharPredicate fn, RZ_StrView *result, bool inclusive);
@@ -158,6 +196,11 @@ RZ_DEC bool rz__sv_rsplit_by(RZ_StrView *sv, RZ_StrViewCharPredicate fn, RZ_StrV
 #    define rz_sv_rsplit_inclusive_char(sv, delim, result)      rz__sv_rsplit_char(sv, delim, result, true)
 #    define rz_sv_rsplit_inclusive_by(sv, predicate, result)    rz__sv_rsplit_by(sv, predicate, result, true)
 
+RZ_DEC bool rz__sv_rsplit_any(RZ_StrView *sv, RZ_StrView bytes, RZ_StrView *result, bool inclusive);
+#    define rz_sv_rsplit_any(sv, bytes, result)                 rz__sv_rsplit_any(sv, bytes, result, false)
+#    define rz_sv_rsplit_any_cstr(sv, cstr, result)             rz__sv_rsplit_any(sv, rz_sv(cstr), result, false)
+#    define rz_sv_rsplit_inclusive_any(sv, bytes, result)       rz__sv_rsplit_any(sv, bytes, result, true)
+
 RZ_DEC bool rz__sv_split_once(RZ_StrView sv, RZ_StrView delim, RZ_StrView *left_result, RZ_StrView *right_result, bool inclusive);
 RZ_DEC bool rz__sv_split_once_char(RZ_StrView sv, rz_char delim, RZ_StrView *left_result, RZ_StrView *right_result, bool inclusive);
 RZ_DEC bool rz__sv_split_once_by(RZ_StrView sv, RZ_StrViewCharPredicate fn, RZ_StrView *left_result, RZ_StrView *right_result, bool inclusive);
@@ -191,11 +234,71 @@ RZ_DEC void rz_sv_to_ascii_uppercase(RZ_StrView *sv);
 /// required to change one string into the other.
 RZ_DEC rz_usize rz_sv_levenshtein_distance(RZ_StrView pattern, RZ_StrView txt);
 #    define rz_sv_levenshtein_distance_cstr(pattern, txt) rz_sv_levenshtein_distance(pattern, rz_sv(txt))
+/// Same as rz_sv_levenshtein_distance, but stop early and return `max_distance + 1`
+/// when the distance is larger than `max_distance`.
+RZ_DEC rz_usize rz_sv_levenshtein_distance_max(RZ_StrView pattern, RZ_StrView txt, rz_usize max_distance);
 
 /// Like Levenshtein but allows for adjacent transpositions. Each substring can
 /// only be edited once.
 RZ_DEC rz_usize rz_sv_osa_distance(RZ_StrView pattern, RZ_StrView txt);
 #    define rz_sv_osa_distance_cstr(pattern, txt) rz_sv_osa_distance(pattern, rz_sv(txt))
+RZ_DEC rz_usize rz_sv_osa_distance_max(RZ_StrView pattern, RZ_StrView txt, rz_usize max_distance);
+
+typedef struct {
+    rz_usize index;    // index of the candidate
+    rz_usize distance; // edit distance to the query
+} RZ_StrMatch;
+
+typedef struct {
+    /// skip the candidates farther than this, 0 is no limit
+    rz_usize max_distance;
+    /// OSA distance instead of Levenshtein
+    bool     transpositions;
+} RZ__SvFuzzyOpt;
+
+/// Scores the `query` against every candidate and writes the `k` closest into `out`, sorted by the distance
+/// (the earlier candidate first on tie). the search bound is lowered to the k-th best distance as it goes,
+/// so the far candidates exit early. return the amount of matches written (<= k).
+///   rz_usize rz_sv_fuzzy_top_k(RZ_StrView query, const RZ_StrView *candidates, rz_usize count, RZ_StrMatch *out, rz_usize k,
+///                              .max_distance = 3, .transpositions = true);
+#    define rz_sv_fuzzy_top_k(query, candidates, count, out, k, ...) rz__sv_fuzzy_top_k(query, candidates, count, out, k, (RZ__SvFuzzyOpt){__VA_ARGS__})
+RZ_DEC rz_usize rz__sv_fuzzy_top_k(RZ_StrView query, const RZ_StrView *candidates, rz_usize count, RZ_StrMatch *out, rz_usize k, RZ__SvFuzzyOpt opt);
+
+/// Number parsing directly from the view (not nul terminated, nothing is allocated), no whitespace is skipped.
+///  - integer: [+-]digits (u64 accept only '+'), 8 digits per step (SWAR). on overflow the value is clamped.
+///  - float: [+-](digits[.digits] | .digits)[(e|E)[+-]digits], "inf", "infinity" and "nan" (any case),
+///    correctly rounded (round to nearest even). the 19 significant digits is converted with Eisel-Lemire (the
+///    128 bit product with the power of 5), the longer mantissa that is not decided by its 19 digits prefix fall
+///    back to strtod/strtof of the canonical digits. the value out of range is ±inf with RZ_STR_PARSE_OVERFLOW.
+/// the result tell how many bytes is consumed, the number followed by other bytes is consumed < sv.len.
+typedef enum : rz_u8
+{
+    RZ_STR_PARSE_OK,
+    /// no number at the start of the view, nothing is consumed and the output is unchanged
+    RZ_STR_PARSE_INVALID,
+    /// the number does not fit the type, the output is clamped (or ±inf)
+    RZ_STR_PARSE_OVERFLOW,
+} RZ_StrParseStatus;
+
+typedef struct {
+    RZ_StrParseStatus status;
+    rz_usize          consumed;
+} RZ_StrParseResult;
+
+/// the whole view is the number that fit the type
+#    define rz_sv_parse_is_full(result, sv) ((result).status == RZ_STR_PARSE_OK && (result).consumed == (sv).len)
+
+RZ_DEC RZ_StrParseResult rz_sv_parse_i64(RZ_StrView sv, rz_i64 *out);
+RZ_DEC RZ_StrParseResult rz_sv_parse_u64(RZ_StrView sv, rz_u64 *out);
+RZ_DEC RZ_StrParseResult rz_sv_parse_f64(RZ_StrView sv, rz_f64 *out);
+RZ_DEC RZ_StrParseResult rz_sv_parse_f32(RZ_StrView sv, rz_f32 *out);
+
+/// parse the column of `count` views (e.g. the fields of the CSV column) into `out`, every view must be the whole
+/// number. return the index of the first view that is not, `count` when every view is parsed.
+RZ_DEC rz_usize rz_sv_parse_many_i64(const RZ_StrView *svs, rz_usize count, rz_i64 *out);
+RZ_DEC rz_usize rz_sv_parse_many_u64(const RZ_StrView *svs, rz_usize count, rz_u64 *out);
+RZ_DEC rz_usize rz_sv_parse_many_f64(const RZ_StrView *svs, rz_usize count, rz_f64 *out);
+RZ_DEC rz_usize rz_sv_parse_many_f32(const RZ_StrView *svs, rz_usize count, rz_f32 *out);
 
 #    if defined(__cplusplus)
 }
@@ -0,0 +1,304 @@
+#include "rz_sync.h"
+
+#ifdef RZ_SYNC_IMPL
+
+#    if RZ_SYNC_FUTEX && RZ_TARGET_OS_LINUX
+#        include <linux/futex.h>
+#        include <sys/syscall.h>
+#    elif RZ_SYNC_FUTEX && RZ_TARGET_OS_WINDOWS
+#        pragma comment(lib, "Synchronization.lib")
+#    endif
+
+RZ_DEF void rz_futex_wait(atomic_uint *addr, rz_u32 expected) {
+#    if RZ_SYNC_FUTEX && RZ_TARGET_OS_LINUX
+    syscall(SYS_futex, (void *)addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+#    elif RZ_SYNC_FUTEX && RZ_TARGET_OS_WINDOWS
+    WaitOnAddress((volatile void *)addr, &expected, sizeof(expected), INFINITE);
+#    else
+    if (atomic_load_explicit(addr, memory_order_relaxed) == expected) thrd_yield();
+#    endif
+}
+
+RZ_DEF void rz_futex_wake_all(atomic_uint *addr) {
+#    if RZ_SYNC_FUTEX && RZ_TARGET_OS_LINUX
+    syscall(SYS_futex, (void *)addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#    elif RZ_SYNC_FUTEX && RZ_TARGET_OS_WINDOWS
+    WakeByAddressAll((void *)addr);
+#    else
+    RZ_UNUSED(addr);
+#    endif
+}
+
+static inline void rz__sync_pause(rz_u32 spin) {
+    if (spin < (RZ_SYNC_SPIN_COUNT / 2)) {
+#    if RZ_TARGET_SIMD_SSE2
+        _mm_pause();
+#    elif RZ_TARGET_ARCH_AARCH64 && !RZ_TARGET_COMPILER_MSVC
+        __asm__ __volatile__("yield");
+#    endif
+    } else {
+        thrd_yield();
+    }
+}
+
+// called by the side that made progress (after the release store of head/tail).
+// the seq_cst fence pairs with the fence in rz__sync_block, so either the waiter see the progress
+// on its retry, or we see the waiter and bump the epoch.
+static inline void rz__sync_notify(RZ__SyncWaiter *w) {
+#    if RZ_SYNC_FUTEX
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&w->waiters, memory_order_relaxed) > 0) {
+        atomic_fetch_add_explicit(&w->epoch, 1, memory_order_release);
+        rz_futex_wake_all(&w->epoch);
+    }
+#    else
+    RZ_UNUSED(w);
+#    endif
+}
+
+// spin for a while, then sleep on the waiter epoch until the other side made progress.
+// `try_expr` is retried after registering as waiter, so the wakeup can't be missed.
+#    define rz__sync_block(w, try_expr)                                                 \
+        do {                                                                            \
+            for (rz_u32 spin = 0; !(try_expr); ++spin) {                                \
+                if (!RZ_SYNC_FUTEX || spin < RZ_SYNC_SPIN_COUNT) {                      \
+                    rz__sync_pause(spin % RZ_SYNC_SPIN_COUNT);                          \
+                    continue;                                                           \
+                }                                                                       \
+                atomic_fetch_add_explicit(&(w)->waiters, 1, memory_order_seq_cst);      \
+                rz_u32 epoch = atomic_load_explicit(&(w)->epoch, memory_order_acquire); \
+                atomic_thread_fence(memory_order_seq_cst);                              \
+                bool done = (try_expr);                                                 \
+                if (!done) rz_futex_wait(&(w)->epoch, epoch);                           \
+                atomic_fetch_sub_explicit(&(w)->waiters, 1, memory_order_relaxed);      \
+                if (done) break;                                                        \
+            }                                                                           \
+        } while (0)
+
+static rz_usize rz__queue_capacity(rz_usize capacity) {
+    if (capacity == 0) capacity = RZ_QUEUE_DEFAULT_CAPACITY;
+    return rz_next_pow2(capacity);
+}
+
+///////////////
+/// SpscQueue
+///
+
+RZ_DEF void rz__spsc_init(RZ__SpscQueue *q, RZ__QueueInitOpt opt) {
+    RZ_ASSERT_NOT_NULL(q);
+    RZ_ASSERT(opt.elemsize > 0);
+    if (!rz_is_allocator(opt.allocator)) opt.allocator = rz_std_allocator();
+
+    rz_usize capacity = rz__queue_capacity(opt.capacity);
+    *q                = (RZ__SpscQueue){0};
+    q->data           = rz_raw_alloc(opt.allocator, capacity * opt.elemsize);
+    RZ_ASSERT_ALLOCATOR_PTR(q->data);
+    q->mask      = capacity - 1;
+    q->elemsize  = opt.elemsize;
+    q->allocator = opt.allocator;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->waiter.epoch, 0);
+    atomic_init(&q->waiter.waiters, 0);
+}
+
+RZ_DEF void rz__spsc_free(RZ__SpscQueue *q) {
+    RZ_ASSERT_NOT_NULL(q);
+    if (q->data != NULL) rz_raw_dealloc(q->allocator, q->data, (q->mask + 1) * q->elemsize);
+    *q = (RZ__SpscQueue){0};
+}
+
+// copy `n` items from/into the ring starting at position `pos`, wrapping at most once.
+static inline void rz__ring_write(rz_u8 *ring, rz_usize mask, rz_usize elemsize, rz_usize pos, const rz_u8 *items, rz_usize n) {
+    rz_usize idx    = pos & mask;
+    rz_usize to_end = RZ_MIN(n, (mask + 1) - idx);
+    memcpy(ring + (idx * elemsize), items, to_end * elemsize);
+    if (to_end < n) memcpy(ring, items + (to_end * elemsize), (n - to_end) * elemsize);
+}
+
+static inline void rz__ring_read(const rz_u8 *ring, rz_usize mask, rz_usize elemsize, rz_usize pos, rz_u8 *out, rz_usize n) {
+    rz_usize idx    = pos & mask;
+    rz_usize to_end = RZ_MIN(n, (mask + 1) - idx);
+    memcpy(out, ring + (idx * elemsize), to_end * elemsize);
+    if (to_end < n) memcpy(out + (to_end * elemsize), ring, (n - to_end) * elemsize);
+}
+
+RZ_DEF rz_usize rz__spsc_push_many(RZ__SpscQueue *q, const void *items, rz_usize n) {
+    RZ_DBG_ASSERT(q != NULL && (items != NULL || n == 0));
+    rz_usize capacity = q->mask + 1;
+    rz_usize tail     = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    rz_usize space    = capacity - (tail - q->cached_head);
+    if (space < n) {
+        q->cached_head = atomic_load_explicit(&q->head, memory_order_acquire);
+        space          = capacity - (tail - q->cached_head);
+    }
+    n = RZ_MIN(n, space);
+    if (n == 0) return 0;
+
+    rz__ring_write(q->data, q->mask, q->elemsize, tail, items, n);
+    atomic_store_explicit(&q->tail, tail + n, memory_order_release);
+    rz__sync_notify(&q->waiter);
+    return n;
+}
+
+RZ_DEF rz_usize rz__spsc_pop_many(RZ__SpscQueue *q, void *out, rz_usize n) {
+    RZ_DBG_ASSERT(q != NULL && (out != NULL || n == 0));
+    rz_usize head  = atomic_load_explicit(&q->head, memory_order_relaxed);
+    rz_usize avail = q->cached_tail - head;
+    if (avail < n) {
+        q->cached_tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+        avail          = q->cached_tail - head;
+    }
+    n = RZ_MIN(n, avail);
+    if (n == 0) return 0;
+
+    rz__ring_read(q->data, q->mask, q->elemsize, head, out, n);
+    atomic_store_explicit(&q->head, head + n, memory_order_release);
+    rz__sync_notify(&q->waiter);
+    return n;
+}
+
+RZ_DEF bool rz__spsc_try_push(RZ__SpscQueue *q, const void *item) {
+    return rz__spsc_push_many(q, item, 1) == 1;
+}
+
+RZ_DEF bool rz__spsc_try_pop(RZ__SpscQueue *q, void *out) {
+    return rz__spsc_pop_many(q, out, 1) == 1;
+}
+
+RZ_DEF void rz__spsc_push(RZ__SpscQueue *q, const void *item) {
+    rz__sync_block(&q->waiter, rz__spsc_try_push(q, item));
+}
+
+RZ_DEF void rz__spsc_pop(RZ__SpscQueue *q, void *out) {
+    rz__sync_block(&q->waiter, rz__spsc_try_pop(q, out));
+}
+
+RZ_DEF rz_usize rz__spsc_len(RZ__SpscQueue *q) {
+    rz_usize head = atomic_load_explicit(&q->head, memory_order_acquire);
+    rz_usize tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    return (tail >= head) ? (tail - head) : 0;
+}
+
+///////////////
+/// MpmcQueue
+///
+
+RZ_DEF void rz__mpmc_init(RZ__MpmcQueue *q, RZ__QueueInitOpt opt) {
+    RZ_ASSERT_NOT_NULL(q);
+    RZ_ASSERT(opt.elemsize > 0);
+    if (!rz_is_allocator(opt.allocator)) opt.allocator = rz_std_allocator();
+
+    rz_usize capacity = rz__queue_capacity(opt.capacity);
+    *q                = (RZ__MpmcQueue){0};
+    q->data           = rz_raw_alloc(opt.allocator, capacity * opt.elemsize);
+    RZ_ASSERT_ALLOCATOR_PTR(q->data);
+    q->seq = rz_raw_alloc(opt.allocator, capacity * sizeof(atomic_size_t));
+    RZ_ASSERT_ALLOCATOR_PTR(q->seq);
+    for (rz_usize i = 0; i < capacity; ++i) atomic_init(&q->seq[i], i);
+
+    q->mask      = capacity - 1;
+    q->elemsize  = opt.elemsize;
+    q->allocator = opt.allocator;
+    atomic_init(&q->enqueue_pos, 0);
+    atomic_init(&q->dequeue_pos, 0);
+    atomic_init(&q->waiter.epoch, 0);
+    atomic_init(&q->waiter.waiters, 0);
+}
+
+RZ_DEF void rz__mpmc_free(RZ__MpmcQueue *q) {
+    RZ_ASSERT_NOT_NULL(q);
+    rz_usize capacity = q->mask + 1;
+    if (q->data != NULL) rz_raw_dealloc(q->allocator, q->data, capacity * q->elemsize);
+    if (q->seq != NULL) rz_raw_dealloc(q->allocator, (void *)q->seq, capacity * sizeof(atomic_size_t));
+    *q = (RZ__MpmcQueue){0};
+}
+
+// the cell at `pos` is free for producer when `seq == pos`, and ready for consumer when `seq == pos + 1`.
+// after consuming, the cell is released for the next round with `seq = pos + capacity`.
+static bool rz__mpmc_try_push_impl(RZ__MpmcQueue *q, const void *item) {
+    rz_usize pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+    for (;;) {
+        atomic_size_t *cell = &q->seq[pos & q->mask];
+        rz_usize       seq  = atomic_load_explicit(cell, memory_order_acquire);
+        rz_ptrdiff     diff = (rz_ptrdiff)seq - (rz_ptrdiff)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->enqueue_pos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                memcpy(q->data + ((pos & q->mask) * q->elemsize), item, q->elemsize);
+                atomic_store_explicit(cell, pos + 1, memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false; // full
+        } else {
+            pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+static bool rz__mpmc_try_pop_impl(RZ__MpmcQueue *q, void *out) {
+    rz_usize pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+    for (;;) {
+        atomic_size_t *cell = &q->seq[pos & q->mask];
+        rz_usize       seq  = atomic_load_explicit(cell, memory_order_acquire);
+        rz_ptrdiff     diff = (rz_ptrdiff)seq - (rz_ptrdiff)(pos + 1);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->dequeue_pos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                memcpy(out, q->data + ((pos & q->mask) * q->elemsize), q->elemsize);
+                atomic_store_explicit(cell, pos + q->mask + 1, memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false; // empty
+        } else {
+            pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+RZ_DEF bool rz__mpmc_try_push(RZ__MpmcQueue *q, const void *item) {
+    RZ_DBG_ASSERT(q != NULL && item != NULL);
+    if (!rz__mpmc_try_push_impl(q, item)) return false;
+    rz__sync_notify(&q->waiter);
+    return true;
+}
+
+RZ_DEF bool rz__mpmc_try_pop(RZ__MpmcQueue *q, void *out) {
+    RZ_DBG_ASSERT(q != NULL && out != NULL);
+    if (!rz__mpmc_try_pop_impl(q, out)) return false;
+    rz__sync_notify(&q->waiter);
+    return true;
+}
+
+RZ_DEF rz_usize rz__mpmc_push_many(RZ__MpmcQueue *q, const void *items, rz_usize n) {
+    RZ_DBG_ASSERT(q != NULL && (items != NULL || n == 0));
+    rz_usize pushed = 0;
+    while (pushed < n && rz__mpmc_try_push_impl(q, (const rz_u8 *)items + (pushed * q->elemsize))) pushed++;
+    // one notify for the whole batch.
+    if (pushed > 0) rz__sync_notify(&q->waiter);
+    return pushed;
+}
+
+RZ_DEF rz_usize rz__mpmc_pop_many(RZ__MpmcQueue *q, void *out, rz_usize n) {
+    RZ_DBG_ASSERT(q != NULL && (out != NULL || n == 0));
+    rz_usize popped = 0;
+    while (popped < n && rz__mpmc_try_pop_impl(q, (rz_u8 *)out + (popped * q->elemsize))) popped++;
+    if (popped > 0) rz__sync_notify(&q->waiter);
+    return popped;
+}
+
+RZ_DEF void rz__mpmc_push(RZ__MpmcQueue *q, const void *item) {
+    rz__sync_block(&q->waiter, rz__mpmc_try_push(q, item));
+}
+
+RZ_DEF void rz__mpmc_pop(RZ__MpmcQueue *q, void *out) {
+    rz__sync_block(&q->waiter, rz__mpmc_try_pop(q, out));
+}
+
+RZ_DEF rz_usize rz__mpmc_len(RZ__MpmcQueue *q) {
+    rz_usize head = atomic_load_explicit(&q->dequeue_pos, memory_order_acquire);
+    rz_usize tail = atomic_load_explicit(&q->enqueue_pos, memory_order_acquire);
+    return (tail >= head) ? (tail - head) : 0;
+}
+
+#endif /* ifdef RZ_SYNC_IMPL */
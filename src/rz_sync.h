@@ -0,0 +1,169 @@
+#pragma once
+#ifndef RZ_SYNC_H
+#    define RZ_SYNC_H
+#    include "rz_allocator.h"
+#    include "rz_common.h"
+
+/// Bounded inter-thread queues for pipeline stages.
+///  - RZ_SpscQueue(T): single producer single consumer ring, head and tail on separate cache line,
+///                     each side keep a cached copy of the other index to avoid cache line ping-pong.
+///  - RZ_MpmcQueue(T): multi producer multi consumer bounded queue (Dmitry Vyukov's design),
+///                     every cell have a sequence number, producers and consumers claim slot with CAS.
+///
+/// the `try_*` functions never block. the blocking wrappers spin for a while and then
+/// sleep on a futex word (linux futex / windows WaitOnAddress) until the other side make progress.
+/// define RZ_SYNC_FUTEX to 0 to compile out the futex wait and the notify on the hot path,
+/// then the blocking wrappers is spin + yield only.
+
+#    ifndef RZ_CACHE_LINE_SIZE
+#        if RZ_TARGET_FAMILY_APPLE && RZ_TARGET_ARCH_AARCH64
+#            define RZ_CACHE_LINE_SIZE 128
+#        else
+#            define RZ_CACHE_LINE_SIZE 64
+#        endif
+#    endif
+
+#    ifndef RZ_SYNC_FUTEX
+#        if RZ_TARGET_ANY(OS, LINUX, WINDOWS)
+#            define RZ_SYNC_FUTEX 1
+#        else
+#            define RZ_SYNC_FUTEX 0
+#        endif
+#    endif
+
+#    ifndef RZ_SYNC_SPIN_COUNT
+#        define RZ_SYNC_SPIN_COUNT 128U
+#    endif
+
+#    define RZ_QUEUE_DEFAULT_CAPACITY 1024U
+
+#    if defined(__cplusplus)
+extern "C" {
+#    endif
+
+/// futex word used by the blocking wrappers (internal use).
+typedef struct {
+    atomic_uint epoch;
+    atomic_uint waiters;
+} RZ__SyncWaiter;
+
+typedef struct {
+    rz_usize     elemsize;
+    /// rounded up to power of two. default: RZ_QUEUE_DEFAULT_CAPACITY
+    rz_usize     capacity;
+    /// default: rz_std_allocator()
+    RZ_Allocator allocator;
+} RZ__QueueInitOpt;
+
+typedef struct {
+    // consumer side
+    alignas(RZ_CACHE_LINE_SIZE) atomic_size_t head;
+    rz_usize cached_tail;
+    // producer side
+    alignas(RZ_CACHE_LINE_SIZE) atomic_size_t tail;
+    rz_usize cached_head;
+    // read only after init
+    alignas(RZ_CACHE_LINE_SIZE) rz_u8 *data;
+    rz_usize       mask;
+    rz_usize       elemsize;
+    RZ_Allocator   allocator;
+    RZ__SyncWaiter waiter;
+} RZ__SpscQueue;
+
+typedef struct {
+    alignas(RZ_CACHE_LINE_SIZE) atomic_size_t enqueue_pos;
+    alignas(RZ_CACHE_LINE_SIZE) atomic_size_t dequeue_pos;
+    // read only after init
+    alignas(RZ_CACHE_LINE_SIZE) atomic_size_t *seq;
+    rz_u8         *data;
+    rz_usize       mask;
+    rz_usize       elemsize;
+    RZ_Allocator   allocator;
+    RZ__SyncWaiter waiter;
+} RZ__MpmcQueue;
+
+// clang-format off
+///////////////
+/// SpscQueue & MpmcQueue Macors helpers
+///
+/// Example:
+///  RZ_SpscQueue(Job) q = {0};
+///  rz_spsc_init(&q, .capacity = 4096);
+///  // producer thread
+///  rz_spsc_push(&q, job);                     // blocking
+///  // consumer thread
+///  Job job;
+///  if (rz_spsc_try_pop(&q, &job)) { ... }     // non blocking
+///  rz_spsc_free(&q);
+///
+/// `__item` is never allocated, only used to carry the type `T` for the macros.
+#    define RZ_SpscQueue(T)  struct { RZ__SpscQueue base; T *__item; }
+#    define RZ_MpmcQueue(T)  struct { RZ__MpmcQueue base; T *__item; }
+
+///    void rz_spsc_init(RZ_SpscQueue(T) *q, RZ__QueueInitOpt...);
+#    define rz_spsc_init(q, ...)               rz__spsc_init(&(q)->base, (RZ__QueueInitOpt){ .elemsize = sizeof(*(q)->__item) __VA_OPT__(, ) __VA_ARGS__ })
+///    void rz_spsc_free(RZ_SpscQueue(T) *q);
+#    define rz_spsc_free(q)                    rz__spsc_free(&(q)->base)
+///    bool rz_spsc_try_push(RZ_SpscQueue(T) *q, T item);
+#    define rz_spsc_try_push(q, item)          rz__spsc_try_push(&(q)->base, RZ_ADDRESSOF(*(q)->__item, (item)))
+///    bool rz_spsc_try_pop(RZ_SpscQueue(T) *q, T *out);
+#    define rz_spsc_try_pop(q, out)            rz__spsc_try_pop(&(q)->base, (void *)(1 ? (out) : (q)->__item))
+///  push / pop as many item as possible (up to `n`) with at most two memcpy. return the amount of item pushed / popped.
+///    rz_usize rz_spsc_push_many(RZ_SpscQueue(T) *q, T *items, rz_usize n);
+///    rz_usize rz_spsc_pop_many(RZ_SpscQueue(T) *q, T *out, rz_usize n);
+#    define rz_spsc_push_many(q, items, n)     rz__spsc_push_many(&(q)->base, (const void *)(1 ? (items) : (q)->__item), (n))
+#    define rz_spsc_pop_many(q, out, n)        rz__spsc_pop_many(&(q)->base, (void *)(1 ? (out) : (q)->__item), (n))
+///  blocking wrappers. wait until there is space / item in the queue.
+///    void rz_spsc_push(RZ_SpscQueue(T) *q, T item);
+///    void rz_spsc_pop(RZ_SpscQueue(T) *q, T *out);
+#    define rz_spsc_push(q, item)              rz__spsc_push(&(q)->base, RZ_ADDRESSOF(*(q)->__item, (item)))
+#    define rz_spsc_pop(q, out)                rz__spsc_pop(&(q)->base, (void *)(1 ? (out) : (q)->__item))
+///  approximate amount of items in the queue.
+///    rz_usize rz_spsc_len(RZ_SpscQueue(T) *q);
+#    define rz_spsc_len(q)                     rz__spsc_len(&(q)->base)
+#    define rz_spsc_capacity(q)                ((q)->base.mask + 1)
+
+///    void rz_mpmc_init(RZ_MpmcQueue(T) *q, RZ__QueueInitOpt...);
+#    define rz_mpmc_init(q, ...)               rz__mpmc_init(&(q)->base, (RZ__QueueInitOpt){ .elemsize = sizeof(*(q)->__item) __VA_OPT__(, ) __VA_ARGS__ })
+#    define rz_mpmc_free(q)                    rz__mpmc_free(&(q)->base)
+#    define rz_mpmc_try_push(q, item)          rz__mpmc_try_push(&(q)->base, RZ_ADDRESSOF(*(q)->__item, (item)))
+#    define rz_mpmc_try_pop(q, out)            rz__mpmc_try_pop(&(q)->base, (void *)(1 ? (out) : (q)->__item))
+///  the items of batch is not claimed atomically as one group, items from other producers may interleave.
+#    define rz_mpmc_push_many(q, items, n)     rz__mpmc_push_many(&(q)->base, (const void *)(1 ? (items) : (q)->__item), (n))
+#    define rz_mpmc_pop_many(q, out, n)        rz__mpmc_pop_many(&(q)->base, (void *)(1 ? (out) : (q)->__item), (n))
+#    define rz_mpmc_push(q, item)              rz__mpmc_push(&(q)->base, RZ_ADDRESSOF(*(q)->__item, (item)))
+#    define rz_mpmc_pop(q, out)                rz__mpmc_pop(&(q)->base, (void *)(1 ? (out) : (q)->__item))
+#    define rz_mpmc_len(q)                     rz__mpmc_len(&(q)->base)
+#    define rz_mpmc_capacity(q)                ((q)->base.mask + 1)
+// clang-format on
+
+RZ_DEC void     rz__spsc_init(RZ__SpscQueue *q, RZ__QueueInitOpt opt);
+RZ_DEC void     rz__spsc_free(RZ__SpscQueue *q);
+RZ_DEC bool     rz__spsc_try_push(RZ__SpscQueue *q, const void *item);
+RZ_DEC bool     rz__spsc_try_pop(RZ__SpscQueue *q, void *out);
+RZ_DEC rz_usize rz__spsc_push_many(RZ__SpscQueue *q, const void *items, rz_usize n);
+RZ_DEC rz_usize rz__spsc_pop_many(RZ__SpscQueue *q, void *out, rz_usize n);
+RZ_DEC void     rz__spsc_push(RZ__SpscQueue *q, const void *item);
+RZ_DEC void     rz__spsc_pop(RZ__SpscQueue *q, void *out);
+RZ_DEC rz_usize rz__spsc_len(RZ__SpscQueue *q);
+
+RZ_DEC void     rz__mpmc_init(RZ__MpmcQueue *q, RZ__QueueInitOpt opt);
+RZ_DEC void     rz__mpmc_free(RZ__MpmcQueue *q);
+RZ_DEC bool     rz__mpmc_try_push(RZ__MpmcQueue *q, const void *item);
+RZ_DEC bool     rz__mpmc_try_pop(RZ__MpmcQueue *q, void *out);
+RZ_DEC rz_usize rz__mpmc_push_many(RZ__MpmcQueue *q, const void *items, rz_usize n);
+RZ_DEC rz_usize rz__mpmc_pop_many(RZ__MpmcQueue *q, void *out, rz_usize n);
+RZ_DEC void     rz__mpmc_push(RZ__MpmcQueue *q, const void *item);
+RZ_DEC void     rz__mpmc_pop(RZ__MpmcQueue *q, void *out);
+RZ_DEC rz_usize rz__mpmc_len(RZ__MpmcQueue *q);
+
+/// wait while `*addr == expected` (futex wait). may return spuriously.
+/// without RZ_SYNC_FUTEX, just yield the thread.
+RZ_DEC void rz_futex_wait(atomic_uint *addr, rz_u32 expected);
+/// wake all the threads waiting on `addr`.
+RZ_DEC void rz_futex_wake_all(atomic_uint *addr);
+
+#    if defined(__cplusplus)
+}
+#    endif
+#endif /* end of include guard: RZ_SYNC_H */
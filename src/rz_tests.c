@@ -12,7 +12,6 @@ static void       rz__tests_print_diff_bytes(FILE *out, const char *title_expect
 static void       rz__tests_case_failure(RZ__TestsGlobalCtx *gctx, RZ__TestCaseCtx *ctx, RZ_Duration dur);
 static void       rz__tests_case_success(RZ__TestsGlobalCtx *gctx, RZ__TestCaseCtx *ctx, RZ_Duration dur);
 static void       rz__tests_case_run(RZ__TestsGlobalCtx *gctx, RZ__TestCaseCtx *ctx);
-static inline int rz__tests_score_cmp(void const *a, void const *b);
 static bool       rz__tests_finish(RZ__TestsGlobalCtx *ctx);
 static bool       rz__tests_run(RZ__TestsGlobalCtx *ctx, RZ_StrView run_arg);
 static bool       rz__tests_lists(RZ__TestsGlobalCtx *ctx);
@@ -156,17 +155,6 @@ static void rz__tests_case_run(RZ__TestsGlobalCtx *gctx, RZ__TestCaseCtx *ctx) {
     }
 }
 
-struct RZ__Score {
-    rz_usize    score;
-    const char *name;
-};
-
-static inline int rz__tests_score_cmp(void const *a, void const *b) {
-    struct RZ__Score *aa = (struct RZ__Score *)a;
-    struct RZ__Score *bb = (struct RZ__Score *)b;
-    return aa->score - bb->score;
-}
-
 static bool rz__tests_finish(RZ__TestsGlobalCtx *ctx) {
     if (ctx->atty) {
         fprintf(ctx->output,
@@ -209,8 +197,8 @@ static bool rz__tests_run(RZ__TestsGlobalCtx *ctx, RZ_StrView run_arg) {
         auto m = rz_temp_snapshot();
         auto a = rz_temp_allocator();
         {
-            RZ_Array(struct RZ__Score) scores = {.allocator = a};
-            rz_arr_reserve(&scores, ctx->cases.len);
+            RZ_Array(RZ_StrView) names = {.allocator = a};
+            rz_arr_reserve(&names, ctx->cases.len);
 
             RZ__TestCaseCtx *found = NULL;
 
@@ -219,22 +207,22 @@ static bool rz__tests_run(RZ__TestsGlobalCtx *ctx, RZ_StrView run_arg) {
                     found = c;
                     break;
                 }
-                rz_usize score = rz_sv_levenshtein_distance_cstr(run_arg, c->name);
-                rz_arr_append(&scores, (struct RZ__Score){score, c->name});
+                rz_arr_append(&names, rz_sv(c->name));
             }
 
             if (found != NULL) {
+                rz_temp_rewind(m);
                 fprintf(ctx->output, "1 tests." RZ_ENDLINE);
                 rz__tests_case_run(ctx, found);
                 return rz__tests_finish(ctx);
             }
-            rz_arr_qsort(&scores, rz__tests_score_cmp);
+            RZ_StrMatch matches[5];
+            rz_usize    matches_len = rz_sv_fuzzy_top_k(run_arg, names.data, names.len, matches, RZ_ARRAY_LEN(matches), .transpositions = true);
 
             fprintf(stderr, "ERROR: Unknown tests case name: " RZ_SVFmt RZ_ENDLINE, RZ_SVArg(run_arg));
             fprintf(stderr, "help: do you mean this?" RZ_ENDLINE);
-            rz_usize max_score = RZ_MAX(5, scores.len);
-            for (rz_usize i = 0; i < max_score; i++) {
-                fprintf(stderr, "   - %s" RZ_ENDLINE, scores.data[i].name);
+            for (rz_usize i = 0; i < matches_len; i++) {
+                fprintf(stderr, "   - " RZ_SVFmt RZ_ENDLINE, RZ_SVArg(names.data[matches[i].index]));
             }
         }
         rz_temp_rewind(m);
@@ -10,7 +10,7 @@ static inline bool rz__add_u64(rz_u64 lhs, rz_u64 rhs, rz_u64 *result) {
 #if RZ_TARGET_COMPILER_MSVC
     return SUCCEEDED(ULongLongAdd(lhs, rhs, result));
 #elif RZ_HAS_BUILTIN(__builtin_add_overflow)
-    return __builtin_add_overflow(lhs, rhs, result);
+    return !__builtin_add_overflow(lhs, rhs, result);
 #else
     if ((lhs + rhs) >= lhs) {
         *result = (lhs + rhs);
@@ -24,7 +24,7 @@ static inline bool rz__sub_u64(rz_u64 lhs, rz_u64 rhs, rz_u64 *result) {
 #if RZ_TARGET_COMPILER_MSVC
     return SUCCEEDED(ULongLongSub(lhs, rhs, result));
 #elif RZ_HAS_BUILTIN(__builtin_sub_overflow)
-    return __builtin_sub_overflow(lhs, rhs, result);
+    return !__builtin_sub_overflow(lhs, rhs, result);
 #else
     if (lhs >= rhs) {
         *result = (lhs - rhs);
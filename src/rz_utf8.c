@@ -0,0 +1,379 @@
+#include "rz_utf8.h"
+
+#ifdef RZ_UTF8_IMPL
+
+#    define rz__utf8_is_cont(b) (((rz_u8)(b) & 0xC0u) == 0x80u)
+
+#    if RZ_TARGET_SIMD_AVX2
+#        define RZ__UTF8_VEC_BYTES 32u
+// the bit of every non ASCII byte / every non continuation byte of the block
+#        define rz__utf8_vec_non_ascii(p) ((rz_u64)(rz_u32)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)(p))))
+#        define rz__utf8_vec_leads(p)     ((rz_u64)(rz_u32)_mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_loadu_si256((const __m256i *)(p)), _mm256_set1_epi8(-65))))
+#        define RZ__UTF8_MASK_SHIFT       0u
+#    elif RZ_TARGET_SIMD_SSE2
+#        define RZ__UTF8_VEC_BYTES 16u
+#        define rz__utf8_vec_non_ascii(p) ((rz_u64)(rz_u32)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(p))))
+#        define rz__utf8_vec_leads(p)     ((rz_u64)(rz_u32)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_loadu_si128((const __m128i *)(p)), _mm_set1_epi8(-65))))
+#        define RZ__UTF8_MASK_SHIFT       0u
+#    elif RZ_TARGET_SIMD_NEON
+#        define RZ__UTF8_VEC_BYTES 16u
+// the shift right narrow give 4 bits per byte, only the top bit of the nibble is kept
+#        define rz__utf8_neon_mask(v)     (vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(v), 4)), 0) & 0x8888888888888888ull)
+#        define rz__utf8_vec_non_ascii(p) rz__utf8_neon_mask(vcltq_s8(vld1q_s8((const int8_t *)(p)), vdupq_n_s8(0)))
+#        define rz__utf8_vec_leads(p)     rz__utf8_neon_mask(vcgtq_s8(vld1q_s8((const int8_t *)(p)), vdupq_n_s8(-65)))
+#        define RZ__UTF8_MASK_SHIFT       2u
+#    endif
+
+RZ_DEF rz_usize rz_utf8_ascii_prefix(RZ_StrView sv) {
+    rz_usize i = 0;
+#    ifdef RZ__UTF8_VEC_BYTES
+    for (; (i + RZ__UTF8_VEC_BYTES) <= sv.len; i += RZ__UTF8_VEC_BYTES) {
+        rz_u64 mask = rz__utf8_vec_non_ascii(sv.data + i);
+        if (mask != 0) return i + (rz_ctz64(mask) >> RZ__UTF8_MASK_SHIFT);
+    }
+#    endif
+    for (; (i + sizeof(rz_u64)) <= sv.len; i += sizeof(rz_u64)) {
+        rz_u64 word = 0;
+        memcpy(&word, sv.data + i, sizeof(word));
+        if ((word & 0x8080808080808080ull) != 0) break;
+    }
+    while (i < sv.len && (rz_u8)sv.data[i] < 0x80u) ++i;
+    return i;
+}
+
+RZ_DEF rz_usize rz_utf8_count_codepoints(RZ_StrView sv) {
+    rz_usize count = 0, i = 0;
+#    ifdef RZ__UTF8_VEC_BYTES
+    for (; (i + RZ__UTF8_VEC_BYTES) <= sv.len; i += RZ__UTF8_VEC_BYTES) count += rz_popcount64(rz__utf8_vec_leads(sv.data + i));
+#    endif
+    for (; i < sv.len; ++i) count += !rz__utf8_is_cont(sv.data[i]);
+    return count;
+}
+
+RZ_DEF rz_usize rz_utf8_decode(RZ_StrView sv, rz_u32 *codepoint) {
+    RZ_ASSERT(sv.len > 0 && codepoint != NULL);
+    const rz_u8 *s = (const rz_u8 *)sv.data;
+    *codepoint     = RZ_UTF8_INVALID;
+    if (s[0] < 0x80u) {
+        *codepoint = s[0];
+        return 1;
+    }
+
+    // the range of the 2nd byte excludes the overlong (E0, F0), the surrogate (ED) and > U+10FFFF (F4)
+    rz_usize need = 0;
+    rz_u32   cp   = 0;
+    rz_u8    lo = 0x80u, hi = 0xBFu;
+    if (s[0] >= 0xC2u && s[0] <= 0xDFu) {
+        need = 1;
+        cp   = s[0] & 0x1Fu;
+    } else if (s[0] >= 0xE0u && s[0] <= 0xEFu) {
+        need = 2;
+        cp   = s[0] & 0x0Fu;
+        if (s[0] == 0xE0u) lo = 0xA0u;
+        if (s[0] == 0xEDu) hi = 0x9Fu;
+    } else if (s[0] >= 0xF0u && s[0] <= 0xF4u) {
+        need = 3;
+        cp   = s[0] & 0x07u;
+        if (s[0] == 0xF0u) lo = 0x90u;
+        if (s[0] == 0xF4u) hi = 0x8Fu;
+    } else {
+        return 1;
+    }
+
+    for (rz_usize i = 1; i <= need; ++i) {
+        if (i >= sv.len || s[i] < lo || s[i] > hi) return i;
+        cp = (cp << 6u) | (s[i] & 0x3Fu);
+        lo = 0x80u;
+        hi = 0xBFu;
+    }
+    *codepoint = cp;
+    return need + 1;
+}
+
+RZ_DEF rz_usize rz_utf8_encode(rz_u32 codepoint, rz_char out[RZ_UTF8_MAX_BYTES]) {
+    if (codepoint < 0x80u) {
+        out[0] = (rz_char)codepoint;
+        return 1;
+    }
+    if (codepoint < 0x800u) {
+        out[0] = (rz_char)(0xC0u | (codepoint >> 6u));
+        out[1] = (rz_char)(0x80u | (codepoint & 0x3Fu));
+        return 2;
+    }
+    if (codepoint < 0x10000u) {
+        if (codepoint >= 0xD800u && codepoint <= 0xDFFFu) return 0;
+        out[0] = (rz_char)(0xE0u | (codepoint >> 12u));
+        out[1] = (rz_char)(0x80u | ((codepoint >> 6u) & 0x3Fu));
+        out[2] = (rz_char)(0x80u | (codepoint & 0x3Fu));
+        return 3;
+    }
+    if (codepoint < 0x110000u) {
+        out[0] = (rz_char)(0xF0u | (codepoint >> 18u));
+        out[1] = (rz_char)(0x80u | ((codepoint >> 12u) & 0x3Fu));
+        out[2] = (rz_char)(0x80u | ((codepoint >> 6u) & 0x3Fu));
+        out[3] = (rz_char)(0x80u | (codepoint & 0x3Fu));
+        return 4;
+    }
+    return 0;
+}
+
+RZ_DEF bool rz_utf8_append(RZ_Str *s, rz_u32 codepoint) {
+    rz_char  bytes[RZ_UTF8_MAX_BYTES];
+    rz_usize n = rz_utf8_encode(codepoint, bytes);
+    if (n == 0) return false;
+    rz_str_append_sized_str(s, bytes, n);
+    return true;
+}
+
+RZ_DEF bool rz_utf8_iter_next(RZ_Utf8Iter *it, rz_u32 *codepoint) {
+    RZ_ASSERT_NOT_NULL(it);
+    if (it->pos >= it->sv.len) return false;
+    it->pos += rz_utf8_decode(rz_sv_sized(it->sv.data + it->pos, it->sv.len - it->pos), codepoint);
+    if (*codepoint == RZ_UTF8_INVALID) *codepoint = RZ_UTF8_REPLACEMENT;
+    return true;
+}
+
+// the valid prefix from `i`, `i` is the start of a codepoint
+static rz_usize rz__utf8_valid_up_to_scalar(RZ_StrView sv, rz_usize i) {
+    while (i < sv.len) {
+        if ((rz_u8)sv.data[i] < 0x80u) {
+            i += rz_utf8_ascii_prefix(rz_sv_sized(sv.data + i, sv.len - i));
+            continue;
+        }
+        rz_u32   cp = 0;
+        rz_usize n  = rz_utf8_decode(rz_sv_sized(sv.data + i, sv.len - i), &cp);
+        if (cp == RZ_UTF8_INVALID) return i;
+        i += n;
+    }
+    return sv.len;
+}
+
+#    if RZ_TARGET_SIMD_AVX2
+// the bits of the errors of the pair (previous byte, byte), see simdjson "Validating UTF-8 In Less Than One Instruction Per Byte"
+#        define RZ__UTF8_TOO_SHORT  (1u << 0u) // 11______ 0_______ or 11______ 11______
+#        define RZ__UTF8_TOO_LONG   (1u << 1u) // 0_______ 10______
+#        define RZ__UTF8_OVERLONG_3 (1u << 2u) // 11100000 100_____
+#        define RZ__UTF8_TOO_LARGE  (1u << 3u) // 11110100 1001____, 11110100 101_____, 11110101+ 10______
+#        define RZ__UTF8_SURROGATE  (1u << 4u) // 11101101 101_____
+#        define RZ__UTF8_OVERLONG_2 (1u << 5u) // 1100000_ 10______
+#        define RZ__UTF8_TOO_LARGE_1000 (1u << 6u) // 11110101+ 1000____
+#        define RZ__UTF8_OVERLONG_4 (1u << 6u) // 11110000 1000____
+#        define RZ__UTF8_TWO_CONTS  (1u << 7u) // 10______ 10______
+#        define RZ__UTF8_CARRY      (RZ__UTF8_TOO_SHORT | RZ__UTF8_TOO_LONG | RZ__UTF8_TWO_CONTS)
+
+// the block of the last `n` bytes of `prev` followed by the first `32 - n` bytes of `input`
+#        define rz__utf8_prev(input, prev, n) _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - (n))
+#        define rz__utf8_lookup(table, idx)   _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(table))), idx)
+
+static const rz_u8 rz__utf8_byte_1_high[16] = {
+    // 0_______ ________ <ASCII in byte 1>
+    RZ__UTF8_TOO_LONG, RZ__UTF8_TOO_LONG, RZ__UTF8_TOO_LONG, RZ__UTF8_TOO_LONG,
+    RZ__UTF8_TOO_LONG, RZ__UTF8_TOO_LONG, RZ__UTF8_TOO_LONG, RZ__UTF8_TOO_LONG,
+    // 10______ ________ <continuation in byte 1>
+    RZ__UTF8_TWO_CONTS, RZ__UTF8_TWO_CONTS, RZ__UTF8_TWO_CONTS, RZ__UTF8_TWO_CONTS,
+    // 1100____ ________ <two byte lead in byte 1>
+    RZ__UTF8_TOO_SHORT | RZ__UTF8_OVERLONG_2,
+    // 1101____ ________ <two byte lead in byte 1>
+    RZ__UTF8_TOO_SHORT,
+    // 1110____ ________ <three byte lead in byte 1>
+    RZ__UTF8_TOO_SHORT | RZ__UTF8_OVERLONG_3 | RZ__UTF8_SURROGATE,
+    // 1111____ ________ <four+ byte lead in byte 1>
+    RZ__UTF8_TOO_SHORT | RZ__UTF8_TOO_LARGE | RZ__UTF8_TOO_LARGE_1000 | RZ__UTF8_OVERLONG_4,
+};
+
+static const rz_u8 rz__utf8_byte_1_low[16] = {
+    // ____0000 ________
+    RZ__UTF8_CARRY | RZ__UTF8_OVERLONG_3 | RZ__UTF8_OVERLONG_2 | RZ__UTF8_OVERLONG_4,
+    // ____0001 ________
+    RZ__UTF8_CARRY | RZ__UTF8_OVERLONG_2,
+    // ____001_ ________
+    RZ__UTF8_CARRY,
+    RZ__UTF8_CARRY,
+    // ____0100 ________
+    RZ__UTF8_CARRY | RZ__UTF8_TOO_LARGE,
+    // ____0101 ________ ... ____1100 ________
+    RZ__UTF8_CARRY | RZ__UTF8_TOO_LARGE | RZ__UTF8_TOO_LARGE_1000,
+    RZ__UTF8_CARRY | RZ__UTF8_TOO_LARGE | RZ__UTF8_TOO_LARGE_1000,
+    RZ__UTF8_CARRY | RZ__UTF8_TOO_LARGE | RZ__UTF8_TOO_LARGE_1000,
+    RZ__UTF8_CARRY | RZ__UTF8_TOO_LARGE | RZ__UTF8_TOO_LARGE_1000,
+    RZ__UTF8_CARRY | RZ__UTF8_TOO_LARGE | RZ__UTF8_TOO_LARGE_1000,
+    RZ__UTF8_CARRY | RZ__UTF8_TOO_LARGE | RZ__UTF8_TOO_LARGE_1000,
+    RZ__UTF8_CARRY | RZ__UTF8_TOO_LARGE | RZ__UTF8_TOO_LARGE_1000,
+    RZ__UTF8_CARRY | RZ__UTF8_TOO_LARGE | RZ__UTF8_TOO_LARGE_1000,
+    // ____1101 ________
+    RZ__UTF8_CARRY | RZ__UTF8_TOO_LARGE | RZ__UTF8_TOO_LARGE_1000 | RZ__UTF8_SURROGATE,
+    // ____111_ ________
+    RZ__UTF8_CARRY | RZ__UTF8_TOO_LARGE | RZ__UTF8_TOO_LARGE_1000,
+    RZ__UTF8_CARRY | RZ__UTF8_TOO_LARGE | RZ__UTF8_TOO_LARGE_1000,
+};
+
+static const rz_u8 rz__utf8_byte_2_high[16] = {
+    // ________ 0_______ <ASCII in byte 2>
+    RZ__UTF8_TOO_SHORT, RZ__UTF8_TOO_SHORT, RZ__UTF8_TOO_SHORT, RZ__UTF8_TOO_SHORT,
+    RZ__UTF8_TOO_SHORT, RZ__UTF8_TOO_SHORT, RZ__UTF8_TOO_SHORT, RZ__UTF8_TOO_SHORT,
+    // ________ 1000____
+    RZ__UTF8_TOO_LONG | RZ__UTF8_OVERLONG_2 | RZ__UTF8_TWO_CONTS | RZ__UTF8_OVERLONG_3 | RZ__UTF8_TOO_LARGE_1000 | RZ__UTF8_OVERLONG_4,
+    // ________ 1001____
+    RZ__UTF8_TOO_LONG | RZ__UTF8_OVERLONG_2 | RZ__UTF8_TWO_CONTS | RZ__UTF8_OVERLONG_3 | RZ__UTF8_TOO_LARGE,
+    // ________ 101_____
+    RZ__UTF8_TOO_LONG | RZ__UTF8_OVERLONG_2 | RZ__UTF8_TWO_CONTS | RZ__UTF8_SURROGATE | RZ__UTF8_TOO_LARGE,
+    RZ__UTF8_TOO_LONG | RZ__UTF8_OVERLONG_2 | RZ__UTF8_TWO_CONTS | RZ__UTF8_SURROGATE | RZ__UTF8_TOO_LARGE,
+    // ________ 11______
+    RZ__UTF8_TOO_SHORT, RZ__UTF8_TOO_SHORT, RZ__UTF8_TOO_SHORT, RZ__UTF8_TOO_SHORT,
+};
+
+static inline __m256i rz__utf8_check_block(__m256i input, __m256i prev_input) {
+    __m256i nib   = _mm256_set1_epi8(0x0F);
+    __m256i prev1 = rz__utf8_prev(input, prev_input, 1);
+    __m256i sc    = _mm256_and_si256(
+        _mm256_and_si256(rz__utf8_lookup(rz__utf8_byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nib)),
+                         rz__utf8_lookup(rz__utf8_byte_1_low, _mm256_and_si256(prev1, nib))),
+        rz__utf8_lookup(rz__utf8_byte_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), nib)));
+    // the 3rd/4th byte of the sequence must be the continuation (the only pair errors that need 2/3 bytes back)
+    __m256i prev2  = rz__utf8_prev(input, prev_input, 2);
+    __m256i prev3  = rz__utf8_prev(input, prev_input, 3);
+    __m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0u - 0x80u))),
+                                     _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0u - 0x80u))));
+    return _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8((char)0x80u)), sc);
+}
+#    endif
+
+// the start of the codepoint that contain the byte before `i` (or `i`), to restart the scalar decoder
+static inline rz_usize rz__utf8_boundary(RZ_StrView sv, rz_usize i) {
+    rz_usize from = i;
+    while (from > 0 && (i - from) < 3 && rz__utf8_is_cont(sv.data[from - 1])) from--;
+    if (from > 0 && (rz_u8)sv.data[from - 1] >= 0xC0u) from--;
+    return from;
+}
+
+RZ_DEF rz_usize rz_utf8_valid_up_to(RZ_StrView sv) {
+    rz_usize i = 0;
+#    if RZ_TARGET_SIMD_AVX2
+    // the lead byte that is incomplete at the end of the block, 3 bytes from the end at most
+    __m256i max_value = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,                  //
+                                         -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xF0u - 1), (char)(0xE0u - 1), (char)(0xC0u - 1));
+    __m256i prev_input = _mm256_setzero_si256(), prev_incomplete = _mm256_setzero_si256(), error = _mm256_setzero_si256();
+    for (; (i + 32) <= sv.len; i += 32) {
+        __m256i input = _mm256_loadu_si256((const __m256i *)(sv.data + i));
+        if (_mm256_movemask_epi8(input) == 0) {
+            error           = _mm256_or_si256(error, prev_incomplete);
+            prev_incomplete = _mm256_setzero_si256();
+        } else {
+            error           = _mm256_or_si256(error, rz__utf8_check_block(input, prev_input));
+            prev_incomplete = _mm256_subs_epu8(input, max_value);
+        }
+        prev_input = input;
+        // the exact position of the error is found by the scalar decoder from the codepoint that cross into this block
+        if (!_mm256_testz_si256(error, error)) return rz__utf8_valid_up_to_scalar(sv, rz__utf8_boundary(sv, i));
+    }
+    i = rz__utf8_boundary(sv, i);
+#    endif
+    return rz__utf8_valid_up_to_scalar(sv, i);
+}
+
+RZ_DEF bool rz_utf8_to_utf16(RZ_StrView sv, RZ_Utf16Str *out) {
+    RZ_ASSERT_NOT_NULL(out);
+    if (sv.len == 0) return true;
+    // the UTF-16 units is never more than the UTF-8 bytes
+    rz_usize start = out->len;
+    rz_arr_reserve(out, out->len + sv.len);
+    rz_u16 *dst = out->data + out->len;
+    for (rz_usize i = 0; i < sv.len;) {
+        if ((rz_u8)sv.data[i] < 0x80u) {
+            rz_usize n = rz_utf8_ascii_prefix(rz_sv_sized(sv.data + i, sv.len - i));
+            for (rz_usize k = 0; k < n; ++k) dst[k] = (rz_u8)sv.data[i + k];
+            dst += n;
+            i += n;
+            continue;
+        }
+        rz_u32 cp = 0;
+        i += rz_utf8_decode(rz_sv_sized(sv.data + i, sv.len - i), &cp);
+        if (cp == RZ_UTF8_INVALID) {
+            out->len = start;
+            return false;
+        }
+        if (cp < 0x10000u) {
+            *dst++ = (rz_u16)cp;
+        } else {
+            cp -= 0x10000u;
+            *dst++ = (rz_u16)(0xD800u | (cp >> 10u));
+            *dst++ = (rz_u16)(0xDC00u | (cp & 0x3FFu));
+        }
+    }
+    out->len = (rz_usize)(dst - out->data);
+    return true;
+}
+
+RZ_DEF bool rz_utf8_to_utf32(RZ_StrView sv, RZ_Utf32Str *out) {
+    RZ_ASSERT_NOT_NULL(out);
+    if (sv.len == 0) return true;
+    rz_usize start = out->len;
+    rz_arr_reserve(out, out->len + sv.len);
+    rz_u32 *dst = out->data + out->len;
+    for (rz_usize i = 0; i < sv.len;) {
+        if ((rz_u8)sv.data[i] < 0x80u) {
+            rz_usize n = rz_utf8_ascii_prefix(rz_sv_sized(sv.data + i, sv.len - i));
+            for (rz_usize k = 0; k < n; ++k) dst[k] = (rz_u8)sv.data[i + k];
+            dst += n;
+            i += n;
+            continue;
+        }
+        i += rz_utf8_decode(rz_sv_sized(sv.data + i, sv.len - i), dst);
+        if (*dst++ == RZ_UTF8_INVALID) {
+            out->len = start;
+            return false;
+        }
+    }
+    out->len = (rz_usize)(dst - out->data);
+    return true;
+}
+
+RZ_DEF bool rz_utf16_to_utf8(const rz_u16 *data, rz_usize len, RZ_Str *out) {
+    RZ_ASSERT_NOT_NULL(out);
+    RZ_ASSERT(len == 0 || data != NULL);
+    if (len == 0) return true;
+    // 3 bytes per unit at most (the surrogate pair is 4 bytes for 2 units)
+    rz_usize start = out->len;
+    rz_arr_reserve(out, out->len + (len * 3));
+    rz_char *dst = out->data + out->len;
+    for (rz_usize i = 0; i < len;) {
+        rz_u32 cp = data[i++];
+        if (cp < 0x80u) {
+            *dst++ = (rz_char)cp;
+            while (i < len && data[i] < 0x80u) *dst++ = (rz_char)data[i++];
+            continue;
+        }
+        if (cp >= 0xD800u && cp <= 0xDBFFu && i < len && data[i] >= 0xDC00u && data[i] <= 0xDFFFu) {
+            cp = 0x10000u + ((cp - 0xD800u) << 10u) + (data[i++] - 0xDC00u);
+        }
+        rz_usize n = rz_utf8_encode(cp, dst);
+        if (n == 0) {
+            out->len = start;
+            return false;
+        }
+        dst += n;
+    }
+    out->len = (rz_usize)(dst - out->data);
+    return true;
+}
+
+RZ_DEF bool rz_utf32_to_utf8(const rz_u32 *data, rz_usize len, RZ_Str *out) {
+    RZ_ASSERT_NOT_NULL(out);
+    RZ_ASSERT(len == 0 || data != NULL);
+    if (len == 0) return true;
+    rz_usize start = out->len;
+    rz_arr_reserve(out, out->len + (len * RZ_UTF8_MAX_BYTES));
+    rz_char *dst = out->data + out->len;
+    for (rz_usize i = 0; i < len; ++i) {
+        rz_usize n = rz_utf8_encode(data[i], dst);
+        if (n == 0) {
+            out->len = start;
+            return false;
+        }
+        dst += n;
+    }
+    out->len = (rz_usize)(dst - out->data);
+    return true;
+}
+
+#endif /* ifdef RZ_UTF8_IMPL */
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef RZ_UTF8_H
+#    define RZ_UTF8_H
+#    include "rz_collections.h"
+#    include "rz_common.h"
+#    include "rz_strings.h"
+
+/// UTF-8 validation, decoding, counting and transcoding of RZ_StrView.
+///
+///  - rz_utf8_valid_up_to / rz_utf8_validate: the strict validation (no overlong, no surrogate, <= U+10FFFF).
+///    with AVX2 it is the lookup table algorithm of simdjson/simdutf (Keiser & Lemire): 3 nibble lookups of
+///    the byte and its previous byte classify every 32 bytes pair at once, the 3rd/4th continuation bytes
+///    is checked with the saturating subtract, the block of only ASCII is skipped with one movemask.
+///    other targets skip the ASCII runs with SSE2/NEON and decode the rest with the scalar decoder.
+///  - rz_utf8_ascii_prefix: the length of the leading ASCII bytes (16/32 bytes per step).
+///  - rz_utf8_count_codepoints: the amount of non continuation bytes (the input is assumed valid).
+///  - RZ_Utf8Iter: codepoint iterator, the invalid sequence is decoded as U+FFFD (maximal subpart).
+///  - rz_utf8_to_utf16/32, rz_utf16/32_to_utf8: transcoding, append to the output array,
+///    the ASCII runs is copied (widened/narrowed) without decoding.
+///
+/// Example:
+///  RZ_StrView text = ...;
+///  if (!rz_utf8_validate(text)) return false;
+///  RZ_Utf8Iter it = rz_utf8_iter(text);
+///  rz_u32      cp = 0;
+///  while (rz_utf8_iter_next(&it, &cp)) { ... }
+
+#    if defined(__cplusplus)
+extern "C" {
+#    endif
+
+#    define RZ_UTF8_MAX_BYTES   4u
+#    define RZ_UTF8_REPLACEMENT 0xFFFDu
+/// the codepoint of rz_utf8_decode for the invalid sequence
+#    define RZ_UTF8_INVALID     0xFFFFFFFFu
+
+typedef RZ_Array(rz_u16) RZ_Utf16Str;
+typedef RZ_Array(rz_u32) RZ_Utf32Str;
+
+/// the length of the longest valid UTF-8 prefix, sv.len when the whole string is valid
+RZ_DEC rz_usize rz_utf8_valid_up_to(RZ_StrView sv);
+#    define rz_utf8_validate(sv)      (rz_utf8_valid_up_to(sv) == (sv).len)
+#    define rz_utf8_validate_cstr(cs) rz_utf8_validate(rz_sv(cs))
+
+RZ_DEC rz_usize rz_utf8_ascii_prefix(RZ_StrView sv);
+#    define rz_utf8_is_ascii(sv) (rz_utf8_ascii_prefix(sv) == (sv).len)
+
+RZ_DEC rz_usize rz_utf8_count_codepoints(RZ_StrView sv);
+
+/// decode the codepoint at the start of `sv` (not empty), return its length in bytes.
+/// the invalid sequence set the codepoint to RZ_UTF8_INVALID and return the length of its maximal subpart (>= 1).
+RZ_DEC rz_usize rz_utf8_decode(RZ_StrView sv, rz_u32 *codepoint);
+/// encode the codepoint into `out`, return the length in bytes, 0 for the surrogate or > U+10FFFF.
+RZ_DEC rz_usize rz_utf8_encode(rz_u32 codepoint, rz_char out[RZ_UTF8_MAX_BYTES]);
+/// append the encoded codepoint, return false for the surrogate or > U+10FFFF.
+RZ_DEC bool     rz_utf8_append(RZ_Str *s, rz_u32 codepoint);
+
+typedef struct {
+    RZ_StrView sv;
+    rz_usize   pos; // byte offset of the next codepoint
+} RZ_Utf8Iter;
+
+#    define rz_utf8_iter(s) ((RZ_Utf8Iter){.sv = (s), .pos = 0})
+/// decode the next codepoint, return false at the end.
+RZ_DEC bool rz_utf8_iter_next(RZ_Utf8Iter *it, rz_u32 *codepoint);
+
+/// transcode the valid UTF-8, return false (and `out` is unchanged) when `sv` is invalid.
+RZ_DEC bool rz_utf8_to_utf16(RZ_StrView sv, RZ_Utf16Str *out);
+RZ_DEC bool rz_utf8_to_utf32(RZ_StrView sv, RZ_Utf32Str *out);
+/// return false (and `out` is unchanged) on the unpaired surrogate / the invalid codepoint.
+RZ_DEC bool rz_utf16_to_utf8(const rz_u16 *data, rz_usize len, RZ_Str *out);
+RZ_DEC bool rz_utf32_to_utf8(const rz_u32 *data, rz_usize len, RZ_Str *out);
+
+#    if defined(__cplusplus)
+}
+#    endif
+#endif /* end of include guard: RZ_UTF8_H */
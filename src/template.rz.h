@@ -8,14 +8,64 @@
 #ifdef RZ_IMPLEMENTATION
 #    define RZ_ALLOC_IMPL
 #    define RZ_ARGPARSE_IMPL
+#    define RZ_ART_IMPL
+#    define RZ_BITSET_IMPL
+#    define RZ_CACHE_IMPL
 #    define RZ_COLLECTIONS_IMPL
+#    define RZ_CSV_IMPL
+#    define RZ_EXTERNAL_SORT_IMPL
+#    define RZ_FILTER_IMPL
 #    define RZ_FS_IMPL
+#    define RZ_HAMT_IMPL
+#    define RZ_HM_MMAP_IMPL
+#    define RZ_INTERNER_IMPL
 #    define RZ_LOGGER_IMPL
 #    define RZ_PROCESS_IMPL
 #    define RZ_SPRINTF_IMPL
 #    define RZ_STRING_IMPL
+#    define RZ_SYNC_IMPL
 #    define RZ_TESTS_IMPL
 #    define RZ_TIME_IMPL
+#    define RZ_UTF8_IMPL
+#endif
+
+#ifdef RZ_CSV_IMPL
+#    ifndef RZ_FS_IMPL
+#        define RZ_FS_IMPL
+#    endif
+#    ifndef RZ_STRING_IMPL
+#        define RZ_STRING_IMPL
+#    endif
+#endif
+
+#ifdef RZ_EXTERNAL_SORT_IMPL
+#    ifndef RZ_FS_IMPL
+#        define RZ_FS_IMPL
+#    endif
+#    ifndef RZ_ALLOC_IMPL
+#        define RZ_ALLOC_IMPL
+#    endif
+#endif
+
+#ifdef RZ_HAMT_IMPL
+#    ifndef RZ_COLLECTIONS_IMPL
+#        define RZ_COLLECTIONS_IMPL
+#    endif
+#    ifndef RZ_ALLOC_IMPL
+#        define RZ_ALLOC_IMPL
+#    endif
+#endif
+
+#ifdef RZ_HM_MMAP_IMPL
+#    ifndef RZ_FS_IMPL
+#        define RZ_FS_IMPL
+#    endif
+#endif
+
+#ifdef RZ_INTERNER_IMPL
+#    ifndef RZ_STRING_IMPL
+#        define RZ_STRING_IMPL
+#    endif
 #endif
 
 #ifdef RZ_LOGGER_IMPL
@@ -63,6 +113,12 @@
 #    endif
 #endif
 
+#ifdef RZ_UTF8_IMPL
+#    ifndef RZ_STRING_IMPL
+#        define RZ_STRING_IMPL
+#    endif
+#endif
+
 #ifdef RZ_TIME_IMPL
 #    ifndef RZ_STRING_IMPL
 #        define RZ_STRING_IMPL
@@ -78,12 +134,42 @@
 #    endif
 #endif
 
+#ifdef RZ_BITSET_IMPL
+#    ifndef RZ_COLLECTIONS_IMPL
+#        define RZ_COLLECTIONS_IMPL
+#    endif
+#endif
+
+#ifdef RZ_CACHE_IMPL
+#    ifndef RZ_COLLECTIONS_IMPL
+#        define RZ_COLLECTIONS_IMPL
+#    endif
+#endif
+
+#ifdef RZ_FILTER_IMPL
+#    ifndef RZ_COLLECTIONS_IMPL
+#        define RZ_COLLECTIONS_IMPL
+#    endif
+#endif
+
 #ifdef RZ_COLLECTIONS_IMPL
 #    ifndef RZ_ALLOC_IMPL
 #        define RZ_ALLOC_IMPL
 #    endif
 #endif
 
+#ifdef RZ_ART_IMPL
+#    ifndef RZ_ALLOC_IMPL
+#        define RZ_ALLOC_IMPL
+#    endif
+#endif
+
+#ifdef RZ_SYNC_IMPL
+#    ifndef RZ_ALLOC_IMPL
+#        define RZ_ALLOC_IMPL
+#    endif
+#endif
+
 #ifdef RZ_SPRINTF_IMPL
 #    ifndef RZ_ALLOC_IMPL
 #        define RZ_ALLOC_IMPL
@@ -0,0 +1,142 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_art.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator   alc;
+    RZ_Art(rz_u32) tree;
+} Arts;
+
+RZ_TESTS_SETUP(Arts) {
+    fixture->alc  = rz_test_allocator(rz_std_allocator());
+    fixture->tree = (RZ_TYPEOF(fixture->tree)){.allocator = fixture->alc};
+}
+
+RZ_TESTS_TEARDOWN(Arts) {
+    rz_art_free(&fixture->tree);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+typedef struct {
+    char     keys[64][64];
+    rz_u32   values[64];
+    rz_usize len;
+} Collected;
+
+static bool collect(const rz_u8 *key, rz_usize key_len, void *value, void *user) {
+    Collected *c = user;
+    memcpy(c->keys[c->len], key, key_len);
+    c->keys[c->len][key_len] = '\0';
+    c->values[c->len++]      = *(rz_u32 *)value;
+    return c->len < 64;
+}
+
+static const char *paths[] = {
+    "/usr",
+    "/usr/lib",
+    "/usr/lib/libc.so",
+    "/usr/lib/libm.so",
+    "/usr/local/share/very/long/common/prefix/a",
+    "/usr/local/share/very/long/common/prefix/b",
+    "/usr/local/share/very/long/common/prefix",
+    "/usr/bin",
+    "/etc",
+    "",
+};
+
+RZ_TESTS(Arts, string_keys) {
+    for (rz_u32 i = 0; i < RZ_ARRAY_LEN(paths); ++i) rz_art_insert_cstr(&fixture->tree, paths[i], i);
+    RZ_TESTS_ASSERT_EQ(fixture->tree.len, RZ_ARRAY_LEN(paths));
+    for (rz_u32 i = 0; i < RZ_ARRAY_LEN(paths); ++i) {
+        rz_u32 *v = rz_art_get_cstr(&fixture->tree, paths[i]);
+        RZ_TESTS_ASSERT_TRUE(v != NULL && *v == i, "key: '%s'", paths[i]);
+    }
+    RZ_TESTS_ASSERT_TRUE(rz_art_get_cstr(&fixture->tree, "/us") == NULL);
+    RZ_TESTS_ASSERT_TRUE(rz_art_get_cstr(&fixture->tree, "/usr/local") == NULL);
+    RZ_TESTS_ASSERT_TRUE(rz_art_get_cstr(&fixture->tree, "/usr/local/share/very/long/common/prefiX") == NULL);
+
+    rz_art_insert_cstr(&fixture->tree, "/usr/lib", 100);
+    RZ_TESTS_ASSERT_EQ(fixture->tree.len, RZ_ARRAY_LEN(paths), "replace the value");
+    RZ_TESTS_ASSERT_EQ(*rz_art_get_cstr(&fixture->tree, "/usr/lib"), 100u);
+
+    Collected all = {0};
+    RZ_TESTS_ASSERT_TRUE(rz_art_foreach(&fixture->tree, collect, &all));
+    RZ_TESTS_ASSERT_EQ(all.len, RZ_ARRAY_LEN(paths));
+    for (rz_usize i = 1; i < all.len; ++i) RZ_TESTS_ASSERT_LT(strcmp(all.keys[i - 1], all.keys[i]), 0, "iterate in order");
+
+    Collected lib = {0};
+    rz_art_foreach_prefix(&fixture->tree, "/usr/lib", 8, collect, &lib);
+    RZ_TESTS_ASSERT_EQ(lib.len, 3u);
+    RZ_TESTS_ASSERT_STREQ(lib.keys[0], "/usr/lib");
+    RZ_TESTS_ASSERT_STREQ(lib.keys[2], "/usr/lib/libm.so");
+
+    Collected share = {0};
+    rz_art_foreach_prefix(&fixture->tree, "/usr/local/share/very/long/common/", 34, collect, &share);
+    RZ_TESTS_ASSERT_EQ(share.len, 3u);
+
+    Collected range = {0};
+    rz_art_foreach_range(&fixture->tree, "/usr/a", 6, "/usr/lib/libm", 13, collect, &range);
+    RZ_TESTS_ASSERT_EQ(range.len, 3u, "[/usr/bin, /usr/lib, /usr/lib/libc.so]");
+    RZ_TESTS_ASSERT_STREQ(range.keys[0], "/usr/bin");
+    RZ_TESTS_ASSERT_STREQ(range.keys[2], "/usr/lib/libc.so");
+
+    rz_usize matched = 0;
+    rz_u32  *route   = rz_art_longest_prefix(&fixture->tree, "/usr/lib/libc.so.6", 18, &matched);
+    RZ_TESTS_ASSERT_TRUE(route != NULL && *route == 2u);
+    RZ_TESTS_ASSERT_EQ(matched, 16u);
+    route = rz_art_longest_prefix(&fixture->tree, "/usr/libexec", 12, &matched);
+    RZ_TESTS_ASSERT_TRUE(route != NULL && matched == 8u);
+    route = rz_art_longest_prefix(&fixture->tree, "/opt", 4, &matched);
+    RZ_TESTS_ASSERT_TRUE(route != NULL && matched == 0u, "the empty key is the prefix of every key");
+
+    for (rz_u32 i = 0; i < RZ_ARRAY_LEN(paths); ++i) {
+        RZ_TESTS_ASSERT_TRUE(rz_art_remove(&fixture->tree, paths[i], strlen(paths[i])), "key: '%s'", paths[i]);
+        RZ_TESTS_ASSERT_FALSE(rz_art_remove(&fixture->tree, paths[i], strlen(paths[i])));
+        for (rz_u32 j = i + 1; j < RZ_ARRAY_LEN(paths); ++j) RZ_TESTS_ASSERT_TRUE(rz_art_get_cstr(&fixture->tree, paths[j]) != NULL, "key: '%s'", paths[j]);
+    }
+    RZ_TESTS_ASSERT_EQ(fixture->tree.len, 0u);
+    RZ_TESTS_ASSERT_TRUE(fixture->tree.root == NULL);
+}
+
+static bool count_u64(const rz_u8 *key, rz_usize key_len, void *value, void *user) {
+    rz_u64 *state = user; // [count, previous key]
+    rz_u64  k     = 0;
+    for (rz_usize i = 0; i < key_len; ++i) k = (k << 8U) | key[i];
+    if (state[0] > 0 && k <= state[1]) return false;
+    state[0]++;
+    state[1] = k;
+    (void)value;
+    return true;
+}
+
+RZ_TESTS(Arts, integer_keys_grow_and_shrink) {
+    // the keys 0..2999 fill Node4, Node16, Node48 and Node256 at the last byte
+    rz_u64 seed = 0x9e3779b97f4a7c15ULL;
+    for (rz_u64 i = 0; i < 3000; ++i) rz_art_insert_u64(&fixture->tree, i, (rz_u32)i);
+    for (rz_u64 i = 0; i < 200; ++i) {
+        seed = (seed * 6364136223846793005ULL) + 1442695040888963407ULL;
+        rz_art_insert_u64(&fixture->tree, seed, 7);
+    }
+    RZ_TESTS_ASSERT_EQ(fixture->tree.len, 3200u);
+    for (rz_u64 i = 0; i < 3000; ++i) RZ_TESTS_ASSERT_EQ(*rz_art_get_u64(&fixture->tree, i), (rz_u32)i);
+
+    rz_u64 state[2] = {0};
+    RZ_TESTS_ASSERT_TRUE(rz_art_foreach(&fixture->tree, count_u64, state), "numeric order");
+    RZ_TESTS_ASSERT_EQ(state[0], 3200u);
+
+    rz_u64 range[2] = {0};
+    rz_art_foreach_range(&fixture->tree, rz_art_key_u64(100).data, 8, rz_art_key_u64(2500).data, 8, count_u64, range);
+    RZ_TESTS_ASSERT_EQ(range[0], 2400u);
+    RZ_TESTS_ASSERT_EQ(range[1], 2499u);
+
+    for (rz_u64 i = 0; i < 3000; i += 2) RZ_TESTS_ASSERT_TRUE(rz_art_remove_u64(&fixture->tree, i));
+    for (rz_u64 i = 0; i < 3000; ++i) RZ_TESTS_ASSERT_EQ(rz_art_get_u64(&fixture->tree, i) != NULL, (i % 2) == 1);
+    for (rz_u64 i = 1; i < 3000; i += 2) RZ_TESTS_ASSERT_TRUE(rz_art_remove_u64(&fixture->tree, i));
+    RZ_TESTS_ASSERT_EQ(fixture->tree.len, 200u);
+}
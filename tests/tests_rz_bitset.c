@@ -0,0 +1,153 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_bitset.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator alc;
+    RZ_Bitset    a;
+    RZ_Bitset    b;
+    RZ_Roaring   x;
+    RZ_Roaring   y;
+    RZ_Roaring   res;
+} Bitsets;
+
+RZ_TESTS_SETUP(Bitsets) {
+    fixture->alc = rz_test_allocator(rz_std_allocator());
+    rz_bitset_init(&fixture->a, 1000, fixture->alc);
+    rz_bitset_init(&fixture->b, 700, fixture->alc);
+    rz_roaring_init(&fixture->x, fixture->alc);
+    rz_roaring_init(&fixture->y, fixture->alc);
+    rz_roaring_init(&fixture->res, fixture->alc);
+}
+
+RZ_TESTS_TEARDOWN(Bitsets) {
+    rz_bitset_free(&fixture->a);
+    rz_bitset_free(&fixture->b);
+    rz_roaring_free(&fixture->x);
+    rz_roaring_free(&fixture->y);
+    rz_roaring_free(&fixture->res);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+RZ_TESTS(Bitsets, bitset_rank_select_and_ops) {
+    // every multiple of 3 in `a`, every multiple of 5 in `b`
+    for (rz_usize i = 0; i < 1000; i += 3) { rz_bitset_set(&fixture->a, i); }
+    for (rz_usize i = 0; i < 700; i += 5) { rz_bitset_set(&fixture->b, i); }
+
+    RZ_TESTS_ASSERT_EQ(rz_bitset_count(&fixture->a), 334u);
+    RZ_TESTS_ASSERT_EQ(rz_bitset_rank(&fixture->a, 300), 100u, "rank count set bits before the index");
+    RZ_TESTS_ASSERT_EQ(rz_bitset_select(&fixture->a, 100), 300u);
+    RZ_TESTS_ASSERT_EQ(rz_bitset_select(&fixture->a, 334), RZ_NOT_FOUND);
+    RZ_TESTS_ASSERT_EQ(rz_bitset_next_set(&fixture->a, 301), 303u);
+    RZ_TESTS_ASSERT_EQ(rz_bitset_and_count(&fixture->a, &fixture->b), 47u, "multiples of 15 below 700");
+
+    rz_bitset_andnot(&fixture->a, &fixture->b);
+    RZ_TESTS_ASSERT_EQ(rz_bitset_count(&fixture->a), 334u - 47u);
+    RZ_TESTS_ASSERT_FALSE(rz_bitset_test(&fixture->a, 15));
+
+    rz_bitset_or(&fixture->b, &fixture->a);
+    RZ_TESTS_ASSERT_EQ(fixture->b.nbits, 1000u, "or grow dst to the size of src");
+    RZ_TESTS_ASSERT_TRUE(rz_bitset_test(&fixture->b, 999));
+
+    rz_usize prev = 0, n = 0;
+    rz_bitset_foreach(i, &fixture->b) {
+        RZ_TESTS_ASSERT_TRUE(n == 0 || i > prev, "foreach iterate in ascending order");
+        prev = i;
+        n++;
+    }
+    RZ_TESTS_ASSERT_EQ(n, rz_bitset_count(&fixture->b));
+
+    rz_bitset_set_range(&fixture->a, 10, 200, true);
+    rz_bitset_resize(&fixture->a, 64);
+    RZ_TESTS_ASSERT_EQ(rz_bitset_count(&fixture->a), 54u + 3u, "shrink clear the bits after nbits");
+    rz_bitset_resize(&fixture->a, 256);
+    RZ_TESTS_ASSERT_FALSE(rz_bitset_test(&fixture->a, 100));
+}
+
+RZ_TESTS(Bitsets, roaring_containers_and_set_algebra) {
+    // sparse chunk (array), dense chunk (bitmap) and a long range (run)
+    for (rz_u32 i = 0; i < 100; ++i) { RZ_TESTS_ASSERT_TRUE(rz_roaring_add(&fixture->x, i * 7)); }
+    RZ_TESTS_ASSERT_FALSE(rz_roaring_add(&fixture->x, 7), "value already in the bitmap");
+    for (rz_u32 i = 0; i < 10000; ++i) { rz_roaring_add(&fixture->x, (1u << 16) + (i * 2)); }
+    rz_roaring_add_range(&fixture->y, 0, 3u << 16);
+
+    RZ_TESTS_ASSERT_EQ(fixture->x.containers.len, 2u);
+    RZ_TESTS_ASSERT_EQ(fixture->x.containers.data[0].kind, RZ_ROARING_ARRAY);
+    RZ_TESTS_ASSERT_EQ(fixture->x.containers.data[1].kind, RZ_ROARING_BITMAP);
+    RZ_TESTS_ASSERT_EQ(fixture->y.containers.data[0].kind, RZ_ROARING_RUN);
+    RZ_TESTS_ASSERT_EQ(rz_roaring_cardinality(&fixture->x), 10100u);
+    RZ_TESTS_ASSERT_EQ(rz_roaring_cardinality(&fixture->y), 3u << 16);
+    RZ_TESTS_ASSERT_TRUE(rz_roaring_contains(&fixture->x, (1u << 16) + 19998));
+    RZ_TESTS_ASSERT_FALSE(rz_roaring_contains(&fixture->x, (1u << 16) + 19999));
+
+    RZ_TESTS_ASSERT_EQ(rz_roaring_and_cardinality(&fixture->x, &fixture->y), 10100u);
+    rz_roaring_andnot(&fixture->res, &fixture->y, &fixture->x);
+    RZ_TESTS_ASSERT_EQ(rz_roaring_cardinality(&fixture->res), (3u << 16) - 10100u);
+    rz_roaring_xor(&fixture->res, &fixture->x, &fixture->y);
+    RZ_TESTS_ASSERT_EQ(rz_roaring_cardinality(&fixture->res), (3u << 16) - 10100u);
+    rz_roaring_and(&fixture->res, &fixture->x, &fixture->y);
+
+    rz_u32 prev = 0;
+    rz_u64 n    = 0;
+    rz_roaring_foreach(v, &fixture->res) {
+        RZ_TESTS_ASSERT_TRUE(rz_roaring_contains(&fixture->x, v));
+        RZ_TESTS_ASSERT_TRUE(n == 0 || v > prev, "iterate in ascending order");
+        prev = v;
+        n++;
+    }
+    RZ_TESTS_ASSERT_EQ(n, 10100u);
+
+    // removing from a run container turn it into bitmap, down to array when it become sparse
+    for (rz_u32 i = 0; i < 65536 - 100; ++i) { RZ_TESTS_ASSERT_TRUE(rz_roaring_remove(&fixture->y, i)); }
+    RZ_TESTS_ASSERT_EQ(fixture->y.containers.data[0].kind, RZ_ROARING_ARRAY);
+    rz_usize before = rz_roaring_memory_usage(&fixture->y);
+    rz_roaring_run_optimize(&fixture->y);
+    RZ_TESTS_ASSERT_TRUE(rz_roaring_memory_usage(&fixture->y) < before);
+    RZ_TESTS_ASSERT_EQ(rz_roaring_cardinality(&fixture->y), (2u << 16) + 100u);
+}
+
+// fill the chunk `chunk` so it end up as `kind` container, `offset` shift the values
+static void tests_roaring_fill(RZ_Roaring *r, rz_u32 chunk, RZ_RoaringKind kind, rz_u32 offset) {
+    rz_u32 base = (chunk << 16u) + offset;
+    switch (kind) {
+    case RZ_ROARING_ARRAY:
+        for (rz_u32 i = 0; i < 300; ++i) rz_roaring_add(r, base + (i * 13));
+        break;
+    case RZ_ROARING_BITMAP:
+        for (rz_u32 i = 0; i < 20000; ++i) rz_roaring_add(r, base + (i * 3));
+        break;
+    case RZ_ROARING_RUN:
+        for (rz_u32 k = 0; k < 50; ++k) rz_roaring_add_range(r, base + (k * 1000), base + (k * 1000) + 400);
+        break;
+    }
+}
+
+RZ_TESTS(Bitsets, roaring_and_cardinality_every_kind_pair) {
+    const RZ_RoaringKind kinds[] = {RZ_ROARING_ARRAY, RZ_ROARING_BITMAP, RZ_ROARING_RUN};
+    for (rz_u32 i = 0; i < 3; ++i) {
+        for (rz_u32 j = 0; j < 3; ++j) {
+            tests_roaring_fill(&fixture->x, (i * 3) + j, kinds[i], 0);
+            tests_roaring_fill(&fixture->y, (i * 3) + j, kinds[j], 7);
+        }
+    }
+    rz_roaring_run_optimize(&fixture->x);
+    rz_roaring_run_optimize(&fixture->y);
+    for (rz_u32 c = 0; c < 9; ++c) {
+        RZ_TESTS_ASSERT_EQ(fixture->x.containers.data[c].kind, kinds[c / 3]);
+        RZ_TESTS_ASSERT_EQ(fixture->y.containers.data[c].kind, kinds[c % 3]);
+    }
+
+    rz_roaring_and(&fixture->res, &fixture->x, &fixture->y);
+    RZ_TESTS_ASSERT_EQ(rz_roaring_and_cardinality(&fixture->x, &fixture->y), rz_roaring_cardinality(&fixture->res));
+    RZ_TESTS_ASSERT_EQ(rz_roaring_and_cardinality(&fixture->y, &fixture->x), rz_roaring_cardinality(&fixture->res));
+    rz_u64 expected = 0;
+    rz_roaring_foreach(v, &fixture->x) { expected += rz_roaring_contains(&fixture->y, v); }
+    RZ_TESTS_ASSERT_EQ(rz_roaring_cardinality(&fixture->res), expected);
+    RZ_TESTS_ASSERT_GT(expected, 0u);
+}
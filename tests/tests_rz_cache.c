@@ -0,0 +1,127 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_cache.h"
+#include "rz_strings.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator                alc;
+    RZ_LruCache(rz_u32, rz_u64) cache;
+    rz_usize                    evicted;
+} Caches;
+
+static void count_evicted(void *key, void *value, void *user) {
+    (void)key, (void)value;
+    (*(rz_usize *)user)++;
+}
+
+RZ_TESTS_SETUP(Caches) {
+    fixture->alc     = rz_test_allocator(rz_std_allocator());
+    fixture->cache   = (RZ_TYPEOF(fixture->cache)){0};
+    fixture->evicted = 0;
+}
+
+RZ_TESTS_TEARDOWN(Caches) {
+    rz_lru_free(&fixture->cache);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+RZ_TESTS(Caches, lru_evict_least_recently_used) {
+    rz_lru_init(&fixture->cache, .max_entries = 3, .on_evict = count_evicted, .user = &fixture->evicted,
+                .allocator = fixture->alc);
+    RZ_TESTS_ASSERT_TRUE(rz_lru_get(&fixture->cache, 1) == NULL, "empty cache");
+
+    rz_lru_put(&fixture->cache, 1, 10);
+    rz_lru_put(&fixture->cache, 2, 20);
+    rz_lru_put(&fixture->cache, 3, 30);
+    RZ_TESTS_ASSERT_EQ(*rz_lru_get(&fixture->cache, 1), 10u, "1 is now the most recently used");
+
+    rz_lru_put(&fixture->cache, 4, 40);
+    RZ_TESTS_ASSERT_EQ(fixture->cache.len, 3u);
+    RZ_TESTS_ASSERT_EQ(fixture->cache.evictions, 1u);
+    RZ_TESTS_ASSERT_FALSE(rz_lru_contains(&fixture->cache, 2), "2 is the least recently used");
+    RZ_TESTS_ASSERT_TRUE(rz_lru_contains(&fixture->cache, 1));
+
+    // replace does not evict, but the old value is released
+    rz_lru_put(&fixture->cache, 3, 33);
+    RZ_TESTS_ASSERT_EQ(fixture->cache.len, 3u);
+    RZ_TESTS_ASSERT_EQ(*rz_lru_peek(&fixture->cache, 3), 33u);
+    RZ_TESTS_ASSERT_EQ(fixture->evicted, 2u);
+
+    RZ_TESTS_ASSERT_TRUE(rz_lru_remove(&fixture->cache, 4));
+    RZ_TESTS_ASSERT_FALSE(rz_lru_remove(&fixture->cache, 4));
+    RZ_TESTS_ASSERT_EQ(fixture->cache.len, 2u);
+
+    for (rz_u32 i = 100; i < 200; ++i) rz_lru_put(&fixture->cache, i, i);
+    RZ_TESTS_ASSERT_EQ(fixture->cache.len, 3u);
+    for (rz_u32 i = 197; i < 200; ++i) RZ_TESTS_ASSERT_EQ(*rz_lru_get(&fixture->cache, i), (rz_u64)i);
+    RZ_TESTS_ASSERT_EQ(fixture->cache.hits, 4u);
+    RZ_TESTS_ASSERT_EQ(fixture->cache.misses, 1u);
+
+    rz_lru_clear(&fixture->cache);
+    RZ_TESTS_ASSERT_EQ(fixture->cache.len, 0u);
+    RZ_TESTS_ASSERT_EQ(fixture->evicted, 3u + 99u + 3u, "every entry that leave the cache is released");
+}
+
+// the key is the owned copy, the released key is recorded
+static void release_key(void *key, void *value, void *user) {
+    (void)value;
+    *(const char **)user = ((RZ_StrView *)key)->data;
+}
+
+RZ_TESTS(Caches, lru_replace_owned_key) {
+    char                            first[] = "key", second[] = "key";
+    const char                     *released = NULL;
+    RZ_LruCache(RZ_StrView, rz_u64) cache    = {0};
+    rz_lru_init(&cache, .hashcmp = rz_hm_hasheq_sv_case, .on_evict = release_key, .user = &released, .allocator = fixture->alc);
+    rz_lru_put(&cache, rz_sv(first), 1);
+    rz_lru_put(&cache, rz_sv(second), 2);
+    RZ_TESTS_ASSERT_TRUE(released == first, "the old key is released with the old value");
+    RZ_TESTS_ASSERT_EQ(cache.len, 1u);
+    RZ_TESTS_ASSERT_TRUE(cache.data[0].key.data == second, "the new key is stored");
+    RZ_TESTS_ASSERT_EQ(*rz_lru_get(&cache, rz_sv("key")), 2u);
+    rz_lru_free(&cache);
+    RZ_TESTS_ASSERT_TRUE(released == second);
+}
+
+RZ_TESTS(Caches, lru_byte_budget) {
+    rz_lru_init(&fixture->cache, .max_bytes = 100, .allocator = fixture->alc);
+    rz_lru_put_cost(&fixture->cache, 1, 1, 40);
+    rz_lru_put_cost(&fixture->cache, 2, 2, 40);
+    RZ_TESTS_ASSERT_EQ(fixture->cache.bytes, 80u);
+
+    rz_lru_put_cost(&fixture->cache, 3, 3, 40);
+    RZ_TESTS_ASSERT_EQ(fixture->cache.bytes, 80u);
+    RZ_TESTS_ASSERT_FALSE(rz_lru_contains(&fixture->cache, 1));
+
+    rz_lru_put_cost(&fixture->cache, 2, 2, 10);
+    RZ_TESTS_ASSERT_EQ(fixture->cache.bytes, 50u, "replace update the cost");
+
+    rz_lru_put_cost(&fixture->cache, 4, 4, 500);
+    RZ_TESTS_ASSERT_FALSE(rz_lru_contains(&fixture->cache, 4), "bigger than the whole budget");
+    RZ_TESTS_ASSERT_EQ(fixture->cache.len, 0u);
+    RZ_TESTS_ASSERT_EQ(fixture->cache.bytes, 0u);
+}
+
+RZ_TESTS(Caches, clock_second_chance) {
+    rz_lru_init(&fixture->cache, .max_entries = 3, .policy = RZ_CACHE_CLOCK, .allocator = fixture->alc);
+    rz_lru_put(&fixture->cache, 1, 10);
+    rz_lru_put(&fixture->cache, 2, 20);
+    rz_lru_put(&fixture->cache, 3, 30);
+    RZ_TESTS_ASSERT_TRUE(rz_lru_get(&fixture->cache, 1) != NULL);
+
+    rz_lru_put(&fixture->cache, 4, 40);
+    RZ_TESTS_ASSERT_TRUE(rz_lru_contains(&fixture->cache, 1), "referenced entry get a second chance");
+    RZ_TESTS_ASSERT_FALSE(rz_lru_contains(&fixture->cache, 2));
+
+    for (rz_u32 i = 0; i < 1000; ++i) {
+        rz_lru_put(&fixture->cache, i % 50, i);
+        RZ_TESTS_ASSERT_EQ(*rz_lru_peek(&fixture->cache, i % 50), (rz_u64)i);
+    }
+    RZ_TESTS_ASSERT_EQ(fixture->cache.len, 3u);
+}
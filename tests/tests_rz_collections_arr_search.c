@@ -0,0 +1,65 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_collections.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef RZ_Array(rz_int) IntArray;
+
+RZ_TESTS_SETUP(IntArray) {
+    fixture->allocator = rz_test_allocator(rz_std_allocator());
+}
+
+RZ_TESTS_TEARDOWN(IntArray) {
+    rz_arr_free(fixture);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->allocator);
+}
+
+RZ_TESTS(IntArray, array_find_count_simd) {
+    // longer than the widest vector so the kernels go through both the simd and the scalar tail loop.
+    rz_usize len = 100;
+    for (rz_usize i = 0; i < len; ++i) { rz_arr_push(fixture, (rz_int)(i % 7)); }
+    RZ_TESTS_ASSERT_EQ(fixture->len, len);
+
+    RZ_TESTS_ASSERT_EQ(rz_arr_find(fixture, 6), 6u);
+    RZ_TESTS_ASSERT_EQ(rz_arr_rfind(fixture, 6), 97u);
+    RZ_TESTS_ASSERT_EQ(rz_arr_count(fixture, 6), 14u);
+    RZ_TESTS_ASSERT_EQ(rz_arr_count(fixture, 69), 0u);
+    RZ_TESTS_ASSERT_TRUE(rz_arr_contains(fixture, 1));
+    RZ_TESTS_ASSERT_FALSE(rz_arr_contains(fixture, 69));
+
+    RZ_Array(rz_usize) indices = {.allocator = fixture->allocator};
+    RZ_TESTS_ASSERT_EQ(rz_arr_find_all(fixture, 3, &indices), 14u);
+    RZ_TESTS_ASSERT_EQ(indices.len, 14u);
+    for (rz_usize i = 0; i < indices.len; ++i) { RZ_TESTS_ASSERT_EQ(indices.data[i], 3 + (i * 7)); }
+    rz_arr_free(&indices);
+
+    RZ_Array(rz_u8) bytes = {.allocator = fixture->allocator};
+    for (rz_usize i = 0; i < len; ++i) { rz_arr_push(&bytes, (rz_u8)(i % 7)); }
+    RZ_TESTS_ASSERT_EQ(rz_arr_find(&bytes, (rz_u8)6), 6u);
+    RZ_TESTS_ASSERT_EQ(rz_arr_rfind(&bytes, (rz_u8)6), 97u);
+    RZ_TESTS_ASSERT_EQ(rz_arr_count(&bytes, (rz_u8)6), 14u);
+    RZ_TESTS_ASSERT_EQ(rz_arr_find(&bytes, (rz_u8)69), RZ_ARR_FIND_NOTFOUND);
+    rz_arr_free(&bytes);
+}
+
+RZ_TESTS(IntArray, array_count_simd_long) {
+    // more than 255 vectors of the same byte, the per byte counters of the kernel must not wrap.
+    RZ_Array(rz_u8) bytes = {.allocator = fixture->allocator};
+    RZ_Array(rz_u64) words = {.allocator = fixture->allocator};
+    rz_usize len          = 20000 + 3;
+    for (rz_usize i = 0; i < len; ++i) {
+        rz_arr_push(&bytes, (rz_u8)((i % 5 == 0) ? 1 : 7));
+        rz_arr_push(&words, (rz_u64)7);
+    }
+    RZ_TESTS_ASSERT_EQ(rz_arr_count(&bytes, (rz_u8)7), len - 4001);
+    RZ_TESTS_ASSERT_EQ(rz_arr_count(&bytes, (rz_u8)1), 4001u);
+    RZ_TESTS_ASSERT_EQ(rz_arr_count(&words, (rz_u64)7), len);
+    RZ_TESTS_ASSERT_EQ(rz_arr_count(fixture, 7), 0u);
+    rz_arr_free(&bytes);
+    rz_arr_free(&words);
+}
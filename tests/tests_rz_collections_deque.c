@@ -0,0 +1,101 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_collections.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef RZ_Deque(rz_int) IntDeque;
+typedef RZ_ArrayView(rz_int) IntArrayView;
+
+#define assert_dq_empty(dq)                \
+    RZ_TESTS_ASSERT_EQ((dq)->capacity, 0u); \
+    RZ_TESTS_ASSERT_EQ((dq)->len, 0u);      \
+    RZ_TESTS_ASSERT_EQ((dq)->data, NULL)
+
+RZ_TESTS_SETUP(IntDeque) {
+    fixture->allocator = rz_test_allocator(rz_std_allocator());
+    assert_dq_empty(fixture);
+}
+
+RZ_TESTS_TEARDOWN(IntDeque) {
+    rz_dq_free(fixture);
+    assert_dq_empty(fixture);
+
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->allocator);
+}
+
+RZ_TESTS(IntDeque, deque_push_pop_both_ends) {
+    rz_dq_push_back(fixture, 1);
+    rz_dq_push_back(fixture, 2);
+    rz_dq_push_front(fixture, 0);
+
+    RZ_TESTS_ASSERT_EQ(fixture->len, 3u);
+    RZ_TESTS_ASSERT_TRUE(rz_is_pow2(fixture->capacity), "capacity of deque should always power of two");
+    RZ_TESTS_ASSERT_EQ(rz_dq_front(fixture), 0);
+    RZ_TESTS_ASSERT_EQ(rz_dq_back(fixture), 2);
+    RZ_TESTS_ASSERT_EQ(rz_dq_at(fixture, 1), 1);
+    RZ_TESTS_ASSERT_EQ(rz_dq_get(fixture, 3), NULL, "try to get with invalid index");
+
+    RZ_TESTS_ASSERT_EQ(rz_dq_pop_front(fixture), 0);
+    RZ_TESTS_ASSERT_EQ(rz_dq_pop_back(fixture), 2);
+    RZ_TESTS_ASSERT_EQ(rz_dq_pop_back(fixture), 1);
+    RZ_TESTS_ASSERT_TRUE(rz_dq_is_empty(fixture));
+}
+
+RZ_TESTS(IntDeque, deque_wrap_slices_and_grow) {
+    for (rz_int i = 0; i < 8; ++i) { rz_dq_push_back(fixture, i); }
+    RZ_TESTS_ASSERT_EQ(fixture->capacity, 8u);
+
+    // move the head forward, then push again so the ring wraps around the end of the buffer.
+    for (rz_int i = 0; i < 5; ++i) { RZ_TESTS_ASSERT_EQ(rz_dq_pop_front(fixture), i); }
+    for (rz_int i = 8; i < 12; ++i) { rz_dq_push_back(fixture, i); }
+    RZ_TESTS_ASSERT_EQ(fixture->capacity, 8u, "no grow while the deque is not full");
+
+    IntArrayView first  = {0};
+    IntArrayView second = {0};
+    rz_dq_slices(fixture, &first, &second);
+    RZ_TESTS_ASSERT_EQ(first.len + second.len, fixture->len);
+    RZ_TESTS_ASSERT_EQ(first.len, 3u);
+    for (rz_usize i = 0; i < first.len; ++i) { RZ_TESTS_ASSERT_EQ(first.data[i], (rz_int)(5 + i)); }
+    for (rz_usize i = 0; i < second.len; ++i) { RZ_TESTS_ASSERT_EQ(second.data[i], (rz_int)(8 + i)); }
+
+    // grow while wrapped, the items is unwrapped into the new buffer.
+    for (rz_int i = 12; i < 20; ++i) { rz_dq_push_back(fixture, i); }
+    RZ_TESTS_ASSERT_EQ(fixture->capacity, 16u);
+    RZ_TESTS_ASSERT_EQ(fixture->len, 15u);
+    for (rz_usize i = 0; i < fixture->len; ++i) { RZ_TESTS_ASSERT_EQ(rz_dq_at(fixture, i), (rz_int)(5 + i)); }
+
+    rz_dq_drop_front(fixture, 10);
+    rz_int many[] = {20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31};
+    rz_dq_push_back_many(fixture, many, RZ_ARRAY_LEN(many));
+    RZ_TESTS_ASSERT_EQ(fixture->len, 17u);
+
+    rz_int expected = 15;
+    rz_dq_foreach(it, fixture) { RZ_TESTS_ASSERT_EQ(*it, expected++); }
+}
+
+RZ_TESTS(IntDeque, deque_foreach_break) {
+    // wrapped ring, the walk cross the end of the buffer
+    for (rz_int i = 0; i < 6; ++i) { rz_dq_push_back(fixture, i); }
+    rz_dq_drop_front(fixture, 5);
+    for (rz_int i = 6; i < 12; ++i) { rz_dq_push_back(fixture, i); }
+
+    rz_int   expected = 5;
+    rz_usize visited  = 0;
+    rz_dq_foreach(it, fixture) {
+        RZ_TESTS_ASSERT_EQ(*it, expected++);
+        if (++visited == 4) break;
+    }
+    RZ_TESTS_ASSERT_EQ(visited, 4u, "break end the walk");
+
+    visited = 0;
+    rz_dq_foreach(it, fixture) { visited++; }
+    RZ_TESTS_ASSERT_EQ(visited, fixture->len);
+
+    rz_dq_clear(fixture);
+    rz_dq_foreach(it, fixture) { RZ_TESTS_ASSERT_TRUE(false, "empty deque"); }
+}
@@ -0,0 +1,147 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_collections.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    rz_u64 deadline;
+    rz_u32 task;
+} Timer;
+
+#define timer_less(a, b) ((a).deadline < (b).deadline)
+#define int_greater(a, b) ((a) > (b))
+
+RZ_HEAP_DEFINE(Timers, Timer, timer_less);
+RZ_HEAP_DEFINE(MaxHeap, int, int_greater);
+
+typedef struct {
+    RZ_Allocator alc;
+    Timers       timers;
+    MaxHeap      ints;
+} Heaps;
+
+RZ_TESTS_SETUP(Heaps) {
+    fixture->alc    = rz_test_allocator(rz_std_allocator());
+    fixture->timers = (Timers){.allocator = fixture->alc};
+    fixture->ints   = (MaxHeap){.allocator = fixture->alc};
+}
+
+RZ_TESTS_TEARDOWN(Heaps) {
+    Timers_free(&fixture->timers);
+    MaxHeap_free(&fixture->ints);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+static int cmp_int(const void *a, const void *b) {
+    return (*(const int *)a > *(const int *)b) - (*(const int *)a < *(const int *)b);
+}
+
+RZ_TESTS(Heaps, push_pop_in_order) {
+    RZ_TESTS_ASSERT_TRUE(MaxHeap_peek(&fixture->ints) == NULL);
+    rz_u32 seed = 7;
+    for (int i = 0; i < 1000; ++i) {
+        seed = (seed * 1103515245U) + 12345U;
+        MaxHeap_push(&fixture->ints, (int)((seed >> 16U) % 500U));
+    }
+    RZ_TESTS_ASSERT_EQ(fixture->ints.len, 1000u);
+
+    int prev = *MaxHeap_peek(&fixture->ints);
+    for (int i = 0; i < 1000; ++i) {
+        int v = MaxHeap_pop(&fixture->ints);
+        RZ_TESTS_ASSERT_LE(v, prev, "max heap pop in descending order");
+        prev = v;
+    }
+    RZ_TESTS_ASSERT_EQ(fixture->ints.len, 0u);
+
+    // heapify the items appended with rz_arr_*
+    int items[] = {5, 1, 9, 3, 7, 2, 8};
+    rz_arr_append_many(&fixture->ints, items, RZ_ARRAY_LEN(items));
+    MaxHeap_heapify(&fixture->ints);
+    RZ_TESTS_ASSERT_EQ(MaxHeap_pop(&fixture->ints), 9);
+    RZ_TESTS_ASSERT_EQ(MaxHeap_pop(&fixture->ints), 8);
+    RZ_TESTS_ASSERT_EQ(MaxHeap_pop(&fixture->ints), 7);
+}
+
+RZ_TESTS(Heaps, decrease_key_with_handle) {
+    RZ_HeapHandle handles[64];
+    for (rz_u32 i = 0; i < 64; ++i) handles[i] = Timers_push_handle(&fixture->timers, (Timer){.deadline = 1000 + i, .task = i});
+
+    Timers_update(&fixture->timers, handles[40], (Timer){.deadline = 1, .task = 40});
+    RZ_TESTS_ASSERT_EQ(Timers_peek(&fixture->timers)->task, 40u, "decrease key move the item to the top");
+    Timers_update(&fixture->timers, handles[40], (Timer){.deadline = 5000, .task = 40});
+    RZ_TESTS_ASSERT_EQ(Timers_peek(&fixture->timers)->task, 0u, "increase key move the item down");
+
+    Timer removed = Timers_remove(&fixture->timers, handles[10]);
+    RZ_TESTS_ASSERT_EQ(removed.task, 10u);
+    RZ_TESTS_ASSERT_FALSE(Timers_contains(&fixture->timers, handles[10]));
+    RZ_TESTS_ASSERT_TRUE(Timers_get(&fixture->timers, handles[10]) == NULL);
+
+    Timers_push(&fixture->timers, (Timer){.deadline = 500, .task = 99});
+    for (rz_u32 i = 0; i < 64; ++i) {
+        if (i == 10) continue;
+        RZ_TESTS_ASSERT_EQ(Timers_get(&fixture->timers, handles[i])->task, i, "the handle follow the item");
+    }
+
+    rz_u64 prev = 0;
+    rz_u32 count = 0;
+    while (fixture->timers.len > 0) {
+        Timer t = Timers_pop(&fixture->timers);
+        RZ_TESTS_ASSERT_GE(t.deadline, prev);
+        prev = t.deadline;
+        count++;
+    }
+    RZ_TESTS_ASSERT_EQ(count, 64u);
+    RZ_TESTS_ASSERT_EQ(prev, 5000u);
+
+    RZ_HeapHandle reused = Timers_push_handle(&fixture->timers, (Timer){.deadline = 1});
+    RZ_TESTS_ASSERT_TRUE(Timers_contains(&fixture->timers, reused));
+}
+
+RZ_TESTS(Heaps, stale_handle) {
+    RZ_HeapHandle old = Timers_push_handle(&fixture->timers, (Timer){.deadline = 10, .task = 1});
+    Timers_pop(&fixture->timers);
+    RZ_HeapHandle reused = Timers_push_handle(&fixture->timers, (Timer){.deadline = 20, .task = 2});
+    RZ_TESTS_ASSERT_EQ(rz__heap_handle_slot(reused), rz__heap_handle_slot(old), "the slot is reused");
+    RZ_TESTS_ASSERT_FALSE(Timers_contains(&fixture->timers, old), "with the next generation");
+    RZ_TESTS_ASSERT_TRUE(Timers_get(&fixture->timers, old) == NULL);
+    RZ_TESTS_ASSERT_EQ(Timers_get(&fixture->timers, reused)->task, 2u);
+
+    Timers_remove(&fixture->timers, reused);
+    RZ_HeapHandle third = Timers_push_handle(&fixture->timers, (Timer){.deadline = 30, .task = 3});
+    RZ_TESTS_ASSERT_FALSE(Timers_contains(&fixture->timers, reused));
+    RZ_TESTS_ASSERT_FALSE(Timers_contains(&fixture->timers, old));
+
+    Timers_clear(&fixture->timers);
+    RZ_HeapHandle after_clear = Timers_push_handle(&fixture->timers, (Timer){.deadline = 40, .task = 4});
+    RZ_TESTS_ASSERT_FALSE(Timers_contains(&fixture->timers, third), "clear release every handle");
+    RZ_TESTS_ASSERT_TRUE(Timers_contains(&fixture->timers, after_clear));
+}
+
+RZ_TESTS(Heaps, top_k) {
+    RZ_Array(int) values = {.allocator = fixture->alc};
+    RZ_Array(int) top    = {.allocator = fixture->alc};
+    rz_u32        seed   = 1;
+    for (int i = 0; i < 500; ++i) {
+        seed = (seed * 1103515245U) + 12345U;
+        rz_arr_append(&values, (int)((seed >> 16U) % 10000U));
+    }
+    rz_arr_top_k(&values, 10, cmp_int, &top);
+    RZ_TESTS_ASSERT_EQ(top.len, 10u);
+
+    rz_arr_qsort(&values, cmp_int);
+    for (rz_usize i = 0; i < 10; ++i) RZ_TESTS_ASSERT_EQ(top.data[i], values.data[values.len - 1 - i], "biggest first");
+
+    rz_arr_clear(&top);
+    rz_arr_top_k(&values, 1000, cmp_int, &top);
+    RZ_TESTS_ASSERT_EQ(top.len, 500u, "k is clamped to the length of the array");
+
+    MaxHeap h = rz_heap_from_array(MaxHeap, &values);
+    RZ_TESTS_ASSERT_EQ(MaxHeap_pop(&h), top.data[0], "the array buffer is moved into the heap");
+    MaxHeap_free(&h);
+    rz_arr_free(&top);
+}
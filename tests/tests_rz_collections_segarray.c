@@ -0,0 +1,79 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_collections.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator        alc;
+    RZ_SegArray(rz_u64) sa;
+} SegArrays;
+
+RZ_TESTS_SETUP(SegArrays) {
+    fixture->alc = rz_test_allocator(rz_std_allocator());
+    fixture->sa  = (RZ_TYPEOF(fixture->sa)){.allocator = fixture->alc};
+}
+
+RZ_TESTS_TEARDOWN(SegArrays) {
+    rz_segarr_free(&fixture->sa);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+RZ_TESTS(SegArrays, push_keep_address_stable) {
+    rz_segarr_push(&fixture->sa, 0);
+    rz_u64 *first = rz_segarr_at(&fixture->sa, 0);
+    for (rz_u64 i = 1; i < 10000; ++i) rz_segarr_push(&fixture->sa, i);
+    RZ_TESTS_ASSERT_EQ(fixture->sa.len, 10000u);
+    RZ_TESTS_ASSERT_TRUE(first == rz_segarr_at(&fixture->sa, 0), "the item is never moved");
+
+    for (rz_usize i = 0; i < fixture->sa.len; ++i) RZ_TESTS_ASSERT_EQ(*rz_segarr_at(&fixture->sa, i), (rz_u64)i);
+    RZ_TESTS_ASSERT_TRUE(rz_segarr_get(&fixture->sa, 10000) == NULL);
+
+    // segment boundaries: [0, 16), [16, 48), [48, 112), ...
+    RZ_TESTS_ASSERT_EQ(rz__segarr_segment(15), 0u);
+    RZ_TESTS_ASSERT_EQ(rz__segarr_segment(16), 1u);
+    RZ_TESTS_ASSERT_EQ(rz__segarr_segment(47), 1u);
+    RZ_TESTS_ASSERT_EQ(rz__segarr_segment(48), 2u);
+
+    rz_u64 sum = 0, count = 0;
+    rz_segarr_foreach(it, &fixture->sa) {
+        sum += *it;
+        count++;
+    }
+    RZ_TESTS_ASSERT_EQ(count, 10000u);
+    RZ_TESTS_ASSERT_EQ(sum, 9999u * 10000u / 2u);
+
+    count = 0;
+    rz_segarr_foreach(it, &fixture->sa) {
+        if (*it == 100) break;
+        count++;
+    }
+    RZ_TESTS_ASSERT_EQ(count, 100u, "break stop the whole iteration");
+
+    RZ_TESTS_ASSERT_EQ(rz_segarr_pop(&fixture->sa), 9999u);
+    RZ_TESTS_ASSERT_EQ(fixture->sa.len, 9999u);
+}
+
+RZ_TESTS(SegArrays, append_many) {
+    rz_u64 items[1000];
+    for (rz_u64 i = 0; i < RZ_ARRAY_LEN(items); ++i) items[i] = i;
+
+    rz_segarr_push(&fixture->sa, 42);
+    rz_segarr_append_many(&fixture->sa, items, RZ_ARRAY_LEN(items));
+    rz_segarr_append_many(&fixture->sa, items, 3);
+    RZ_TESTS_ASSERT_EQ(fixture->sa.len, 1004u);
+    RZ_TESTS_ASSERT_EQ(*rz_segarr_at(&fixture->sa, 0), 42u);
+    for (rz_usize i = 0; i < RZ_ARRAY_LEN(items); ++i) RZ_TESTS_ASSERT_EQ(*rz_segarr_at(&fixture->sa, i + 1), (rz_u64)i);
+    RZ_TESTS_ASSERT_EQ(*rz_segarr_at(&fixture->sa, 1003), 2u);
+
+    rz_usize capacity = fixture->sa.capacity;
+    rz_segarr_clear(&fixture->sa);
+    RZ_TESTS_ASSERT_TRUE(rz_segarr_is_empty(&fixture->sa));
+    rz_segarr_append_many(&fixture->sa, items, RZ_ARRAY_LEN(items));
+    RZ_TESTS_ASSERT_EQ(fixture->sa.capacity, capacity, "the segments is reused");
+    RZ_TESTS_ASSERT_EQ(*rz_segarr_at(&fixture->sa, 999), 999u);
+}
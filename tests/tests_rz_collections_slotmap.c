@@ -0,0 +1,91 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_collections.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    rz_u32 id;
+    rz_i32 hp;
+} Entity;
+
+typedef struct {
+    RZ_Allocator       alc;
+    RZ_SlotMap(Entity) entities;
+    RZ_SparseSet       set;
+} SlotMaps;
+
+RZ_TESTS_SETUP(SlotMaps) {
+    fixture->alc      = rz_test_allocator(rz_std_allocator());
+    fixture->entities = (RZ_TYPEOF(fixture->entities)){.allocator = fixture->alc};
+    fixture->set      = (RZ_SparseSet){.allocator = fixture->alc};
+}
+
+RZ_TESTS_TEARDOWN(SlotMaps) {
+    rz_slotmap_free(&fixture->entities);
+    rz_sparse_set_free(&fixture->set);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+RZ_TESTS(SlotMaps, slotmap_handles_survive_remove) {
+    RZ_SlotHandle handles[100];
+    for (rz_u32 i = 0; i < 100; ++i) {
+        handles[i] = rz_slotmap_insert(&fixture->entities, (Entity){.id = i, .hp = 100});
+        RZ_TESTS_ASSERT_NE(handles[i], RZ_SLOT_HANDLE_NONE);
+    }
+    for (rz_u32 i = 0; i < 100; i += 2) RZ_TESTS_ASSERT_TRUE(rz_slotmap_remove(&fixture->entities, handles[i]));
+    RZ_TESTS_ASSERT_EQ(fixture->entities.len, 50u, "the items is densely packed");
+
+    for (rz_u32 i = 0; i < 100; ++i) {
+        Entity *e = rz_slotmap_get(&fixture->entities, handles[i]);
+        if (i % 2 == 0) {
+            RZ_TESTS_ASSERT_TRUE(e == NULL, "removed handle is stale");
+            RZ_TESTS_ASSERT_FALSE(rz_slotmap_remove(&fixture->entities, handles[i]), "double remove");
+        } else {
+            RZ_TESTS_ASSERT_TRUE(e != NULL && e->id == i, "swap remove must keep the other handles valid");
+        }
+    }
+
+    // the slot of removed item is reused with the next generation
+    RZ_SlotHandle reused = rz_slotmap_insert(&fixture->entities, (Entity){.id = 1000});
+    RZ_TESTS_ASSERT_EQ(rz_slot_handle_index(reused), rz_slot_handle_index(handles[98]));
+    RZ_TESTS_ASSERT_NE(reused, handles[98]);
+    RZ_TESTS_ASSERT_TRUE(rz_slotmap_get(&fixture->entities, handles[98]) == NULL);
+    RZ_TESTS_ASSERT_EQ(rz_slotmap_get(&fixture->entities, reused)->id, 1000u);
+
+    rz_usize count = 0;
+    rz_slotmap_foreach(it, &fixture->entities) {
+        it->hp -= 10;
+        count++;
+    }
+    RZ_TESTS_ASSERT_EQ(count, 51u);
+    RZ_TESTS_ASSERT_EQ(rz_slotmap_handle_at(&fixture->entities, 50), reused);
+
+    rz_slotmap_clear(&fixture->entities);
+    RZ_TESTS_ASSERT_TRUE(rz_slotmap_is_empty(&fixture->entities));
+    RZ_TESTS_ASSERT_FALSE(rz_slotmap_contains(&fixture->entities, reused), "clear invalidate every handle");
+    RZ_TESTS_ASSERT_FALSE(rz_slotmap_contains(&fixture->entities, RZ_SLOT_HANDLE_NONE));
+}
+
+RZ_TESTS(SlotMaps, sparse_set) {
+    RZ_TESTS_ASSERT_FALSE(rz_sparse_set_contains(&fixture->set, 0));
+    RZ_TESTS_ASSERT_TRUE(rz_sparse_set_insert(&fixture->set, 7));
+    RZ_TESTS_ASSERT_TRUE(rz_sparse_set_insert(&fixture->set, 1000));
+    RZ_TESTS_ASSERT_TRUE(rz_sparse_set_insert(&fixture->set, 0));
+    RZ_TESTS_ASSERT_FALSE(rz_sparse_set_insert(&fixture->set, 7), "already in the set");
+    RZ_TESTS_ASSERT_EQ(fixture->set.len, 3u);
+
+    RZ_TESTS_ASSERT_TRUE(rz_sparse_set_remove(&fixture->set, 7));
+    RZ_TESTS_ASSERT_FALSE(rz_sparse_set_remove(&fixture->set, 7));
+    RZ_TESTS_ASSERT_FALSE(rz_sparse_set_contains(&fixture->set, 7));
+    RZ_TESTS_ASSERT_TRUE(rz_sparse_set_contains(&fixture->set, 1000));
+    RZ_TESTS_ASSERT_EQ(fixture->set.dense[rz_sparse_set_index_of(&fixture->set, 0)], 0u);
+
+    rz_sparse_set_clear(&fixture->set);
+    RZ_TESTS_ASSERT_FALSE(rz_sparse_set_contains(&fixture->set, 1000));
+    RZ_TESTS_ASSERT_TRUE(rz_sparse_set_insert(&fixture->set, 1000));
+}
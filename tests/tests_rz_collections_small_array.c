@@ -0,0 +1,78 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_collections.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef RZ_SmallArray(rz_int, 4) IntSmallArray;
+typedef RZ_ArrayView(rz_int) IntArrayView;
+
+RZ_TESTS_SETUP(IntSmallArray) {
+    rz_sarr_init(fixture, rz_test_allocator(rz_std_allocator()));
+    RZ_TESTS_ASSERT_EQ(fixture->len, 0u);
+    RZ_TESTS_ASSERT_EQ(fixture->capacity, 4u);
+    RZ_TESTS_ASSERT_TRUE(rz_sarr_is_inline(fixture));
+}
+
+RZ_TESTS_TEARDOWN(IntSmallArray) {
+    rz_arr_free(fixture);
+    RZ_TESTS_ASSERT_EQ(fixture->data, NULL);
+
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->storage.backing);
+}
+
+RZ_TESTS(IntSmallArray, small_array_inline_then_spill) {
+    for (rz_int i = 0; i < 4; ++i) { rz_arr_append(fixture, i); }
+    RZ_TESTS_ASSERT_TRUE(rz_sarr_is_inline(fixture), "the first N items is stored inline");
+    RZ_TESTS_ASSERT_EQ(rz_arr_find(fixture, 2), 2u);
+    RZ_TESTS_ASSERT_EQ(rz_arr_pop(fixture), 3);
+
+    rz_int items[] = {3, 4, 5, 6, 7};
+    rz_arr_append_many(fixture, items, RZ_ARRAY_LEN(items));
+    RZ_TESTS_ASSERT_FALSE(rz_sarr_is_inline(fixture), "grow past N spill into the backing allocator");
+    RZ_TESTS_ASSERT_EQ(fixture->len, 8u);
+
+    rz_int sum = 0;
+    rz_arr_foreach(it, fixture) { sum += *it; }
+    RZ_TESTS_ASSERT_EQ(sum, 28);
+
+    IntArrayView view = rz_sarr_view(IntArrayView, fixture);
+    RZ_TESTS_ASSERT_EQ(view.len, fixture->len);
+    RZ_TESTS_ASSERT_EQ(rz_arr_last(&view), 7);
+}
+
+RZ_TESTS(IntSmallArray, small_array_reuse_inline_after_free) {
+    for (rz_int i = 0; i < 16; ++i) { rz_arr_append(fixture, i); }
+    RZ_TESTS_ASSERT_FALSE(rz_sarr_is_inline(fixture));
+
+    rz_arr_free(fixture);
+    rz_arr_append(fixture, 69);
+    RZ_TESTS_ASSERT_TRUE(rz_sarr_is_inline(fixture), "inline storage is handed out again after free");
+    RZ_TESTS_ASSERT_EQ(rz_arr_first(fixture), 69);
+}
+
+// N smaller than RZ_ARR_INIT_CAPACITY grow one by one and restart inline after rz_sarr_free
+#define CHECK_SMALL_N(N)                                                                                    \
+    do {                                                                                                    \
+        RZ_SmallArray(rz_int, N) sa;                                                                        \
+        rz_sarr_init(&sa, fixture->storage.backing);                                                        \
+        for (rz_int round = 0; round < 2; ++round) {                                                        \
+            for (rz_int i = 0; i < N; ++i) { rz_arr_append(&sa, i); }                                       \
+            RZ_TESTS_ASSERT_TRUE(rz_sarr_is_inline(&sa), "N=%d round %d", N, round);                        \
+            RZ_TESTS_ASSERT_EQ(sa.capacity, (rz_usize)N);                                                   \
+            for (rz_int i = N; i < 10; ++i) { rz_arr_append(&sa, i); }                                      \
+            RZ_TESTS_ASSERT_FALSE(rz_sarr_is_inline(&sa), "N=%d round %d", N, round);                       \
+            RZ_TESTS_ASSERT_EQ(sa.len, 10u);                                                                \
+            for (rz_int i = 0; i < 10; ++i) { RZ_TESTS_ASSERT_EQ(sa.data[i], i); }                          \
+            rz_sarr_free(&sa);                                                                              \
+        }                                                                                                   \
+    } while (0)
+
+RZ_TESTS(IntSmallArray, small_array_tiny_inline) {
+    CHECK_SMALL_N(1);
+    CHECK_SMALL_N(2);
+}
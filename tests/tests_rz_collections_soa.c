@@ -0,0 +1,73 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_collections.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+RZ_SOA_DEFINE(Particles, (float, x), (rz_u8, flags), (rz_u64, id));
+typedef RZ_ArrayView(rz_u64) U64View;
+
+typedef struct {
+    RZ_Allocator alc;
+    Particles    ps;
+} Soas;
+
+RZ_TESTS_SETUP(Soas) {
+    fixture->alc = rz_test_allocator(rz_std_allocator());
+    fixture->ps  = (Particles){.allocator = fixture->alc};
+}
+
+RZ_TESTS_TEARDOWN(Soas) {
+    Particles_free(&fixture->ps);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+RZ_TESTS(Soas, push_get_remove) {
+    for (rz_u32 i = 0; i < 100; ++i) Particles_push(&fixture->ps, (ParticlesItem){.x = (float)i, .flags = (rz_u8)(i & 1), .id = i * 10});
+    RZ_TESTS_ASSERT_EQ(fixture->ps.len, 100u);
+    RZ_TESTS_ASSERT_GE(fixture->ps.capacity, 100u);
+    RZ_TESTS_ASSERT_EQ((rz_uptr)fixture->ps.id % alignof(max_align_t), 0u, "the column is aligned");
+
+    ParticlesItem item = Particles_get(&fixture->ps, 42);
+    RZ_TESTS_ASSERT_EQ(item.id, 420u);
+    RZ_TESTS_ASSERT_EQ(item.flags, 0u);
+
+    Particles_remove_unordered(&fixture->ps, 42);
+    RZ_TESTS_ASSERT_EQ(fixture->ps.len, 99u);
+    RZ_TESTS_ASSERT_EQ(fixture->ps.id[42], 990u, "the last item is moved into the removed index");
+    RZ_TESTS_ASSERT_EQ(fixture->ps.flags[42], 1u);
+
+    Particles_set(&fixture->ps, 0, (ParticlesItem){.x = -1, .id = 7});
+    RZ_TESTS_ASSERT_EQ(fixture->ps.id[0], 7u);
+
+    U64View ids = rz_soa_column(U64View, &fixture->ps, id);
+    rz_u64  sum = 0;
+    for (rz_usize i = 0; i < ids.len; ++i) sum += ids.data[i];
+    RZ_TESTS_ASSERT_EQ(sum, ((99u * 100u / 2u) * 10u) - 420u + 7u);
+
+    Particles_resize(&fixture->ps, 200);
+    RZ_TESTS_ASSERT_EQ(fixture->ps.id[150], 0u, "resize zero the new items");
+    RZ_TESTS_ASSERT_EQ(fixture->ps.id[98], 980u);
+}
+
+RZ_TESTS(Soas, aos_roundtrip) {
+    ParticlesItem items[37];
+    for (rz_u32 i = 0; i < RZ_ARRAY_LEN(items); ++i) items[i] = (ParticlesItem){.x = (float)i * 0.5f, .flags = (rz_u8)i, .id = i};
+
+    Particles_from_aos(&fixture->ps, items, RZ_ARRAY_LEN(items));
+    RZ_TESTS_ASSERT_EQ(fixture->ps.len, RZ_ARRAY_LEN(items));
+    RZ_TESTS_ASSERT_TRUE(fixture->ps.x[36] == 18.0f);
+
+    ParticlesItem out[37] = {0};
+    Particles_to_aos(&fixture->ps, out);
+    for (rz_u32 i = 0; i < RZ_ARRAY_LEN(items); ++i) {
+        RZ_TESTS_ASSERT_TRUE(out[i].x == items[i].x && out[i].flags == items[i].flags && out[i].id == items[i].id);
+    }
+
+    Particles_clear(&fixture->ps);
+    RZ_TESTS_ASSERT_EQ(fixture->ps.len, 0u);
+}
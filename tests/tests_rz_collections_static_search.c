@@ -0,0 +1,98 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_collections.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    rz_u32      code;
+    const char *name;
+} Symbol;
+
+#define symbol_code(s) ((s).code)
+RZ_STATIC_SEARCH_DEFINE(Symbols, Symbol, rz_u32, symbol_code);
+
+typedef struct {
+    RZ_Allocator       alc;
+    RZ_StaticSearchU32 u32s;
+    RZ_StaticSearchU64 u64s;
+    RZ_StaticSearchF64 f64s;
+    Symbols            symbols;
+} StaticSearches;
+
+RZ_TESTS_SETUP(StaticSearches) {
+    fixture->alc     = rz_test_allocator(rz_std_allocator());
+    fixture->u32s    = (RZ_StaticSearchU32){.allocator = fixture->alc};
+    fixture->u64s    = (RZ_StaticSearchU64){.allocator = fixture->alc};
+    fixture->f64s    = (RZ_StaticSearchF64){.allocator = fixture->alc};
+    fixture->symbols = (Symbols){.allocator = fixture->alc};
+}
+
+RZ_TESTS_TEARDOWN(StaticSearches) {
+    RZ_StaticSearchU32_free(&fixture->u32s);
+    RZ_StaticSearchU64_free(&fixture->u64s);
+    RZ_StaticSearchF64_free(&fixture->f64s);
+    Symbols_free(&fixture->symbols);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    return (*(const rz_u32 *)a > *(const rz_u32 *)b) - (*(const rz_u32 *)a < *(const rz_u32 *)b);
+}
+
+RZ_TESTS(StaticSearches, lower_bound_match_bsearch) {
+    RZ_Array(rz_u32) sorted = {.allocator = fixture->alc};
+    RZ_StaticSearchU32_build(&fixture->u32s, sorted.data, 0);
+    RZ_TESTS_ASSERT_EQ(RZ_StaticSearchU32_lower_bound(&fixture->u32s, 5), 0u, "empty table");
+    RZ_TESTS_ASSERT_EQ(RZ_StaticSearchU32_find(&fixture->u32s, 5), RZ_ARR_FIND_NOTFOUND);
+
+    // every size up to 300 cover the complete and the partial last level of the tree
+    for (rz_u32 len = 1; len <= 300; ++len) {
+        rz_arr_clear(&sorted);
+        for (rz_u32 i = 0; i < len; ++i) rz_arr_append(&sorted, (i * 3U) + 1U);
+        RZ_StaticSearchU32_build(&fixture->u32s, sorted.data, sorted.len);
+        RZ_TESTS_ASSERT_EQ(fixture->u32s.len, (rz_usize)len);
+        for (rz_u32 key = 0; key <= (len * 3U) + 1U; ++key) {
+            rz_usize expected = (key == 0) ? 0 : RZ_MIN((key + 1U) / 3U, len);
+            RZ_TESTS_ASSERT_EQ(RZ_StaticSearchU32_lower_bound(&fixture->u32s, key), expected, "len: %u, key: %u", len, key);
+            bool     exists = (key % 3U) == 1U && key < (len * 3U);
+            rz_usize idx    = RZ_StaticSearchU32_find(&fixture->u32s, key);
+            RZ_TESTS_ASSERT_EQ(idx, exists ? rz_arr_bsearch(&sorted, key, cmp_u32) : RZ_ARR_FIND_NOTFOUND, "len: %u, key: %u", len, key);
+        }
+    }
+    rz_arr_free(&sorted);
+
+    // duplicated keys: lower bound is the first one
+    rz_u64 dups[] = {1, 2, 2, 2, 5, 5, 9};
+    RZ_StaticSearchU64_build(&fixture->u64s, dups, RZ_ARRAY_LEN(dups));
+    RZ_TESTS_ASSERT_EQ(RZ_StaticSearchU64_lower_bound(&fixture->u64s, 2), 1u);
+    RZ_TESTS_ASSERT_EQ(RZ_StaticSearchU64_lower_bound(&fixture->u64s, 5), 4u);
+    RZ_TESTS_ASSERT_EQ(RZ_StaticSearchU64_lower_bound(&fixture->u64s, 6), 6u);
+    RZ_TESTS_ASSERT_EQ(RZ_StaticSearchU64_lower_bound(&fixture->u64s, 10), 7u);
+
+    rz_f64 floats[] = {-2.5, -1.0, 0.0, 0.25, 3.5};
+    RZ_StaticSearchF64_build(&fixture->f64s, floats, RZ_ARRAY_LEN(floats));
+    RZ_TESTS_ASSERT_EQ(RZ_StaticSearchF64_lower_bound(&fixture->f64s, -1.5), 1u);
+    RZ_TESTS_ASSERT_EQ(RZ_StaticSearchF64_find(&fixture->f64s, 0.25), 3u);
+    RZ_TESTS_ASSERT_TRUE(RZ_StaticSearchF64_get(&fixture->f64s, 0.5) == NULL);
+}
+
+RZ_TESTS(StaticSearches, key_extractor) {
+    Symbol sorted[] = {{'!', "bang"}, {'#', "hash"}, {'A', "upper a"}, {'a', "lower a"}, {'z', "lower z"}};
+    Symbols_build(&fixture->symbols, sorted, RZ_ARRAY_LEN(sorted));
+    Symbol *s = Symbols_get(&fixture->symbols, 'a');
+    RZ_TESTS_ASSERT_TRUE(s != NULL);
+    RZ_TESTS_ASSERT_STREQ(s->name, "lower a");
+    RZ_TESTS_ASSERT_EQ(Symbols_find(&fixture->symbols, 'A'), 2u);
+    RZ_TESTS_ASSERT_TRUE(Symbols_get(&fixture->symbols, 'b') == NULL);
+    RZ_TESTS_ASSERT_EQ(Symbols_lower_bound(&fixture->symbols, 'b'), 4u);
+    RZ_TESTS_ASSERT_EQ((uintptr_t)fixture->symbols.keys % 64U, 0u, "the keys is aligned to the cache line");
+
+    Symbols_build(&fixture->symbols, sorted, 2);
+    RZ_TESTS_ASSERT_EQ(fixture->symbols.len, 2u, "rebuild free the old table");
+    RZ_TESTS_ASSERT_EQ(Symbols_find(&fixture->symbols, '#'), 1u);
+}
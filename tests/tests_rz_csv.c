@@ -0,0 +1,197 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_csv.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator       alc;
+    RZ_Str             csv;
+    RZ_Str             values;  // the expected fields, one after the other
+    RZ_Array(rz_usize) fields;  // the end of every expected field in `values`
+    RZ_Array(rz_usize) rows;    // the amount of fields of every expected row
+    RZ_Str             scratch;
+} Csvs;
+
+RZ_TESTS_SETUP(Csvs) {
+    fixture->alc     = rz_test_allocator(rz_std_allocator());
+    fixture->csv     = (RZ_Str){.allocator = fixture->alc};
+    fixture->values  = (RZ_Str){.allocator = fixture->alc};
+    fixture->fields  = (RZ_TYPEOF(fixture->fields)){.allocator = fixture->alc};
+    fixture->rows    = (RZ_TYPEOF(fixture->rows)){.allocator = fixture->alc};
+    fixture->scratch = (RZ_Str){.allocator = fixture->alc};
+}
+
+RZ_TESTS_TEARDOWN(Csvs) {
+    rz_arr_free(&fixture->csv);
+    rz_arr_free(&fixture->values);
+    rz_arr_free(&fixture->fields);
+    rz_arr_free(&fixture->rows);
+    rz_arr_free(&fixture->scratch);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+RZ_TESTS(Csvs, read_rows) {
+    RZ_StrView   input = rz_sv("name,age,note\r\n"
+                               "\"Doe, John\",42,\"said \"\"hi\"\"\"\r\n"
+                               "\"multi\nline\",,\n"
+                               "\n"
+                               "last,1,x");
+    RZ_CsvReader r     = rz_csv_reader(input, .allocator = fixture->alc);
+    RZ_CsvRow    row;
+
+    RZ_TESTS_ASSERT_TRUE(rz_csv_next_row(&r, &row));
+    RZ_TESTS_ASSERT_EQ(row.len, 3u);
+    RZ_TESTS_ASSERT_TRUE(rz_sv_eq_cstr(row.data[2], "note"), "the '\\r' of CRLF is removed");
+
+    RZ_TESTS_ASSERT_TRUE(rz_csv_next_row(&r, &row));
+    RZ_TESTS_ASSERT_EQ(row.len, 3u);
+    RZ_TESTS_ASSERT_TRUE(rz_sv_eq_cstr(row.data[0], "\"Doe, John\""), "the raw field keep the quotes");
+    RZ_StrView name = rz_csv_unquote(&r, row.data[0], &fixture->scratch);
+    RZ_TESTS_ASSERT_TRUE(rz_sv_eq_cstr(name, "Doe, John"));
+    RZ_TESTS_ASSERT_TRUE(name.data == row.data[0].data + 1, "zero copy without escaped quote");
+    RZ_TESTS_ASSERT_TRUE(rz_sv_eq_cstr(rz_csv_unquote(&r, row.data[1], &fixture->scratch), "42"));
+    RZ_TESTS_ASSERT_TRUE(rz_sv_eq_cstr(rz_csv_unquote(&r, row.data[2], &fixture->scratch), "said \"hi\""));
+
+    RZ_TESTS_ASSERT_TRUE(rz_csv_next_row(&r, &row));
+    RZ_TESTS_ASSERT_EQ(row.len, 3u);
+    RZ_TESTS_ASSERT_TRUE(rz_sv_eq_cstr(rz_csv_unquote(&r, row.data[0], &fixture->scratch), "multi\nline"));
+    RZ_TESTS_ASSERT_TRUE(row.data[1].len == 0 && row.data[2].len == 0);
+
+    RZ_TESTS_ASSERT_TRUE(rz_csv_next_row(&r, &row));
+    RZ_TESTS_ASSERT_TRUE(row.len == 1 && row.data[0].len == 0, "the empty line");
+
+    RZ_TESTS_ASSERT_TRUE(rz_csv_next_row(&r, &row));
+    RZ_TESTS_ASSERT_TRUE(row.len == 3 && rz_sv_eq_cstr(row.data[2], "x"), "the last row without newline");
+    RZ_TESTS_ASSERT_FALSE(rz_csv_next_row(&r, &row));
+    RZ_TESTS_ASSERT_FALSE(rz_csv_next_row(&r, &row));
+    rz_csv_reader_free(&r);
+
+    r = rz_csv_reader(rz_sv("a\tb,c\n"), .delimiter = '\t', .allocator = fixture->alc);
+    RZ_TESTS_ASSERT_TRUE(rz_csv_next_row(&r, &row));
+    RZ_TESTS_ASSERT_TRUE(row.len == 2 && rz_sv_eq_cstr(row.data[1], "b,c"));
+    RZ_TESTS_ASSERT_FALSE(rz_csv_next_row(&r, &row));
+    rz_csv_reader_free(&r);
+}
+
+// random records, the quoted fields has the delimiters, the newlines and the escaped quotes across the blocks
+static void random_csv(Csvs *fixture, rz_u32 seed, rz_usize nrows) {
+    static const char plain[]  = "abcxyz0189 ";
+    static const char quoted[] = "ab,\n\r\"\" ";
+    fixture->csv.len           = 0;
+    fixture->values.len        = 0;
+    fixture->fields.len        = 0;
+    fixture->rows.len          = 0;
+    for (rz_usize row = 0; row < nrows; ++row) {
+        seed            = (seed * 1103515245U) + 12345U;
+        rz_usize nfield = 1 + ((seed >> 16U) % 6U);
+        for (rz_usize f = 0; f < nfield; ++f) {
+            seed        = (seed * 1103515245U) + 12345U;
+            bool     q  = ((seed >> 8U) % 3U) == 0;
+            rz_usize fl = (seed >> 16U) % ((seed % 5U == 0) ? 90U : 9U);
+            if (f > 0) rz_arr_append(&fixture->csv, ',');
+            if (q) rz_arr_append(&fixture->csv, '"');
+            for (rz_usize i = 0; i < fl; ++i) {
+                seed    = (seed * 1103515245U) + 12345U;
+                char ch = q ? quoted[(seed >> 16U) % (sizeof(quoted) - 1)] : plain[(seed >> 16U) % (sizeof(plain) - 1)];
+                rz_arr_append(&fixture->values, ch);
+                rz_arr_append(&fixture->csv, ch);
+                if (ch == '"') rz_arr_append(&fixture->csv, '"');
+            }
+            if (q) rz_arr_append(&fixture->csv, '"');
+            rz_arr_append(&fixture->fields, fixture->values.len);
+        }
+        rz_arr_append(&fixture->rows, nfield);
+        const char *newline = (seed % 4U) ? "\n" : "\r\n";
+        // the last row of one empty field without newline is the end of the input
+        if (row + 1 < nrows || nfield == 1 || (seed % 2U)) rz_str_append_cstr(&fixture->csv, newline);
+    }
+}
+
+// read every row of `input`, compare with the expected rows from `*row`/`*field`
+static bool check_rows(Csvs *fixture, RZ_StrView input, rz_usize *row, rz_usize *field) {
+    RZ_CsvReader r = rz_csv_reader(input, .allocator = fixture->alc);
+    RZ_CsvRow    got;
+    bool         ok = true;
+    while (ok && rz_csv_next_row(&r, &got)) {
+        ok = (*row < fixture->rows.len) && (got.len == fixture->rows.data[*row]);
+        for (rz_usize i = 0; ok && i < got.len; ++i, ++*field) {
+            rz_usize   start  = (*field == 0) ? 0 : fixture->fields.data[*field - 1];
+            RZ_StrView expect = rz_sv_sized(fixture->values.data + start, fixture->fields.data[*field] - start);
+            ok                = rz_sv_eq(rz_csv_unquote(&r, got.data[i], &fixture->scratch), expect) || (expect.len == 0 && got.data[i].len == 0);
+        }
+        ++*row;
+    }
+    rz_csv_reader_free(&r);
+    return ok;
+}
+
+RZ_TESTS(Csvs, read_random) {
+    for (rz_u32 round = 0; round < 300; ++round) {
+        random_csv(fixture, round, 1 + (round % 40));
+        rz_usize row = 0, field = 0;
+        RZ_TESTS_ASSERT_TRUE(check_rows(fixture, rz_sv_from_str(&fixture->csv), &row, &field), "round %u row %zu", round, row);
+        RZ_TESTS_ASSERT_EQ(row, fixture->rows.len, "round %u", round);
+    }
+}
+
+static bool count_rows(const RZ_CsvReader *r, RZ_CsvRow row, rz_usize chunk, void *user) {
+    RZ_UNUSED(r);
+    RZ_UNUSED(chunk);
+    atomic_size_t *counts = user;
+    atomic_fetch_add(&counts[0], 1);
+    atomic_fetch_add(&counts[1], row.len);
+    return true;
+}
+
+static bool stop_at_first_row(const RZ_CsvReader *r, RZ_CsvRow row, rz_usize chunk, void *user) {
+    RZ_UNUSED_ALL(r, row, chunk, user);
+    return false;
+}
+
+RZ_TESTS(Csvs, chunks_parallel) {
+    for (rz_u32 round = 0; round < 100; ++round) {
+        random_csv(fixture, round * 7919U, 20 + (round % 60));
+        RZ_StrView input = rz_sv_from_str(&fixture->csv);
+        RZ_StrView chunks[8];
+        rz_usize   count = 1 + (round % RZ_ARRAY_LEN(chunks));
+        rz_usize   len   = rz_csv_chunks(input, chunks, count);
+        RZ_TESTS_ASSERT_TRUE(len >= 1 && len <= count, "round %u", round);
+
+        // the chunks cover the input in order and the rows of the chunks is the rows of the input
+        rz_usize row = 0, field = 0, offset = 0;
+        for (rz_usize i = 0; i < len; ++i) {
+            RZ_TESTS_ASSERT_TRUE(chunks[i].data == input.data + offset, "round %u chunk %zu", round, i);
+            offset += chunks[i].len;
+            RZ_TESTS_ASSERT_TRUE(check_rows(fixture, chunks[i], &row, &field), "round %u chunk %zu row %zu", round, i, row);
+        }
+        RZ_TESTS_ASSERT_EQ(offset, input.len);
+        RZ_TESTS_ASSERT_EQ(row, fixture->rows.len, "round %u", round);
+
+        // the readers allocate from every thread, the test allocator is not thread safe
+        atomic_size_t counts[2] = {0};
+        RZ_TESTS_ASSERT_TRUE(rz_csv_read_parallel(input, count, count_rows, counts));
+        RZ_TESTS_ASSERT_EQ(atomic_load(&counts[0]), fixture->rows.len, "round %u", round);
+        RZ_TESTS_ASSERT_EQ(atomic_load(&counts[1]), fixture->fields.len, "round %u", round);
+    }
+    RZ_TESTS_ASSERT_FALSE(rz_csv_read_parallel(rz_sv_from_str(&fixture->csv), 4, stop_at_first_row, NULL));
+}
+
+RZ_TESTS(Csvs, map_file) {
+    random_csv(fixture, 99, 500);
+    RZ_Path path = rz_path("tests_rz_csv.csv");
+    RZ_TESTS_ASSERT_TRUE(rz_fs_write(path, (const rz_u8 *)fixture->csv.data, fixture->csv.len));
+
+    RZ_CsvMap m = {0};
+    RZ_TESTS_ASSERT_TRUE(rz_csv_map(&m, path));
+    RZ_TESTS_ASSERT_EQ(m.data.len, fixture->csv.len);
+    rz_usize row = 0, field = 0;
+    RZ_TESTS_ASSERT_TRUE(check_rows(fixture, m.data, &row, &field));
+    RZ_TESTS_ASSERT_EQ(row, fixture->rows.len);
+    rz_csv_unmap(&m);
+    rz_fs_remove(path);
+}
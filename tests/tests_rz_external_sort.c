@@ -0,0 +1,150 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_external_sort.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator  alc;
+    RZ_BytesArray input;
+    RZ_BytesArray output;
+} ExternalSorts;
+
+RZ_TESTS_SETUP(ExternalSorts) {
+    fixture->alc    = rz_test_allocator(rz_std_allocator());
+    fixture->input  = (RZ_BytesArray){.allocator = fixture->alc};
+    fixture->output = (RZ_BytesArray){.allocator = fixture->alc};
+}
+
+RZ_TESTS_TEARDOWN(ExternalSorts) {
+    rz_arr_free(&fixture->input);
+    rz_arr_free(&fixture->output);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+static const RZ_Path input_path  = rz_path_static("tests_rz_external_sort.in");
+static const RZ_Path output_path = rz_path_static("tests_rz_external_sort.out");
+
+static bool sort_file(ExternalSorts *fixture, RZ_ExternalSortOpt opt) {
+    RZ_ASSERT(rz_fs_write(input_path, fixture->input.data, fixture->input.len));
+    RZ_Fd in  = rz_fd_open_read(input_path);
+    RZ_Fd out = rz_fd_open_write(output_path);
+    opt.allocator = fixture->alc;
+    bool result   = rz_external_sort_opt(in, out, opt);
+    rz_fd_close(in);
+    rz_fd_close(out);
+    fixture->output.len = 0;
+    RZ_ASSERT(rz_fs_read(output_path, &fixture->output));
+    rz_fs_remove(input_path);
+    rz_fs_remove(output_path);
+    return result;
+}
+
+static int cmp_line(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+static void on_progress(const RZ_ExternalSortProgress *progress, void *user) {
+    RZ_ExternalSortProgress *last = user;
+    RZ_ASSERT(progress->stage >= last->stage, "the stage only move forward");
+    *last = *progress;
+}
+
+RZ_TESTS(ExternalSorts, lines_multi_pass_merge) {
+    // 2000 lines of 1..16 chars, with duplicates
+    static char lines[2000][20];
+    const char *sorted[2000];
+    rz_u32      seed = 3;
+    for (rz_usize i = 0; i < RZ_ARRAY_LEN(lines); ++i) {
+        seed         = (seed * 1103515245U) + 12345U;
+        rz_usize size = 1 + ((seed >> 16U) % 16U);
+        for (rz_usize j = 0; j < size; ++j) {
+            seed        = (seed * 1103515245U) + 12345U;
+            lines[i][j] = (char)('a' + ((seed >> 16U) % 4U));
+        }
+        lines[i][size] = '\0';
+        sorted[i]      = lines[i];
+        rz_arr_append_many(&fixture->input, (rz_u8 *)lines[i], size);
+        rz_arr_append(&fixture->input, '\n');
+    }
+    qsort(sorted, RZ_ARRAY_LEN(sorted), sizeof(*sorted), cmp_line);
+
+    for (int sync_io = 0; sync_io < 2; ++sync_io) {
+        // ~20 runs of 1KB merged 3 at a time, the io buffer is smaller than a line
+        RZ_ExternalSortProgress last = {0};
+        RZ_TESTS_ASSERT_TRUE(sort_file(fixture, (RZ_ExternalSortOpt){.memory_limit = 1024, .fan_in = 3, .io_buffer_size = 7, .sync_io = sync_io,
+                                                                     .temp_dir = rz_path("."), .progress = on_progress, .progress_user = &last}),
+                             "%s", rz_strerror());
+        RZ_TESTS_ASSERT_EQ(fixture->output.len, fixture->input.len);
+        const char *line = (const char *)fixture->output.data;
+        for (rz_usize i = 0; i < RZ_ARRAY_LEN(sorted); ++i) {
+            rz_usize len = strlen(sorted[i]);
+            RZ_TESTS_ASSERT_TRUE(memcmp(line, sorted[i], len) == 0 && line[len] == '\n', "line %zu: %s", i, sorted[i]);
+            line += len + 1;
+        }
+        RZ_TESTS_ASSERT_EQ(last.stage, RZ_EXTERNAL_SORT_STAGE_DONE);
+        RZ_TESTS_ASSERT_EQ(last.records, 2000u);
+        RZ_TESTS_ASSERT_GT(last.runs, 3u, "more runs than the fan in");
+        RZ_TESTS_ASSERT_EQ(last.runs_pending, 0u);
+        RZ_TESTS_ASSERT_GT(last.bytes_written, fixture->input.len, "the runs is written and merged");
+        RZ_TESTS_ASSERT_GT(last.elapsed_secs, 0.0);
+        RZ_TESTS_ASSERT_GT(last.bytes_per_sec, 0.0);
+    }
+
+    // fit in the memory, the last line without '\n'
+    fixture->input.len = 0;
+    rz_arr_append_many(&fixture->input, (rz_u8 *)"pear\napple\n\nfig", 15);
+    RZ_TESTS_ASSERT_TRUE(sort_file(fixture, (RZ_ExternalSortOpt){0}));
+    RZ_TESTS_ASSERT_EQ(fixture->output.len, 16u);
+    RZ_TESTS_ASSERT_TRUE(memcmp(fixture->output.data, "\napple\nfig\npear\n", 16) == 0);
+
+    // the '\0' bytes and the records longer than the 8 bytes key prefix
+    static const char zeros_in[]  = "ab\0\0\0\0\0\0\0y\nab\0\nab\0\0\0\0\0\0\0x\nab\na\n";
+    static const char zeros_out[] = "a\nab\nab\0\nab\0\0\0\0\0\0\0x\nab\0\0\0\0\0\0\0y\n";
+    fixture->input.len = 0;
+    rz_arr_append_many(&fixture->input, (const rz_u8 *)zeros_in, sizeof(zeros_in) - 1);
+    RZ_TESTS_ASSERT_TRUE(sort_file(fixture, (RZ_ExternalSortOpt){0}));
+    RZ_TESTS_ASSERT_EQ(fixture->output.len, sizeof(zeros_out) - 1);
+    RZ_TESTS_ASSERT_TRUE(memcmp(fixture->output.data, zeros_out, sizeof(zeros_out) - 1) == 0);
+
+    fixture->input.len = 0;
+    RZ_TESTS_ASSERT_TRUE(sort_file(fixture, (RZ_ExternalSortOpt){0}));
+    RZ_TESTS_ASSERT_EQ(fixture->output.len, 0u, "empty input");
+}
+
+typedef struct {
+    rz_u32 key;
+    rz_u32 order;
+} Item;
+
+static int cmp_item(const void *a, rz_usize a_len, const void *b, rz_usize b_len, void *user) {
+    RZ_UNUSED_ALL(a_len, b_len, user);
+    rz_u32 ka = ((const Item *)a)->key, kb = ((const Item *)b)->key;
+    return (ka > kb) - (ka < kb);
+}
+
+RZ_TESTS(ExternalSorts, fixed_records_stable) {
+    rz_u32 seed = 11;
+    for (rz_u32 i = 0; i < 5000; ++i) {
+        seed      = (seed * 1103515245U) + 12345U;
+        Item item = {.key = (seed >> 16U) % 100U, .order = i};
+        rz_arr_append_many(&fixture->input, (rz_u8 *)&item, sizeof(item));
+    }
+    RZ_TESTS_ASSERT_TRUE(sort_file(fixture, (RZ_ExternalSortOpt){.record_size = sizeof(Item), .cmp = cmp_item, .memory_limit = 4096, .fan_in = 4,
+                                                                 .io_buffer_size = 100, .temp_dir = rz_path(".")}),
+                         "%s", rz_strerror());
+    RZ_TESTS_ASSERT_EQ(fixture->output.len, fixture->input.len);
+    const Item *items = (const Item *)fixture->output.data;
+    for (rz_usize i = 1; i < 5000; ++i) {
+        RZ_TESTS_ASSERT_LE(items[i - 1].key, items[i].key);
+        RZ_TESTS_ASSERT_TRUE(items[i - 1].key < items[i].key || items[i - 1].order < items[i].order, "stable");
+    }
+
+    fixture->input.len -= 3;
+    RZ_TESTS_ASSERT_FALSE(sort_file(fixture, (RZ_ExternalSortOpt){.record_size = sizeof(Item), .memory_limit = 4096, .temp_dir = rz_path(".")}),
+                          "truncated record");
+}
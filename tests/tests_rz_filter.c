@@ -0,0 +1,75 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_filter.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator    alc;
+    RZ_BloomFilter  bloom;
+    RZ_CuckooFilter cuckoo;
+    RZ_BytesArray   bytes;
+} Filters;
+
+#define TESTS_FILTER_ITEMS 10000u
+
+RZ_TESTS_SETUP(Filters) {
+    fixture->alc   = rz_test_allocator(rz_std_allocator());
+    fixture->bytes = (RZ_BytesArray){.allocator = fixture->alc};
+    rz_bloom_init(&fixture->bloom, .expected_count = TESTS_FILTER_ITEMS, .fpp = 0.01, .allocator = fixture->alc);
+    rz_cuckoo_init(&fixture->cuckoo, .expected_count = TESTS_FILTER_ITEMS, .allocator = fixture->alc);
+}
+
+RZ_TESTS_TEARDOWN(Filters) {
+    rz_bloom_free(&fixture->bloom);
+    rz_cuckoo_free(&fixture->cuckoo);
+    rz_arr_free(&fixture->bytes);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+RZ_TESTS(Filters, bloom_no_false_negative_and_serialize) {
+    for (rz_u64 i = 0; i < TESTS_FILTER_ITEMS; ++i) { rz_bloom_add_item(&fixture->bloom, i); }
+    for (rz_u64 i = 0; i < TESTS_FILTER_ITEMS; ++i) { RZ_TESTS_ASSERT_TRUE(rz_bloom_contains_item(&fixture->bloom, i)); }
+
+    rz_usize false_positive = 0;
+    for (rz_u64 i = TESTS_FILTER_ITEMS; i < TESTS_FILTER_ITEMS * 11; ++i) { false_positive += rz_bloom_contains_item(&fixture->bloom, i); }
+    RZ_TESTS_ASSERT_TRUE(false_positive < (TESTS_FILTER_ITEMS * 10) / 50, "false positive rate should be around 1%%");
+
+    rz_bloom_serialize(&fixture->bloom, &fixture->bytes);
+    RZ_BloomFilter loaded = {0};
+    RZ_TESTS_ASSERT_FALSE(rz_bloom_deserialize(&loaded, fixture->bytes.data, fixture->bytes.len - 1), "truncated bytes");
+    RZ_TESTS_ASSERT_TRUE(rz_bloom_deserialize(&loaded, fixture->bytes.data, fixture->bytes.len, .allocator = fixture->alc));
+    RZ_TESTS_ASSERT_EQ(loaded.nblocks, fixture->bloom.nblocks);
+    for (rz_u64 i = 0; i < TESTS_FILTER_ITEMS; ++i) { RZ_TESTS_ASSERT_TRUE(rz_bloom_contains_item(&loaded, i)); }
+    rz_bloom_free(&loaded);
+}
+
+RZ_TESTS(Filters, cuckoo_add_remove_and_serialize) {
+    for (rz_u64 i = 0; i < TESTS_FILTER_ITEMS; ++i) { RZ_TESTS_ASSERT_TRUE(rz_cuckoo_add_item(&fixture->cuckoo, i)); }
+    RZ_TESTS_ASSERT_EQ(fixture->cuckoo.len, TESTS_FILTER_ITEMS);
+
+    for (rz_u64 i = 0; i < TESTS_FILTER_ITEMS; i += 2) { RZ_TESTS_ASSERT_TRUE(rz_cuckoo_remove_item(&fixture->cuckoo, i)); }
+    for (rz_u64 i = 1; i < TESTS_FILTER_ITEMS; i += 2) { RZ_TESTS_ASSERT_TRUE(rz_cuckoo_contains_item(&fixture->cuckoo, i), "remove must not drop other items"); }
+    RZ_TESTS_ASSERT_EQ(fixture->cuckoo.len, TESTS_FILTER_ITEMS / 2);
+
+    rz_cuckoo_serialize(&fixture->cuckoo, &fixture->bytes);
+    RZ_CuckooFilter loaded = {0};
+    RZ_TESTS_ASSERT_FALSE(rz_cuckoo_deserialize(&loaded, fixture->bytes.data + 1, fixture->bytes.len - 1), "invalid magic");
+    RZ_TESTS_ASSERT_TRUE(rz_cuckoo_deserialize(&loaded, fixture->bytes.data, fixture->bytes.len, .allocator = fixture->alc));
+    RZ_TESTS_ASSERT_EQ(loaded.len, TESTS_FILTER_ITEMS / 2);
+    for (rz_u64 i = 1; i < TESTS_FILTER_ITEMS; i += 2) { RZ_TESTS_ASSERT_TRUE(rz_cuckoo_contains_item(&loaded, i)); }
+    rz_cuckoo_free(&loaded);
+}
+
+RZ_TESTS(Filters, cuckoo_full) {
+    rz_usize capacity = fixture->cuckoo.nbuckets * RZ_CUCKOO_BUCKET_SLOTS;
+    rz_u64   added    = 0;
+    while (added < capacity && rz_cuckoo_add_item(&fixture->cuckoo, added)) { added++; }
+    RZ_TESTS_ASSERT_TRUE(added < capacity, "the filter report full before every slot is used");
+    RZ_TESTS_ASSERT_TRUE(added > (capacity * 9) / 10, "load factor should be above 90%%");
+    for (rz_u64 i = 0; i < added; ++i) { RZ_TESTS_ASSERT_TRUE(rz_cuckoo_contains_item(&fixture->cuckoo, i)); }
+}
@@ -0,0 +1,158 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_filter.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator      alc;
+    RZ_HyperLogLog    hll;
+    RZ_CountMinSketch cms;
+    RZ_TopK           topk;
+    RZ_BytesArray     bytes;
+} Sketches;
+
+RZ_TESTS_SETUP(Sketches) {
+    fixture->alc   = rz_test_allocator(rz_std_allocator());
+    fixture->bytes = (RZ_BytesArray){.allocator = fixture->alc};
+    rz_hll_init(&fixture->hll, .precision = 12, .allocator = fixture->alc);
+    rz_cms_init(&fixture->cms, .epsilon = 0.001, .delta = 0.01, .allocator = fixture->alc);
+    rz_topk_init(&fixture->topk, .capacity = 100, .allocator = fixture->alc);
+}
+
+RZ_TESTS_TEARDOWN(Sketches) {
+    rz_hll_free(&fixture->hll);
+    rz_cms_free(&fixture->cms);
+    rz_topk_free(&fixture->topk);
+    rz_arr_free(&fixture->bytes);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+static bool near(rz_f64 estimate, rz_f64 expected, rz_f64 error) {
+    return (estimate >= expected * (1.0 - error)) && (estimate <= expected * (1.0 + error));
+}
+
+RZ_TESTS(Sketches, hll_sparse_dense_merge_serialize) {
+    // standard error of 2^12 registers is ~1.6%
+    for (rz_u64 i = 0; i < 100; ++i) { rz_hll_add_item(&fixture->hll, i); }
+    for (rz_u64 i = 0; i < 100; ++i) { rz_hll_add_item(&fixture->hll, i); }
+    RZ_TESTS_ASSERT_TRUE(rz_hll_is_sparse(&fixture->hll));
+    RZ_TESTS_ASSERT_TRUE(near(rz_hll_estimate(&fixture->hll), 100, 0.05), "%f", rz_hll_estimate(&fixture->hll));
+
+    rz_hll_serialize(&fixture->hll, &fixture->bytes);
+    RZ_HyperLogLog loaded = {0};
+    RZ_TESTS_ASSERT_TRUE(rz_hll_deserialize(&loaded, fixture->bytes.data, fixture->bytes.len, .allocator = fixture->alc));
+    RZ_TESTS_ASSERT_TRUE(rz_hll_is_sparse(&loaded));
+    RZ_TESTS_ASSERT_TRUE(rz_hll_estimate(&loaded) == rz_hll_estimate(&fixture->hll));
+    rz_hll_free(&loaded);
+
+    for (rz_u64 i = 100; i < 50000; ++i) { rz_hll_add_item(&fixture->hll, i); }
+    RZ_TESTS_ASSERT_FALSE(rz_hll_is_sparse(&fixture->hll));
+    RZ_TESTS_ASSERT_TRUE(near(rz_hll_estimate(&fixture->hll), 50000, 0.05), "%f", rz_hll_estimate(&fixture->hll));
+
+    // the other process count [25000, 75000), the union is [0, 75000)
+    RZ_HyperLogLog other = {0};
+    rz_hll_init(&other, .precision = 12, .allocator = fixture->alc);
+    for (rz_u64 i = 25000; i < 75000; ++i) { rz_hll_add_item(&other, i); }
+    fixture->bytes.len = 0;
+    rz_hll_serialize(&other, &fixture->bytes);
+    rz_hll_free(&other);
+    RZ_TESTS_ASSERT_FALSE(rz_hll_deserialize(&other, fixture->bytes.data, fixture->bytes.len - 1), "truncated bytes");
+    RZ_TESTS_ASSERT_TRUE(rz_hll_deserialize(&other, fixture->bytes.data, fixture->bytes.len, .allocator = fixture->alc));
+    RZ_TESTS_ASSERT_TRUE(rz_hll_merge(&fixture->hll, &other));
+    RZ_TESTS_ASSERT_TRUE(near(rz_hll_estimate(&fixture->hll), 75000, 0.05), "%f", rz_hll_estimate(&fixture->hll));
+    rz_hll_free(&other);
+
+    rz_hll_init(&other, .precision = 10, .allocator = fixture->alc);
+    RZ_TESTS_ASSERT_FALSE(rz_hll_merge(&fixture->hll, &other), "different precision");
+    rz_hll_free(&other);
+}
+
+RZ_TESTS(Sketches, cms_conservative_update) {
+    // item i occur 2000 / (i + 1) times
+    rz_u64 total = 0;
+    for (rz_u64 round = 0; round < 2000; ++round) {
+        for (rz_u64 i = 0; i < 5000 && (round * (i + 1)) < 2000; ++i) {
+            rz_cms_add_item(&fixture->cms, i, 1);
+            total++;
+        }
+    }
+    RZ_TESTS_ASSERT_EQ(fixture->cms.total, total);
+    for (rz_u64 i = 0; i < 5000; ++i) {
+        rz_u64 expected = (2000 + i) / (i + 1), estimate = rz_cms_estimate_item(&fixture->cms, i);
+        RZ_TESTS_ASSERT_GE(estimate, expected, "never under estimated");
+        RZ_TESTS_ASSERT_LE(estimate, expected + (rz_u64)(0.001 * (rz_f64)total) + 1, "item %llu", (unsigned long long)i);
+    }
+
+    rz_cms_serialize(&fixture->cms, &fixture->bytes);
+    RZ_CountMinSketch other = {0};
+    RZ_TESTS_ASSERT_FALSE(rz_cms_deserialize(&other, fixture->bytes.data + 1, fixture->bytes.len - 1), "invalid magic");
+    RZ_TESTS_ASSERT_TRUE(rz_cms_deserialize(&other, fixture->bytes.data, fixture->bytes.len, .allocator = fixture->alc));
+    RZ_TESTS_ASSERT_TRUE(rz_cms_merge(&fixture->cms, &other));
+    RZ_TESTS_ASSERT_EQ(fixture->cms.total, total * 2);
+    for (rz_u64 i = 0; i < 100; ++i) {
+        RZ_TESTS_ASSERT_GE(rz_cms_estimate_item(&fixture->cms, i), 2 * ((2000 + i) / (i + 1)));
+    }
+    rz_cms_free(&other);
+}
+
+static void topk_stream(RZ_TopK *tk, rz_u64 first_noise) {
+    // "key0" ... "key9" occur 550, 500, ... 100 times, between 4000 distinct noise keys,
+    // more than total / capacity (~73) so every key is tracked
+    char key[32];
+    for (rz_u64 round = 0; round < 550; ++round) {
+        for (rz_u64 i = 0; i < 10 && round < (11 - i) * 50; ++i) {
+            int len = snprintf(key, sizeof(key), "key%llu", (unsigned long long)i);
+            rz_topk_add(tk, key, (rz_usize)len, 1);
+        }
+        for (rz_u64 i = 0; i < 8; ++i) {
+            int len = snprintf(key, sizeof(key), "noise%llu", (unsigned long long)(first_noise + (round * 8) + i));
+            if (round < 500) rz_topk_add(tk, key, (rz_usize)len, 1);
+        }
+    }
+}
+
+static bool topk_is_heavy_hitters(RZ_TopK *tk, rz_u64 scale) {
+    RZ_TopKItem items[10];
+    char        key[32];
+    if (rz_topk_items(tk, items, RZ_ARRAY_LEN(items)) != RZ_ARRAY_LEN(items)) return false;
+    for (rz_u64 i = 0; i < 10; ++i) {
+        int    len      = snprintf(key, sizeof(key), "key%llu", (unsigned long long)i);
+        rz_u64 expected = (11 - i) * 50 * scale;
+        if (items[i].key_len != (rz_usize)len || memcmp(items[i].key, key, (rz_usize)len) != 0) return false;
+        if (items[i].count < expected || items[i].count - items[i].error > expected) return false;
+    }
+    return true;
+}
+
+RZ_TESTS(Sketches, topk_heavy_hitters) {
+    topk_stream(&fixture->topk, 0);
+    RZ_TESTS_ASSERT_EQ(fixture->topk.len, 100u);
+    RZ_TESTS_ASSERT_TRUE(topk_is_heavy_hitters(&fixture->topk, 1));
+    RZ_TESTS_ASSERT_GE(rz_topk_count(&fixture->topk, "key0", 4), 550u);
+    RZ_TESTS_ASSERT_EQ(rz_topk_count(&fixture->topk, "missing", 7), 0u);
+
+    RZ_TopKItem all[128];
+    RZ_TESTS_ASSERT_EQ(rz_topk_items(&fixture->topk, all, RZ_ARRAY_LEN(all)), 100u);
+    for (rz_usize i = 1; i < 100; ++i) { RZ_TESTS_ASSERT_GE(all[i - 1].count, all[i].count); }
+    RZ_TESTS_ASSERT_EQ(rz_topk_items(&fixture->topk, NULL, 0), 0u);
+
+    // the other process see the same heavy keys with different noise
+    RZ_TopK other = {0};
+    rz_topk_init(&other, .capacity = 100, .allocator = fixture->alc);
+    topk_stream(&other, 100000);
+    rz_topk_serialize(&other, &fixture->bytes);
+    rz_topk_free(&other);
+    RZ_TESTS_ASSERT_FALSE(rz_topk_deserialize(&other, fixture->bytes.data, fixture->bytes.len - 1), "truncated bytes");
+    RZ_TESTS_ASSERT_TRUE(rz_topk_deserialize(&other, fixture->bytes.data, fixture->bytes.len, .allocator = fixture->alc));
+    RZ_TESTS_ASSERT_TRUE(topk_is_heavy_hitters(&other, 1));
+
+    rz_topk_merge(&fixture->topk, &other);
+    RZ_TESTS_ASSERT_EQ(fixture->topk.len, 100u);
+    RZ_TESTS_ASSERT_TRUE(topk_is_heavy_hitters(&fixture->topk, 2));
+    rz_topk_free(&other);
+}
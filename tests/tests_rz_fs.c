@@ -0,0 +1,48 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_fs.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator alc;
+    RZ_PathBuf   buf;
+} Paths;
+
+RZ_TESTS_SETUP(Paths) {
+    fixture->alc = rz_test_allocator(rz_std_allocator());
+    fixture->buf = (RZ_PathBuf){.allocator = fixture->alc};
+}
+
+RZ_TESTS_TEARDOWN(Paths) {
+    rz_arr_free(&fixture->buf);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+RZ_TESTS(Paths, path_filename) {
+    RZ_Path filename = {0};
+    RZ_TESTS_ASSERT_TRUE(rz_path_filename_cstr("a/./", &filename) && rz_sv_eq_cstr(filename, "a"), "stop at the first real component");
+    RZ_TESTS_ASSERT_TRUE(rz_path_filename_cstr("dir/a.b.c", &filename) && rz_sv_eq_cstr(filename, "a.b.c"));
+    RZ_TESTS_ASSERT_TRUE(rz_path_filename_cstr(".bashrc", &filename) && rz_sv_eq_cstr(filename, ".bashrc"));
+    RZ_TESTS_ASSERT_FALSE(rz_path_filename_cstr("/", &filename));
+    RZ_TESTS_ASSERT_FALSE(rz_path_filename_cstr("a/..", &filename));
+}
+
+RZ_TESTS(Paths, path_filestem) {
+    RZ_Path filestem = {0};
+    RZ_TESTS_ASSERT_TRUE(rz_path_filestem_cstr("a.b.c", &filestem) && rz_sv_eq_cstr(filestem, "a.b"), "the extension start at the last dot");
+    RZ_TESTS_ASSERT_TRUE(rz_path_filestem_cstr("x.y/a.b.c", &filestem) && rz_sv_eq_cstr(filestem, "a.b"), "the dot is searched in the filename only");
+    RZ_TESTS_ASSERT_TRUE(rz_path_filestem_cstr(".bashrc", &filestem) && rz_sv_eq_cstr(filestem, ".bashrc"), "leading dot is not an extension");
+    RZ_TESTS_ASSERT_TRUE(rz_path_filestem_cstr("a/./", &filestem) && rz_sv_eq_cstr(filestem, "a"));
+    RZ_TESTS_ASSERT_FALSE(rz_path_filestem_cstr("/", &filestem));
+}
+
+RZ_TESTS(Paths, pathbuf_set_extension) {
+    fixture->buf = rz_pathbuf_from_path_alloc(rz_path_static("dir/a.b.c"), fixture->alc);
+    RZ_TESTS_ASSERT_TRUE(rz_pathbuf_set_extension(&fixture->buf, rz_path_static("txt")), "extension without separator is accepted");
+    RZ_TESTS_ASSERT_TRUE(rz_sv_eq_cstr(rz_path_from_pathbuf(&fixture->buf), "dir/a.b.txt"));
+}
@@ -0,0 +1,106 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_hamt.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator    alc;
+    RZ_Hamt(rz_u64) map;
+} Hamts;
+
+RZ_TESTS_SETUP(Hamts) {
+    fixture->alc = rz_test_allocator(rz_std_allocator());
+    fixture->map = (RZ_TYPEOF(fixture->map)){.allocator = fixture->alc};
+}
+
+RZ_TESTS_TEARDOWN(Hamts) {
+    rz_hamt_free(&fixture->map);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+static bool sum_values(const rz_u8 *key, rz_usize key_len, const void *value, void *user) {
+    RZ_UNUSED_ALL(key, key_len);
+    *(rz_u64 *)user += *(const rz_u64 *)value;
+    return true;
+}
+
+RZ_TESTS(Hamts, persistent_snapshots) {
+    // snapshot[i] is the map with the keys 0 .. (i + 1) * 500 mapped to key * 3
+    RZ_Hamt(rz_u64) snapshots[4] = {0};
+    for (rz_u64 i = 0; i < 2000; ++i) {
+        rz_hamt_insert_u64(&fixture->map, i, i * 3);
+        if ((i + 1) % 500 == 0) rz_hamt_clone(&snapshots[i / 500], &fixture->map);
+    }
+    // replace and remove on the map, the snapshots keep the old values
+    for (rz_u64 i = 0; i < 2000; ++i) {
+        if (i % 2 == 0) {
+            RZ_TESTS_ASSERT_TRUE(rz_hamt_remove_u64(&fixture->map, i));
+        } else {
+            rz_hamt_insert_u64(&fixture->map, i, i);
+        }
+    }
+    RZ_TESTS_ASSERT_FALSE(rz_hamt_remove_u64(&fixture->map, 0), "already removed");
+    RZ_TESTS_ASSERT_FALSE(rz_hamt_remove_u64(&fixture->map, 5000), "not found");
+    RZ_TESTS_ASSERT_EQ(fixture->map.len, 1000u);
+
+    for (rz_u64 i = 0; i < 2000; ++i) {
+        const rz_u64 *v = rz_hamt_get_u64(&fixture->map, i);
+        RZ_TESTS_ASSERT_TRUE((i % 2 == 0) ? v == NULL : (v != NULL && *v == i), "key %llu", (unsigned long long)i);
+    }
+    for (rz_usize s = 0; s < RZ_ARRAY_LEN(snapshots); ++s) {
+        rz_u64 end = (s + 1) * 500, sum = 0;
+        RZ_TESTS_ASSERT_EQ(snapshots[s].len, end);
+        for (rz_u64 i = 0; i < 2000; ++i) {
+            const rz_u64 *v = rz_hamt_get_u64(&snapshots[s], i);
+            RZ_TESTS_ASSERT_TRUE((i < end) ? (v != NULL && *v == i * 3) : v == NULL, "snapshot %zu key %llu", s, (unsigned long long)i);
+        }
+        RZ_TESTS_ASSERT_TRUE(rz_hamt_foreach(&snapshots[s], sum_values, &sum));
+        RZ_TESTS_ASSERT_EQ(sum, 3 * (end * (end - 1) / 2));
+    }
+    // the snapshots is freed in the middle of the map updates
+    for (rz_usize s = 0; s < RZ_ARRAY_LEN(snapshots); ++s) rz_hamt_free(&snapshots[s]);
+    for (rz_u64 i = 1; i < 2000; i += 2) RZ_TESTS_ASSERT_TRUE(rz_hamt_remove_u64(&fixture->map, i));
+    RZ_TESTS_ASSERT_EQ(fixture->map.len, 0u);
+    RZ_TESTS_ASSERT_TRUE(fixture->map.root == NULL);
+}
+
+RZ_TESTS(Hamts, transient_batch) {
+    char key[32];
+    rz_hamt_insert_cstr(&fixture->map, "", 42);
+    rz_hamt_transient_begin(&fixture->map);
+    for (rz_u64 i = 0; i < 3000; ++i) {
+        snprintf(key, sizeof(key), "route/%llu", (unsigned long long)i);
+        rz_hamt_insert_cstr(&fixture->map, key, i);
+    }
+    // the snapshot in the middle of the transient is not modified by the rest of the batch
+    RZ_Hamt(rz_u64) snapshot = {0};
+    rz_hamt_clone(&snapshot, &fixture->map);
+    for (rz_u64 i = 0; i < 3000; ++i) {
+        snprintf(key, sizeof(key), "route/%llu", (unsigned long long)i);
+        if (i % 3 == 0) {
+            RZ_TESTS_ASSERT_TRUE(rz_hamt_remove_cstr(&fixture->map, key));
+        } else {
+            rz_hamt_insert_cstr(&fixture->map, key, i + 1);
+        }
+    }
+    rz_hamt_transient_end(&fixture->map);
+    RZ_TESTS_ASSERT_EQ(fixture->map.edit, 0u);
+
+    RZ_TESTS_ASSERT_EQ(snapshot.len, 3001u);
+    RZ_TESTS_ASSERT_EQ(fixture->map.len, 2001u);
+    for (rz_u64 i = 0; i < 3000; ++i) {
+        snprintf(key, sizeof(key), "route/%llu", (unsigned long long)i);
+        const rz_u64 *old = rz_hamt_get_cstr(&snapshot, key);
+        const rz_u64 *cur = rz_hamt_get_cstr(&fixture->map, key);
+        RZ_TESTS_ASSERT_TRUE(old != NULL && *old == i, "%s", key);
+        RZ_TESTS_ASSERT_TRUE((i % 3 == 0) ? cur == NULL : (cur != NULL && *cur == i + 1), "%s", key);
+    }
+    const rz_u64 *empty = rz_hamt_get_cstr(&fixture->map, "");
+    RZ_TESTS_ASSERT_TRUE(empty != NULL && *empty == 42, "empty key");
+    rz_hamt_free(&snapshot);
+}
@@ -0,0 +1,109 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_hm_mmap.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    rz_u32 id;
+    rz_f64 score;
+} Record;
+
+typedef struct {
+    rz_u64 key;
+    Record value;
+} RecordEntry;
+
+typedef struct {
+    const char *key;
+    rz_u32      value;
+} LevelEntry;
+
+typedef struct {
+    RZ_Allocator  alc;
+    RZ_BytesArray bytes;
+    RZ_HmMmap     m;
+} HmMmap;
+
+#define TESTS_HM_MMAP_ITEMS 5000u
+
+RZ_TESTS_SETUP(HmMmap) {
+    fixture->alc   = rz_test_allocator(rz_std_allocator());
+    fixture->bytes = (RZ_BytesArray){.allocator = fixture->alc};
+}
+
+RZ_TESTS_TEARDOWN(HmMmap) {
+    rz_hm_mmap_close(&fixture->m);
+    rz_arr_free(&fixture->bytes);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+RZ_TESTS(HmMmap, fixed_keys_from_bytes) {
+    RZ_Array(RecordEntry) entries = {.allocator = fixture->alc};
+    for (rz_u64 i = 0; i < TESTS_HM_MMAP_ITEMS; ++i) rz_arr_append(&entries, ((RecordEntry){i * 7, {.id = (rz_u32)i, .score = (rz_f64)i / 2}}));
+
+    rz_hm_mmap_serialize(&entries, &fixture->bytes, .seed = 42);
+    rz_arr_free(&entries);
+
+    RZ_TESTS_ASSERT_TRUE(rz_hm_mmap_from_bytes(&fixture->m, fixture->bytes.data, fixture->bytes.len, (RZ_HmMmapOpenOpt){.verify_checksum = true}));
+    RZ_TESTS_ASSERT_EQ(rz_hm_mmap_len(&fixture->m), TESTS_HM_MMAP_ITEMS);
+    for (rz_u64 i = 0; i < TESTS_HM_MMAP_ITEMS; ++i) {
+        const Record *r = rz_hm_mmap_get(&fixture->m, i * 7);
+        RZ_TESTS_ASSERT_TRUE(r != NULL);
+        RZ_TESTS_ASSERT_EQ(r->id, (rz_u32)i);
+        RZ_TESTS_ASSERT_TRUE(r->score == (rz_f64)i / 2);
+    }
+    RZ_TESTS_ASSERT_TRUE(rz_hm_mmap_get(&fixture->m, (rz_u64)1) == NULL, "not in the map");
+    RZ_TESTS_ASSERT_TRUE(rz_hm_mmap_get(&fixture->m, (rz_u32)7) == NULL, "other key size");
+
+    fixture->bytes.data[fixture->bytes.len - 1] ^= 1;
+    RZ_TESTS_ASSERT_TRUE(rz_hm_mmap_from_bytes(&fixture->m, fixture->bytes.data, fixture->bytes.len, (RZ_HmMmapOpenOpt){0}), "checksum is not verified by default");
+    RZ_TESTS_ASSERT_FALSE(rz_hm_mmap_from_bytes(&fixture->m, fixture->bytes.data, fixture->bytes.len, (RZ_HmMmapOpenOpt){.verify_checksum = true}));
+    RZ_TESTS_ASSERT_FALSE(rz_hm_mmap_from_bytes(&fixture->m, fixture->bytes.data, fixture->bytes.len - 8, (RZ_HmMmapOpenOpt){0}), "truncated file");
+    fixture->bytes.data[4] = RZ_HM_MMAP_VERSION + 1;
+    RZ_TESTS_ASSERT_FALSE(rz_hm_mmap_from_bytes(&fixture->m, fixture->bytes.data, fixture->bytes.len, (RZ_HmMmapOpenOpt){0}), "unsupported version");
+}
+
+RZ_TESTS(HmMmap, full_slots_miss) {
+    RZ_Array(RecordEntry) entries = {.allocator = fixture->alc};
+    for (rz_u64 i = 0; i < 4; ++i) rz_arr_append(&entries, ((RecordEntry){i, {.id = (rz_u32)i}}));
+    rz_hm_mmap_serialize(&entries, &fixture->bytes, .seed = 42);
+    rz_arr_free(&entries);
+
+    // fill every empty slot, the header still pass (len < nslots) and the checksum is not verified
+    RZ_HmMmapHeader *h     = (RZ_HmMmapHeader *)fixture->bytes.data;
+    RZ_HmMmapSlot   *slots = (RZ_HmMmapSlot *)(fixture->bytes.data + h->slots_offset);
+    for (rz_u64 i = 0; i < h->nslots; ++i) {
+        if (slots[i].offset == 0) slots[i] = (RZ_HmMmapSlot){.hash = 0, .offset = h->entries_offset};
+    }
+
+    RZ_TESTS_ASSERT_TRUE(rz_hm_mmap_from_bytes(&fixture->m, fixture->bytes.data, fixture->bytes.len, (RZ_HmMmapOpenOpt){0}));
+    RZ_TESTS_ASSERT_TRUE(rz_hm_mmap_get(&fixture->m, (rz_u64)3) != NULL);
+    RZ_TESTS_ASSERT_TRUE(rz_hm_mmap_get(&fixture->m, (rz_u64)69) == NULL, "the probe stops after nslots");
+}
+
+RZ_TESTS(HmMmap, string_keys_open_file) {
+    static const char *keys[] = {"info", "warn", "error", "debug", "trace", ""};
+
+    RZ_Array(LevelEntry) entries = {.allocator = fixture->alc};
+    for (rz_usize i = 0; i < RZ_ARRAY_LEN(keys); ++i) rz_arr_append(&entries, ((LevelEntry){keys[i], (rz_u32)i}));
+
+    RZ_Path path = rz_path("tests_rz_hm_mmap.rzhm");
+    RZ_TESTS_ASSERT_TRUE(rz_hm_mmap_write(path, &entries, .string_keys = true));
+    rz_arr_free(&entries);
+
+    RZ_TESTS_ASSERT_TRUE(rz_hm_mmap_open(&fixture->m, path, .verify_checksum = true));
+    for (rz_usize i = 0; i < RZ_ARRAY_LEN(keys); ++i) {
+        const rz_u32 *v = rz_hm_mmap_get_cstr(&fixture->m, keys[i]);
+        RZ_TESTS_ASSERT_TRUE(v != NULL);
+        RZ_TESTS_ASSERT_EQ(*v, (rz_u32)i);
+    }
+    RZ_TESTS_ASSERT_TRUE(rz_hm_mmap_get_cstr(&fixture->m, "fatal") == NULL);
+    RZ_TESTS_ASSERT_TRUE(rz_hm_mmap_get_sv(&fixture->m, rz_sv_sized("information", 5)) == NULL);
+    rz_hm_mmap_close(&fixture->m);
+    rz_fs_remove(path);
+}
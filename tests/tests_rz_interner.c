@@ -0,0 +1,61 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_interner.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator    alc;
+    RZ_Interner     in;
+    RZ_SyncInterner sync;
+} Interners;
+
+RZ_TESTS_SETUP(Interners) {
+    fixture->alc = rz_test_allocator(rz_std_allocator());
+    rz_interner_init(&fixture->in, fixture->alc);
+    rz_sync_interner_init(&fixture->sync, fixture->alc);
+}
+
+RZ_TESTS_TEARDOWN(Interners) {
+    rz_interner_free(&fixture->in);
+    rz_sync_interner_free(&fixture->sync);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+RZ_TESTS(Interners, interner_symbol_roundtrip) {
+    RZ_Symbol info = rz_intern_cstr(&fixture->in, "info");
+    RZ_Symbol warn = rz_intern_cstr(&fixture->in, "warn");
+    RZ_TESTS_ASSERT_EQ(info, 0u, "symbol is dense, start from 0");
+    RZ_TESTS_ASSERT_EQ(warn, 1u);
+
+    const char *line = "info: something";
+    RZ_TESTS_ASSERT_EQ(rz_intern(&fixture->in, rz_sv_sized(line, 4)), info, "same string same symbol");
+    RZ_TESTS_ASSERT_STREQ(rz_interner_cstr(&fixture->in, info), "info", "the string is copied with nul terminator");
+    RZ_TESTS_ASSERT_EQ(rz_interner_find_cstr(&fixture->in, "debug"), RZ_SYMBOL_NONE, "find never insert");
+    RZ_TESTS_ASSERT_EQ(rz_interner_len(&fixture->in), 2u);
+
+    char buf[32];
+    for (rz_usize i = 0; i < 1000; ++i) {
+        int       n   = snprintf(buf, sizeof(buf), "path/%zu", i);
+        RZ_Symbol sym = rz_intern(&fixture->in, rz_sv_sized(buf, n));
+        RZ_TESTS_ASSERT_EQ(sym, (RZ_Symbol)(i + 2));
+    }
+    RZ_StrView sv = rz_interner_str(&fixture->in, 2 + 500);
+    RZ_TESTS_ASSERT_TRUE(rz_sv_eq_cstr(sv, "path/500"), "strings is stable after the table grow");
+    RZ_TESTS_ASSERT_EQ(rz_intern_cstr(&fixture->in, "warn"), warn);
+}
+
+RZ_TESTS(Interners, sync_interner_symbol_roundtrip) {
+    RZ_Symbol a = rz_sync_intern_cstr(&fixture->sync, "--verbose");
+    RZ_Symbol b = rz_sync_intern_cstr(&fixture->sync, "--output");
+    RZ_TESTS_ASSERT_NE(a, b);
+    RZ_TESTS_ASSERT_EQ(rz_sync_intern_cstr(&fixture->sync, "--verbose"), a);
+    RZ_TESTS_ASSERT_EQ(rz_sync_interner_find(&fixture->sync, rz_sv("--output")), b);
+    RZ_TESTS_ASSERT_EQ(rz_sync_interner_find(&fixture->sync, rz_sv("--help")), RZ_SYMBOL_NONE);
+    RZ_TESTS_ASSERT_TRUE(rz_sv_eq_cstr(rz_sync_interner_str(&fixture->sync, b), "--output"));
+    RZ_TESTS_ASSERT_EQ(rz_sync_interner_len(&fixture->sync), 2u);
+}
@@ -0,0 +1,432 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_strings.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator alc;
+    RZ_Str       str;
+} Strings;
+
+RZ_TESTS_SETUP(Strings) {
+    fixture->alc = rz_test_allocator(rz_std_allocator());
+    fixture->str = (RZ_Str){.allocator = fixture->alc};
+}
+
+RZ_TESTS_TEARDOWN(Strings) {
+    rz_arr_free(&fixture->str);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+static rz_usize naive_find(RZ_StrView sv, RZ_StrView needle) {
+    if (needle.len == 0) return sv.len;
+    for (rz_usize i = 0; needle.len <= sv.len && i <= sv.len - needle.len; ++i) {
+        if (memcmp(sv.data + i, needle.data, needle.len) == 0) return i;
+    }
+    return RZ_NOT_FOUND;
+}
+
+static rz_usize naive_rfind(RZ_StrView sv, RZ_StrView needle) {
+    if (needle.len == 0) return sv.len;
+    for (rz_usize i = sv.len + 1; needle.len <= sv.len && i-- > 0;) {
+        if (i <= sv.len - needle.len && memcmp(sv.data + i, needle.data, needle.len) == 0) return i;
+    }
+    return RZ_NOT_FOUND;
+}
+
+RZ_TESTS(Strings, sv_find_edges) {
+    RZ_StrView sv = rz_sv("hello world");
+    RZ_TESTS_ASSERT_EQ(rz_sv_find_cstr(sv, "world"), 6u, "match at the last position");
+    RZ_TESTS_ASSERT_EQ(rz_sv_rfind_cstr(sv, "world"), 6u, "match at the last position");
+    RZ_TESTS_ASSERT_EQ(rz_sv_find_cstr(sv, "hello world"), 0u);
+    RZ_TESTS_ASSERT_EQ(rz_sv_rfind_cstr(sv, "hello world"), 0u);
+    RZ_TESTS_ASSERT_EQ(rz_sv_rfind_cstr(sv, "he"), 0u, "match at the first position");
+    RZ_TESTS_ASSERT_EQ(rz_sv_find_cstr(sv, "hello world!"), RZ_NOT_FOUND);
+    RZ_TESTS_ASSERT_EQ(rz_sv_find_cstr(sv, ""), sv.len);
+    RZ_TESTS_ASSERT_EQ(rz_sv_rfind_cstr(sv, ""), sv.len);
+    RZ_TESTS_ASSERT_EQ(rz_sv_find_cstr(sv, "o"), 4u);
+    RZ_TESTS_ASSERT_EQ(rz_sv_rfind_cstr(sv, "o"), 7u);
+    RZ_TESTS_ASSERT_TRUE(rz_sv_contains_cstr(sv, "ld"));
+    RZ_TESTS_ASSERT_FALSE(rz_sv_contains_cstr(sv, "wold"));
+
+    RZ_StrFinder f = rz_sv_finder(rz_sv("abab"));
+    RZ_TESTS_ASSERT_EQ(rz_sv_finder_find(&f, rz_sv("xxabababx")), 2u);
+    RZ_TESTS_ASSERT_EQ(rz_sv_finder_rfind(&f, rz_sv("xxabababx")), 4u);
+    RZ_TESTS_ASSERT_EQ(rz_sv_finder_find(&f, rz_sv("aba")), RZ_NOT_FOUND);
+}
+
+RZ_TESTS(Strings, sv_find_random) {
+    // small alphabet, so the filter see many false candidates and the periodic needle is common
+    rz_u32 seed = 7;
+    char   needle[72];
+    for (rz_usize round = 0; round < 3000; ++round) {
+        fixture->str.len = 0;
+        seed             = (seed * 1103515245U) + 12345U;
+        rz_usize len     = (seed >> 16U) % 300U;
+        rz_u32   sigma   = 1 + ((seed >> 8U) % 3U);
+        for (rz_usize i = 0; i < len; ++i) {
+            seed = (seed * 1103515245U) + 12345U;
+            rz_arr_append(&fixture->str, (char)('a' + ((seed >> 16U) % sigma)));
+        }
+        RZ_StrView sv = rz_sv_from_str(&fixture->str);
+
+        seed              = (seed * 1103515245U) + 12345U;
+        rz_usize nlen     = (seed >> 16U) % 71U;
+        rz_usize from     = (len > nlen) ? ((seed >> 4U) % (len - nlen + 1)) : 0;
+        bool     take_sub = (len >= nlen) && (round % 3 != 0);
+        for (rz_usize i = 0; i < nlen; ++i) {
+            seed      = (seed * 1103515245U) + 12345U;
+            needle[i] = take_sub ? sv.data[from + i] : (char)('a' + ((seed >> 16U) % sigma));
+        }
+        if (round % 5 == 0 && nlen > 0) needle[nlen - 1] = 'b'; // "aaa...ab"
+        RZ_StrView   n = rz_sv_sized(needle, nlen);
+        RZ_StrFinder f = rz_sv_finder(n);
+
+        RZ_TESTS_ASSERT_EQ(rz_sv_find(sv, n), naive_find(sv, n), "round %zu (len %zu, needle %zu)", round, len, nlen);
+        RZ_TESTS_ASSERT_EQ(rz_sv_rfind(sv, n), naive_rfind(sv, n), "round %zu (len %zu, needle %zu)", round, len, nlen);
+        RZ_TESTS_ASSERT_EQ(rz_sv_finder_find(&f, sv), naive_find(sv, n), "round %zu", round);
+        RZ_TESTS_ASSERT_EQ(rz_sv_finder_rfind(&f, sv), naive_rfind(sv, n), "round %zu", round);
+    }
+}
+
+RZ_TESTS(Strings, sv_find_adversarial) {
+    // "aaa...a" haystack with "aa...abaa...a" needle make every position a candidate of the filter,
+    // the search switch to Two-Way and must still find the match near the end
+    for (rz_usize i = 0; i < 5000; ++i) rz_arr_append(&fixture->str, 'a');
+    char needle[65];
+    memset(needle, 'a', sizeof(needle));
+    needle[32]    = 'b';
+    RZ_StrView sv = rz_sv_from_str(&fixture->str);
+    RZ_StrView n  = rz_sv_sized(needle, sizeof(needle));
+    RZ_TESTS_ASSERT_EQ(rz_sv_find(sv, n), RZ_NOT_FOUND);
+    RZ_TESTS_ASSERT_EQ(rz_sv_rfind(sv, n), RZ_NOT_FOUND);
+
+    fixture->str.data[4950] = 'b';
+    RZ_TESTS_ASSERT_EQ(rz_sv_find(sv, n), 4950u - 32u);
+    RZ_TESTS_ASSERT_EQ(rz_sv_rfind(sv, n), 4950u - 32u);
+
+    // the match near the start is found from the end
+    fixture->str.data[4950] = 'a';
+    fixture->str.data[40]   = 'b';
+    RZ_TESTS_ASSERT_EQ(rz_sv_rfind(sv, n), 8u);
+    RZ_TESTS_ASSERT_EQ(rz_sv_find(sv, n), 8u);
+}
+
+RZ_TESTS(Strings, sv_find_bytes_random) {
+    // the bytes >= 0x80 and the set with the high nibbles `h` and `h ^ 8` check the verification of the nibble lookup,
+    // the set of 20 bytes is scalar without the byte shuffle
+    static const char *const sets[] = {"\r\n,", "a", "xyz\x80", "\x2c\xac", "0123456789abcdef", "\x01\x12\x23\x34\x45\x56\x67\x78\x89\x9a",
+                                       "0123456789abcdefghij"};
+    rz_u32                   seed   = 13;
+    for (rz_usize round = 0; round < 2000; ++round) {
+        fixture->str.len = 0;
+        seed             = (seed * 1103515245U) + 12345U;
+        rz_usize len     = (seed >> 16U) % 200U;
+        RZ_StrView set   = rz_sv(sets[round % RZ_ARRAY_LEN(sets)]);
+        for (rz_usize i = 0; i < len; ++i) {
+            seed = (seed * 1103515245U) + 12345U;
+            // mostly the fill byte, so the matches is sparse and the trims is long
+            rz_u32 r = (seed >> 16U) % 64U;
+            rz_arr_append(&fixture->str, (r < 2) ? set.data[r % set.len] : (r < 4) ? (char)(seed >> 8U) : '-');
+        }
+        RZ_StrView sv = rz_sv_from_str(&fixture->str);
+
+        rz_usize first_any = RZ_NOT_FOUND, last_any = RZ_NOT_FOUND, first_ch = RZ_NOT_FOUND, last_ch = RZ_NOT_FOUND;
+        rz_usize first_fill = len, last_fill = 0;
+        for (rz_usize i = 0; i < len; ++i) {
+            bool in_set = memchr(set.data, sv.data[i], set.len) != NULL;
+            if (in_set && first_any == RZ_NOT_FOUND) first_any = i;
+            if (in_set) last_any = i;
+            if (sv.data[i] == set.data[0] && first_ch == RZ_NOT_FOUND) first_ch = i;
+            if (sv.data[i] == set.data[0]) last_ch = i;
+            if (sv.data[i] != '-' && first_fill == len) first_fill = i;
+            if (sv.data[i] != '-') last_fill = i + 1;
+        }
+        if (first_fill == len) last_fill = len; // trim everything, the suffix trim is empty
+
+        RZ_TESTS_ASSERT_EQ(rz_sv_find_any(sv, set), first_any, "round %zu", round);
+        RZ_TESTS_ASSERT_EQ(rz_sv_rfind_any(sv, set), last_any, "round %zu", round);
+        RZ_TESTS_ASSERT_EQ(rz_sv_find_char(sv, set.data[0]), first_ch, "round %zu", round);
+        RZ_TESTS_ASSERT_EQ(rz_sv_rfind_char(sv, set.data[0]), last_ch, "round %zu", round);
+        RZ_TESTS_ASSERT_EQ(rz_sv_trim_prefix_char(sv, '-').len, len - first_fill, "round %zu", round);
+        RZ_TESTS_ASSERT_EQ(rz_sv_trim_suffix_char(sv, '-').len, (first_fill == len) ? 0 : last_fill, "round %zu", round);
+    }
+}
+
+RZ_TESTS(Strings, sv_split_any) {
+    RZ_StrView sv     = rz_sv("a,b\r\nc,");
+    RZ_StrView result = {0};
+    RZ_TESTS_ASSERT_TRUE(rz_sv_split_any_cstr(&sv, "\r\n,", &result) && rz_sv_eq_cstr(result, "a"));
+    RZ_TESTS_ASSERT_TRUE(rz_sv_split_any_cstr(&sv, "\r\n,", &result) && rz_sv_eq_cstr(result, "b"));
+    RZ_TESTS_ASSERT_TRUE(rz_sv_split_any_cstr(&sv, "\r\n,", &result) && rz_sv_is_empty(result));
+    RZ_TESTS_ASSERT_TRUE(rz_sv_split_any_cstr(&sv, "\r\n,", &result) && rz_sv_eq_cstr(result, "c"));
+    RZ_TESTS_ASSERT_FALSE(rz_sv_split_any_cstr(&sv, "\r\n,", &result));
+
+    // the rest of rsplit is everything before the delimiter
+    sv = rz_sv("a/bcd\\ef");
+    RZ_TESTS_ASSERT_TRUE(rz_sv_rsplit_any_cstr(&sv, "/\\", &result) && rz_sv_eq_cstr(result, "ef") && rz_sv_eq_cstr(sv, "a/bcd"));
+    RZ_TESTS_ASSERT_TRUE(rz_sv_rsplit_char(&sv, '/', &result) && rz_sv_eq_cstr(result, "bcd") && rz_sv_eq_cstr(sv, "a"));
+
+    RZ_TESTS_ASSERT_EQ(rz_sv_find_by(rz_sv("abc1"), rz_is_ascii_digit), 3u, "the last char is checked");
+}
+
+static rz_usize dp_distance(RZ_StrView a, RZ_StrView b, bool transpositions) {
+    static rz_usize d[302][302];
+    for (rz_usize i = 0; i <= a.len; ++i) d[i][0] = i;
+    for (rz_usize j = 0; j <= b.len; ++j) d[0][j] = j;
+    for (rz_usize i = 1; i <= a.len; ++i) {
+        for (rz_usize j = 1; j <= b.len; ++j) {
+            rz_usize cost = a.data[i - 1] != b.data[j - 1];
+            d[i][j]       = RZ_MIN(RZ_MIN(d[i - 1][j] + 1, d[i][j - 1] + 1), d[i - 1][j - 1] + cost);
+            if (transpositions && i > 1 && j > 1 && a.data[i - 1] == b.data[j - 2] && a.data[i - 2] == b.data[j - 1]) {
+                d[i][j] = RZ_MIN(d[i][j], d[i - 2][j - 2] + 1);
+            }
+        }
+    }
+    return d[a.len][b.len];
+}
+
+RZ_TESTS(Strings, sv_edit_distance) {
+    RZ_TESTS_ASSERT_EQ(rz_sv_levenshtein_distance_cstr(rz_sv("kitten"), "sitting"), 3u);
+    RZ_TESTS_ASSERT_EQ(rz_sv_osa_distance_cstr(rz_sv("ca"), "abc"), 3u, "OSA edit the substring once");
+    RZ_TESTS_ASSERT_EQ(rz_sv_osa_distance_cstr(rz_sv("abcd"), "acbd"), 1u);
+    RZ_TESTS_ASSERT_EQ(rz_sv_levenshtein_distance_cstr(rz_sv(""), "abc"), 3u);
+    RZ_TESTS_ASSERT_EQ(rz_sv_levenshtein_distance_max(rz_sv("kitten"), rz_sv("sitting"), 2), 3u, "max + 1 when farther");
+
+    // up to 300 chars, the multi word bit vectors and the carry between the words
+    char   a[300], b[300];
+    rz_u32 seed = 17;
+    for (rz_usize round = 0; round < 400; ++round) {
+        seed           = (seed * 1103515245U) + 12345U;
+        rz_usize a_len = (round < 200) ? ((seed >> 16U) % 70U) : ((seed >> 16U) % 300U);
+        seed           = (seed * 1103515245U) + 12345U;
+        rz_usize b_len = (round % 2) ? a_len : ((seed >> 16U) % 300U);
+        for (rz_usize i = 0; i < a_len; ++i) {
+            seed = (seed * 1103515245U) + 12345U;
+            a[i] = (char)('a' + ((seed >> 16U) % 4U));
+        }
+        for (rz_usize i = 0; i < b_len; ++i) {
+            // similar strings: mostly the char of `a`, some edits
+            seed = (seed * 1103515245U) + 12345U;
+            b[i] = (i < a_len && ((seed >> 16U) % 8U) != 0) ? a[i] : (char)('a' + ((seed >> 20U) % 4U));
+            if (i > 0 && i < a_len && ((seed >> 8U) % 16U) == 0) RZ_SWAP(b[i], b[i - 1]);
+        }
+        RZ_StrView sa = rz_sv_sized(a, a_len), sb = rz_sv_sized(b, b_len);
+        rz_usize   lev = dp_distance(sa, sb, false), osa = dp_distance(sa, sb, true);
+        RZ_TESTS_ASSERT_EQ(rz_sv_levenshtein_distance(sa, sb), lev, "round %zu (%zu x %zu)", round, a_len, b_len);
+        RZ_TESTS_ASSERT_EQ(rz_sv_osa_distance(sa, sb), osa, "round %zu (%zu x %zu)", round, a_len, b_len);
+        RZ_TESTS_ASSERT_EQ(rz_sv_osa_distance(sb, sa), osa, "round %zu symmetric", round);
+        rz_usize max = lev / 2;
+        RZ_TESTS_ASSERT_EQ(rz_sv_levenshtein_distance_max(sa, sb, max), (lev > max) ? max + 1 : lev, "round %zu", round);
+        RZ_TESTS_ASSERT_EQ(rz_sv_osa_distance_max(sa, sb, osa), osa, "round %zu", round);
+    }
+}
+
+RZ_TESTS(Strings, sv_fuzzy_top_k) {
+    RZ_StrView  candidates[] = {rz_sv("sv_find"), rz_sv("sv_rfind"), rz_sv("sv_split_any"), rz_sv("hm_insert"), rz_sv("sv_fnid"), rz_sv("sv_find")};
+    RZ_StrMatch out[3]       = {0};
+
+    rz_usize found = rz_sv_fuzzy_top_k(rz_sv("sv_fnid"), candidates, RZ_ARRAY_LEN(candidates), out, RZ_ARRAY_LEN(out), .transpositions = true);
+    RZ_TESTS_ASSERT_EQ(found, 3u);
+    RZ_TESTS_ASSERT_TRUE(out[0].index == 4 && out[0].distance == 0);
+    RZ_TESTS_ASSERT_TRUE(out[1].index == 0 && out[1].distance == 1, "the earlier candidate win the tie");
+    RZ_TESTS_ASSERT_TRUE(out[2].index == 5 && out[2].distance == 1);
+
+    found = rz_sv_fuzzy_top_k(rz_sv("sv_fnid"), candidates, RZ_ARRAY_LEN(candidates), out, RZ_ARRAY_LEN(out), .max_distance = 2);
+    RZ_TESTS_ASSERT_EQ(found, 3u);
+    RZ_TESTS_ASSERT_TRUE(out[0].index == 4 && out[1].index == 0 && out[1].distance == 2 && out[2].index == 5);
+
+    found = rz_sv_fuzzy_top_k(rz_sv("xyz"), candidates, RZ_ARRAY_LEN(candidates), out, RZ_ARRAY_LEN(out), .max_distance = 2);
+    RZ_TESTS_ASSERT_EQ(found, 0u);
+}
+
+static rz_ptrdiff naive_case_cmp(RZ_StrView a, RZ_StrView b) {
+    for (rz_usize i = 0; i < a.len; ++i) {
+        rz_u8 x = (rz_u8)rz_ascii_lower(a.data[i]), y = (rz_u8)rz_ascii_lower(b.data[i]);
+        if (x != y) return (rz_ptrdiff)x - (rz_ptrdiff)y;
+    }
+    return 0;
+}
+
+RZ_TESTS(Strings, sv_case_fold_random) {
+    // the bytes around the letters ('@' '[' '`' '{') and the letters + 0x80 must not be folded
+    static const char alphabet[] = "aAbBzZ@[`{\xC1\xE1";
+    rz_u32            seed       = 11;
+    char              a[160], b[160], la[160], lb[160];
+    for (rz_usize round = 0; round < 3000; ++round) {
+        seed         = (seed * 1103515245U) + 12345U;
+        rz_usize len = (seed >> 16U) % 150U;
+        rz_u32   sigma = (round % 2) ? 4 : (sizeof(alphabet) - 1);
+        for (rz_usize i = 0; i < len; ++i) {
+            seed = (seed * 1103515245U) + 12345U;
+            a[i] = alphabet[(seed >> 16U) % sigma];
+            // the same string with the random case, and sometimes one different byte
+            b[i] = ((seed >> 8U) % 2U) ? rz_ascii_upper(a[i]) : rz_ascii_lower(a[i]);
+            if (((seed >> 4U) % 97U) == 0) b[i] = alphabet[(seed >> 24U) % sigma];
+        }
+        RZ_StrView sa = rz_sv_sized(a, len), sb = rz_sv_sized(b, len);
+        rz_ptrdiff cmp = rz_sv_case_cmp(sa, sb), expect = naive_case_cmp(sa, sb);
+        RZ_TESTS_ASSERT_TRUE(len == 0 || cmp == expect, "round %zu (%td vs %td)", round, cmp, expect);
+        if (cmp == 0) RZ_TESTS_ASSERT_EQ(rz_sv_case_hash(sa, 42), rz_sv_case_hash(sb, 42), "round %zu", round);
+
+        memcpy(la, a, len);
+        memcpy(lb, b, len);
+        RZ_StrView va = rz_sv_sized(la, len), vb = rz_sv_sized(lb, len);
+        rz_sv_to_ascii_lowercase(&va);
+        rz_sv_to_ascii_uppercase(&vb);
+        for (rz_usize i = 0; i < len; ++i) {
+            RZ_TESTS_ASSERT_EQ(la[i], rz_ascii_lower(a[i]), "round %zu at %zu", round, i);
+            RZ_TESTS_ASSERT_EQ(lb[i], rz_ascii_upper(b[i]), "round %zu at %zu", round, i);
+        }
+
+        // the needle is a piece of `b` (random case) searched in `a`, the reference search the lowercase copies
+        seed          = (seed * 1103515245U) + 12345U;
+        rz_usize nlen = (seed >> 16U) % 40U;
+        rz_usize from = (len > nlen) ? ((seed >> 4U) % (len - nlen + 1)) : 0;
+        if (nlen > len) nlen = len;
+        rz_sv_to_ascii_lowercase(&vb);
+        RZ_StrView needle = rz_sv_sized(b + from, nlen);
+        RZ_TESTS_ASSERT_EQ(rz_sv_case_find(sa, needle), naive_find(va, rz_sv_sized(lb + from, nlen)), "round %zu (len %zu, needle %zu)", round, len, nlen);
+    }
+
+    RZ_StrView k0 = rz_sv("Content-Type"), k1 = rz_sv("content-type"), k2 = rz_sv("content-typo");
+    RZ_TESTS_ASSERT_TRUE(rz_hm_hasheq_sv_case(RZ_HM_HASHCMP_CMP, &k0, &k1, sizeof(RZ_StrView), 0));
+    RZ_TESTS_ASSERT_FALSE(rz_hm_hasheq_sv_case(RZ_HM_HASHCMP_CMP, &k0, &k2, sizeof(RZ_StrView), 0));
+    RZ_TESTS_ASSERT_EQ(rz_hm_hasheq_sv_case(RZ_HM_HASHCMP_HASH, &k0, NULL, sizeof(RZ_StrView), 7), rz_hm_hasheq_sv_case(RZ_HM_HASHCMP_HASH, &k1, NULL, sizeof(RZ_StrView), 7));
+    RZ_TESTS_ASSERT_TRUE(rz_sv_case_contains_cstr(rz_sv("Accept: TEXT/HTML"), "text/html"));
+    RZ_TESTS_ASSERT_EQ(rz_sv_case_find_cstr(rz_sv("xXx"), "X"), 0u);
+    RZ_TESTS_ASSERT_EQ(rz_sv_case_find_cstr(rz_sv("ab"), "\xC1"), RZ_NOT_FOUND);
+
+    // the filter give up on "aAaA..." and the folded Two-Way must find the match near the end
+    fixture->str.len = 0;
+    for (rz_usize i = 0; i < 5000; ++i) rz_arr_append(&fixture->str, (i % 2) ? 'A' : 'a');
+    char needle[65];
+    memset(needle, 'a', sizeof(needle));
+    needle[32]            = 'B';
+    fixture->str.data[4951] = 'b';
+    RZ_TESTS_ASSERT_EQ(rz_sv_case_find(rz_sv_from_str(&fixture->str), rz_sv_sized(needle, sizeof(needle))), 4951u - 32u);
+}
+
+RZ_TESTS(Strings, sv_parse_int) {
+    rz_i64            i = 0;
+    rz_u64            u = 0;
+    RZ_StrParseResult r = rz_sv_parse_i64(rz_sv("-9223372036854775808"), &i);
+    RZ_TESTS_ASSERT_TRUE(rz_sv_parse_is_full(r, rz_sv("-9223372036854775808")) && i == RZ_I64_MIN);
+    r = rz_sv_parse_i64(rz_sv("+9223372036854775807"), &i);
+    RZ_TESTS_ASSERT_TRUE(r.status == RZ_STR_PARSE_OK && i == RZ_I64_MAX);
+    r = rz_sv_parse_i64(rz_sv("9223372036854775808"), &i);
+    RZ_TESTS_ASSERT_TRUE(r.status == RZ_STR_PARSE_OVERFLOW && r.consumed == 19 && i == RZ_I64_MAX, "clamped");
+    r = rz_sv_parse_i64(rz_sv("-00000000000000000000000000012345678901234xyz"), &i);
+    RZ_TESTS_ASSERT_TRUE(r.status == RZ_STR_PARSE_OK && r.consumed == 42 && i == -12345678901234, "leading zeros, partial");
+
+    r = rz_sv_parse_u64(rz_sv("18446744073709551615"), &u);
+    RZ_TESTS_ASSERT_TRUE(r.status == RZ_STR_PARSE_OK && u == RZ_U64_MAX);
+    static const char *const overflows[] = {"18446744073709551616", "20000000000000000000", "99999999999999999999", "100000000000000000000"};
+    for (rz_usize k = 0; k < RZ_ARRAY_LEN(overflows); ++k) {
+        r = rz_sv_parse_u64(rz_sv(overflows[k]), &u);
+        RZ_TESTS_ASSERT_TRUE(r.status == RZ_STR_PARSE_OVERFLOW && u == RZ_U64_MAX, "%s", overflows[k]);
+    }
+    u = 7;
+    static const char *const invalids[] = {"", "+", "-1", " 1", "x1"};
+    for (rz_usize k = 0; k < RZ_ARRAY_LEN(invalids); ++k) {
+        r = rz_sv_parse_u64(rz_sv(invalids[k]), &u);
+        RZ_TESTS_ASSERT_TRUE(r.status == RZ_STR_PARSE_INVALID && r.consumed == 0 && u == 7, "'%s'", invalids[k]);
+    }
+
+    // every length around the 8 digits chunks, followed by the non digit
+    char buf[32];
+    for (rz_u32 round = 0, seed = 5; round < 5000; ++round) {
+        seed       = (seed * 1103515245U) + 12345U;
+        rz_u64 v   = ((rz_u64)seed << 32U) | ((seed * 1103515245U) + 12345U);
+        v        >>= round % 64U;
+        int n      = snprintf(buf, sizeof(buf), "%llu:", (unsigned long long)v);
+        r          = rz_sv_parse_u64(rz_sv(buf), &u);
+        RZ_TESTS_ASSERT_TRUE(r.status == RZ_STR_PARSE_OK && r.consumed == (rz_usize)(n - 1) && u == v, "%s", buf);
+        rz_i64 s = (round % 2) ? -(rz_i64)(v >> 1U) : (rz_i64)(v >> 1U);
+        snprintf(buf, sizeof(buf), "%lld", (long long)s);
+        RZ_TESTS_ASSERT_TRUE(rz_sv_parse_is_full(rz_sv_parse_i64(rz_sv(buf), &i), rz_sv(buf)) && i == s, "%s", buf);
+    }
+}
+
+// the result must be the same bits as strtod and strtof
+static bool check_float(const char *cstr) {
+    rz_f64 d = 0, expect_d = strtod(cstr, NULL);
+    rz_f32 f = 0, expect_f = strtof(cstr, NULL);
+    RZ_StrParseResult rd = rz_sv_parse_f64(rz_sv(cstr), &d);
+    RZ_StrParseResult rf = rz_sv_parse_f32(rz_sv(cstr), &f);
+    return rd.consumed == strlen(cstr) && rf.consumed == strlen(cstr) && memcmp(&d, &expect_d, sizeof(d)) == 0 && memcmp(&f, &expect_f, sizeof(f)) == 0;
+}
+
+RZ_TESTS(Strings, sv_parse_float) {
+    // the halfway cases, the boundaries of the subnormals and of the overflow, the long mantissas
+    static const char *const cases[] = {
+        "0", "-0", "1", "0.1", "-.5", "5.", "1e23", "9007199254740993", "9007199254740993.000000000000000000001",
+        "7.2057594037927933e16", "2.2250738585072011e-308", "2.2250738585072014e-308", "4.9e-324", "2.4703282292062327e-324",
+        "2.4703282292062328e-324", "1e-400", "1.7976931348623157e308", "1.7976931348623158e308", "3.4028235e38",
+        "1.4e-45", "7.006492321624085354618e-46", "1.00000005960464477550", "123456789012345678901234567890",
+        "0.000000000000000000000000000000000000000000001234567890123456789012345", "1e0000000000000000000000000000001",
+        "2.47032822920623272088284396434110686182529901307162382212792841250337753635104375932649918180817996189898282347"
+        "722858865463328355177969898199387398005390939063150356595155702263922908583924491051844359318028499365361525003193"
+        "704576782492193656236698636584807570236923306569393052148226300498478209718624744e-324",
+    };
+    for (rz_usize k = 0; k < RZ_ARRAY_LEN(cases); ++k) RZ_TESTS_ASSERT_TRUE(check_float(cases[k]), "%s", cases[k]);
+
+    rz_f64            d = 0;
+    RZ_StrParseResult r = rz_sv_parse_f64(rz_sv("-1e400"), &d);
+    RZ_TESTS_ASSERT_TRUE(r.status == RZ_STR_PARSE_OVERFLOW && r.consumed == 6 && d < 0 && d * 0.5 == d, "-inf");
+    r = rz_sv_parse_f64(rz_sv("-Infinity"), &d);
+    RZ_TESTS_ASSERT_TRUE(r.status == RZ_STR_PARSE_OK && r.consumed == 9 && d < 0 && d * 0.5 == d);
+    r = rz_sv_parse_f64(rz_sv("NaN"), &d);
+    RZ_TESTS_ASSERT_TRUE(r.status == RZ_STR_PARSE_OK && r.consumed == 3 && d != d);
+    r = rz_sv_parse_f64(rz_sv("1.5e+x"), &d);
+    RZ_TESTS_ASSERT_TRUE(r.status == RZ_STR_PARSE_OK && r.consumed == 3 && d == 1.5, "the 'e' without digits is not consumed");
+    d = 2;
+    static const char *const invalids[] = {"", ".", "-", "+.e1", "e5", "in", " 1"};
+    for (rz_usize k = 0; k < RZ_ARRAY_LEN(invalids); ++k) {
+        r = rz_sv_parse_f64(rz_sv(invalids[k]), &d);
+        RZ_TESTS_ASSERT_TRUE(r.status == RZ_STR_PARSE_INVALID && r.consumed == 0 && d == 2, "'%s'", invalids[k]);
+    }
+
+    // the random doubles printed with the random precision, and the random long digits strings
+    char   buf[128];
+    rz_u64 seed = 88172645463325252ull;
+    for (rz_usize round = 0; round < 20000; ++round) {
+        seed ^= seed << 13U, seed ^= seed >> 7U, seed ^= seed << 17U;
+        memcpy(&d, &seed, sizeof(d));
+        if (((seed >> 52U) & 0x7FFU) != 0x7FFU) {
+            snprintf(buf, sizeof(buf), "%.*g", (int)(1 + (round % 17)), d);
+            RZ_TESTS_ASSERT_TRUE(check_float(buf), "%s", buf);
+        }
+        rz_usize n = 0, digits = 1 + (seed % 40U);
+        for (rz_usize k = 0; k < digits; ++k) {
+            seed     ^= seed << 13U, seed ^= seed >> 7U, seed ^= seed << 17U;
+            buf[n++]  = (char)('0' + (seed % 10U));
+            if (k == (digits / 2) && (seed & 16U)) buf[n++] = '.';
+        }
+        snprintf(buf + n, sizeof(buf) - n, "e%d", (int)((seed >> 8U) % 700U) - 350);
+        RZ_TESTS_ASSERT_TRUE(check_float(buf), "%s", buf);
+    }
+}
+
+RZ_TESTS(Strings, sv_parse_many) {
+    const RZ_StrView ints[] = {rz_sv("1"), rz_sv("-22"), rz_sv("333333333333"), rz_sv("4x"), rz_sv("5")};
+    rz_i64           i[RZ_ARRAY_LEN(ints)];
+    rz_u64           u[RZ_ARRAY_LEN(ints)];
+    RZ_TESTS_ASSERT_EQ(rz_sv_parse_many_i64(ints, 3, i), 3u);
+    RZ_TESTS_ASSERT_TRUE(i[0] == 1 && i[1] == -22 && i[2] == 333333333333);
+    RZ_TESTS_ASSERT_EQ(rz_sv_parse_many_i64(ints, RZ_ARRAY_LEN(ints), i), 3u, "partial consumption");
+    RZ_TESTS_ASSERT_EQ(rz_sv_parse_many_u64(ints, RZ_ARRAY_LEN(ints), u), 1u, "no sign");
+
+    const RZ_StrView floats[] = {rz_sv("0.5"), rz_sv("-1e3"), rz_sv("3.4e39"), rz_sv("1")};
+    rz_f64           d[RZ_ARRAY_LEN(floats)];
+    rz_f32           f[RZ_ARRAY_LEN(floats)];
+    RZ_TESTS_ASSERT_EQ(rz_sv_parse_many_f64(floats, RZ_ARRAY_LEN(floats), d), RZ_ARRAY_LEN(floats));
+    RZ_TESTS_ASSERT_TRUE(d[0] == 0.5 && d[1] == -1e3 && d[2] == 3.4e39 && d[3] == 1);
+    RZ_TESTS_ASSERT_EQ(rz_sv_parse_many_f32(floats, RZ_ARRAY_LEN(floats), f), 2u, "overflow of the float");
+    RZ_TESTS_ASSERT_EQ(rz_sv_parse_many_f32(floats, 0, NULL), 0u);
+}
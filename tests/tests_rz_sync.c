@@ -0,0 +1,97 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_sync.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator         alc;
+    RZ_SpscQueue(rz_u64) spsc;
+    RZ_MpmcQueue(rz_u64) mpmc;
+} Queues;
+
+#define TESTS_QUEUE_ITEMS 100000u
+
+RZ_TESTS_SETUP(Queues) {
+    fixture->alc = rz_test_allocator(rz_std_allocator());
+    rz_spsc_init(&fixture->spsc, .capacity = 100, .allocator = fixture->alc);
+    rz_mpmc_init(&fixture->mpmc, .capacity = 64, .allocator = fixture->alc);
+}
+
+RZ_TESTS_TEARDOWN(Queues) {
+    rz_spsc_free(&fixture->spsc);
+    rz_mpmc_free(&fixture->mpmc);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+RZ_TESTS(Queues, queue_bounded_push_pop) {
+    RZ_TESTS_ASSERT_EQ(rz_spsc_capacity(&fixture->spsc), 128u, "capacity is rounded up to power of two");
+    RZ_TESTS_ASSERT_EQ(rz_mpmc_capacity(&fixture->mpmc), 64u);
+
+    rz_u64 items[200];
+    for (rz_usize i = 0; i < RZ_ARRAY_LEN(items); ++i) { items[i] = i; }
+
+    RZ_TESTS_ASSERT_EQ(rz_spsc_push_many(&fixture->spsc, items, 200), 128u, "push many stop when the queue is full");
+    RZ_TESTS_ASSERT_FALSE(rz_spsc_try_push(&fixture->spsc, 69));
+    RZ_TESTS_ASSERT_EQ(rz_mpmc_push_many(&fixture->mpmc, items, 200), 64u);
+    RZ_TESTS_ASSERT_FALSE(rz_mpmc_try_push(&fixture->mpmc, 69));
+
+    rz_u64 out[200] = {0};
+    RZ_TESTS_ASSERT_EQ(rz_spsc_pop_many(&fixture->spsc, out, 100), 100u);
+    for (rz_usize i = 0; i < 100; ++i) { RZ_TESTS_ASSERT_EQ(out[i], items[i]); }
+    // wrap around the end of the ring.
+    RZ_TESTS_ASSERT_EQ(rz_spsc_push_many(&fixture->spsc, items + 128, 72), 72u);
+    RZ_TESTS_ASSERT_EQ(rz_spsc_len(&fixture->spsc), 100u);
+    RZ_TESTS_ASSERT_EQ(rz_spsc_pop_many(&fixture->spsc, out, 200), 100u);
+    for (rz_usize i = 0; i < 100; ++i) { RZ_TESTS_ASSERT_EQ(out[i], items[100 + i]); }
+
+    rz_u64 v = 0;
+    for (rz_usize i = 0; i < 64; ++i) {
+        RZ_TESTS_ASSERT_TRUE(rz_mpmc_try_pop(&fixture->mpmc, &v));
+        RZ_TESTS_ASSERT_EQ(v, items[i]);
+    }
+    RZ_TESTS_ASSERT_FALSE(rz_mpmc_try_pop(&fixture->mpmc, &v));
+    RZ_TESTS_ASSERT_FALSE(rz_spsc_try_pop(&fixture->spsc, &v));
+}
+
+static int tests_spsc_producer(void *arg) {
+    Queues *q = arg;
+    for (rz_u64 i = 1; i <= TESTS_QUEUE_ITEMS; ++i) { rz_spsc_push(&q->spsc, i); }
+    return 0;
+}
+
+static int tests_mpmc_producer(void *arg) {
+    Queues *q = arg;
+    for (rz_u64 i = 1; i <= TESTS_QUEUE_ITEMS; ++i) { rz_mpmc_push(&q->mpmc, i); }
+    return 0;
+}
+
+RZ_TESTS(Queues, queue_blocking_threads) {
+    const rz_u64 expected = ((rz_u64)TESTS_QUEUE_ITEMS * (TESTS_QUEUE_ITEMS + 1)) / 2;
+
+    thrd_t producer;
+    RZ_TESTS_ASSERT_EQ(thrd_create(&producer, tests_spsc_producer, fixture), thrd_success);
+    rz_u64 sum = 0, prev = 0, v = 0;
+    for (rz_usize i = 0; i < TESTS_QUEUE_ITEMS; ++i) {
+        rz_spsc_pop(&fixture->spsc, &v);
+        RZ_TESTS_ASSERT_EQ(v, prev + 1, "spsc keep the order of items");
+        prev = v;
+        sum += v;
+    }
+    thrd_join(producer, NULL);
+    RZ_TESTS_ASSERT_EQ(sum, expected);
+
+    thrd_t producers[2];
+    for (rz_usize i = 0; i < RZ_ARRAY_LEN(producers); ++i) { thrd_create(&producers[i], tests_mpmc_producer, fixture); }
+    sum = 0;
+    for (rz_usize i = 0; i < TESTS_QUEUE_ITEMS * RZ_ARRAY_LEN(producers); ++i) {
+        rz_mpmc_pop(&fixture->mpmc, &v);
+        sum += v;
+    }
+    for (rz_usize i = 0; i < RZ_ARRAY_LEN(producers); ++i) { thrd_join(producers[i], NULL); }
+    RZ_TESTS_ASSERT_EQ(sum, expected * RZ_ARRAY_LEN(producers));
+}
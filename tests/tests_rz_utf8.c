@@ -0,0 +1,141 @@
+#define RZ_TESTS_IMPL
+
+#include "rz_common.h"
+#include "rz_tests.h"
+
+#include "rz_utf8.h"
+#include "tests_allocator.h"
+
+RZ_TESTS_MAIN()
+
+typedef struct {
+    RZ_Allocator alc;
+    RZ_Str       str;
+    RZ_Str       str2;
+    RZ_Utf16Str  u16;
+    RZ_Utf32Str  u32;
+} Utf8s;
+
+RZ_TESTS_SETUP(Utf8s) {
+    fixture->alc  = rz_test_allocator(rz_std_allocator());
+    fixture->str  = (RZ_Str){.allocator = fixture->alc};
+    fixture->str2 = (RZ_Str){.allocator = fixture->alc};
+    fixture->u16  = (RZ_Utf16Str){.allocator = fixture->alc};
+    fixture->u32  = (RZ_Utf32Str){.allocator = fixture->alc};
+}
+
+RZ_TESTS_TEARDOWN(Utf8s) {
+    rz_arr_free(&fixture->str);
+    rz_arr_free(&fixture->str2);
+    rz_arr_free(&fixture->u16);
+    rz_arr_free(&fixture->u32);
+    RZ_TESTS_ALLOCATOR_ASSERT_DEINIT(fixture->alc);
+}
+
+// the reference of the validation: the strict decoder one codepoint at a time
+static rz_usize naive_valid_up_to(RZ_StrView sv) {
+    for (rz_usize i = 0; i < sv.len;) {
+        rz_u32   cp = 0;
+        rz_usize n  = rz_utf8_decode(rz_sv_sized(sv.data + i, sv.len - i), &cp);
+        if (cp == RZ_UTF8_INVALID) return i;
+        i += n;
+    }
+    return sv.len;
+}
+
+RZ_TESTS(Utf8s, decode_and_validate) {
+    // the boundaries of the ranges of the 2nd byte
+    static const struct {
+        const char *bytes;
+        rz_usize    valid;
+    } cases[] = {
+        {"a\xC3\xA9", 3},     {"\xC0\x80", 0},          {"\xC1\xBF", 0},          {"\xC2\x80", 2},          {"\xE0\x9F\x80", 0},
+        {"\xE0\xA0\x80", 3},  {"\xED\x9F\xBF", 3},      {"\xED\xA0\x80", 0},      {"\xEF\xBF\xBF", 3},      {"\xF0\x8F\xBF\xBF", 0},
+        {"\xF0\x90\x80\x80", 4}, {"\xF4\x8F\xBF\xBF", 4}, {"\xF4\x90\x80\x80", 0}, {"\xF5\x80\x80\x80", 0}, {"ab\xE2\x82", 2},
+        {"\x80", 0},          {"\xE2\x82\xAC\xAC", 3},
+    };
+    for (rz_usize i = 0; i < RZ_ARRAY_LEN(cases); ++i) {
+        RZ_TESTS_ASSERT_EQ(rz_utf8_valid_up_to(rz_sv(cases[i].bytes)), cases[i].valid, "case %zu", i);
+    }
+
+    rz_u32 cp = 0;
+    RZ_TESTS_ASSERT_EQ(rz_utf8_decode(rz_sv("\xF0\x9F\x98\x80"), &cp), 4u);
+    RZ_TESTS_ASSERT_EQ(cp, 0x1F600u);
+    RZ_TESTS_ASSERT_EQ(rz_utf8_decode(rz_sv("\xF0\x9F\x98" "a"), &cp), 3u, "maximal subpart");
+    RZ_TESTS_ASSERT_EQ(cp, RZ_UTF8_INVALID);
+
+    // "a€", the invalid "\xE2\x82" then "😀"
+    RZ_Utf8Iter  it       = rz_utf8_iter(rz_sv("a\xE2\x82\xAC\xE2\x82\xF0\x9F\x98\x80"));
+    const rz_u32 expect[] = {'a', 0x20ACu, RZ_UTF8_REPLACEMENT, 0x1F600u};
+    rz_usize     count    = 0;
+    while (rz_utf8_iter_next(&it, &cp)) {
+        RZ_TESTS_ASSERT_TRUE(count < RZ_ARRAY_LEN(expect) && cp == expect[count], "codepoint %zu", count);
+        count++;
+    }
+    RZ_TESTS_ASSERT_EQ(count, RZ_ARRAY_LEN(expect));
+}
+
+static bool is_non_ascii(rz_char ch) {
+    return (rz_u8)ch >= 0x80u;
+}
+
+RZ_TESTS(Utf8s, validate_random) {
+    // long ASCII runs, 2/3/4 bytes sequences and the random corruption at every offset of the 32 bytes blocks
+    static const char *const pieces[] = {"hello ", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xE4\xB8\xAD\xE6\x96\x87", "0123456789abcdef0123456789abcdef"};
+    rz_u32                   seed     = 23;
+    for (rz_usize round = 0; round < 2000; ++round) {
+        fixture->str.len = 0;
+        seed             = (seed * 1103515245U) + 12345U;
+        rz_usize pieces_len = (seed >> 16U) % 40U;
+        rz_usize codepoints = 0;
+        for (rz_usize i = 0; i < pieces_len; ++i) {
+            seed                 = (seed * 1103515245U) + 12345U;
+            RZ_StrView piece     = rz_sv(pieces[(seed >> 16U) % RZ_ARRAY_LEN(pieces)]);
+            codepoints          += rz_utf8_count_codepoints(piece);
+            rz_str_append_sv(&fixture->str, piece);
+        }
+        RZ_StrView sv = rz_sv_from_str(&fixture->str);
+        RZ_TESTS_ASSERT_TRUE(rz_utf8_validate(sv), "round %zu", round);
+        RZ_TESTS_ASSERT_EQ(rz_utf8_count_codepoints(sv), codepoints, "round %zu", round);
+
+        if (sv.len > 0 && (round % 2) == 0) {
+            seed                    = (seed * 1103515245U) + 12345U;
+            sv.data[(seed >> 8U) % sv.len] = (char)(seed >> 20U);
+            if ((round % 4) == 0) sv.len -= ((seed >> 4U) % RZ_MIN(sv.len, 3u));
+        }
+        RZ_TESTS_ASSERT_EQ(rz_utf8_valid_up_to(sv), naive_valid_up_to(sv), "round %zu", round);
+        rz_usize non_ascii = rz_sv_find_by(sv, is_non_ascii);
+        RZ_TESTS_ASSERT_EQ(rz_utf8_ascii_prefix(sv), (non_ascii == RZ_NOT_FOUND) ? sv.len : non_ascii, "round %zu", round);
+    }
+}
+
+RZ_TESTS(Utf8s, transcode) {
+    RZ_StrView text = rz_sv("plain ascii text that is longer than 32 bytes, caf\xC3\xA9 \xE2\x82\xAC 100 \xE4\xB8\xAD\xE6\x96\x87 \xF0\x9F\x98\x80!");
+    RZ_TESTS_ASSERT_TRUE(rz_utf8_to_utf16(text, &fixture->u16));
+    RZ_TESTS_ASSERT_TRUE(rz_utf8_to_utf32(text, &fixture->u32));
+    RZ_TESTS_ASSERT_EQ(fixture->u32.len, rz_utf8_count_codepoints(text));
+    RZ_TESTS_ASSERT_EQ(fixture->u16.len, fixture->u32.len + 1, "one surrogate pair");
+    RZ_TESTS_ASSERT_EQ(fixture->u16.data[fixture->u16.len - 3], 0xD83Du);
+    RZ_TESTS_ASSERT_EQ(fixture->u16.data[fixture->u16.len - 2], 0xDE00u);
+
+    RZ_TESTS_ASSERT_TRUE(rz_utf16_to_utf8(fixture->u16.data, fixture->u16.len, &fixture->str));
+    RZ_TESTS_ASSERT_TRUE(rz_sv_eq(rz_sv_from_str(&fixture->str), text));
+    RZ_TESTS_ASSERT_TRUE(rz_utf32_to_utf8(fixture->u32.data, fixture->u32.len, &fixture->str2));
+    RZ_TESTS_ASSERT_TRUE(rz_sv_eq(rz_sv_from_str(&fixture->str2), text));
+
+    // the invalid input leave the output unchanged
+    rz_usize len = fixture->u16.len;
+    RZ_TESTS_ASSERT_FALSE(rz_utf8_to_utf16(rz_sv("ok \xED\xA0\x80"), &fixture->u16));
+    RZ_TESTS_ASSERT_EQ(fixture->u16.len, len);
+    const rz_u16 lone[] = {'a', 0xD83Du, 'b'};
+    len                 = fixture->str.len;
+    RZ_TESTS_ASSERT_FALSE(rz_utf16_to_utf8(lone, RZ_ARRAY_LEN(lone), &fixture->str), "unpaired surrogate");
+    RZ_TESTS_ASSERT_EQ(fixture->str.len, len);
+    const rz_u32 large[] = {0x110000u};
+    RZ_TESTS_ASSERT_FALSE(rz_utf32_to_utf8(large, 1, &fixture->str));
+
+    fixture->str.len = 0;
+    RZ_TESTS_ASSERT_TRUE(rz_utf8_append(&fixture->str, 0x20ACu));
+    RZ_TESTS_ASSERT_FALSE(rz_utf8_append(&fixture->str, 0xDC00u));
+    RZ_TESTS_ASSERT_TRUE(rz_sv_eq_cstr(rz_sv_from_str(&fixture->str), "\xE2\x82\xAC"));
+}